@@ -48,6 +48,12 @@ if(DEFINED ENV{TEST_FILTER_OUT} AND NOT "$ENV{TEST_FILTER_OUT}" STREQUAL "")
   list(APPEND BUSTED_ARGS --filter-out $ENV{TEST_FILTER_OUT})
 endif()
 
+if(TEST_TYPE STREQUAL "unitbenchmark" AND NOT DEFINED ENV{BENCH_JSON})
+  # Each benchmark appends one JSON object per line.
+  set(ENV{BENCH_JSON} ${BUILD_DIR}/unitbenchmark.jsonl)
+  file(REMOVE $ENV{BENCH_JSON})
+endif()
+
 # TMPDIR: for testutil.tmpname() and Nvim tempname().
 set(ENV{TMPDIR} "${BUILD_DIR}/Xtest_tmpdir")
 execute_process(COMMAND ${CMAKE_COMMAND} -E make_directory $ENV{TMPDIR})
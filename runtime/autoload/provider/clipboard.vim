@@ -24,6 +24,10 @@ function! s:selection.on_exit(jobid, data, event) abort
   " a new provider instance. Don't drop ownership in this case.
   if self.owner == a:jobid
     let self.owner = 0
+    " Another program took ownership of the selection.
+    if self.detach && s:selections[self.reg] is self
+      unlet! s:pasted[self.reg]
+    endif
   endif
   " Don't print if exit code is >= 128 ( exit is 128+SIGNUM if by signal (e.g. 143 on SIGTERM))
   if a:data > 0 && a:data < 128
@@ -35,6 +39,41 @@ endfunction
 
 let s:selections = { '*': s:selection, '+': copy(s:selection) }
 
+" When "async" is enabled, the clipboard contents last read or written are
+" served from s:pasted until Nvim gains focus again, and are then read in
+" the background, storing the jobid of the paste command in s:fetching.
+let s:async = 0
+let s:pasted = {}
+let s:fetching = { '*': 0, '+': 0 }
+let s:fetcher = { 'stdout_buffered': v:true }
+
+function! s:fetcher.on_exit(jobid, data, event) abort
+  if s:fetching[self.reg] == a:jobid
+    let s:fetching[self.reg] = 0
+    if a:data == 0 && !has_key(s:pasted, self.reg)
+      let s:pasted[self.reg] = self.stdout
+    endif
+  endif
+endfunction
+
+function! s:refresh() abort
+  for reg in ['+', '*']
+    unlet! s:pasted[reg]
+    " Functions (e.g. OSC 52) can't run in the background: they are called
+    " on the next paste.
+    if type(s:paste[reg]) != v:t_list || s:fetching[reg] > 0
+          \ || s:selections[reg].owner > 0
+      continue
+    endif
+    let fetcher = extend(copy(s:fetcher), { 'reg': reg })
+    let jobid = jobstart(s:paste[reg], fetcher)
+    if jobid > 0
+      call chanclose(jobid, 'stdin')
+      let s:fetching[reg] = jobid
+    endif
+  endfor
+endfunction
+
 function! s:try_cmd(cmd, ...) abort
   let out = systemlist(a:cmd, (a:0 ? a:1 : ['']), 1)
   if v:shell_error
@@ -232,6 +271,7 @@ function! provider#clipboard#Executable() abort
     let s:paste['*'] = s:split_cmd(get(g:clipboard.paste, '*', v:null))
 
     let s:cache_enabled = get(g:clipboard, 'cache_enabled', 0)
+    let s:async = get(g:clipboard, 'async', 0)
     return get(g:clipboard, 'name', 'g:clipboard')
   elseif has('mac')
     return s:set_pbcopy()
@@ -267,12 +307,30 @@ function! provider#clipboard#Executable() abort
   return ''
 endfunction
 
+function! s:paste_now(reg) abort
+  return type(s:paste[a:reg]) == v:t_func ? s:paste[a:reg]() : s:try_cmd(s:paste[a:reg])
+endfunction
+
 function! s:clipboard.get(reg) abort
   if s:selections[a:reg].owner > 0
     return s:selections[a:reg].data
   end
 
-  let clipboard_data = type(s:paste[a:reg]) == v:t_func ? s:paste[a:reg]() : s:try_cmd(s:paste[a:reg])
+  if s:async
+    if s:fetching[a:reg] > 0
+      " Let the background read finish, it is likely close to done.
+      call jobwait([s:fetching[a:reg]])
+    endif
+    let clipboard_data = get(s:pasted, a:reg, v:null)
+    if clipboard_data is v:null
+      let clipboard_data = s:paste_now(a:reg)
+      if type(clipboard_data) == v:t_list
+        let s:pasted[a:reg] = clipboard_data
+      endif
+    endif
+  else
+    let clipboard_data = s:paste_now(a:reg)
+  endif
   if match(&clipboard, '\v(unnamed|unnamedplus)') >= 0
         \ && type(clipboard_data) == v:t_list
         \ && get(s:selections[a:reg].data, 0, []) ==# clipboard_data
@@ -292,7 +350,12 @@ function! s:clipboard.set(lines, regtype, reg) abort
     return 0
   end
 
-  if s:cache_enabled == 0 || type(s:copy[a:reg]) == v:t_func
+  if s:async
+    " Served by get() until the clipboard changes.
+    let s:pasted[a:reg] = copy(a:lines)
+  endif
+
+  if (s:cache_enabled == 0 && !s:async) || type(s:copy[a:reg]) == v:t_func
     if type(s:copy[a:reg]) == v:t_func
       call s:copy[a:reg](a:lines, a:regtype)
     else
@@ -312,6 +375,7 @@ function! s:clipboard.set(lines, regtype, reg) abort
   let selection.data = [a:lines, a:regtype]
   let selection.argv = s:copy[a:reg]
   let selection.detach = s:cache_enabled
+  let selection.reg = a:reg
   let selection.cwd = "/"
   let jobid = jobstart(selection.argv, selection)
   if jobid > 0
@@ -355,3 +419,8 @@ endfunction
 
 " eval_has_provider() decides based on this variable.
 let g:loaded_clipboard_provider = empty(provider#clipboard#Executable()) ? 0 : 2
+
+augroup nvim_clipboard
+  autocmd!
+  autocmd FocusGained * if s:async | call s:refresh() | endif
+augroup END
@@ -547,6 +547,88 @@ function vim.defer_fn(fn, timeout)
   return timer
 end
 
+--- @class vim.parallel_map.Opts
+--- @inlinedoc
+---
+--- Number of worker threads to use.
+--- (default: |uv.available_parallelism()|)
+--- @field threads? integer
+
+--- Calls {fn} on each item of {list} on worker threads of the |vim.uv| thread pool, and returns
+--- the results in the order of {list}. Waits until all items were processed.
+---
+--- {fn} runs in a separate Lua state (see |lua-loop-threading|), so it must not have upvalues and
+--- only the |lua-stdlib| functions available in threads can be used. Items and results must be
+--- strings, numbers or booleans.
+---
+--- Example: >lua
+---     local lens = vim.parallel_map(function(path)
+---       return #path
+---     end, files)
+--- <
+---
+---@param fn fun(item: string|number|boolean): string|number|boolean
+---@param list (string|number|boolean)[]
+---@param opts? vim.parallel_map.Opts
+---@return (string|number|boolean)[]
+function vim.parallel_map(fn, list, opts)
+  vim.validate('fn', fn, 'function')
+  vim.validate('list', list, 'table')
+  vim.validate('opts', opts, 'table', true)
+  if debug.getinfo(fn, 'u').nups > 0 then
+    error('fn must not have upvalues', 2)
+  end
+  local n = #list
+  local nthreads = math.min((opts and opts.threads) or vim.uv.available_parallelism(), n)
+  if nthreads <= 1 then
+    local ret = {}
+    for i = 1, n do
+      ret[i] = fn(list[i])
+    end
+    return ret
+  end
+
+  local size = math.ceil(n / nthreads)
+  local results = {} --- @type (string|number|boolean)[]
+  local pending = math.ceil(n / size)
+  local err --- @type string?
+  local work = vim.uv.new_work(function(code, idx, items)
+    local ok, ret = pcall(function()
+      local f = assert(loadstring(code))
+      local t = vim.mpack.decode(items)
+      for i = 1, #t do
+        t[i] = f(t[i])
+      end
+      return vim.mpack.encode(t)
+    end)
+    return idx, ok, ret
+  end, function(idx, ok, ret)
+    if ok then
+      local t = vim.mpack.decode(ret)
+      for i = 1, #t do
+        results[idx + i - 1] = t[i]
+      end
+    else
+      err = err or ret
+    end
+    pending = pending - 1
+  end)
+
+  local code = string.dump(fn)
+  for first = 1, n, size do
+    local items = { unpack(list, first, math.min(first + size - 1, n)) }
+    work:queue(code, first, vim.mpack.encode(items))
+  end
+
+  vim.wait(vim._maxint, function()
+    return pending == 0
+  end, nil, true)
+  if err then
+    error(err, 2)
+  end
+  return results
+end
+
 --- Displays a notification to the user.
 ---
 --- This function can be overridden by plugins to display notifications using
@@ -35,6 +35,15 @@ function vim.api.nvim__complete_set(index, opts) end
 --- @return string
 function vim.api.nvim__get_lib_dir() end
 
+--- Gets the values of several options in one call, like calling
+--- `nvim_get_option_value()` for each name.
+---
+--- @param names string[] Option names
+--- @param opts vim.api.keyset.option Optional parameters, like `nvim_get_option_value()` but
+--- "filetype" is not supported.
+--- @return any[] # Option values, in the order of {names}
+function vim.api.nvim__get_option_values(names, opts) end
+
 --- Find files in runtime directories
 ---
 --- @param pat string[] pattern of files to search for
@@ -142,9 +151,42 @@ function vim.api.nvim__screenshot(path) end
 
 --- Gets internal stats.
 ---
+--- The "redraw_hist", "rpc_hist" and "input_latency_hist" histograms count
+--- durations by powers of two: item i is the number of durations of 2^(i-1) to
+--- 2^i milliseconds, the first item counts shorter ones and the last item
+--- longer ones.
+---
+--- "input_latency_ns" is the time from the arrival of input (`nvim_input()` or
+--- a UI) until the screen was updated and flushed after processing it, of
+--- which "input_ns" is spent before the screen update started. The time of the
+--- screen update is split into "win_line_ns", "compositor_ns" and
+--- "ui_encode_ns", for drawing buffer lines, composing grids and encoding the
+--- result for remote UIs.
+---
+--- "pools" has the object size and the number of allocated ("live") and free
+--- objects and of blocks for each pool of small objects.
+---
 --- @return table<string,any> # Map of various internal stats.
 function vim.api.nvim__stats() end
 
+--- Gets the spans recorded after `nvim__trace_start()`, oldest first, as events
+--- of the Chrome trace event format, which can be loaded in Perfetto:
+---
+--- ```lua
+--- vim.fn.writefile({ vim.json.encode(vim.api.nvim__trace_get()) }, 'trace.json')
+--- ```
+---
+--- @return any[] # Array of dicts with keys "name", "cat", "ph", "ts" and "dur" (in
+---         microseconds), "pid", "tid" and optionally "args".
+function vim.api.nvim__trace_get() end
+
+--- Starts recording the time spent in sourcing scripts, autocommands, RPC
+--- requests, decoration providers and redrawing. Replaces the spans recorded
+--- before.
+---
+--- @param size integer Number of spans to keep, older ones are dropped. Zero stops recording.
+function vim.api.nvim__trace_start(size) end
+
 --- @param str string
 --- @return any
 function vim.api.nvim__unpack(str) end
@@ -159,6 +201,23 @@ function vim.api.nvim__unpack(str) end
 --- @return integer
 function vim.api.nvim_buf_add_highlight(buffer, ns_id, hl_group, line, col_start, col_end) end
 
+--- Applies several text edits to a buffer at once.
+---
+--- Each edit is a `[start_row, start_col, end_row, end_col, replacement]` list,
+--- with the same meaning as the arguments of `nvim_buf_set_text()`. All
+--- positions refer to the buffer text before any of the edits is applied, the
+--- edits must not overlap. Edits at the same position are inserted in the
+--- given order.
+---
+--- This is equivalent to calling `nvim_buf_set_text()` for each edit, from the
+--- last one in the buffer to the first, but creates a single undo step and
+--- redraws and triggers `TextChanged` once, which is much faster for many
+--- edits.
+---
+--- @param buffer integer Buffer id, or 0 for current buffer
+--- @param edits any[] Array of edits
+function vim.api.nvim_buf_apply_edits(buffer, edits) end
+
 --- Activates `api-buffer-updates` events on a channel, or as Lua callbacks.
 ---
 --- Example (Lua): capture buffer updates in a global `events` variable
@@ -228,6 +287,12 @@ function vim.api.nvim_buf_add_highlight(buffer, ns_id, hl_group, line, col_start
 ---   region, as args to `on_lines`.
 --- - preview: also attach to command preview (i.e. 'inccommand')
 ---   events.
+--- - batch: queue changes and deliver them once per main loop
+---   iteration (and before redraw) instead of on every change.
+---   Adjacent changes are merged: `on_lines` is called once with
+---   the range covering all changed lines, where byte counts are
+---   summed, and `on_bytes` is called once for each run of
+---   changes which start where the previous one ended.
 --- @return boolean # False if attach failed (invalid parameter, or buffer isn't loaded);
 --- otherwise True. TODO: LUA_API_NO_EVAL
 function vim.api.nvim_buf_attach(buffer, send_buffer, opts) end
@@ -689,6 +754,24 @@ function vim.api.nvim_buf_line_count(buffer) end
 --- @return integer # Id of the created/updated extmark
 function vim.api.nvim_buf_set_extmark(buffer, ns_id, line, col, opts) end
 
+--- Creates or updates many `extmarks` at once.
+---
+--- Like calling `nvim_buf_set_extmark()` for each item of {marks}, but
+--- crosses the API boundary only once, which matters when placing a large
+--- number of marks, e.g. for semantic highlighting. Stops at the first mark
+--- that cannot be set, the marks before it are kept.
+---
+--- @param buffer integer Buffer id, or 0 for current buffer
+--- @param ns_id integer Namespace id from `nvim_create_namespace()`
+--- @param marks any[] List of marks, each a list `[line, col, opts]` with the same
+---               meaning as the arguments of `nvim_buf_set_extmark()`.
+---               `opts` can be omitted.
+--- @param opts vim.api.keyset.set_extmarks Optional parameters.
+--- - clear: remove all extmarks of the namespace first, so that
+---   afterwards the namespace holds exactly {marks}.
+--- @return integer[] # List of ids of the created/updated extmarks, in the order of {marks}
+function vim.api.nvim_buf_set_extmarks(buffer, ns_id, marks, opts) end
+
 --- Sets a buffer-local `mapping` for the given mode.
 ---
 ---
@@ -963,6 +1046,10 @@ function vim.api.nvim_create_augroup(name, opts) end
 --- only once `autocmd-once`.
 --- - nested (boolean) optional: defaults to false. Run nested
 --- autocommands `autocmd-nested`.
+--- - debounce (integer) optional: milliseconds to wait before running the
+--- autocommand, restarted when the event is triggered again for the same buffer.
+--- Repeated events run it only once, with the file and data of the last one, and
+--- without `v:event`. Useful for `CursorMoved` and `TextChangedI`.
 --- @return integer # Autocommand id (number)
 function vim.api.nvim_create_autocmd(event, opts) end
 
@@ -2147,6 +2234,12 @@ function vim.api.nvim_set_current_win(window) end
 ---   ```
 ---     ["end", tick]
 ---   ```
+--- - cache_lines: (boolean) reuse the ephemeral highlights set by
+---   `on_line` for a line, and skip calling `on_line` for it again,
+---   until the buffer changes (its `b:changedtick`) or the window
+---   shows another buffer. Lines where `on_line` returns false,
+---   sets virtual text or adds non-ephemeral extmarks are not
+---   cached. Set the provider again to discard the cache.
 function vim.api.nvim_set_decoration_provider(ns_id, opts) end
 
 --- Sets a highlight group.
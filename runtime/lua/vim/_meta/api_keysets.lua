@@ -11,6 +11,7 @@ error('Cannot require a meta file')
 --- @field on_reload? fun(_: "reload", bufnr: integer)
 --- @field utf_sizes? boolean
 --- @field preview? boolean
+--- @field batch? boolean
 
 --- @class vim.api.keyset.buf_delete
 --- @field force? boolean
@@ -223,6 +224,7 @@ error('Cannot require a meta file')
 --- @field buffer? integer
 --- @field callback? string|fun(args: vim.api.keyset.create_autocmd.callback_args): boolean?
 --- @field command? string
+--- @field debounce? integer
 --- @field desc? string
 --- @field group? integer|string
 --- @field nested? boolean
@@ -380,6 +382,7 @@ error('Cannot require a meta file')
 --- @field _on_hl_def? fun(_: "hl_def")
 --- @field _on_spell_nav? fun(_: "spell_nav")
 --- @field _on_conceal_line? fun(_: "conceal_line")
+--- @field cache_lines? boolean
 
 --- @class vim.api.keyset.set_extmark
 --- @field id? integer
@@ -417,6 +420,9 @@ error('Cannot require a meta file')
 --- @field url? string
 --- @field scoped? boolean
 
+--- @class vim.api.keyset.set_extmarks
+--- @field clear? boolean
+
 --- @class vim.api.keyset.user_command
 --- @field addr? any
 --- @field bang? boolean
@@ -75,6 +75,36 @@ vim.NIL = ...
 --- to other restrictions such as |textlock|).
 function vim.in_fast_event() end
 
+--- Iterates over the lines of a buffer without creating a Lua string for each line. Yields the
+--- 0-based row and a line view, which reads the text from the buffer when used:
+--- - `view:text()` (or `tostring(view)`) returns the line as a string.
+--- - `#view` is the length of the line in bytes.
+--- - `view:find(s, init)` finds the plain text {s}, like `string.find(line, s, init, true)`.
+--- - `view:match(re)` matches a |vim.regex()| object, like `re:match_str(line)`.
+---
+--- A view must not be used after the buffer was changed.
+---
+--- Example: >lua
+---     local count = 0
+---     for _, line in vim.buf_lines(0) do
+---       if line:find('TODO') then
+---         count = count + 1
+---       end
+---     end
+--- <
+--- @param buf? integer Buffer handle, or 0 for current buffer
+--- @param start? integer First line index, zero-based (default: 0)
+--- @param end_? integer Last line index, exclusive, negative values index from the end
+---                      like |nvim_buf_get_lines()| (default: -1)
+--- @return fun(): integer?, vim.LineView?
+function vim.buf_lines(buf, start, end_) end
+
+--- @nodoc
+--- @class vim.LineView
+--- @field text fun(self: vim.LineView): string
+--- @field find fun(self: vim.LineView, s: string, init?: integer): integer?, integer?
+--- @field match fun(self: vim.LineView, re: vim.regex): integer?, integer?
+
 --- Creates a special empty table (marked with a metatable), which Nvim
 --- converts to an empty dictionary when translating Lua values to Vimscript
 --- or API types. Nvim by default converts an empty table `{}` without this
@@ -273,6 +273,11 @@
 --- blocks.  Each item may again have an "alt"
 --- item.
 --- @field alt? vim.fn.undotree.entry[]
+---
+--- Only appears when {since} is given.  The sequence
+--- number of the change this one follows, zero for
+--- the oldest change.
+--- @field parent? integer
 
 --- @class vim.fn.undotree.ret
 ---
@@ -302,6 +307,10 @@
 --- user.  See |undo-blocks|.
 --- @field synced integer
 ---
+--- Number of bytes used by the undo information.
+--- See 'undomemory'.
+--- @field memory integer
+---
 --- A list of dictionaries with information about
 --- undo blocks.
 --- @field entries vim.fn.undotree.entry[]
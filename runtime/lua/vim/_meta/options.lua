@@ -5175,6 +5175,18 @@ vim.o.rdb = vim.o.redrawdebug
 vim.go.redrawdebug = vim.o.redrawdebug
 vim.go.rdb = vim.go.redrawdebug
 
+--- Minimum time in milliseconds between screen updates for events, such
+--- as output of jobs and terminals, timers and RPC requests.  When events
+--- arrive faster, the changes they make are drawn together once this time
+--- has passed.  The screen is still updated right away after typed keys.
+--- Set to 0 to update the screen after every event.
+---
+--- @type integer
+vim.o.redrawinterval = 0
+vim.o.rdi = vim.o.redrawinterval
+vim.go.redrawinterval = vim.o.redrawinterval
+vim.go.rdi = vim.go.redrawinterval
+
 --- Time in milliseconds for redrawing the display.  Applies to
 --- 'hlsearch', 'inccommand', `:match` highlighting, syntax highlighting,
 --- and async `LanguageTree:parse()`.
@@ -5196,6 +5208,8 @@ vim.go.rdt = vim.go.redrawtime
 --- 	0	automatic selection
 --- 	1	old engine
 --- 	2	NFA engine
+--- 	3	NFA engine, with a lazily built DFA to quickly skip
+--- 		lines that cannot match
 --- Note that when using the NFA engine and the pattern contains something
 --- that is not supported the pattern will not match.  This is only useful
 --- for debugging the regexp engine.
@@ -6838,7 +6852,8 @@ vim.wo.stc = vim.wo.statuscolumn
 --- 	set statusline=...%(\ [%M%R%H]%)...
 --- ```
 --- Beware that an expression is evaluated each and every time the status
---- line is displayed.
+--- line is updated.  When the status line is only drawn again because it
+--- was overwritten, the text of the previous evaluation is used.
 --- 			*stl-%{* *g:actual_curbuf* *g:actual_curwin*
 --- While evaluating %{} the current buffer and current window will be set
 --- temporarily to that of the window (and buffer) whose statusline is
@@ -7587,6 +7602,28 @@ vim.bo.ul = vim.bo.undolevels
 vim.go.undolevels = vim.o.undolevels
 vim.go.ul = vim.go.undolevels
 
+--- Maximum amount of memory in Kbyte to use for the undo information of
+--- a buffer.  When it is exceeded the oldest changes are forgotten, like
+--- when there are more than 'undolevels' changes.  The last change is
+--- always kept, even when it uses more memory.  The limit is for each
+--- buffer, the total for all buffers is not limited.
+--- Set to 0 for no limit.  The memory used is reported by `undotree()`.
+--- After using the local value, go back the global value with one of
+--- these two:
+---
+--- ```vim
+--- 	setlocal undomemory<
+--- 	setlocal undomemory=-1
+--- ```
+---
+--- @type integer
+vim.o.undomemory = 0
+vim.o.um = vim.o.undomemory
+vim.bo.undomemory = vim.o.undomemory
+vim.bo.um = vim.bo.undomemory
+vim.go.undomemory = vim.o.undomemory
+vim.go.um = vim.go.undomemory
+
 --- Save the whole buffer for undo when reloading it.  This applies to the
 --- ":e!" command and reloading for when the buffer changed outside of
 --- Vim. `FileChangedShell`
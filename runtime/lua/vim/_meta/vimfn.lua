@@ -5019,8 +5019,12 @@ function vim.fn.jobsend(...) end
 ---         but `on_stderr` can still be used.
 ---   stderr_buffered: (boolean) Collect data until EOF (stream closed)
 ---         before invoking `on_stderr`. |channel-buffered|
+---   stderr_raw: (boolean) Pass the data to `on_stderr` as one
+---         String instead of a list. |channel-raw|
 ---   stdout_buffered: (boolean) Collect data until EOF (stream
 ---         closed) before invoking `on_stdout`. |channel-buffered|
+---   stdout_raw: (boolean) Pass the data to `on_stdout` as one
+---         String instead of a list. |channel-raw|
 ---   stdin:      (string) Either "pipe" (default) to connect the
 ---         job's stdin to a channel or "null" to disconnect
 ---         stdin.
@@ -10590,6 +10594,8 @@ function vim.fn.undofile(name) end
 ---   "synced"  Non-zero when the last undo block was synced.
 ---     This happens when waiting from input from the
 ---     user.  See |undo-blocks|.
+---   "memory"  Number of bytes used by the undo information.
+---     See 'undomemory'.
 ---   "entries"  A list of dictionaries with information about
 ---     undo blocks.
 ---
@@ -10616,9 +10622,19 @@ function vim.fn.undofile(name) end
 ---     blocks.  Each item may again have an "alt"
 ---     item.
 ---
+--- When {since} is given, "entries" is a flat list of the undo
+--- blocks with a sequence number above {since}, ordered by
+--- sequence number.  The items have no "alt" item, instead
+--- "parent" is the sequence number of the undo block they
+--- follow, zero for the oldest.  This is fast for a long undo
+--- history when only the new changes are needed: >vim
+---   let changes = undotree('%', last_seen_seq).entries
+--- <
+---
 --- @param buf? integer|string
+--- @param since? integer
 --- @return vim.fn.undotree.ret
-function vim.fn.undotree(buf) end
+function vim.fn.undotree(buf, since) end
 
 --- Remove second and succeeding copies of repeated adjacent
 --- {list} items in-place.  Returns {list}.  If you want a list
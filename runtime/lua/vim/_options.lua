@@ -125,12 +125,21 @@ local function get_option_metatype(name, info)
   return info.type
 end
 
+--- Option info by name, so that using |vim.opt| doesn't need an extra API call.
+--- Only fields that never change (type, flags) are used from it, not "was_set".
+--- @type table<string,vim._option.Info>
+local options_info = {}
+
 --- @param name string
 --- @return vim._option.Info
 local function get_options_info(name)
-  local info = api.nvim_get_option_info2(name, {})
-  --- @cast info vim._option.Info
-  info.metatype = get_option_metatype(name, info)
+  local info = options_info[name]
+  if not info then
+    info = api.nvim_get_option_info2(name, {})
+    --- @cast info vim._option.Info
+    info.metatype = get_option_metatype(name, info)
+    options_info[name] = info
+  end
   return info
 end
 
@@ -308,7 +308,8 @@ local is_win = vim.fn.has('win32') == 1
 --- @param on_error fun()
 --- @return uv.uv_process_t, integer
 local function spawn(cmd, opts, on_exit, on_error)
-  if is_win then
+  -- vim.system_all() resolves commands beforehand, as it also spawns from fast callbacks.
+  if is_win and not vim.in_fast_event() then
     local cmd1 = vim.fn.exepath(cmd)
     if cmd1 ~= '' then
       cmd = cmd1
@@ -320,7 +321,7 @@ local function spawn(cmd, opts, on_exit, on_error)
     on_error()
     if opts.cwd and not uv.fs_stat(opts.cwd) then
       error(("%s (cwd): '%s'"):format(pid_or_err, opts.cwd))
-    elseif vim.fn.executable(cmd) == 0 then
+    elseif not vim.in_fast_event() and vim.fn.executable(cmd) == 0 then
       error(("%s (cmd): '%s'"):format(pid_or_err, cmd))
     else
       error(pid_or_err)
@@ -507,3 +508,173 @@ function vim.system(cmd, opts, on_exit)
   end
   return run(cmd, opts, on_exit)
 end
+
+--- @class vim.SystemAllOpts : vim.SystemOpts
+--- @inlinedoc
+---
+--- Maximum number of commands running at the same time.
+--- (Default: |uv.available_parallelism()|)
+--- @field limit? integer
+
+--- @class (package) vim.SystemAllState
+--- @field results vim.SystemCompleted[]
+--- @field objs table<integer,vim.SystemObj> Running commands.
+--- @field next integer Index of the next command to start.
+--- @field running integer
+--- @field done integer
+--- @field stopped? boolean
+
+--- @class vim.SystemAllObj
+--- @field cmds string[][] Commands, in the order given to |vim.system_all()|.
+--- @field private _state vim.SystemAllState
+--- @field private _on_exit? fun(i: integer, out: vim.SystemCompleted)
+local SystemAllObj = {}
+
+--- @param state vim.SystemAllState
+--- @param i integer
+--- @param out vim.SystemCompleted
+--- @param on_exit? fun(i: integer, out: vim.SystemCompleted)
+local function finish_one(state, i, out, on_exit)
+  state.results[i] = out
+  state.objs[i] = nil
+  state.done = state.done + 1
+  if on_exit then
+    on_exit(i, out)
+  end
+end
+
+--- Sends a signal to the running commands. Commands which were not started yet
+--- are not started anymore, their result only has `signal` set.
+---
+--- @param signal integer|string Signal to send to the processes.
+function SystemAllObj:kill(signal)
+  local state = self._state
+  state.stopped = true
+  local signum = type(signal) == 'number' and signal or SIG[signal:upper():gsub('^SIG', '')] or 0
+  for i = state.next, #self.cmds do
+    finish_one(state, i, { code = 0, signal = signum }, self._on_exit)
+  end
+  state.next = #self.cmds + 1
+  for _, obj in pairs(state.objs) do
+    obj:kill(signal)
+  end
+end
+
+--- Waits for all commands to complete or until the specified timeout elapses.
+---
+--- Like |SystemObj:wait()|, but on timeout all running commands are killed with
+--- SIGKILL, and the ones not started yet get exit code 124 too.
+---
+--- @param timeout? integer
+--- @return vim.SystemCompleted[] # Results, in the order of the commands.
+function SystemAllObj:wait(timeout)
+  local state = self._state
+  local function all_done()
+    return state.done == #self.cmds
+  end
+
+  if not vim.wait(timeout or vim._maxint, all_done, nil, true) then
+    state.stopped = true
+    for i = state.next, #self.cmds do
+      finish_one(state, i, { code = 124, signal = SIG.KILL }, self._on_exit)
+    end
+    state.next = #self.cmds + 1
+    for _, obj in pairs(state.objs) do
+      obj:_timeout(SIG.KILL)
+    end
+    vim.wait(vim._maxint, all_done, nil, true)
+  end
+
+  return state.results
+end
+
+--- Runs a list of system commands concurrently, at most {opts.limit} at a time.
+---
+--- Each command is run like |vim.system()| with the same {opts}. When a command
+--- exits, the next one is started from the exit callback, so the commands keep
+--- running while Nvim waits for input. If a command cannot be run, its result
+--- has exit code 127 and the error message in `stderr`.
+---
+--- Example:
+---
+--- ```lua
+--- local files = { 'a.lua', 'b.lua', 'c.lua' }
+--- local cmds = vim.tbl_map(function(f)
+---   return { 'stylua', '--check', f }
+--- end, files)
+---
+--- -- Runs asynchronously, reports each result as it is ready:
+--- vim.system_all(cmds, { text = true }, function(i, out)
+---   print(files[i], out.code)
+--- end)
+---
+--- -- Runs synchronously:
+--- local results = vim.system_all(cmds, { limit = 2 }):wait()
+--- ```
+---
+--- @param cmds string[][] Commands to execute
+--- @param opts? vim.SystemAllOpts
+--- @param on_exit? fun(i: integer, out: vim.SystemCompleted) Called when command {i} exits.
+---   Like the {on_exit} of |vim.system()|, this is called in |lua-loop-callbacks|.
+---
+--- @return vim.SystemAllObj
+function vim.system_all(cmds, opts, on_exit)
+  vim.validate('cmds', cmds, 'table')
+  vim.validate('opts', opts, 'table', true)
+  vim.validate('on_exit', on_exit, 'function', true)
+
+  opts = opts or {}
+  local limit = opts.limit or uv.available_parallelism()
+  vim.validate('opts.limit', limit, function(v)
+    return type(v) == 'number' and v >= 1
+  end, 'positive number')
+
+  -- Commands after the first batch are started in fast callbacks, where Vimscript functions cannot
+  -- be called: resolve the environment and the executables here.
+  local cmd_opts = vim.tbl_extend('force', {}, opts) --- @type vim.SystemOpts
+  if not opts.clear_env then
+    cmd_opts.env = vim.tbl_extend('force', base_env(), opts.env or {})
+    cmd_opts.clear_env = true
+  end
+  local resolved = {} --- @type string[][]
+  for i, cmd in ipairs(cmds) do
+    vim.validate(('cmds[%d]'):format(i), cmd, 'table')
+    resolved[i] = cmd
+    if is_win then
+      local cmd1 = vim.fn.exepath(cmd[1])
+      if cmd1 ~= '' then
+        resolved[i] = vim.list_extend({ cmd1 }, cmd, 2)
+      end
+    end
+  end
+
+  --- @type vim.SystemAllState
+  local state = { results = {}, objs = {}, next = 1, running = 0, done = 0 }
+
+  local function start_next()
+    while state.running < limit and state.next <= #resolved and not state.stopped do
+      local i = state.next
+      state.next = i + 1
+      state.running = state.running + 1
+      local ok, obj = pcall(run, resolved[i], cmd_opts, function(out)
+        state.running = state.running - 1
+        finish_one(state, i, out, on_exit)
+        start_next()
+      end)
+      if ok then
+        state.objs[i] = obj
+      else
+        state.running = state.running - 1
+        finish_one(state, i, { code = 127, signal = 0, stderr = tostring(obj) }, on_exit)
+      end
+    end
+  end
+
+  start_next()
+
+  return setmetatable({
+    cmds = cmds,
+    _state = state,
+    _on_exit = on_exit,
+  }, { __index = SystemAllObj })
+end
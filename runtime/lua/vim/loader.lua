@@ -1,18 +1,12 @@
 local fs = vim.fs -- "vim.fs" is a dependency, so must be loaded early.
 local uv = vim.uv
-local uri_encode = vim.uri_encode --- @type function
 
 --- @type (fun(modename: string): fun()|string)[]
 local loaders = package.loaders
 local _loadfile = loadfile
 
-local VERSION = 4
-
 local M = {}
 
---- @alias vim.loader.CacheHash {mtime: {nsec: integer, sec: integer}, size: integer, type?: string}
---- @alias vim.loader.CacheEntry {hash:vim.loader.CacheHash, chunk:string}
-
 --- @class vim.loader.find.Opts
 --- @inlinedoc
 ---
@@ -50,6 +44,11 @@ local M = {}
 --- @private
 M.path = vim.fn.stdpath('cache') .. '/luac'
 
+--- The bytecode cache of all modules, kept in memory by Nvim and written back on exit.
+local function pack_filename()
+  return M.path .. '/cache.luac'
+end
+
 --- @private
 M.enabled = false
 
@@ -112,75 +111,6 @@ local function get_rtp()
   return rtp_cached, updated
 end
 
---- Returns the cache file name
---- @param name string can be a module name, or a file name
---- @return string file_name
-local function cache_filename(name)
-  local ret = ('%s/%s'):format(M.path, uri_encode(name, 'rfc2396'))
-  return ret:sub(-4) == '.lua' and (ret .. 'c') or (ret .. '.luac')
-end
-
---- Saves the cache entry for a given module or file
---- @param cname string cache filename
---- @param hash vim.loader.CacheHash
---- @param chunk function
-local function write_cachefile(cname, hash, chunk)
-  local f = assert(uv.fs_open(cname, 'w', 438))
-  local header = {
-    VERSION,
-    hash.size,
-    hash.mtime.sec,
-    hash.mtime.nsec,
-  }
-  uv.fs_write(f, table.concat(header, ',') .. '\0')
-  uv.fs_write(f, string.dump(chunk))
-  uv.fs_close(f)
-end
-
---- @param path string
---- @param mode integer
---- @return string? data
-local function readfile(path, mode)
-  local f = uv.fs_open(path, 'r', mode)
-  if f then
-    local size = assert(uv.fs_fstat(f)).size
-    local data = uv.fs_read(f, size, 0)
-    uv.fs_close(f)
-    return data
-  end
-end
-
---- Loads the cache entry for a given module or file
---- @param cname string cache filename
---- @return vim.loader.CacheHash? hash
---- @return string? chunk
-local function read_cachefile(cname)
-  local data = readfile(cname, 438)
-  if not data then
-    return
-  end
-
-  local zero = data:find('\0', 1, true)
-  if not zero then
-    return
-  end
-
-  --- @type integer[]|{[0]:integer}
-  local header = vim.split(data:sub(1, zero - 1), ',')
-  if tonumber(header[1]) ~= VERSION then
-    return
-  end
-
-  local hash = {
-    size = tonumber(header[2]),
-    mtime = { sec = tonumber(header[3]), nsec = tonumber(header[4]) },
-  }
-
-  local chunk = data:sub(zero + 1)
-
-  return hash, chunk
-end
-
 --- The `package.loaders` loader for Lua files using the cache.
 --- @param modname string module name
 --- @return string|function
@@ -220,20 +150,6 @@ local function loader_lib_cached(modname)
   return chunk or error(err)
 end
 
---- Checks whether two cache hashes are the same based on:
---- * file size
---- * mtime in seconds
---- * mtime in nanoseconds
---- @param a? vim.loader.CacheHash
---- @param b? vim.loader.CacheHash
-local function hash_eq(a, b)
-  return a
-    and b
-    and a.size == b.size
-    and a.mtime.sec == b.mtime.sec
-    and a.mtime.nsec == b.mtime.nsec
-end
-
 --- `loadfile` using the cache
 --- Note this has the mode and env arguments which is supported by LuaJIT and is 5.1 compatible.
 --- @param filename? string
@@ -243,21 +159,17 @@ end
 local function loadfile_cached(filename, mode, env)
   local modpath = normalize(filename)
   local stat = fs_stat_cached(modpath)
-  local cname = cache_filename(modpath)
-  if stat then
-    local e_hash, e_chunk = read_cachefile(cname)
-    if hash_eq(e_hash, stat) and e_chunk then
-      -- found in cache and up to date
-      local chunk, err = load(e_chunk, '@' .. modpath, mode, env)
-      if not (err and err:find('cannot load incompatible bytecode', 1, true)) then
-        return chunk, err
-      end
+  if stat and (mode == nil or mode:find('b', 1, true)) then
+    -- found in cache and up to date
+    local chunk = vim._luac_load(modpath, stat.size, stat.mtime.sec, stat.mtime.nsec)
+    if chunk then
+      return env and setfenv(chunk, env) or chunk
     end
   end
 
   local chunk, err = _loadfile(modpath, mode, env)
   if chunk and stat then
-    write_cachefile(cname, stat, chunk)
+    vim._luac_add(modpath, stat.size, stat.mtime.sec, stat.mtime.nsec, string.dump(chunk))
   end
   return chunk, err
 end
@@ -403,7 +315,8 @@ end
 ---
 --- Enable (`enable=true`):
 --- * overrides |loadfile()|
---- * adds the Lua loader using the byte-compilation cache
+--- * adds the Lua loader using the byte-compilation cache, which is read from a single file and
+---   written back on exit
 --- * adds the libs loader
 --- * removes the default Nvim loader
 ---
@@ -423,6 +336,13 @@ function M.enable(enable)
 
   if enable then
     vim.fn.mkdir(vim.fn.fnamemodify(M.path, ':p'), 'p')
+    vim._luac_read(pack_filename())
+    vim.api.nvim_create_autocmd('VimLeavePre', {
+      group = vim.api.nvim_create_augroup('nvim.loader', {}),
+      callback = function()
+        vim._luac_write(pack_filename())
+      end,
+    })
     _G.loadfile = loadfile_cached
     -- add Lua loader
     table.insert(loaders, 2, loader_cached)
@@ -436,6 +356,8 @@ function M.enable(enable)
       end
     end
   else
+    vim._luac_write(pack_filename())
+    vim.api.nvim_create_augroup('nvim.loader', {})
     _G.loadfile = _loadfile
     for l, loader in ipairs(loaders) do
       if loader == loader_cached or loader == loader_lib_cached then
@@ -476,7 +398,6 @@ end
 --- @param opts vim.loader._profile.Opts?
 function M._profile(opts)
   get_rtp = track('get_rtp', get_rtp)
-  read_cachefile = track('read', read_cachefile)
   loader_cached = track('loader', loader_cached)
   loader_lib_cached = track('loader_lib', loader_lib_cached)
   loadfile_cached = track('loadfile', loadfile_cached)
@@ -630,9 +630,124 @@ local function pack_add(plug, load)
   end
 end
 
+--- Names of Lua modules that add plugins on first `require()`, see |vim.pack.keyset.load|.
+--- @type table<string, fun()>
+local lazy_modules = {}
+
+--- Package loader that adds lazily loaded plugins providing module {modname}.
+--- Returns nothing so that the next loaders find the module on 'runtimepath'.
+--- @param modname string
+local function lazy_module_loader(modname)
+  for name, load in pairs(lazy_modules) do
+    if modname == name or vim.startswith(modname, name .. '.') then
+      load()
+      return
+    end
+  end
+end
+
+--- @param x string|string[]|nil
+--- @return string[]
+local function to_list(x)
+  return type(x) == 'string' and { x } or x or {}
+end
+
+--- Adds plugin on the first of {triggers}.
+--- @param plug vim.pack.Plug
+--- @param triggers vim.pack.keyset.load
+local function pack_add_lazy(plug, triggers)
+  vim.validate('load.event', triggers.event, { 'string', 'table' }, true)
+  vim.validate('load.ft', triggers.ft, { 'string', 'table' }, true)
+  vim.validate('load.cmd', triggers.cmd, { 'string', 'table' }, true)
+  vim.validate('load.module', triggers.module, { 'string', 'table' }, true)
+
+  local group = api.nvim_create_augroup('nvim.pack.lazy.' .. plug.spec.name, {})
+  local cmds = to_list(triggers.cmd)
+  local modules = to_list(triggers.module)
+
+  local function load()
+    if active_plugins[plug.path] then
+      return
+    end
+    api.nvim_del_augroup_by_id(group)
+    for _, cmd in ipairs(cmds) do
+      pcall(api.nvim_del_user_command, cmd)
+    end
+    for _, mod in ipairs(modules) do
+      lazy_modules[mod] = nil
+    end
+    pack_add(plug, true)
+  end
+
+  local events = to_list(triggers.event)
+  if #events > 0 then
+    api.nvim_create_autocmd(events, { group = group, once = true, callback = load })
+  end
+
+  local filetypes = to_list(triggers.ft)
+  if #filetypes > 0 then
+    api.nvim_create_autocmd('FileType', {
+      group = group,
+      pattern = filetypes,
+      once = true,
+      callback = function(ev)
+        load()
+        -- Source the 'ftplugin/' and 'indent/' files the plugin has for this
+        -- filetype, they were looked for before it was added.
+        for _, ft_group in ipairs({ 'filetypeplugin', 'filetypeindent' }) do
+          if vim.fn.exists('#' .. ft_group .. '#FileType') == 1 then
+            api.nvim_exec_autocmds('FileType', { group = ft_group, buffer = ev.buf })
+          end
+        end
+      end,
+    })
+  end
+
+  for _, cmd in ipairs(cmds) do
+    --- @param args vim.api.keyset.create_user_command.command_args
+    api.nvim_create_user_command(cmd, function(args)
+      load()
+      local range = (args.range == 1 and { args.line1 })
+        or (args.range == 2 and { args.line1, args.line2 })
+        or nil
+      vim.cmd({ cmd = cmd, args = args.fargs, bang = args.bang, range = range, mods = args.smods })
+    end, {
+      bang = true,
+      nargs = '*',
+      range = true,
+      complete = function(_, line)
+        load()
+        return vim.fn.getcompletion(line, 'cmdline')
+      end,
+    })
+  end
+
+  if #modules > 0 then
+    for _, mod in ipairs(modules) do
+      lazy_modules[mod] = load
+    end
+    if not vim.tbl_contains(package.loaders, lazy_module_loader) then
+      table.insert(package.loaders, 1, lazy_module_loader)
+    end
+  end
+end
+
+--- Triggers for adding a plugin later, the first one used adds it.
+--- @class vim.pack.keyset.load
+--- @inlinedoc
+--- @field event? string|string[] |autocmd-events|. Autocommands the plugin defines for
+--- the event are not triggered for the occurrence that added it.
+--- @field ft? string|string[] Filetypes, used with the |FileType| event.
+--- @field cmd? string|string[] User commands defined by the plugin. A command
+--- that adds the plugin and then runs the plugin's command is defined until then.
+--- @field module? string|string[] Lua modules, |require()| of one of them or its
+--- submodules adds the plugin.
+
 --- @class vim.pack.keyset.add
 --- @inlinedoc
---- @field load? boolean Load `plugin/` files and `ftdetect/` scripts. If `false`, works like `:packadd!`. Default `true`.
+--- @field load? boolean|vim.pack.keyset.load Load `plugin/` files and `ftdetect/` scripts.
+--- If `false`, works like `:packadd!`. If a table, the plugin is added with |:packadd| on the
+--- first trigger, which avoids sourcing its files at startup. Default `true`.
 
 --- Add plugin to current session
 ---
@@ -679,7 +794,12 @@ function M.add(specs, opts)
   local errors = {} --- @type string[]
   for _, p in ipairs(plugs) do
     if p.info.installed then
-      local ok, err = pcall(pack_add, p, opts.load) --[[@as string]]
+      local ok, err
+      if type(opts.load) == 'table' then
+        ok, err = pcall(pack_add_lazy, p, opts.load)
+      else
+        ok, err = pcall(pack_add, p, opts.load) --[[@as string]]
+      end
       if not ok then
         p.info.err = err
       end
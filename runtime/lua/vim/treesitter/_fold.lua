@@ -201,6 +201,26 @@ local M = {}
 ---@type table<integer,TS.FoldInfo>
 local foldinfos = {}
 
+--- Maximum number of lines for which foldexpr is evaluated at once by `do_foldupdate`.
+local FOLDUPDATE_CHUNK = 1000
+
+--- Schedule a function only if bufnr is loaded.
+--- We schedule fold level computation for the following reasons:
+--- * queries seem to use the old buffer state in on_bytes for some unknown reason;
+--- * to avoid textlock;
+--- * to avoid infinite recursion:
+---   compute_folds_levels → parse → _do_callback → on_changedtree → compute_folds_levels.
+---@param bufnr integer
+---@param fn function
+local function schedule_if_loaded(bufnr, fn)
+  vim.schedule(function()
+    if not api.nvim_buf_is_loaded(bufnr) then
+      return
+    end
+    fn()
+  end)
+end
+
 local group = api.nvim_create_augroup('nvim.treesitter.fold', {})
 
 --- Update the folds in the windows that contain the buffer and use expr foldmethod (assuming that
@@ -253,28 +273,43 @@ function FoldInfo:do_foldupdate(bufnr)
 
   local srow, erow = self.foldupdate_range[1], self.foldupdate_range[2]
   self.foldupdate_range = nil
+  erow = math.min(erow, api.nvim_buf_line_count(bufnr))
+  if srow >= erow then
+    return
+  end
+
+  local wins = {} ---@type integer[]
   for _, win in ipairs(vim.fn.win_findbuf(bufnr)) do
     if vim.wo[win].foldmethod == 'expr' then
-      vim._foldupdate(win, srow, erow)
+      wins[#wins + 1] = win
     end
   end
-end
 
---- Schedule a function only if bufnr is loaded.
---- We schedule fold level computation for the following reasons:
---- * queries seem to use the old buffer state in on_bytes for some unknown reason;
---- * to avoid textlock;
---- * to avoid infinite recursion:
----   compute_folds_levels → parse → _do_callback → on_changedtree → compute_folds_levels.
----@param bufnr integer
----@param fn function
-local function schedule_if_loaded(bufnr, fn)
-  vim.schedule(function()
-    if not api.nvim_buf_is_loaded(bufnr) then
-      return
+  if erow - srow > FOLDUPDATE_CHUNK then
+    -- Evaluating foldexpr for a large range blocks the editor. Update the lines visible in the
+    -- windows first, then the rest in chunks, so that input is handled in between.
+    for _, win in ipairs(wins) do
+      local top = math.max(srow, vim.fn.line('w0', win) - 1)
+      local bot = math.min(erow, vim.fn.line('w$', win))
+      if top < bot then
+        vim._foldupdate(win, top, bot)
+      end
     end
-    fn()
-  end)
+    -- The remaining range is shifted by on_bytes like any other pending update.
+    self.foldupdate_range = { srow + FOLDUPDATE_CHUNK, erow }
+    erow = srow + FOLDUPDATE_CHUNK
+    schedule_if_loaded(bufnr, function()
+      local range = self.foldupdate_range
+      if foldinfos[bufnr] == self and range then
+        self.foldupdate_range = nil
+        self:foldupdate(bufnr, range[1], range[2])
+      end
+    end)
+  end
+
+  for _, win in ipairs(wins) do
+    vim._foldupdate(win, srow, erow)
+  end
 end
 
 ---@param bufnr integer
@@ -6,6 +6,7 @@ error('Cannot require a meta file')
 
 ---@class TSParser: userdata
 ---@field parse fun(self: TSParser, tree: TSTree?, source: integer|string, include_bytes: boolean, timeout_ns: integer?): TSTree?, (Range4|Range6)[]
+---@field _parse_async fun(self: TSParser, tree: TSTree?, source: integer, include_bytes: boolean, timeout_ns: integer?, callback: fun(tree: TSTree?, changes: (Range4|Range6)[]?)): boolean
 ---@field reset fun(self: TSParser)
 ---@field included_ranges fun(self: TSParser, include_bytes: boolean?): integer[]
 ---@field set_included_ranges fun(self: TSParser, ranges: (Range6|TSNode)[])
@@ -75,6 +76,16 @@ local TSQueryCursor = {} -- luacheck: no unused
 --- @return TSQueryMatch match
 function TSQueryCursor:next_capture() end
 
+--- @param out integer[]
+--- @param offset integer
+--- @param max integer
+--- @param query TSQuery
+--- @return integer count
+--- @return integer? capture
+--- @return TSNode? captured_node
+--- @return TSQueryMatch? match
+function TSQueryCursor:_next_capture_ranges(out, offset, max, query) end
+
 --- @return TSQueryMatch match
 function TSQueryCursor:next_match() end
 
@@ -1,6 +1,7 @@
 local api = vim.api
 local query = vim.treesitter.query
 local Range = require('vim.treesitter._range')
+local add_ephemeral_hl = vim._add_ephemeral_hl
 
 local ns = api.nvim_create_namespace('nvim.treesitter.highlighter')
 
@@ -52,7 +53,24 @@ function TSHighlighterQuery:query()
   return self._query
 end
 
----@alias MarkInfo { start_line: integer, start_col: integer, opts: vim.api.keyset.set_extmark }
+---@class (private) MarkInfo
+---@field start_line integer
+---@field start_col integer
+---@field end_line integer
+---@field end_col integer
+---@field hl_group integer
+---@field priority integer
+---@field conceal string?
+---@field spell boolean?
+---@field url string?
+
+--- A highlight added to a line: the clipped range and the mark it came from.
+---@alias vim.treesitter.highlighter.LineMark { [1]: integer, [2]: integer, [3]: integer, [4]: integer, [5]: MarkInfo }
+
+--- Highlights of the lines of one tree, valid while the tree and its query don't change.
+---@class (private) vim.treesitter.highlighter.LineCache
+---@field query vim.treesitter.highlighter.Query
+---@field lines table<integer, vim.treesitter.highlighter.LineMark[]>
 
 ---@class (private) vim.treesitter.highlighter.State
 ---@field tstree TSTree
@@ -72,6 +90,9 @@ end
 ---@field private _queries table<string,vim.treesitter.highlighter.Query>
 ---@field  _conceal_line boolean?
 ---@field  _conceal_checked table<integer, boolean>
+--- Highlights of already drawn lines, by tree. Trees are immutable (edits make a copy), so the
+--- entries stay valid for as long as the tree is in use; weak keys drop them with the tree.
+---@field private _line_caches table<TSTree, vim.treesitter.highlighter.LineCache>
 ---@field tree vim.treesitter.LanguageTree
 ---@field private redraw_count integer
 --- A map from window ID to whether we are currently parsing that window asynchronously
@@ -145,6 +166,7 @@ function TSHighlighter.new(tree, opts)
   self._conceal_checked = {}
   self._queries = {}
   self._highlight_states = {}
+  self._line_caches = setmetatable({}, { __mode = 'k' })
   self.parsing = {}
 
   -- Queries for a specific language can be overridden by a custom
@@ -330,7 +352,8 @@ end
 ---@param buf integer
 ---@param line integer
 ---@param next_marks MarkInfo[]
-local function add_mark(m, buf, line, next_marks)
+---@param record? vim.treesitter.highlighter.LineMark[] list to record the added highlight in
+local function add_mark(m, buf, line, next_marks, record)
   local cur_start_l = m.start_line
   local cur_start_c = m.start_col
   if cur_start_l < line then
@@ -338,19 +361,45 @@ local function add_mark(m, buf, line, next_marks)
     cur_start_c = 0
   end
 
-  local cur_opts = m.opts
-  if cur_opts.end_line >= line + 1 then
-    cur_opts = vim.deepcopy(cur_opts, true)
-    cur_opts.end_line = line + 1
-    cur_opts.end_col = 0
+  local cur_end_l = m.end_line
+  local cur_end_c = m.end_col
+  if cur_end_l >= line + 1 then
+    cur_end_l = line + 1
+    cur_end_c = 0
     table.insert(next_marks, m)
   end
 
-  local empty = cur_opts.end_line < cur_start_l
-    or (cur_opts.end_line == cur_start_l and cur_opts.end_col <= cur_start_c)
+  local empty = cur_end_l < cur_start_l or (cur_end_l == cur_start_l and cur_end_c <= cur_start_c)
   if cur_start_l <= line and not empty then
-    api.nvim_buf_set_extmark(buf, ns, cur_start_l, cur_start_c, cur_opts)
+    if record then
+      record[#record + 1] = { cur_start_l, cur_start_c, cur_end_l, cur_end_c, m }
+    end
+    add_ephemeral_hl(
+      buf,
+      ns,
+      cur_start_l,
+      cur_start_c,
+      cur_end_l,
+      cur_end_c,
+      m.hl_group,
+      m.priority,
+      m.conceal,
+      m.spell,
+      m.url
+    )
+  end
+end
+
+---@param self vim.treesitter.highlighter
+---@param state vim.treesitter.highlighter.State
+---@return table<integer, vim.treesitter.highlighter.LineMark[]>
+local function get_line_cache(self, state)
+  local cache = self._line_caches[state.tstree]
+  if not cache or cache.query ~= state.highlighter_query then
+    cache = { query = state.highlighter_query, lines = {} }
+    self._line_caches[state.tstree] = cache
   end
+  return cache.lines
 end
 
 ---@param self vim.treesitter.highlighter
@@ -370,21 +419,49 @@ local function on_line_impl(self, win, buf, line, on_spell, on_conceal)
       return
     end
 
-    local tree_region = state.tstree:included_ranges(true)
-
-    local next_marks = {}
-
-    for _, mark in ipairs(state.prev_marks) do
-      add_mark(mark, buf, line, next_marks)
+    -- Spell and conceal_lines checks only add some of the highlights, don't cache those.
+    local line_cache = not on_spell and not on_conceal and get_line_cache(self, state) or nil
+    local cached = line_cache and line_cache[line]
+    if cached then
+      for _, lm in ipairs(cached) do
+        local m = lm[5]
+        add_ephemeral_hl(
+          buf,
+          ns,
+          lm[1],
+          lm[2],
+          lm[3],
+          lm[4],
+          m.hl_group,
+          m.priority,
+          m.conceal,
+          m.spell,
+          m.url
+        )
+      end
+      return
     end
+    local record = line_cache and {} or nil ---@type vim.treesitter.highlighter.LineMark[]?
+
+    local tree_region = state.tstree:included_ranges(true)
 
     if state.iter == nil or state.next_row < line then
-      -- Mainly used to skip over folds
+      -- Mainly used to skip over folds and lines drawn from the cache. The new iterator also
+      -- returns the captures which started before this line, so the marks carried over from
+      -- the last drawn line are not needed.
 
       -- TODO(lewis6991): Creating a new iterator loses the cached predicate results for query
       -- matches. Move this logic inside iter_captures() so we can maintain the cache.
       state.iter =
         state.highlighter_query:query():iter_captures(root_node, self.bufnr, line, root_end_row + 1)
+      state.next_row = line
+      state.prev_marks = {}
+    end
+
+    local next_marks = {}
+
+    for _, mark in ipairs(state.prev_marks) do
+      add_mark(mark, buf, line, next_marks, record)
     end
 
     local captures = state.highlighter_query:query().captures
@@ -422,20 +499,25 @@ local function on_line_impl(self, win, buf, line, on_spell, on_conceal)
             local url = get_url(match, buf, capture, metadata)
 
             if hl and end_row >= line and not on_conceal and (not on_spell or spell ~= nil) then
-              local opts = {
+              local mark = {
+                start_line = start_row,
+                start_col = start_col,
                 end_line = end_row,
                 end_col = end_col,
                 hl_group = hl,
-                ephemeral = true,
                 priority = priority,
                 conceal = conceal,
                 spell = spell,
                 url = url,
               }
-              local mark = { start_line = start_row, start_col = start_col, opts = opts }
-              add_mark(mark, buf, line, next_marks)
+              add_mark(mark, buf, line, next_marks, record)
             end
 
+            if metadata.conceal_lines or metadata[capture] and metadata[capture].conceal_lines then
+              -- Placed as a real extmark which may be cleared again, check it on every redraw.
+              record = nil
+              line_cache = nil
+            end
             if
               (metadata.conceal_lines or metadata[capture] and metadata[capture].conceal_lines)
               and #api.nvim_buf_get_extmarks(buf, ns, { start_row, 0 }, { start_row, 0 }, {}) == 0
@@ -455,6 +537,9 @@ local function on_line_impl(self, win, buf, line, on_spell, on_conceal)
     end
 
     state.prev_marks = next_marks
+    if line_cache then
+      line_cache[line] = record
+    end
   end)
 end
 
@@ -68,7 +68,14 @@ local entire_document_range = {
 ---| 'on_child_added'
 ---| 'on_child_removed'
 
----@alias ParserThreadState { timeout: integer? }
+---@class ParserThreadState
+---@field timeout? integer
+---
+--- Set by an asynchronous parse: resumes it once a parse started on a worker thread finishes.
+---@field resume? fun()
+---@field worker_timeout? integer
+---@field waiting? boolean
+---@field timed_out? boolean
 
 --- @type table<TSCallbackNameOn,TSCallbackName>
 local TSCallbackNames = {
@@ -382,9 +389,28 @@ function LanguageTree:_parse_regions(range, thread_state)
   local no_regions_parsed = 0
   local total_parse_time = 0
 
+  --- @param i integer
+  --- @param tree TSTree
+  --- @param tree_changes Range6[]
+  local function set_tree(i, tree, tree_changes)
+    self:_do_callback('changedtree', tree_changes, tree)
+    self._trees[i] = tree
+    vim.list_extend(changes, tree_changes)
+
+    no_regions_parsed = no_regions_parsed + 1
+    self._valid_regions[i] = true
+    self._num_valid_regions = self._num_valid_regions + 1
+
+    if self._num_valid_regions == self._num_regions then
+      self._is_entirely_valid = true
+    end
+  end
+
   -- If there are no ranges, set to an empty list
   -- so the included ranges in the parser are cleared.
-  for i, ranges in pairs(self:included_regions()) do
+  local regions = self:included_regions()
+  local todo = {} ---@type integer[]
+  for i, ranges in pairs(regions) do
     if
       not self._valid_regions[i]
       and (
@@ -392,9 +418,43 @@ function LanguageTree:_parse_regions(range, thread_state)
         or (self._trees[i] and intercepts_region(self._trees[i]:included_ranges(false), range))
       )
     then
-      self._parser:set_included_ranges(ranges)
+      todo[#todo + 1] = i
+    end
+  end
+
+  for k, i in ipairs(todo) do
+    self._parser:set_included_ranges(regions[i])
+
+    local parse_time, tree, tree_changes = tcall(
+      self._parser.parse,
+      self._parser,
+      self._trees[i],
+      self._source,
+      true,
+      thread_state.timeout
+    )
+    local tried_worker = false
+    while true do
+      if tree then
+        break
+      end
+      if thread_state.resume and not tried_worker and type(self._source) == 'number' then
+        -- Didn't finish within the time slice: hand the rest to a worker thread
+        -- instead of blocking the main loop with more slices.
+        tried_worker = true
+        local started
+        started, tree, tree_changes = self:_parse_on_worker(self._trees[i], thread_state)
+        if started then
+          if not tree then
+            thread_state.timed_out = true
+            coroutine.yield(self._trees, false)
+          end
+          break
+        end
+      end
+      coroutine.yield(self._trees, false)
 
-      local parse_time, tree, tree_changes = tcall(
+      parse_time, tree, tree_changes = tcall(
         self._parser.parse,
         self._parser,
         self._trees[i],
@@ -402,40 +462,124 @@ function LanguageTree:_parse_regions(range, thread_state)
         true,
         thread_state.timeout
       )
-      while true do
-        if tree then
-          break
-        end
-        coroutine.yield(self._trees, false)
+    end
 
-        parse_time, tree, tree_changes = tcall(
-          self._parser.parse,
-          self._parser,
-          self._trees[i],
-          self._source,
-          true,
-          thread_state.timeout
-        )
-      end
+    set_tree(i, tree, tree_changes)
+    total_parse_time = total_parse_time + parse_time
+
+    -- Out of time with several regions left (e.g. many injections): parse the rest
+    -- concurrently on worker threads instead of one after another in later time slices.
+    if
+      thread_state.timeout
+      and thread_state.timeout <= parse_time
+      and #todo - k >= 2
+      and self:_parse_regions_on_workers(regions, todo, k + 1, thread_state, set_tree)
+    then
+      break
+    end
+
+    self:_subtract_time(thread_state, parse_time)
+  end
+
+  return changes, no_regions_parsed, total_parse_time
+end
 
-      self:_subtract_time(thread_state, parse_time)
+--- Parses regions of the buffer concurrently on worker threads, yielding until all are done.
+---
+--- @private
+--- @param regions Range6[][]
+--- @param todo integer[] indexes of the regions to parse
+--- @param first integer index in {todo} of the first region to parse
+--- @param thread_state ParserThreadState
+--- @param on_tree fun(i: integer, tree: TSTree, tree_changes: Range6[])
+--- @return boolean started false if the parser can't run on worker threads
+function LanguageTree:_parse_regions_on_workers(regions, todo, first, thread_state, on_tree)
+  if not thread_state.resume or type(self._source) ~= 'number' then
+    return false
+  end
+
+  local pending = 0
+  local results = {} ---@type table<integer, { [1]: TSTree?, [2]: Range6[]? }>
+  for k = first, #todo do
+    local i = todo[k]
+    self._parser:set_included_ranges(regions[i])
+    local started = self._parser:_parse_async(
+      self._trees[i],
+      self._source,
+      true,
+      thread_state.worker_timeout,
+      function(tree, tree_changes)
+        results[i] = { tree, tree_changes }
+        pending = pending - 1
+        if pending == 0 and thread_state.resume then
+          thread_state.resume()
+        end
+      end
+    )
+    if not started then
+      if pending == 0 then
+        return false
+      end
+      -- The remaining regions stay invalid and get parsed by the next parse.
+      break
+    end
+    pending = pending + 1
+  end
 
-      self:_do_callback('changedtree', tree_changes, tree)
-      self._trees[i] = tree
-      vim.list_extend(changes, tree_changes)
+  thread_state.waiting = true
+  while pending > 0 do
+    coroutine.yield(self._trees, false)
+  end
+  thread_state.waiting = false
 
-      total_parse_time = total_parse_time + parse_time
-      no_regions_parsed = no_regions_parsed + 1
-      self._valid_regions[i] = true
-      self._num_valid_regions = self._num_valid_regions + 1
+  -- Apply the results in region order, like a sequential parse would.
+  for k = first, #todo do
+    local i = todo[k]
+    local result = results[i]
+    if result then
+      if not result[1] then
+        thread_state.timed_out = true
+        coroutine.yield(self._trees, false)
+      end
+      on_tree(i, result[1], result[2])
+    end
+  end
+  return true
+end
 
-      if self._num_valid_regions == self._num_regions then
-        self._is_entirely_valid = true
+--- Parses the buffer on a worker thread, yielding until the result arrives.
+---
+--- @private
+--- @param old_tree TSTree?
+--- @param thread_state ParserThreadState
+--- @return boolean started false if the parser can't run on a worker thread
+--- @return TSTree? tree nil if the worker parse timed out
+--- @return Range6[]? changes
+function LanguageTree:_parse_on_worker(old_tree, thread_state)
+  local done = false
+  local tree, changes ---@type TSTree?, Range6[]?
+  local started = self._parser:_parse_async(
+    old_tree,
+    self._source,
+    true,
+    thread_state.worker_timeout,
+    function(t, c)
+      done, tree, changes = true, t, c
+      if thread_state.resume then
+        thread_state.resume()
       end
     end
+  )
+  if not started then
+    return false
   end
 
-  return changes, no_regions_parsed, total_parse_time
+  thread_state.waiting = true
+  while not done do
+    coroutine.yield(self._trees, false)
+  end
+  thread_state.waiting = false
+  return true, tree, changes
 end
 
 --- @private
@@ -521,12 +665,19 @@ function LanguageTree:_async_parse(range, on_parse)
   local total_parse_time = 0
   local redrawtime = vim.o.redrawtime * 1000000
 
-  local thread_state = {} ---@type ParserThreadState
+  local thread_state ---@type ParserThreadState
+  local step ---@type fun(): table<integer, TSTree>?
+
+  -- Each parse coroutine gets its own state, so that a worker thread still running
+  -- for an abandoned coroutine can't resume the current one.
+  local function new_thread_state()
+    return { resume = step, worker_timeout = redrawtime }
+  end
 
   ---@type fun(): table<integer, TSTree>, boolean
   local parse = coroutine.wrap(self._parse)
 
-  local function step()
+  step = function()
     if is_buffer_parser then
       if
         not vim.api.nvim_buf_is_valid(source --[[@as number]])
@@ -538,6 +689,8 @@ function LanguageTree:_async_parse(range, on_parse)
       if buf.changedtick ~= ct then
         ct = buf.changedtick
         total_parse_time = 0
+        thread_state.resume = nil
+        thread_state = new_thread_state()
         parse = coroutine.wrap(self._parse)
       end
     end
@@ -549,14 +702,15 @@ function LanguageTree:_async_parse(range, on_parse)
     if finished then
       self:_run_async_callbacks(range, nil, trees)
       return trees
-    elseif total_parse_time > redrawtime then
+    elseif total_parse_time > redrawtime or thread_state.timed_out then
       self:_run_async_callbacks(range, 'TIMEOUT', nil)
       return nil
-    else
+    elseif not thread_state.waiting then
       vim.schedule(step)
     end
   end
 
+  thread_state = new_thread_state()
   return step()
 end
 
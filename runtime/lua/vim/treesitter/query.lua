@@ -1024,6 +1024,88 @@ function Query:iter_captures(node, source, start, stop, opts)
   return iter
 end
 
+--- Gets the ranges of all captures from all matches in {node}.
+---
+--- Like |Query:iter_captures()|, but returns only the capture ids and ranges, in one flat list,
+--- without creating a |TSNode| for each capture. This is much cheaper when many captures are
+--- needed and their nodes are not. Ranges changed by directives (e.g. `#offset!`) are used.
+---
+--- Example: print the range of every capture:
+--- ```lua
+--- local ranges = query:capture_ranges(tree:root(), bufnr, first, last)
+--- for i = 1, #ranges, 5 do
+---   local id, row1, col1, row2, col2 = unpack(ranges, i, i + 4)
+---   print(query.captures[id], row1, col1, row2, col2)
+--- end
+--- ```
+---
+---@param node TSNode under which the search will occur
+---@param source (integer|string) Source buffer or string to extract text from
+---@param start? integer Starting line for the search. Defaults to `node:start()`.
+---@param stop? integer Stopping line for the search (end-exclusive). Defaults to `node:end_()`.
+---@param opts? table Optional keyword arguments, see |Query:iter_captures()|.
+---
+---@return integer[] # 5 integers for each capture: capture id, start row, start col, end row,
+---        end col
+function Query:capture_ranges(node, source, start, stop, opts)
+  opts = opts or {}
+  opts.match_limit = opts.match_limit or 256
+
+  if type(source) == 'number' and source == 0 then
+    source = api.nvim_get_current_buf()
+  end
+
+  start, stop = value_or_node_range(start, stop, node)
+
+  local cursor = vim._create_ts_querycursor(node, self.query, start, stop, opts)
+
+  local ranges = {} ---@type integer[]
+  local n = 0
+  -- Metadata of the matches with predicates seen so far, false if the predicates failed.
+  ---@type table<integer, vim.treesitter.query.TSMetadata|false>
+  local match_cache = {}
+
+  while true do
+    local count, capture, captured_node, match =
+      cursor:_next_capture_ranges(ranges, n, 1024, self.query)
+    n = n + count * 5
+
+    if capture then
+      local match_id, pattern_i = match:info()
+      local metadata = match_cache[match_id]
+      if metadata == nil then
+        metadata = {}
+        local processed_pattern = self._processed_patterns[pattern_i]
+        if processed_pattern then
+          local captures = match:captures()
+          if self:_match_predicates(processed_pattern.predicates, pattern_i, captures, source) then
+            metadata =
+              self:_apply_directives(processed_pattern.directives, pattern_i, captures, source)
+          else
+            cursor:remove_match(match_id)
+            metadata = false
+          end
+        end
+        match_cache[match_id] = metadata
+      end
+
+      if metadata then
+        local range = vim.treesitter.get_range(captured_node, source, metadata[capture])
+        ranges[n + 1] = capture
+        ranges[n + 2] = range[1]
+        ranges[n + 3] = range[2]
+        ranges[n + 4] = range[4]
+        ranges[n + 5] = range[5]
+        n = n + 5
+      end
+    elseif count < 1024 then
+      break
+    end
+  end
+
+  return ranges
+end
+
 --- Iterates the matches of self on a given range.
 ---
 --- Iterate over all matches within a {node}. The arguments are the same as for
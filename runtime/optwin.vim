@@ -694,6 +694,9 @@ call <SID>Header(gettext("editing text"))
 call <SID>AddOption("undolevels", gettext("maximum number of changes that can be undone"))
 call append("$", "\t" .. s:global_or_local)
 call append("$", " \tset ul=" . s:old_ul)
+call <SID>AddOption("undomemory", gettext("maximum memory in Kbyte used for undo"))
+call append("$", "\t" .. s:global_or_local)
+call append("$", " \tset um=" . &um)
 call <SID>AddOption("undofile", gettext("automatically save and restore undo history"))
 call <SID>BinOptionG("udf", &udf)
 call <SID>AddOption("undodir", gettext("list of directories for undo files"))
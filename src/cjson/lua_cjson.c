@@ -47,6 +47,9 @@
 #include <limits.h>
 #include <lua.h>
 #include <lauxlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "nvim/lua/executor.h"
 
@@ -195,6 +198,7 @@ typedef struct {
 typedef struct {
     const char *data;
     const char *ptr;
+    const char *end;  /* data + length of data */
     strbuf_t *tmp;    /* Temporary storage for strings */
     json_config_t *cfg;
     json_options_t *options;
@@ -1178,6 +1182,35 @@ static void json_set_token_error(json_token_t *token, json_parse_t *json,
     token->value.string = errtype;
 }
 
+/* Returns the number of bytes from ptr that need no decoding: anything but
+ * '"', '\\' and NUL. Checks 16 bytes at a time when SSE2 is available. */
+static size_t json_string_run_len(const char *ptr, const char *end)
+{
+    const char *p = ptr;
+
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                    _mm_cmpeq_epi8(v, backslash)),
+                                       _mm_cmpeq_epi8(v, zero));
+        int mask = _mm_movemask_epi8(special);
+        if (mask)
+            return (size_t)(p - ptr) + (size_t)__builtin_ctz((unsigned)mask);
+        p += 16;
+    }
+#endif
+
+    while (p < end && *p != '"' && *p != '\\' && *p)
+        p++;
+
+    return (size_t)(p - ptr);
+}
+
 static void json_next_string_token(json_parse_t *json, json_token_t *token)
 {
     char *escape2char = json->cfg->escape2char;
@@ -1196,6 +1229,14 @@ static void json_next_string_token(json_parse_t *json, json_token_t *token)
     strbuf_reset(json->tmp);
 
     while ((ch = *json->ptr) != '"') {
+        /* Append characters which need no decoding at once */
+        size_t run = json_string_run_len(json->ptr, json->end);
+        if (run) {
+            strbuf_append_mem_unsafe(json->tmp, json->ptr, run);
+            json->ptr += run;
+            continue;
+        }
+
         if (!ch) {
             /* Premature end of the string */
             json_set_token_error(token, json, "unexpected end of string");
@@ -1291,8 +1332,28 @@ static int json_is_invalid_number(json_parse_t *json)
 
 static void json_next_number_token(json_parse_t *json, json_token_t *token)
 {
+    const char *p = json->ptr;
     char *endptr;
 
+    /* Fast path for integers short enough not to overflow, which is what
+     * most numbers are (e.g. LSP positions and semantic tokens) */
+    int negative = *p == '-';
+    if (negative)
+        p++;
+    const char *digits = p;
+    uint64_t value = 0;
+    while ('0' <= *p && *p <= '9' && p - digits < 18) {
+        value = value * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    if (p != digits && !('0' <= *p && *p <= '9') && *p != '.' &&
+        *p != 'e' && *p != 'E' && *p != 'x') {
+        token->type = T_INTEGER;
+        token->value.integer = negative ? -(lua_Integer)value : (lua_Integer)value;
+        json->ptr = p;
+        return;
+    }
+
     token->value.integer = strtoll(json->ptr, &endptr, 10);
     if (json->ptr == endptr || *endptr == '.' || *endptr == 'e' ||
         *endptr == 'E' || *endptr == 'x') {
@@ -1609,6 +1670,7 @@ static int json_decode(lua_State *l)
     json.options = &options;
     json.current_depth = 0;
     json.ptr = json.data;
+    json.end = json.data + json_len;
 
     /* Detect Unicode other than UTF-8 (see RFC 4627, Sec 3)
      *
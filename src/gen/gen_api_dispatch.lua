@@ -273,6 +273,26 @@ for _, f in ipairs(shallowcopy(functions)) do
   end
 end
 
+--- @type {[string]: gen_api_dispatch.Function, redraw: {impl_name: string, fast: boolean}}
+local remote_fns = {}
+for _, fn in ipairs(functions) do
+  if fn.remote then
+    remote_fns[fn.name] = fn
+  end
+end
+remote_fns.redraw = { impl_name = 'ui_client_redraw', fast = true }
+
+local names = vim.tbl_keys(remote_fns)
+table.sort(names)
+local hashorder, hashfun = hashy.hashy_hash('msgpack_rpc_get_handler_for', names, function(idx)
+  return 'method_handlers[' .. idx .. '].name'
+end)
+
+-- the index in method_handlers[] is the "method_id" of the function
+for n, name in ipairs(hashorder) do
+  remote_fns[name].handler_id = n - 1
+end
+
 --- don't expose internal attributes like "impl_name" in public metadata
 --- @class gen_api_dispatch.Function.Exported
 --- @field name string
@@ -281,6 +301,7 @@ end
 --- @field method boolean
 --- @field since integer
 --- @field deprecated_since integer
+--- @field method_id integer?
 
 --- @type gen_api_dispatch.Function.Exported[]
 local exported_functions = {}
@@ -293,6 +314,7 @@ for _, f in ipairs(functions) do
       method = f.method,
       since = f.since,
       deprecated_since = f.deprecated_since,
+      method_id = f.remote and f.handler_id or nil,
       parameters = {},
       return_type = real_type(f.return_type, true),
     }
@@ -718,25 +740,10 @@ for i = 1, #functions do
   end
 end
 
---- @type {[string]: gen_api_dispatch.Function, redraw: {impl_name: string, fast: boolean}}
-local remote_fns = {}
-for _, fn in ipairs(functions) do
-  if fn.remote then
-    remote_fns[fn.name] = fn
-  end
-end
-remote_fns.redraw = { impl_name = 'ui_client_redraw', fast = true }
-
-local names = vim.tbl_keys(remote_fns)
-table.sort(names)
-local hashorder, hashfun = hashy.hashy_hash('msgpack_rpc_get_handler_for', names, function(idx)
-  return 'method_handlers[' .. idx .. '].name'
-end)
 
 output:write('const MsgpackRpcRequestHandler method_handlers[] = {\n')
-for n, name in ipairs(hashorder) do
+for _, name in ipairs(hashorder) do
   local fn = remote_fns[name]
-  fn.handler_id = n - 1
   output:write(
     '  { .name = "'
       .. name
@@ -750,6 +757,7 @@ for n, name in ipairs(hashorder) do
   )
 end
 output:write('};\n\n')
+output:write('const size_t method_handlers_size = ' .. #hashorder .. ';\n\n')
 output:write(hashfun)
 
 output:close()
@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <lauxlib.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -386,6 +387,10 @@ cleanup:
 ///             only once |autocmd-once|.
 ///             - nested (boolean) optional: defaults to false. Run nested
 ///             autocommands |autocmd-nested|.
+///             - debounce (integer) optional: milliseconds to wait before running the
+///             autocommand, restarted when the event is triggered again for the same buffer.
+///             Repeated events run it only once, with the file and data of the last one, and
+///             without |v:event|. Useful for |CursorMoved| and |TextChangedI|.
 ///
 /// @return Autocommand id (number)
 /// @see |autocommand|
@@ -466,6 +471,10 @@ Integer nvim_create_autocmd(uint64_t channel_id, Object event, Dict(create_autoc
     desc = opts->desc.data;
   }
 
+  VALIDATE_RANGE((opts->debounce >= 0 && opts->debounce <= INT_MAX), "debounce", {
+    goto cleanup;
+  });
+
   VALIDATE_R((event_array.size > 0), "event", {
     goto cleanup;
   });
@@ -485,6 +494,7 @@ Integer nvim_create_autocmd(uint64_t channel_id, Object event, Dict(create_autoc
                                   au_group,
                                   opts->once,
                                   opts->nested,
+                                  (int)opts->debounce,
                                   desc,
                                   handler_cmd,
                                   &handler_fn);
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "klib/kvec.h"
@@ -157,6 +158,12 @@ Integer nvim_buf_line_count(Buffer buffer, Error *err)
 ///               region, as args to `on_lines`.
 ///             - preview: also attach to command preview (i.e. 'inccommand')
 ///               events.
+///             - batch: queue changes and deliver them once per main loop
+///               iteration (and before redraw) instead of on every change.
+///               Adjacent changes are merged: `on_lines` is called once with
+///               the range covering all changed lines, where byte counts are
+///               summed, and `on_bytes` is called once for each run of
+///               changes which start where the previous one ended.
 /// @param[out] err Error details, if any
 /// @return False if attach failed (invalid parameter, or buffer isn't loaded);
 ///         otherwise True. TODO: LUA_API_NO_EVAL
@@ -201,6 +208,8 @@ Boolean nvim_buf_attach(uint64_t channel_id, Buffer buffer, Boolean send_buffer,
     cb.utf_sizes = opts->utf_sizes;
 
     cb.preview = opts->preview;
+
+    cb.batch = opts->batch;
   }
 
   return buf_updates_register(buf, channel_id, cb, send_buffer);
@@ -292,6 +301,19 @@ ArrayOf(String) nvim_buf_get_lines(uint64_t channel_id,
   return rv;
 }
 
+/// Gets a line of text from the replacement lines of an API call, with NULs
+/// converted to newlines as required by NL-used-for-NUL.
+///
+/// The decoded arguments of a request from a channel belong to the request and
+/// are NUL terminated, they are changed in place instead of copied.
+static char *replacement_line(uint64_t channel_id, String l, Arena *arena)
+{
+  char *line = (channel_id != 0 && !is_internal_call(channel_id))
+               ? l.data : arena_memdupz(arena, l.data, l.size);
+  memchrsub(line, NUL, NL, l.size);
+  return line;
+}
+
 /// Sets (replaces) a line-range in the buffer.
 ///
 /// Indexing is zero-based, end-exclusive. Negative indices are interpreted
@@ -353,12 +375,7 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
   char **lines = (new_len != 0) ? arena_alloc(arena, new_len * sizeof(char *), true) : NULL;
 
   for (size_t i = 0; i < new_len; i++) {
-    const String l = replacement.items[i].data.string;
-
-    // Fill lines[i] with l's contents. Convert NULs to newlines as required by
-    // NL-used-for-NUL.
-    lines[i] = arena_memdupz(arena, l.data, l.size);
-    memchrsub(lines[i], NUL, NL, l.size);
+    lines[i] = replacement_line(channel_id, replacement.items[i].data.string, arena);
   }
 
   TRY_WRAP(err, {
@@ -410,21 +427,27 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
     }
 
     // Now we may need to insert the remaining new old_len
-    for (size_t i = to_replace; i < new_len; i++) {
-      int64_t lnum = start + (int64_t)i - 1;
+    if (to_replace < new_len) {
+      int64_t lnum = start + (int64_t)to_replace - 1;
+      size_t count = new_len - to_replace;
 
-      VALIDATE(lnum < MAXLNUM, "%s", "Index out of bounds", {
+      VALIDATE(lnum + (int64_t)count - 1 < MAXLNUM, "%s", "Index out of bounds", {
         goto end;
       });
 
-      if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+      colnr_T *lens = arena_alloc(arena, count * sizeof(colnr_T), true);
+      for (size_t i = 0; i < count; i++) {
+        lens[i] = (colnr_T)replacement.items[to_replace + i].data.string.size + 1;
+        inserted_bytes += lens[i];
+      }
+
+      if (ml_append_buf_many(buf, (linenr_T)lnum, lines + to_replace, lens, (int)count,
+                             false) == FAIL) {
         api_set_error(err, kErrorTypeException, "Failed to insert line");
         goto end;
       }
 
-      inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
-
-      extra++;
+      extra += (ptrdiff_t)count;
     }
 
     // Adjust marks. Invalidate any which lie in the
@@ -509,18 +532,13 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
     return;
   });
 
-  // Another call to ml_get_buf() may free the lines, so we make copies
-  char *str_at_start = ml_get_buf(buf, (linenr_T)start_row);
   colnr_T len_at_start = ml_get_buf_len(buf, (linenr_T)start_row);
-  str_at_start = arena_memdupz(arena, str_at_start, (size_t)len_at_start);
   start_col = start_col < 0 ? len_at_start + start_col + 1 : start_col;
   VALIDATE_RANGE((start_col >= 0 && start_col <= len_at_start), "start_col", {
     return;
   });
 
-  char *str_at_end = ml_get_buf(buf, (linenr_T)end_row);
   colnr_T len_at_end = ml_get_buf_len(buf, (linenr_T)end_row);
-  str_at_end = arena_memdupz(arena, str_at_end, (size_t)len_at_end);
   end_col = end_col < 0 ? len_at_end + end_col + 1 : end_col;
   VALIDATE_RANGE((end_col >= 0 && end_col <= len_at_end), "end_col", {
     return;
@@ -536,6 +554,46 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
     return;
   }
 
+  TRY_WRAP(err, {
+    if (!MODIFIABLE(buf)) {
+      api_set_error(err, kErrorTypeException, "Buffer is not 'modifiable'");
+      goto end;
+    }
+
+    // Small note about undo states: unlike set_lines, we want to save the
+    // undo state of one past the end_row, since end_row is inclusive.
+    if (u_save_buf(buf, (linenr_T)start_row - 1, (linenr_T)end_row + 1) == FAIL) {
+      api_set_error(err, kErrorTypeException, "Failed to save undo information");
+      goto end;
+    }
+
+    buf_set_text(channel_id, buf, start_row, start_col, end_row, end_col, replacement, false,
+                 arena, err);
+    end:;
+  });
+}
+
+/// Replaces the text from ("start_row", "start_col") to ("end_row", "end_col")
+/// with "replacement", see nvim_buf_set_text(). The rows are line numbers, the
+/// positions and "replacement" must be valid and undo information must have
+/// been saved.
+///
+/// @param batch  Don't call changed_lines(), the caller does that once for
+///               several edits.
+/// @return  number of lines added, negative when lines were deleted.
+static ptrdiff_t buf_set_text(uint64_t channel_id, buf_T *buf, Integer start_row,
+                              Integer start_col, Integer end_row, Integer end_col,
+                              Array replacement, bool batch, Arena *arena, Error *err)
+{
+  // Another call to ml_get_buf() may free the lines, so we make copies
+  char *str_at_start = ml_get_buf(buf, (linenr_T)start_row);
+  colnr_T len_at_start = ml_get_buf_len(buf, (linenr_T)start_row);
+  str_at_start = arena_memdupz(arena, str_at_start, (size_t)len_at_start);
+
+  char *str_at_end = ml_get_buf(buf, (linenr_T)end_row);
+  colnr_T len_at_end = ml_get_buf_len(buf, (linenr_T)end_row);
+  str_at_end = arena_memdupz(arena, str_at_end, (size_t)len_at_end);
+
   size_t new_len = replacement.size;
 
   bcount_t new_byte = 0;
@@ -580,11 +638,7 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
   new_byte += (bcount_t)(first_item.size);
   for (size_t i = 1; i < new_len - 1; i++) {
     const String l = replacement.items[i].data.string;
-
-    // Fill lines[i] with l's contents. Convert NULs to newlines as required by
-    // NL-used-for-NUL.
-    lines[i] = arena_memdupz(arena, l.data, l.size);
-    memchrsub(lines[i], NUL, NL, l.size);
+    lines[i] = replacement_line(channel_id, l, arena);
     new_byte += (bcount_t)(l.size) + 1;
   }
   if (replacement.size > 1) {
@@ -592,97 +646,257 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
     new_byte += (bcount_t)(last_item.size) + 1;
   }
 
-  TRY_WRAP(err, {
-    if (!MODIFIABLE(buf)) {
-      api_set_error(err, kErrorTypeException, "Buffer is not 'modifiable'");
-      goto end;
+  ptrdiff_t extra = 0;  // lines added to text, can be negative
+  size_t old_len = (size_t)(end_row - start_row + 1);
+
+  // If the size of the range is reducing (ie, new_len < old_len) we
+  // need to delete some old_len. We do this at the start, by
+  // repeatedly deleting line "start".
+  size_t to_delete = (new_len < old_len) ? old_len - new_len : 0;
+  for (size_t i = 0; i < to_delete; i++) {
+    if (ml_delete_buf(buf, (linenr_T)start_row, false) == FAIL) {
+      api_set_error(err, kErrorTypeException, "Failed to delete line");
+      return extra;
     }
+  }
 
-    // Small note about undo states: unlike set_lines, we want to save the
-    // undo state of one past the end_row, since end_row is inclusive.
-    if (u_save_buf(buf, (linenr_T)start_row - 1, (linenr_T)end_row + 1) == FAIL) {
-      api_set_error(err, kErrorTypeException, "Failed to save undo information");
-      goto end;
-    }
+  if (to_delete > 0) {
+    extra -= (ptrdiff_t)to_delete;
+  }
 
-    ptrdiff_t extra = 0;  // lines added to text, can be negative
-    size_t old_len = (size_t)(end_row - start_row + 1);
+  // For as long as possible, replace the existing old_len with the
+  // new old_len. This is a more efficient operation, as it requires
+  // less memory allocation and freeing.
+  size_t to_replace = old_len < new_len ? old_len : new_len;
+  for (size_t i = 0; i < to_replace; i++) {
+    int64_t lnum = start_row + (int64_t)i;
 
-    // If the size of the range is reducing (ie, new_len < old_len) we
-    // need to delete some old_len. We do this at the start, by
-    // repeatedly deleting line "start".
-    size_t to_delete = (new_len < old_len) ? old_len - new_len : 0;
-    for (size_t i = 0; i < to_delete; i++) {
-      if (ml_delete_buf(buf, (linenr_T)start_row, false) == FAIL) {
-        api_set_error(err, kErrorTypeException, "Failed to delete line");
-        goto end;
-      }
+    VALIDATE((lnum < MAXLNUM), "%s", "Index out of bounds", {
+      return extra;
+    });
+
+    if (ml_replace_buf(buf, (linenr_T)lnum, lines[i], false, true) == FAIL) {
+      api_set_error(err, kErrorTypeException, "Failed to replace line");
+      return extra;
     }
+  }
 
-    if (to_delete > 0) {
-      extra -= (ptrdiff_t)to_delete;
+  // Now we may need to insert the remaining new old_len
+  for (size_t i = to_replace; i < new_len; i++) {
+    int64_t lnum = start_row + (int64_t)i - 1;
+
+    VALIDATE((lnum < MAXLNUM), "%s", "Index out of bounds", {
+      return extra;
+    });
+
+    if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+      api_set_error(err, kErrorTypeException, "Failed to insert line");
+      return extra;
     }
 
-    // For as long as possible, replace the existing old_len with the
-    // new old_len. This is a more efficient operation, as it requires
-    // less memory allocation and freeing.
-    size_t to_replace = old_len < new_len ? old_len : new_len;
-    for (size_t i = 0; i < to_replace; i++) {
-      int64_t lnum = start_row + (int64_t)i;
+    extra++;
+  }
 
-      VALIDATE((lnum < MAXLNUM), "%s", "Index out of bounds", {
-        goto end;
-      });
+  colnr_T col_extent = (colnr_T)(end_col
+                                 - ((end_row == start_row) ? start_col : 0));
 
-      if (ml_replace_buf(buf, (linenr_T)lnum, lines[i], false, true) == FAIL) {
-        api_set_error(err, kErrorTypeException, "Failed to replace line");
-        goto end;
+  // Adjust marks. Invalidate any which lie in the
+  // changed range, and move any in the remainder of the buffer.
+  // Do not adjust any cursors. need to use column-aware logic (below)
+  linenr_T adjust = end_row >= start_row ? MAXLNUM : 0;
+  mark_adjust_buf(buf, (linenr_T)start_row, (linenr_T)end_row - 1, adjust, (linenr_T)extra,
+                  true, true, kExtmarkNOOP);
+
+  extmark_splice(buf, (int)start_row - 1, (colnr_T)start_col,
+                 (int)(end_row - start_row), col_extent, old_byte,
+                 (int)new_len - 1, (colnr_T)last_item.size, new_byte,
+                 kExtmarkUndo);
+
+  if (!batch) {
+    changed_lines(buf, (linenr_T)start_row, 0, (linenr_T)end_row + 1, (linenr_T)extra, true);
+  }
+
+  FOR_ALL_TAB_WINDOWS(tp, win) {
+    if (win->w_buffer == buf) {
+      if (win->w_cursor.lnum >= start_row && win->w_cursor.lnum <= end_row) {
+        fix_cursor_cols(win, (linenr_T)start_row, (colnr_T)start_col, (linenr_T)end_row,
+                        (colnr_T)end_col, (linenr_T)new_len, (colnr_T)last_item.size);
+      } else {
+        fix_cursor(win, (linenr_T)start_row, (linenr_T)end_row, (linenr_T)extra);
       }
     }
+  }
+  return extra;
+}
 
-    // Now we may need to insert the remaining new old_len
-    for (size_t i = to_replace; i < new_len; i++) {
-      int64_t lnum = start_row + (int64_t)i - 1;
+/// Edit of nvim_buf_apply_edits(), rows are line numbers.
+typedef struct {
+  Integer start_row;
+  Integer start_col;
+  Integer end_row;
+  Integer end_col;
+  Array replacement;
+  size_t idx;  ///< position in the "edits" argument
+} BufEdit;
+
+/// qsort() callback: sorts edits from the end of the buffer to the start, so
+/// that applying an edit does not move the positions of the edits after it.
+/// Edits at the same position are sorted last one first.
+static int buf_edit_cmp(const void *a, const void *b)
+{
+  const BufEdit *e1 = a;
+  const BufEdit *e2 = b;
+  if (e1->start_row != e2->start_row) {
+    return e1->start_row > e2->start_row ? -1 : 1;
+  }
+  if (e1->start_col != e2->start_col) {
+    return e1->start_col > e2->start_col ? -1 : 1;
+  }
+  if (e1->end_row != e2->end_row) {
+    return e1->end_row > e2->end_row ? -1 : 1;
+  }
+  if (e1->end_col != e2->end_col) {
+    return e1->end_col > e2->end_col ? -1 : 1;
+  }
+  return e1->idx > e2->idx ? -1 : 1;
+}
 
-      VALIDATE((lnum < MAXLNUM), "%s", "Index out of bounds", {
-        goto end;
-      });
+/// Applies several text edits to a buffer at once.
+///
+/// Each edit is a `[start_row, start_col, end_row, end_col, replacement]` list,
+/// with the same meaning as the arguments of |nvim_buf_set_text()|. All
+/// positions refer to the buffer text before any of the edits is applied, the
+/// edits must not overlap. Edits at the same position are inserted in the
+/// given order.
+///
+/// This is equivalent to calling |nvim_buf_set_text()| for each edit, from the
+/// last one in the buffer to the first, but creates a single undo step and
+/// redraws and triggers |TextChanged| once, which is much faster for many
+/// edits.
+///
+/// @param channel_id
+/// @param buffer           Buffer id, or 0 for current buffer
+/// @param edits            Array of edits
+/// @param[out] err         Error details, if any
+void nvim_buf_apply_edits(uint64_t channel_id, Buffer buffer, ArrayOf(Array) edits, Arena *arena,
+                          Error *err)
+  FUNC_API_SINCE(14)
+  FUNC_API_TEXTLOCK_ALLOW_CMDWIN
+{
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return;
+  }
 
-      if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
-        api_set_error(err, kErrorTypeException, "Failed to insert line");
-        goto end;
-      }
+  // Load buffer if necessary. #22670
+  if (!buf_ensure_loaded(buf)) {
+    api_set_error(err, kErrorTypeException, "Failed to load buffer");
+    return;
+  }
 
-      extra++;
+  if (edits.size == 0) {
+    return;
+  }
+
+  bool disallow_nl = (channel_id != VIML_INTERNAL_CALL);
+  BufEdit *items = arena_alloc(arena, edits.size * sizeof(BufEdit), true);
+  for (size_t i = 0; i < edits.size; i++) {
+    VALIDATE_T("edit", kObjectTypeArray, edits.items[i].type, {
+      return;
+    });
+    Array e = edits.items[i].data.array;
+    VALIDATE((e.size == 5), "%s",
+             "edit must be [start_row, start_col, end_row, end_col, replacement]", {
+      return;
+    });
+    for (size_t j = 0; j < 4; j++) {
+      VALIDATE_T("edit position", kObjectTypeInteger, e.items[j].type, {
+        return;
+      });
     }
+    VALIDATE_T("replacement", kObjectTypeArray, e.items[4].type, {
+      return;
+    });
+
+    BufEdit *edit = &items[i];
+    bool oob = false;
+    edit->start_row = normalize_index(buf, e.items[0].data.integer, false, &oob);
+    VALIDATE_RANGE((!oob), "start_row", {
+      return;
+    });
+    edit->end_row = normalize_index(buf, e.items[2].data.integer, false, &oob);
+    VALIDATE_RANGE((!oob), "end_row", {
+      return;
+    });
+
+    Integer start_col = e.items[1].data.integer;
+    colnr_T len_at_start = ml_get_buf_len(buf, (linenr_T)edit->start_row);
+    edit->start_col = start_col < 0 ? len_at_start + start_col + 1 : start_col;
+    VALIDATE_RANGE((edit->start_col >= 0 && edit->start_col <= len_at_start), "start_col", {
+      return;
+    });
+
+    Integer end_col = e.items[3].data.integer;
+    colnr_T len_at_end = ml_get_buf_len(buf, (linenr_T)edit->end_row);
+    edit->end_col = end_col < 0 ? len_at_end + end_col + 1 : end_col;
+    VALIDATE_RANGE((edit->end_col >= 0 && edit->end_col <= len_at_end), "end_col", {
+      return;
+    });
+
+    VALIDATE((edit->start_row < edit->end_row
+              || (edit->start_row == edit->end_row && edit->start_col <= edit->end_col)),
+             "%s", "'start' is higher than 'end'", {
+      return;
+    });
+
+    edit->replacement = e.items[4].data.array;
+    if (edit->replacement.size == 0) {
+      edit->replacement = arena_array(arena, 1);
+      ADD_C(edit->replacement, STATIC_CSTR_AS_OBJ(""));
+    }
+    if (!check_string_array(edit->replacement, "replacement string", disallow_nl, err)) {
+      return;
+    }
+    edit->idx = i;
+  }
 
-    colnr_T col_extent = (colnr_T)(end_col
-                                   - ((end_row == start_row) ? start_col : 0));
+  qsort(items, edits.size, sizeof(BufEdit), buf_edit_cmp);
 
-    // Adjust marks. Invalidate any which lie in the
-    // changed range, and move any in the remainder of the buffer.
-    // Do not adjust any cursors. need to use column-aware logic (below)
-    linenr_T adjust = end_row >= start_row ? MAXLNUM : 0;
-    mark_adjust_buf(buf, (linenr_T)start_row, (linenr_T)end_row - 1, adjust, (linenr_T)extra,
-                    true, true, kExtmarkNOOP);
+  for (size_t i = 1; i < edits.size; i++) {
+    BufEdit *later = &items[i - 1];
+    BufEdit *edit = &items[i];
+    VALIDATE((edit->end_row < later->start_row
+              || (edit->end_row == later->start_row && edit->end_col <= later->start_col)),
+             "%s", "edits overlap", {
+      return;
+    });
+  }
 
-    extmark_splice(buf, (int)start_row - 1, (colnr_T)start_col,
-                   (int)(end_row - start_row), col_extent, old_byte,
-                   (int)new_len - 1, (colnr_T)last_item.size, new_byte,
-                   kExtmarkUndo);
+  linenr_T top = (linenr_T)items[edits.size - 1].start_row;
+  linenr_T bot = (linenr_T)items[0].end_row;
 
-    changed_lines(buf, (linenr_T)start_row, 0, (linenr_T)end_row + 1, (linenr_T)extra, true);
+  TRY_WRAP(err, {
+    if (!MODIFIABLE(buf)) {
+      api_set_error(err, kErrorTypeException, "Buffer is not 'modifiable'");
+      goto end;
+    }
 
-    FOR_ALL_TAB_WINDOWS(tp, win) {
-      if (win->w_buffer == buf) {
-        if (win->w_cursor.lnum >= start_row && win->w_cursor.lnum <= end_row) {
-          fix_cursor_cols(win, (linenr_T)start_row, (colnr_T)start_col, (linenr_T)end_row,
-                          (colnr_T)end_col, (linenr_T)new_len, (colnr_T)last_item.size);
-        } else {
-          fix_cursor(win, (linenr_T)start_row, (linenr_T)end_row, (linenr_T)extra);
-        }
+    if (u_save_buf(buf, top - 1, bot + 1) == FAIL) {
+      api_set_error(err, kErrorTypeException, "Failed to save undo information");
+      goto end;
+    }
+
+    ptrdiff_t extra = 0;
+    for (size_t i = 0; i < edits.size; i++) {
+      BufEdit *edit = &items[i];
+      extra += buf_set_text(channel_id, buf, edit->start_row, edit->start_col, edit->end_row,
+                            edit->end_col, edit->replacement, true, arena, err);
+      if (ERROR_SET(err)) {
+        break;
       }
     }
+
+    changed_lines(buf, top, 0, bot + 1, (linenr_T)extra, true);
     end:;
   });
 }
@@ -1421,10 +1635,15 @@ static void push_linestr(lua_State *lstate, Array *a, const char *s, size_t len,
 void buf_collect_lines(buf_T *buf, size_t n, linenr_T start, int start_idx, bool replace_nl,
                        Array *l, lua_State *lstate, Arena *arena)
 {
-  for (size_t i = 0; i < n; i++) {
-    linenr_T lnum = start + (linenr_T)i;
-    char *bufstr = ml_get_buf(buf, lnum);
-    size_t bufstrlen = (size_t)ml_get_buf_len(buf, lnum);
-    push_linestr(lstate, l, bufstr, bufstrlen, start_idx + (int)i, replace_nl, arena);
+  enum { SPAN_LINES = 64, };
+  char *lines[SPAN_LINES];
+  colnr_T lens[SPAN_LINES];
+  for (size_t i = 0; i < n;) {
+    // Get the lines directly from the data block, a run at a time.
+    int count = ml_get_buf_span(buf, start + (linenr_T)i, (int)MIN(n - i, SPAN_LINES),
+                                lines, lens);
+    for (int j = 0; j < count; j++, i++) {
+      push_linestr(lstate, l, lines[j], (size_t)lens[j], start_idx + (int)i, replace_nl, arena);
+    }
   }
 }
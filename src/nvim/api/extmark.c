@@ -29,6 +29,7 @@
 #include "nvim/memory.h"
 #include "nvim/memory_defs.h"
 #include "nvim/move.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/sign.h"
 
@@ -834,13 +835,16 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
 
     if (kv_size(virt_text.data.virt_text)) {
       decor_range_add_virt(&decor_state, r, c, line2, col2, decor_put_vt(virt_text, NULL), true);
+      decor_provider_record_ephemeral(r, c, line2, col2, NULL, (uint32_t)ns_id, id);
     }
     if (kv_size(virt_lines.data.virt_lines)) {
       decor_range_add_virt(&decor_state, r, c, line2, col2, decor_put_vt(virt_lines, NULL), true);
+      decor_provider_record_ephemeral(r, c, line2, col2, NULL, (uint32_t)ns_id, id);
     }
     if (has_hl) {
       DecorSignHighlight sh = decor_sh_from_inline(hl);
       sh.url = url;
+      decor_provider_record_ephemeral(r, c, line2, col2, &sh, (uint32_t)ns_id, id);
       decor_range_add_sh(&decor_state, r, c, line2, col2, &sh, true, (uint32_t)ns_id, id);
     }
   } else {
@@ -937,6 +941,83 @@ error:
   return 0;
 }
 
+/// Creates or updates many |extmarks| at once.
+///
+/// Like calling |nvim_buf_set_extmark()| for each item of {marks}, but
+/// crosses the API boundary only once, which matters when placing a large
+/// number of marks, e.g. for semantic highlighting. Stops at the first mark
+/// that cannot be set, the marks before it are kept.
+///
+/// @param buffer Buffer id, or 0 for current buffer
+/// @param ns_id  Namespace id from |nvim_create_namespace()|
+/// @param marks  List of marks, each a list `[line, col, opts]` with the same
+///               meaning as the arguments of |nvim_buf_set_extmark()|.
+///               `opts` can be omitted.
+/// @param opts  Optional parameters.
+///             - clear: remove all extmarks of the namespace first, so that
+///               afterwards the namespace holds exactly {marks}.
+/// @param[out] err   Error details, if any
+/// @return List of ids of the created/updated extmarks, in the order of {marks}
+ArrayOf(Integer) nvim_buf_set_extmarks(uint64_t channel_id, Buffer buffer, Integer ns_id,
+                                       Array marks, Dict(set_extmarks) *opts, Arena *arena,
+                                       Error *err)
+  FUNC_API_SINCE(14)
+{
+  Array rv = ARRAY_DICT_INIT;
+
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return rv;
+  }
+
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return rv;
+  });
+
+  if (opts->clear) {
+    extmark_clear(buf, (uint32_t)ns_id, 0, 0, MAXLNUM, MAXCOL);
+  }
+
+  rv = arena_array(arena, marks.size);
+  for (size_t i = 0; i < marks.size; i++) {
+    Object item = marks.items[i];
+    VALIDATE_EXP((item.type == kObjectTypeArray
+                  && (item.data.array.size == 2 || item.data.array.size == 3)),
+                 "marks item", "[line, col, opts]", NULL, {
+      return rv;
+    });
+
+    Array args = item.data.array;
+    VALIDATE_T("line", kObjectTypeInteger, args.items[0].type, {
+      return rv;
+    });
+    VALIDATE_T("col", kObjectTypeInteger, args.items[1].type, {
+      return rv;
+    });
+
+    Dict(set_extmark) mark_opts[1] = KEYDICT_INIT;
+    if (args.size == 3) {
+      VALIDATE_T_DICT("opts", args.items[2], {
+        return rv;
+      });
+      if (args.items[2].type == kObjectTypeDict
+          && !api_dict_to_keydict(mark_opts, DictHash(set_extmark), args.items[2].data.dict,
+                                  err)) {
+        return rv;
+      }
+    }
+
+    Integer id = nvim_buf_set_extmark(buffer, ns_id, args.items[0].data.integer,
+                                      args.items[1].data.integer, mark_opts, err);
+    if (ERROR_SET(err)) {
+      return rv;
+    }
+    ADD_C(rv, INTEGER_OBJ(id));
+  }
+
+  return rv;
+}
+
 /// Removes an |extmark|.
 ///
 /// @param buffer Buffer id, or 0 for current buffer
@@ -1044,6 +1125,12 @@ void nvim_buf_clear_namespace(Buffer buffer, Integer ns_id, Integer line_start,
 ///               ```
 ///                 ["end", tick]
 ///               ```
+///             - cache_lines: (boolean) reuse the ephemeral highlights set by
+///               `on_line` for a line, and skip calling `on_line` for it again,
+///               until the buffer changes (its |b:changedtick|) or the window
+///               shows another buffer. Lines where `on_line` returns false,
+///               sets virtual text or adds non-ephemeral extmarks are not
+///               cached. Set the provider again to discard the cache.
 void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *opts, Error *err)
   FUNC_API_SINCE(7) FUNC_API_LUA_ONLY
 {
@@ -1080,6 +1167,7 @@ void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *
     *v = LUA_NOREF;
   }
 
+  p->cache_lines = opts->cache_lines;
   p->state = kDecorProviderActive;
   p->hl_valid++;
   p->hl_cached = false;
@@ -1225,6 +1313,9 @@ void nvim__ns_set(Integer ns_id, Dict(ns_opts) *opts, Error *err)
     return;
   });
 
+  // The inline virtual text shown in windows may change.
+  inline_virt_cache_invalidate_all();
+
   bool set_scoped = true;
 
   if (HAS_KEY(opts, ns_opts, wins)) {
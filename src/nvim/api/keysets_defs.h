@@ -22,6 +22,7 @@ typedef struct {
   LuaRefOf(("hl_def" _)) _on_hl_def;
   LuaRefOf(("spell_nav" _)) _on_spell_nav;
   LuaRefOf(("conceal_line" _)) _on_conceal_line;
+  Boolean cache_lines;
 } Dict(set_decoration_provider);
 
 typedef struct {
@@ -62,6 +63,11 @@ typedef struct {
   Boolean scoped;
 } Dict(set_extmark);
 
+typedef struct {
+  OptionalKeys is_set__set_extmarks_;
+  Boolean clear;
+} Dict(set_extmarks);
+
 typedef struct {
   OptionalKeys is_set__get_extmark_;
   Boolean details;
@@ -246,6 +252,7 @@ typedef struct {
   Buffer buffer;
   Union(String, LuaRefOf((DictAs(create_autocmd__callback_args) args), *Boolean)) callback;
   String command;
+  Integer debounce;
   String desc;
   Union(Integer, String) group;
   Boolean nested;
@@ -370,6 +377,7 @@ typedef struct {
   LuaRefOf(("reload" _, Integer bufnr)) on_reload;
   Boolean utf_sizes;
   Boolean preview;
+  Boolean batch;
 } Dict(buf_attach);
 
 typedef struct {
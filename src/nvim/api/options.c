@@ -206,6 +206,52 @@ err:
   return (Object)OBJECT_INIT;
 }
 
+/// Gets the values of several options in one call, like calling
+/// |nvim_get_option_value()| for each name.
+///
+/// @param names     Option names
+/// @param opts      Optional parameters, like |nvim_get_option_value()| but
+///                  "filetype" is not supported.
+/// @param[out] err  Error details, if any
+/// @return          Option values, in the order of {names}
+Array nvim__get_option_values(ArrayOf(String) names, Dict(option) *opts, Error *err)
+  FUNC_API_RET_ALLOC
+{
+  Array rv = ARRAY_DICT_INIT;
+  VALIDATE(!HAS_KEY(opts, option, filetype), "%s", "cannot use 'filetype'", {
+    return rv;
+  });
+
+  for (size_t i = 0; i < names.size; i++) {
+    VALIDATE_T("option name", kObjectTypeString, names.items[i].type, {
+      goto err;
+    });
+    char *name = names.items[i].data.string.data;
+    OptIndex opt_idx = 0;
+    int opt_flags = 0;
+    OptScope scope = kOptScopeGlobal;
+    void *from = NULL;
+    if (!validate_option_value_args(opts, name, &opt_idx, &opt_flags, &scope, &from, NULL, err)) {
+      goto err;
+    }
+
+    OptVal value = get_option_value_for(opt_idx, opt_flags, scope, from, err);
+    if (ERROR_SET(err)) {
+      optval_free(value);
+      goto err;
+    }
+    VALIDATE_S(value.type != kOptValTypeNil, "option", name, {
+      goto err;
+    });
+    ADD(rv, optval_as_object(value));
+  }
+  return rv;
+
+err:
+  api_free_array(rv);
+  return (Array)ARRAY_DICT_INIT;
+}
+
 /// Sets the value of an option. The behavior of this function matches that of
 /// |:set|: for global-local options, both the global and local value are set
 /// unless otherwise specified with {scope}.
@@ -1,4 +1,6 @@
+#include <inttypes.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/dispatch.h"
@@ -23,3 +25,16 @@ MsgpackRpcRequestHandler msgpack_rpc_get_handler_for(const char *name, size_t na
   }
   return method_handlers[hash];
 }
+
+/// Gets the handler of a request which names the method by its "method_id" in
+/// |api-metadata|, which skips hashing the name.
+///
+/// @param id index in method_handlers[]
+MsgpackRpcRequestHandler msgpack_rpc_get_handler_for_id(uint64_t id, Error *error)
+{
+  if (id >= method_handlers_size) {
+    api_set_error(error, kErrorTypeException, "Invalid method id: %" PRIu64, id);
+    return (MsgpackRpcRequestHandler){ 0 };
+  }
+  return method_handlers[id];
+}
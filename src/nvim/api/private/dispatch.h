@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "nvim/api/private/defs.h"  // IWYU pragma: keep
@@ -23,6 +24,7 @@ struct MsgpackRpcRequestHandler {
 };
 
 extern const MsgpackRpcRequestHandler method_handlers[];
+extern const size_t method_handlers_size;
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "api/private/dispatch.h.generated.h"
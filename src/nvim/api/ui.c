@@ -37,6 +37,7 @@
 #include "nvim/msgpack_rpc/packer.h"
 #include "nvim/msgpack_rpc/packer_defs.h"
 #include "nvim/option.h"
+#include "nvim/os/time.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 
@@ -94,6 +95,7 @@ void remote_ui_disconnect(uint64_t channel_id, Error *err, bool send_error_exit)
   if (!ui) {
     return;
   }
+  ui_unmirror_all();
   if (send_error_exit) {
     MAXSIZE_TEMP_ARRAY(args, 1);
     ADD_C(args, INTEGER_OBJ(0));
@@ -186,7 +188,7 @@ void nvim_ui_attach(uint64_t channel_id, Integer width, Integer height, Dict opt
     }
   }
 
-  if (ui->ui_ext[kUIHlState] || ui->ui_ext[kUIMultigrid]) {
+  if (ui->ui_ext[kUIHlState] || ui->ui_ext[kUIMultigrid] || ui->ui_ext[kUIGridBin]) {
     ui->ui_ext[kUILinegrid] = true;
   }
 
@@ -300,6 +302,7 @@ bool remote_ui_restart(uint64_t channel_id, Error *err)
   });
   ADD_C(args, ARRAY_OBJ(argv));
 
+  ui_unmirror_all();
   push_call(ui, "restart", args);
   arena_mem_free(arena_finish(&arena));
   return true;
@@ -336,6 +339,7 @@ void nvim_ui_set_option(uint64_t channel_id, String name, Object value, Error *e
     return;
   }
 
+  ui_unmirror_all();
   ui_set_option(ui, false, name, value, error);
 }
 
@@ -424,10 +428,10 @@ static void ui_set_option(RemoteUI *ui, bool init, String name, Object value, Er
         return;
       });
       bool boolval = value.data.boolean;
-      if (!init && i == kUILinegrid && boolval != ui->ui_ext[i]) {
+      if (!init && (i == kUILinegrid || i == kUIGridBin) && boolval != ui->ui_ext[i]) {
         // There shouldn't be a reason for a UI to do this ever
         // so explicitly don't support this.
-        api_set_error(err, kErrorTypeValidation, "ext_linegrid option cannot be changed");
+        api_set_error(err, kErrorTypeValidation, "%s option cannot be changed", ui_ext_names[i]);
       }
       ui->ui_ext[i] = boolval;
       if (!init) {
@@ -818,8 +822,12 @@ void remote_ui_raw_line(RemoteUI *ui, Integer grid, Integer row, Integer startco
   // If MAX_SCHAR_SIZE is made larger, we need to refactor implementation below
   // to not only use FIXSTR (only up to 0x20 bytes)
   STATIC_ASSERT(MAX_SCHAR_SIZE - 1 < 0x20, "SCHAR doesn't fit in fixstr");
+  const uint64_t encode_start = os_hrtime();
 
-  if (ui->ui_ext[kUILinegrid]) {
+  if (ui->ui_ext[kUIGridBin]) {
+    remote_ui_raw_line_bin(ui, grid, row, startcol, endcol, clearcol, clearattr, flags, chunk,
+                           attrs);
+  } else if (ui->ui_ext[kUILinegrid]) {
     prepare_call(ui, "grid_line");
 
     char **buf = &ui->packer.ptr;
@@ -926,6 +934,78 @@ void remote_ui_raw_line(RemoteUI *ui, Integer grid, Integer row, Integer startco
       }
     }
   }
+  g_stats.ui_encode_ns += (int64_t)(os_hrtime() - encode_start);
+}
+
+static void mpack_uvarint(char **buf, uint32_t val)
+{
+  while (val >= 0x80) {
+    mpack_w(buf, 0x80 | (val & 0x7f));
+    val >>= 7;
+  }
+  mpack_w(buf, val);
+}
+
+static void prepare_grid_line_bin(RemoteUI *ui, Integer grid, Integer row, Integer col,
+                                  char **lenpos)
+{
+  prepare_call(ui, "grid_line");
+  char **buf = &ui->packer.ptr;
+  mpack_array(buf, 5);
+  mpack_uint(buf, (uint32_t)grid);
+  mpack_uint(buf, (uint32_t)row);
+  mpack_uint(buf, (uint32_t)col);
+  mpack_w(buf, 0xc5);  // bin 16
+  *lenpos = *buf;
+  mpack_w2(buf, 0);
+}
+
+static void finish_grid_line_bin(RemoteUI *ui, char *lenpos, bool wrap)
+{
+  char *start = lenpos + 2;
+  mpack_w2(&lenpos, (uint32_t)(ui->packer.ptr - start));
+  mpack_bool(&ui->packer.ptr, wrap);
+}
+
+/// "grid_line" event for ext_gridbin: the cells are a single binary blob with
+/// a run of equal cells packed as the length of the text, the UTF-8 text, and
+/// the highlight id and repeat count as unsigned LEB128 numbers.
+static void remote_ui_raw_line_bin(RemoteUI *ui, Integer grid, Integer row, Integer startcol,
+                                   Integer endcol, Integer clearcol, Integer clearattr,
+                                   LineFlags flags, const schar_T *chunk, const sattr_T *attrs)
+{
+  char **buf = &ui->packer.ptr;
+  char *lenpos;
+  prepare_grid_line_bin(ui, grid, row, startcol, &lenpos);
+
+  uint32_t repeat = 0;
+  size_t ncells = (size_t)(endcol - startcol);
+  for (size_t i = 0; i < ncells; i++) {
+    repeat++;
+    if (i == ncells - 1 || attrs[i] != attrs[i + 1] || chunk[i] != chunk[i + 1]) {
+      // Leave place for this run, the clearing run and the "wrap" field.
+      if (UI_BUF_SIZE - BUF_POS(ui) < 2 * (1 + MAX_SCHAR_SIZE + 5 + 5) + 1
+          || ui->ncells_pending >= 500) {
+        finish_grid_line_bin(ui, lenpos, false);
+        ui_flush_buf(ui, false);
+        prepare_grid_line_bin(ui, grid, row, startcol + (Integer)i - repeat + 1, &lenpos);
+      }
+      char *size_byte = (*buf)++;
+      *size_byte = (char)schar_get_adv(buf, chunk[i]);
+      mpack_uvarint(buf, (uint32_t)attrs[i]);
+      mpack_uvarint(buf, repeat);
+      ui->ncells_pending += MIN(repeat, 2);
+      repeat = 0;
+    }
+  }
+  if (endcol < clearcol) {
+    ui->ncells_pending += 1;
+    mpack_w(buf, 1);
+    mpack_w(buf, ' ');
+    mpack_uvarint(buf, (uint32_t)clearattr);
+    mpack_uvarint(buf, (uint32_t)(clearcol - endcol));
+  }
+  finish_grid_line_bin(ui, lenpos, flags & kLineFlagWrap);
 }
 
 /// Flush the internal packing buffer to the client.
@@ -946,8 +1026,12 @@ static void ui_flush_buf(RemoteUI *ui, bool incomplete_event)
     ui->nevents_pos = NULL;
   }
 
-  WBuffer *buf = wstream_new_buffer(ui->packer.startptr, BUF_POS(ui), 1, free_block);
+  WBuffer *buf = wstream_new_buffer(ui->packer.startptr, BUF_POS(ui), 1 + ui->nmirrors,
+                                    free_block);
   rpc_write_raw(ui->channel_id, buf);
+  for (size_t i = 0; i < ui->nmirrors; i++) {
+    rpc_write_raw(ui->mirror_chans[i], buf);
+  }
 
   ui->packer.startptr = NULL;
   ui->packer.ptr = NULL;
@@ -964,18 +1048,72 @@ static void ui_flush_buf(RemoteUI *ui, bool incomplete_event)
 void remote_ui_flush(RemoteUI *ui)
 {
   if (ui->nevents > 0 || ui->flushed_events) {
+    const uint64_t encode_start = os_hrtime();
     if (!ui->ui_ext[kUILinegrid]) {
       remote_ui_cursor_goto(ui, ui->cursor_row, ui->cursor_col);
     }
     push_call(ui, "flush", (Array)ARRAY_DICT_INIT);
     ui_flush_buf(ui, false);
     ui->flushed_events = false;
+    g_stats.ui_encode_ns += (int64_t)(os_hrtime() - encode_start);
   }
 }
 
 void remote_ui_flush_pending_data(RemoteUI *ui)
 {
+  ui_flush_buf(ui->mirror ? ui->mirror : ui, false);
+}
+
+/// Checks if the client of "ui" may have been sent a part of an event, which
+/// must be completed before anything else is written to its channel.
+bool remote_ui_incomplete_event(RemoteUI *ui)
+{
+  return (ui->mirror ? ui->mirror : ui)->incomplete_event;
+}
+
+/// Checks if "a" and "b" get the same events, encoded in the same way.
+bool remote_ui_same_options(RemoteUI *a, RemoteUI *b)
+{
+  return a->rgb == b->rgb && a->override == b->override && a->term_colors == b->term_colors
+         && memcmp(a->ui_ext, b->ui_ext, sizeof(a->ui_ext)) == 0;
+}
+
+/// Lets "leader" pack the events of "ui" as well.
+void remote_ui_mirror(RemoteUI *leader, RemoteUI *ui)
+{
+  assert(!leader->mirror && leader->nmirrors < MAX_UI_COUNT);
+  // Events packed before this point were sent to both UIs separately.
+  ui_flush_buf(leader, false);
   ui_flush_buf(ui, false);
+  ui->mirror = leader;
+  leader->mirror_chans[leader->nmirrors++] = ui->channel_id;
+}
+
+/// Stops "ui" from sharing the events of another UI.
+void remote_ui_unmirror(RemoteUI *ui)
+{
+  RemoteUI *leader = ui->mirror;
+  if (!leader) {
+    return;
+  }
+
+  // The client has to get the events packed so far, before the UIs diverge.
+  ui_flush_buf(leader, false);
+  ui->flushed_events = leader->flushed_events;
+  ui->hl_id = leader->hl_id;
+  ui->cursor_row = leader->cursor_row;
+  ui->cursor_col = leader->cursor_col;
+  ui->client_row = leader->client_row;
+  ui->client_col = leader->client_col;
+  ui->wildmenu_active = leader->wildmenu_active;
+
+  for (size_t i = 0; i < leader->nmirrors; i++) {
+    if (leader->mirror_chans[i] == ui->channel_id) {
+      leader->mirror_chans[i] = leader->mirror_chans[--leader->nmirrors];
+      break;
+    }
+  }
+  ui->mirror = NULL;
 }
 
 static Array translate_contents(RemoteUI *ui, Array contents, Arena *arena)
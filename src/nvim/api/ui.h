@@ -19,6 +19,7 @@ EXTERN const char *ui_ext_names[] INIT( = {
   "ext_multigrid",
   "ext_hlstate",
   "ext_termcolors",
+  "ext_gridbin",
   "_debug_float",
 });
 
@@ -34,6 +34,7 @@
 #include "nvim/eval.h"
 #include "nvim/eval/typval.h"
 #include "nvim/eval/typval_defs.h"
+#include "nvim/event/multiqueue.h"
 #include "nvim/ex_docmd.h"
 #include "nvim/ex_eval.h"
 #include "nvim/fold.h"
@@ -51,6 +52,7 @@
 #include "nvim/lua/executor.h"
 #include "nvim/lua/treesitter.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/mapping.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
@@ -75,6 +77,7 @@
 #include "nvim/os/proc.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
+#include "nvim/profile.h"
 #include "nvim/runtime.h"
 #include "nvim/sign_defs.h"
 #include "nvim/state.h"
@@ -1607,6 +1610,10 @@ void nvim_set_client_info(uint64_t channel_id, String name, Dict version, String
 ///    -  "buffer"  (optional) Buffer connected to |terminal| instance.
 ///    -  "client"  (optional) Info about the peer (client on the other end of the channel), as set
 ///                 by |nvim_set_client_info()|.
+///    -  "dropped_notifications"  (optional) Number of RPC notifications which were not sent,
+///                 because too much data was waiting to be written to the peer.
+///    -  "queued_bytes"  (optional) Bytes waiting to be written, present with
+///                 "dropped_notifications".
 ///
 Dict nvim_get_chan_info(uint64_t channel_id, Integer chan, Arena *arena, Error *err)
   FUNC_API_SINCE(4)
@@ -1686,21 +1693,95 @@ Float nvim__id_float(Float flt)
   return flt;
 }
 
+static Array stats_hist(const int64_t *hist, Arena *arena)
+{
+  Array rv = arena_array(arena, STATS_HIST_SIZE);
+  for (int i = 0; i < STATS_HIST_SIZE; i++) {
+    ADD_C(rv, INTEGER_OBJ(hist[i]));
+  }
+  return rv;
+}
+
 /// Gets internal stats.
 ///
+/// The "redraw_hist", "rpc_hist" and "input_latency_hist" histograms count
+/// durations by powers of two: item i is the number of durations of 2^(i-1) to
+/// 2^i milliseconds, the first item counts shorter ones and the last item
+/// longer ones.
+///
+/// "input_latency_ns" is the time from the arrival of input (|nvim_input()| or
+/// a UI) until the screen was updated and flushed after processing it, of
+/// which "input_ns" is spent before the screen update started. The time of the
+/// screen update is split into "win_line_ns", "compositor_ns" and
+/// "ui_encode_ns", for drawing buffer lines, composing grids and encoding the
+/// result for remote UIs.
+///
+/// "pools" has the object size and the number of allocated ("live") and free
+/// objects and of blocks for each pool of small objects.
+///
 /// @return Map of various internal stats.
 Dict nvim__stats(Arena *arena)
 {
-  Dict rv = arena_dict(arena, 6);
+  Dict rv = arena_dict(arena, 28);
   PUT_C(rv, "fsync", INTEGER_OBJ(g_stats.fsync));
   PUT_C(rv, "log_skip", INTEGER_OBJ(g_stats.log_skip));
   PUT_C(rv, "lua_refcount", INTEGER_OBJ(nlua_get_global_ref_count()));
   PUT_C(rv, "redraw", INTEGER_OBJ(g_stats.redraw));
   PUT_C(rv, "arena_alloc_count", INTEGER_OBJ((Integer)arena_alloc_count));
   PUT_C(rv, "ts_query_parse_count", INTEGER_OBJ((Integer)tslua_query_parse_count));
+  PUT_C(rv, "memfile_hit", INTEGER_OBJ(g_stats.memfile_hit));
+  PUT_C(rv, "memfile_miss", INTEGER_OBJ(g_stats.memfile_miss));
+  PUT_C(rv, "memfile_release", INTEGER_OBJ(g_stats.memfile_release));
+  PUT_C(rv, "redraw_ns", INTEGER_OBJ(g_stats.redraw_ns));
+  PUT_C(rv, "redraw_hist", ARRAY_OBJ(stats_hist(g_stats.redraw_hist, arena)));
+  PUT_C(rv, "win_line", INTEGER_OBJ(g_stats.win_line));
+  PUT_C(rv, "win_line_ns", INTEGER_OBJ(g_stats.win_line_ns));
+  PUT_C(rv, "compositor_ns", INTEGER_OBJ(g_stats.compositor_ns));
+  PUT_C(rv, "ui_encode_ns", INTEGER_OBJ(g_stats.ui_encode_ns));
+  PUT_C(rv, "input_ns", INTEGER_OBJ(g_stats.input_ns));
+  PUT_C(rv, "input_latency", INTEGER_OBJ(g_stats.input_latency));
+  PUT_C(rv, "input_latency_ns", INTEGER_OBJ(g_stats.input_latency_ns));
+  PUT_C(rv, "input_latency_hist", ARRAY_OBJ(stats_hist(g_stats.input_latency_hist, arena)));
+  PUT_C(rv, "ml_locked_hit", INTEGER_OBJ(g_stats.ml_locked_hit));
+  PUT_C(rv, "ml_tree_search", INTEGER_OBJ(g_stats.ml_tree_search));
+  PUT_C(rv, "regexp_exec", INTEGER_OBJ(g_stats.regexp_exec));
+  PUT_C(rv, "rpc_request", INTEGER_OBJ(g_stats.rpc_request));
+  PUT_C(rv, "rpc_request_ns", INTEGER_OBJ(g_stats.rpc_request_ns));
+  PUT_C(rv, "rpc_hist", ARRAY_OBJ(stats_hist(g_stats.rpc_hist, arena)));
+  PUT_C(rv, "rpc_method", DICT_OBJ(rpc_method_stats_get(arena)));
+  PUT_C(rv, "main_loop_events", INTEGER_OBJ((Integer)multiqueue_size(main_loop.events)));
+  PUT_C(rv, "pools", DICT_OBJ(pool_stats(arena)));
   return rv;
 }
 
+/// Starts recording the time spent in sourcing scripts, autocommands, RPC
+/// requests, decoration providers and redrawing. Replaces the spans recorded
+/// before.
+///
+/// @param size Number of spans to keep, older ones are dropped. Zero stops recording.
+/// @param[out] err Error details, if any
+void nvim__trace_start(Integer size, Error *err)
+{
+  VALIDATE_RANGE((size >= 0 && size <= INT32_MAX), "size", {
+    return;
+  });
+  trace_start((size_t)size);
+}
+
+/// Gets the spans recorded after |nvim__trace_start()|, oldest first, as events
+/// of the Chrome trace event format, which can be loaded in Perfetto:
+///
+/// ```lua
+/// vim.fn.writefile({ vim.json.encode(vim.api.nvim__trace_get()) }, 'trace.json')
+/// ```
+///
+/// @return Array of dicts with keys "name", "cat", "ph", "ts" and "dur" (in
+///         microseconds), "pid", "tid" and optionally "args".
+Array nvim__trace_get(Arena *arena)
+{
+  return trace_events(arena);
+}
+
 /// Gets a list of dictionaries representing attached UIs.
 ///
 /// Example: The Nvim builtin |TUI| sets its channel info as described in |startup-tui|. In
@@ -2227,7 +2308,7 @@ static void redraw_status(win_T *wp, Dict(redraw) *opts, bool *flush)
 
   // Mark for redraw in case flush will happen, otherwise redraw now.
   if (*flush && (opts->statusline || opts->winbar)) {
-    wp->w_redr_status = true;
+    status_redraw_win(wp);
   } else if (opts->statusline || opts->winbar) {
     win_check_ns_hl(wp);
     if (opts->winbar) {
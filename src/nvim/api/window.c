@@ -147,7 +147,7 @@ void nvim_win_set_cursor(Window window, ArrayOf(Integer, 2) pos, Error *err)
   restore_win(&switchwin, true);
 
   redraw_later(win, UPD_VALID);
-  win->w_redr_status = true;
+  status_redraw_win(win);
 }
 
 /// Gets the window height
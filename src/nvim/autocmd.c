@@ -20,8 +20,10 @@
 #include "nvim/eval/typval.h"
 #include "nvim/eval/userfunc.h"
 #include "nvim/eval/vars.h"
+#include "nvim/event/defs.h"
 #include "nvim/event/loop.h"
 #include "nvim/event/multiqueue.h"
+#include "nvim/event/time.h"
 #include "nvim/ex_docmd.h"
 #include "nvim/ex_eval.h"
 #include "nvim/fileio.h"
@@ -35,6 +37,7 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/insexpand.h"
 #include "nvim/lua/executor.h"
+#include "nvim/macros_defs.h"
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/memory.h"
@@ -110,6 +113,25 @@ static bool autocmd_include_groups = false;
 
 static char *old_termresponse = NULL;
 
+/// Autocommand postponed by its "debounce" time, see aucmd_debounce().
+typedef struct {
+  int64_t id;     ///< autocommand id
+  event_T event;  ///< event that was triggered
+  int bufnr;      ///< <abuf>, zero when there is no buffer
+  char *fname;    ///< "fname" argument of the last event, NULL when empty
+  char *afile;    ///< <afile> of the last event
+  Object data;    ///< "data" of the last event
+  uint64_t due;   ///< time to execute the autocommand, in milliseconds
+} AuDebounce;
+
+// Postponed autocommands and the timer for executing the first one.
+static kvec_t(AuDebounce) au_debounce_pending = KV_INITIAL_VALUE;
+static TimeWatcher au_debounce_timer;
+static bool au_debounce_timer_init = false;
+// Id of the postponed autocommand that apply_autocmds_group() is going to
+// execute, zero otherwise.
+static int64_t au_debounce_exec_id = 0;
+
 // Map of autocmd group names and ids.
 //  name -> ID
 //  ID -> name
@@ -961,7 +983,7 @@ int do_autocmd_event(event_T event, const char *pat, bool once, int nested, cons
 
     if (is_adding_cmd) {
       Callback handler_fn = CALLBACK_INIT;
-      autocmd_register(0, event, pat, patlen, group, once, nested, NULL, cmd, &handler_fn);
+      autocmd_register(0, event, pat, patlen, group, once, nested, 0, NULL, cmd, &handler_fn);
     }
 
     pat = aucmd_next_pattern(pat, (size_t)patlen);
@@ -975,10 +997,12 @@ int do_autocmd_event(event_T event, const char *pat, bool once, int nested, cons
 /// Registers an autocmd. The handler may be a Ex command or callback function, decided by
 /// the `handler_cmd` or `handler_fn` args.
 ///
+/// @param debounce Milliseconds to postpone executing the autocmd, see aucmd_debounce().
 /// @param handler_cmd Handler Ex command, or NULL if handler is a function (`handler_fn`).
 /// @param handler_fn Handler function, ignored if `handler_cmd` is not NULL.
 int autocmd_register(int64_t id, event_T event, const char *pat, int patlen, int group, bool once,
-                     bool nested, char *desc, const char *handler_cmd, Callback *handler_fn)
+                     bool nested, int debounce, char *desc, const char *handler_cmd,
+                     Callback *handler_fn)
 {
   // 0 is not a valid group.
   assert(group != 0);
@@ -1033,8 +1057,10 @@ int autocmd_register(int64_t id, event_T event, const char *pat, int patlen, int
     if (is_buflocal) {
       ap->buflocal_nr = buflocal_nr;
       ap->reg_prog = NULL;
+      ap->literal_off = -1;
     } else {
       ap->buflocal_nr = 0;
+      ap->literal_off = file_pat_literal_off(pat, (size_t)patlen);
       char *reg_pat = file_pat_to_reg_pat(pat, pat + patlen, &ap->allow_dirs, true);
       if (reg_pat != NULL) {
         ap->reg_prog = vim_regcomp(reg_pat, RE_MAGIC);
@@ -1098,6 +1124,7 @@ int autocmd_register(int64_t id, event_T event, const char *pat, int patlen, int
   nlua_set_sctx(&ac->script_ctx);
   ac->once = once;
   ac->nested = nested;
+  ac->debounce = debounce;
   ac->desc = desc == NULL ? NULL : xstrdup(desc);
 
   return OK;
@@ -1135,6 +1162,20 @@ size_t aucmd_pattern_length(const char *pat)
   return strlen(pat);
 }
 
+/// Check if the file name matches the pattern of a not buffer-local AutoPat.
+static bool aupat_match(AutoPat *ap, char *fname, char *sfname, char *tail, int tail_len)
+{
+  if (ap->literal_off >= 0) {
+    const TriState res = match_file_literal(ap->pat + ap->literal_off,
+                                            (size_t)(ap->patlen - ap->literal_off),
+                                            ap->literal_off > 0, tail, tail_len);
+    if (res != kNone) {
+      return res == kTrue;
+    }
+  }
+  return match_file_pat(NULL, &ap->reg_prog, fname, sfname, tail, ap->allow_dirs);
+}
+
 const char *aucmd_next_pattern(const char *pat, size_t patlen)
   FUNC_ATTR_PURE
 {
@@ -1600,6 +1641,7 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
                           buf_T *buf, exarg_T *eap, Object *data)
 {
   char *sfname = NULL;  // short file name
+  char *const fname_arg = fname != NULL && *fname != NUL ? fname : NULL;
   bool retval = false;
   static int nesting = 0;
   char *save_cmdarg;
@@ -1608,6 +1650,8 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
   bool did_save_redobuff = false;
   save_redo_T save_redo;
   const bool save_KeyTyped = KeyTyped;
+  const int64_t debounce_id = au_debounce_exec_id;
+  au_debounce_exec_id = 0;
 
   // Quickly return if there are no autocommands for this event or
   // autocommands are blocked.
@@ -1782,6 +1826,29 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
   forward_slash(fname);
 #endif
 
+  char *tail = path_tail(fname);
+  const int tail_len = match_file_literal_len(tail);
+
+  // Most autocommands of an event are often for other file types or buffers.
+  // Don't save and restore the state for executing them when none matches.
+  if (!aucmd_has_match(event, group, fname, sfname, tail, tail_len, autocmd_bufnr)) {
+    // Same effect on did_filetype() as executing no autocommands.
+    if (!autocmd_busy) {
+      curbuf->b_did_filetype = false;
+    } else if (event == EVENT_FILETYPE) {
+      curbuf->b_did_filetype = true;
+    }
+    xfree(afile_orig);
+    xfree(autocmd_fname);
+    autocmd_fname = save_autocmd_fname;
+    autocmd_fname_full = save_autocmd_fname_full;
+    autocmd_bufnr = save_autocmd_bufnr;
+    xfree(fname);
+    xfree(sfname);
+    au_cleanup();
+    goto BYPASS_AU;
+  }
+
   // Set the name to be used for <amatch>.
   autocmd_match = fname;
 
@@ -1821,8 +1888,6 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
     curbuf->b_did_filetype = true;
   }
 
-  char *tail = path_tail(fname);
-
   // Find first autocommand that matches
   AutoPatCmd patcmd = {
     // aucmd_next will set lastpat back to NULL if there are no more autocommands left to run
@@ -1836,9 +1901,12 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
     .fname = fname,
     .sfname = sfname,
     .tail = tail,
+    .tail_len = tail_len,
+    .fname_arg = fname_arg,
     .group = group,
     .event = event,
     .arg_bufnr = autocmd_bufnr,
+    .debounce_id = debounce_id,
   };
   aucmd_next(&patcmd);
 
@@ -1874,7 +1942,9 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
     const bool save_ex_pressedreturn = get_pressedreturn();
 
     // Execute the autocmd. The `getnextac` callback handles iteration.
+    const uint64_t trace_tm = trace_begin();
     do_cmdline(NULL, getnextac, &patcmd, DOCMD_NOWAIT | DOCMD_VERBOSE | DOCMD_REPEAT);
+    trace_end("autocmd", event_nr2name(event), NULL, trace_tm);
 
     did_emsg += save_did_emsg;
     set_pressedreturn(save_ex_pressedreturn);
@@ -1996,6 +2066,26 @@ bool is_autocmd_blocked(void)
   return autocmd_blocked != 0;
 }
 
+/// Check if aucmd_next() would find an autocommand to execute for "event",
+/// without changing the execution stack.
+static bool aucmd_has_match(event_T event, int group, char *fname, char *sfname, char *tail,
+                            int tail_len, int bufnr)
+{
+  AutoCmdVec *const acs = &autocmds[(int)event];
+  for (size_t i = 0; i < kv_size(*acs) && !got_int; i++) {
+    AutoPat *const ap = kv_A(*acs, i).pat;
+    if (ap == NULL || (group != AUGROUP_ALL && group != ap->group)) {
+      continue;
+    }
+    if (ap->buflocal_nr == 0
+        ? aupat_match(ap, fname, sfname, tail, tail_len)
+        : ap->buflocal_nr == bufnr) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /// Find next matching autocommand.
 /// If next autocommand was not found, sets lastpat to NULL and cmdidx to SIZE_MAX on apc.
 static void aucmd_next(AutoPatCmd *apc)
@@ -2012,6 +2102,10 @@ static void aucmd_next(AutoPatCmd *apc)
     if (ap == NULL) {
       continue;
     }
+    // When executing a postponed autocommand, skip all the others.
+    if (apc->debounce_id != 0 && ac->id != apc->debounce_id) {
+      continue;
+    }
     // Skip matching if pattern didn't change.
     if (ap != apc->lastpat) {
       // Skip autocommands that don't match the group.
@@ -2020,7 +2114,7 @@ static void aucmd_next(AutoPatCmd *apc)
       }
       // Skip autocommands that don't match the pattern or buffer number.
       if (ap->buflocal_nr == 0
-          ? !match_file_pat(NULL, &ap->reg_prog, apc->fname, apc->sfname, apc->tail, ap->allow_dirs)
+          ? !aupat_match(ap, apc->fname, apc->sfname, apc->tail, apc->tail_len)
           : ap->buflocal_nr != apc->arg_bufnr) {
         continue;
       }
@@ -2043,6 +2137,13 @@ static void aucmd_next(AutoPatCmd *apc)
       entry->es_info.aucmd = apc;
     }
 
+    // Postpone an autocommand with a "debounce" time, unless executing it
+    // after that time.
+    if (ac->debounce > 0 && apc->debounce_id == 0) {
+      aucmd_debounce(ac, apc);
+      continue;
+    }
+
     apc->lastpat = ap;
     apc->auidx = i;
 
@@ -2058,6 +2159,112 @@ static void aucmd_next(AutoPatCmd *apc)
   apc->auidx = SIZE_MAX;
 }
 
+/// Postpone executing autocommand "ac" until its "debounce" time has passed
+/// without the event being triggered again for the same buffer.  Repeated
+/// events are coalesced, the autocommand is executed once with the file name
+/// and data of the last one.
+static void aucmd_debounce(const AutoCmd *ac, const AutoPatCmd *apc)
+{
+  AuDebounce *d = NULL;
+  for (size_t i = 0; i < kv_size(au_debounce_pending); i++) {
+    AuDebounce *p = &kv_A(au_debounce_pending, i);
+    if (p->id == ac->id && p->event == apc->event && p->bufnr == apc->arg_bufnr) {
+      d = p;
+      xfree(d->fname);
+      xfree(d->afile);
+      api_free_object(d->data);
+      break;
+    }
+  }
+  if (d == NULL) {
+    d = kv_pushp(au_debounce_pending);
+    d->id = ac->id;
+    d->event = apc->event;
+    d->bufnr = apc->arg_bufnr;
+  }
+  d->fname = apc->fname_arg == NULL ? NULL : xstrdup(apc->fname_arg);
+  d->afile = apc->afile_orig == NULL ? NULL : xstrdup(apc->afile_orig);
+  d->data = apc->data == NULL ? NIL : copy_object(*apc->data, NULL);
+  d->due = os_hrtime() / 1000000 + (uint64_t)ac->debounce;
+  aucmd_debounce_start_timer();
+}
+
+/// Start the timer for the first postponed autocommand.
+static void aucmd_debounce_start_timer(void)
+{
+  if (kv_size(au_debounce_pending) == 0) {
+    return;
+  }
+  uint64_t due = UINT64_MAX;
+  for (size_t i = 0; i < kv_size(au_debounce_pending); i++) {
+    due = MIN(due, kv_A(au_debounce_pending, i).due);
+  }
+  if (!au_debounce_timer_init) {
+    time_watcher_init(&main_loop, &au_debounce_timer, NULL);
+    // the autocommands are executed like any other, not as a fast event
+    au_debounce_timer.events = multiqueue_new_child(main_loop.events);
+    au_debounce_timer_init = true;
+  }
+  const uint64_t now = os_hrtime() / 1000000;
+  time_watcher_start(&au_debounce_timer, aucmd_debounce_due_cb, due > now ? due - now : 0, 0);
+}
+
+/// Execute the postponed autocommands whose time has come.
+static void aucmd_debounce_due_cb(TimeWatcher *tw, void *data)
+{
+  if (exiting) {
+    return;
+  }
+  const uint64_t now = os_hrtime() / 1000000;
+  kvec_t(AuDebounce) due = KV_INITIAL_VALUE;
+  size_t n = 0;
+  for (size_t i = 0; i < kv_size(au_debounce_pending); i++) {
+    AuDebounce d = kv_A(au_debounce_pending, i);
+    if (d.due <= now) {
+      kv_push(due, d);
+    } else {
+      kv_A(au_debounce_pending, n++) = d;
+    }
+  }
+  kv_size(au_debounce_pending) = n;
+
+  // The autocommands may postpone others, which restarts the timer.
+  for (size_t i = 0; i < kv_size(due); i++) {
+    AuDebounce *d = &kv_A(due, i);
+    buf_T *buf = d->bufnr == 0 ? NULL : buflist_findnr(d->bufnr);
+    // Drop it when the buffer was wiped out.
+    if (d->bufnr == 0 || buf != NULL) {
+      au_debounce_exec_id = d->id;
+      apply_autocmds_group(d->event, d->fname, d->afile, true, AUGROUP_ALL, buf, NULL,
+                           d->data.type == kObjectTypeNil ? NULL : &d->data);
+    }
+    xfree(d->fname);
+    xfree(d->afile);
+    api_free_object(d->data);
+  }
+  kv_destroy(due);
+
+  aucmd_debounce_start_timer();
+}
+
+/// Drop the postponed autocommands and close their timer.
+void aucmd_debounce_teardown(void)
+{
+  for (size_t i = 0; i < kv_size(au_debounce_pending); i++) {
+    AuDebounce *d = &kv_A(au_debounce_pending, i);
+    xfree(d->fname);
+    xfree(d->afile);
+    api_free_object(d->data);
+  }
+  kv_destroy(au_debounce_pending);
+  if (au_debounce_timer_init) {
+    time_watcher_stop(&au_debounce_timer);
+    multiqueue_free(au_debounce_timer.events);
+    time_watcher_close(&au_debounce_timer, NULL);
+    au_debounce_timer_init = false;
+  }
+}
+
 /// Executes an autocmd callback function (as opposed to an Ex command).
 static bool au_callback(const AutoCmd *ac, const AutoPatCmd *apc)
 {
@@ -2191,6 +2398,7 @@ bool has_autocmd(event_T event, char *sfname, buf_T *buf)
   FUNC_ATTR_WARN_UNUSED_RESULT
 {
   char *tail = path_tail(sfname);
+  const int tail_len = match_file_literal_len(tail);
   bool retval = false;
 
   char *fname = FullName_save(sfname, false);
@@ -2211,7 +2419,7 @@ bool has_autocmd(event_T event, char *sfname, buf_T *buf)
     AutoPat *const ap = kv_A(*acs, i).pat;
     if (ap != NULL
         && (ap->buflocal_nr == 0
-            ? match_file_pat(NULL, &ap->reg_prog, fname, sfname, tail, ap->allow_dirs)
+            ? aupat_match(ap, fname, sfname, tail, tail_len)
             : buf != NULL && ap->buflocal_nr == buf->b_fnum)) {
       retval = true;
       break;
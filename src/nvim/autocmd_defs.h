@@ -34,6 +34,7 @@ typedef struct {
   int patlen;               ///< strlen() of pat
   int buflocal_nr;          ///< !=0 for buffer-local AutoPat
   char allow_dirs;          ///< Pattern may match whole path
+  int literal_off;          ///< See file_pat_literal_off()
 } AutoPat;
 
 typedef struct {
@@ -45,6 +46,7 @@ typedef struct {
   sctx_T script_ctx;        ///< Script context where it is defined
   bool once;                ///< "One shot": removed after execution
   bool nested;              ///< If autocommands nest here
+  int debounce;             ///< Milliseconds to postpone executing, zero for none
 } AutoCmd;
 
 /// Struct used to keep status while executing autocommands for an event.
@@ -57,11 +59,14 @@ struct AutoPatCmd_S {
   char *fname;              ///< Fname to match with
   char *sfname;             ///< Sfname to match with
   char *tail;               ///< Tail of fname
+  int tail_len;             ///< match_file_literal_len() of tail
+  char *fname_arg;          ///< "fname" argument, NULL when it was empty
   int group;                ///< Group being used
   event_T event;            ///< Current event
   sctx_T script_ctx;        ///< Script context where it is defined
   int arg_bufnr;            ///< Initially equal to <abuf>, set to zero when buf is deleted
   Object *data;             ///< Arbitrary data
+  int64_t debounce_id;      ///< Only execute this postponed autocmd, see aucmd_debounce()
   AutoPatCmd *next;         ///< Chain of active apc-s for auto-invalidation
 };
 
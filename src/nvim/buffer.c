@@ -68,6 +68,7 @@
 #include "nvim/help.h"
 #include "nvim/indent.h"
 #include "nvim/indent_c.h"
+#include "nvim/insexpand.h"
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/mapping.h"
@@ -617,6 +618,9 @@ bool close_buffer(win_T *win, buf_T *buf, int action, bool abort_if_last, bool i
   if (buf->b_nwindows > 0) {
     buf->b_nwindows--;
   }
+  if (buf->b_nwindows == 0) {
+    buf_unwatch_file(buf);  // only checked again when in a window
+  }
 
   if (diffopt_hiddenoff() && !unload_buf && buf->b_nwindows == 0) {
     diff_buf_delete(buf);   // Clear 'diff' for hidden buffer.
@@ -846,6 +850,7 @@ void buf_freeall(buf_T *buf, int flags)
   }
 
   ml_close(buf, true);              // close and delete the memline/memfile
+  buf_unwatch_file(buf);
   buf->b_ml.ml_line_count = 0;      // no lines in buffer
   if ((flags & BFA_KEEP_UNDO) == 0) {
     // free the memory allocated for undo
@@ -853,6 +858,7 @@ void buf_freeall(buf_T *buf, int flags)
     u_clearallandblockfree(buf);
   }
   syntax_clear(&buf->b_s);          // reset syntax info
+  ins_compl_free_buf_words(buf);    // words for completion
   buf->b_flags &= ~BF_READERR;      // a read error is no longer relevant
 }
 
@@ -860,8 +866,11 @@ void buf_freeall(buf_T *buf, int flags)
 /// itself (not the file, that must have been done already).
 static void free_buffer(buf_T *buf)
 {
+  // Entries can't find the line changes of the buffer after this.
+  qf_adjust_flush(buf);
   pmap_del(int)(&buffer_handles, buf->b_fnum, NULL);
   buf_free_count++;
+  buf_unwatch_file(buf);
   // b:changedtick uses an item in buf_T.
   free_buffer_stuff(buf, kBffClearWinInfo);
   if (buf->b_vars->dv_refcount > DO_NOT_FREE_CNT) {
@@ -2118,6 +2127,7 @@ void free_buf_options(buf_T *buf, bool free_p_ff)
   clear_string_option(&buf->b_p_qe);
   buf->b_p_ar = -1;
   buf->b_p_ul = NO_LOCAL_UNDOLEVEL;
+  buf->b_p_um = -1;
   clear_string_option(&buf->b_p_lw);
   clear_string_option(&buf->b_p_bkc);
   clear_string_option(&buf->b_p_menc);
@@ -2389,6 +2399,7 @@ int buflist_findpat(const char *pattern, const char *pattern_end, bool unlisted,
 typedef struct {
   buf_T *buf;
   char *match;
+  int score;  ///< fuzzy match score
 } bufmatch_T;
 
 /// Compare functions for qsort() below, that compares b_last_used.
@@ -2409,7 +2420,6 @@ static int buf_time_compare(const void *s1, const void *s2)
 /// @return  OK if matches found, FAIL otherwise.
 int ExpandBufnames(char *pat, int *num_file, char ***file, int options)
 {
-  bufmatch_T *matches = NULL;
   bool to_free = false;
 
   *num_file = 0;                    // return values in case of FAIL
@@ -2422,7 +2432,6 @@ int ExpandBufnames(char *pat, int *num_file, char ***file, int options)
   const bool fuzzy = cmdline_fuzzy_complete(pat);
 
   char *patc = NULL;
-  fuzmatch_str_T *fuzmatch = NULL;
   regmatch_T regmatch;
 
   // Make a copy of "pat" and change "^" to "\(^\|[\/]\)" (if doing regular
@@ -2439,91 +2448,60 @@ int ExpandBufnames(char *pat, int *num_file, char ***file, int options)
     regmatch.regprog = vim_regcomp(patc, RE_MAGIC);
   }
 
-  int count = 0;
-  int score = 0;
-  // round == 1: Count the matches.
-  // round == 2: Build the array to keep the matches.
-  for (int round = 1; round <= 2; round++) {
-    count = 0;
-    FOR_ALL_BUFFERS(buf) {
-      if (!buf->b_p_bl) {             // skip unlisted buffers
+  // Find the matches in one pass, matching the names of many buffers is
+  // what takes time.
+  garray_T ga;
+  ga_init(&ga, (int)sizeof(bufmatch_T), 10);
+  FOR_ALL_BUFFERS(buf) {
+    if (!buf->b_p_bl) {             // skip unlisted buffers
+      continue;
+    }
+    if (options & BUF_DIFF_FILTER) {
+      // Skip buffers not suitable for
+      // :diffget or :diffput completion.
+      if (buf == curbuf || !diff_mode_buf(buf)) {
         continue;
       }
-      if (options & BUF_DIFF_FILTER) {
-        // Skip buffers not suitable for
-        // :diffget or :diffput completion.
-        if (buf == curbuf || !diff_mode_buf(buf)) {
-          continue;
-        }
-      }
+    }
 
-      char *p = NULL;
-      if (!fuzzy) {
-        if (regmatch.regprog == NULL) {
-          // invalid pattern, possibly after recompiling
-          if (to_free) {
-            xfree(patc);
-          }
-          return FAIL;
-        }
-        p = buflist_match(&regmatch, buf, p_wic);
-      } else {
-        p = NULL;
-        // first try matching with the short file name
-        if ((score = fuzzy_match_str(buf->b_sfname, pat)) != 0) {
-          p = buf->b_sfname;
+    char *p = NULL;
+    int score = 0;
+    if (!fuzzy) {
+      if (regmatch.regprog == NULL) {
+        // invalid pattern, possibly after recompiling
+        if (to_free) {
+          xfree(patc);
         }
-        if (p == NULL) {
-          // next try matching with the full path file name
-          if ((score = fuzzy_match_str(buf->b_ffname, pat)) != 0) {
-            p = buf->b_ffname;
-          }
+        for (int i = 0; i < ga.ga_len; i++) {
+          xfree(((bufmatch_T *)ga.ga_data)[i].match);
         }
+        ga_clear(&ga);
+        return FAIL;
       }
-
-      if (p == NULL) {
-        continue;
-      }
-
-      if (round == 1) {
-        count++;
-        continue;
-      }
-
-      if (options & WILD_HOME_REPLACE) {
-        p = home_replace_save(buf, p);
-      } else {
-        p = xstrdup(p);
+      p = buflist_match(&regmatch, buf, p_wic);
+    } else {
+      // first try matching with the short file name
+      if ((score = fuzzy_match_str(buf->b_sfname, pat)) != 0) {
+        p = buf->b_sfname;
       }
-
-      if (!fuzzy) {
-        if (matches != NULL) {
-          matches[count].buf = buf;
-          matches[count].match = p;
-          count++;
-        } else {
-          (*file)[count++] = p;
+      if (p == NULL) {
+        // next try matching with the full path file name
+        if ((score = fuzzy_match_str(buf->b_ffname, pat)) != 0) {
+          p = buf->b_ffname;
         }
-      } else {
-        fuzmatch[count].idx = count;
-        fuzmatch[count].str = p;
-        fuzmatch[count].score = score;
-        count++;
       }
     }
-    if (count == 0) {         // no match found, break here
-      break;
+
+    if (p == NULL) {
+      continue;
     }
-    if (round == 1) {
-      if (!fuzzy) {
-        *file = xmalloc((size_t)count * sizeof(**file));
-        if (options & WILD_BUFLASTUSED) {
-          matches = xmalloc((size_t)count * sizeof(*matches));
-        }
-      } else {
-        fuzmatch = xmalloc((size_t)count * sizeof(fuzmatch_str_T));
-      }
+
+    if (options & WILD_HOME_REPLACE) {
+      p = home_replace_save(buf, p);
+    } else {
+      p = xstrdup(p);
     }
+    GA_APPEND(bufmatch_T, &ga, ((bufmatch_T){ .buf = buf, .match = p, .score = score }));
   }
 
   if (!fuzzy) {
@@ -2533,28 +2511,43 @@ int ExpandBufnames(char *pat, int *num_file, char ***file, int options)
     }
   }
 
-  if (!fuzzy) {
-    if (matches != NULL) {
-      if (count > 1) {
-        qsort(matches, (size_t)count, sizeof(bufmatch_T), buf_time_compare);
-      }
+  int count = ga.ga_len;
+  bufmatch_T *matches = ga.ga_data;
+  if (count > 0) {
+    if (!fuzzy) {
+      *file = xmalloc((size_t)count * sizeof(**file));
+      if (options & WILD_BUFLASTUSED) {
+        if (count > 1) {
+          qsort(matches, (size_t)count, sizeof(bufmatch_T), buf_time_compare);
+        }
 
-      // if the current buffer is first in the list, place it at the end
-      if (matches[0].buf == curbuf) {
-        for (int i = 1; i < count; i++) {
-          (*file)[i - 1] = matches[i].match;
+        // if the current buffer is first in the list, place it at the end
+        if (matches[0].buf == curbuf) {
+          for (int i = 1; i < count; i++) {
+            (*file)[i - 1] = matches[i].match;
+          }
+          (*file)[count - 1] = matches[0].match;
+        } else {
+          for (int i = 0; i < count; i++) {
+            (*file)[i] = matches[i].match;
+          }
         }
-        (*file)[count - 1] = matches[0].match;
       } else {
         for (int i = 0; i < count; i++) {
           (*file)[i] = matches[i].match;
         }
       }
-      xfree(matches);
+    } else {
+      fuzmatch_str_T *fuzmatch = xmalloc((size_t)count * sizeof(fuzmatch_str_T));
+      for (int i = 0; i < count; i++) {
+        fuzmatch[i].idx = i;
+        fuzmatch[i].str = matches[i].match;
+        fuzmatch[i].score = matches[i].score;
+      }
+      fuzzymatches_to_strmatches(fuzmatch, file, count, false);
     }
-  } else {
-    fuzzymatches_to_strmatches(fuzmatch, file, count, false);
   }
+  ga_clear(&ga);
 
   *num_file = count;
   return count == 0 ? FAIL : OK;
@@ -2594,12 +2587,19 @@ static char *fname_match(regmatch_T *rmp, char *name, bool ignore_case)
   if (vim_regexec(rmp, name, 0)) {
     match = name;
   } else if (rmp->regprog != NULL) {
-    // Replace $(HOME) with '~' and try matching again.
-    char *p = home_replace_save(NULL, name);
-    if (vim_regexec(rmp, p, 0)) {
+    // Replace $(HOME) with '~' and try matching again.  Only when that
+    // changes the name, this is done for every buffer.
+    char buf[MAXPATHL];
+    char *p = strlen(name) < MAXPATHL ? buf : home_replace_save(NULL, name);
+    if (p == buf) {
+      home_replace(NULL, name, buf, MAXPATHL, true);
+    }
+    if (strcmp(p, name) != 0 && vim_regexec(rmp, p, 0)) {
       match = name;
     }
-    xfree(p);
+    if (p != buf) {
+      xfree(p);
+    }
   }
 
   return match;
@@ -3303,11 +3303,12 @@ void fileinfo(int fullname, int shorthelp, bool dont_truncate)
 
 int col_print(char *buf, size_t buflen, int col, int vcol)
 {
-  if (col == vcol) {
-    return vim_snprintf(buf, buflen, "%d", col);
+  size_t len = vim_fmt_num(buf, buflen, col, 0);
+  if (col != vcol && len + 1 < buflen) {
+    buf[len++] = '-';
+    len += vim_fmt_num(buf + len, buflen - len, vcol, 0);
   }
-
-  return vim_snprintf(buf, buflen, "%d-%d", col, vcol);
+  return (int)len;
 }
 
 static char *lasttitle = NULL;
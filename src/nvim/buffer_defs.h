@@ -5,6 +5,7 @@
 #include <stdio.h>
 
 #include "nvim/arglist_defs.h"
+#include "nvim/extmark_defs.h"
 #include "nvim/grid_defs.h"
 #include "nvim/mapping_defs.h"
 #include "nvim/marktree_defs.h"
@@ -253,6 +254,8 @@ struct wininfo_S {
 
 typedef struct qf_info_S qf_info_T;
 
+typedef struct compl_words_S compl_words_T;
+
 // Used for :syntime: timing of executing a syntax pattern.
 typedef struct {
   proftime_T total;             // total time used
@@ -266,6 +269,9 @@ typedef struct {
 typedef struct {
   hashtab_T b_keywtab;                  // syntax keywords hash table
   hashtab_T b_keywtab_ic;               // idem, ignore case
+  uint64_t b_keyw_len_mask[2];          // bit N set: a keyword has N bytes
+  uint64_t b_keyw_start_mask[4];        // bit C set: a keyword may start with
+                                        // byte C
   bool b_syn_error;                     // true when error occurred in HL
   bool b_syn_slow;                      // true when 'redrawtime' reached
   int b_syn_ic;                         // ignore case for :syn cmds
@@ -320,6 +326,10 @@ typedef struct {
   char *b_p_spl;              // 'spelllang'
   char *b_p_spo;              // 'spelloptions'
   unsigned b_p_spo_flags;      // 'spelloptions' flags
+  // lines without bad words found by spell_move_to(), see spell_clean_line_get()
+  Map(int64_t, int64_t) b_spell_clean;
+  varnumber_T b_spell_clean_tick;  // b:changedtick when b_spell_clean was filled
+  int b_spell_clean_state;         // spell_state_tick when b_spell_clean was filled
   int b_cjk;                  // all CJK letters as OK
   uint8_t b_syn_chartab[32];  // syntax iskeyword option
   char *b_syn_isk;            // iskeyword option
@@ -330,6 +340,19 @@ typedef struct {
 /// Primary exists so that literals of relevant type can be made.
 typedef TV_DICTITEM_STRUCT(sizeof("changedtick")) ChangedtickDictItem;
 
+/// Text change queued for an "on_bytes" callback with "batch" set.
+typedef struct {
+  int start_row;
+  colnr_T start_col;
+  bcount_t start_byte;
+  int old_row;
+  colnr_T old_col;
+  bcount_t old_byte;
+  int new_row;
+  colnr_T new_col;
+  bcount_t new_byte;
+} BufUpdateSplice;
+
 typedef struct {
   LuaRef on_lines;
   LuaRef on_bytes;
@@ -338,6 +361,18 @@ typedef struct {
   LuaRef on_reload;
   bool utf_sizes;
   bool preview;
+  bool batch;  ///< queue changes and deliver them merged, see buf_updates_flush()
+
+  // Changed lines queued for "on_lines" with "batch", zero-based
+  bool lines_pending;
+  linenr_T lines_first;
+  linenr_T lines_last_old;
+  linenr_T lines_last_new;
+  size_t lines_bytes;
+  size_t lines_codepoints;
+  size_t lines_codeunits;
+  // Changes queued for "on_bytes" with "batch"
+  kvec_t(BufUpdateSplice) splices;
 } BufUpdateCallbacks;
 #define BUF_UPDATE_CALLBACKS_INIT { LUA_NOREF, LUA_NOREF, LUA_NOREF, \
                                     LUA_NOREF, LUA_NOREF, false, false }
@@ -345,6 +380,18 @@ typedef struct {
 #define BUF_HAS_QF_ENTRY 1
 #define BUF_HAS_LL_ENTRY 2
 
+/// Number of line changes that are kept for quickfix entries of a buffer before
+/// they are applied to all of them, see qf_mark_adjust().
+#define QF_ADJUST_MAX 32
+
+/// A line change as passed to mark_adjust().
+typedef struct {
+  linenr_T line1;
+  linenr_T line2;
+  linenr_T amount;
+  linenr_T amount_after;
+} LineAdjust;
+
 // Maximum number of maphash blocks we will have
 #define MAX_MAPHASH 256
 
@@ -424,6 +471,8 @@ struct file_buffer {
   int64_t b_mtime_read_ns;      // nanoseconds of last read time
   uint64_t b_orig_size;         // size of original file in bytes
   int b_orig_mode;              // mode of original file
+  struct fs_watcher *b_fswatcher;  // watches the file for changes, or NULL
+  bool b_fschanged;             // b_fswatcher saw a change since last check
   time_t b_last_used;           // time when the buffer was last used; used
                                 // for viminfo
 
@@ -480,6 +529,8 @@ struct file_buffer {
                                // if b_u_curhead is not NULL
   u_header_T *b_u_curhead;     // pointer to current header
   int b_u_numhead;             // current number of headers
+  size_t b_u_memory;           // bytes used by the undo entries
+  PMap(int) b_u_seq_headers;   // undo headers by uh_seq
   bool b_u_synced;             // entry lists are synced
   int b_u_seq_last;            // last used undo sequence number
   int b_u_save_nr_last;        // counter for last file write
@@ -493,6 +544,7 @@ struct file_buffer {
   colnr_T b_u_line_colnr;       // optional column number
 
   bool b_scanned;               // ^N/^P have scanned this buffer
+  compl_words_T *b_compl_words;  // words for ^N/^P, see insexpand.c
 
   // flags for use of ":lmap" and IM control
   OptInt b_p_iminsert;          // input mode for insert
@@ -525,6 +577,11 @@ struct file_buffer {
   char *b_p_bt;                 ///< 'buftype'
   OptInt b_p_busy;              ///< 'busy'
   int b_has_qf_entry;           ///< quickfix exists for buffer
+  /// Line changes not applied to the quickfix and location list entries for
+  /// this buffer yet. Entries remember how many of them they have seen.
+  LineAdjust b_qf_adjust[QF_ADJUST_MAX];
+  int b_qf_adjust_len;
+  int b_qf_adjust_gen;          ///< incremented when the changes were applied to all entries
   int b_p_bl;                   ///< 'buflisted'
   OptInt b_p_channel;           ///< 'channel'
   int b_p_cin;                  ///< 'cindent'
@@ -624,6 +681,7 @@ struct file_buffer {
   char *b_p_tsrfu;              ///< 'thesaurusfunc' local value
   Callback b_tsrfu_cb;          ///< 'thesaurusfunc' callback
   OptInt b_p_ul;                ///< 'undolevels' local value
+  OptInt b_p_um;                ///< 'undomemory' local value
   int b_p_udf;                  ///< 'undofile'
   char *b_p_lw;                 ///< 'lispwords' local value
 
@@ -740,6 +798,9 @@ struct file_buffer {
   // whether an update callback has requested codepoint size of deleted regions.
   bool update_need_codepoints;
 
+  // whether a "batch" update callback has queued changes.
+  bool update_pending;
+
   // Measurements of the deleted or replaced region since the last update
   // event. Some consumers of buffer changes need to know the byte size (like
   // treesitter) or the corresponding UTF-32/UTF-16 size (like LSP) of the
@@ -807,6 +868,16 @@ struct diffline_S {
   int lineoff;
 };
 
+/// Lines of a diff buffer changed since the list of diffs was last updated.
+/// Used to re-diff only the edited part of the buffers.
+typedef struct {
+  varnumber_T dd_tick;  ///< b:changedtick after the last recorded change, -1 when
+                        ///< a change was missed
+  linenr_T dd_lines;    ///< line count after the last recorded change
+  linenr_T dd_top;      ///< first changed line, zero when nothing changed
+  linenr_T dd_bot;      ///< last changed line
+} diffdirty_T;
+
 #define SNAP_HELP_IDX   0
 #define SNAP_AUCMD_IDX 1
 #define SNAP_COUNT     2
@@ -833,6 +904,9 @@ struct tabpage_S {
   buf_T *(tp_diffbuf[DB_COUNT]);
   int tp_diff_invalid;              ///< list of diffs is outdated
   int tp_diff_update;               ///< update diffs before redrawing
+  bool tp_diff_partial;             ///< list of diffs is only outdated for the
+                                    ///< lines in tp_diff_dirty[]
+  diffdirty_T tp_diff_dirty[DB_COUNT];
   frame_T *(tp_snapshot[SNAP_COUNT]);    ///< window layout snapshots
   ScopeDictDictItem tp_winvar;      ///< Variable for "t:" Dict.
   dict_T *tp_vars;         ///< Internal variables, local to tab page.
@@ -1029,6 +1103,54 @@ typedef struct {
   pos_T w_cursor_corr;  // corrected cursor position
 } pos_save_T;
 
+/// Virtual column of a character in a long line, see vcol_cache_get().
+typedef struct {
+  colnr_T col;     ///< byte index of the character
+  colnr_T nchars;  ///< number of characters before "col"
+  colnr_T vcol;    ///< virtual column where the character starts
+} VcolCheckpoint;
+
+/// Size of a long line in a window and virtual columns of some of its
+/// characters, computed once for the line text and the options involved.
+typedef struct {
+  linenr_T lnum;            ///< line number, zero when not used
+  handle_T buf;             ///< handle of the buffer of the line
+  varnumber_T changedtick;  ///< b:changedtick when computed
+  colnr_T len;              ///< length of the line in bytes
+  uint32_t epoch;           ///< see vcol_cache_invalidate_all()
+  OptInt ts;                ///< 'tabstop'
+  bool use_tabstop;         ///< CharsizeArg.use_tabstop
+  int width1;               ///< width of the first screen line, 0 for 'nowrap'
+  int width2;               ///< width of further screen lines
+  int size;                 ///< size of the whole line, like linesize_fast()
+  kvec_t(VcolCheckpoint) checkpoints;
+} VcolCache;
+
+enum {
+  kVcolCacheSize = 4,  ///< number of long lines cached per window
+};
+
+/// Width of the inline virtual text placed at one byte of a line.
+typedef struct {
+  colnr_T col;      ///< byte index of the character the text is placed at
+  int width_left;   ///< width of text with left gravity
+  int width_right;  ///< width of text with right gravity
+} InlineVirtItem;
+
+/// Inline virtual text of a line that is shown in a window, so that computing
+/// the size of each character does not need to look up the marks again.
+typedef struct {
+  linenr_T lnum;            ///< line number, zero when not used
+  handle_T buf;             ///< handle of the buffer of the line
+  varnumber_T changedtick;  ///< b:changedtick when computed
+  uint32_t epoch;           ///< see inline_virt_cache_invalidate_all()
+  kvec_t(InlineVirtItem) items;  ///< sorted on "col", without zero widths
+} InlineVirtCache;
+
+enum {
+  kInlineVirtCacheSize = 4,  ///< number of lines cached per window
+};
+
 /// Characters from the 'listchars' option.
 typedef struct {
   schar_T eol;
@@ -1149,6 +1271,7 @@ struct window_S {
   colnr_T w_skipcol;                // starting screen column for the first
                                     // line in the window; used when 'wrap' is
                                     // on; does not include win_col_off()
+  colnr_T w_old_skipcol;            // w_skipcol at last redraw
 
   // six fields that are only used when there is a WinScrolled autocommand
   linenr_T w_last_topline;          ///< last known value for w_topline
@@ -1247,6 +1370,18 @@ struct window_S {
   wline_T *w_lines;
   int w_lines_size;
 
+  // Screen rows of lines drawn by win_line(), by line number, which can be
+  // put back when the same line is drawn again, see win_line_cache_put().
+  PMap(int) w_line_cache;
+
+  // Sizes of recently used long lines, see vcol_cache_get().
+  VcolCache w_vcol_cache[kVcolCacheSize];
+  int w_vcol_cache_next;            // entry of w_vcol_cache[] to use next
+
+  // Inline virtual text of recently used lines, see inline_virt_cache_get().
+  InlineVirtCache w_inline_virt_cache[kInlineVirtCacheSize];
+  int w_inline_virt_cache_next;     // entry of w_inline_virt_cache[] to use next
+
   garray_T w_folds;                 // array of nested folds
   bool w_fold_manual;               // when true: some folds are opened/closed
                                     // manually
@@ -1266,6 +1401,8 @@ struct window_S {
   linenr_T w_redraw_top;            // when != 0: first line needing redraw
   linenr_T w_redraw_bot;            // when != 0: last line needing redraw
   bool w_redr_status;               // if true statusline/winbar must be redrawn
+  bool w_stl_repaint;               // w_redr_status is only set because the
+                                    // statusline/winbar was overwritten
   bool w_redr_border;               // if true border must be redrawn
   bool w_redr_statuscol;            // if true 'statuscolumn' must be redrawn
 
@@ -1279,6 +1416,7 @@ struct window_S {
   int w_stl_recording;               // reg_recording when last redrawn
   int w_stl_state;                   // get_real_state() when last redrawn
   int w_stl_visual_mode;             // VIsual_mode when last redrawn
+  StlCache w_stl_cache[2];           // last evaluated statusline and winbar
 
   int w_alt_fnum;                   // alternate file (for # and CTRL-^)
 
@@ -11,9 +11,12 @@
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/buffer_updates.h"
+#include "nvim/event/multiqueue.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
+#include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/memory_defs.h"
@@ -25,6 +28,9 @@
 # include "buffer_updates.c.generated.h"  // IWYU pragma: keep
 #endif
 
+/// Whether buf_updates_flush_event() was put on the main loop queue.
+static bool flush_scheduled = false;
+
 // Register a channel. Return True if the channel was added, or already added.
 // Return False if the channel couldn't be added because the buffer is
 // unloaded.
@@ -151,6 +157,8 @@ void buf_free_callbacks(buf_T *buf)
 
 void buf_updates_unload(buf_T *buf, bool can_reload)
 {
+  buf_updates_flush(buf);
+
   size_t size = kv_size(buf->update_channels);
   if (size) {
     for (size_t i = 0; i < size; i++) {
@@ -270,36 +278,14 @@ void buf_updates_send_changes(buf_T *buf, linenr_T firstline, int64_t num_added,
     BufUpdateCallbacks cb = kv_A(buf->update_callbacks, i);
     bool keep = true;
     if (cb.on_lines != LUA_NOREF && (cb.preview || !cmdpreview)) {
-      MAXSIZE_TEMP_ARRAY(args, 8);  // 6 or 8 used
-
-      // the first argument is always the buffer handle
-      ADD_C(args, BUFFER_OBJ(buf->handle));
-
-      // next argument is b:changedtick
-      ADD_C(args, send_tick ? INTEGER_OBJ(buf_get_changedtick(buf)) : NIL);
-
-      // the first line that changed (zero-indexed)
-      ADD_C(args, INTEGER_OBJ(firstline - 1));
-
-      // the last line that was changed
-      ADD_C(args, INTEGER_OBJ(firstline - 1 + num_removed));
-
-      // the last line in the updated range
-      ADD_C(args, INTEGER_OBJ(firstline - 1 + num_added));
-
-      // byte count of previous contents
-      ADD_C(args, INTEGER_OBJ((Integer)deleted_bytes));
-      if (cb.utf_sizes) {
-        ADD_C(args, INTEGER_OBJ((Integer)deleted_codepoints));
-        ADD_C(args, INTEGER_OBJ((Integer)deleted_codeunits));
-      }
-
-      Object res;
-      TEXTLOCK_WRAP({
-        res = nlua_call_ref(cb.on_lines, "lines", args, kRetNilBool, NULL, NULL);
-      });
-
-      if (LUARET_TRUTHY(res)) {
+      linenr_T first = firstline - 1;
+      linenr_T last_old = first + (linenr_T)num_removed;
+      linenr_T last_new = first + (linenr_T)num_added;
+      if (cb.batch) {
+        buf_updates_queue_lines(buf, &kv_A(buf->update_callbacks, i), first, last_old, last_new,
+                                deleted_bytes, deleted_codepoints, deleted_codeunits);
+      } else if (buf_updates_call_lines(buf, cb, send_tick, first, last_old, last_new,
+                                        deleted_bytes, deleted_codepoints, deleted_codeunits)) {
         buffer_update_callbacks_free(cb);
         keep = false;
       }
@@ -326,36 +312,205 @@ void buf_updates_send_splice(buf_T *buf, int start_row, colnr_T start_col, bcoun
     BufUpdateCallbacks cb = kv_A(buf->update_callbacks, i);
     bool keep = true;
     if (cb.on_bytes != LUA_NOREF && (cb.preview || !cmdpreview)) {
-      MAXSIZE_TEMP_ARRAY(args, 11);
+      BufUpdateSplice splice = {
+        start_row, start_col, start_byte,
+        old_row, old_col, old_byte,
+        new_row, new_col, new_byte,
+      };
+      if (cb.batch) {
+        buf_updates_queue_splice(buf, &kv_A(buf->update_callbacks, i), splice);
+      } else if (buf_updates_call_bytes(buf, cb, splice)) {
+        buffer_update_callbacks_free(cb);
+        keep = false;
+      }
+    }
+    if (keep) {
+      kv_A(buf->update_callbacks, j++) = kv_A(buf->update_callbacks, i);
+    }
+  }
+  kv_size(buf->update_callbacks) = j;
+}
 
-      // the first argument is always the buffer handle
-      ADD_C(args, BUFFER_OBJ(buf->handle));
+/// Calls the "on_lines" callback of "cb".
+///
+/// @return  true if the callback asked to detach.
+static bool buf_updates_call_lines(buf_T *buf, BufUpdateCallbacks cb, bool send_tick,
+                                   linenr_T first, linenr_T last_old, linenr_T last_new,
+                                   size_t deleted_bytes, size_t deleted_codepoints,
+                                   size_t deleted_codeunits)
+{
+  MAXSIZE_TEMP_ARRAY(args, 8);  // 6 or 8 used
 
-      // next argument is b:changedtick
-      ADD_C(args, INTEGER_OBJ(buf_get_changedtick(buf)));
+  // the first argument is always the buffer handle
+  ADD_C(args, BUFFER_OBJ(buf->handle));
 
-      ADD_C(args, INTEGER_OBJ(start_row));
-      ADD_C(args, INTEGER_OBJ(start_col));
-      ADD_C(args, INTEGER_OBJ(start_byte));
-      ADD_C(args, INTEGER_OBJ(old_row));
-      ADD_C(args, INTEGER_OBJ(old_col));
-      ADD_C(args, INTEGER_OBJ(old_byte));
-      ADD_C(args, INTEGER_OBJ(new_row));
-      ADD_C(args, INTEGER_OBJ(new_col));
-      ADD_C(args, INTEGER_OBJ(new_byte));
+  // next argument is b:changedtick
+  ADD_C(args, send_tick ? INTEGER_OBJ(buf_get_changedtick(buf)) : NIL);
 
-      Object res;
-      TEXTLOCK_WRAP({
-        res = nlua_call_ref(cb.on_bytes, "bytes", args, kRetNilBool, NULL, NULL);
-      });
+  // the first line that changed (zero-indexed)
+  ADD_C(args, INTEGER_OBJ(first));
 
-      if (LUARET_TRUTHY(res)) {
-        buffer_update_callbacks_free(cb);
+  // the last line that was changed
+  ADD_C(args, INTEGER_OBJ(last_old));
+
+  // the last line in the updated range
+  ADD_C(args, INTEGER_OBJ(last_new));
+
+  // byte count of previous contents
+  ADD_C(args, INTEGER_OBJ((Integer)deleted_bytes));
+  if (cb.utf_sizes) {
+    ADD_C(args, INTEGER_OBJ((Integer)deleted_codepoints));
+    ADD_C(args, INTEGER_OBJ((Integer)deleted_codeunits));
+  }
+
+  Object res;
+  TEXTLOCK_WRAP({
+    res = nlua_call_ref(cb.on_lines, "lines", args, kRetNilBool, NULL, NULL);
+  });
+  return LUARET_TRUTHY(res);
+}
+
+/// Calls the "on_bytes" callback of "cb".
+///
+/// @return  true if the callback asked to detach.
+static bool buf_updates_call_bytes(buf_T *buf, BufUpdateCallbacks cb, BufUpdateSplice s)
+{
+  Integer args[] = {
+    // the first argument is always the buffer handle
+    buf->handle,
+    // next argument is b:changedtick
+    buf_get_changedtick(buf),
+    s.start_row, s.start_col, s.start_byte,
+    s.old_row, s.old_col, s.old_byte,
+    s.new_row, s.new_col, s.new_byte,
+  };
+
+  Object res;
+  TEXTLOCK_WRAP({
+    res = nlua_call_ref_int(cb.on_bytes, "bytes", args, ARRAY_SIZE(args), kRetNilBool, NULL);
+  });
+  return LUARET_TRUTHY(res);
+}
+
+/// Marks "buf" as having queued changes and makes sure they get delivered.
+static void buf_updates_pending(buf_T *buf)
+{
+  buf->update_pending = true;
+  if (!flush_scheduled) {
+    flush_scheduled = true;
+    multiqueue_put(main_loop.events, buf_updates_flush_event, NULL);
+  }
+}
+
+/// Merges the change of lines "first" to "last_old" (now "last_new") into the
+/// range queued for "cb". The queued range is in terms of the text before the
+/// first queued change ("last_old") and the current text ("last_new").
+static void buf_updates_queue_lines(buf_T *buf, BufUpdateCallbacks *cb, linenr_T first,
+                                    linenr_T last_old, linenr_T last_new, size_t deleted_bytes,
+                                    size_t deleted_codepoints, size_t deleted_codeunits)
+{
+  if (!cb->lines_pending) {
+    cb->lines_pending = true;
+    cb->lines_first = first;
+    cb->lines_last_old = last_old;
+    cb->lines_last_new = last_new;
+    cb->lines_bytes = deleted_bytes;
+    cb->lines_codepoints = deleted_codepoints;
+    cb->lines_codeunits = deleted_codeunits;
+    buf_updates_pending(buf);
+    return;
+  }
+
+  // "last_old" of this change is in the current text, lines after the queued
+  // range are shifted by the lines the queued changes added.
+  linenr_T end = MAX(cb->lines_last_new, last_old);
+  cb->lines_first = MIN(cb->lines_first, first);
+  cb->lines_last_old = end - (cb->lines_last_new - cb->lines_last_old);
+  cb->lines_last_new = end + (last_new - last_old);
+  cb->lines_bytes += deleted_bytes;
+  cb->lines_codepoints += deleted_codepoints;
+  cb->lines_codeunits += deleted_codeunits;
+}
+
+/// Adds extent "b" to extent "a", which is where "b" starts.
+static void splice_extent_add(int *a_row, colnr_T *a_col, int b_row, colnr_T b_col)
+{
+  if (b_row == 0) {
+    *a_col += b_col;
+  } else {
+    *a_row += b_row;
+    *a_col = b_col;
+  }
+}
+
+/// Queues "splice" for "cb", merged with the previous queued change if it
+/// starts where the new text of that one ends, like for typed text.
+static void buf_updates_queue_splice(buf_T *buf, BufUpdateCallbacks *cb, BufUpdateSplice splice)
+{
+  if (kv_size(cb->splices) > 0) {
+    BufUpdateSplice *last = &kv_last(cb->splices);
+    if (splice.start_byte == last->start_byte + last->new_byte) {
+      splice_extent_add(&last->old_row, &last->old_col, splice.old_row, splice.old_col);
+      last->old_byte += splice.old_byte;
+      splice_extent_add(&last->new_row, &last->new_col, splice.new_row, splice.new_col);
+      last->new_byte += splice.new_byte;
+      return;
+    }
+  }
+  kv_push(cb->splices, splice);
+  buf_updates_pending(buf);
+}
+
+static void buf_updates_flush_event(void **argv)
+{
+  flush_scheduled = false;
+  buf_updates_flush_all();
+}
+
+/// Delivers the changes queued for callbacks with "batch" of all buffers.
+void buf_updates_flush_all(void)
+{
+  FOR_ALL_BUFFERS(buf) {
+    buf_updates_flush(buf);
+  }
+}
+
+/// Delivers the changes queued for callbacks with "batch" of "buf".
+void buf_updates_flush(buf_T *buf)
+{
+  if (!buf->update_pending) {
+    return;
+  }
+  buf->update_pending = false;
+
+  bool send_tick = !(cmdpreview && buf == curbuf);
+
+  size_t j = 0;
+  for (size_t i = 0; i < kv_size(buf->update_callbacks); i++) {
+    BufUpdateCallbacks *cbp = &kv_A(buf->update_callbacks, i);
+    BufUpdateCallbacks cb = *cbp;
+    cbp->lines_pending = false;
+    kv_init(cbp->splices);
+
+    // like for a single change, "on_bytes" goes first
+    bool keep = true;
+    for (size_t k = 0; keep && k < kv_size(cb.splices); k++) {
+      if (buf_updates_call_bytes(buf, cb, kv_A(cb.splices, k))) {
         keep = false;
       }
     }
+    kv_destroy(cb.splices);
+    if (keep && cb.lines_pending
+        && buf_updates_call_lines(buf, cb, send_tick, cb.lines_first, cb.lines_last_old,
+                                  cb.lines_last_new, cb.lines_bytes, cb.lines_codepoints,
+                                  cb.lines_codeunits)) {
+      keep = false;
+    }
+
     if (keep) {
       kv_A(buf->update_callbacks, j++) = kv_A(buf->update_callbacks, i);
+    } else {
+      buffer_update_callbacks_free(kv_A(buf->update_callbacks, i));
     }
   }
   kv_size(buf->update_callbacks) = j;
@@ -372,17 +527,13 @@ void buf_updates_changedtick(buf_T *buf)
     BufUpdateCallbacks cb = kv_A(buf->update_callbacks, i);
     bool keep = true;
     if (cb.on_changedtick != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 2);
-
-      // the first argument is always the buffer handle
-      ADD_C(args, BUFFER_OBJ(buf->handle));
-
-      // next argument is b:changedtick
-      ADD_C(args, INTEGER_OBJ(buf_get_changedtick(buf)));
+      // the buffer handle and b:changedtick
+      Integer args[] = { buf->handle, buf_get_changedtick(buf) };
 
       Object res;
       TEXTLOCK_WRAP({
-        res = nlua_call_ref(cb.on_changedtick, "changedtick", args, kRetNilBool, NULL, NULL);
+        res = nlua_call_ref_int(cb.on_changedtick, "changedtick", args, ARRAY_SIZE(args),
+                                kRetNilBool, NULL);
       });
 
       if (LUARET_TRUTHY(res)) {
@@ -418,4 +569,5 @@ void buffer_update_callbacks_free(BufUpdateCallbacks cb)
   api_free_luaref(cb.on_changedtick);
   api_free_luaref(cb.on_reload);
   api_free_luaref(cb.on_detach);
+  kv_destroy(cb.splices);
 }
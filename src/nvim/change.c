@@ -238,6 +238,7 @@ static void changed_common(buf_T *buf, linenr_T lnum, colnr_T col, linenr_T lnum
 {
   // mark the buffer as modified
   changed(buf);
+  diff_record_change(buf, lnum, lnume, xtra);
 
   FOR_ALL_WINDOWS_IN_TAB(win, curtab) {
     if (win->w_buffer == buf && win->w_p_diff && diff_internal()) {
@@ -10,6 +10,7 @@
 #include "nvim/api/private/converter.h"
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
+#include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/autocmd_defs.h"
 #include "nvim/buffer_defs.h"
@@ -282,7 +283,7 @@ void callback_reader_free(CallbackReader *reader)
 
 void callback_reader_start(CallbackReader *reader, const char *type)
 {
-  ga_init(&reader->buffer, sizeof(char *), 32);
+  ga_init(&reader->buffer, sizeof(char), 32);
   reader->type = type;
 }
 
@@ -365,6 +366,10 @@ Channel *channel_job_start(char **argv, const char *exepath, CallbackReader on_s
                            varnumber_T *status_out)
 {
   Channel *chan = channel_alloc(kChannelStreamProc);
+  if (!rpc) {
+    // Job output callbacks should not delay RPC requests and other events.
+    multiqueue_set_background(chan->events, true);
+  }
   chan->on_data = on_stdout;
   chan->on_stderr = on_stderr;
   chan->on_exit = on_exit;
@@ -738,10 +743,15 @@ void channel_reader_callbacks(Channel *chan, CallbackReader *reader)
     if (reader->eof) {
       if (reader->self) {
         if (tv_dict_find(reader->self, reader->type, -1) == NULL) {
-          list_T *data = buffer_to_tv_list(reader->buffer.ga_data,
-                                           (size_t)reader->buffer.ga_len);
-          tv_dict_add_list(reader->self, reader->type, strlen(reader->type),
-                           data);
+          typval_T data;
+          reader_take_data(reader, &data);
+          if (data.v_type == VAR_STRING) {
+            tv_dict_add_allocated_str(reader->self, reader->type, strlen(reader->type),
+                                      data.vval.v_string);
+          } else {
+            tv_dict_add_list(reader->self, reader->type, strlen(reader->type),
+                             data.vval.v_list);
+          }
         } else {
           semsg(_(e_streamkey), reader->type, chan->id);
         }
@@ -790,12 +800,10 @@ static void channel_callback_call(Channel *chan, CallbackReader *reader)
   argv[0].vval.v_number = (varnumber_T)chan->id;
 
   if (reader) {
-    argv[1].v_type = VAR_LIST;
-    argv[1].v_lock = VAR_UNLOCKED;
-    argv[1].vval.v_list = buffer_to_tv_list(reader->buffer.ga_data,
-                                            (size_t)reader->buffer.ga_len);
-    tv_list_ref(argv[1].vval.v_list);
-    ga_clear(&reader->buffer);
+    reader_take_data(reader, &argv[1]);
+    if (argv[1].v_type == VAR_LIST) {
+      tv_list_ref(argv[1].vval.v_list);
+    }
     cb = &reader->cb;
     argv[2].vval.v_string = (char *)reader->type;
   } else {
@@ -812,6 +820,31 @@ static void channel_callback_call(Channel *chan, CallbackReader *reader)
   typval_T rettv = TV_INITIAL_VALUE;
   callback_call(cb, 3, argv, &rettv);
   tv_clear(&rettv);
+  if (reader && argv[1].v_type == VAR_STRING) {
+    xfree(argv[1].vval.v_string);
+  }
+}
+
+/// Moves the data collected by "reader" to "tv": as a readfile()-style list,
+/// or in |channel-raw| mode as a String which takes over the read buffer.
+static void reader_take_data(CallbackReader *reader, typval_T *tv)
+{
+  garray_T *ga = &reader->buffer;
+  tv->v_lock = VAR_UNLOCKED;
+  if (reader->raw) {
+    tv->v_type = VAR_STRING;
+    ga_append(ga, NUL);
+    // NUL bytes are represented as NL, like in the list items.
+    memchrsub(ga->ga_data, NUL, NL, (size_t)ga->ga_len - 1);
+    tv->vval.v_string = ga->ga_data;
+    ga->ga_data = NULL;
+    ga->ga_len = 0;
+    ga->ga_maxlen = 0;
+  } else {
+    tv->v_type = VAR_LIST;
+    tv->vval.v_list = buffer_to_tv_list(ga->ga_data, (size_t)ga->ga_len);
+    ga_clear(ga);
+  }
 }
 
 /// Open terminal for channel
@@ -920,7 +953,7 @@ Dict channel_info(uint64_t id, Arena *arena)
     return (Dict)ARRAY_DICT_INIT;
   }
 
-  Dict info = arena_dict(arena, 8);
+  Dict info = arena_dict(arena, 10);
   PUT_C(info, "id", INTEGER_OBJ((Integer)chan->id));
 
   const char *stream_desc, *mode_desc;
@@ -975,6 +1008,11 @@ Dict channel_info(uint64_t id, Arena *arena)
   }
   PUT_C(info, "mode", CSTR_AS_OBJ(mode_desc));
 
+  if (chan->is_rpc && chan->rpc.dropped_notifications > 0) {
+    PUT_C(info, "dropped_notifications", INTEGER_OBJ((Integer)chan->rpc.dropped_notifications));
+    PUT_C(info, "queued_bytes", INTEGER_OBJ((Integer)channel_instream(chan)->curmem));
+  }
+
   return info;
 }
 
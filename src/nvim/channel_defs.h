@@ -49,6 +49,7 @@ typedef struct {
   garray_T buffer;
   bool eof;
   bool buffered;
+  bool raw;  ///< pass the data as one String, see |channel-raw|
   bool fwd_err;
   const char *type;
 } CallbackReader;
@@ -57,5 +58,6 @@ typedef struct {
                                                 .self = NULL, \
                                                 .buffer = GA_EMPTY_INIT_VALUE, \
                                                 .buffered = false, \
+                                                .raw = false, \
                                                 .fwd_err = false, \
                                                 .type = NULL })
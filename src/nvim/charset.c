@@ -26,6 +26,7 @@
 #include "nvim/memory.h"
 #include "nvim/option.h"
 #include "nvim/path.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
@@ -89,6 +90,8 @@ int init_chartab(void)
 int buf_init_chartab(buf_T *buf, bool global)
 {
   if (global) {
+    vcol_cache_invalidate_all();
+
     // Set the default size for printable characters:
     // From <Space> to '~' is 1 (printable), others are 2 (not printable).
     // This also inits all 'isident' and 'isfname' flags to false.
@@ -88,6 +88,17 @@ static bool cmd_showtail;  ///< Only show path tail in lists ?
 static bool may_expand_pattern = false;
 static pos_T pre_incsearch_pos;  ///< Cursor position when incsearch started
 
+/// Matches of the last file or shell command expansion done while typing on
+/// the command line.  Used to narrow down the matches when more characters of
+/// the name are typed, instead of going over the file system again.
+static bool use_expand_cache = false;
+static int expand_cache_context = EXPAND_NOTHING;
+static int expand_cache_options;
+static char *expand_cache_pat = NULL;  ///< pattern without the trailing star
+static char *expand_cache_dir = NULL;  ///< current directory when expanded
+static char **expand_cache_matches = NULL;
+static int expand_cache_count = 0;
+
 /// "compl_match_array" points the currently displayed list of entries in the
 /// popup menu.  It is NULL when there is no popup menu.
 static pumitem_T *compl_match_array = NULL;
@@ -320,8 +331,10 @@ int nextwild(expand_T *xp, int type, int options, bool escape)
                              | WILD_SILENT
                              | (escape ? WILD_ESCAPE : 0)
                              | (p_wic ? WILD_ICASE : 0));
+    use_expand_cache = true;
     p = ExpandOne(xp, tmp, xstrnsave(&ccline->cmdbuff[i], xp->xp_pattern_len),
                   use_options, type);
+    use_expand_cache = false;
     xfree(tmp);
     // Longest match: make sure it is not shorter, happens with :help.
     if (p != NULL && type == WILD_LONGEST) {
@@ -765,7 +778,8 @@ static char *ExpandOne_start(int mode, expand_T *xp, char *str, int options)
   char *ss = NULL;
 
   // Do the expansion.
-  if (ExpandFromContext(xp, str, &xp->xp_files, &xp->xp_numfiles, options) == FAIL) {
+  if (expand_from_cache_or_context(xp, str, &xp->xp_files, &xp->xp_numfiles,
+                                   options) == FAIL) {
 #ifdef FNAME_ILLEGAL
     // Illegal file name has been silently skipped.  But when there
     // are wildcards, the real problem is that there was no match,
@@ -1019,6 +1033,18 @@ void clear_cmdline_orig(void)
   XFREE_CLEAR(cmdline_orig);
 }
 
+/// Forget the matches kept for narrowing down file name completion.
+/// Called when leaving the command line, files may have changed after that.
+void expand_cache_clear(void)
+{
+  FreeWild(expand_cache_count, expand_cache_matches);
+  expand_cache_matches = NULL;
+  expand_cache_count = 0;
+  XFREE_CLEAR(expand_cache_pat);
+  XFREE_CLEAR(expand_cache_dir);
+  expand_cache_context = EXPAND_NOTHING;
+}
+
 /// Display one line of completion matches. Multiple matches are displayed in
 /// each line (used by wildmode=list and CTRL-D)
 ///
@@ -3057,6 +3083,144 @@ static int ExpandFromContext(expand_T *xp, char *pat, char ***matches, int *numM
   return ret;
 }
 
+/// Return true if the matches for "pat" can be kept to narrow down the matches
+/// when more characters are typed: it is a file or shell command name ending
+/// in the star added by addstar(), without other special characters and with
+/// at least one character in the last path component.  With an empty last
+/// component names starting with "." are not found.
+static bool expand_cache_pat_ok(const expand_T *xp, const char *pat, int options)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  if ((xp->xp_context != EXPAND_FILES
+       && xp->xp_context != EXPAND_DIRECTORIES
+       && xp->xp_context != EXPAND_SHELLCMD)
+      || xp->xp_backslash != XP_BS_NONE
+      || (options & WILD_LIST_NOTFOUND)) {
+    return false;
+  }
+
+  size_t len = strlen(pat);
+  if (len < 2 || pat[len - 1] != '*' || *path_tail(pat) == '*') {
+    return false;
+  }
+  for (size_t i = 0; i < len - 1; i++) {
+    if (vim_strchr("*?[]{}~$`\\%#<!", (uint8_t)pat[i]) != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Compare the first "len" bytes of a match with "pat" the way the file
+/// system expansion matches names.
+static bool expand_cache_match(const expand_T *xp, const char *match, const char *pat, size_t len,
+                               int options)
+  FUNC_ATTR_NONNULL_ALL
+{
+  bool ic = p_fic || (xp->xp_context != EXPAND_SHELLCMD && (options & WILD_ICASE));
+  return ic ? mb_strnicmp(match, pat, len) == 0 : strncmp(match, pat, len) == 0;
+}
+
+/// Get the matches for "pat" from the matches of a previous expansion, when
+/// "pat" is the previous pattern with more characters of the last path
+/// component typed.
+///
+/// @return  true when "matches" and "numMatches" were set.
+static bool expand_cache_narrow(const expand_T *xp, const char *pat, int options,
+                                char ***matches, int *numMatches)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (expand_cache_pat == NULL
+      || expand_cache_context != xp->xp_context
+      || expand_cache_options != options) {
+    return false;
+  }
+
+  size_t cachelen = strlen(expand_cache_pat);
+  size_t len = strlen(pat) - 1;  // without the trailing star
+  if (len < cachelen || strncmp(pat, expand_cache_pat, cachelen) != 0) {
+    return false;
+  }
+  for (size_t i = cachelen; i < len; i++) {
+    if (vim_ispathsep(pat[i])) {
+      return false;
+    }
+  }
+
+  char *dir = xmalloc(MAXPATHL);
+  bool same_dir = os_dirname(dir, MAXPATHL) == OK && strcmp(dir, expand_cache_dir) == 0;
+  xfree(dir);
+  if (!same_dir) {
+    return false;
+  }
+
+  garray_T ga;
+  ga_init(&ga, (int)sizeof(char *), 10);
+  for (int i = 0; i < expand_cache_count; i++) {
+    if (expand_cache_match(xp, expand_cache_matches[i], pat, len, options)) {
+      GA_APPEND(char *, &ga, xstrdup(expand_cache_matches[i]));
+    }
+  }
+  *matches = ga.ga_data;
+  *numMatches = ga.ga_len;
+  return true;
+}
+
+/// Keep a copy of the matches for "pat", see expand_cache_narrow().
+static void expand_cache_store(const expand_T *xp, const char *pat, int options, char **matches,
+                               int numMatches)
+  FUNC_ATTR_NONNULL_ALL
+{
+  size_t len = strlen(pat) - 1;  // without the trailing star
+
+  // Only when all matches start with the typed name, otherwise narrowing
+  // them down would drop matches.
+  for (int i = 0; i < numMatches; i++) {
+    if (!expand_cache_match(xp, matches[i], pat, len, options)) {
+      return;
+    }
+  }
+
+  char *dir = xmalloc(MAXPATHL);
+  if (os_dirname(dir, MAXPATHL) != OK) {
+    xfree(dir);
+    return;
+  }
+
+  expand_cache_dir = dir;
+  expand_cache_pat = xmemdupz(pat, len);
+  expand_cache_context = xp->xp_context;
+  expand_cache_options = options;
+  expand_cache_matches = xmalloc(sizeof(char *) * (size_t)numMatches);
+  for (int i = 0; i < numMatches; i++) {
+    expand_cache_matches[i] = xstrdup(matches[i]);
+  }
+  expand_cache_count = numMatches;
+}
+
+/// Like ExpandFromContext(), but when typing a file or shell command name on
+/// the command line narrow down the matches of the previous expansion, if
+/// possible.  Only expands again when the name got shorter or the context or
+/// directory changed.
+static int expand_from_cache_or_context(expand_T *xp, char *pat, char ***matches, int *numMatches,
+                                        int options)
+{
+  if (!use_expand_cache || !expand_cache_pat_ok(xp, pat, options)) {
+    return ExpandFromContext(xp, pat, matches, numMatches, options);
+  }
+
+  if (expand_cache_narrow(xp, pat, options, matches, numMatches)) {
+    return OK;
+  }
+
+  expand_cache_clear();
+  int ret = ExpandFromContext(xp, pat, matches, numMatches, options);
+  if (ret == OK && *numMatches > 0 && !got_int) {
+    expand_cache_store(xp, pat, options, *matches, *numMatches);
+  }
+  return ret;
+}
+
 /// Expand a list of names.
 ///
 /// Generic function for command line completion.  It calls a function to
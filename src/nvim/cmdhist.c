@@ -20,6 +20,7 @@
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/option_vars.h"
@@ -40,6 +41,15 @@ static int hisidx[HIST_COUNT] = { -1, -1, -1, -1, -1 };  ///< lastused entry
 static int hisnum[HIST_COUNT] = { 0, 0, 0, 0, 0 };
 static int hislen = 0;  ///< actual length of history tables
 
+/// Number of entries with each string in the history tables, so that adding a
+/// new string doesn't need to look through the whole history for it.  Kept up
+/// to date by add_to_history(), other changes mark it invalid and it is built
+/// again when needed.
+static Map(cstr_t, int) hist_strings[HIST_COUNT] = {
+  MAP_INIT, MAP_INIT, MAP_INIT, MAP_INIT, MAP_INIT
+};
+static bool hist_strings_valid[HIST_COUNT] = { false, false, false, false, false };
+
 /// Return the length of the history tables
 int get_hislen(void)
 {
@@ -55,6 +65,7 @@ histentry_T *get_histentry(int hist_type)
 void set_histentry(int hist_type, histentry_T *entry)
 {
   history[hist_type] = entry;
+  hist_strings_valid[hist_type] = false;
 }
 
 int *get_hisidx(int hist_type)
@@ -183,10 +194,61 @@ void init_history(void)
     hisidx[type] = l3 - 1;
     xfree(history[type]);
     history[type] = temp;
+    hist_strings_clear(type);
   }
   hislen = newlen;
 }
 
+/// Forget the strings in history "type", see hist_strings[].
+static void hist_strings_clear(int type)
+{
+  const char *key;
+  map_foreach_key(&hist_strings[type], key, {
+    xfree((char *)key);
+  });
+  map_destroy(cstr_t, &hist_strings[type]);
+  hist_strings_valid[type] = false;
+}
+
+/// Add "n" to the number of entries with "str" in history "type".
+static void hist_strings_add(int type, const char *str, int n)
+{
+  if (!hist_strings_valid[type]) {
+    return;
+  }
+  if (n > 0) {
+    bool new_item = false;
+    const char **key = NULL;
+    int *count = map_put_ref(cstr_t, int)(&hist_strings[type], str, &key, &new_item);
+    if (new_item) {
+      *key = xstrdup(str);
+    }
+    *count += n;
+    return;
+  }
+  int *count = map_ref(cstr_t, int)(&hist_strings[type], str, NULL);
+  if (count != NULL && (*count += n) <= 0) {
+    const char *key = NULL;
+    map_del(cstr_t, int)(&hist_strings[type], str, &key);
+    xfree((char *)key);
+  }
+}
+
+/// Return false when history "type" has no entry with "str".
+static bool hist_strings_may_have(int type, const char *str)
+{
+  if (!hist_strings_valid[type]) {
+    hist_strings_clear(type);
+    hist_strings_valid[type] = true;
+    for (int i = 0; i < hislen; i++) {
+      if (history[type][i].hisstr != NULL) {
+        hist_strings_add(type, history[type][i].hisstr, 1);
+      }
+    }
+  }
+  return map_has(cstr_t, &hist_strings[type], str);
+}
+
 static inline void hist_free_entry(histentry_T *hisptr)
   FUNC_ATTR_NONNULL_ALL
 {
@@ -209,7 +271,7 @@ static int in_history(int type, const char *str, int move_to_front, int sep)
 {
   int last_i = -1;
 
-  if (hisidx[type] < 0) {
+  if (hisidx[type] < 0 || !hist_strings_may_have(type, str)) {
     return false;
   }
   int i = hisidx[type];
@@ -318,6 +380,9 @@ void add_to_history(int histype, const char *new_entry, size_t new_entrylen, boo
     if (maptick == last_maptick && hisidx[HIST_SEARCH] >= 0) {
       // Current line is from the same mapping, remove it
       hisptr = &history[HIST_SEARCH][hisidx[HIST_SEARCH]];
+      if (hisptr->hisstr != NULL) {
+        hist_strings_add(HIST_SEARCH, hisptr->hisstr, -1);
+      }
       hist_free_entry(hisptr);
       hisnum[histype]--;
       if (--hisidx[HIST_SEARCH] < 0) {
@@ -335,10 +400,14 @@ void add_to_history(int histype, const char *new_entry, size_t new_entrylen, boo
     hisidx[histype] = 0;
   }
   hisptr = &history[histype][hisidx[histype]];
+  if (hisptr->hisstr != NULL) {
+    hist_strings_add(histype, hisptr->hisstr, -1);
+  }
   hist_free_entry(hisptr);
 
   // Store the separator after the NUL of the string.
   hisptr->hisstr = xstrnsave(new_entry, new_entrylen + 2);
+  hist_strings_add(histype, hisptr->hisstr, 1);
   hisptr->timestamp = os_time();
   hisptr->additional_data = NULL;
   hisptr->hisstr[new_entrylen + 1] = (char)sep;
@@ -419,6 +488,7 @@ int clr_history(const int histype)
     }
     hisidx[histype] = -1;  // mark history as cleared
     hisnum[histype] = 0;   // reset identifier counter
+    hist_strings_clear(histype);
     return OK;
   }
   return FAIL;
@@ -471,6 +541,9 @@ static int del_history_entry(int histype, char *str)
   if (history[histype][idx].hisstr == NULL) {
     hisidx[histype] = -1;
   }
+  if (found) {
+    hist_strings_valid[histype] = false;
+  }
 
   vim_regfree(regmatch.regprog);
   return found;
@@ -486,6 +559,7 @@ static int del_history_idx(int histype, int idx)
     return false;
   }
   idx = hisidx[histype];
+  hist_strings_add(histype, history[histype][i].hisstr, -1);
   hist_free_entry(&history[histype][i]);
 
   // When deleting the last added search string in a mapping, reset
@@ -734,6 +808,7 @@ const void *hist_iter(const void *const iter, const uint8_t history_type, const
   *hist = *hiter;
   if (zero) {
     CLEAR_POINTER(hiter);
+    hist_strings_valid[history_type] = false;
   }
   if (hiter == hlast) {
     return NULL;
@@ -756,6 +831,7 @@ histentry_T *hist_get_array(const uint8_t history_type, int **const new_hisidx,
   FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ALL
 {
   init_history();
+  hist_strings_valid[history_type] = false;
   *new_hisidx = &(hisidx[history_type]);
   *new_hisnum = &(hisnum[history_type]);
   return history[history_type];
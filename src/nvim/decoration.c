@@ -25,6 +25,7 @@
 #include "nvim/memory_defs.h"
 #include "nvim/move.h"
 #include "nvim/option_vars.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/sign.h"
 
@@ -99,6 +100,9 @@ void decor_redraw(buf_T *buf, int row1, int row2, int col1, DecorInline decor)
       bool below = (vt->flags & kVTIsLines) && !(vt->flags & kVTLinesAbove);
       linenr_T vt_lnum = row1 + 1 + below;
       redraw_buf_line_later(buf, vt_lnum, true);
+      if (vt->pos == kVPosInline) {
+        inline_virt_cache_invalidate_all();
+      }
       if (vt->flags & kVTIsLines || vt->pos == kVPosInline) {
         // changed_lines_redraw_buf(buf, vt_lnum, vt_lnum + 1, 0);
         colnr_T vt_col = vt->flags & kVTIsLines ? 0 : col1;
@@ -373,6 +377,19 @@ void decor_check_invalid_glyphs(void)
   }
 }
 
+/// Translate the sign and conceal text of all decorations while compacting the
+/// glyph cache.
+void decor_remap_glyphs(void)
+{
+  for (size_t i = 0; i < kv_size(decor_items); i++) {
+    DecorSignHighlight *it = &kv_A(decor_items, i);
+    int width = (it->flags & kSHIsSign) ? SIGN_WIDTH : ((it->flags & kSHConceal) ? 1 : 0);
+    for (int j = 0; j < width; j++) {
+      it->text[j] = schar_cache_remap(it->text[j]);
+    }
+  }
+}
+
 /// Get the next chunk of a virtual text item.
 ///
 /// @param[in]     vt    The virtual text item
@@ -528,6 +545,7 @@ bool decor_redraw_line(win_T *wp, int row, DecorState *state)
 
   state->row = row;
   state->col_until = -1;
+  state->end_until = -1;
   state->eol_col = -1;
 
   if (state->current_end != 0 || state->future_begin != (int)kv_size(state->ranges_i)) {
@@ -721,6 +739,12 @@ next_mark:
   int cur_end = state->current_end;
   int fut_beg = state->future_begin;
 
+  // When no active range ends here and the promoted ranges all sort after the
+  // active ones, the combined state of the active ranges is still valid and
+  // only the promoted ranges need to be added on top of it.
+  bool incremental = state->end_until >= col && state->conceal != 2;
+  int const old_cur_end = cur_end;
+
   // Promote future ranges before the cursor to active.
   for (; fut_beg < count; fut_beg++) {
     int const index = indices[fut_beg];
@@ -744,6 +768,9 @@ next_mark:
       }
     }
 
+    if (begin != cur_end) {
+      incremental = false;
+    }
     int *const item = indices + begin;
     memmove(item + 1, item, (size_t)(cur_end - begin) * sizeof(*item));
     *item = index;
@@ -757,15 +784,17 @@ next_mark:
     }
   }
 
-  int new_cur_end = 0;
+  int first = incremental ? old_cur_end : 0;
+  int new_cur_end = first;
 
-  int attr = 0;
-  int conceal = 0;
+  int attr = incremental ? state->current : 0;
+  int conceal = incremental ? state->conceal : 0;
   schar_T conceal_char = 0;
   int conceal_attr = 0;
-  TriState spell = kNone;
+  TriState spell = incremental ? state->spell : kNone;
+  int end_until = incremental ? state->end_until : MAXCOL;
 
-  for (int i = 0; i < cur_end; i++) {
+  for (int i = first; i < cur_end; i++) {
     int const index = indices[i];
     DecorRangeSlot *const slot = slots + index;
     DecorRange *const r = &slot->range;
@@ -777,7 +806,7 @@ next_mark:
       keep = true;
 
       if (r->end_row == row && r->end_col > col) {
-        col_until = MIN(col_until, r->end_col - 1);
+        end_until = MIN(end_until, r->end_col - 1);
       }
 
       if (r->attr_id > 0) {
@@ -838,7 +867,8 @@ next_mark:
   kv_size(state->ranges_i) = (size_t)count;
   state->future_begin = fut_beg;
   state->current_end = cur_end;
-  state->col_until = col_until;
+  state->col_until = MIN(col_until, end_until);
+  state->end_until = end_until;
 
   state->current = attr;
   state->conceal = conceal;
@@ -1027,8 +1057,15 @@ void buf_signcols_count_range(buf_T *buf, int row1, int row2, int add, TriState
     return;
   }
 
-  // Allocate an array of integers holding the number of signs in the range.
-  int *count = xcalloc((size_t)(row2 + 1 - row1), sizeof(int));
+  // Array of integers holding the number of signs in the range. A sign is first
+  // counted as +1 at its first and -1 after its last row in the range, so that
+  // long signs don't need to touch every row they span. The extra element
+  // takes the -1 of signs ending at "row2".
+  enum { SIGN_COUNT_STACK = 64, };
+  int count_stack[SIGN_COUNT_STACK + 1];
+  size_t nrows = (size_t)(row2 + 1 - row1);
+  int *count = nrows <= SIGN_COUNT_STACK ? count_stack : xmalloc((nrows + 1) * sizeof(int));
+  memset(count, 0, (nrows + 1) * sizeof(int));
   MarkTreeIter itr[1];
   MTPair pair = { 0 };
 
@@ -1036,9 +1073,8 @@ void buf_signcols_count_range(buf_T *buf, int row1, int row2, int add, TriState
   marktree_itr_get_overlap(buf->b_marktree, row1, 0, itr);
   while (marktree_itr_step_overlap(buf->b_marktree, itr, &pair)) {
     if ((pair.start.flags & MT_FLAG_DECOR_SIGNTEXT) && !mt_invalid(pair.start)) {
-      for (int i = row1; i <= MIN(row2, pair.end_pos.row); i++) {
-        count[i - row1]++;
-      }
+      count[0]++;
+      count[MIN(row2, pair.end_pos.row) + 1 - row1]--;
     }
   }
 
@@ -1053,14 +1089,17 @@ void buf_signcols_count_range(buf_T *buf, int row1, int row2, int add, TriState
     if ((mark.flags & MT_FLAG_DECOR_SIGNTEXT) && !mt_invalid(mark) && !mt_end(mark)) {
       // Increment count array for the range of a paired sign mark.
       MTPos end = marktree_get_altpos(buf->b_marktree, mark, NULL);
-      for (int i = mark.pos.row; i <= MIN(row2, end.row); i++) {
-        count[i - row1]++;
-      }
+      count[mark.pos.row - row1]++;
+      count[MIN(row2, end.row) + 1 - row1]--;
     }
 
     marktree_itr_next_filter(buf->b_marktree, itr, row2 + 1, 0, signtext_filter);
   }
 
+  for (size_t i = 1; i < nrows; i++) {
+    count[i] += count[i - 1];
+  }
+
   // For each row increment "b_signcols.count" at the number of counted signs,
   // and decrement at the previous number of signs. These two operations are
   // split in separate calls if "clear" is not kFalse (surrounding a marktree splice).
@@ -1082,7 +1121,9 @@ void buf_signcols_count_range(buf_T *buf, int row1, int row2, int add, TriState
     }
   }
 
-  xfree(count);
+  if (count != count_stack) {
+    xfree(count);
+  }
 }
 
 void decor_redraw_end(DecorState *state)
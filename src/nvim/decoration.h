@@ -86,6 +86,8 @@ typedef struct {
   int top_row;
   int row;
   int col_until;
+  /// Last column before one of the active ranges ends on this row, -1 if unknown.
+  int end_until;
   int current;
   int eol_col;
 
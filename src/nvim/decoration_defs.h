@@ -4,6 +4,7 @@
 
 #include "klib/kvec.h"
 #include "nvim/api/private/defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/types_defs.h"
 
 #define DECOR_ID_INVALID UINT32_MAX
@@ -135,6 +136,15 @@ typedef struct {
 // initializes in a valid state for the DecorHighlightInline branch
 #define DECOR_INLINE_INIT { .ext = false, .data.hl = DECOR_HIGHLIGHT_INLINE_INIT }
 
+/// Ephemeral highlight set by a caching provider in "on_line", see DecorProvider.cache_lines
+typedef struct {
+  int start_row, start_col, end_row, end_col;
+  DecorSignHighlight sh;  ///< "url" is owned by the cache
+  uint32_t ns, mark_id;
+} DecorCachedHl;
+
+typedef kvec_t(DecorCachedHl) DecorCachedLine;
+
 typedef struct {
   NS ns_id;
 
@@ -156,5 +166,13 @@ typedef struct {
   int hl_valid;
   bool hl_cached;
 
+  /// Reuse the ephemeral highlights set by "on_line" for a row, until the
+  /// window shows another buffer or the buffer changes.
+  bool cache_lines;
+  handle_T cache_win;
+  handle_T cache_buf;
+  int64_t cache_tick;
+  PMap(int) line_cache[1];  ///< row -> DecorCachedLine *
+
   uint8_t error_count;
 } DecorProvider;
@@ -7,17 +7,22 @@
 #include "nvim/api/extmark.h"
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/decoration.h"
 #include "nvim/decoration_defs.h"
 #include "nvim/decoration_provider.h"
 #include "nvim/globals.h"
+#include "nvim/grid.h"
 #include "nvim/highlight.h"
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
+#include "nvim/macros_defs.h"
+#include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/move.h"
 #include "nvim/pos_defs.h"
+#include "nvim/profile.h"
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "decoration_provider.c.generated.h"
@@ -26,9 +31,20 @@
 static kvec_t(DecorProvider) decor_providers = KV_INITIAL_VALUE;
 
 #define DECORATION_PROVIDER_INIT(ns_id) (DecorProvider) \
-  { ns_id, kDecorProviderDisabled, LUA_NOREF, LUA_NOREF, \
-    LUA_NOREF, LUA_NOREF, LUA_NOREF, \
-    LUA_NOREF, LUA_NOREF, -1, false, false, 0 }
+  { .ns_id = ns_id, .state = kDecorProviderDisabled, \
+    .redraw_start = LUA_NOREF, .redraw_buf = LUA_NOREF, \
+    .redraw_win = LUA_NOREF, .redraw_line = LUA_NOREF, .redraw_end = LUA_NOREF, \
+    .hl_def = LUA_NOREF, .spell_nav = LUA_NOREF, .conceal_line = LUA_NOREF, \
+    .hl_valid = 0, .hl_cached = false, .cache_lines = false, .line_cache = { MAP_INIT }, \
+    .error_count = 0 }
+
+/// Line being recorded for a provider with "cache_lines", NULL if the
+/// ephemeral marks set now are not cached.
+static DecorCachedLine *decor_recording = NULL;
+static bool decor_recording_ok = false;
+/// Set when an ephemeral mark was added to the window being drawn which is
+/// not part of any line cache, e.g. from "on_win".
+static bool decor_uncached_marks = false;
 
 static void decor_provider_error(DecorProvider *provider, const char *name, const char *msg)
 {
@@ -39,18 +55,22 @@ static void decor_provider_error(DecorProvider *provider, const char *name, cons
 
 // Note we pass in a provider index as this function may cause decor_providers providers to be
 // reallocated so we need to be careful with DecorProvider pointers
-static bool decor_provider_invoke(int provider_idx, const char *name, LuaRef ref, Array args,
-                                  bool default_true)
+static bool decor_provider_invoke(int provider_idx, const char *name, LuaRef ref,
+                                  const Integer *args, size_t nargs, bool default_true)
 {
   Error err = ERROR_INIT;
 
+  const uint64_t trace_tm = trace_begin();
   textlock++;
-  Object ret = nlua_call_ref(ref, name, args, kRetNilBool, NULL, &err);
+  Object ret = nlua_call_ref_int(ref, name, args, nargs, kRetNilBool, &err);
   textlock--;
 
   // We get the provider here via an index in case the above call to nlua_call_ref causes
   // decor_providers to be reallocated.
   DecorProvider *provider = &kv_A(decor_providers, provider_idx);
+  if (trace_tm != 0) {
+    trace_end("decor", describe_ns(provider->ns_id, "(UNKNOWN PLUGIN)"), name, trace_tm);
+  }
   if (!ERROR_SET(&err)
       && api_object_to_bool(ret, "provider %s retval", default_true, &err)) {
     provider->error_count = 0;
@@ -76,18 +96,25 @@ void decor_providers_invoke_spell(win_T *wp, int start_row, int start_col, int e
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state != kDecorProviderDisabled && p->spell_nav != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 6);
-      ADD_C(args, INTEGER_OBJ(wp->handle));
-      ADD_C(args, INTEGER_OBJ(wp->w_buffer->handle));
-      ADD_C(args, INTEGER_OBJ(start_row));
-      ADD_C(args, INTEGER_OBJ(start_col));
-      ADD_C(args, INTEGER_OBJ(end_row));
-      ADD_C(args, INTEGER_OBJ(end_col));
-      decor_provider_invoke((int)i, "spell", p->spell_nav, args, true);
+      Integer args[] = { wp->handle, wp->w_buffer->handle, start_row, start_col, end_row,
+                         end_col };
+      decor_provider_invoke((int)i, "spell", p->spell_nav, args, ARRAY_SIZE(args), true);
     }
   }
 }
 
+/// @return  whether a provider has an "on_spell_nav" callback.
+bool decor_providers_have_spell_nav(void)
+{
+  for (size_t i = 0; i < kv_size(decor_providers); i++) {
+    DecorProvider *p = &kv_A(decor_providers, i);
+    if (p->state != kDecorProviderDisabled && p->spell_nav != LUA_NOREF) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /// @return whether a provider placed any marks in the callback.
 bool decor_providers_invoke_conceal_line(win_T *wp, int row)
 {
@@ -95,11 +122,9 @@ bool decor_providers_invoke_conceal_line(win_T *wp, int row)
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state != kDecorProviderDisabled && p->conceal_line != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 4);
-      ADD_C(args, INTEGER_OBJ(wp->handle));
-      ADD_C(args, INTEGER_OBJ(wp->w_buffer->handle));
-      ADD_C(args, INTEGER_OBJ(row));
-      decor_provider_invoke((int)i, "conceal_line", p->conceal_line, args, true);
+      Integer args[] = { wp->handle, wp->w_buffer->handle, row };
+      decor_provider_invoke((int)i, "conceal_line", p->conceal_line, args, ARRAY_SIZE(args),
+                            true);
     }
   }
   return wp->w_buffer->b_marktree->n_keys > keys;
@@ -114,9 +139,9 @@ void decor_providers_start(void)
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state != kDecorProviderDisabled && p->redraw_start != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 2);
-      ADD_C(args, INTEGER_OBJ((int)display_tick));
-      bool active = decor_provider_invoke((int)i, "start", p->redraw_start, args, true);
+      Integer args[] = { (int)display_tick };
+      bool active = decor_provider_invoke((int)i, "start", p->redraw_start, args,
+                                          ARRAY_SIZE(args), true);
       kv_A(decor_providers, i).state = active ? kDecorProviderActive : kDecorProviderRedrawDisabled;
     } else if (p->state != kDecorProviderDisabled) {
       kv_A(decor_providers, i).state = kDecorProviderActive;
@@ -142,6 +167,7 @@ void decor_providers_invoke_win(win_T *wp)
     validate_botline(wp);
   }
   linenr_T botline = MIN(wp->w_botline, wp->w_buffer->b_ml.ml_line_count);
+  decor_uncached_marks = false;
 
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
@@ -150,13 +176,14 @@ void decor_providers_invoke_win(win_T *wp)
     }
 
     if (p->state == kDecorProviderActive && p->redraw_win != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 4);
-      ADD_C(args, WINDOW_OBJ(wp->handle));
-      ADD_C(args, BUFFER_OBJ(wp->w_buffer->handle));
-      // TODO(bfredl): we are not using this, but should be first drawn line?
-      ADD_C(args, INTEGER_OBJ(wp->w_topline - 1));
-      ADD_C(args, INTEGER_OBJ(botline - 1));
-      if (!decor_provider_invoke((int)i, "win", p->redraw_win, args, true)) {
+      Integer args[] = {
+        wp->handle,
+        wp->w_buffer->handle,
+        // TODO(bfredl): we are not using this, but should be first drawn line?
+        wp->w_topline - 1,
+        botline - 1,
+      };
+      if (!decor_provider_invoke((int)i, "win", p->redraw_win, args, ARRAY_SIZE(args), true)) {
         kv_A(decor_providers, i).state = kDecorProviderWinDisabled;
       }
     }
@@ -172,25 +199,151 @@ void decor_providers_invoke_win(win_T *wp)
 /// @param[out] err       Provider error
 void decor_providers_invoke_line(win_T *wp, int row)
 {
+  buf_T *buf = wp->w_buffer;
   decor_state.running_decor_provider = true;
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state == kDecorProviderActive && p->redraw_line != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 3);
-      ADD_C(args, WINDOW_OBJ(wp->handle));
-      ADD_C(args, BUFFER_OBJ(wp->w_buffer->handle));
-      ADD_C(args, INTEGER_OBJ(row));
-      if (!decor_provider_invoke((int)i, "line", p->redraw_line, args, true)) {
+      DecorCachedLine *line = NULL;
+      if (p->cache_lines) {
+        if (p->cache_win != wp->handle || p->cache_buf != buf->handle
+            || p->cache_tick != buf_get_changedtick(buf)) {
+          decor_provider_clear_cache(p);
+          p->cache_win = wp->handle;
+          p->cache_buf = buf->handle;
+          p->cache_tick = buf_get_changedtick(buf);
+        }
+        line = pmap_get(int)(p->line_cache, row);
+        if (line) {
+          decor_provider_replay_line(line);
+          continue;
+        }
+        line = xcalloc(1, sizeof(*line));
+        decor_recording = line;
+        decor_recording_ok = true;
+      }
+
+      size_t keys = buf->b_marktree->n_keys;
+      Integer args[] = { wp->handle, buf->handle, row };
+      bool ok = decor_provider_invoke((int)i, "line", p->redraw_line, args, ARRAY_SIZE(args),
+                                      true);
+      if (!ok) {
         // return 'false' or error: skip rest of this window
         kv_A(decor_providers, i).state = kDecorProviderWinDisabled;
       }
 
+      if (line) {
+        decor_recording = NULL;
+        // only cache rows where the callback did nothing but set ephemeral highlights
+        if (ok && decor_recording_ok && buf->b_marktree->n_keys == keys) {
+          pmap_put(int)(kv_A(decor_providers, i).line_cache, row, line);
+        } else {
+          decor_cached_line_free(line);
+        }
+      }
+
       hl_check_ns();
     }
   }
   decor_state.running_decor_provider = false;
 }
 
+/// Called for each ephemeral mark set with |nvim_buf_set_extmark()| while
+/// drawing.
+///
+/// @param sh  highlight of the mark, or NULL if the mark has decorations
+///            which cannot be cached, like virtual text.
+void decor_provider_record_ephemeral(int start_row, int start_col, int end_row, int end_col,
+                                     const DecorSignHighlight *sh, uint32_t ns, uint32_t mark_id)
+{
+  if (!decor_recording) {
+    decor_uncached_marks = true;
+    return;
+  }
+  if (!sh) {
+    decor_recording_ok = false;
+    return;
+  }
+  DecorCachedHl *hl = kv_pushp(*decor_recording);
+  *hl = (DecorCachedHl){ .start_row = start_row, .start_col = start_col,
+                         .end_row = end_row, .end_col = end_col,
+                         .sh = *sh, .ns = ns, .mark_id = mark_id };
+  hl->sh.url = sh->url ? xstrdup(sh->url) : NULL;
+}
+
+/// Whether the decorations providers add to "row" of "wp" are already known,
+/// i.e. every active provider has "cache_lines" and has cached the row.
+bool decor_providers_row_cached(win_T *wp, int row)
+{
+  if (decor_uncached_marks) {
+    return false;
+  }
+  buf_T *buf = wp->w_buffer;
+  for (size_t i = 0; i < kv_size(decor_providers); i++) {
+    DecorProvider *p = &kv_A(decor_providers, i);
+    if (p->state == kDecorProviderDisabled) {
+      continue;
+    }
+    if (p->state != kDecorProviderActive || !p->cache_lines) {
+      return false;
+    }
+    if (p->redraw_line != LUA_NOREF
+        && (p->cache_win != wp->handle || p->cache_buf != buf->handle
+            || p->cache_tick != buf_get_changedtick(buf)
+            || !map_has(int, p->line_cache, row))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void decor_provider_replay_line(DecorCachedLine *line)
+{
+  for (size_t i = 0; i < kv_size(*line); i++) {
+    DecorCachedHl *hl = &kv_A(*line, i);
+    DecorSignHighlight sh = hl->sh;
+    // the range owns its url, which is freed once it has been drawn
+    sh.url = sh.url ? xstrdup(sh.url) : NULL;
+    decor_range_add_sh(&decor_state, hl->start_row, hl->start_col, hl->end_row, hl->end_col,
+                       &sh, true, hl->ns, hl->mark_id);
+  }
+}
+
+static void decor_cached_line_free(DecorCachedLine *line)
+{
+  for (size_t i = 0; i < kv_size(*line); i++) {
+    xfree((char *)kv_A(*line, i).sh.url);
+  }
+  kv_destroy(*line);
+  xfree(line);
+}
+
+/// Translate the glyphs of the cached lines while compacting the glyph cache.
+void decor_providers_remap_glyphs(void)
+{
+  for (size_t i = 0; i < kv_size(decor_providers); i++) {
+    DecorCachedLine *line;
+    map_foreach_value(kv_A(decor_providers, i).line_cache, line, {
+      for (size_t j = 0; j < kv_size(*line); j++) {
+        DecorSignHighlight *sh = &kv_A(*line, j).sh;
+        int width = (sh->flags & kSHIsSign) ? SIGN_WIDTH : ((sh->flags & kSHConceal) ? 1 : 0);
+        for (int k = 0; k < width; k++) {
+          sh->text[k] = schar_cache_remap(sh->text[k]);
+        }
+      }
+    });
+  }
+}
+
+static void decor_provider_clear_cache(DecorProvider *p)
+{
+  DecorCachedLine *line;
+  map_foreach_value(p->line_cache, line, {
+    decor_cached_line_free(line);
+  });
+  map_destroy(int, p->line_cache);
+}
+
 /// For each provider invoke the 'buf' callback for a given buffer.
 ///
 /// @param      buf       Buffer
@@ -201,10 +354,8 @@ void decor_providers_invoke_buf(buf_T *buf)
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state == kDecorProviderActive && p->redraw_buf != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 2);
-      ADD_C(args, BUFFER_OBJ(buf->handle));
-      ADD_C(args, INTEGER_OBJ((int64_t)display_tick));
-      decor_provider_invoke((int)i, "buf", p->redraw_buf, args, true);
+      Integer args[] = { buf->handle, (int64_t)display_tick };
+      decor_provider_invoke((int)i, "buf", p->redraw_buf, args, ARRAY_SIZE(args), true);
     }
   }
 }
@@ -219,9 +370,8 @@ void decor_providers_invoke_end(void)
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
     if (p->state != kDecorProviderDisabled && p->redraw_end != LUA_NOREF) {
-      MAXSIZE_TEMP_ARRAY(args, 1);
-      ADD_C(args, INTEGER_OBJ((int)display_tick));
-      decor_provider_invoke((int)i, "end", p->redraw_end, args, true);
+      Integer args[] = { (int)display_tick };
+      decor_provider_invoke((int)i, "end", p->redraw_end, args, ARRAY_SIZE(args), true);
     }
   }
   decor_check_to_be_deleted();
@@ -277,6 +427,8 @@ void decor_provider_clear(DecorProvider *p)
   NLUA_CLEAR_REF(p->redraw_end);
   NLUA_CLEAR_REF(p->spell_nav);
   NLUA_CLEAR_REF(p->conceal_line);
+  decor_provider_clear_cache(p);
+  p->cache_lines = false;
   p->state = kDecorProviderDisabled;
 }
 
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "auto/config.h"
 #include "nvim/ascii_defs.h"
@@ -51,6 +52,7 @@
 #include "nvim/message.h"
 #include "nvim/move.h"
 #include "nvim/normal.h"
+#include "nvim/ops.h"
 #include "nvim/option.h"
 #include "nvim/option_defs.h"
 #include "nvim/option_vars.h"
@@ -112,8 +114,20 @@ enum { MAX_DIFF_ANCHORS = 20, };
 typedef struct {
   char *din_fname;   // used for external diff
   mmfile_t din_mmfile;  // used for internal diff
+  bool din_cached;      // din_mmfile is owned by diff_cache[]
 } diffin_T;
 
+// text of a whole buffer as written for the internal diff, kept to diff it
+// again while the buffer does not change
+typedef struct {
+  handle_T dc_handle;     // buffer handle, zero when not used
+  varnumber_T dc_tick;    // b:changedtick of the buffer when written
+  bool dc_icase;          // text was fold-cased
+  mmfile_t dc_mmfile;
+} diffcache_T;
+
+static diffcache_T diff_cache[DB_COUNT];
+
 // used for diff result
 typedef struct {
   char *dout_fname;  // used for external diff
@@ -136,6 +150,13 @@ typedef struct {
   int dio_internal;  // using internal diff
 } diffio_T;
 
+// diff of one pair of buffers, done in a thread
+typedef struct {
+  diffio_T dj_dio;       // shares dio_orig with the other jobs
+  int dj_idx;            // index of the new buffer
+  int dj_ret;            // OK or FAIL
+} diffjob_T;
+
 typedef enum {
   DIFF_ED,
   DIFF_UNIFIED,
@@ -160,12 +181,15 @@ static void clear_diffblock(diff_T *dp)
 /// @param buf
 void diff_buf_delete(buf_T *buf)
 {
+  diff_cache_free(buf->handle);
+
   FOR_ALL_TABS(tp) {
     int i = diff_buf_idx(buf, tp);
 
     if (i != DB_COUNT) {
       tp->tp_diffbuf[i] = NULL;
       tp->tp_diff_invalid = true;
+      tp->tp_diff_partial = false;
 
       if (tp == curtab) {
         // don't redraw right away, more might change or buffer state
@@ -198,6 +222,8 @@ void diff_buf_adjust(win_T *win)
       if (i != DB_COUNT) {
         curtab->tp_diffbuf[i] = NULL;
         curtab->tp_diff_invalid = true;
+        curtab->tp_diff_partial = false;
+        diff_cache_free(win->w_buffer->handle);
         diff_redraw(true);
       }
     }
@@ -226,6 +252,7 @@ void diff_buf_add(buf_T *buf)
     if (curtab->tp_diffbuf[i] == NULL) {
       curtab->tp_diffbuf[i] = buf;
       curtab->tp_diff_invalid = true;
+      curtab->tp_diff_partial = false;
       diff_redraw(true);
       return;
     }
@@ -239,8 +266,10 @@ static void diff_buf_clear(void)
 {
   for (int i = 0; i < DB_COUNT; i++) {
     if (curtab->tp_diffbuf[i] != NULL) {
+      diff_cache_free(curtab->tp_diffbuf[i]->handle);
       curtab->tp_diffbuf[i] = NULL;
       curtab->tp_diff_invalid = true;
+      curtab->tp_diff_partial = false;
       diff_redraw(true);
     }
   }
@@ -273,6 +302,7 @@ void diff_invalidate(buf_T *buf)
     int i = diff_buf_idx(buf, tp);
     if (i != DB_COUNT) {
       tp->tp_diff_invalid = true;
+      tp->tp_diff_partial = false;
       if (tp == curtab) {
         diff_redraw(true);
       }
@@ -748,7 +778,10 @@ void diff_redraw(bool dofold)
 
 static void clear_diffin(diffin_T *din)
 {
-  if (din->din_fname == NULL) {
+  if (din->din_cached) {
+    din->din_mmfile = (mmfile_t){ 0 };
+    din->din_cached = false;
+  } else if (din->din_fname == NULL) {
     XFREE_CLEAR(din->din_mmfile.ptr);
   } else {
     os_remove(din->din_fname);
@@ -768,9 +801,10 @@ static void clear_diffout(diffout_T *dout)
 ///
 /// @param buf
 /// @param din
+/// @param icase  fold-case the text
 ///
 /// @return FAIL for failure.
-static int diff_write_buffer(buf_T *buf, mmfile_t *m, linenr_T start, linenr_T end)
+static int diff_write_buffer(buf_T *buf, mmfile_t *m, linenr_T start, linenr_T end, bool icase)
 {
   if (end < 0) {
     end = buf->b_ml.ml_line_count;
@@ -782,62 +816,134 @@ static int diff_write_buffer(buf_T *buf, mmfile_t *m, linenr_T start, linenr_T e
     return OK;
   }
 
+  enum { SPAN_LINES = 64, };
+  char *lines[SPAN_LINES];
+  colnr_T lens[SPAN_LINES];
   size_t len = 0;
 
   // xdiff requires one big block of memory with all the text.
-  for (linenr_T lnum = start; lnum <= end; lnum++) {
-    len += (size_t)ml_get_buf_len(buf, lnum) + 1;
+  for (linenr_T lnum = start; lnum <= end;) {
+    int count = ml_get_buf_span(buf, lnum, MIN(end - lnum + 1, SPAN_LINES), lines, lens);
+    for (int i = 0; i < count; i++) {
+      len += (size_t)lens[i] + 1;
+    }
+    lnum += count;
   }
   char *ptr = xmalloc(len);
   m->ptr = ptr;
   m->size = (int)len;
 
   len = 0;
+  if (!icase) {
+    // Copy the text directly from the data blocks.
+    for (linenr_T lnum = start; lnum <= end;) {
+      int count = ml_get_buf_span(buf, lnum, MIN(end - lnum + 1, SPAN_LINES), lines, lens);
+      for (int i = 0; i < count; i++) {
+        memmove(ptr + len, lines[i], (size_t)lens[i]);
+        // NUL is represented as NL; convert
+        memchrsub(ptr + len, NL, NUL, (size_t)lens[i]);
+        len += (size_t)lens[i];
+        ptr[len++] = NL;
+      }
+      lnum += count;
+    }
+    return OK;
+  }
+
   for (linenr_T lnum = start; lnum <= end; lnum++) {
     char *s = ml_get_buf(buf, lnum);
-    if (diff_flags & DIFF_ICASE) {
-      while (*s != NUL) {
-        int c;
-        int c_len = 1;
-        char cbuf[MB_MAXBYTES + 1];
+    while (*s != NUL) {
+      int c;
+      int c_len = 1;
+      char cbuf[MB_MAXBYTES + 1];
 
-        if (*s == NL) {
-          c = NUL;
-        } else {
-          // xdiff doesn't support ignoring case, fold-case the text.
-          c = utf_ptr2char(s);
-          c_len = utf_char2len(c);
-          c = utf_fold(c);
-        }
-        const int orig_len = utfc_ptr2len(s);
+      if (*s == NL) {
+        c = NUL;
+      } else {
+        // xdiff doesn't support ignoring case, fold-case the text.
+        c = utf_ptr2char(s);
+        c_len = utf_char2len(c);
+        c = utf_fold(c);
+      }
+      const int orig_len = utfc_ptr2len(s);
 
-        if (utf_char2bytes(c, cbuf) != c_len) {
-          // TODO(Bram): handle byte length difference
-          // One example is Å (3 bytes) and å (2 bytes).
-          memmove(ptr + len, s, (size_t)orig_len);
-        } else {
-          memmove(ptr + len, cbuf, (size_t)c_len);
-          if (orig_len > c_len) {
-            // Copy remaining composing characters
-            memmove(ptr + len + c_len, s + c_len, (size_t)(orig_len - c_len));
-          }
+      if (utf_char2bytes(c, cbuf) != c_len) {
+        // TODO(Bram): handle byte length difference
+        // One example is Å (3 bytes) and å (2 bytes).
+        memmove(ptr + len, s, (size_t)orig_len);
+      } else {
+        memmove(ptr + len, cbuf, (size_t)c_len);
+        if (orig_len > c_len) {
+          // Copy remaining composing characters
+          memmove(ptr + len + c_len, s + c_len, (size_t)(orig_len - c_len));
         }
-
-        s += orig_len;
-        len += (size_t)orig_len;
       }
-    } else {
-      size_t slen = strlen(s);
-      memmove(ptr + len, s, slen);
-      // NUL is represented as NL; convert
-      memchrsub(ptr + len, NL, NUL, slen);
-      len += slen;
+
+      s += orig_len;
+      len += (size_t)orig_len;
     }
     ptr[len++] = NL;
   }
   return OK;
 }
 
+/// Write all of buffer "buf" to a memory buffer, reusing the text written for
+/// the previous diff when the buffer was not changed since then.  Usually only
+/// one of the diffed buffers is being edited.
+///
+/// @return FAIL for failure.
+static int diff_write_cached(buf_T *buf, diffin_T *din, bool icase)
+{
+  diffcache_T *dc = NULL;
+  for (int i = 0; i < DB_COUNT && dc == NULL; i++) {
+    if (diff_cache[i].dc_handle == buf->handle) {
+      dc = &diff_cache[i];
+    }
+  }
+  if (dc == NULL) {
+    // Use an entry for a buffer that is not diffed in the current tab page,
+    // the text of the others may be in use.
+    for (int i = 0; i < DB_COUNT && dc == NULL; i++) {
+      buf_T *cbuf = buflist_findnr(diff_cache[i].dc_handle);
+      if (cbuf == NULL || diff_buf_idx(cbuf, curtab) == DB_COUNT) {
+        dc = &diff_cache[i];
+      }
+    }
+    if (dc == NULL) {
+      return diff_write_buffer(buf, &din->din_mmfile, 1, -1, icase);
+    }
+    diff_cache_free(dc->dc_handle);
+  } else if (dc->dc_tick != buf_get_changedtick(buf) || dc->dc_icase != icase) {
+    diff_cache_free(dc->dc_handle);
+  }
+
+  if (dc->dc_handle == 0) {
+    if (diff_write_buffer(buf, &dc->dc_mmfile, 1, -1, icase) == FAIL) {
+      return FAIL;
+    }
+    dc->dc_handle = buf->handle;
+    dc->dc_tick = buf_get_changedtick(buf);
+    dc->dc_icase = icase;
+  }
+  din->din_mmfile = dc->dc_mmfile;
+  din->din_cached = true;
+  return OK;
+}
+
+/// Free the text of buffer "handle" kept by diff_write_cached().
+static void diff_cache_free(handle_T handle)
+{
+  if (handle == 0) {
+    return;
+  }
+  for (int i = 0; i < DB_COUNT; i++) {
+    if (diff_cache[i].dc_handle == handle) {
+      xfree(diff_cache[i].dc_mmfile.ptr);
+      CLEAR_FIELD(diff_cache[i]);
+    }
+  }
+}
+
 /// Write buffer "buf" to file or memory buffer.
 ///
 /// Always use 'fileformat' set to "unix".
@@ -849,7 +955,10 @@ static int diff_write_buffer(buf_T *buf, mmfile_t *m, linenr_T start, linenr_T e
 static int diff_write(buf_T *buf, diffin_T *din, linenr_T start, linenr_T end)
 {
   if (din->din_fname == NULL) {
-    return diff_write_buffer(buf, &din->din_mmfile, start, end);
+    if (start == 1 && end < 0) {
+      return diff_write_cached(buf, din, diff_flags & DIFF_ICASE);
+    }
+    return diff_write_buffer(buf, &din->din_mmfile, start, end, diff_flags & DIFF_ICASE);
   }
 
   if (end < 0) {
@@ -986,28 +1095,38 @@ static void diff_try_update(diffio_T *dio, int idx_orig, exarg_T *eap)
       goto theend;
     }
 
-    // Make a difference between the first buffer and every other.
+    linenr_T lnum_starts[DB_COUNT];
+    linenr_T lnum_ends[DB_COUNT];
     for (int idx_new = idx_orig + 1; idx_new < DB_COUNT; idx_new++) {
-      buf = curtab->tp_diffbuf[idx_new];
-      if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
-        continue;  // skip buffer that isn't loaded
-      }
-      lnum_start = anchor_i == 0 ? 1 : anchors[idx_new][anchor_i - 1];
-      lnum_end = anchor_i == num_anchors ? -1 : anchors[idx_new][anchor_i] - 1;
+      lnum_starts[idx_new] = anchor_i == 0 ? 1 : anchors[idx_new][anchor_i - 1];
+      lnum_ends[idx_new] = anchor_i == num_anchors ? -1 : anchors[idx_new][anchor_i] - 1;
+    }
 
-      // Write the other buffer and diff with the first one.
-      if (diff_write(buf, &dio->dio_new, lnum_start, lnum_end) == FAIL) {
-        continue;
-      }
-      if (diff_file(dio) == FAIL) {
-        continue;
-      }
+    // Make a difference between the first buffer and every other.
+    // With several buffers these are diffed at the same time.
+    if (!diff_files_parallel(dio, idx_orig, lnum_starts, lnum_ends)) {
+      for (int idx_new = idx_orig + 1; idx_new < DB_COUNT; idx_new++) {
+        buf = curtab->tp_diffbuf[idx_new];
+        if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
+          continue;  // skip buffer that isn't loaded
+        }
+        lnum_start = lnum_starts[idx_new];
+        lnum_end = lnum_ends[idx_new];
 
-      // Read the diff output and add each entry to the diff list.
-      diff_read(idx_orig, idx_new, dio);
+        // Write the other buffer and diff with the first one.
+        if (diff_write(buf, &dio->dio_new, lnum_start, lnum_end) == FAIL) {
+          continue;
+        }
+        if (diff_file(dio) == FAIL) {
+          continue;
+        }
 
-      clear_diffin(&dio->dio_new);
-      clear_diffout(&dio->dio_diff);
+        // Read the diff output and add each entry to the diff list.
+        diff_read(idx_orig, idx_new, dio);
+
+        clear_diffin(&dio->dio_new);
+        clear_diffout(&dio->dio_diff);
+      }
     }
     clear_diffin(&dio->dio_orig);
 
@@ -1046,6 +1165,221 @@ int diff_internal(void)
   return (diff_flags & DIFF_INTERNAL) != 0 && *p_dex == NUL;
 }
 
+/// Remember that lines "lnum" to "lnume" (exclusive) in "buf" were changed and
+/// "xtra" lines were added, so that ex_diffupdate() only needs to diff the
+/// edited part again.  Called by changed_common() after b:changedtick was
+/// incremented.
+void diff_record_change(buf_T *buf, linenr_T lnum, linenr_T lnume, linenr_T xtra)
+{
+  FOR_ALL_TABS(tp) {
+    int idx = diff_buf_idx(buf, tp);
+    if (idx == DB_COUNT || !tp->tp_diff_partial) {
+      continue;
+    }
+    diffdirty_T *dd = &tp->tp_diff_dirty[idx];
+    if (dd->dd_tick < 0) {
+      continue;
+    }
+    // A change that was not recorded makes the lines unknown, until the next
+    // full update.
+    if (dd->dd_tick != buf_get_changedtick(buf) - 1
+        || dd->dd_lines + xtra != buf->b_ml.ml_line_count) {
+      dd->dd_tick = -1;
+      continue;
+    }
+    dd->dd_tick = buf_get_changedtick(buf);
+    dd->dd_lines = buf->b_ml.ml_line_count;
+
+    // Deleting lines changes the line below them.
+    linenr_T top = lnum;
+    linenr_T bot = MAX(lnume + xtra - 1, lnum);
+    if (dd->dd_top != 0) {
+      top = MIN(top, dd->dd_top);
+      bot = MAX(bot, dd->dd_bot >= lnume ? dd->dd_bot + xtra : dd->dd_bot);
+    }
+    dd->dd_top = top;
+    dd->dd_bot = bot;
+  }
+}
+
+/// Start recording changes in the diff buffers of the current tab page, after
+/// the list of diffs was updated for all their lines.
+static void diff_reset_dirty(void)
+{
+  for (int idx = 0; idx < DB_COUNT; idx++) {
+    buf_T *buf = curtab->tp_diffbuf[idx];
+    diffdirty_T *dd = &curtab->tp_diff_dirty[idx];
+    if (buf == NULL) {
+      continue;
+    }
+    dd->dd_tick = buf_get_changedtick(buf);
+    dd->dd_lines = buf->b_ml.ml_line_count;
+    dd->dd_top = 0;
+    dd->dd_bot = 0;
+  }
+}
+
+/// Update the diffs of two buffers in the current tab page by diffing only the
+/// lines around those changed since the last update and keeping the diff
+/// blocks above and below them.
+///
+/// The diffed section starts and ends in lines that are equal in both
+/// buffers, at least DIFF_PARTIAL_MARGIN lines away from the changes.
+///
+/// @return  FAIL when the whole buffers need to be diffed.
+static int diff_update_partial(void)
+{
+  enum { DIFF_PARTIAL_MARGIN = 50, };
+  int idxs[2];
+  int nbufs = 0;
+  linenr_T top[2];
+  linenr_T bot[2];
+  bool dirty = false;
+
+  if (!curtab->tp_diff_partial || !diff_internal() || (diff_flags & DIFF_ANCHOR)) {
+    return FAIL;
+  }
+  for (int i = 0; i < DB_COUNT; i++) {
+    if (curtab->tp_diffbuf[i] != NULL) {
+      if (nbufs == 2) {
+        return FAIL;
+      }
+      idxs[nbufs++] = i;
+    }
+  }
+  if (nbufs != 2) {
+    return FAIL;
+  }
+  const int idx_orig = idxs[0];
+  const int idx_new = idxs[1];
+  buf_T *bufs[2] = { curtab->tp_diffbuf[idx_orig], curtab->tp_diffbuf[idx_new] };
+  for (int i = 0; i < 2; i++) {
+    diffdirty_T *dd = &curtab->tp_diff_dirty[idxs[i]];
+    if (bufs[i]->b_ml.ml_mfp == NULL
+        || dd->dd_tick != buf_get_changedtick(bufs[i])
+        || dd->dd_lines != bufs[i]->b_ml.ml_line_count) {
+      return FAIL;
+    }
+    if (dd->dd_top == 0) {
+      // Nothing changed: no limit on this side.
+      top[i] = MAXLNUM;
+      bot[i] = 0;
+    } else {
+      top[i] = dd->dd_top - DIFF_PARTIAL_MARGIN;
+      bot[i] = dd->dd_bot + DIFF_PARTIAL_MARGIN;
+      dirty = true;
+    }
+  }
+  if (!dirty) {
+    return FAIL;
+  }
+
+  // Find the section to diff, "start" and "end" are the first and last line
+  // in each buffer.  The unchanged lines before a diff block are its gap, the
+  // gap after the last block ends at the last line.  "first" is the first
+  // block inside the section and "last" the first one after it.
+  linenr_T start[2] = { 1, 1 };
+  linenr_T end[2] = { 0, 0 };
+  diff_T *first = curtab->tp_first_diff;
+  diff_T *last = NULL;
+  diff_T *before = NULL;  // block before "first"
+  bool end_found = false;
+  linenr_T gap_top[2] = { 1, 1 };
+  diff_T *dprev = NULL;
+  for (diff_T *dp = curtab->tp_first_diff;; dp = dp->df_next) {
+    linenr_T gap_bot[2];
+    for (int i = 0; i < 2; i++) {
+      gap_bot[i] = dp == NULL ? bufs[i]->b_ml.ml_line_count : dp->df_lnum[idxs[i]] - 1;
+    }
+    if (gap_bot[0] - gap_top[0] != gap_bot[1] - gap_top[1]) {
+      return FAIL;  // the list of diffs does not match the buffers
+    }
+    // Line in the new buffer is the line in the original buffer minus "off".
+    linenr_T off = gap_top[0] - gap_top[1];
+
+    // The section may start anywhere in the gap or with block "dp".
+    linenr_T s = MIN(MIN(gap_bot[0] + 1, top[0]), top[1] == MAXLNUM ? MAXLNUM : top[1] + off);
+    if (s >= gap_top[0] || dprev == NULL) {
+      start[0] = MAX(s, gap_top[0]);
+      start[1] = start[0] - off;
+      first = dp;
+      before = dprev;
+    }
+    // The section may end anywhere in the gap or with block "dprev".
+    linenr_T e = MAX(MAX(gap_top[0] - 1, bot[0]), bot[1] + off);
+    if (e <= gap_bot[0]) {
+      end[0] = e;
+      end[1] = e - off;
+      last = dp;
+      end_found = true;
+      break;
+    }
+    if (dp == NULL) {
+      break;
+    }
+    dprev = dp;
+    for (int i = 0; i < 2; i++) {
+      gap_top[i] = dp->df_lnum[idxs[i]] + dp->df_count[idxs[i]];
+    }
+  }
+  if (!end_found) {
+    // The changes extend beyond the last line, diff up to the end.
+    end[0] = bufs[0]->b_ml.ml_line_count;
+    end[1] = bufs[1]->b_ml.ml_line_count;
+    last = NULL;
+  }
+  if (first != last) {
+    for (diff_T *dp = first; dp != last; dp = dp->df_next) {
+      if (dp == NULL) {
+        return FAIL;  // "last" is not after "first"
+      }
+    }
+  }
+  if (start[0] > end[0] + 1 || start[1] > end[1] + 1) {
+    return FAIL;
+  }
+
+  diffio_T dio = { 0 };
+  dio.dio_internal = true;
+  ga_init(&dio.dio_diff.dout_ga, sizeof(diffhunk_T), 100);
+  if (diff_write(bufs[0], &dio.dio_orig, start[0], end[0]) == FAIL) {
+    return FAIL;
+  }
+  if (diff_write(bufs[1], &dio.dio_new, start[1], end[1]) == FAIL) {
+    clear_diffin(&dio.dio_orig);
+    return FAIL;
+  }
+  int ret = diff_file(&dio);
+  if (ret == OK) {
+    // Remove the old blocks in the section.
+    for (diff_T *dp = first; dp != last;) {
+      diff_T *dnext = dp->df_next;
+      clear_diffblock(dp);
+      dp = dnext;
+    }
+
+    // Read the new blocks into an empty list and move them to the section.
+    diff_T *orig_diff = curtab->tp_first_diff;
+    curtab->tp_first_diff = NULL;
+    diff_read(idx_orig, idx_new, &dio);
+    diff_T *new_diff = curtab->tp_first_diff;
+    curtab->tp_first_diff = before == NULL ? NULL : orig_diff;
+
+    diff_T **linkp = before == NULL ? &curtab->tp_first_diff : &before->df_next;
+    *linkp = new_diff;
+    for (diff_T *dp = new_diff; dp != NULL; dp = dp->df_next) {
+      dp->df_lnum[idx_orig] += start[0] - 1;
+      dp->df_lnum[idx_new] += start[1] - 1;
+      linkp = &dp->df_next;
+    }
+    *linkp = last;
+  }
+  clear_diffin(&dio.dio_orig);
+  clear_diffin(&dio.dio_new);
+  clear_diffout(&dio.dio_diff);
+  return ret;
+}
+
 /// Completely update the diffs for the buffers involved.
 ///
 /// When using the external "diff" command the buffers are written to a file,
@@ -1060,11 +1394,22 @@ void ex_diffupdate(exarg_T *eap)
     return;
   }
 
+  // After editing only the changed lines need to be diffed again.
+  if (eap == NULL && diff_update_partial() == OK) {
+    curtab->tp_diff_invalid = false;
+    diff_reset_dirty();
+    curwin->w_valid_cursor.lnum = 0;
+    diff_redraw(true);
+    apply_autocmds(EVENT_DIFFUPDATED, NULL, NULL, false, curbuf);
+    return;
+  }
+
   int had_diffs = curtab->tp_first_diff != NULL;
 
   // Delete all diffblocks.
   diff_clear(curtab);
   curtab->tp_diff_invalid = false;
+  curtab->tp_diff_partial = false;
 
   // Use the first buffer as the original text.
   int idx_orig;
@@ -1095,6 +1440,8 @@ void ex_diffupdate(exarg_T *eap)
   diffio.dio_internal = diff_internal();
 
   diff_try_update(&diffio, idx_orig, eap);
+  curtab->tp_diff_partial = diffio.dio_internal;
+  diff_reset_dirty();
 
   // force updating cursor position on screen
   curwin->w_valid_cursor.lnum = 0;
@@ -1195,6 +1542,17 @@ static int check_external_diff(diffio_T *diffio)
 
 /// Invoke the xdiff function.
 static int diff_file_internal(diffio_T *diffio)
+{
+  if (diff_xdl(diffio) == FAIL) {
+    emsg(_("E960: Problem creating the internal diff"));
+    return FAIL;
+  }
+  return OK;
+}
+
+/// Invoke the xdiff function without giving a message, so that it can run in
+/// another thread.
+static int diff_xdl(diffio_T *diffio)
 {
   xpparam_t param;
   xdemitconf_t emit_cfg;
@@ -1225,12 +1583,83 @@ static int diff_file_internal(diffio_T *diffio)
   if (xdl_diff(&diffio->dio_orig.din_mmfile,
                &diffio->dio_new.din_mmfile,
                &param, &emit_cfg, &emit_cb) < 0) {
-    emsg(_("E960: Problem creating the internal diff"));
     return FAIL;
   }
   return OK;
 }
 
+static void diff_job_thread(void *arg)
+{
+  diffjob_T *job = arg;
+  if (job->dj_ret == OK) {
+    job->dj_ret = diff_xdl(&job->dj_dio);
+  }
+}
+
+/// Diff the first buffer, already written to "dio", with every other buffer
+/// in the current tab page.  Each pair is diffed in its own thread, xdiff
+/// only uses the memory of its input and output.  The results are added to
+/// the diff list in buffer order, like when diffing the pairs one by one.
+///
+/// @param lnum_start  first line of each buffer to diff
+/// @param lnum_end  last line of each buffer, -1 for the last line
+///
+/// @return  false when not using the internal diff or there are less than
+///          two other buffers, the caller needs to diff them.
+static bool diff_files_parallel(diffio_T *dio, int idx_orig, const linenr_T *lnum_start,
+                                const linenr_T *lnum_end)
+{
+  if (!dio->dio_internal || *p_dex != NUL || uv_available_parallelism() < 2) {
+    return false;
+  }
+  int njobs = 0;
+  for (int idx_new = idx_orig + 1; idx_new < DB_COUNT; idx_new++) {
+    buf_T *buf = curtab->tp_diffbuf[idx_new];
+    if (buf != NULL && buf->b_ml.ml_mfp != NULL) {
+      njobs++;
+    }
+  }
+  if (njobs < 2) {
+    return false;
+  }
+
+  diffjob_T jobs[DB_COUNT];
+  njobs = 0;
+  for (int idx_new = idx_orig + 1; idx_new < DB_COUNT; idx_new++) {
+    buf_T *buf = curtab->tp_diffbuf[idx_new];
+    if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
+      continue;  // skip buffer that isn't loaded
+    }
+    diffjob_T *job = &jobs[njobs];
+    CLEAR_POINTER(job);
+    job->dj_idx = idx_new;
+    job->dj_dio.dio_internal = true;
+    job->dj_dio.dio_orig = dio->dio_orig;
+    ga_init(&job->dj_dio.dio_diff.dout_ga, sizeof(diffhunk_T), 100);
+    // Reading the buffer is only possible in this thread.
+    job->dj_ret = diff_write(buf, &job->dj_dio.dio_new, lnum_start[idx_new], lnum_end[idx_new]);
+    njobs++;
+  }
+
+  run_in_threads(jobs, (size_t)njobs, sizeof(*jobs), diff_job_thread);
+
+  bool failed = false;
+  for (int i = 0; i < njobs; i++) {
+    if (jobs[i].dj_ret == OK) {
+      // Read the diff output and add each entry to the diff list.
+      diff_read(idx_orig, jobs[i].dj_idx, &jobs[i].dj_dio);
+    } else {
+      failed = true;
+    }
+    clear_diffin(&jobs[i].dj_dio.dio_new);
+    clear_diffout(&jobs[i].dj_dio.dio_diff);
+  }
+  if (failed) {
+    emsg(_("E960: Problem creating the internal diff"));
+  }
+  return true;
+}
+
 /// Make a diff between files "tmp_orig" and "tmp_new", results in "tmp_diff".
 ///
 /// @param dio
@@ -2145,7 +2574,8 @@ static void run_linematch_algorithm(diff_T *dp)
         // write the contents of the entire buffer to
         // diffbufs_mm[diffbuffers_count]
         diff_write_buffer(curtab->tp_diffbuf[i], &diffbufs_mm[ndiffs],
-                          dp->df_lnum[i], dp->df_lnum[i] + dp->df_count[i] - 1);
+                          dp->df_lnum[i], dp->df_lnum[i] + dp->df_count[i] - 1,
+                          diff_flags & DIFF_ICASE);
       } else {
         diffbufs_mm[ndiffs].size = 0;
         diffbufs_mm[ndiffs].ptr = NULL;
@@ -2612,10 +3042,12 @@ int diffanchors_changed(bool buflocal)
     FOR_ALL_TABS(tp) {
       if (!buflocal) {
         tp->tp_diff_invalid = true;
+        tp->tp_diff_partial = false;
       } else {
         for (int idx = 0; idx < DB_COUNT; idx++) {
           if (tp->tp_diffbuf[idx] == curbuf) {
             tp->tp_diff_invalid = true;
+            tp->tp_diff_partial = false;
             break;
           }
         }
@@ -2758,6 +3190,7 @@ int diffopt_changed(void)
   if (diff_flags != diff_flags_new || diff_algorithm != diff_algorithm_new) {
     FOR_ALL_TABS(tp) {
       tp->tp_diff_invalid = true;
+      tp->tp_diff_partial = false;
     }
   }
 
@@ -4227,6 +4660,95 @@ static int xdiff_out(int start_a, int count_a, int start_b, int count_b, void *p
   return 0;
 }
 
+/// Make the lines of "buf" equal to the lines of "from", only changing the
+/// lines that differ.  Unlike replacing all the lines, this keeps marks,
+/// extmarks and folds in the lines that did not change, and only saves the
+/// changed lines for undo.
+///
+/// @return  FAIL if the diff could not be made or a change failed.
+int diff_update_buffer(buf_T *buf, buf_T *from)
+  FUNC_ATTR_NONNULL_ALL
+{
+  xpparam_t param;
+  xdemitconf_t emit_cfg;
+  xdemitcb_t emit_cb;
+  mmfile_t orig;
+  mmfile_t new;
+  diffout_T dout;
+
+  CLEAR_FIELD(param);
+  CLEAR_FIELD(emit_cfg);
+  CLEAR_FIELD(emit_cb);
+  CLEAR_FIELD(dout);
+  ga_init(&dout.dout_ga, sizeof(diffhunk_T), 100);
+
+  diff_write_buffer(buf, &orig, 1, -1, false);
+  diff_write_buffer(from, &new, 1, -1, false);
+
+  emit_cb.priv = &dout;
+  emit_cfg.hunk_func = xdiff_out;
+  int retval = xdl_diff(&orig, &new, &param, &emit_cfg, &emit_cb) < 0 ? FAIL : OK;
+  xfree(orig.ptr);
+  xfree(new.ptr);
+
+  // Apply the hunks from the end, so that the line numbers of the hunks
+  // before it stay valid.
+  for (int i = dout.dout_ga.ga_len - 1; i >= 0 && retval == OK; i--) {
+    retval = diff_update_hunk(buf, from, &((diffhunk_T *)dout.dout_ga.ga_data)[i]);
+  }
+
+  ga_clear(&dout.dout_ga);
+  return retval;
+}
+
+/// Replace the lines of "hunk" in "buf" with the lines from "from".
+static int diff_update_hunk(buf_T *buf, buf_T *from, diffhunk_T *hunk)
+{
+  linenr_T lnum = hunk->lnum_orig;
+  linenr_T count_orig = hunk->count_orig;
+  linenr_T count_new = hunk->count_new;
+  linenr_T extra = count_new - count_orig;
+
+  if (u_save_buf(buf, lnum - 1, lnum + count_orig) == FAIL) {
+    return FAIL;
+  }
+
+  bcount_t deleted_bytes = get_region_bytecount(buf, lnum, lnum + count_orig, 0, 0);
+  bcount_t inserted_bytes = 0;
+
+  for (linenr_T i = count_new; i < count_orig; i++) {
+    if (ml_delete_buf(buf, lnum + count_new, false) == FAIL) {
+      return FAIL;
+    }
+  }
+
+  for (linenr_T i = 0; i < count_new; i++) {
+    char *line = ml_get_buf(from, hunk->lnum_new + i);
+    inserted_bytes += ml_get_buf_len(from, hunk->lnum_new + i) + 1;
+    if (i < count_orig) {
+      if (ml_replace_buf(buf, lnum + i, line, true, false) == FAIL) {
+        return FAIL;
+      }
+    } else if (ml_append_buf(buf, lnum + i - 1, line, 0, false) == FAIL) {
+      return FAIL;
+    }
+  }
+
+  // Marks in deleted lines are deleted, marks below the hunk move.
+  if (extra < 0) {
+    mark_adjust_buf(buf, lnum + count_new, lnum + count_orig - 1, MAXLNUM, extra,
+                    true, false, kExtmarkNOOP);
+  } else if (extra > 0) {
+    mark_adjust_buf(buf, lnum + count_orig, MAXLNUM, extra, 0, true, false, kExtmarkNOOP);
+  }
+
+  extmark_splice(buf, (int)lnum - 1, 0, count_orig, 0, deleted_bytes,
+                 count_new, 0, inserted_bytes, kExtmarkUndo);
+
+  changed_lines(buf, lnum, 0, lnum + count_orig, extra, true);
+  return OK;
+}
+
 /// "diff_filler()" function
 void f_diff_filler(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
 {
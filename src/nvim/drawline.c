@@ -32,6 +32,7 @@
 #include "nvim/highlight_group.h"
 #include "nvim/indent.h"
 #include "nvim/insexpand.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/marktree_defs.h"
 #include "nvim/match.h"
@@ -43,6 +44,7 @@
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/os_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/quickfix.h"
@@ -130,6 +132,42 @@ typedef struct {
   int *color_cols;           ///< if not NULL, highlight colorcolumn using according columns array
 } winlinevars_T;
 
+/// What the rows drawn for a line depend on, besides the buffer text.
+/// Compared with memcmp(), so it must be cleared before it is filled.
+typedef struct {
+  varnumber_T tick;          ///< b:changedtick
+  int width;                 ///< w_view_width
+  colnr_T leftcol;           ///< w_leftcol
+  int col_off;               ///< width of the fold, sign and number columns
+  linenr_T relnum;           ///< line number relative to the cursor for 'relativenumber'
+  colnr_T cuc_vcol;          ///< cursor column for 'cursorcolumn', -1 if not set
+  int bg_attr;               ///< window background attribute
+  bool is_curwin;            ///< drawn in the current window
+  int fold_level;            ///< foldinfo_T.fi_level
+  int fold_low_level;        ///< foldinfo_T.fi_low_level
+} WinLineKey;
+
+/// One call of grid_put_linebuf() made for a cached line.
+typedef struct {
+  int row;                   ///< row relative to the first row of the line
+  int startcol;
+  int endcol;
+  int clear_width;
+  int bg_attr;
+  colnr_T last_vcol;
+  int flags;
+  schar_T *chars;            ///< linebuf_char[], also holds attrs and vcols
+  sattr_T *attrs;            ///< linebuf_attr[]
+  colnr_T *vcols;            ///< linebuf_vcol[]
+} WinLinePut;
+
+/// Entry in "w_line_cache": the rows win_line() put on the screen for a line.
+typedef struct {
+  WinLineKey key;
+  int rows;                  ///< number of rows the line occupies
+  kvec_t(WinLinePut) puts;
+} WinLineCache;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "drawline.c.generated.h"
 #endif
@@ -137,6 +175,11 @@ typedef struct {
 static char *extra_buf = NULL;
 static size_t extra_buf_size = 0;
 
+/// Window whose lines may be cached in this redraw, see win_line_cache_start().
+static win_T *line_cache_win = NULL;
+/// Line being recorded by wlv_put_linebuf(), NULL when not recording.
+static WinLineCache *line_cache_rec = NULL;
+
 static char *get_extra_buf(size_t size)
 {
   size = MAX(size, 64);
@@ -364,6 +407,11 @@ static int draw_virt_text_item(buf_T *buf, int col, VirtText vt, HlMode hl_mode,
   const char *virt_str = "";
   int virt_attr = 0;
   size_t virt_pos = 0;
+  // Consecutive cells mostly have the same attributes underneath, remember the
+  // last combination to avoid looking it up again for every cell.
+  int last_base = -1;
+  int last_virt = -1;
+  int last_attr = 0;
 
   while (col < max_col) {
     if (skip_cells >= 0 && *virt_str == NUL) {
@@ -395,7 +443,12 @@ static int draw_virt_text_item(buf_T *buf, int col, VirtText vt, HlMode hl_mode,
     int attr;
     bool through = false;
     if (hl_mode == kHlModeCombine) {
-      attr = hl_combine_attr(linebuf_attr[col], virt_attr);
+      if (linebuf_attr[col] != last_base || virt_attr != last_virt) {
+        last_base = linebuf_attr[col];
+        last_virt = virt_attr;
+        last_attr = hl_combine_attr(last_base, last_virt);
+      }
+      attr = last_attr;
     } else if (hl_mode == kHlModeBlend) {
       through = (*draw_str == ' ');
       attr = hl_blend_attrs(linebuf_attr[col], virt_attr, &through);
@@ -549,7 +602,7 @@ static void draw_sign(bool nrcol, win_T *wp, winlinevars_T *wlv, int sign_idx)
 static inline void get_line_number_str(win_T *wp, linenr_T lnum, char *buf, size_t buf_len)
 {
   linenr_T num;
-  char *fmt = "%*" PRIdLINENR " ";
+  int width = number_width(wp);
 
   if (wp->w_p_nu && !wp->w_p_rnu) {
     // 'number' + 'norelativenumber'
@@ -560,11 +613,14 @@ static inline void get_line_number_str(win_T *wp, linenr_T lnum, char *buf, size
     if (num == 0 && wp->w_p_nu && wp->w_p_rnu) {
       // 'number' + 'relativenumber'
       num = lnum;
-      fmt = "%-*" PRIdLINENR " ";
+      width = -width;
     }
   }
 
-  snprintf(buf, buf_len, fmt, number_width(wp), num);
+  // Leave room for the separating space.
+  size_t len = vim_fmt_num(buf, buf_len - 1, num, width);
+  buf[len++] = ' ';
+  buf[len] = NUL;
 }
 
 /// Return true if CursorLineNr highlight is to be used for the number column.
@@ -1040,6 +1096,9 @@ static int get_rightmost_vcol(win_T *wp, const int *color_cols)
 int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, int col_rows, bool concealed,
              spellvars_T *spv, foldinfo_T foldinfo)
 {
+  g_stats.win_line++;
+  const uint64_t win_line_start = os_hrtime();
+
   colnr_T vcol_prev = -1;             // "wlv.vcol" of previous character
   GridView *grid = &wp->w_grid;       // grid specific to the window
   const int view_width = wp->w_view_width;
@@ -1127,6 +1186,13 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, int col_rows, b
 
   assert(startrow < endrow);
 
+  // Remember the rows of the line when it can be put back later.
+  size_t win_extmark_count = kv_size(win_extmark_arr);
+  if (col_rows == 0 && !concealed && lnum != spv->spv_checked_lnum
+      && win_line_cache_line_ok(wp, lnum, foldinfo)) {
+    line_cache_rec = xcalloc(1, sizeof(*line_cache_rec));
+  }
+
   // variables passed between functions
   winlinevars_T wlv = {
     .lnum = lnum,
@@ -1635,6 +1701,11 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, int col_rows, b
 
   const bool may_have_inline_virt
     = !has_foldtext && buf_meta_total(wp->w_buffer, kMTMetaInline) > 0;
+  // When nothing highlights or replaces single characters, runs of printable
+  // ASCII can be copied to "linebuf_char" directly.
+  const bool plain_ascii = !extra_check && !area_highlighting && !has_fold
+                           && !wp->w_p_list && wp->w_p_cole == 0 && !wp->w_p_cuc
+                           && !may_have_inline_virt && !cul_screenline && dollar_vcol < 0;
   int virt_line_index = -1;
   int virt_line_flags = 0;
   // Repeat for the whole displayed line.
@@ -2067,6 +2138,29 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, int col_rows, b
       // skip writing the buffer line itself
       mb_schar = NUL;
     } else {
+      if (plain_ascii && wlv.skip_cells <= 0 && wlv.skipped_cells == 0 && wlv.n_attr == 0
+          && n_attr3 == 0 && multi_attr == 0 && wlv.boguscols == 0 && wlv.color_cols == NULL) {
+        // Copy printable ASCII characters up to the last column, which is
+        // left for the checks at the end of the screen line.  A character
+        // followed by a composing character is drawn as usual.
+        const int max_len = view_width - 1 - wlv.col;
+        int len = 0;
+        while (len < max_len && (uint8_t)ptr[len] >= 0x20 && (uint8_t)ptr[len] < 0x7f
+               && (uint8_t)ptr[len + 1] < 0x80) {
+          linebuf_char[wlv.off + len] = schar_from_ascii(ptr[len]);
+          linebuf_attr[wlv.off + len] = wlv.char_attr;
+          linebuf_vcol[wlv.off + len] = wlv.vcol + len;
+          len++;
+        }
+        if (len > 0) {
+          ptr += len;
+          wlv.off += len;
+          wlv.col += len;
+          wlv.vcol += len;
+          vcol_prev = wlv.vcol - 1;
+        }
+      }
+
       const char *prev_ptr = ptr;
 
       // first byte of next char
@@ -3128,6 +3222,31 @@ end_check:
   clear_virttext(&fold_vt);
   kv_destroy(virt_lines);
   xfree(foldtext_free);
+
+  if (line_cache_rec != NULL) {
+    WinLineCache *entry = line_cache_rec;
+    line_cache_rec = NULL;
+    win_line_cache_key(wp, lnum, foldinfo, &entry->key);
+    entry->rows = wlv.row - startrow;
+    // Only keep lines which are completely visible and were drawn without
+    // anything that changes when they are drawn again.
+    if (wlv.row < view_height && !wp->w_s->b_syn_slow
+        && kv_size(win_extmark_arr) == win_extmark_count
+        && decor_providers_row_cached(wp, lnum - 1)) {
+      if (map_size(&wp->w_line_cache) >= (uint32_t)(2 * Rows)) {
+        win_line_cache_clear(wp);
+      }
+      ptr_t *ref = pmap_put_ref(int)(&wp->w_line_cache, lnum, NULL, NULL);
+      if (*ref != NULL) {
+        win_line_cache_free(*ref);
+      }
+      *ref = entry;
+    } else {
+      win_line_cache_free(entry);
+    }
+  }
+
+  g_stats.win_line_ns += (int64_t)(os_hrtime() - win_line_start);
   return wlv.row;
 }
 
@@ -3177,8 +3296,162 @@ static void wlv_put_linebuf(win_T *wp, const winlinevars_T *wlv, int endcol, boo
     }
   }
 
+  if (line_cache_rec != NULL) {
+    int width = wp->w_view_width;
+    WinLinePut *put = kv_pushp(line_cache_rec->puts);
+    *put = (WinLinePut){
+      .row = wlv->row - wlv->startrow,
+      .startcol = startcol,
+      .endcol = endcol,
+      .clear_width = clear_width,
+      .bg_attr = bg_attr,
+      .last_vcol = wlv->vcol - 1,
+      .flags = flags,
+    };
+    put->chars = xmalloc((size_t)width * (sizeof(schar_T) + sizeof(sattr_T) + sizeof(colnr_T)));
+    put->attrs = (sattr_T *)(put->chars + width);
+    put->vcols = (colnr_T *)(put->attrs + width);
+    memcpy(put->chars, linebuf_char, (size_t)width * sizeof(schar_T));
+    memcpy(put->attrs, linebuf_attr, (size_t)width * sizeof(sattr_T));
+    memcpy(put->vcols, linebuf_vcol, (size_t)width * sizeof(colnr_T));
+  }
+
   int row = wlv->row;
   int coloff = 0;
   ScreenGrid *g = grid_adjust(grid, &row, &coloff);
   grid_put_linebuf(g, row, coloff, startcol, endcol, clear_width, bg_attr, wlv->vcol - 1, flags);
 }
+
+static void win_line_cache_key(win_T *wp, linenr_T lnum, foldinfo_T foldinfo, WinLineKey *key)
+{
+  memset(key, 0, sizeof(*key));
+  key->tick = buf_get_changedtick(wp->w_buffer);
+  key->width = wp->w_view_width;
+  key->leftcol = wp->w_leftcol;
+  key->col_off = win_col_off(wp);
+  key->relnum = wp->w_p_rnu ? lnum - wp->w_cursor.lnum : 0;
+  key->cuc_vcol = wp->w_p_cuc ? wp->w_virtcol : -1;
+  key->bg_attr = win_bg_attr(wp);
+  key->is_curwin = wp == curwin;
+  key->fold_level = foldinfo.fi_level;
+  key->fold_low_level = foldinfo.fi_low_level;
+}
+
+/// Whether line "lnum" of "wp" is drawn the same way as long as its key does
+/// not change.  The top line may have filler lines or 'smoothscroll' and the
+/// cursor line depends on the cursor column.
+static bool win_line_cache_line_ok(win_T *wp, linenr_T lnum, foldinfo_T foldinfo)
+{
+  return wp == line_cache_win
+         && lnum != wp->w_topline
+         && lnum != wp->w_cursor.lnum
+         && lnum != wp->w_cursorline
+         && lnum <= wp->w_buffer->b_ml.ml_line_count
+         && foldinfo.fi_lines == 0;
+}
+
+static void win_line_cache_free(WinLineCache *entry)
+{
+  for (size_t i = 0; i < kv_size(entry->puts); i++) {
+    xfree(kv_A(entry->puts, i).chars);
+  }
+  kv_destroy(entry->puts);
+  xfree(entry);
+}
+
+/// Forget all lines cached for "wp".
+void win_line_cache_clear(win_T *wp)
+{
+  WinLineCache *entry;
+  map_foreach_value(&wp->w_line_cache, entry, {
+    win_line_cache_free(entry);
+  });
+  map_destroy(int, &wp->w_line_cache);
+}
+
+/// Forget lines "first" to "last" cached for "wp".
+void win_line_cache_invalidate(win_T *wp, linenr_T first, linenr_T last)
+{
+  uint32_t size = map_size(&wp->w_line_cache);
+  if (size == 0) {
+    return;
+  }
+  if (last - first >= (linenr_T)size) {
+    win_line_cache_clear(wp);
+    return;
+  }
+  for (linenr_T lnum = first; lnum <= last; lnum++) {
+    WinLineCache *entry = pmap_del(int)(&wp->w_line_cache, lnum, NULL);
+    if (entry != NULL) {
+      win_line_cache_free(entry);
+    }
+  }
+}
+
+/// Called by win_update() before drawing lines of "wp" with redraw type
+/// "type".  Drops the cached lines when the whole window is redrawn and
+/// decides whether lines can be cached in this redraw.
+void win_line_cache_start(win_T *wp, int type)
+{
+  buf_T *buf = wp->w_buffer;
+
+  if (type >= UPD_SOME_VALID) {
+    win_line_cache_clear(wp);
+  }
+
+  // Skip windows where lines are highlighted depending on the cursor or
+  // state that is not part of the key.
+  line_cache_win = NULL;
+  if (buf->terminal || bt_quickfix(buf) || wp->w_p_diff || *wp->w_p_stc != NUL
+      || (VIsual_active && buf == curwin->w_buffer) || highlight_match
+      || (p_hls && !no_hlsearch)
+      || ((State & MODE_INSERT) && ins_compl_win_active(wp))) {
+    return;
+  }
+  line_cache_win = wp;
+}
+
+/// Put back the rows of line "lnum" of "wp" at "startrow" when they were
+/// cached with the same key, instead of drawing the line with win_line().
+///
+/// @param[out] row  row below the line when returning true
+///
+/// @return  whether the line was put back.
+bool win_line_cache_put(win_T *wp, linenr_T lnum, int startrow, foldinfo_T foldinfo, int *row)
+{
+  if (!win_line_cache_line_ok(wp, lnum, foldinfo)) {
+    return false;
+  }
+  WinLineCache *entry = pmap_get(int)(&wp->w_line_cache, lnum);
+  if (entry == NULL || startrow + entry->rows >= wp->w_view_height
+      || !decor_providers_row_cached(wp, lnum - 1)) {
+    return false;
+  }
+  if (wp->w_p_cuc) {
+    validate_virtcol(wp);
+  }
+  WinLineKey key;
+  win_line_cache_key(wp, lnum, foldinfo, &key);
+  if (memcmp(&key, &entry->key, sizeof(key)) != 0) {
+    return false;
+  }
+
+  int width = wp->w_view_width;
+  for (size_t i = 0; i < kv_size(entry->puts); i++) {
+    WinLinePut *put = &kv_A(entry->puts, i);
+    memcpy(linebuf_char, put->chars, (size_t)width * sizeof(schar_T));
+    memcpy(linebuf_attr, put->attrs, (size_t)width * sizeof(sattr_T));
+    memcpy(linebuf_vcol, put->vcols, (size_t)width * sizeof(colnr_T));
+    int grid_row = startrow + put->row;
+    int coloff = 0;
+    ScreenGrid *g = grid_adjust(&wp->w_grid, &grid_row, &coloff);
+    grid_put_linebuf(g, grid_row, coloff, put->startcol, put->endcol, put->clear_width,
+                     put->bg_attr, put->last_vcol, put->flags);
+    if (put->flags & SLF_WRAP) {
+      // Force a redraw of the first column of the next line, like win_line().
+      g->attrs[g->line_offset[grid_row + 1]] = -1;
+    }
+  }
+  *row = startrow + entry->rows;
+  return true;
+}
@@ -66,6 +66,7 @@
 #include "nvim/autocmd_defs.h"
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/buffer_updates.h"
 #include "nvim/charset.h"
 #include "nvim/cmdexpand.h"
 #include "nvim/decoration.h"
@@ -75,6 +76,7 @@
 #include "nvim/digraph.h"
 #include "nvim/drawline.h"
 #include "nvim/drawscreen.h"
+#include "nvim/edit.h"
 #include "nvim/eval.h"
 #include "nvim/ex_getln.h"
 #include "nvim/fold.h"
@@ -92,19 +94,25 @@
 #include "nvim/match.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
+#include "nvim/memory.h"
+#include "nvim/memory_defs.h"
 #include "nvim/message.h"
 #include "nvim/move.h"
 #include "nvim/normal.h"
 #include "nvim/normal_defs.h"
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
+#include "nvim/optionstr.h"
+#include "nvim/os/input.h"
 #include "nvim/os/os_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
 #include "nvim/profile.h"
 #include "nvim/regexp.h"
 #include "nvim/search.h"
+#include "nvim/sign.h"
 #include "nvim/spell.h"
 #include "nvim/state.h"
 #include "nvim/state_defs.h"
@@ -136,6 +144,23 @@ static bool redraw_popupmenu = false;
 static bool msg_grid_invalid = false;
 static bool resizing_autocmd = false;
 static bool conceal_cursor_used = false;
+/// os_hrtime() of the last update_screen(), see redraw_wait_time().
+static uint64_t last_update_time = 0;
+/// Temporary allocations for drawing, see frame_arena().
+static Arena frame_arena_mem = ARENA_EMPTY;
+
+/// Arena for temporary allocations while drawing.
+///
+/// Everything allocated from it is freed at once at the end of update_screen(),
+/// so the blocks are reused for the next redraw instead of calling malloc() and
+/// free() for every allocation. Memory that is allocated outside of
+/// update_screen() is freed at the end of the next one. It must not be used
+/// across code that may call update_screen(), like evaluating an expression
+/// when not inside update_screen().
+Arena *frame_arena(void)
+{
+  return &frame_arena_mem;
+}
 
 /// Check if the cursor line needs to be redrawn because of 'concealcursor'.
 ///
@@ -431,6 +456,34 @@ bool redrawing(void)
          && !(p_lz && char_avail() && !KeyTyped && !do_redraw);
 }
 
+/// Replace the full glyph cache with one that only contains the glyphs which
+/// are still in use.  Unlike clearing the cache, the screen grids stay valid
+/// and nothing needs to be redrawn.
+static void compact_glyph_cache(void)
+{
+  schar_cache_compact_start();
+  grid_remap_glyphs(&default_grid);
+  grid_remap_glyphs(&msg_grid);
+  grid_remap_glyphs(&pum_grid);
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    grid_remap_glyphs(&wp->w_grid_alloc);
+    // cached lines are cheap to draw again
+    win_line_cache_clear(wp);
+  }
+  decor_remap_glyphs();
+  decor_providers_remap_glyphs();
+  sign_remap_glyphs();
+  edit_remap_glyphs();
+  ui_comp_remap_glyphs();
+  schar_cache_compact_finish();
+
+  // for char options we have stored the original strings. Regenerate
+  // the parsed schar_T values with the new cache.
+  if (check_chars_options()) {
+    abort();
+  }
+}
+
 /// Redraw the parts of the screen that is marked for redraw.
 ///
 /// Most code shouldn't call this directly, rather use redraw_later() and
@@ -465,6 +518,10 @@ int update_screen(void)
     return FAIL;
   }
 
+  // Changes queued for buffer update callbacks may be needed for drawing,
+  // e.g. by treesitter highlighting.
+  buf_updates_flush_all();
+
   int type = must_redraw;
 
   // must_redraw is reset here, so that when we run into some weird
@@ -475,17 +532,16 @@ int update_screen(void)
   must_redraw = 0;
 
   updating_screen = true;
+  g_stats.redraw++;
+  input_latency_redraw();
+  const uint64_t redraw_start = os_hrtime();
 
   display_tick++;  // let syntax code know we're in a next round of
                    // display updating
 
   // glyph cache full, very rare
-  if (schar_cache_clear_if_full()) {
-    // must use CLEAR, as the contents of screen buffers cannot be
-    // compared to their previous state here.
-    // TODO(bfredl): if start to cache schar_T values in places (like fcs/lcs)
-    // we need to revalidate these here as well!
-    type = MAX(type, UPD_CLEAR);
+  if (schar_cache_full()) {
+    compact_glyph_cache();
   }
 
   // Tricky: vim code can reset msg_scrolled behind our back, so need
@@ -530,11 +586,11 @@ int update_screen(void)
           wp->w_redr_type = MAX(wp->w_redr_type, UPD_NOT_VALID);
         }
         if (!is_stl_global && W_ENDROW(wp) + wp->w_status_height > valid) {
-          wp->w_redr_status = true;
+          status_repaint_later(wp);
         }
       }
       if (is_stl_global && Rows - p_ch - 1 > valid) {
-        curwin->w_redr_status = true;
+        status_repaint_later(curwin);
       }
     }
     msg_grid_set_pos(Rows - (int)p_ch, false);
@@ -667,7 +723,9 @@ int update_screen(void)
         did_one = true;
         start_search_hl();
       }
+      const uint64_t win_tm = trace_begin();
       win_update(wp);
+      trace_end("redraw", "win_update", NULL, win_tm);
     }
 
     // redraw status line and window bar after the window to minimize cursor movement
@@ -718,9 +776,25 @@ int update_screen(void)
   if (!ui_has(kUICmdline)) {
     cmdline_was_last_drawn = false;
   }
+  trace_end("redraw", "update_screen", NULL, redraw_start);
+  last_update_time = os_hrtime();
+  arena_mem_free(arena_finish(&frame_arena_mem));
+  g_stats.redraw_ns += (int64_t)(last_update_time - redraw_start);
+  stats_hist_add(g_stats.redraw_hist, last_update_time - redraw_start);
   return OK;
 }
 
+/// @return  the time in milliseconds to wait before updating the screen for
+///          events, so that it is updated at most once per 'redrawinterval'.
+int redraw_wait_time(void)
+{
+  if (p_rdi <= 0 || last_update_time == 0) {
+    return 0;
+  }
+  uint64_t elapsed = (os_hrtime() - last_update_time) / 1000000;
+  return elapsed >= (uint64_t)p_rdi ? 0 : (int)((uint64_t)p_rdi - elapsed);
+}
+
 /// Prepare for 'hlsearch' highlighting.
 void start_search_hl(void)
 {
@@ -918,13 +992,13 @@ void show_cursor_info_later(bool force)
       || state != curwin->w_stl_state
       || (VIsual_active && VIsual_mode != curwin->w_stl_visual_mode)) {
     if (curwin->w_status_height || global_stl_height()) {
-      curwin->w_redr_status = true;
+      status_redraw_win(curwin);
     } else {
       redraw_cmdline = true;
     }
 
     if (*p_wbr != NUL || *curwin->w_p_wbr != NUL) {
-      curwin->w_redr_status = true;
+      status_redraw_win(curwin);
     }
 
     redraw_custom_title_later();
@@ -1496,7 +1570,7 @@ static void win_update(win_T *wp)
   int type = wp->w_redr_type;
 
   if (type >= UPD_NOT_VALID) {
-    wp->w_redr_status = true;
+    status_repaint_later(wp);
     wp->w_lines_valid = 0;
   }
 
@@ -1677,10 +1751,34 @@ static void win_update(win_T *wp)
     }
   }
 
+  // When 'smoothscroll' changed the part of w_topline that is displayed,
+  // handle w_topline like a changed line: it is redrawn and the rows below
+  // it are scrolled, instead of redrawing all rows.
+  if (type < UPD_SOME_VALID
+      && (wp->w_skipcol != wp->w_old_skipcol
+          || (wp->w_skipcol > 0 && wp->w_lines_valid > 0
+              && wp->w_lines[0].wl_lnum != wp->w_topline))) {
+    if (type != UPD_REDRAW_TOP
+        && wp->w_lines_valid > 0
+        && wp->w_lines[0].wl_valid
+        && wp->w_lines[0].wl_lnum <= wp->w_topline
+        && !win_lines_concealed(wp)) {
+      if (mod_top == 0 || mod_top > wp->w_topline) {
+        mod_top = wp->w_topline;
+      }
+      mod_bot = MAX(mod_bot, wp->w_topline + 1);
+    } else {
+      // w_lines[] sizes of the old topline are not usable.
+      type = UPD_NOT_VALID;
+    }
+  }
+
   wp->w_redraw_top = 0;  // reset for next time
   wp->w_redraw_bot = 0;
   search_hl_has_cursor_lnum = 0;
 
+  win_line_cache_start(wp, type);
+
   // When only displaying the lines at the top, set top_end.  Used when
   // window has scrolled down for msg_scrolled.
   if (type == UPD_REDRAW_TOP) {
@@ -2282,24 +2380,31 @@ static void win_update(win_T *wp)
         // will draw "@  " lines below.
         row = wp->w_view_height + 1;
       } else {
-        prepare_search_hl(wp, &screen_search_hl, lnum);
-        // Let the syntax stuff know we skipped a few lines.
-        if (syntax_last_parsed != 0 && syntax_last_parsed + 1 < lnum
-            && syntax_present(wp)) {
-          syntax_end_parsing(wp, syntax_last_parsed + 1);
-        }
-
         bool display_buf_line = !concealed && (foldinfo.fi_lines == 0 || *wp->w_p_fdt == NUL);
 
-        // Display one line
-        spellvars_T zero_spv = { 0 };
-        row = win_line(wp, lnum, srow, wp->w_view_height, 0, concealed,
-                       display_buf_line ? &spv : &zero_spv, foldinfo);
-
-        if (display_buf_line) {
-          syntax_last_parsed = lnum;
-        } else {
+        if (display_buf_line && lnum != spv.spv_checked_lnum
+            && win_line_cache_put(wp, lnum, srow, foldinfo, &row)) {
+          // Put back the rows drawn for the line before, as if it was
+          // not redrawn.
           spv.spv_capcol_lnum = 0;
+        } else {
+          prepare_search_hl(wp, &screen_search_hl, lnum);
+          // Let the syntax stuff know we skipped a few lines.
+          if (syntax_last_parsed != 0 && syntax_last_parsed + 1 < lnum
+              && syntax_present(wp)) {
+            syntax_end_parsing(wp, syntax_last_parsed + 1);
+          }
+
+          // Display one line
+          spellvars_T zero_spv = { 0 };
+          row = win_line(wp, lnum, srow, wp->w_view_height, 0, concealed,
+                         display_buf_line ? &spv : &zero_spv, foldinfo);
+
+          if (display_buf_line) {
+            syntax_last_parsed = lnum;
+          } else {
+            spv.spv_capcol_lnum = 0;
+          }
         }
 
         linenr_T lastlnum = lnum + foldinfo.fi_lines - (foldinfo.fi_lines > 0);
@@ -2482,6 +2587,7 @@ redr_statuscol:
   wp->w_redr_type = 0;
   wp->w_old_topfill = wp->w_topfill;
   wp->w_old_botfill = wp->w_botfill;
+  wp->w_old_skipcol = wp->w_skipcol;
 
   // Send win_extmarks if needed
   for (size_t n = 0; n < kv_size(win_extmark_arr); n++) {
@@ -2734,6 +2840,7 @@ void redraw_buf_line_later(buf_T *buf, linenr_T line, bool force)
 
 void redraw_win_range_later(win_T *wp, linenr_T first, linenr_T last)
 {
+  win_line_cache_invalidate(wp, first, last);
   if (last >= wp->w_topline && first < wp->w_botline) {
     if (wp->w_redraw_top == 0 || wp->w_redraw_top > first) {
       wp->w_redraw_top = first;
@@ -2774,12 +2881,31 @@ void redraw_buf_status_later(buf_T *buf)
         && (wp->w_status_height
             || (wp == curwin && global_stl_height())
             || wp->w_winbar_height)) {
-      wp->w_redr_status = true;
+      status_redraw_win(wp);
       set_must_redraw(UPD_VALID);
     }
   }
 }
 
+/// Mark the status line and window bar of "wp" for redraw because they were
+/// overwritten on the screen.  When nothing else requires redrawing them,
+/// the text of their last evaluation is drawn again.
+void status_repaint_later(win_T *wp)
+{
+  if (!wp->w_redr_status) {
+    wp->w_stl_repaint = true;
+  }
+  wp->w_redr_status = true;
+}
+
+/// Mark the status line and window bar of "wp" for redraw, they are evaluated
+/// again.
+void status_redraw_win(win_T *wp)
+{
+  wp->w_redr_status = true;
+  wp->w_stl_repaint = false;
+}
+
 /// Mark all status lines and window bars for redraw; used after first :cd
 void status_redraw_all(void)
 {
@@ -2788,7 +2914,7 @@ void status_redraw_all(void)
   FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
     if ((!is_stl_global && wp->w_status_height) || wp == curwin
         || wp->w_winbar_height) {
-      wp->w_redr_status = true;
+      status_redraw_win(wp);
       redraw_later(wp, UPD_VALID);
     }
   }
@@ -2808,7 +2934,7 @@ void status_redraw_buf(buf_T *buf)
   FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
     if (wp->w_buffer == buf && ((!is_stl_global && wp->w_status_height)
                                 || (is_stl_global && wp == curwin) || wp->w_winbar_height)) {
-      wp->w_redr_status = true;
+      status_redraw_win(wp);
       redraw_later(wp, UPD_VALID);
     }
   }
@@ -2845,7 +2971,7 @@ void win_redraw_last_status(const frame_T *frp)
   FUNC_ATTR_NONNULL_ARG(1)
 {
   if (frp->fr_layout == FR_LEAF) {
-    frp->fr_win->w_redr_status = true;
+    status_redraw_win(frp->fr_win);
   } else if (frp->fr_layout == FR_ROW) {
     FOR_ALL_FRAMES(frp, frp->fr_child) {
       win_redraw_last_status(frp);
@@ -1412,7 +1412,9 @@ void ins_redraw(bool ready)
   pum_check_clear();
   show_cursor_info_later(false);
   if (must_redraw) {
-    update_screen();
+    if (!state_redraw_postponed()) {
+      update_screen();
+    }
   } else {
     redraw_statuslines();
     if (clear_cmdline || redraw_cmdline || redraw_mode) {
@@ -1582,6 +1584,14 @@ bool prompt_curpos_editable(void)
              && curwin->w_cursor.col >= (int)strlen(prompt_text()));
 }
 
+/// Translate the saved char of edit_putchar() while compacting the glyph cache.
+void edit_remap_glyphs(void)
+{
+  if (pc_status == PC_STATUS_SET) {
+    pc_schar = schar_cache_remap(pc_schar);
+  }
+}
+
 // Undo the previous edit_putchar().
 void edit_unputchar(void)
 {
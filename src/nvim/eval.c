@@ -45,6 +45,7 @@
 #include "nvim/highlight_group.h"
 #include "nvim/insexpand.h"
 #include "nvim/keycodes.h"
+#include "nvim/lib/kvec.h"
 #include "nvim/lib/queue_defs.h"
 #include "nvim/lua/executor.h"
 #include "nvim/macros_defs.h"
@@ -315,6 +316,51 @@ typedef enum {
   FILTERMAP_FOREACH,
 } filtermap_T;
 
+/// Operation of an expression compiled by expr_compile().
+typedef enum {
+  kExprOpNumber,     ///< Push Number "n".
+  kExprOpString,     ///< Push String "str".
+  kExprOpVimVar,     ///< Push a copy of v: variable with index "n", named "str".
+  kExprOpVar,        ///< Push the value of variable "str", e.g. "b:name".
+  kExprOpCall,       ///< Call function "str" with "n" arguments from the stack.
+  kExprOpLuaCall,    ///< Call chunk "ref" for "v:lua.str()" with "n" arguments.
+  kExprOpLeader,     ///< Apply the "!", "-" and "+" in "str" to the top value.
+  kExprOpCheck,      ///< Check the left operand of "op", like eval5() does.
+  kExprOpArith,      ///< Pop two values, push the result of "op": + - . * / %
+  kExprOpCompare,    ///< Pop two values, push the result of comparison "op".
+  kExprOpBool,       ///< Replace the top value with 0 or 1.
+  kExprOpOr,         ///< Pop a value, if it is true push 1 and jump to "n".
+  kExprOpAnd,        ///< Pop a value, if it is false push 0 and jump to "n".
+  kExprOpJumpFalse,  ///< Pop a value, if it is false jump to "n".
+  kExprOpJump,       ///< Jump to "n".
+} ExprOpType;
+
+/// One operation of a compiled expression.
+typedef struct {
+  ExprOpType type;
+  int op;          ///< Operator character or exprtype_T.
+  TriState ic;     ///< For kExprOpCompare: ignore case, kNone to use 'ignorecase'.
+  varnumber_T n;   ///< Number, argument count, v: variable index or jump target.
+  char *str;       ///< Allocated string or name, NULL when not used.
+  size_t len;      ///< Length of "str".
+  LuaRef ref;      ///< For kExprOpLuaCall: chunk calling the Lua function.
+} ExprOp;
+
+/// Expression compiled to operations on a stack of values.  "ops" is empty
+/// when the expression uses something only eval1() handles.
+typedef struct {
+  kvec_t(ExprOp) ops;
+} ExprProg;
+
+/// State of expr_compile().
+typedef struct {
+  const char *p;   ///< Current position, at a non-white character.
+  ExprProg *prog;  ///< Program being compiled.
+  int depth;       ///< Stack depth after the last operation.
+  int max_depth;   ///< Maximum stack depth.
+  int nest;        ///< Nesting of expr_compile7().
+} ExprCompiler;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "eval.c.generated.h"
 #endif
@@ -543,6 +589,9 @@ void eval_clear(void)
 
   // functions not garbage collected
   free_all_functions();
+
+  expr_progs_clear();
+  map_destroy(cstr_t, &expr_progs);
 }
 
 #endif
@@ -1098,7 +1147,10 @@ varnumber_T eval_to_number(char *expr, const bool use_simple_function)
   emsg_off++;
 
   if (use_simple_function) {
-    r = may_call_simple_func(expr, &rettv);
+    r = eval0_compiled(p, &rettv);
+    if (r == NOTDONE) {
+      r = may_call_simple_func(expr, &rettv);
+    }
   }
   if (r == NOTDONE) {
     r = eval1(&p, &rettv, &EVALARG_EVALUATE);
@@ -2637,14 +2689,637 @@ static int may_call_simple_func(const char *arg, typval_T *rettv)
 /// Same arguments and return value as eval0().
 int eval0_simple_funccal(char *arg, typval_T *rettv, exarg_T *eap, evalarg_T *const evalarg)
 {
-  int r = may_call_simple_func(arg, rettv);
+  int r = NOTDONE;
 
+  if (eap == NULL && evalarg != NULL && (evalarg->eval_flags & EVAL_EVALUATE)) {
+    r = eval0_compiled(arg, rettv);
+  }
+  if (r == NOTDONE) {
+    r = may_call_simple_func(arg, rettv);
+  }
   if (r == NOTDONE) {
     r = eval0(arg, rettv, eap, evalarg);
   }
   return r;
 }
 
+/// Maximum number of values on the stack of a compiled expression, including
+/// the VAR_UNKNOWN after function arguments.
+#define EXPR_STACK_SIZE 32
+/// Maximum number of expressions kept by eval0_compiled().
+#define EXPR_PROG_CACHE_SIZE 64
+
+/// Compiled expressions of eval0_compiled(), keyed by the expression text.
+static PMap(cstr_t) expr_progs = MAP_INIT;
+/// Number of compiled expressions running, "expr_progs" is not cleared then.
+static int expr_progs_busy = 0;
+
+/// Evaluate expression "arg" with a compiled form that is kept per expression
+/// text.  Useful for expressions that are evaluated many times, e.g. 'foldexpr'
+/// for every line.
+///
+/// @return  OK or FAIL, NOTDONE when "arg" must be evaluated with eval0().
+static int eval0_compiled(const char *arg, typval_T *rettv)
+{
+  ExprProg *prog = pmap_get(cstr_t)(&expr_progs, arg);
+
+  if (prog == NULL) {
+    if (map_size(&expr_progs) >= EXPR_PROG_CACHE_SIZE) {
+      if (expr_progs_busy > 0) {
+        return NOTDONE;
+      }
+      expr_progs_clear();
+    }
+    prog = xcalloc(1, sizeof(*prog));
+    expr_compile(arg, prog);
+    pmap_put(cstr_t)(&expr_progs, xstrdup(arg), prog);
+  }
+
+  if (kv_size(prog->ops) == 0) {
+    return NOTDONE;
+  }
+  expr_progs_busy++;
+  int ret = expr_prog_run(prog, rettv);
+  expr_progs_busy--;
+  return ret;
+}
+
+/// Free the operations of "prog".
+static void expr_prog_clear(ExprProg *prog)
+{
+  for (size_t i = 0; i < kv_size(prog->ops); i++) {
+    xfree(kv_A(prog->ops, i).str);
+    if (kv_A(prog->ops, i).type == kExprOpLuaCall) {
+      api_free_luaref(kv_A(prog->ops, i).ref);
+    }
+  }
+  kv_destroy(prog->ops);
+  kv_init(prog->ops);
+}
+
+/// Free all compiled expressions of eval0_compiled().
+static void expr_progs_clear(void)
+{
+  const char *key;
+  ExprProg *prog;
+  map_foreach(&expr_progs, key, prog, {
+    expr_prog_clear(prog);
+    xfree(prog);
+    xfree((char *)key);
+  });
+  map_clear(cstr_t, &expr_progs);
+}
+
+/// Compile expression "expr" into "prog".  Leaves "prog" empty when "expr"
+/// uses something the compiler doesn't handle: more than numbers, strings,
+/// v: and scoped variables, function calls including "v:lua.func()", "!", "-"
+/// and "+" in front and the operators of eval1() to eval6() except "??" and a
+/// single ".".  Any syntax error also leaves "prog" empty, so that eval0() gives the error message.
+static void expr_compile(const char *expr, ExprProg *prog)
+{
+  ExprCompiler c = { .p = skipwhite(expr), .prog = prog };
+
+  if (!expr_compile1(&c) || *c.p != NUL || c.max_depth >= EXPR_STACK_SIZE) {
+    expr_prog_clear(prog);
+  }
+}
+
+/// Add operation "op" to the program, "push" is the change of stack depth.
+///
+/// @return  index of the operation, for setting a jump target.
+static size_t expr_emit(ExprCompiler *c, ExprOp op, int push)
+{
+  kv_push(c->prog->ops, op);
+  c->depth += push;
+  c->max_depth = MAX(c->max_depth, c->depth);
+  return kv_size(c->prog->ops) - 1;
+}
+
+/// Compile "expr2 ? expr1 : expr1", like eval1().
+static bool expr_compile1(ExprCompiler *c)
+{
+  if (!expr_compile2(c)) {
+    return false;
+  }
+  if (*c->p != '?') {
+    return true;
+  }
+  if (c->p[1] == '?') {
+    return false;
+  }
+
+  c->p = skipwhite(c->p + 1);
+  const size_t jump_false = expr_emit(c, (ExprOp){ .type = kExprOpJumpFalse }, -1);
+  if (!expr_compile1(c) || *c->p != ':') {
+    return false;
+  }
+  c->p = skipwhite(c->p + 1);
+  // The second branch starts without the value of the first one.
+  const size_t jump_end = expr_emit(c, (ExprOp){ .type = kExprOpJump }, -1);
+  kv_A(c->prog->ops, jump_false).n = (varnumber_T)kv_size(c->prog->ops);
+  if (!expr_compile1(c)) {
+    return false;
+  }
+  kv_A(c->prog->ops, jump_end).n = (varnumber_T)kv_size(c->prog->ops);
+  return true;
+}
+
+/// Compile "expr3 || expr3 || ...", like eval2().
+static bool expr_compile2(ExprCompiler *c)
+{
+  return expr_compile_logic(c, kExprOpOr, "||", expr_compile3);
+}
+
+/// Compile "expr4 && expr4 && ...", like eval3().
+static bool expr_compile3(ExprCompiler *c)
+{
+  return expr_compile_logic(c, kExprOpAnd, "&&", expr_compile4);
+}
+
+/// Compile a chain of operands compiled with "operand", separated by logical
+/// operator "op" of operation "type".
+static bool expr_compile_logic(ExprCompiler *c, ExprOpType type, const char *op,
+                               bool (*operand)(ExprCompiler *c))
+{
+  if (!operand(c)) {
+    return false;
+  }
+  if (c->p[0] != op[0] || c->p[1] != op[1]) {
+    return true;
+  }
+
+  const size_t start = kv_size(c->prog->ops);
+  while (c->p[0] == op[0] && c->p[1] == op[1]) {
+    expr_emit(c, (ExprOp){ .type = type, .n = -1 }, -1);
+    c->p = skipwhite(c->p + 2);
+    if (!operand(c)) {
+      return false;
+    }
+  }
+  expr_emit(c, (ExprOp){ .type = kExprOpBool }, 0);
+
+  // Jump to after the chain.  Nested chains already have their target.
+  for (size_t i = start; i < kv_size(c->prog->ops); i++) {
+    if (kv_A(c->prog->ops, i).type == type && kv_A(c->prog->ops, i).n == -1) {
+      kv_A(c->prog->ops, i).n = (varnumber_T)kv_size(c->prog->ops);
+    }
+  }
+  return true;
+}
+
+/// Compile "expr5 == expr5" and the other comparisons, like eval4().
+static bool expr_compile4(ExprCompiler *c)
+{
+  if (!expr_compile5(c)) {
+    return false;
+  }
+
+  int len;
+  TriState ic;
+  const exprtype_T type = get_compare_type(c->p, &len, &ic);
+  if (type == EXPR_UNKNOWN) {
+    return true;
+  }
+  c->p = skipwhite(c->p + len);
+  if (!expr_compile5(c)) {
+    return false;
+  }
+  expr_emit(c, (ExprOp){ .type = kExprOpCompare, .op = (int)type, .ic = ic }, -1);
+  return true;
+}
+
+/// Compile "expr6 + expr6", "-" and "..", like eval5().
+static bool expr_compile5(ExprCompiler *c)
+{
+  if (!expr_compile6(c)) {
+    return false;
+  }
+
+  while (true) {
+    const int op = (uint8_t)(*c->p);
+    if (op != '+' && op != '-' && op != '.') {
+      return true;
+    }
+    if (op == '.') {
+      if (c->p[1] != '.') {
+        return false;
+      }
+      c->p++;
+    }
+    expr_emit(c, (ExprOp){ .type = kExprOpCheck, .op = op }, 0);
+    c->p = skipwhite(c->p + 1);
+    if (!expr_compile6(c)) {
+      return false;
+    }
+    expr_emit(c, (ExprOp){ .type = kExprOpArith, .op = op }, -1);
+  }
+}
+
+/// Compile "expr7 * expr7", "/" and "%", like eval6().
+static bool expr_compile6(ExprCompiler *c)
+{
+  if (!expr_compile7(c)) {
+    return false;
+  }
+
+  while (*c->p == '*' || *c->p == '/' || *c->p == '%') {
+    const int op = (uint8_t)(*c->p);
+    c->p = skipwhite(c->p + 1);
+    if (!expr_compile7(c)) {
+      return false;
+    }
+    expr_emit(c, (ExprOp){ .type = kExprOpArith, .op = op }, -1);
+  }
+  return true;
+}
+
+/// Compile a value with "!", "-" and "+" in front, like eval7().
+static bool expr_compile7(ExprCompiler *c)
+{
+  const char *start_leader = c->p;
+  while (*c->p == '!' || *c->p == '-' || *c->p == '+') {
+    c->p = skipwhite(c->p + 1);
+  }
+  const char *end_leader = c->p;
+
+  if (c->nest == 50) {
+    return false;
+  }
+  c->nest++;
+  const bool ok = expr_compile_value(c);
+  c->nest--;
+  if (!ok) {
+    return false;
+  }
+
+  // Subscripts, "->method()" and a Dictionary member are left to eval7().
+  c->p = skipwhite(c->p);
+  if (*c->p == '[' || *c->p == '(' || (c->p[0] == '.' && c->p[1] != '.')
+      || (c->p[0] == '-' && c->p[1] == '>')) {
+    return false;
+  }
+
+  if (end_leader > start_leader) {
+    const size_t len = (size_t)(end_leader - start_leader);
+    expr_emit(c, (ExprOp){ .type = kExprOpLeader, .str = xmemdupz(start_leader, len),
+                           .len = len }, 0);
+  }
+  return true;
+}
+
+/// Compile a Number, a String, a variable, a function call or a nested
+/// expression in parentheses.
+static bool expr_compile_value(ExprCompiler *c)
+{
+  if (*c->p == '(') {
+    c->p = skipwhite(c->p + 1);
+    if (!expr_compile1(c) || *c->p != ')') {
+      return false;
+    }
+    c->p++;
+    return true;
+  }
+  if (*c->p == '\'' || *c->p == '"') {
+    return expr_compile_string(c);
+  }
+  if (ascii_isdigit(*c->p)) {
+    // A Float or Blob is not accepted after this: "." or "z" follows.
+    int len;
+    varnumber_T n;
+    vim_str2nr(c->p, NULL, &len, STR2NR_ALL, &n, NULL, 0, true, NULL);
+    if (len == 0) {
+      return false;
+    }
+    c->p += len;
+    expr_emit(c, (ExprOp){ .type = kExprOpNumber, .n = n }, 1);
+    return true;
+  }
+  return expr_compile_name(c);
+}
+
+/// Compile a 'literal string', or a "string" without backslashes.
+static bool expr_compile_string(ExprCompiler *c)
+{
+  const char quote = *c->p;
+  const char *start = c->p + 1;
+  const char *p = start;
+  size_t len = 0;
+
+  while (*p != quote || (quote == '\'' && p[1] == '\'')) {
+    if (*p == NUL || (quote == '"' && *p == '\\')) {
+      return false;
+    }
+    p += *p == quote ? 2 : 1;
+    len++;
+  }
+
+  char *str = xmalloc(len + 1);
+  size_t i = 0;
+  for (const char *s = start; s < p; s += *s == quote ? 2 : 1) {
+    str[i++] = *s;
+  }
+  str[i] = NUL;
+  c->p = p + 1;
+  expr_emit(c, (ExprOp){ .type = kExprOpString, .str = str, .len = len }, 1);
+  return true;
+}
+
+/// Compile a v:, g:, b:, w: or t: variable, or a call of a global function.
+static bool expr_compile_name(ExprCompiler *c)
+{
+  const char *name = c->p;
+  const char *p = name;
+  int scope = NUL;
+
+  if (ASCII_ISALPHA(p[0]) && p[1] == ':') {
+    scope = (uint8_t)p[0];
+    p += 2;
+  }
+  if (scope == 'v' && strncmp(p, "lua.", 4) == 0) {
+    return expr_compile_luacall(c, p + 4);
+  }
+  const char *start = p;
+  if (!ASCII_ISALPHA(*p) && *p != '_') {
+    return false;
+  }
+  while (ASCII_ISALNUM(*p) || *p == '_' || *p == '#') {
+    p++;
+  }
+  // Curly braces names and "s:" in a name are left to eval7().
+  if (*p == '{' || *p == ':') {
+    return false;
+  }
+  size_t len = (size_t)(p - name);
+
+  const char *paren = skipwhite(p);
+  if (*paren == '(') {
+    int argcount;
+    if ((scope != NUL && scope != 'g') || !expr_compile_args(c, paren, &argcount)) {
+      return false;
+    }
+    expr_emit(c, (ExprOp){ .type = kExprOpCall, .n = argcount, .str = xmemdupz(name, len),
+                           .len = len }, 1 - argcount);
+    return true;
+  }
+
+  if (scope == 'v') {
+    for (size_t i = 0; i < ARRAY_SIZE(vimvars); i++) {
+      if (i != VV_LUA && strlen(vimvars[i].vv_name) == (size_t)(p - start)
+          && strncmp(vimvars[i].vv_name, start, (size_t)(p - start)) == 0) {
+        c->p = p;
+        expr_emit(c, (ExprOp){ .type = kExprOpVimVar, .n = (varnumber_T)i,
+                               .str = xmemdupz(name, len), .len = len }, 1);
+        return true;
+      }
+    }
+    return false;
+  }
+  if (scope == NUL || vim_strchr("gbwt", scope) == NULL) {
+    return false;
+  }
+  c->p = p;
+  expr_emit(c, (ExprOp){ .type = kExprOpVar, .str = xmemdupz(name, len), .len = len }, 1);
+  return true;
+}
+
+/// Compile "v:lua.func(arg, ...)", "name" points to "func".  The chunk that
+/// calls the Lua function is loaded once, instead of for every call.
+static bool expr_compile_luacall(ExprCompiler *c, const char *name)
+{
+  const char *p = skip_luafunc_name(name);
+  const char *paren = skipwhite(p);
+  int argcount;
+
+  if (p == name || *paren != '(' || !expr_compile_args(c, paren, &argcount)) {
+    return false;
+  }
+  const LuaRef ref = nlua_typval_ref(name, (size_t)(p - name));
+  if (ref == LUA_NOREF) {
+    return false;
+  }
+  expr_emit(c, (ExprOp){ .type = kExprOpLuaCall, .n = argcount, .ref = ref }, 1 - argcount);
+  return true;
+}
+
+/// Compile the arguments of a function call, "paren" points to the "(".
+///
+/// @param[out]  argcountp  number of arguments
+static bool expr_compile_args(ExprCompiler *c, const char *paren, int *argcountp)
+{
+  int argcount = 0;
+
+  c->p = skipwhite(paren + 1);
+  if (*c->p != ')') {
+    while (true) {
+      if (argcount == MAX_FUNC_ARGS || !expr_compile1(c)) {
+        return false;
+      }
+      argcount++;
+      if (*c->p == ')') {
+        break;
+      }
+      if (*c->p != ',') {
+        return false;
+      }
+      c->p = skipwhite(c->p + 1);
+    }
+  }
+  c->p++;
+  *argcountp = argcount;
+  return true;
+}
+
+/// Run compiled expression "prog" and put the result in "rettv".
+///
+/// @return  OK or FAIL.
+static int expr_prog_run(const ExprProg *prog, typval_T *rettv)
+{
+  typval_T stack[EXPR_STACK_SIZE];
+  int sp = 0;
+  size_t pc = 0;
+
+  while (pc < kv_size(prog->ops)) {
+    const ExprOp *op = &kv_A(prog->ops, pc++);
+
+    switch (op->type) {
+    case kExprOpNumber:
+      stack[sp++] = (typval_T){ .v_type = VAR_NUMBER, .vval.v_number = op->n };
+      break;
+
+    case kExprOpString:
+      stack[sp++] = (typval_T){ .v_type = VAR_STRING,
+                                .vval.v_string = xmemdupz(op->str, op->len) };
+      break;
+
+    case kExprOpVimVar:
+      if (vimvars[op->n].vv_type != VAR_UNKNOWN) {
+        tv_copy(&vimvars[op->n].vv_tv, &stack[sp++]);
+        break;
+      }
+      FALLTHROUGH;
+
+    case kExprOpVar:
+      if (eval_variable(op->str, (int)op->len, &stack[sp], NULL, true, false) == FAIL) {
+        goto fail;
+      }
+      sp++;
+      break;
+
+    case kExprOpCall:
+    case kExprOpLuaCall: {
+      typval_T tv;
+      sp -= (int)op->n;
+      if (expr_prog_call(op, &stack[sp], &tv) == FAIL) {
+        goto fail;
+      }
+      stack[sp++] = tv;
+      break;
+    }
+
+    case kExprOpLeader: {
+      const char *end_leader = op->str + op->len;
+      if (eval7_leader(&stack[sp - 1], false, op->str, &end_leader) == FAIL) {
+        sp--;  // cleared by eval7_leader()
+        goto fail;
+      }
+      break;
+    }
+
+    case kExprOpCheck: {
+      typval_T *tv = &stack[sp - 1];
+      if ((op->op != '+' || (tv->v_type != VAR_LIST && tv->v_type != VAR_BLOB))
+          && (op->op == '.' || tv->v_type != VAR_FLOAT)
+          && (op->op == '.' ? !tv_check_str(tv) : !tv_check_num(tv))) {
+        goto fail;
+      }
+      break;
+    }
+
+    case kExprOpArith: {
+      typval_T *tv1 = &stack[sp - 2];
+      typval_T *tv2 = &stack[sp - 1];
+      int ret = OK;
+      // Both operands are cleared on failure.
+      sp -= 2;
+      if (op->op == '.') {
+        ret = eval_concat_str(tv1, tv2);
+      } else if (op->op == '+' && tv1->v_type == VAR_BLOB && tv2->v_type == VAR_BLOB) {
+        eval_addblob(tv1, tv2);
+      } else if (op->op == '+' && tv1->v_type == VAR_LIST && tv2->v_type == VAR_LIST) {
+        ret = eval_addlist(tv1, tv2);
+      } else if (op->op == '+' || op->op == '-') {
+        ret = eval_addsub_number(tv1, tv2, op->op);
+      } else {
+        ret = eval_multdiv_number(tv1, tv2, op->op);
+      }
+      if (ret == FAIL) {
+        goto fail;
+      }
+      if (op->op == '+' || op->op == '-' || op->op == '.') {
+        tv_clear(tv2);
+      }
+      sp++;
+      break;
+    }
+
+    case kExprOpCompare: {
+      typval_T *tv1 = &stack[sp - 2];
+      typval_T *tv2 = &stack[sp - 1];
+      const bool ic = op->ic == kNone ? p_ic : op->ic == kTrue;
+      const int ret = typval_compare(tv1, tv2, (exprtype_T)op->op, ic);
+      tv_clear(tv2);
+      sp -= ret == FAIL ? 2 : 1;  // "tv1" is cleared on failure
+      if (ret == FAIL) {
+        goto fail;
+      }
+      break;
+    }
+
+    case kExprOpBool:
+    case kExprOpOr:
+    case kExprOpAnd:
+    case kExprOpJumpFalse: {
+      bool error = false;
+      typval_T *tv = &stack[--sp];
+      const bool val = tv_get_number_chk(tv, &error) != 0;
+      tv_clear(tv);
+      if (error) {
+        goto fail;
+      }
+      const bool jump = op->type == kExprOpOr ? val : !val;
+      if (op->type == kExprOpBool || (jump && op->type != kExprOpJumpFalse)) {
+        stack[sp++] = (typval_T){ .v_type = VAR_NUMBER, .vval.v_number = val };
+      }
+      if (op->type != kExprOpBool && jump) {
+        pc = (size_t)op->n;
+      }
+      break;
+    }
+
+    case kExprOpJump:
+      pc = (size_t)op->n;
+      break;
+    }
+  }
+
+  assert(sp == 1);
+  *rettv = stack[0];
+  return OK;
+
+fail:
+  while (sp > 0) {
+    tv_clear(&stack[--sp]);
+  }
+  return FAIL;
+}
+
+/// Call the function of kExprOpCall "op" with the arguments in "argvars",
+/// like eval_func().  The arguments are cleared.
+///
+/// @return  OK or FAIL.
+static int expr_prog_call(const ExprOp *op, typval_T *argvars, typval_T *rettv)
+{
+  const int argcount = (int)op->n;
+  int ret = OK;
+
+  argvars[argcount].v_type = VAR_UNKNOWN;
+  if (op->type == kExprOpLuaCall) {
+    // Like call_func() for v:lua: the result is VAR_UNKNOWN after a Lua error.
+    rettv->v_type = VAR_UNKNOWN;
+    nlua_typval_call_ref(op->ref, argvars, argcount, rettv);
+  } else {
+    int len = (int)op->len;
+    partial_T *partial;
+    bool found_var = false;
+
+    // If the name is a variable of type VAR_FUNC use its contents.  Need to
+    // make a copy, in case calling the function makes the name invalid.
+    char *name = deref_func_name(op->str, &len, &partial, false, &found_var);
+    name = xmemdupz(name, (size_t)len);
+
+    funcexe_T funcexe = FUNCEXE_INIT;
+    funcexe.fe_firstline = curwin->w_cursor.lnum;
+    funcexe.fe_lastline = curwin->w_cursor.lnum;
+    funcexe.fe_evaluate = true;
+    funcexe.fe_partial = partial;
+    funcexe.fe_found_var = found_var;
+    ret = call_func(name, len, rettv, argcount, argvars, &funcexe);
+    xfree(name);
+  }
+
+  for (int i = 0; i < argcount; i++) {
+    tv_clear(&argvars[i]);
+  }
+
+  // Stop when immediately aborting on error, or when an interrupt occurred or
+  // an exception was thrown but not caught.
+  if (ret == OK && aborting()) {
+    tv_clear(rettv);
+    ret = FAIL;
+  }
+  return ret;
+}
+
 /// Handle top level expression:
 ///      expr2 ? expr1 : expr1
 ///      expr2 ?? expr1
@@ -2900,34 +3575,18 @@ static int eval3(char **arg, typval_T *rettv, evalarg_T *const evalarg)
   return OK;
 }
 
-/// Handle third level expression:
-///      var1 == var2
-///      var1 =~ var2
-///      var1 != var2
-///      var1 !~ var2
-///      var1 > var2
-///      var1 >= var2
-///      var1 < var2
-///      var1 <= var2
-///      var1 is var2
-///      var1 isnot var2
+/// Get the comparison operator at "p", for eval4().
 ///
-/// "arg" must point to the first non-white of the expression.
-/// "arg" is advanced to the next non-white after the recognized expression.
+/// @param[out]  lenp  length of the operator, including a trailing "?" or "#"
+/// @param[out]  icp  kTrue for a trailing "?" (ignore case), kFalse for a
+///                   trailing "#" (match case), kNone otherwise
 ///
-/// @return  OK or FAIL.
-static int eval4(char **arg, typval_T *rettv, evalarg_T *const evalarg)
+/// @return  EXPR_UNKNOWN when there is no comparison operator.
+static exprtype_T get_compare_type(const char *p, int *lenp, TriState *icp)
 {
-  typval_T var2;
   exprtype_T type = EXPR_UNKNOWN;
   int len = 2;
 
-  // Get the first variable.
-  if (eval5(arg, rettv, evalarg) == FAIL) {
-    return FAIL;
-  }
-
-  char *p = *arg;
   switch (p[0]) {
   case '=':
     if (p[1] == '=') {
@@ -2971,19 +3630,54 @@ static int eval4(char **arg, typval_T *rettv, evalarg_T *const evalarg)
     break;
   }
 
-  // If there is a comparative operator, use it.
+  *icp = kNone;
   if (type != EXPR_UNKNOWN) {
-    bool ic;
-    // extra question mark appended: ignore case
-    if (p[len] == '?') {
-      ic = true;
+    if (p[len] == '?') {  // extra question mark appended: ignore case
+      *icp = kTrue;
       len++;
     } else if (p[len] == '#') {  // extra '#' appended: match case
-      ic = false;
+      *icp = kFalse;
       len++;
-    } else {  // nothing appended: use 'ignorecase'
-      ic = p_ic;
     }
+  }
+  *lenp = len;
+  return type;
+}
+
+/// Handle third level expression:
+///      var1 == var2
+///      var1 =~ var2
+///      var1 != var2
+///      var1 !~ var2
+///      var1 > var2
+///      var1 >= var2
+///      var1 < var2
+///      var1 <= var2
+///      var1 is var2
+///      var1 isnot var2
+///
+/// "arg" must point to the first non-white of the expression.
+/// "arg" is advanced to the next non-white after the recognized expression.
+///
+/// @return  OK or FAIL.
+static int eval4(char **arg, typval_T *rettv, evalarg_T *const evalarg)
+{
+  typval_T var2;
+  int len;
+
+  // Get the first variable.
+  if (eval5(arg, rettv, evalarg) == FAIL) {
+    return FAIL;
+  }
+
+  char *p = *arg;
+  TriState icase;
+  const exprtype_T type = get_compare_type(p, &len, &icase);
+
+  // If there is a comparative operator, use it.
+  if (type != EXPR_UNKNOWN) {
+    // Nothing appended: use 'ignorecase'.
+    const bool ic = icase == kNone ? p_ic : icase == kTrue;
 
     // Get the second variable.
     *arg = skipwhite(p + len);
@@ -4096,7 +4790,12 @@ static int eval_index_inner(typval_T *rettv, bool is_range, typval_T *var1, typv
     }
 
     typval_T tmp;
-    tv_copy(&item->di_tv, &tmp);
+    if (rettv->vval.v_dict->dv_refcount == 1) {
+      // Nothing else refers to the dict, no need to copy the value.
+      tv_move(&item->di_tv, &tmp);
+    } else {
+      tv_copy(&item->di_tv, &tmp);
+    }
     tv_clear(rettv);
     *rettv = tmp;
     break;
@@ -4592,6 +5291,8 @@ void partial_unref(partial_T *pt)
 
   if (--pt->pt_refcount <= 0) {
     partial_free(pt);
+  } else {
+    need_garbage_collect = true;
   }
 }
 
@@ -4889,6 +5590,9 @@ bool garbage_collect(bool testing)
     // 3. Check if any funccal can be freed now.
     //    This may call us back recursively.
     did_free = free_unref_funccal(copyID, testing) || did_free;
+    // Freeing the unreferenced items dropped references to each other, but
+    // everything that is left is reachable.
+    need_garbage_collect = false;
   } else if (p_verbose > 0) {
     verb_msg(_("Not enough memory to set references, garbage collection aborted!"));
   }
@@ -5441,9 +6145,11 @@ static void filter_map_dict(dict_T *d, filtermap_T filtermap, const char *func_n
       di->di_tv = newtv;
     } else if (filtermap == FILTERMAP_MAPNEW) {
       // mapnew(): add the item value to the new dict
-      r = tv_dict_add_tv(d_ret, di->di_key, strlen(di->di_key), &newtv);
-      tv_clear(&newtv);
-      if (r == FAIL) {
+      dictitem_T *const new_di = tv_dict_item_alloc(di->di_key);
+      newtv.v_lock = VAR_UNLOCKED;
+      new_di->di_tv = newtv;
+      if (tv_dict_add(d_ret, new_di) == FAIL) {
+        tv_dict_item_free(new_di);
         break;
       }
     } else if (filtermap == FILTERMAP_FILTER && rem) {
@@ -7501,17 +8207,19 @@ dictitem_T *find_var(const char *const name, const size_t name_len, hashtab_T **
                      int no_autoload)
 {
   const char *varname;
-  hashtab_T *const ht = find_var_ht(name, name_len, &varname);
+  dict_T *d;
+  hash_T hash;
+  // The name is hashed once, for the compat lookup and for the scope.
+  hashtab_T *const ht = find_var_ht_dict_hash(name, name_len, &varname, &d, &hash);
   if (htp != NULL) {
     *htp = ht;
   }
   if (ht == NULL) {
     return NULL;
   }
-  dictitem_T *const ret = find_var_in_ht(ht, *name,
-                                         varname,
-                                         name_len - (size_t)(varname - name),
-                                         no_autoload || htp != NULL);
+  dictitem_T *const ret = find_var_in_ht_hash(ht, *name, varname,
+                                              name_len - (size_t)(varname - name), hash,
+                                              no_autoload || htp != NULL);
   if (ret != NULL) {
     return ret;
   }
@@ -7535,6 +8243,16 @@ dictitem_T *find_var(const char *const name, const size_t name_len, hashtab_T **
 dictitem_T *find_var_in_ht(hashtab_T *const ht, int htname, const char *const varname,
                            const size_t varname_len, int no_autoload)
   FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ALL
+{
+  return find_var_in_ht_hash(ht, htname, varname, varname_len,
+                             hash_hash_len(varname, varname_len), no_autoload);
+}
+
+/// Like find_var_in_ht(), but "hash" is the hash of "varname".
+static dictitem_T *find_var_in_ht_hash(hashtab_T *const ht, int htname, const char *const varname,
+                                       const size_t varname_len, const hash_T hash,
+                                       int no_autoload)
+  FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ALL
 {
   if (varname_len == 0) {
     // Must be something like "s:", otherwise "ht" would be NULL.
@@ -7559,7 +8277,7 @@ dictitem_T *find_var_in_ht(hashtab_T *const ht, int htname, const char *const va
     return NULL;
   }
 
-  hashitem_T *hi = hash_find_len(ht, varname, varname_len);
+  hashitem_T *hi = hash_lookup(ht, varname, varname_len, hash);
   if (HASHITEM_EMPTY(hi)) {
     // For global variables we may try auto-loading the script.  If it
     // worked find the variable again.  Don't auto-load a script if it was
@@ -7571,7 +8289,7 @@ dictitem_T *find_var_in_ht(hashtab_T *const ht, int htname, const char *const va
       if (!script_autoload(varname, varname_len, false) || aborting()) {
         return NULL;
       }
-      hi = hash_find_len(ht, varname, varname_len);
+      hi = hash_lookup(ht, varname, varname_len, hash);
     }
     if (HASHITEM_EMPTY(hi)) {
       return NULL;
@@ -7593,6 +8311,15 @@ dictitem_T *find_var_in_ht(hashtab_T *const ht, int htname, const char *const va
 /// @return Scope hashtab, NULL if name is not valid.
 hashtab_T *find_var_ht_dict(const char *name, const size_t name_len, const char **varname,
                             dict_T **d)
+{
+  return find_var_ht_dict_hash(name, name_len, varname, d, NULL);
+}
+
+/// Like find_var_ht_dict(), and also get the hash of "varname".
+///
+/// @param[out]  hashp  When not NULL, set to the hash of "varname".
+static hashtab_T *find_var_ht_dict_hash(const char *name, const size_t name_len,
+                                        const char **varname, dict_T **d, hash_T *hashp)
 {
   funccall_T *funccal = get_funccal();
   *d = NULL;
@@ -7609,7 +8336,11 @@ hashtab_T *find_var_ht_dict(const char *name, const size_t name_len, const char
     *varname = name;
 
     // "version" is "v:version" in all scopes
-    hashitem_T *hi = hash_find_len(&compat_hashtab, name, name_len);
+    const hash_T hash = hash_hash_len(name, name_len);
+    if (hashp != NULL) {
+      *hashp = hash;
+    }
+    hashitem_T *hi = hash_lookup(&compat_hashtab, name, name_len, hash);
     if (!HASHITEM_EMPTY(hi)) {
       return &compat_hashtab;
     }
@@ -7623,6 +8354,9 @@ hashtab_T *find_var_ht_dict(const char *name, const size_t name_len, const char
   }
 
   *varname = name + 2;
+  if (hashp != NULL) {
+    *hashp = hash_hash_len(*varname, name_len - 2);
+  }
   if (*name == 'g') {  // global variable
     *d = &globvardict;
   } else if (name_len > 2
@@ -8478,6 +9212,8 @@ bool common_job_callbacks(dict_T *vopts, CallbackReader *on_stdout, CallbackRead
       && tv_dict_get_callback(vopts, S_LEN("on_exit"), on_exit)) {
     on_stdout->buffered = tv_dict_get_number(vopts, "stdout_buffered");
     on_stderr->buffered = tv_dict_get_number(vopts, "stderr_buffered");
+    on_stdout->raw = tv_dict_get_number(vopts, "stdout_raw");
+    on_stderr->raw = tv_dict_get_number(vopts, "stderr_raw");
     if (on_stdout->buffered && on_stdout->cb.type == kCallbackNone) {
       on_stdout->self = vopts;
     }
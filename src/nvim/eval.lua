@@ -6183,8 +6183,12 @@ M.funcs = {
       	      but `on_stderr` can still be used.
         stderr_buffered: (boolean) Collect data until EOF (stream closed)
       	      before invoking `on_stderr`. |channel-buffered|
+        stderr_raw: (boolean) Pass the data to `on_stderr` as one
+      	      String instead of a list. |channel-raw|
         stdout_buffered: (boolean) Collect data until EOF (stream
       	      closed) before invoking `on_stdout`. |channel-buffered|
+        stdout_raw: (boolean) Pass the data to `on_stdout` as one
+      	      String instead of a list. |channel-raw|
         stdin:      (string) Either "pipe" (default) to connect the
       	      job's stdin to a channel or "null" to disconnect
       	      stdin.
@@ -12792,7 +12796,7 @@ M.funcs = {
     signature = 'undofile({name})',
   },
   undotree = {
-    args = { 0, 1 },
+    args = { 0, 2 },
     base = 1,
     desc = [=[
       Return the current state of the undo tree for the current
@@ -12812,6 +12816,8 @@ M.funcs = {
         "synced"	Non-zero when the last undo block was synced.
       		This happens when waiting from input from the
       		user.  See |undo-blocks|.
+        "memory"	Number of bytes used by the undo information.
+      		See 'undomemory'.
         "entries"	A list of dictionaries with information about
       		undo blocks.
 
@@ -12837,11 +12843,20 @@ M.funcs = {
         "alt"		Alternate entry.  This is again a List of undo
       		blocks.  Each item may again have an "alt"
       		item.
+
+      When {since} is given, "entries" is a flat list of the undo
+      blocks with a sequence number above {since}, ordered by
+      sequence number.  The items have no "alt" item, instead
+      "parent" is the sequence number of the undo block they
+      follow, zero for the oldest.  This is fast for a long undo
+      history when only the new changes are needed: >vim
+      	let changes = undotree('%', last_seen_seq).entries
+      <
     ]=],
     name = 'undotree',
-    params = { { 'buf', 'integer|string' } },
+    params = { { 'buf', 'integer|string' }, { 'since', 'integer' } },
     returns = 'vim.fn.undotree.ret',
-    signature = 'undotree([{buf}])',
+    signature = 'undotree([{buf} [, {since}]])',
   },
   uniq = {
     args = { 1, 3 },
@@ -5,6 +5,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include "klib/kvec.h"
 #include "mpack/conv.h"
 #include "mpack/mpack_core.h"
@@ -20,6 +24,7 @@
 #include "nvim/garray.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/macros_defs.h"
+#include "nvim/math.h"
 #include "nvim/mbyte.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -281,6 +286,36 @@ typval_T decode_string(const char *const s, const size_t len, bool force_blob,
   };
 }
 
+/// Skip printable ASCII characters other than '"' and '\\', which need no
+/// checks or decoding inside a JSON string.
+///
+/// @return Pointer to the first other byte in "p[e - p]", or "e".
+static const char *json_skip_plain_ascii(const char *p, const char *const e)
+  FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ALL
+{
+#ifdef __SSE2__
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(' ');
+  while (e - p >= 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)p);
+    // Signed comparison: also true for bytes 0x80 and above.
+    const __m128i special = _mm_or_si128(_mm_cmplt_epi8(v, space),
+                                         _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                      _mm_cmpeq_epi8(v, backslash)));
+    const int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return p + xctz((uint64_t)mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p < e && (uint8_t)(*p) >= 0x20 && (uint8_t)(*p) < 0x80 && *p != '"' && *p != '\\') {
+    p++;
+  }
+  return p;
+}
+
 /// Parse JSON double-quoted string
 ///
 /// @param[in]  buf  Buffer being converted.
@@ -312,6 +347,12 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
   const char *const s = ++p;
   int ret = OK;
   while (p < e && *p != '"') {
+    const char *const plain_end = json_skip_plain_ascii(p, e);
+    if (plain_end != p) {
+      len += (size_t)(plain_end - p);
+      p = plain_end;
+      continue;
+    }
     if (*p == '\\') {
       p++;
       if (p == e) {
@@ -451,7 +492,12 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
         abort();
       }
     } else {
-      *str_end++ = *t;
+      // Copy everything up to the next escape at once.
+      const char *const esc = memchr(t, '\\', (size_t)(p - t));
+      const size_t copy_len = (size_t)((esc == NULL ? p : esc) - t);
+      memcpy(str_end, t, copy_len);
+      str_end += copy_len;
+      t += copy_len - 1;
     }
   }
   PUT_FST_IN_PAIR(fst_in_pair, str_end);
@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <lauxlib.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -119,8 +120,49 @@ bool tv_in_free_unref_items = false;
 const char *const tv_empty_string = "";
 
 //{{{1 Lists
+//{{{2 List index
+
+/// Build the item index of a list when tv_list_find() would have to walk more
+/// than this many items.
+#define LIST_INDEX_MIN_WALK 32
+
+/// Free the item index of a list
+///
+/// Must be called whenever items are added or removed anywhere but at the end.
+/// The next lookup walks the list, so that alternating insert() and indexing
+/// does not rebuild the index every time.
+///
+/// @param[out]  l  List to clear the index of.
+static inline void tv_list_index_clear(list_T *const l)
+  FUNC_ATTR_ALWAYS_INLINE FUNC_ATTR_NONNULL_ALL
+{
+  XFREE_CLEAR(l->lv_items);
+  l->lv_items_size = -1;
+}
+
+/// Build an array with all items of a list, for constant time indexing
+///
+/// It is kept up to date when appending and removing at the end of the list.
+///
+/// @param[out]  l  List to index.
+static void tv_list_index_build(list_T *const l)
+  FUNC_ATTR_NONNULL_ALL
+{
+  assert(l->lv_items == NULL);
+  l->lv_items_size = l->lv_len;
+  l->lv_items = xmalloc((size_t)l->lv_items_size * sizeof(*l->lv_items));
+  int i = 0;
+  for (listitem_T *li = l->lv_first; li != NULL; li = li->li_next) {
+    l->lv_items[i++] = li;
+  }
+  assert(i == l->lv_len);
+}
+
 //{{{2 List item
 
+/// Pool for list items, they are allocated and freed very often.
+static MemPool listitem_pool = MEM_POOL_INIT("listitem", listitem_T);
+
 /// Allocate a list item
 ///
 /// @warning Allocated item is not initialized, do not forget to initialize it
@@ -130,7 +172,7 @@ const char *const tv_empty_string = "";
 static listitem_T *tv_list_item_alloc(void)
   FUNC_ATTR_NONNULL_RET FUNC_ATTR_MALLOC
 {
-  return xmalloc(sizeof(listitem_T));
+  return pool_alloc(&listitem_pool);
 }
 
 /// Remove a list item from a List and free it
@@ -148,7 +190,7 @@ listitem_T *tv_list_item_remove(list_T *const l, listitem_T *const item)
   listitem_T *const next_item = TV_LIST_ITEM_NEXT(l, item);
   tv_list_drop_items(l, item, item);
   tv_clear(TV_LIST_ITEM_TV(item));
-  xfree(item);
+  pool_free(&listitem_pool, item);
   return next_item;
 }
 
@@ -274,11 +316,12 @@ void tv_list_init_static(list_T *const l)
 void tv_list_free_contents(list_T *const l)
   FUNC_ATTR_NONNULL_ALL
 {
+  tv_list_index_clear(l);
   for (listitem_T *item = l->lv_first; item != NULL; item = l->lv_first) {
     // Remove the item before deleting it.
     l->lv_first = item->li_next;
     tv_clear(&item->li_tv);
-    xfree(item);
+    pool_free(&listitem_pool, item);
   }
   l->lv_len = 0;
   l->lv_idx_item = NULL;
@@ -305,6 +348,7 @@ void tv_list_free_list(list_T *const l)
   }
 
   NLUA_CLEAR_REF(l->lua_table_ref);
+  xfree(l->lv_items);
   xfree(l);
 }
 
@@ -332,8 +376,13 @@ void tv_list_free(list_T *const l)
 /// @param[in,out]  l  List to unreference.
 void tv_list_unref(list_T *const l)
 {
-  if (l != NULL && --l->lv_refcount <= 0) {
+  if (l == NULL) {
+    return;
+  }
+  if (--l->lv_refcount <= 0) {
     tv_list_free(l);
+  } else {
+    need_garbage_collect = true;
   }
 }
 
@@ -356,9 +405,11 @@ void tv_list_drop_items(list_T *const l, listitem_T *const item, listitem_T *con
   }
 
   if (item2->li_next == NULL) {
+    // Removing from the end keeps the index valid for the remaining items.
     l->lv_last = item->li_prev;
   } else {
     item2->li_next->li_prev = item->li_prev;
+    tv_list_index_clear(l);
   }
   if (item->li_prev == NULL) {
     l->lv_first = item2->li_next;
@@ -376,7 +427,7 @@ void tv_list_remove_items(list_T *const l, listitem_T *const item, listitem_T *c
   for (listitem_T *li = item;;) {
     tv_clear(TV_LIST_ITEM_TV(li));
     listitem_T *const nli = li->li_next;
-    xfree(li);
+    pool_free(&listitem_pool, li);
     if (li == item2) {
       break;
     }
@@ -396,6 +447,7 @@ void tv_list_move_items(list_T *const l, listitem_T *const item, listitem_T *con
   FUNC_ATTR_NONNULL_ALL
 {
   tv_list_drop_items(l, item, item2);
+  tv_list_index_clear(tgt_l);
   item->li_prev = tgt_l->lv_last;
   item2->li_next = NULL;
   if (tgt_l->lv_last == NULL) {
@@ -432,6 +484,7 @@ void tv_list_insert(list_T *const l, listitem_T *const ni, listitem_T *const ite
     }
     item->li_prev = ni;
     l->lv_len++;
+    tv_list_index_clear(l);
   }
 }
 
@@ -467,6 +520,13 @@ void tv_list_append(list_T *const l, listitem_T *const item)
     item->li_prev = l->lv_last;
     l->lv_last = item;
   }
+  if (l->lv_items != NULL) {
+    if (l->lv_len == l->lv_items_size) {
+      l->lv_items_size = l->lv_items_size * 2 + 1;
+      l->lv_items = xrealloc(l->lv_items, (size_t)l->lv_items_size * sizeof(*l->lv_items));
+    }
+    l->lv_items[l->lv_len] = item;
+  }
   l->lv_len++;
   item->li_next = NULL;
 }
@@ -616,7 +676,7 @@ list_T *tv_list_copy(const vimconv_T *const conv, list_T *const orig, const bool
     if (deep) {
       if (var_item_copy(conv, TV_LIST_ITEM_TV(item), TV_LIST_ITEM_TV(ni),
                         deep, copyID) == FAIL) {
-        xfree(ni);
+        pool_free(&listitem_pool, ni);
         goto tv_list_copy_error;
       }
     } else {
@@ -787,7 +847,7 @@ void tv_list_flatten(list_T *list, listitem_T *first, int64_t maxitems, int64_t
                         itemlist->lv_len, maxdepth - 1);
       }
       tv_clear(&item->li_tv);
-      xfree(item);
+      pool_free(&listitem_pool, item);
     }
 
     done++;
@@ -941,9 +1001,14 @@ int tv_list_slice_or_index(list_T *list, bool range, varnumber_T n1_arg, varnumb
     tv_list_set_ret(rettv, l);
   } else {
     // copy the item to "var1" to avoid that freeing the list makes it
-    // invalid.
+    // invalid.  When nothing else refers to the list the item can be moved.
     typval_T var1;
-    tv_copy(TV_LIST_ITEM_TV(tv_list_find(rettv->vval.v_list, (int)n1)), &var1);
+    typval_T *const item_tv = TV_LIST_ITEM_TV(tv_list_find(rettv->vval.v_list, (int)n1));
+    if (rettv->vval.v_list->lv_refcount == 1) {
+      tv_move(item_tv, &var1);
+    } else {
+      tv_copy(item_tv, &var1);
+    }
     tv_clear(rettv);
     *rettv = var1;
   }
@@ -1118,7 +1183,7 @@ void tv_list_remove(typval_T *argvars, typval_T *rettv, const char *arg_errmsg)
       // Remove one item, return its value.
       tv_list_drop_items(l, item, item);
       *rettv = *TV_LIST_ITEM_TV(item);
-      xfree(item);
+      pool_free(&listitem_pool, item);
     } else {
       listitem_T *item2;
       // Remove range of items, return list with values.
@@ -1320,6 +1385,31 @@ static int item_compare2_not_keeping_zero(const void *s1, const void *s2)
   return item_compare2(s1, s2, false);
 }
 
+/// Check whether item_compare() can compare all items of list "l" in threads:
+/// it must not need to convert items to a string or give an error.
+static bool item_compare_threadsafe(list_T *l, const sortinfo_T *info)
+{
+  if (info->item_compare_func != NULL || info->item_compare_partial != NULL) {
+    return false;
+  }
+  TV_LIST_ITER_CONST(l, li, {
+    const typval_T *const tv = TV_LIST_ITEM_TV(li);
+    if (info->item_compare_numbers) {
+      if (tv->v_type != VAR_NUMBER && tv->v_type != VAR_STRING) {
+        return false;
+      }
+    } else if (info->item_compare_float) {
+      if (tv->v_type != VAR_NUMBER
+          && (tv->v_type != VAR_FLOAT || isnan(tv->vval.v_float))) {
+        return false;
+      }
+    } else if (tv->v_type != VAR_STRING) {
+      return false;
+    }
+  });
+  return true;
+}
+
 /// sort() List "l"
 static void do_sort(list_T *l, sortinfo_T *info)
 {
@@ -1342,14 +1432,20 @@ static void do_sort(list_T *l, sortinfo_T *info)
                                   ? item_compare_not_keeping_zero
                                   : item_compare2_not_keeping_zero);
 
-  // Sort the array with item pointers.
-  qsort(ptrs, (size_t)len, sizeof(ListSortItem), item_compare_func);
+  // Sort the array with item pointers.  Item indexes make all items
+  // different, so sorting in threads gives the same order.
+  if (len >= QSORT_PARALLEL_MIN && item_compare_threadsafe(l, info)) {
+    qsort_parallel(ptrs, (size_t)len, sizeof(ListSortItem), item_compare_func);
+  } else {
+    qsort(ptrs, (size_t)len, sizeof(ListSortItem), item_compare_func);
+  }
   if (!info->item_compare_func_err) {
     // Clear the list and append the items in the sorted order.
     l->lv_first = NULL;
     l->lv_last = NULL;
     l->lv_idx_item = NULL;
     l->lv_len = 0;
+    tv_list_index_clear(l);
     for (i = 0; i < len; i++) {
       tv_list_append(l, ptrs[i].item);
     }
@@ -1573,6 +1669,7 @@ void tv_list_reverse(list_T *const l)
 #undef SWAP
 
   l->lv_idx = l->lv_len - l->lv_idx - 1;
+  tv_list_index_clear(l);
 }
 
 //{{{2 Indexing/searching
@@ -1598,6 +1695,10 @@ listitem_T *tv_list_find(list_T *const l, int n)
     return NULL;
   }
 
+  if (l->lv_items != NULL) {
+    return l->lv_items[n];
+  }
+
   int idx;
   listitem_T *item;
 
@@ -1628,6 +1729,17 @@ listitem_T *tv_list_find(list_T *const l, int n)
     }
   }
 
+  if (abs(n - idx) > LIST_INDEX_MIN_WALK) {
+    if (l->lv_items_size < 0) {
+      l->lv_items_size = 0;
+    } else {
+      // Far from any known item: index the list once instead of walking it
+      // again for every random access.
+      tv_list_index_build(l);
+      return l->lv_items[n];
+    }
+  }
+
   while (n > idx) {
     // Search forward.
     item = item->li_next;
@@ -2205,8 +2317,13 @@ void tv_dict_free(dict_T *const d)
 /// @param[in]  d  Dictionary to operate on.
 void tv_dict_unref(dict_T *const d)
 {
-  if (d != NULL && --d->dv_refcount <= 0) {
+  if (d == NULL) {
+    return;
+  }
+  if (--d->dv_refcount <= 0) {
     tv_dict_free(d);
+  } else {
+    need_garbage_collect = true;
   }
 }
 
@@ -3434,6 +3551,7 @@ static inline int _nothing_conv_func_start(typval_T *const tv, char *const fun)
     partial_T *const pt_ = tv->vval.v_partial;
     if (pt_ != NULL && pt_->pt_refcount > 1) {
       pt_->pt_refcount--;
+      need_garbage_collect = true;
       tv->vval.v_partial = NULL;
       return OK;
     }
@@ -3508,6 +3626,7 @@ static inline int _nothing_conv_real_list_after_start(typval_T *const tv,
   tv->v_lock = VAR_UNLOCKED;
   if (tv->vval.v_list->lv_refcount > 1) {
     tv->vval.v_list->lv_refcount--;
+    need_garbage_collect = true;
     tv->vval.v_list = NULL;
     mpsv->data.l.li = NULL;
     return OK;
@@ -3548,6 +3667,7 @@ static inline int _nothing_conv_real_dict_after_start(typval_T *const tv, dict_T
   }
   if ((const void *)dictp != nodictvar && (*dictp)->dv_refcount > 1) {
     (*dictp)->dv_refcount--;
+    need_garbage_collect = true;
     *dictp = NULL;
     mpsv->data.d.todo = 0;
     return OK;
@@ -3686,6 +3806,22 @@ void tv_free(typval_T *tv)
 
 //{{{3 Copy
 
+/// Move a value out of a container that is about to be freed
+///
+/// Unlike tv_copy() does not allocate a string or change a reference count:
+/// "from" is left holding a Number, so freeing the container keeps the value.
+///
+/// @param[in,out]  from  Location to move from.
+/// @param[out]  to  Location to move to.
+void tv_move(typval_T *const from, typval_T *const to)
+  FUNC_ATTR_NONNULL_ALL
+{
+  *to = *from;
+  to->v_lock = VAR_UNLOCKED;
+  from->v_type = VAR_NUMBER;
+  from->vval.v_number = 0;
+}
+
 /// Copy typval from one location to another
 ///
 /// When needed allocates string or increases reference count. Does not make
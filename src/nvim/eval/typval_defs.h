@@ -185,12 +185,15 @@ struct listvar_S {
   listitem_T *lv_last;  ///< Last item, NULL if none.
   listwatch_T *lv_watch;  ///< First watcher, NULL if none.
   listitem_T *lv_idx_item;  ///< When not NULL item at index "lv_idx".
+  listitem_T **lv_items;  ///< When not NULL all "lv_len" items in order.
   list_T *lv_copylist;  ///< Copied list used by deepcopy().
   list_T *lv_used_next;  ///< next list in used lists list.
   list_T *lv_used_prev;  ///< Previous list in used lists list.
   int lv_refcount;  ///< Reference count.
   int lv_len;  ///< Number of items.
   int lv_idx;  ///< Index of a cached item, used for optimising repeated l[idx].
+  int lv_items_size;  ///< Number of entries allocated for "lv_items", -1 when
+                      ///< the index was just dropped by a change in the middle.
   int lv_copyID;  ///< ID used by deepcopy().
   VarLockStatus lv_lock;  ///< Zero, VAR_LOCKED, VAR_FIXED.
 
@@ -320,6 +323,14 @@ struct funccall_S {
   garray_T fc_ufuncs;                ///< List of ufunc_T* which keep a reference to "fc_func".
 };
 
+/// Built-in command found at the start of a function line, see
+/// find_ex_command_cached().
+typedef struct {
+  int cmd_off;   ///< offset of the command name in the line, -1 if not known
+  int name_len;  ///< length of the command name
+  int cmdidx;    ///< cmdidx_T of the command
+} FuncLineCmd;
+
 /// Structure to hold info for a user function.
 struct ufunc {
   int uf_varargs;       ///< variable nr of arguments
@@ -329,6 +340,7 @@ struct ufunc {
   garray_T uf_args;          ///< arguments
   garray_T uf_def_args;      ///< default argument expressions
   garray_T uf_lines;         ///< function lines
+  FuncLineCmd *uf_line_cmds;  ///< commands found in uf_lines, or NULL
   int uf_profiling;     ///< true when func is being profiled
   int uf_prof_initialized;
   LuaRef uf_luaref;      ///< lua callback, used if (uf_flags & FC_LUAREF)
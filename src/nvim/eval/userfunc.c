@@ -79,6 +79,14 @@ static funccall_T *current_funccal = NULL;
 // item in it is still being used.
 static funccall_T *previous_funccal = NULL;
 
+/// Number of freed funccall_T kept for reuse.
+#define FUNCCAL_POOL_SIZE 16
+
+// Freed funccall_T structs, reused by create_funccal() to avoid an
+// allocation for every function call.
+static funccall_T *funccal_pool[FUNCCAL_POOL_SIZE];
+static int funccal_pool_len = 0;
+
 static const char *e_funcexts = N_("E122: Function %s already exists, add ! to replace it");
 static const char *e_funcdict = N_("E717: Dictionary entry already exists");
 static const char *e_funcref = N_("E718: Funcref required");
@@ -769,7 +777,11 @@ static void free_funccal(funccall_T *fc)
   ga_clear(&fc->fc_ufuncs);
 
   func_ptr_unref(fc->fc_func);
-  xfree(fc);
+  if (funccal_pool_len < FUNCCAL_POOL_SIZE) {
+    funccal_pool[funccal_pool_len++] = fc;
+  } else {
+    xfree(fc);
+  }
 }
 
 /// Free "fc" and what it contains.
@@ -843,6 +855,7 @@ static void cleanup_function_call(funccall_T *fc)
     // Link "fc" in the list for garbage collection later.
     fc->fc_caller = previous_funccal;
     previous_funccal = fc;
+    need_garbage_collect = true;
 
     if (want_garbage_collect) {
       // If garbage collector is ready, clear count.
@@ -869,6 +882,7 @@ static void funccal_unref(funccall_T *fc, ufunc_T *fp, bool force)
   }
 
   fc->fc_refcount--;
+  need_garbage_collect = true;
   if (force ? fc->fc_refcount <= 0 : !fc_referenced(fc)) {
     for (funccall_T **pfc = &previous_funccal; *pfc != NULL; pfc = &(*pfc)->fc_caller) {
       if (fc == *pfc) {
@@ -905,6 +919,7 @@ static void func_clear_items(ufunc_T *fp)
   ga_clear_strings(&(fp->uf_args));
   ga_clear_strings(&(fp->uf_def_args));
   ga_clear_strings(&(fp->uf_lines));
+  XFREE_CLEAR(fp->uf_line_cmds);
 
   if (fp->uf_flags & FC_LUAREF) {
     api_free_luaref(fp->uf_luaref);
@@ -961,7 +976,9 @@ static void func_clear_free(ufunc_T *fp, bool force)
 /// Must be followed by one call to remove_funccal() or cleanup_function_call().
 funccall_T *create_funccal(ufunc_T *fp, typval_T *rettv)
 {
-  funccall_T *fc = xcalloc(1, sizeof(funccall_T));
+  funccall_T *fc = funccal_pool_len > 0
+                    ? memset(funccal_pool[--funccal_pool_len], 0, sizeof(funccall_T))
+                    : xcalloc(1, sizeof(funccall_T));
   fc->fc_caller = current_funccal;
   current_funccal = fc;
   fc->fc_func = fp;
@@ -1518,6 +1535,10 @@ void free_all_functions(void)
   if (skipped == 0) {
     hash_clear(&func_hashtab);
   }
+
+  while (funccal_pool_len > 0) {
+    xfree(funccal_pool[--funccal_pool_len]);
+  }
 }
 
 #endif
@@ -2953,6 +2974,7 @@ void ex_function(exarg_T *eap)
   fp->uf_args = newargs;
   fp->uf_def_args = default_args;
   fp->uf_lines = newlines;
+  XFREE_CLEAR(fp->uf_line_cmds);
   if ((flags & FC_CLOSURE) != 0) {
     register_closure(fp);
   } else {
@@ -3210,12 +3232,17 @@ void func_unref(char *name)
 /// @param  fp  Function to unreference.
 void func_ptr_unref(ufunc_T *fp)
 {
-  if (fp != NULL && --fp->uf_refcount <= 0) {
+  if (fp == NULL) {
+    return;
+  }
+  if (--fp->uf_refcount <= 0) {
     // Only delete it when it's not being used. Otherwise it's done
     // when "uf_calls" becomes zero.
     if (fp->uf_calls == 0) {
       func_clear_free(fp, false);
     }
+  } else {
+    need_garbage_collect = true;
   }
 }
 
@@ -3734,6 +3761,7 @@ char *get_func_line(int c, void *cookie, int indent, bool do_concat)
   }
 
   garray_T *gap = &fp->uf_lines;  // growarray with function lines
+  FuncLineCmd *line_cmd = NULL;
   if (((fp->uf_flags & FC_ABORT) && did_emsg && !aborted_in_try())
       || fcp->fc_returned) {
     retval = NULL;
@@ -3746,6 +3774,13 @@ char *get_func_line(int c, void *cookie, int indent, bool do_concat)
     if (fcp->fc_linenr >= gap->ga_len) {
       retval = NULL;
     } else {
+      if (fp->uf_line_cmds == NULL) {
+        fp->uf_line_cmds = xmalloc((size_t)gap->ga_len * sizeof(*fp->uf_line_cmds));
+        for (int i = 0; i < gap->ga_len; i++) {
+          fp->uf_line_cmds[i].cmd_off = -1;
+        }
+      }
+      line_cmd = &fp->uf_line_cmds[fcp->fc_linenr];
       retval = xstrdup(((char **)(gap->ga_data))[fcp->fc_linenr++]);
       SOURCING_LNUM = fcp->fc_linenr;
       if (do_profiling == PROF_YES) {
@@ -3762,6 +3797,8 @@ char *get_func_line(int c, void *cookie, int indent, bool do_concat)
     fcp->fc_dbg_tick = debug_tick;
   }
 
+  // Set last, the breakpoint may have executed other lines.
+  getline_set_line_cmd(line_cmd);
   return retval;
 }
 
@@ -6,10 +6,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer.h"
 #include "nvim/cursor.h"
+#include "nvim/drawscreen.h"
 #include "nvim/errors.h"
 #include "nvim/eval/funcs.h"
 #include "nvim/eval/typval.h"
@@ -21,6 +23,7 @@
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -106,16 +109,15 @@ win_T *win_id2wp(int id)
 /// Returns NULL when not found.
 win_T *win_id2wp_tp(int id, tabpage_T **tpp)
 {
-  FOR_ALL_TAB_WINDOWS(tp, wp) {
-    if (wp->handle == id) {
-      if (tpp != NULL) {
-        *tpp = tp;
-      }
-      return wp;
-    }
+  // Windows are in "window_handles" while they are in a window list.  Only
+  // search the tab pages when the tab page is wanted.
+  win_T *wp = handle_get_window(id);
+  if (wp == NULL || tpp == NULL) {
+    return wp;
   }
 
-  return NULL;
+  *tpp = win_find_tabpage(wp);
+  return *tpp != NULL ? wp : NULL;
 }
 
 static int win_id2win(typval_T *argvars)
@@ -545,7 +547,7 @@ void win_execute_after(win_execute_T *args)
 
   // Update the status line if the cursor moved.
   if (win_valid(args->wp) && !equalpos(args->curpos, args->wp->w_cursor)) {
-    args->wp->w_redr_status = true;
+    status_redraw_win(args->wp);
   }
 
   // In case the command moved the cursor or changed the Visual area,
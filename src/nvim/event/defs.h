@@ -44,6 +44,17 @@ struct time_watcher {
   bool blockable;
 };
 
+typedef struct fs_watcher FsWatcher;
+typedef void (*fs_watcher_cb)(FsWatcher *watcher, void *data);
+
+/// Watches one file for changes, see fs_watcher_start().
+struct fs_watcher {
+  uv_fs_event_t uv;
+  char *path;  ///< File being watched.
+  void *data;
+  fs_watcher_cb cb;
+};
+
 typedef struct wbuffer WBuffer;
 typedef void (*wbuffer_data_finalizer)(void *data);
 
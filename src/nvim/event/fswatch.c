@@ -0,0 +1,104 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <uv.h>
+
+#include "nvim/event/defs.h"
+#include "nvim/event/fswatch.h"
+#include "nvim/event/loop.h"
+#include "nvim/memory.h"
+#include "nvim/types_defs.h"
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "event/fswatch.c.generated.h"
+#endif
+
+/// Checks whether changes to "path" by anyone are reported by the kernel as
+/// soon as they happen. On network file systems only local changes would be
+/// seen, and elsewhere the notifications may arrive late.
+static bool fs_watcher_reliable(Loop *loop, const char *path)
+{
+#ifdef __linux__
+  uv_fs_t req;
+  if (uv_fs_statfs(&loop->uv, &req, path, NULL) != 0) {
+    uv_fs_req_cleanup(&req);
+    return false;
+  }
+  uint64_t f_type = ((uv_statfs_t *)req.ptr)->f_type;
+  uv_fs_req_cleanup(&req);
+  switch (f_type) {
+  case 0x6969:  // NFS
+  case 0x517B:  // SMB
+  case 0xFE534D42:  // SMB2
+  case 0xFF534D42:  // CIFS
+  case 0x65735546:  // FUSE
+  case 0x01021997:  // 9P
+  case 0x5346414F:  // AFS
+  case 0x00C36400:  // Ceph
+    return false;
+  default:
+    return true;
+  }
+#elif defined(MSWIN)
+  // ReadDirectoryChangesW() reports changes asynchronously.
+  (void)loop;
+  (void)path;
+  return false;
+#else
+  // kqueue (also used for files on macOS) reports changes synchronously.
+  (void)loop;
+  (void)path;
+  return true;
+#endif
+}
+
+/// Starts watching the file "path". "cb" is called directly from the libuv
+/// callback when the file was changed, renamed or deleted, it should only take
+/// note of that.
+///
+/// @returns NULL if the file cannot be watched reliably, see
+///          fs_watcher_reliable().
+FsWatcher *fs_watcher_start(Loop *loop, const char *path, fs_watcher_cb cb, void *data)
+  FUNC_ATTR_NONNULL_ARG(1, 2, 3)
+{
+  if (!fs_watcher_reliable(loop, path)) {
+    return NULL;
+  }
+
+  FsWatcher *watcher = xmalloc(sizeof(*watcher));
+  uv_fs_event_init(&loop->uv, &watcher->uv);
+  watcher->uv.data = watcher;
+  watcher->path = xstrdup(path);
+  watcher->data = data;
+  watcher->cb = cb;
+  if (uv_fs_event_start(&watcher->uv, fs_watcher_event_cb, path, 0) != 0) {
+    // For example when the inotify watch limit was reached.
+    fs_watcher_stop(watcher);
+    return NULL;
+  }
+  return watcher;
+}
+
+/// Stops watching and frees "watcher" (once libuv is done with it).
+void fs_watcher_stop(FsWatcher *watcher)
+  FUNC_ATTR_NONNULL_ALL
+{
+  watcher->cb = NULL;
+  uv_close((uv_handle_t *)&watcher->uv, fs_watcher_close_cb);
+}
+
+static void fs_watcher_event_cb(uv_fs_event_t *handle, const char *filename, int events,
+                                int status)
+{
+  FsWatcher *watcher = handle->data;
+  if (watcher->cb) {
+    watcher->cb(watcher, watcher->data);
+  }
+}
+
+static void fs_watcher_close_cb(uv_handle_t *handle)
+{
+  FsWatcher *watcher = handle->data;
+  xfree(watcher->path);
+  xfree(watcher);
+}
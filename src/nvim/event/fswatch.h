@@ -0,0 +1,8 @@
+#pragma once
+
+#include "nvim/event/defs.h"  // IWYU pragma: keep
+#include "nvim/types_defs.h"  // IWYU pragma: keep
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "event/fswatch.h.generated.h"
+#endif
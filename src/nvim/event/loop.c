@@ -10,6 +10,12 @@
 #include "nvim/os/time.h"
 #include "nvim/types_defs.h"
 
+typedef struct thread_event ThreadEvent;
+struct thread_event {
+  ThreadEvent *next;
+  Event event;
+};
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "event/loop.c.generated.h"
 #endif
@@ -23,8 +29,8 @@ void loop_init(Loop *loop, void *data)
   kv_init(loop->children);
   loop->events = multiqueue_new(loop_on_put, loop);
   loop->fast_events = multiqueue_new_child(loop->events);
-  loop->thread_events = multiqueue_new(NULL, NULL);
-  uv_mutex_init(&loop->mutex);
+  loop->thread_events = NULL;
+  loop->thread_events_count = 0;
   uv_async_init(&loop->uv, &loop->async, async_cb);
   uv_signal_init(&loop->uv, &loop->children_watcher);
   uv_timer_init(&loop->uv, &loop->children_kill_timer);
@@ -86,6 +92,11 @@ bool loop_poll_events(Loop *loop, int64_t ms)
 
 /// Schedules a fast event from another thread.
 ///
+/// This takes no lock, so many threads can schedule many events without
+/// waiting on each other or on the loop thread. Only the thread whose event
+/// makes the list non-empty wakes up the loop, which then takes all events
+/// scheduled until then in one go.
+///
 /// @note Event is queued into `fast_events`, which is processed outside of the
 ///       primary `events` queue by loop_poll_events(). For `main_loop`, that
 ///       means `fast_events` is NOT processed in an "editor mode"
@@ -94,10 +105,19 @@ bool loop_poll_events(Loop *loop, int64_t ms)
 /// @see loop_schedule_deferred
 void loop_schedule_fast(Loop *loop, Event event)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_put_event(loop->thread_events, event);
-  uv_async_send(&loop->async);
-  uv_mutex_unlock(&loop->mutex);
+  ThreadEvent *node = xmalloc(sizeof(*node));
+  node->event = event;
+  // Counted first, so that loop_size() never sees the count go below zero.
+  atomic_add_size(&loop->thread_events_count, 1);
+  ThreadEvent *head = NULL;  // Updated by a failed atomic_cas_event().
+  do {
+    node->next = head;
+  } while (!atomic_cas_event(&loop->thread_events, &head, node));
+  if (head == NULL) {
+    // Otherwise the thread which pushed "head" sends the wakeup, for which the
+    // loop has not taken the events yet.
+    uv_async_send(&loop->async);
+  }
 }
 
 /// Schedules an event from another thread. Unlike loop_schedule_fast(), the
@@ -148,7 +168,6 @@ bool loop_close(Loop *loop, bool wait)
 {
   bool rv = true;
   loop->closing = true;
-  uv_mutex_destroy(&loop->mutex);
   uv_close((uv_handle_t *)&loop->children_watcher, NULL);
   uv_close((uv_handle_t *)&loop->children_kill_timer, NULL);
   uv_close((uv_handle_t *)&loop->poll_timer, timer_close_cb);
@@ -185,7 +204,7 @@ bool loop_close(Loop *loop, bool wait)
 #endif
   }
   multiqueue_free(loop->fast_events);
-  multiqueue_free(loop->thread_events);
+  thread_events_free(take_thread_events(loop));
   multiqueue_free(loop->events);
   kv_destroy(loop->children);
   return rv;
@@ -193,27 +212,93 @@ bool loop_close(Loop *loop, bool wait)
 
 void loop_purge(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_purge_events(loop->thread_events);
+  thread_events_free(take_thread_events(loop));
   multiqueue_purge_events(loop->fast_events);
-  uv_mutex_unlock(&loop->mutex);
 }
 
+/// Gets the number of events scheduled from other threads, which the loop did
+/// not take yet.
 size_t loop_size(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  size_t rv = multiqueue_size(loop->thread_events);
-  uv_mutex_unlock(&loop->mutex);
-  return rv;
+  return atomic_add_size(&loop->thread_events_count, 0);
+}
+
+/// Takes all events scheduled from other threads, in the order they were
+/// scheduled.
+static ThreadEvent *take_thread_events(Loop *loop)
+{
+  ThreadEvent *node = atomic_take_events(&loop->thread_events);
+  // Reverse the list: it was pushed newest first.
+  ThreadEvent *list = NULL;
+  size_t count = 0;
+  while (node != NULL) {
+    ThreadEvent *next = node->next;
+    node->next = list;
+    list = node;
+    node = next;
+    count++;
+  }
+  atomic_add_size(&loop->thread_events_count, (size_t)0 - count);
+  return list;
+}
+
+/// Replaces "*head" with "node" if it is still "*expected" (release), else
+/// updates "*expected".
+static inline bool atomic_cas_event(ThreadEvent **head, ThreadEvent **expected, ThreadEvent *node)
+{
+#ifdef _MSC_VER
+  ThreadEvent *prev = InterlockedCompareExchangePointer((PVOID volatile *)head, node, *expected);
+  if (prev == *expected) {
+    return true;
+  }
+  *expected = prev;
+  return false;
+#else
+  return __atomic_compare_exchange_n(head, expected, node, false, __ATOMIC_RELEASE,
+                                     __ATOMIC_RELAXED);
+#endif
+}
+
+/// Replaces "*head" with NULL (acquire) and returns the old value.
+static inline ThreadEvent *atomic_take_events(ThreadEvent **head)
+{
+#ifdef _MSC_VER
+  return InterlockedExchangePointer((PVOID volatile *)head, NULL);
+#else
+  return __atomic_exchange_n(head, NULL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/// Adds "n" to "*ptr" and returns the new value.
+static inline size_t atomic_add_size(size_t *ptr, size_t n)
+{
+#ifdef _MSC_VER
+  return InterlockedExchangeAddSizeT(ptr, n) + n;
+#else
+  return __atomic_add_fetch(ptr, n, __ATOMIC_RELAXED);
+#endif
+}
+
+static void thread_events_free(ThreadEvent *list)
+{
+  while (list != NULL) {
+    ThreadEvent *next = list->next;
+    xfree(list);
+    list = next;
+  }
 }
 
 static void async_cb(uv_async_t *handle)
 {
   Loop *l = handle->loop->data;
-  uv_mutex_lock(&l->mutex);
   // Flush thread_events to fast_events for processing on main loop.
-  multiqueue_move_events(l->fast_events, l->thread_events);
-  uv_mutex_unlock(&l->mutex);
+  ThreadEvent *list = take_thread_events(l);
+  while (list != NULL) {
+    ThreadEvent *next = list->next;
+    multiqueue_put_event(l->fast_events, list->event);
+    xfree(list);
+    list = next;
+  }
 }
 
 static void timer_cb(uv_timer_t *handle)
@@ -10,7 +10,10 @@
 struct loop {
   uv_loop_t uv;
   MultiQueue *events;
-  MultiQueue *thread_events;
+  // Events scheduled from other threads, newest first. Pushed without a lock
+  // and taken all at once by the loop thread, see loop_schedule_fast().
+  struct thread_event *thread_events;
+  size_t thread_events_count;
   // Immediate events.
   // - "Processed after exiting `uv_run()` (to avoid recursion), but before returning from
   //   `loop_poll_events()`." 502aee690c98
@@ -32,7 +35,6 @@ struct loop {
   uv_timer_t exit_delay_timer;
 
   uv_async_t async;
-  uv_mutex_t mutex;
   int recursive;
   bool closing;  ///< Set to true if loop_close() has been called
 };
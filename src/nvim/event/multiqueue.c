@@ -41,6 +41,11 @@
 // the event loop queue and poll job1 queue instead. Same with channels, when
 // calling `rpcrequest` we want to temporarily stop processing events from
 // other sources and focus on a specific channel.
+//
+// A child queue can be given background priority with `multiqueue_set_background`:
+// its link nodes are kept in a separate list of the parent, and the parent only
+// takes them when there is no other event, or after MULTIQUEUE_BG_MAX_SKIP other
+// events were taken while one was waiting, so that it cannot be starved.
 
 #include <assert.h>
 #include <stdbool.h>
@@ -51,6 +56,8 @@
 #include "nvim/lib/queue_defs.h"
 #include "nvim/memory.h"
 
+#define MULTIQUEUE_BG_MAX_SKIP 8
+
 typedef struct multiqueue_item MultiQueueItem;
 struct multiqueue_item {
   union {
@@ -67,6 +74,9 @@ struct multiqueue_item {
 struct multiqueue {
   MultiQueue *parent;
   QUEUE headtail;  // circularly-linked
+  QUEUE bg_headtail;  // links to child queues with background priority
+  int bg_skipped;  // events taken while a background event was waiting
+  bool background;  // child queue with background priority
   PutCallback on_put;  // Called on the parent (if any) when an item is enqueued in a child.
   void *data;
   size_t size;
@@ -103,6 +113,9 @@ static MultiQueue *_multiqueue_new(MultiQueue *parent, PutCallback on_put, void
 {
   MultiQueue *rv = xmalloc(sizeof(MultiQueue));
   QUEUE_INIT(&rv->headtail);
+  QUEUE_INIT(&rv->bg_headtail);
+  rv->bg_skipped = 0;
+  rv->background = false;
   rv->size = 0;
   rv->parent = parent;
   rv->on_put = on_put;
@@ -123,6 +136,10 @@ void multiqueue_free(MultiQueue *self)
     QUEUE_REMOVE(q);
     xfree(item);
   })
+  QUEUE_FOREACH(q, &self->bg_headtail, {
+    QUEUE_REMOVE(q);
+    xfree(multiqueue_node_data(q));
+  })
 
   xfree(self);
 }
@@ -175,7 +192,15 @@ void multiqueue_purge_events(MultiQueue *self)
 bool multiqueue_empty(MultiQueue *self)
 {
   assert(self);
-  return QUEUE_EMPTY(&self->headtail);
+  return QUEUE_EMPTY(&self->headtail) && QUEUE_EMPTY(&self->bg_headtail);
+}
+
+/// Sets if the events of child queue `self` have background priority in its
+/// parent, i.e. other events of the parent are taken first.
+void multiqueue_set_background(MultiQueue *self, bool background)
+{
+  assert(self->parent && multiqueue_empty(self));
+  self->background = background;
 }
 
 void multiqueue_replace_parent(MultiQueue *self, MultiQueue *new_parent)
@@ -221,10 +246,25 @@ static Event multiqueueitem_get_event(MultiQueueItem *item, bool remove)
   return ev;
 }
 
+/// Gets the node to be removed next from non-empty queue `self`.
+static QUEUE *multiqueue_head(MultiQueue *self)
+{
+  if (QUEUE_EMPTY(&self->bg_headtail)) {
+    self->bg_skipped = 0;
+    return QUEUE_HEAD(&self->headtail);
+  }
+  if (QUEUE_EMPTY(&self->headtail) || self->bg_skipped >= MULTIQUEUE_BG_MAX_SKIP) {
+    self->bg_skipped = 0;
+    return QUEUE_HEAD(&self->bg_headtail);
+  }
+  self->bg_skipped++;
+  return QUEUE_HEAD(&self->headtail);
+}
+
 static Event multiqueue_remove(MultiQueue *self)
 {
   assert(!multiqueue_empty(self));
-  QUEUE *h = QUEUE_HEAD(&self->headtail);
+  QUEUE *h = multiqueue_head(self);
   QUEUE_REMOVE(h);
   MultiQueueItem *item = multiqueue_node_data(h);
   assert(!item->link || !self->parent);  // Only a parent queue has link-nodes
@@ -246,7 +286,7 @@ static void multiqueue_push(MultiQueue *self, Event event)
     item->data.item.parent_item = xmalloc(sizeof(MultiQueueItem));
     item->data.item.parent_item->link = true;
     item->data.item.parent_item->data.queue = self;
-    QUEUE_INSERT_TAIL(&self->parent->headtail,
+    QUEUE_INSERT_TAIL(self->background ? &self->parent->bg_headtail : &self->parent->headtail,
                       &item->data.item.parent_item->node);
   }
   self->size++;
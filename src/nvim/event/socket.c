@@ -25,6 +25,10 @@
 # include "event/socket.c.generated.h"
 #endif
 
+// Kernel buffer size for local sockets: large enough for a full screen redraw
+// of a big grid, so that it is written without waiting for the peer.
+#define LOCAL_SOCKET_BUFSIZE (512 * 1024)
+
 int socket_watcher_init(Loop *loop, SocketWatcher *watcher, const char *endpoint)
   FUNC_ATTR_NONNULL_ALL
 {
@@ -156,10 +160,33 @@ int socket_watcher_accept(SocketWatcher *watcher, RStream *stream)
     return result;
   }
 
+  if (client->type == UV_NAMED_PIPE) {
+    local_socket_buffers((uv_handle_t *)client);
+  }
+
   stream_init(NULL, &stream->s, -1, client);
   return 0;
 }
 
+/// Grows the kernel buffers of a local socket to LOCAL_SOCKET_BUFSIZE.
+///
+/// The defaults are small enough that a redraw of a large screen needs several
+/// round trips through the event loops of both ends. Failure is not an error,
+/// the defaults still work (named pipes on Windows do not support this).
+static void local_socket_buffers(uv_handle_t *handle)
+{
+  int size = 0;
+  if (uv_send_buffer_size(handle, &size) == 0 && size < LOCAL_SOCKET_BUFSIZE) {
+    size = LOCAL_SOCKET_BUFSIZE;
+    uv_send_buffer_size(handle, &size);
+  }
+  size = 0;
+  if (uv_recv_buffer_size(handle, &size) == 0 && size < LOCAL_SOCKET_BUFSIZE) {
+    size = LOCAL_SOCKET_BUFSIZE;
+    uv_recv_buffer_size(handle, &size);
+  }
+}
+
 void socket_watcher_close(SocketWatcher *watcher, socket_close_cb cb)
   FUNC_ATTR_NONNULL_ARG(1)
 {
@@ -245,6 +272,9 @@ tcp_retry:
   status = 1;
   LOOP_PROCESS_EVENTS_UNTIL(&main_loop, NULL, timeout, status != 1);
   if (status == 0) {
+    if (!is_tcp) {
+      local_socket_buffers((uv_handle_t *)uv_stream);
+    }
     stream_init(NULL, &stream->s, -1, uv_stream);
     success = true;
   } else if (is_tcp && addrinfo->ai_next) {
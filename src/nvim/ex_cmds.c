@@ -346,10 +346,9 @@ static int linelen(int *has_tab)
   return len;
 }
 
-// Buffer for two lines used during sorting.  They are allocated to
-// contain the longest line being sorted.
+// Buffer for the previous line used by ":uniq".  It is allocated to contain
+// the longest line.
 static char *sortbuf1;
-static char *sortbuf2;
 
 static bool sort_lc;      ///< sort using locale
 static bool sort_ic;      ///< ignore case
@@ -359,13 +358,18 @@ static bool sort_flt;     ///< sort on floating number
 
 static bool sort_abort;   ///< flag to indicate if sorting has been interrupted
 
+/// Copy of all the lines being sorted and of the text to sort on, each NUL
+/// terminated.  The lines can then be compared without ml_get() and written
+/// back in place.
+static char *sort_text;
+
 /// Struct to store info to be sorted.
 typedef struct {
   linenr_T lnum;          ///< line number
+  size_t text_off;        ///< offset of the line in "sort_text"
   union {
     struct {
-      varnumber_T start_col_nr;  ///< starting column number
-      varnumber_T end_col_nr;    ///< ending column number
+      size_t key_off;       ///< offset of the text to sort on in "sort_text"
     } line;
     struct {
       varnumber_T value;         ///< value if sorting by integer
@@ -383,25 +387,14 @@ static int string_compare(const void *s1, const void *s2) FUNC_ATTR_NONNULL_ALL
   return sort_ic ? STRICMP(s1, s2) : strcmp(s1, s2);
 }
 
-static int sort_compare(const void *s1, const void *s2)
+/// Compare two lines for ":sort" without checking for an interrupt, so that
+/// this can be used by qsort_parallel().
+static int sort_compare_lines(const void *s1, const void *s2)
 {
   sorti_T l1 = *(sorti_T *)s1;
   sorti_T l2 = *(sorti_T *)s2;
   int result = 0;
 
-  // If the user interrupts, there's no way to stop qsort() immediately, but
-  // if we return 0 every time, qsort will assume it's done sorting and
-  // exit.
-  if (sort_abort) {
-    return 0;
-  }
-  fast_breakcheck();
-  if (got_int) {
-    sort_abort = true;
-  }
-
-  // When sorting numbers "start_col_nr" is the number, not the column
-  // number.
   if (sort_nr) {
     if (l1.st_u.num.is_number != l2.st_u.num.is_number) {
       result = l1.st_u.num.is_number > l2.st_u.num.is_number ? 1 : -1;
@@ -415,17 +408,8 @@ static int sort_compare(const void *s1, const void *s2)
              ? 0
              : l1.st_u.value_flt > l2.st_u.value_flt ? 1 : -1;
   } else {
-    // We need to copy one line into "sortbuf1", because there is no
-    // guarantee that the first pointer becomes invalid when obtaining the
-    // second one.
-    memcpy(sortbuf1, ml_get(l1.lnum) + l1.st_u.line.start_col_nr,
-           (size_t)(l1.st_u.line.end_col_nr - l1.st_u.line.start_col_nr + 1));
-    sortbuf1[l1.st_u.line.end_col_nr - l1.st_u.line.start_col_nr] = NUL;
-    memcpy(sortbuf2, ml_get(l2.lnum) + l2.st_u.line.start_col_nr,
-           (size_t)(l2.st_u.line.end_col_nr - l2.st_u.line.start_col_nr + 1));
-    sortbuf2[l2.st_u.line.end_col_nr - l2.st_u.line.start_col_nr] = NUL;
-
-    result = string_compare(sortbuf1, sortbuf2);
+    result = string_compare(sort_text + l1.st_u.line.key_off,
+                            sort_text + l2.st_u.line.key_off);
   }
 
   // If two lines have the same value, preserve the original line order.
@@ -435,11 +419,92 @@ static int sort_compare(const void *s1, const void *s2)
   return result;
 }
 
+static int sort_compare(const void *s1, const void *s2)
+{
+  // If the user interrupts, there's no way to stop qsort() immediately, but
+  // if we return 0 every time, qsort will assume it's done sorting and
+  // exit.
+  if (sort_abort) {
+    return 0;
+  }
+  fast_breakcheck();
+  if (got_int) {
+    sort_abort = true;
+  }
+
+  return sort_compare_lines(s1, s2);
+}
+
+/// Key of a line for sort_radix(): unsigned numbers that compare like
+/// sort_compare_lines() compares the numbers or floats.
+typedef struct {
+  uint64_t key;
+  size_t idx;               ///< index in the array being sorted
+} sort_radix_T;
+
+/// Sort "nrs" on the number or float of each line with a stable LSD radix
+/// sort, in the same order as sort_compare_lines() gives.  Not for NaN.
+static void sort_radix(sorti_T *nrs, size_t count)
+{
+  sort_radix_T *keys = xmalloc(count * sizeof(*keys));
+  sort_radix_T *tmp = xmalloc(count * sizeof(*keys));
+  size_t nkeys = 0;
+  size_t nonum = 0;
+
+  // Lines without a number go first, in their original order.
+  sorti_T *const orig = xmemdup(nrs, count * sizeof(*nrs));
+  for (size_t i = 0; i < count; i++) {
+    uint64_t key;
+    if (sort_nr) {
+      if (!orig[i].st_u.num.is_number) {
+        nrs[nonum++] = orig[i];
+        continue;
+      }
+      key = (uint64_t)orig[i].st_u.num.value ^ ((uint64_t)1 << 63);
+    } else {
+      // -0.0 and 0.0 are equal.
+      float_T f = orig[i].st_u.value_flt == 0 ? 0 : orig[i].st_u.value_flt;
+      memcpy(&key, &f, sizeof(key));
+      key = (key >> 63) ? ~key : key | ((uint64_t)1 << 63);
+    }
+    keys[nkeys++] = (sort_radix_T){ .key = key, .idx = i };
+  }
+
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t counts[256] = { 0 };
+    for (size_t i = 0; i < nkeys; i++) {
+      counts[(keys[i].key >> shift) & 0xff]++;
+    }
+    // Skip a byte that is the same in all keys.
+    if (nkeys == 0 || counts[(keys[0].key >> shift) & 0xff] == nkeys) {
+      continue;
+    }
+    size_t pos = 0;
+    for (int b = 0; b < 256; b++) {
+      size_t c = counts[b];
+      counts[b] = pos;
+      pos += c;
+    }
+    for (size_t i = 0; i < nkeys; i++) {
+      tmp[counts[(keys[i].key >> shift) & 0xff]++] = keys[i];
+    }
+    sort_radix_T *swap = keys;
+    keys = tmp;
+    tmp = swap;
+  }
+
+  for (size_t i = 0; i < nkeys; i++) {
+    nrs[nonum + i] = orig[keys[i].idx];
+  }
+  xfree(orig);
+  xfree(keys);
+  xfree(tmp);
+}
+
 /// ":sort".
 void ex_sort(exarg_T *eap)
 {
   regmatch_T regmatch;
-  int maxlen = 0;
   size_t count = (size_t)(eap->line2 - eap->line1) + 1;
   size_t i;
   bool unique = false;
@@ -453,8 +518,8 @@ void ex_sort(exarg_T *eap)
   if (u_save((linenr_T)(eap->line1 - 1), (linenr_T)(eap->line2 + 1)) == FAIL) {
     return;
   }
-  sortbuf1 = NULL;
-  sortbuf2 = NULL;
+  StringBuilder text = KV_INITIAL_VALUE;
+  bool has_nan = false;
   regmatch.regprog = NULL;
   sorti_T *nrs = xmalloc(count * sizeof(sorti_T));
 
@@ -530,16 +595,15 @@ void ex_sort(exarg_T *eap)
   // sorting.
   sort_nr |= sort_what;
 
-  // Make an array with all line numbers.  This avoids having to copy all
-  // the lines into allocated memory.
-  // When sorting on strings "start_col_nr" is the offset in the line, for
-  // numbers sorting it's the number to sort on.  This means the pattern
+  // Make an array with all line numbers and copy the lines.
+  // When sorting on strings the text to sort on is also copied, for numbers
+  // sorting the number to sort on is stored.  This means the pattern
   // matching and number conversion only has to be done once per line.
-  // Also get the longest line length for allocating "sortbuf".
   for (linenr_T lnum = eap->line1; lnum <= eap->line2; lnum++) {
     char *s = ml_get(lnum);
     int len = ml_get_len(lnum);
-    maxlen = MAX(maxlen, len);
+    nrs[lnum - eap->line1].text_off = kv_size(text);
+    kv_concat_len(text, s, (size_t)len + 1);
 
     colnr_T start_col = 0;
     colnr_T end_col = len;
@@ -593,13 +657,18 @@ void ex_sort(exarg_T *eap)
           nrs[lnum - eap->line1].st_u.value_flt = -DBL_MAX;
         } else {
           nrs[lnum - eap->line1].st_u.value_flt = strtod(s, NULL);
+          has_nan |= isnan(nrs[lnum - eap->line1].st_u.value_flt);
         }
       }
       *s2 = c;
+    } else if (end_col == len) {
+      // The copied line ends where the text to sort on ends.
+      nrs[lnum - eap->line1].st_u.line.key_off = nrs[lnum - eap->line1].text_off
+                                                 + (size_t)start_col;
     } else {
-      // Store the column to sort at.
-      nrs[lnum - eap->line1].st_u.line.start_col_nr = start_col;
-      nrs[lnum - eap->line1].st_u.line.end_col_nr = end_col;
+      nrs[lnum - eap->line1].st_u.line.key_off = kv_size(text);
+      kv_concat_len(text, s + start_col, (size_t)(end_col - start_col));
+      kv_push(text, NUL);
     }
 
     nrs[lnum - eap->line1].lnum = lnum;
@@ -612,12 +681,16 @@ void ex_sort(exarg_T *eap)
     }
   }
 
-  // Allocate a buffer that can hold the longest line.
-  sortbuf1 = xmalloc((size_t)maxlen + 1);
-  sortbuf2 = xmalloc((size_t)maxlen + 1);
+  sort_text = text.items;
 
   // Sort the array of line numbers.  Note: can't be interrupted!
-  qsort((void *)nrs, count, sizeof(sorti_T), sort_compare);
+  if ((sort_nr || sort_flt) && !has_nan) {
+    sort_radix(nrs, count);
+  } else if (!sort_nr && !sort_flt && count >= QSORT_PARALLEL_MIN) {
+    qsort_parallel(nrs, count, sizeof(sorti_T), sort_compare_lines);
+  } else {
+    qsort((void *)nrs, count, sizeof(sorti_T), sort_compare);
+  }
 
   if (sort_abort) {
     goto sortend;
@@ -626,57 +699,43 @@ void ex_sort(exarg_T *eap)
   bcount_t old_count = 0;
   bcount_t new_count = 0;
 
-  // Insert the lines in the sorted order below the last one.
-  linenr_T lnum = eap->line2;
+  // Put the lines in the sorted order in place of the original ones, which
+  // are all in "sort_text".  A line that stays where it was is not replaced.
+  linenr_T lnum = eap->line1;
+  const char *prev = NULL;
   for (i = 0; i < count; i++) {
-    const linenr_T get_lnum = nrs[eap->forceit ? count - i - 1 : i].lnum;
-
-    // If the original line number of the line being placed is not the same
-    // as "lnum" (accounting for offset), we know that the buffer changed.
-    if (get_lnum + ((linenr_T)count - 1) != lnum) {
-      change_occurred = true;
-    }
-
-    char *s = ml_get(get_lnum);
-    colnr_T bytelen = ml_get_len(get_lnum) + 1;  // include EOL in bytelen
+    const sorti_T *const si = &nrs[eap->forceit ? count - i - 1 : i];
+    const char *const s = sort_text + si->text_off;
+    const colnr_T bytelen = (colnr_T)strlen(s) + 1;  // include EOL in bytelen
     old_count += bytelen;
-    if (!unique || i == 0 || string_compare(s, sortbuf1) != 0) {
-      // Copy the line into a buffer, it may become invalid in
-      // ml_append(). And it's needed for "unique".
-      STRCPY(sortbuf1, s);
-      if (ml_append(lnum++, sortbuf1, 0, false) == FAIL) {
-        break;
-      }
-      new_count += bytelen;
+    if (unique && prev != NULL && string_compare(s, prev) == 0) {
+      continue;
     }
-    fast_breakcheck();
-    if (got_int) {
-      goto sortend;
+    prev = s;
+    if (si->lnum != lnum) {
+      change_occurred = true;
+      ml_replace(lnum, (char *)s, true);
     }
+    lnum++;
+    new_count += bytelen;
   }
 
-  // delete the original lines if appending worked
-  if (i == count) {
-    for (i = 0; i < count; i++) {
-      ml_delete(eap->line1, false);
-    }
-  } else {
-    count = 0;
+  // Delete the lines left over by "unique".
+  linenr_T deleted = (linenr_T)count - (lnum - eap->line1);
+  for (linenr_T n = 0; n < deleted; n++) {
+    ml_delete(lnum, false);
   }
 
-  // Adjust marks for deleted (or added) lines and prepare for displaying.
-  linenr_T deleted = (linenr_T)count - (lnum - eap->line2);
+  // Adjust marks for deleted lines and prepare for displaying.
   if (deleted > 0) {
     mark_adjust(eap->line2 - deleted, eap->line2, MAXLNUM, -deleted, kExtmarkNOOP);
     msgmore(-deleted);
-  } else if (deleted < 0) {
-    mark_adjust(eap->line2, MAXLNUM, -deleted, 0, kExtmarkNOOP);
   }
 
   if (change_occurred || deleted != 0) {
     extmark_splice(curbuf, eap->line1 - 1, 0,
                    (int)count, 0, old_count,
-                   lnum - eap->line2, 0, new_count, kExtmarkUndo);
+                   lnum - eap->line1, 0, new_count, kExtmarkUndo);
     changed_lines(curbuf, eap->line1, 0, eap->line2 + 1, -deleted, true);
   }
 
@@ -685,8 +744,8 @@ void ex_sort(exarg_T *eap)
 
 sortend:
   xfree(nrs);
-  xfree(sortbuf1);
-  xfree(sortbuf2);
+  kv_destroy(text);
+  sort_text = NULL;
   vim_regfree(regmatch.regprog);
   if (got_int) {
     emsg(_(e_interr));
@@ -3743,7 +3802,21 @@ static int do_sub(exarg_T *eap, const proftime_T timeout, const int cmdpreview_n
   // If preview: limit to max('cmdwinheight', viewport).
   linenr_T line2 = eap->line2;
 
-  for (linenr_T lnum = eap->line1;
+  // Without the preview window only what is visible needs to be substituted:
+  // skip the lines above the windows showing the buffer.
+  linenr_T first_lnum = eap->line1;
+  if (cmdpreview_ns > 0 && *p_icm != 's') {
+    linenr_T top = MAXLNUM;
+    FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
+      if (wp->w_buffer == curbuf) {
+        top = MIN(top, wp->w_topline);
+      }
+    }
+    first_lnum = MAX(first_lnum, top);
+  }
+
+preview_above:
+  for (linenr_T lnum = first_lnum;
        lnum <= line2 && !got_quit && !aborting()
        && (cmdpreview_ns <= 0 || preview_lines.lines_needed <= (linenr_T)p_cwh
            || lnum <= curwin->w_botline);
@@ -4414,6 +4487,14 @@ skip:
     }
   }
 
+  if (first_lnum > eap->line1 && sub_nsubs == start_nsubs && !got_quit && !aborting()) {
+    // Nothing matched in the visible lines: preview the matches above them,
+    // which also moves the cursor to the last one.
+    line2 = first_lnum - 1;
+    first_lnum = eap->line1;
+    goto preview_above;
+  }
+
   curbuf->deleted_bytes2 = 0;
 
   if (first_line != 0) {
@@ -4566,6 +4647,65 @@ static void global_exe_one(char *const cmd, const linenr_T lnum)
   }
 }
 
+/// Check whether the command for ":global" is a plain ":delete", which can
+/// be executed for a range of marked lines at once.
+///
+/// @return  kNone when it isn't, kTrue for ":delete _", kFalse for ":delete"
+///          into the unnamed register.
+static TriState global_delete_cmd(const char *cmd)
+{
+  const char *p = skipwhite(cmd);
+  if (*p != 'd') {
+    return kNone;
+  }
+  const char *name = "delete";
+  while (*p != NUL && *p == *name) {
+    p++;
+    name++;
+  }
+  if (ASCII_ISALPHA(*p)) {
+    return kNone;
+  }
+  p = skipwhite(p);
+  if (*p == NUL || *p == '\n') {
+    // Deleting one line at a time fills the numbered registers and triggers
+    // TextYankPost, only do it at once when that doesn't make a difference.
+    return (cb_flags == 0 && !has_event(EVENT_TEXTYANKPOST)) ? kFalse : kNone;
+  }
+  if (*p == '_' && *skipwhite(p + 1) == NUL) {
+    return kTrue;
+  }
+  return kNone;
+}
+
+/// Execute ":delete" for "lnum" and all marked lines directly below it.
+///
+/// @param blackhole  deleting into the "_ register
+static void global_exe_delete(char *const cmd, const linenr_T lnum, bool blackhole)
+{
+  linenr_T count = 1;
+  linenr_T next;
+  while ((next = ml_firstmarked()) == lnum + count) {
+    count++;
+  }
+  if (next != 0) {
+    ml_setmarked(next);  // not part of this range, do it later
+  }
+
+  // The last nine lines end up in the numbered registers, delete them one
+  // by one.  The lines before that can go to the black hole register.
+  linenr_T keep = blackhole ? 0 : MIN(count, 9);
+  if (count > keep) {
+    char buf[NUMBUFLEN * 2 + 5];
+    snprintf(buf, sizeof(buf), "%" PRIdLINENR ",%" PRIdLINENR "d _",
+             lnum, lnum + count - keep - 1);
+    global_exe_one(buf, lnum);
+  }
+  for (linenr_T i = 0; i < keep && !got_int && global_busy == 1; i++) {
+    global_exe_one(cmd, lnum);
+  }
+}
+
 /// Execute a global command of the form:
 ///
 /// g/pattern/X : execute X on all lines where pattern matches
@@ -4708,8 +4848,16 @@ void global_exe(char *cmd)
   global_busy = 1;
   old_lcount = curbuf->b_ml.ml_line_count;
 
+  // ":g/pat/d" deletes runs of matching lines at once, instead of making a
+  // change with its own undo, marks and redraw bookkeeping for every line.
+  const TriState delete_cmd = global_delete_cmd(cmd);
+
   while (!got_int && (lnum = ml_firstmarked()) != 0 && global_busy == 1) {
-    global_exe_one(cmd, lnum);
+    if (delete_cmd != kNone) {
+      global_exe_delete(cmd, lnum, delete_cmd == kTrue);
+    } else {
+      global_exe_one(cmd, lnum);
+    }
     os_breakcheck();
   }
 
@@ -133,10 +133,14 @@ static const char e_no_script_file_name_to_substitute_for_script[]
 static int quitmore = 0;
 static bool ex_pressedreturn = false;
 
+/// Command cache of the function line last returned by get_func_line().
+static FuncLineCmd *getline_line_cmd = NULL;
+
 // Struct for storing a line inside a while/for loop
 typedef struct {
   char *line;            // command line
   linenr_T lnum;                // sourcing_lnum of the line
+  FuncLineCmd *line_cmd;  // cached command of a function line, or NULL
 } wcmd_T;
 
 #define FREE_WCMD(wcmd) xfree((wcmd)->line)
@@ -418,6 +422,7 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
   char *fname = NULL;                   // function or script name
   linenr_T *breakpoint = NULL;          // ptr to breakpoint field in cookie
   int *dbg_tick = NULL;                 // ptr to dbg_tick field in cookie
+  FuncLineCmd *line_cmd = NULL;         // command cache of a function line
   struct dbg_stuff debug_saved;         // saved things for debug mode
   msglist_T *private_msg_list;
 
@@ -556,6 +561,7 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
 
       next_cmdline = ((wcmd_T *)(lines_ga.ga_data))[current_line].line;
       SOURCING_LNUM = ((wcmd_T *)(lines_ga.ga_data))[current_line].lnum;
+      line_cmd = ((wcmd_T *)(lines_ga.ga_data))[current_line].line_cmd;
 
       // Did we encounter a breakpoint?
       if (breakpoint != NULL && *breakpoint != 0 && *breakpoint <= SOURCING_LNUM) {
@@ -589,7 +595,11 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
           msg_didout = true;
         }
       }
-      if (fgetline == NULL || (next_cmdline = fgetline(':', cookie, indent, true)) == NULL) {
+      getline_line_cmd = NULL;
+      next_cmdline = fgetline == NULL ? NULL : fgetline(':', cookie, indent, true);
+      line_cmd = getline_line_cmd;
+      getline_line_cmd = NULL;
+      if (next_cmdline == NULL) {
         // Don't call wait_return() for aborted command line.  The NULL
         // returned for the end of a sourced file or executed function
         // doesn't do this.
@@ -613,6 +623,7 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
     } else if (cmdline_copy == NULL) {
       // 3. Make a copy of the command so we can mess with it.
       next_cmdline = xstrdup(next_cmdline);
+      line_cmd = NULL;
     }
     cmdline_copy = next_cmdline;
 
@@ -639,7 +650,7 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
 
       // Save the current line when encountering it the first time.
       if (current_line == lines_ga.ga_len) {
-        store_loop_line(&lines_ga, next_cmdline);
+        store_loop_line(&lines_ga, next_cmdline, line_cmd);
       }
       current_line_before = current_line;
     } else {
@@ -673,8 +684,10 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
     //    do_one_cmd() will return NULL if there is no trailing '|'.
     //    "cmdline_copy" can change, e.g. for '%' and '#' expansion.
     recursive++;
-    next_cmdline = do_one_cmd(&cmdline_copy, flags, &cstack, cmd_getline, cmd_cookie);
+    next_cmdline = do_one_cmd(&cmdline_copy, flags, &cstack, cmd_getline, cmd_cookie, line_cmd);
     recursive--;
+    // The cache is only for the first command in the line.
+    line_cmd = NULL;
 
     if (cmd_cookie == (void *)&cmd_loop_cookie) {
       // Use "current_line" from "cmd_loop_cookie", it may have been
@@ -1026,7 +1039,7 @@ static char *get_loop_line(int c, void *cookie, int indent, bool do_concat)
       line = cp->lc_getline(c, cp->cookie, indent, do_concat);
     }
     if (line != NULL) {
-      store_loop_line(cp->lines_gap, line);
+      store_loop_line(cp->lines_gap, line, NULL);
       cp->current_line++;
     }
 
@@ -1041,11 +1054,18 @@ static char *get_loop_line(int c, void *cookie, int indent, bool do_concat)
 }
 
 /// Store a line in "gap" so that a ":while" loop can execute it again.
-static void store_loop_line(garray_T *gap, char *line)
+static void store_loop_line(garray_T *gap, char *line, FuncLineCmd *line_cmd)
 {
   wcmd_T *p = GA_APPEND_VIA_PTR(wcmd_T, gap);
   p->line = xstrdup(line);
   p->lnum = SOURCING_LNUM;
+  p->line_cmd = line_cmd;
+}
+
+/// Sets the command cache of the line that get_func_line() returns.
+void getline_set_line_cmd(FuncLineCmd *line_cmd)
+{
+  getline_line_cmd = line_cmd;
 }
 
 /// If "fgetline" is get_loop_line(), return true if the getline it uses equals
@@ -1975,8 +1995,10 @@ static bool skip_cmd(const exarg_T *eap)
 /// This function may be called recursively!
 ///
 /// @param cookie  argument for fgetline()
+///
+/// @param line_cmd  cache for the command, when *cmdlinep is a function line
 static char *do_one_cmd(char **cmdlinep, int flags, cstack_T *cstack, LineGetter fgetline,
-                        void *cookie)
+                        void *cookie, FuncLineCmd *line_cmd)
 {
   const char *errormsg = NULL;  // error message
   const int save_reg_executing = reg_executing;
@@ -2037,7 +2059,7 @@ static char *do_one_cmd(char **cmdlinep, int flags, cstack_T *cstack, LineGetter
   if (*ea.cmd == '*') {
     ea.cmd = skipwhite(ea.cmd + 1);
   }
-  char *p = find_ex_command(&ea, NULL);
+  char *p = find_ex_command_cached(&ea, *cmdlinep, line_cmd);
 
   profile_cmd(&ea, cstack, fgetline, cookie);
 
@@ -3156,6 +3178,34 @@ char *find_ex_command(exarg_T *eap, int *full)
   return p;
 }
 
+/// Like find_ex_command(), but for the first command in a function line
+/// remembers the built-in command found in "line_cmd", so that later calls of
+/// the function don't need to look it up again.
+static char *find_ex_command_cached(exarg_T *eap, const char *line, FuncLineCmd *line_cmd)
+{
+  if (line_cmd == NULL) {
+    return find_ex_command(eap, NULL);
+  }
+  const ptrdiff_t off = eap->cmd - line;
+  if (line_cmd->cmd_off == off) {
+    eap->cmdidx = (cmdidx_T)line_cmd->cmdidx;
+    return eap->cmd + line_cmd->name_len;
+  }
+
+  const int flags = eap->flags;
+  char *p = find_ex_command(eap, NULL);
+  // User commands may be redefined, and ":dl" also sets flags.
+  if (p != NULL && eap->cmdidx != CMD_SIZE && !IS_USER_CMDIDX(eap->cmdidx)
+      && eap->flags == flags && off <= INT_MAX) {
+    *line_cmd = (FuncLineCmd){
+      .cmd_off = (int)off,
+      .name_len = (int)(p - eap->cmd),
+      .cmdidx = (int)eap->cmdidx,
+    };
+  }
+  return p;
+}
+
 static struct cmdmod {
   char *name;
   int minlen;
@@ -5903,7 +5953,7 @@ static void ex_syncbind(exarg_T *eap)
       wp->w_scbind_pos = vtopline;
       redraw_later(wp, UPD_VALID);
       cursor_correct(wp);
-      wp->w_redr_status = true;
+      status_redraw_win(wp);
     }
   }
 
@@ -6670,6 +6720,7 @@ static void ex_redraw(exarg_T *eap)
   update_topline(curwin);
   if (eap->forceit) {
     redraw_all_later(UPD_NOT_VALID);
+    status_redraw_all();  // evaluate 'statusline' again
     redraw_cmdline = true;
   } else if (VIsual_active) {
     redraw_curbuf_later(UPD_INVERTED);
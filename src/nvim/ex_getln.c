@@ -112,6 +112,16 @@ typedef struct {
   bool did_incsearch;
   bool incsearch_postponed;
   optmagic_T magic_overruled_save;
+  // Result of the previous search, used when the pattern is extended.
+  char *prev_pat;       // previous pattern or NULL
+  size_t prev_patlen;
+  int prev_firstc;
+  bool prev_ic;
+  handle_T prev_bufnr;
+  varnumber_T prev_changedtick;
+  pos_T prev_start;     // "search_start" used for "prev_pat"
+  bool prev_found;
+  pos_T prev_match;     // start of the match of "prev_pat"
 } incsearch_state_T;
 
 typedef struct {
@@ -153,6 +163,8 @@ typedef struct {
   u_header_T *save_b_u_newhead;
   u_header_T *save_b_u_curhead;
   int save_b_u_numhead;
+  size_t save_b_u_memory;
+  PMap(int) save_b_u_seq_headers;
   bool save_b_u_synced;
   int save_b_u_seq_last;
   int save_b_u_save_nr_last;
@@ -167,6 +179,7 @@ typedef struct {
 typedef struct {
   buf_T *buf;
   OptInt save_b_p_ul;
+  OptInt save_b_p_um;
   int save_b_p_ma;
   int save_b_changed;
   pos_T save_b_op_start;
@@ -267,6 +280,7 @@ static void init_incsearch_state(incsearch_state_T *s)
   clearpos(&s->match_end);
   s->save_cursor = curwin->w_cursor;  // may be restored later
   s->search_start = curwin->w_cursor;
+  XFREE_CLEAR(s->prev_pat);
   save_viewstate(curwin, &s->init_viewstate);
   save_viewstate(curwin, &s->old_viewstate);
 }
@@ -507,11 +521,47 @@ static void may_do_incsearch_highlighting(int firstc, int count, incsearch_state
     proftime_T tm = profile_setlimit(500);
     searchit_arg_T sia = { .sa_tm = &tm };
     ccline.cmdbuff[skiplen + patlen] = NUL;
+    char *pat = ccline.cmdbuff + skiplen;
+
+    // When the pattern is plain text that extends the previous one, its
+    // first match can't be before the previous match: continue there.
+    // Without a previous match there is no match now either.
+    bool can_reuse = (firstc == '/' || firstc == '?') && count == 1;
+    bool ic = p_ic && !(p_scs && pat_has_uppercase(pat));
+    bool reuse = can_reuse && s->prev_pat != NULL
+                 && firstc == s->prev_firstc
+                 && ic == s->prev_ic
+                 && curbuf->handle == s->prev_bufnr
+                 && buf_get_changedtick(curbuf) == s->prev_changedtick
+                 && equalpos(s->search_start, s->prev_start)
+                 && search_pat_extends(s->prev_pat, s->prev_patlen, pat, (size_t)patlen);
     emsg_off++;            // So it doesn't beep if bad expr
-    found = do_search(NULL, firstc == ':' ? '/' : firstc, search_delim,
-                      ccline.cmdbuff + skiplen, (size_t)patlen, count,
-                      search_flags, &sia);
+    if (reuse && !s->prev_found) {
+      if (p_hls) {
+        save_re_pat(RE_SEARCH, pat, (size_t)patlen, magic_isset());
+      }
+    } else {
+      if (reuse) {
+        curwin->w_cursor = s->prev_match;
+        search_flags |= SEARCH_START;
+      }
+      found = do_search(NULL, firstc == ':' ? '/' : firstc, search_delim,
+                        pat, (size_t)patlen, count, search_flags, &sia);
+    }
     emsg_off--;
+
+    XFREE_CLEAR(s->prev_pat);
+    if (can_reuse && !got_int && !sia.sa_timed_out && !char_avail()) {
+      s->prev_pat = xmemdupz(pat, (size_t)patlen);
+      s->prev_patlen = (size_t)patlen;
+      s->prev_firstc = firstc;
+      s->prev_ic = ic;
+      s->prev_bufnr = curbuf->handle;
+      s->prev_changedtick = buf_get_changedtick(curbuf);
+      s->prev_start = s->search_start;
+      s->prev_found = found != 0;
+      s->prev_match = curwin->w_cursor;
+    }
     ccline.cmdbuff[skiplen + patlen] = next_char;
     if (curwin->w_cursor.lnum < search_first_line
         || curwin->w_cursor.lnum > search_last_line) {
@@ -570,7 +620,7 @@ static void may_do_incsearch_highlighting(int firstc, int count, incsearch_state
 
   // May redraw the status line to show the cursor position.
   if (p_ru && (curwin->w_status_height > 0 || global_stl_height() > 0)) {
-    curwin->w_redr_status = true;
+    status_redraw_win(curwin);
   }
 
   redraw_later(curwin, UPD_SOME_VALID);
@@ -649,6 +699,7 @@ static int may_add_char_to_search(int firstc, int *c, incsearch_state_T *s)
 static void finish_incsearch_highlighting(bool gotesc, incsearch_state_T *s,
                                           bool call_update_screen)
 {
+  XFREE_CLEAR(s->prev_pat);
   if (!s->did_incsearch) {
     return;
   }
@@ -871,7 +922,7 @@ static uint8_t *command_line_enter(int firstc, int count, int indent, bool clear
 
     FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
       if (*p_stl != NUL || *wp->w_p_stl != NUL || *p_wbr != NUL || *wp->w_p_wbr != NUL) {
-        wp->w_redr_status = true;
+        status_redraw_win(wp);
         found_one = true;
       }
     }
@@ -937,6 +988,7 @@ static uint8_t *command_line_enter(int firstc, int count, int indent, bool clear
   ExpandCleanup(&s->xpc);
   ccline.xpc = NULL;
   clear_cmdline_orig();
+  expand_cache_clear();
 
   finish_incsearch_highlighting(s->gotesc, &s->is_state, false);
 
@@ -2472,6 +2524,9 @@ static void cmdpreview_save_undo(CpUndoInfo *cp_undoinfo, buf_T *buf)
   cp_undoinfo->save_b_u_newhead = buf->b_u_newhead;
   cp_undoinfo->save_b_u_curhead = buf->b_u_curhead;
   cp_undoinfo->save_b_u_numhead = buf->b_u_numhead;
+  cp_undoinfo->save_b_u_memory = buf->b_u_memory;
+  cp_undoinfo->save_b_u_seq_headers = buf->b_u_seq_headers;
+  buf->b_u_seq_headers = (PMap(int)) MAP_INIT;
   cp_undoinfo->save_b_u_seq_last = buf->b_u_seq_last;
   cp_undoinfo->save_b_u_save_nr_last = buf->b_u_save_nr_last;
   cp_undoinfo->save_b_u_seq_cur = buf->b_u_seq_cur;
@@ -2489,6 +2544,9 @@ static void cmdpreview_restore_undo(const CpUndoInfo *cp_undoinfo, buf_T *buf)
   buf->b_u_newhead = cp_undoinfo->save_b_u_newhead;
   buf->b_u_curhead = cp_undoinfo->save_b_u_curhead;
   buf->b_u_numhead = cp_undoinfo->save_b_u_numhead;
+  buf->b_u_memory = cp_undoinfo->save_b_u_memory;
+  map_destroy(int, &buf->b_u_seq_headers);
+  buf->b_u_seq_headers = cp_undoinfo->save_b_u_seq_headers;
   buf->b_u_seq_last = cp_undoinfo->save_b_u_seq_last;
   buf->b_u_save_nr_last = cp_undoinfo->save_b_u_save_nr_last;
   buf->b_u_seq_cur = cp_undoinfo->save_b_u_seq_cur;
@@ -2524,6 +2582,7 @@ static void cmdpreview_prepare(CpInfo *cpinfo)
       cp_bufinfo.buf = buf;
       cp_bufinfo.save_b_p_ma = buf->b_p_ma;
       cp_bufinfo.save_b_p_ul = buf->b_p_ul;
+      cp_bufinfo.save_b_p_um = buf->b_p_um;
       cp_bufinfo.save_b_changed = buf->b_changed;
       cp_bufinfo.save_b_op_start = buf->b_op_start;
       cp_bufinfo.save_b_op_end = buf->b_op_end;
@@ -2534,6 +2593,7 @@ static void cmdpreview_prepare(CpInfo *cpinfo)
 
       u_clearall(buf);
       buf->b_p_ul = INT_MAX;  // Make sure we can undo all changes
+      buf->b_p_um = 0;
     }
 
     CpWinInfo cp_wininfo;
@@ -2613,6 +2673,7 @@ static void cmdpreview_restore_state(CpInfo *cpinfo)
     }
 
     buf->b_p_ul = cp_bufinfo.save_b_p_ul;        // Restore 'undolevels'
+    buf->b_p_um = cp_bufinfo.save_b_p_um;        // Restore 'undomemory'
     buf->b_p_ma = cp_bufinfo.save_b_p_ma;        // Restore 'modifiable'
   }
 
@@ -218,23 +218,27 @@ bool extmark_clear(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_col, int u_r
   bool marks_cleared_any = false;
   bool marks_cleared_all = l_row == 0 && l_col == 0;
 
-  MarkTreeIter itr[1] = { 0 };
-  marktree_itr_get(buf->b_marktree, l_row, l_col, itr);
-  while (true) {
-    MTKey mark = marktree_itr_current(itr);
-    if (mark.pos.row < 0
-        || mark.pos.row > u_row
-        || (mark.pos.row == u_row && mark.pos.col > u_col)) {
-      if (mark.pos.row >= 0) {
-        marks_cleared_all = false;
+  if (marks_cleared_all && u_row >= MAXLNUM - 1 && extmark_clear_rebuild(buf, ns_id)) {
+    marks_cleared_any = true;
+  } else {
+    MarkTreeIter itr[1] = { 0 };
+    marktree_itr_get(buf->b_marktree, l_row, l_col, itr);
+    while (true) {
+      MTKey mark = marktree_itr_current(itr);
+      if (mark.pos.row < 0
+          || mark.pos.row > u_row
+          || (mark.pos.row == u_row && mark.pos.col > u_col)) {
+        if (mark.pos.row >= 0) {
+          marks_cleared_all = false;
+        }
+        break;
+      }
+      if (mark.ns == ns_id || all_ns) {
+        marks_cleared_any = true;
+        extmark_del(buf, itr, mark, true);
+      } else {
+        marktree_itr_next(buf->b_marktree, itr);
       }
-      break;
-    }
-    if (mark.ns == ns_id || all_ns) {
-      marks_cleared_any = true;
-      extmark_del(buf, itr, mark, true);
-    } else {
-      marktree_itr_next(buf->b_marktree, itr);
     }
   }
 
@@ -254,6 +258,77 @@ bool extmark_clear(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_col, int u_r
   return marks_cleared_any;
 }
 
+/// Delete all marks of namespace "ns_id", or of all namespaces if it is 0, by
+/// building a new marktree from the other marks.  When most of the marks are
+/// deleted this is much faster than deleting them one by one, which
+/// rebalances the tree for every mark.
+///
+/// @return  false if nothing was done, because deleting the marks one by one
+///          is expected to be faster or a deleted mark has a sign.
+static bool extmark_clear_rebuild(buf_T *buf, uint32_t ns_id)
+{
+  MarkTree *b = buf->b_marktree;
+  size_t n_del = 0;
+
+  MarkTreeIter itr[1] = { 0 };
+  marktree_itr_get(b, 0, 0, itr);
+  while (true) {
+    MTKey mark = marktree_itr_current(itr);
+    if (mark.pos.row < 0) {
+      break;
+    }
+    if (mark.ns == ns_id || ns_id == 0) {
+      // Removing a sign recounts the sign columns from the marktree.
+      if (mark.flags & MT_FLAG_DECOR_SIGNTEXT) {
+        return false;
+      }
+      n_del++;
+    }
+    marktree_itr_next(b, itr);
+  }
+
+  if (n_del == 0 || n_del < b->n_keys - n_del) {
+    return false;
+  }
+
+  ExtmarkInfoArray kept = KV_INITIAL_VALUE;
+  marktree_itr_get(b, 0, 0, itr);
+  while (true) {
+    MTKey mark = marktree_itr_current(itr);
+    if (mark.pos.row < 0) {
+      break;
+    }
+    if (!mt_end(mark)) {
+      MTPair pair = mtpair_from(mark, marktree_get_alt(b, mark, NULL));
+      if (mark.ns != ns_id && ns_id != 0) {
+        kv_push(kept, pair);
+      } else if (mt_decor_any(mark)) {
+        if (mt_invalid(mark)) {
+          decor_free(mt_decor(mark));
+        } else {
+          buf_decor_remove(buf, mark.pos.row, pair.end_pos.row, mark.pos.col, mt_decor(mark),
+                           true);
+        }
+      }
+    }
+    marktree_itr_next(b, itr);
+  }
+
+  marktree_clear(b);
+  for (size_t i = 0; i < kv_size(kept); i++) {
+    MTPair pair = kv_A(kept, i);
+    MTKey key = pair.start;
+    bool paired = mt_paired(key);
+    key.flags &= MT_FLAG_EXTERNAL_MASK | MT_FLAG_RIGHT_GRAVITY;
+    marktree_put(b, key, paired ? pair.end_pos.row : -1, pair.end_pos.col,
+                 pair.end_right_gravity);
+  }
+  kv_destroy(kept);
+
+  decor_state_invalidate(buf);
+  return true;
+}
+
 /// @return  the position of marks between a range,
 ///          marks found at the start or end index will be included.
 ///
@@ -264,7 +339,21 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
                              colnr_T u_col, int64_t amount, ExtmarkType type_filter, bool overlap)
 {
   ExtmarkInfoArray array = KV_INITIAL_VALUE;
-  MarkTreeIter itr[1];
+  MarkTreeIter itr[1] = { 0 };
+
+  // virt_lines marks are counted in the marktree meta, so subtrees without
+  // any of them can be skipped.
+  static const uint32_t lines_filter[kMTMetaCount] = {[kMTMetaLines] = kMTFilterSelect };
+  MetaFilter filter = type_filter == kExtmarkVirtLines ? lines_filter : NULL;
+  // (stop_row, stop_col) is the first position after the range
+  int stop_row = u_row;
+  int stop_col = u_col;
+  if (u_col < MAXCOL) {
+    stop_col++;
+  } else if (u_row < MAXLNUM) {
+    stop_row++;
+    stop_col = 0;
+  }
 
   if (overlap) {
     // Find all the marks overlapping the start position
@@ -276,13 +365,18 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
     while (marktree_itr_step_overlap(buf->b_marktree, itr, &pair)) {
       push_mark(&array, ns_id, type_filter, pair);
     }
+    if (filter) {
+      marktree_itr_step_out_filter(buf->b_marktree, itr, filter);
+    }
+  } else if (filter) {
+    marktree_itr_get_filter(buf->b_marktree, l_row, l_col, stop_row, stop_col, filter, itr);
   } else {
     // Find all the marks beginning with the start position
     marktree_itr_get_ext(buf->b_marktree, MTPos(l_row, l_col),
                          itr, false, false, NULL, NULL);
   }
 
-  while ((int64_t)kv_size(array) < amount) {
+  while (itr->x && (int64_t)kv_size(array) < amount) {
     MTKey mark = marktree_itr_current(itr);
     if (mark.pos.row < 0
         || (mark.pos.row > u_row)
@@ -293,7 +387,11 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
       MTKey end = marktree_get_alt(buf->b_marktree, mark, NULL);
       push_mark(&array, ns_id, type_filter, mtpair_from(mark, end));
     }
-    marktree_itr_next(buf->b_marktree, itr);
+    if (filter) {
+      marktree_itr_next_filter(buf->b_marktree, itr, stop_row, stop_col, filter);
+    } else {
+      marktree_itr_next(buf->b_marktree, itr);
+    }
   }
   return array;
 }
@@ -592,8 +690,9 @@ void extmark_splice_impl(buf_T *buf, int start_row, colnr_T start_col, bcount_t
 
     bool merged = false;
     // TODO(bfredl): this is quite rudimentary. We merge small (within line)
-    // inserts with each other and small deletes with each other. Add full
-    // merge algorithm later.
+    // inserts with each other and small deletes with each other, and inserts
+    // that continue where the previous insert ended. Add full merge algorithm
+    // later.
     if (old_row == 0 && new_row == 0 && kv_size(uhp->uh_extmark)) {
       ExtmarkUndoObject *item = &kv_A(uhp->uh_extmark,
                                       kv_size(uhp->uh_extmark) - 1);
@@ -623,6 +722,25 @@ void extmark_splice_impl(buf_T *buf, int start_row, colnr_T start_col, bcount_t
       }
     }
 
+    if (!merged && old_row == 0 && old_col == 0 && kv_size(uhp->uh_extmark)) {
+      // An insert starting at the end of the previous insert, e.g. typing
+      // a line break in Insert mode, extends the previous splice.
+      ExtmarkUndoObject *item = &kv_last(uhp->uh_extmark);
+      if (item->type == kExtmarkSplice) {
+        ExtmarkSplice *splice = &item->data.splice;
+        int end_row = splice->start_row + splice->new_row;
+        colnr_T end_col = (splice->new_row ? 0 : splice->start_col) + splice->new_col;
+        if (splice->old_row == 0 && splice->old_col == 0
+            && start_row == end_row && start_col == end_col
+            && start_byte == splice->start_byte + splice->new_byte) {
+          splice->new_col = new_row ? new_col : splice->new_col + new_col;
+          splice->new_row += new_row;
+          splice->new_byte += new_byte;
+          merged = true;
+        }
+      }
+    }
+
     if (!merged) {
       ExtmarkSplice splice;
       splice.start_row = start_row;
@@ -66,6 +66,7 @@
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -115,6 +116,8 @@ typedef struct ff_stack {
 // type for already visited directories or files.
 typedef struct ff_visited {
   struct ff_visited *ffv_next;
+  // next entry with the same key in ffvl_visited_map
+  struct ff_visited *ffv_same_next;
 
   // Visited directories are different if the wildcard string are
   // different. So we have to save it.
@@ -147,6 +150,10 @@ typedef struct ff_visited_list_hdr {
   char *ffvl_filename;
 
   ff_visited_T *ffvl_visited_list;
+  // Entries of ffvl_visited_list with a FileID, by ff_fileid_key().  Searching
+  // a large tree with "**" visits many directories, going over the whole list
+  // for each of them is slow.  URLs are only in the list.
+  PMap(uint64_t) ffvl_visited_map;
 } ff_visited_list_hdr_T;
 
 // '**' can be expanded to several directory levels.
@@ -663,7 +670,7 @@ char *vim_findfile(void *search_ctx_arg)
       // This check is only needed for directories we work on for the
       // first time (hence stackp->ff_filearray == NULL)
       if (stackp->ffs_filearray == NULL
-          && ff_check_visited(&search_ctx->ffsc_dir_visited_list->ffvl_visited_list,
+          && ff_check_visited(search_ctx->ffsc_dir_visited_list,
                               stackp->ffs_fix_path.data, stackp->ffs_fix_path.size,
                               stackp->ffs_wc_path.data, stackp->ffs_wc_path.size) == FAIL) {
 #ifdef FF_VERBOSE
@@ -866,12 +873,12 @@ char *vim_findfile(void *search_ctx_arg)
                            || ((search_ctx->ffsc_find_what == FINDFILE_DIR)
                                == os_isdir(file_path.data)))))
 #ifndef FF_VERBOSE
-                  && (ff_check_visited(&search_ctx->ffsc_visited_list->ffvl_visited_list,
+                  && (ff_check_visited(search_ctx->ffsc_visited_list,
                                        file_path.data, file_path.size, "", 0) == OK)
 #endif
                   ) {
 #ifdef FF_VERBOSE
-                if (ff_check_visited(&search_ctx->ffsc_visited_list->ffvl_visited_list,
+                if (ff_check_visited(search_ctx->ffsc_visited_list,
                                      file_path.data, file_path.size, "", 0) == FAIL) {
                   if (p_verbose >= 5) {
                     verbose_enter_scroll();
@@ -1049,6 +1056,7 @@ static void vim_findfile_free_visited_list(ff_visited_list_hdr_T **list_headp)
   while (*list_headp != NULL) {
     vp = (*list_headp)->ffvl_next;
     ff_free_visited_list((*list_headp)->ffvl_visited_list);
+    map_destroy(uint64_t, &(*list_headp)->ffvl_visited_map);
 
     xfree((*list_headp)->ffvl_filename);
     xfree(*list_headp);
@@ -1109,6 +1117,7 @@ static ff_visited_list_hdr_T *ff_get_visited_list(char *filename, size_t filenam
   retptr = xmalloc(sizeof(*retptr));
 
   retptr->ffvl_visited_list = NULL;
+  retptr->ffvl_visited_map = (PMap(uint64_t))MAP_INIT;
   retptr->ffvl_filename = xmemdupz(filename, filenamelen);
   retptr->ffvl_next = *list_headp;
   *list_headp = retptr;
@@ -1154,15 +1163,23 @@ static bool ff_wc_equal(char *s1, char *s2)
   return s1[i] == s2[j];
 }
 
+/// @return  the key for "file_id" in ffvl_visited_map.
+static uint64_t ff_fileid_key(const FileID *file_id)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  return file_id->inode ^ (file_id->device_id * 0x9e3779b97f4a7c15);
+}
+
 /// maintains the list of already visited files and dirs
 ///
 /// @return  FAIL if the given file/dir is already in the list or,
 ///          OK if it is newly added
-static int ff_check_visited(ff_visited_T **visited_list, char *fname, size_t fnamelen,
+static int ff_check_visited(ff_visited_list_hdr_T *visited, char *fname, size_t fnamelen,
                             char *wc_path, size_t wc_pathlen)
 {
   ff_visited_T *vp;
   bool url = false;
+  ff_visited_T **same_key = NULL;
 
   FileID file_id;
   // For a URL we only compare the name, otherwise we compare the
@@ -1180,12 +1197,22 @@ static int ff_check_visited(ff_visited_T **visited_list, char *fname, size_t fna
   }
 
   // check against list of already visited files
-  for (vp = *visited_list; vp != NULL; vp = vp->ffv_next) {
-    if ((url && path_fnamecmp(vp->ffv_fname, ff_expand_buffer.data) == 0)
-        || (!url && vp->file_id_valid
-            && os_fileid_equal(&(vp->file_id), &file_id))) {
-      // are the wildcard parts equal
-      if (ff_wc_equal(vp->ffv_wc_path, wc_path)) {
+  if (url) {
+    for (vp = visited->ffvl_visited_list; vp != NULL; vp = vp->ffv_next) {
+      if (!vp->file_id_valid && path_fnamecmp(vp->ffv_fname, ff_expand_buffer.data) == 0
+          // are the wildcard parts equal
+          && ff_wc_equal(vp->ffv_wc_path, wc_path)) {
+        // already visited
+        return FAIL;
+      }
+    }
+  } else {
+    same_key = (ff_visited_T **)pmap_put_ref(uint64_t)(&visited->ffvl_visited_map,
+                                                        ff_fileid_key(&file_id), NULL, NULL);
+    for (vp = *same_key; vp != NULL; vp = vp->ffv_same_next) {
+      if (os_fileid_equal(&(vp->file_id), &file_id)
+          // are the wildcard parts equal
+          && ff_wc_equal(vp->ffv_wc_path, wc_path)) {
         // already visited
         return FAIL;
       }
@@ -1199,9 +1226,12 @@ static int ff_check_visited(ff_visited_T **visited_list, char *fname, size_t fna
     vp->file_id_valid = true;
     vp->file_id = file_id;
     vp->ffv_fname[0] = NUL;
+    vp->ffv_same_next = *same_key;
+    *same_key = vp;
   } else {
     vp->file_id_valid = false;
     STRCPY(vp->ffv_fname, ff_expand_buffer.data);
+    vp->ffv_same_next = NULL;
   }
 
   if (wc_path != NULL) {
@@ -1210,8 +1240,8 @@ static int ff_check_visited(ff_visited_T **visited_list, char *fname, size_t fna
     vp->ffv_wc_path = NULL;
   }
 
-  vp->ffv_next = *visited_list;
-  *visited_list = vp;
+  vp->ffv_next = visited->ffvl_visited_list;
+  visited->ffvl_visited_list = vp;
 
   return OK;
 }
@@ -29,6 +29,9 @@
 #include "nvim/edit.h"
 #include "nvim/errors.h"
 #include "nvim/eval.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/fswatch.h"
+#include "nvim/event/loop.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_eval.h"
 #include "nvim/fileio.h"
@@ -42,6 +45,7 @@
 #include "nvim/iconv_defs.h"
 #include "nvim/log.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
 #include "nvim/memfile.h"
@@ -952,7 +956,6 @@ retry:
           if (read_buf_lnum > from) {
             size = 0;
           } else {
-            int ni;
             int tlen = 0;
             while (true) {
               p = (uint8_t *)ml_get(read_buf_lnum) + read_buf_col;
@@ -962,26 +965,18 @@ retry:
                 // Change NL to NUL to reverse the effect done
                 // below.
                 n = (int)(size - tlen);
-                for (ni = 0; ni < n; ni++) {
-                  if (p[ni] == NL) {
-                    ptr[tlen++] = NUL;
-                  } else {
-                    ptr[tlen++] = (char)p[ni];
-                  }
-                }
+                memcpy(ptr + tlen, p, (size_t)n);
+                memchrsub(ptr + tlen, NL, NUL, (size_t)n);
+                tlen += n;
                 read_buf_col += n;
                 break;
               }
 
               // Append whole line and new-line.  Change NL
               // to NUL to reverse the effect done below.
-              for (ni = 0; ni < n; ni++) {
-                if (p[ni] == NL) {
-                  ptr[tlen++] = NUL;
-                } else {
-                  ptr[tlen++] = (char)p[ni];
-                }
-              }
+              memcpy(ptr + tlen, p, (size_t)n);
+              memchrsub(ptr + tlen, NL, NUL, (size_t)n);
+              tlen += n;
               ptr[tlen++] = NL;
               read_buf_col = 0;
               if (++read_buf_lnum > from) {
@@ -1335,59 +1330,62 @@ retry:
           if (todo <= 0) {
             break;
           }
-          if (*p >= 0x80) {
-            // A length of 1 means it's an illegal byte.  Accept
-            // an incomplete character at the end though, the next
-            // read() will get the next bytes, we'll check it
-            // then.
-            int l = utf_ptr2len_len((char *)p, todo);
-            if (l > todo && !incomplete_tail) {
-              // Avoid retrying with a different encoding when
-              // a truncated file is more likely, or attempting
-              // to read the rest of an incomplete sequence when
-              // we have already done so.
-              if (p > (uint8_t *)ptr || filesize > 0) {
-                incomplete_tail = true;
-              }
-              // Incomplete byte sequence, move it to conv_rest[]
-              // and try to read the rest of it, unless we've
-              // already done so.
-              if (p > (uint8_t *)ptr) {
-                conv_restlen = todo;
-                memmove(conv_rest, p, (size_t)conv_restlen);
-                size -= conv_restlen;
-                break;
-              }
+          if (*p < 0x80) {
+            // Quickly skip over a run of ASCII bytes.
+            p += utf_ascii_len((char *)p, todo) - 1;
+            continue;
+          }
+          // A length of 1 means it's an illegal byte.  Accept
+          // an incomplete character at the end though, the next
+          // read() will get the next bytes, we'll check it
+          // then.
+          int l = utf_ptr2len_len((char *)p, todo);
+          if (l > todo && !incomplete_tail) {
+            // Avoid retrying with a different encoding when
+            // a truncated file is more likely, or attempting
+            // to read the rest of an incomplete sequence when
+            // we have already done so.
+            if (p > (uint8_t *)ptr || filesize > 0) {
+              incomplete_tail = true;
+            }
+            // Incomplete byte sequence, move it to conv_rest[]
+            // and try to read the rest of it, unless we've
+            // already done so.
+            if (p > (uint8_t *)ptr) {
+              conv_restlen = todo;
+              memmove(conv_rest, p, (size_t)conv_restlen);
+              size -= conv_restlen;
+              break;
+            }
+          }
+          if (l == 1 || l > todo) {
+            // Illegal byte.  If we can try another encoding
+            // do that, unless at EOF where a truncated
+            // file is more likely than a conversion error.
+            if (can_retry && !incomplete_tail) {
+              break;
             }
-            if (l == 1 || l > todo) {
-              // Illegal byte.  If we can try another encoding
-              // do that, unless at EOF where a truncated
-              // file is more likely than a conversion error.
-              if (can_retry && !incomplete_tail) {
-                break;
-              }
 
-              // When we did a conversion report an error.
-              if (iconv_fd != (iconv_t)-1 && conv_error == 0) {
-                conv_error = readfile_linenr(linecnt, ptr, (char *)p);
-              }
+            // When we did a conversion report an error.
+            if (iconv_fd != (iconv_t)-1 && conv_error == 0) {
+              conv_error = readfile_linenr(linecnt, ptr, (char *)p);
+            }
 
-              // Remember the first linenr with an illegal byte
-              if (conv_error == 0 && illegal_byte == 0) {
-                illegal_byte = readfile_linenr(linecnt, ptr, (char *)p);
-              }
+            // Remember the first linenr with an illegal byte
+            if (conv_error == 0 && illegal_byte == 0) {
+              illegal_byte = readfile_linenr(linecnt, ptr, (char *)p);
+            }
 
-              // Drop, keep or replace the bad byte.
-              if (bad_char_behavior == BAD_DROP) {
-                memmove(p, p + 1, (size_t)(todo - 1));
-                p--;
-                size--;
-              } else if (bad_char_behavior != BAD_KEEP) {
-                *p = (uint8_t)bad_char_behavior;
-              }
-            } else {
-              p += l - 1;
+            // Drop, keep or replace the bad byte.
+            if (bad_char_behavior == BAD_DROP) {
+              memmove(p, p + 1, (size_t)(todo - 1));
+              p--;
+              size--;
+            } else if (bad_char_behavior != BAD_KEEP) {
+              *p = (uint8_t)bad_char_behavior;
             }
+          } else {
+            p += l - 1;
           }
         }
         if (p < (uint8_t *)ptr + size && !incomplete_tail) {
@@ -1511,58 +1509,84 @@ rewind_retry:
         }
       }
     } else {
-      ptr--;
-      while (++ptr, --size >= 0) {
-        if ((c = *ptr) != NUL && c != NL) {        // catch most common case
-          continue;
+      // Find the line breaks with memchr(), which is a lot faster than
+      // checking every character for big files.  The lines are collected
+      // and appended to the buffer together.
+      enum { APPEND_MAX = 256, };
+      char *append_lines[APPEND_MAX];
+      colnr_T append_lens[APPEND_MAX];
+      int append_count = 0;
+      char *const end = ptr + size;
+      while (ptr < end) {
+        char *const nl = memchr(ptr, NL, (size_t)(end - ptr));
+        char *const stop = nl == NULL ? end : nl;
+        for (char *nul = memchr(ptr, NUL, (size_t)(stop - ptr)); nul != NULL;
+             nul = memchr(nul + 1, NUL, (size_t)(stop - nul - 1))) {
+          *nul = NL;            // NULs are replaced by newlines!
         }
-        if (c == NUL) {
-          *ptr = NL;            // NULs are replaced by newlines!
-        } else {
-          if (skip_count == 0) {
-            *ptr = NUL;                         // end of line
-            len = (colnr_T)(ptr - line_start + 1);
-            if (fileformat == EOL_DOS) {
-              if (ptr > line_start && ptr[-1] == CAR) {
-                // remove CR before NL
-                ptr[-1] = NUL;
-                len--;
-              } else if (ff_error != EOL_DOS) {
-                // Reading in Dos format, but no CR-LF found!
-                // When 'fileformats' includes "unix", delete all
-                // the lines read so far and start all over again.
-                // Otherwise give an error message later.
-                if (try_unix
-                    && !read_stdin
-                    && (read_buffer || vim_lseek(fd, 0, SEEK_SET) == 0)) {
-                  fileformat = EOL_UNIX;
-                  if (set_options) {
-                    set_fileformat(EOL_UNIX, OPT_LOCAL);
-                  }
-                  file_rewind = true;
-                  keep_fileformat = true;
-                  goto retry;
+        ptr = stop;
+        if (nl == NULL) {
+          break;
+        }
+        if (skip_count == 0) {
+          *ptr = NUL;  // end of line
+          len = (colnr_T)(ptr - line_start + 1);
+          if (fileformat == EOL_DOS) {
+            if (ptr > line_start && ptr[-1] == CAR) {
+              // remove CR before NL
+              ptr[-1] = NUL;
+              len--;
+            } else if (ff_error != EOL_DOS) {
+              // Reading in Dos format, but no CR-LF found!
+              // When 'fileformats' includes "unix", delete all
+              // the lines read so far and start all over again.
+              // Otherwise give an error message later.
+              if (try_unix
+                  && !read_stdin
+                  && (read_buffer || vim_lseek(fd, 0, SEEK_SET) == 0)) {
+                fileformat = EOL_UNIX;
+                if (set_options) {
+                  set_fileformat(EOL_UNIX, OPT_LOCAL);
                 }
-                ff_error = EOL_DOS;
+                file_rewind = true;
+                keep_fileformat = true;
+                goto retry;
               }
+              ff_error = EOL_DOS;
             }
-            if (ml_append(lnum, line_start, len, newfile) == FAIL) {
+          }
+          append_lines[append_count] = line_start;
+          append_lens[append_count] = len;
+          if (++append_count == APPEND_MAX) {
+            if (ml_append_many(lnum, append_lines, append_lens, append_count,
+                               newfile) == FAIL) {
+              append_count = 0;
               error = true;
               break;
             }
-            if (read_undo_file) {
-              sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
-            }
-            lnum++;
-            if (--read_count == 0) {
-              error = true;                         // break loop
-              line_start = ptr;                 // nothing left to write
-              break;
-            }
-          } else {
-            skip_count--;
+            lnum += append_count;
+            append_count = 0;
           }
-          line_start = ptr + 1;
+          if (read_undo_file) {
+            sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
+          }
+          if (--read_count == 0) {
+            error = true;  // break loop
+            line_start = ptr;  // nothing left to write
+            break;
+          }
+        } else {
+          skip_count--;
+        }
+        line_start = ptr + 1;
+        ptr++;
+      }
+      // The lines are in "buffer", append them before reading more.
+      if (append_count > 0) {
+        if (ml_append_many(lnum, append_lines, append_lens, append_count, newfile) == FAIL) {
+          error = true;
+        } else {
+          lnum += append_count;
         }
       }
     }
@@ -2773,9 +2797,13 @@ int check_timestamps(int focus)
     no_wait_return++;
     did_check_timestamps = true;
     already_warned = false;
+    // Take note of file changes reported since the loop was last polled.
+    if (!main_loop.recursive) {
+      loop_poll_events(&main_loop, 0);
+    }
     FOR_ALL_BUFFERS(buf) {
-      // Only check buffers in a window.
-      if (buf->b_nwindows > 0) {
+      // Only check buffers in a window, whose file may have changed.
+      if (buf->b_nwindows > 0 && buf_file_maybe_changed(buf)) {
         bufref_T bufref;
         set_bufref(&bufref, buf);
         const int n = buf_check_timestamp(buf);
@@ -3091,8 +3119,19 @@ void buf_reload(buf_T *buf, int orig_mode, bool reload_options)
 
   pos_T old_cursor = curwin->w_cursor;
   linenr_T old_topline = curwin->w_topline;
+  bool keep_undo = p_ur < 0 || curbuf->b_ml.ml_line_count <= p_ur;
 
-  if (p_ur < 0 || curbuf->b_ml.ml_line_count <= p_ur) {
+  if (!reload_options && keep_undo && buf == curbuf && !buf_is_empty(curbuf)) {
+    // Only change the lines that differ, keeping extmarks, folds and
+    // syntax state for the rest of the buffer.
+    // Sync first so that this is a separate undo-able action.
+    u_sync(false);
+    if (buf_reload_changed_lines(buf, &ea) == OK) {
+      goto reloaded;
+    }
+  }
+
+  if (keep_undo) {
     // Save all the text, so that the reload can be undone.
     // Sync first so that this is a separate undo-able action.
     u_sync(false);
@@ -3158,12 +3197,14 @@ void buf_reload(buf_T *buf, int orig_mode, bool reload_options)
       curbuf->b_mod_set = true;
     }
   }
-  xfree(ea.cmd);
 
   if (savebuf != NULL && bufref_valid(&bufref)) {
     wipe_buffer(savebuf, false);
   }
 
+reloaded:
+  xfree(ea.cmd);
+
   // Invalidate diff info if necessary.
   diff_invalidate(curbuf);
 
@@ -3198,6 +3239,78 @@ void buf_reload(buf_T *buf, int orig_mode, bool reload_options)
   // Careful: autocommands may have made "buf" invalid!
 }
 
+/// Reload "buf", which must be curbuf, by reading the file into a hidden
+/// buffer and only changing the lines that differ.
+///
+/// @return  FAIL if the file could not be read.
+static int buf_reload_changed_lines(buf_T *buf, exarg_T *eap)
+{
+  // Allocate a buffer without putting it in the buffer list.
+  buf_T *newbuf = buflist_new(NULL, NULL, 1, BLN_DUMMY);
+  if (newbuf == NULL) {
+    return FAIL;
+  }
+
+  apply_autocmds_exarg(EVENT_BUFREADPRE, NULL, buf->b_fname, false, buf, eap);
+  if (curbuf != buf || aborting()) {
+    wipe_buffer(newbuf, false);
+    return FAIL;
+  }
+
+  int retval = FAIL;
+  aco_save_T aco;
+  aucmd_prepbuf(&aco, newbuf);
+
+  // The BufRead autocommands are triggered for "buf" instead.
+  block_autocmds();
+
+  newbuf->b_flags |= BF_CHECK_RO;
+  if (ml_open(curbuf) == OK
+      && readfile(buf->b_ffname, buf->b_fname, 0, 0, (linenr_T)MAXLNUM,
+                  eap, READ_NEW | READ_DUMMY, true) == OK) {
+    retval = OK;
+  }
+
+  // restore curwin/curbuf and a few other things
+  aucmd_restbuf(&aco);
+
+  if (retval == OK && curbuf == buf) {
+    retval = diff_update_buffer(buf, newbuf);
+  }
+  if (retval == OK) {
+    buf->b_p_ro = newbuf->b_p_ro;
+    buf->b_p_eol = newbuf->b_p_eol;
+    buf->b_p_eof = newbuf->b_p_eof;
+    buf->b_p_bomb = newbuf->b_p_bomb;
+    buf->b_no_eol_lnum = newbuf->b_no_eol_lnum;
+    buf->b_mtime = newbuf->b_mtime;
+    buf->b_mtime_ns = newbuf->b_mtime_ns;
+    buf->b_mtime_read = newbuf->b_mtime_read;
+    buf->b_mtime_read_ns = newbuf->b_mtime_read_ns;
+    buf->b_orig_size = newbuf->b_orig_size;
+    buf->b_orig_mode = newbuf->b_orig_mode;
+    save_file_ff(buf);
+
+    // Mark the buffer as unmodified and all undo states as changed.
+    unchanged(buf, true, true);
+    u_unchanged(buf);
+    buf->b_mod_set = true;
+  }
+
+  if (curbuf != newbuf) {  // safety check
+    wipe_buffer(newbuf, false);
+  }
+
+  unblock_autocmds();
+
+  if (retval == OK) {
+    buf->b_keep_filetype = true;  // don't detect 'filetype'
+    apply_autocmds_exarg(EVENT_BUFREADPOST, NULL, buf->b_fname, false, buf, eap);
+    buf->b_keep_filetype = false;
+  }
+  return retval;
+}
+
 void buf_store_file_info(buf_T *buf, FileInfo *file_info)
   FUNC_ATTR_NONNULL_ALL
 {
@@ -3205,6 +3318,71 @@ void buf_store_file_info(buf_T *buf, FileInfo *file_info)
   buf->b_mtime_ns = file_info->stat.st_mtim.tv_nsec;
   buf->b_orig_size = os_fileinfo_size(file_info);
   buf->b_orig_mode = (int)file_info->stat.st_mode;
+  buf_watch_file(buf, false);
+}
+
+/// Starts watching the file of "buf", so that check_timestamps() only needs to
+/// look at the buffers whose file changed, if the file system supports that.
+/// Only buffers in a window are watched, like check_timestamps() only checks
+/// them, a watcher may use a file descriptor.
+///
+/// @param restart  watch the file again, even if it is already watched: a
+///                 change may have been that the file was replaced.
+static void buf_watch_file(buf_T *buf, bool restart)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (buf->b_ffname == NULL || buf->b_nwindows == 0) {
+    return;
+  }
+  if (buf->b_fswatcher != NULL) {
+    if (!restart && !buf->b_fschanged
+        && path_fnamecmp(buf->b_fswatcher->path, buf->b_ffname) == 0) {
+      return;
+    }
+    buf_unwatch_file(buf);
+  }
+  buf->b_fschanged = false;
+  buf->b_fswatcher = fs_watcher_start(&main_loop, buf->b_ffname, buf_file_changed_cb, buf);
+}
+
+/// Stops watching the file of "buf", when it is unloaded or hidden.
+void buf_unwatch_file(buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (buf->b_fswatcher != NULL) {
+    fs_watcher_stop(buf->b_fswatcher);
+    buf->b_fswatcher = NULL;
+  }
+}
+
+static void buf_file_changed_cb(FsWatcher *watcher, void *data)
+{
+  buf_T *buf = data;
+  buf->b_fschanged = true;
+}
+
+/// @return  false if the file of "buf" is watched and did not change since it
+///          was last checked, true if it needs to be checked.
+static bool buf_file_maybe_changed(buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  FsWatcher *watcher = buf->b_fswatcher;
+  if (watcher == NULL) {
+    // Not watched while hidden, let following checks use a watcher.
+    buf_watch_file(buf, false);
+    return true;
+  }
+  if (buf->b_ffname == NULL || buf->b_mtime <= 0
+      || (buf->b_flags & BF_NOTEDITED)
+      || path_fnamecmp(watcher->path, buf->b_ffname) != 0) {
+    return true;
+  }
+  if (!buf->b_fschanged) {
+    return false;
+  }
+  // Before checking, so that no change made meanwhile is missed.
+  buf_watch_file(buf, true);
+  return true;
 }
 
 /// Adjust the line with missing eol, used for the next write.
@@ -3578,6 +3756,67 @@ bool match_file_pat(char *pattern, regprog_T **prog, char *fname, char *sfname,
   return result;
 }
 
+/// Check if file pattern "pat[patlen]" is text without wildcards or path
+/// separators, like "lua", possibly after leading stars, like "*.c" and "*".
+/// Such a pattern only matches the tail of a file name, which can be checked
+/// with match_file_literal() instead of a regexp.
+///
+/// @return  the offset of the text after the stars, -1 for other patterns.
+int file_pat_literal_off(const char *pat, size_t patlen)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t off = 0;
+  while (off < patlen && pat[off] == '*') {
+    off++;
+  }
+  for (size_t i = off; i < patlen; i++) {
+    if (vim_strchr("*?[]{},\\^$", (uint8_t)pat[i]) != NULL || vim_ispathsep(pat[i])) {
+      return -1;
+    }
+  }
+  return patlen == 0 ? -1 : (int)off;
+}
+
+/// Match the tail of a file name with the text of a pattern found with
+/// file_pat_literal_off().
+///
+/// @param lit     text of the pattern after the stars
+/// @param litlen  length of "lit"
+/// @param star    the pattern starts with a star, "tail" must end in "lit"
+/// @param taillen result of match_file_literal_len() for "tail"
+///
+/// @return  kNone when a regexp is needed: with 'fileignorecase' or when the
+///          tail is not ASCII, there may be case folding or composing characters.
+TriState match_file_literal(const char *lit, size_t litlen, bool star, const char *tail,
+                            int taillen)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  if (p_fic || taillen < 0) {
+    return kNone;
+  }
+  const size_t len = (size_t)taillen;
+  if (star ? len < litlen : len != litlen) {
+    return kFalse;
+  }
+  return memcmp(tail + len - litlen, lit, litlen) == 0 ? kTrue : kFalse;
+}
+
+/// Get the length of file name tail "tail" for match_file_literal(), so that it
+/// can be computed once when matching with many patterns.
+///
+/// @return  the length of "tail", -1 when it is not ASCII.
+int match_file_literal_len(const char *tail)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t len = 0;
+  for (; tail[len] != NUL; len++) {
+    if ((uint8_t)tail[len] >= 0x80) {
+      return -1;
+    }
+  }
+  return len > INT_MAX ? -1 : (int)len;
+}
+
 /// Check if a file matches with a pattern in "list".
 /// "list" is a comma-separated list of patterns, like 'wildignore'.
 /// "sfname" is the short file name or NULL, "ffname" the long file name.
@@ -3591,12 +3830,23 @@ bool match_file_list(char *list, char *sfname, char *ffname)
   FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ARG(1, 3)
 {
   char *tail = path_tail(sfname);
+  const int tail_len = match_file_literal_len(tail);
 
   // try all patterns in 'wildignore'
   char *p = list;
   while (*p) {
     char buf[MAXPATHL];
-    copy_option_part(&p, buf, ARRAY_SIZE(buf), ",");
+    size_t len = copy_option_part(&p, buf, ARRAY_SIZE(buf), ",");
+    const int off = file_pat_literal_off(buf, len);
+    if (off >= 0) {
+      const TriState res = match_file_literal(buf + off, len - (size_t)off, off > 0, tail,
+                                                tail_len);
+      if (res == kTrue) {
+        return true;
+      } else if (res == kFalse) {
+        continue;
+      }
+    }
     char allow_dirs;
     char *regpat = file_pat_to_reg_pat(buf, NULL, &allow_dirs, false);
     if (regpat == NULL) {
@@ -942,6 +942,12 @@ int ins_typebuf(char *str, int noremap, int offset, bool nottyped, bool silent)
     // Leave some space before and after, if possible.
     typebuf.tb_off = (typebuf.tb_buflen - addlen - 3 * (MAXMAPLEN + 4)) / 2;
     memmove(typebuf.tb_buf + typebuf.tb_off, str, (size_t)addlen);
+  } else if (offset == typebuf.tb_len
+             && typebuf.tb_buflen - typebuf.tb_off - typebuf.tb_len
+             >= addlen + 3 * (MAXMAPLEN + 4)) {
+    // Appending and there is room after the last character, e.g. for
+    // feedkeys(): copy the new chars including the NUL.
+    memmove(typebuf.tb_buf + typebuf.tb_off + offset, str, (size_t)addlen + 1);
   } else {
     // Need to allocate a new buffer.
     // In typebuf.tb_buf there must always be room for 3 * (MAXMAPLEN + 4)
@@ -955,6 +961,14 @@ int ins_typebuf(char *str, int noremap, int offset, bool nottyped, bool silent)
       setcursor();
       return FAIL;
     }
+    // Also leave room in proportion to the contents, on the side where chars
+    // are added, so that adding many strings one by one (mappings expanding
+    // in front, feedkeys() at the end) doesn't copy everything each time.
+    int grow = MIN((typebuf.tb_len + addlen) / 2, INT_MAX - extra - typebuf.tb_len);
+    if (offset == 0) {
+      newoff += grow;
+    }
+    extra += grow;
     int newlen = typebuf.tb_len + extra;
     uint8_t *s1 = xmalloc((size_t)newlen);
     uint8_t *s2 = xmalloc((size_t)newlen);
@@ -1492,7 +1506,7 @@ int using_script(void)
 void before_blocking(void)
 {
   updatescript(0);
-  if (may_garbage_collect) {
+  if (may_garbage_collect && need_garbage_collect) {
     garbage_collect(false);
   }
 }
@@ -2225,37 +2239,46 @@ static int handle_mapping(int *keylenp, const bool *timedout, int *mapdepth)
     // and "aaa" can both be mapped.
     mp_match = NULL;
     mp_match_len = 0;
+    // The typeahead as compared with the mappings, with 'langmap' applied.
+    // It doesn't depend on the mapping, thus it is computed only once, as far
+    // as needed for the mappings checked so far.
+    kvec_withinit_t(int, MAXMAPLEN + 1) tb_keys;
+    kvi_init(tb_keys);
+    kvi_push(tb_keys, tb_c1);
+    int nomap = nolmaplen;
+    int modifiers = 0;
     for (; mp != NULL; mp->m_next == NULL ? (mp = mp2, mp2 = NULL) : (mp = mp->m_next)) {
       // Only consider an entry if the first character matches and it is
       // for the current state.
       // Skip ":lmap" mappings if keys were mapped.
       if ((uint8_t)mp->m_keys[0] == tb_c1 && (mp->m_mode & local_State)
           && ((mp->m_mode & MODE_LANGMAP) == 0 || typebuf.tb_maplen == 0)) {
-        int nomap = nolmaplen;
-        int modifiers = 0;
         // find the match length of this mapping
         for (mlen = 1; mlen < typebuf.tb_len; mlen++) {
-          int c2 = typebuf.tb_buf[typebuf.tb_off + mlen];
-          if (nomap > 0) {
-            if (nomap == 2 && c2 == KS_MODIFIER) {
-              modifiers = 1;
-            } else if (nomap == 1 && modifiers == 1) {
-              modifiers = c2;
-            }
-            nomap--;
-          } else {
-            if (c2 == K_SPECIAL) {
-              nomap = 2;
-            } else if (merge_modifiers(c2, &modifiers) == c2) {
-              // Only apply 'langmap' if merging modifiers into
-              // the key will not result in another character,
-              // so that 'langmap' behaves consistently in
-              // different terminals and GUIs.
-              LANGMAP_ADJUST(c2, true);
+          if (mlen == (int)kv_size(tb_keys)) {
+            int c2 = typebuf.tb_buf[typebuf.tb_off + mlen];
+            if (nomap > 0) {
+              if (nomap == 2 && c2 == KS_MODIFIER) {
+                modifiers = 1;
+              } else if (nomap == 1 && modifiers == 1) {
+                modifiers = c2;
+              }
+              nomap--;
+            } else {
+              if (c2 == K_SPECIAL) {
+                nomap = 2;
+              } else if (merge_modifiers(c2, &modifiers) == c2) {
+                // Only apply 'langmap' if merging modifiers into
+                // the key will not result in another character,
+                // so that 'langmap' behaves consistently in
+                // different terminals and GUIs.
+                LANGMAP_ADJUST(c2, true);
+              }
+              modifiers = 0;
             }
-            modifiers = 0;
+            kvi_push(tb_keys, c2);
           }
-          if ((uint8_t)mp->m_keys[mlen] != c2) {
+          if ((uint8_t)mp->m_keys[mlen] != kv_A(tb_keys, mlen)) {
             break;
           }
         }
@@ -2318,6 +2341,7 @@ static int handle_mapping(int *keylenp, const bool *timedout, int *mapdepth)
         }
       }
     }
+    kvi_destroy(tb_keys);
 
     // If no partly match found, use the longest full match.
     if (keylen != KEYLEN_PART_MAP && mp_match != NULL) {
@@ -81,11 +81,33 @@
 # define VIMRC_LUA_FILE ".nvim.lua"
 #endif
 
+/// Number of buckets of the duration histograms in g_stats, see stats_hist_add().
+#define STATS_HIST_SIZE 8
+
 EXTERN struct nvim_stats_s {
   int64_t fsync;
-  int64_t redraw;
+  int64_t redraw;  // update_screen() calls that redrew something.
+  int64_t redraw_ns;  // Time spent in update_screen().
+  int64_t redraw_hist[STATS_HIST_SIZE];  // Durations of update_screen().
+  int64_t win_line;  // Buffer lines drawn by win_line().
+  int64_t win_line_ns;  // Time spent in win_line().
+  int64_t compositor_ns;  // Time spent composing lines for the UIs.
+  int64_t ui_encode_ns;  // Time spent encoding lines and flushes for remote UIs.
+  int64_t input_ns;  // Time from input arrival until the screen update showing it started.
+  int64_t input_latency;  // Inputs shown on the screen, see input_latency_flushed().
+  int64_t input_latency_ns;  // Time from input arrival until the screen was flushed.
+  int64_t input_latency_hist[STATS_HIST_SIZE];  // Durations of input latencies.
   int16_t log_skip;  // How many logs were tried and skipped before log_init.
-} g_stats INIT( = { 0, 0, 0 });
+  int64_t memfile_hit;  // Memfile blocks found in memory.
+  int64_t memfile_miss;  // Memfile blocks read from the swap file.
+  int64_t memfile_release;  // Memfile blocks released by mf_release_all().
+  int64_t ml_locked_hit;  // ml_find_line() found the line in the locked block.
+  int64_t ml_tree_search;  // ml_find_line() searched the block tree.
+  int64_t regexp_exec;  // Regexp matches tried.
+  int64_t rpc_request;  // RPC requests and notifications handled.
+  int64_t rpc_request_ns;  // Time spent handling them.
+  int64_t rpc_hist[STATS_HIST_SIZE];  // Durations of RPC requests.
+} g_stats INIT( = { 0 });
 
 // Values for "starting".
 #define NO_SCREEN       2       // no screen updating yet
@@ -221,6 +243,7 @@ EXTERN int debug_backtrace_level INIT( = 0);     // breakpoint backtrace level
 #define PROF_YES        1       ///< profiling busy
 #define PROF_PAUSED     2       ///< profiling paused
 EXTERN int do_profiling INIT( = PROF_NONE);      ///< PROF_ values
+EXTERN bool do_tracing INIT( = false);           ///< recording spans, see trace_start()
 
 /// Exception currently being thrown.  Used to pass an exception to a different
 /// cstack.  Also used for discarding an exception before it is caught or made
@@ -280,9 +303,13 @@ EXTERN except_T *caught_stack INIT( = NULL);
 /// "want_garbage_collect" is set by the garbagecollect() function, which means
 /// we do garbage collection before waiting for a char at the toplevel.
 /// "garbage_collect_at_exit" indicates garbagecollect(1) was called.
+/// "need_garbage_collect" is set when a reference to a List, Dictionary,
+/// Partial or funccall was dropped without freeing it.  Only then can a cycle
+/// have become unreachable, otherwise the idle garbage collection is skipped.
 ///
 EXTERN bool may_garbage_collect INIT( = false);
 EXTERN bool want_garbage_collect INIT( = false);
+EXTERN bool need_garbage_collect INIT( = false);
 EXTERN bool garbage_collect_at_exit INIT( = false);
 
 // Special values for current_SID.
@@ -54,6 +54,9 @@ static size_t linebuf_size = 0;
 // The maximum byte size of a glyph is MAX_SCHAR_SIZE (including the final NUL).
 static Set(glyph) glyph_cache = SET_INIT;
 
+// The cache being replaced while compacting glyph_cache, see schar_cache_compact_start().
+static Set(glyph) glyph_cache_old = SET_INIT;
+
 /// Determine if dedicated window grid should be used or the default_grid
 ///
 /// If UI did not request multigrid support, draw all windows on the
@@ -113,13 +116,35 @@ bool schar_cache_clear_if_full(void)
 {
   // note: critical max is really (1<<24)-1. This gives us some marginal
   // until next time update_screen() is called
-  if (glyph_cache.h.n_keys > (1<<21)) {
+  if (schar_cache_full()) {
     schar_cache_clear();
     return true;
   }
   return false;
 }
 
+/// @return true if the cache must be cleared or compacted before interning many
+/// more glyphs.
+bool schar_cache_full(void)
+{
+  return glyph_cache.h.n_keys > (1<<21);
+}
+
+/// Start compacting the cache: glyphs are interned into a new, empty cache,
+/// and every schar_T value which is kept must be passed to schar_cache_remap()
+/// before schar_cache_compact_finish() frees the old cache.
+void schar_cache_compact_start(void)
+{
+  assert(glyph_cache_old.keys == NULL);
+  glyph_cache_old = glyph_cache;
+  glyph_cache = (Set(glyph))SET_INIT;
+}
+
+void schar_cache_compact_finish(void)
+{
+  set_destroy(glyph, &glyph_cache_old);
+}
+
 void schar_cache_clear(void)
 {
   decor_check_invalid_glyphs();
@@ -148,6 +173,29 @@ bool schar_high(schar_T sc)
 # define schar_idx(sc) (sc >> 8)
 #endif
 
+/// Translate "sc" from the old cache to the new one while compacting.
+schar_T schar_cache_remap(schar_T sc)
+{
+  if (!schar_high(sc)) {
+    return sc;
+  }
+  uint32_t idx = schar_idx(sc);
+  assert(idx < glyph_cache_old.h.n_keys);
+  return schar_from_str(&glyph_cache_old.keys[idx]);
+}
+
+/// Translate all cells of "grid" while compacting.
+void grid_remap_glyphs(ScreenGrid *grid)
+{
+  if (grid->chars == NULL) {
+    return;
+  }
+  size_t ncells = (size_t)grid->rows * (size_t)grid->cols;
+  for (size_t off = 0; off < ncells; off++) {
+    grid->chars[off] = schar_cache_remap(grid->chars[off]);
+  }
+}
+
 /// sets final NUL
 size_t schar_get(char *buf_out, schar_T sc)
 {
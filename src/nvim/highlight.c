@@ -44,6 +44,15 @@ static Map(int, int) blend_attr_entries = MAP_INIT;
 static Map(int, int) blendthrough_attr_entries = MAP_INIT;
 static Set(cstr_t) urls = SET_INIT;
 
+/// Direct-mapped cache in front of combine_attr_entries.  hl_combine_attr() is
+/// called for every cell with cursorline, Visual, search or diagnostics
+/// highlighting, and the same few pairs repeat.  An "id" of zero is unused.
+#define COMBINE_CACHE_BITS 8
+static struct {
+  int tag;
+  int id;
+} combine_attr_cache[1 << COMBINE_CACHE_BITS];
+
 #define attr_entry(i) attr_entries.keys[i]
 
 /// highlight entries private to a namespace
@@ -544,6 +553,7 @@ void clear_hl_tables(bool reinit)
     set_clear(HlEntry, &attr_entries);
     highlight_init();
     map_clear(int, &combine_attr_entries);
+    CLEAR_FIELD(combine_attr_cache);
     map_clear(int, &blend_attr_entries);
     map_clear(int, &blendthrough_attr_entries);
     set_clear(cstr_t, &urls);
@@ -595,8 +605,14 @@ int hl_combine_attr(int char_attr, int prim_attr)
 
   // TODO(bfredl): could use a struct for clearer intent.
   int combine_tag = (char_attr << 16) + prim_attr;
+  uint32_t slot = ((uint32_t)combine_tag * 2654435761U) >> (32 - COMBINE_CACHE_BITS);
+  if (combine_attr_cache[slot].tag == combine_tag && combine_attr_cache[slot].id > 0) {
+    return combine_attr_cache[slot].id;
+  }
   int id = map_get(int, int)(&combine_attr_entries, combine_tag);
   if (id > 0) {
+    combine_attr_cache[slot].tag = combine_tag;
+    combine_attr_cache[slot].id = id;
     return id;
   }
 
@@ -657,6 +673,8 @@ int hl_combine_attr(int char_attr, int prim_attr)
                                  .id1 = char_attr, .id2 = prim_attr });
   if (id > 0) {
     map_put(int, int)(&combine_attr_entries, combine_tag, id);
+    combine_attr_cache[slot].tag = combine_tag;
+    combine_attr_cache[slot].id = id;
   }
 
   return id;
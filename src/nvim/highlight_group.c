@@ -900,6 +900,16 @@ static int lookup_color(const int idx, const bool foreground, TriState *const bo
   return color;
 }
 
+/// Check if a highlight group was changed in another way than where it was
+/// last set, which does not need a redraw.
+static bool hl_group_changed(const HlGroup *before, const HlGroup *after)
+{
+  HlGroup item = *before;
+  item.sg_script_ctx = after->sg_script_ctx;
+  item.sg_deflink_sctx = after->sg_deflink_sctx;
+  return memcmp(&item, after, sizeof(item)) != 0;
+}
+
 void set_hl_group(int id, HlAttrs attrs, Dict(highlight) *dict, int link_id)
 {
   int idx = id - 1;  // Index is ID minus one.
@@ -911,6 +921,7 @@ void set_hl_group(int id, HlAttrs attrs, Dict(highlight) *dict, int link_id)
   }
 
   HlGroup *g = &hl_table[idx];
+  HlGroup item_before = *g;
   g->sg_cleared = false;
 
   if (link_id > 0) {
@@ -991,6 +1002,12 @@ void set_hl_group(int id, HlAttrs attrs, Dict(highlight) *dict, int link_id)
     }
   }
 
+  // Setting a group again to the same value, as a colorscheme preview does
+  // for most groups, changes nothing on the screen.
+  if (!hl_group_changed(&item_before, g)) {
+    return;
+  }
+
   if (!updating_screen) {
     redraw_all_later(UPD_NOT_VALID);
   }
@@ -1105,6 +1122,8 @@ void do_highlight(const char *line, const bool forceit, const bool init)
       } else if (hlgroup->sg_link != to_id
                  || hlgroup->sg_script_ctx.sc_sid != current_sctx.sc_sid
                  || hlgroup->sg_cleared) {
+        // Only a different script, the screen does not change.
+        bool changed = hlgroup->sg_link != to_id || hlgroup->sg_cleared;
         if (!init) {
           hlgroup->sg_set |= SG_LINK;
         }
@@ -1113,10 +1132,12 @@ void do_highlight(const char *line, const bool forceit, const bool init)
         hlgroup->sg_script_ctx.sc_lnum += SOURCING_LNUM;
         nlua_set_sctx(&hlgroup->sg_script_ctx);
         hlgroup->sg_cleared = false;
-        redraw_all_later(UPD_SOME_VALID);
+        if (changed) {
+          redraw_all_later(UPD_SOME_VALID);
 
-        // Only call highlight changed() once after multiple changes
-        need_highlight_changed = true;
+          // Only call highlight changed() once after multiple changes
+          need_highlight_changed = true;
+        }
       }
     }
 
@@ -1516,8 +1537,7 @@ void do_highlight(const char *line, const bool forceit, const bool init)
 
   // Only call highlight_changed() once, after a sequence of highlight
   // commands, and only if an attribute actually changed
-  if ((did_change
-       || memcmp(&hl_table[idx], &item_before, sizeof(item_before)) != 0)
+  if ((did_change || hl_group_changed(&item_before, &hl_table[idx]))
       && !did_highlight_changed) {
     // Do not trigger a redraw when highlighting is changed while
     // redrawing.  This may happen when evaluating 'statusline' changes the
@@ -998,6 +998,7 @@ void op_reindent(oparg_T *oap, Indenter how)
   if (u_savecommon(curbuf, start_lnum - 1, start_lnum + oap->line_count,
                    start_lnum + oap->line_count, false) == OK) {
     int amount;
+    cindent_memo_clear();
     for (i = oap->line_count - 1; i >= 0 && !got_int; i--) {
       // it's a slow thing to do, so give feedback so there's no worry
       // that the computer's just hung.
@@ -1018,7 +1019,9 @@ void op_reindent(oparg_T *oap, Indenter how)
         } else {
           amount = how();                     // get the indent for this line
         }
+        varnumber_T prev_tick = buf_get_changedtick(curbuf);
         if (amount >= 0 && set_indent(amount, 0)) {
+          cindent_indent_changed(prev_tick);
           // did change the indent, call changed_lines() later
           if (first_changed == 0) {
             first_changed = curwin->w_cursor.lnum;
@@ -5,6 +5,7 @@
 #include <string.h>
 
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
 #include "nvim/cursor.h"
@@ -36,6 +37,16 @@ typedef struct {
   lpos_T lpos;
 } cpp_baseclass_cache_T;
 
+// Result of find_start_brace() for the start of line "lnum", see
+// start_brace_memo_get().
+static struct {
+  handle_T buf;
+  varnumber_T changedtick;
+  linenr_T lnum;
+  linenr_T brace_lnum;   // line of the '{', zero when there is none
+  colnr_T brace_off;     // column of the '{' after the indent of its line
+} start_brace_memo;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "indent_c.c.generated.h"
 #endif
@@ -1424,6 +1435,11 @@ static pos_T *find_start_brace(void)  // XXX
   pos_T *pos;
   static pos_T pos_copy;
 
+  bool at_bol = curwin->w_cursor.col == 0;
+  if (at_bol && start_brace_memo_get(&pos_copy)) {
+    return pos_copy.lnum == 0 ? NULL : &pos_copy;
+  }
+
   cursor_save = curwin->w_cursor;
   while ((trypos = findmatchlimit(NULL, '{', FM_BLOCKSTOP, 0)) != NULL) {
     pos_copy = *trypos;         // copy pos_T, next findmatch will change it
@@ -1440,9 +1456,69 @@ static pos_T *find_start_brace(void)  // XXX
     }
   }
   curwin->w_cursor = cursor_save;
+
+  if (at_bol && !got_int) {
+    start_brace_memo.buf = curbuf->handle;
+    start_brace_memo.changedtick = buf_get_changedtick(curbuf);
+    start_brace_memo.lnum = cursor_save.lnum;
+    start_brace_memo.brace_lnum = 0;
+    if (trypos != NULL) {
+      start_brace_memo.brace_lnum = trypos->lnum;
+      start_brace_memo.brace_off = trypos->col - (colnr_T)getwhitecols(ml_get(trypos->lnum));
+    }
+  }
   return trypos;
 }
 
+/// When re-indenting many lines, find_start_brace() would search back from
+/// every line to the same '{'.  Reuse the result for a previous line when the
+/// lines in between contain nothing findmatchlimit() and the comment checks
+/// look at.  Only changing the indent of lines keeps the result valid, see
+/// cindent_indent_changed().
+///
+/// @param[out] pos  the '{', lnum is zero when there is none
+///
+/// @return  false when the result must be searched for.
+static bool start_brace_memo_get(pos_T *pos)
+{
+  linenr_T lnum = curwin->w_cursor.lnum;
+  if (start_brace_memo.buf != curbuf->handle
+      || start_brace_memo.changedtick != buf_get_changedtick(curbuf)
+      || start_brace_memo.lnum == 0 || start_brace_memo.lnum > lnum) {
+    return false;
+  }
+  for (linenr_T l = start_brace_memo.lnum; l < lnum; l++) {
+    if (strpbrk(ml_get(l), "{}\"'/\\") != NULL) {
+      return false;
+    }
+  }
+  start_brace_memo.lnum = lnum;
+
+  *pos = (pos_T){ 0 };
+  if (start_brace_memo.brace_lnum != 0) {
+    pos->lnum = start_brace_memo.brace_lnum;
+    pos->col = (colnr_T)getwhitecols(ml_get(pos->lnum)) + start_brace_memo.brace_off;
+  }
+  return true;
+}
+
+/// Forget the find_start_brace() result, the options it depends on may have
+/// changed.  Called by op_reindent() before it starts.
+void cindent_memo_clear(void)
+{
+  start_brace_memo.lnum = 0;
+}
+
+/// Called by op_reindent() after changing only the indent of the cursor line,
+/// changedtick was "prev_tick" before.  Keeps the find_start_brace() result
+/// valid, since it only depends on the text after the indent.
+void cindent_indent_changed(varnumber_T prev_tick)
+{
+  if (start_brace_memo.buf == curbuf->handle && start_brace_memo.changedtick == prev_tick) {
+    start_brace_memo.changedtick = buf_get_changedtick(curbuf);
+  }
+}
+
 /// Find the matching '(', ignoring it if it is in a comment.
 /// @returns NULL or the found match.
 static pos_T *find_match_paren(int ind_maxparen)
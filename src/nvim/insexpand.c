@@ -47,6 +47,7 @@
 #include "nvim/keycodes.h"
 #include "nvim/lua/executor.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
@@ -64,6 +65,7 @@
 #include "nvim/path.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
+#include "nvim/profile.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
 #include "nvim/search.h"
@@ -3531,6 +3533,10 @@ enum {
   INS_COMPL_CPT_END,
 };
 
+/// Time in msec between checks for typed keys while 'complete' sources
+/// without a new match are scanned.
+enum { COMPL_CHECK_KEYS_MSEC = 10, };
+
 /// Process the next 'complete' option value in st->e_cpt.
 ///
 /// If successful, the arguments are set as below:
@@ -4054,6 +4060,240 @@ static char *ins_compl_get_next_word_or_line(buf_T *ins_buf, pos_T *cur_match_po
   return ptr;
 }
 
+/// The distinct words of a buffer for ^N/^P, so that a buffer that didn't
+/// change does not have to be searched again.
+typedef struct {
+  char *cw_word;
+  int cw_len;
+  int cw_last;       ///< number of the last occurrence of the word
+} complword_T;
+
+struct compl_words_S {
+  varnumber_T cws_changedtick;  ///< b:changedtick when the words were found
+  uint64_t cws_chartab[4];      ///< b_chartab when the words were found
+  bool cws_usable;              ///< false when the text is not all ASCII
+  kvec_t(complword_T) cws_words;  ///< in order of the first occurrence
+  int *cws_sorted;              ///< indexes in "cws_words", sorted ignoring case
+};
+
+/// Compare two words ignoring case, only ASCII is used.
+static int compl_word_cmp(const char *s1, int len1, const char *s2, int len2)
+{
+  for (int i = 0; i < len1 && i < len2; i++) {
+    int d = TOLOWER_ASC((uint8_t)s1[i]) - TOLOWER_ASC((uint8_t)s2[i]);
+    if (d != 0) {
+      return d;
+    }
+  }
+  return len1 - len2;
+}
+
+static const compl_words_T *compl_words_sorting;  ///< used by compl_word_sort_cmp()
+
+static int compl_word_sort_cmp(const void *a, const void *b)
+{
+  const complword_T *w1 = &kv_A(compl_words_sorting->cws_words, *(const int *)a);
+  const complword_T *w2 = &kv_A(compl_words_sorting->cws_words, *(const int *)b);
+  return compl_word_cmp(w1->cw_word, w1->cw_len, w2->cw_word, w2->cw_len);
+}
+
+static int compl_word_first_cmp(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+static int compl_word_last_cmp(const void *a, const void *b)
+{
+  const complword_T *w1 = &kv_A(compl_words_sorting->cws_words, *(const int *)a);
+  const complword_T *w2 = &kv_A(compl_words_sorting->cws_words, *(const int *)b);
+  return w2->cw_last - w1->cw_last;  // last occurrence first
+}
+
+/// Free the words of "buf" found for completion.
+void ins_compl_free_buf_words(buf_T *buf)
+{
+  compl_words_T *cws = buf->b_compl_words;
+  if (cws == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < kv_size(cws->cws_words); i++) {
+    xfree(kv_A(cws->cws_words, i).cw_word);
+  }
+  kv_destroy(cws->cws_words);
+  xfree(cws->cws_sorted);
+  XFREE_CLEAR(buf->b_compl_words);
+}
+
+/// Find the words in "buf": the text that "\<\k\+" matches.  Only done for
+/// text that is all ASCII, then the start and end of a word only depend on
+/// 'iskeyword'.
+static void compl_find_buf_words(buf_T *buf, compl_words_T *cws)
+{
+  Map(cstr_t, int) seen = MAP_INIT;  // word to index in "cws_words" + 1
+  garray_T word;
+  ga_init(&word, 1, 80);
+  int occurrence = 0;
+
+  cws->cws_usable = true;
+  for (linenr_T lnum = 1; lnum <= buf->b_ml.ml_line_count && cws->cws_usable; lnum++) {
+    const char *line = ml_get_buf(buf, lnum);
+    const int len = ml_get_buf_len(buf, lnum);
+    for (int col = 0; col < len;) {
+      if ((uint8_t)line[col] >= 0x80) {
+        cws->cws_usable = false;
+        break;
+      }
+      if (!vim_iswordc_tab((uint8_t)line[col], buf->b_chartab)) {
+        col++;
+        continue;
+      }
+      int end = col;
+      while (end < len && (uint8_t)line[end] < 0x80
+             && vim_iswordc_tab((uint8_t)line[end], buf->b_chartab)) {
+        end++;
+      }
+      ga_clear(&word);
+      ga_concat_len(&word, line + col, (size_t)(end - col));
+      ga_append(&word, NUL);
+      occurrence++;
+      int *idx = map_ref(cstr_t, int)(&seen, (const char *)word.ga_data, NULL);
+      if (idx != NULL) {
+        kv_A(cws->cws_words, *idx - 1).cw_last = occurrence;
+      } else {
+        char *w = xmemdupz(line + col, (size_t)(end - col));
+        kv_push(cws->cws_words, ((complword_T){ w, end - col, occurrence }));
+        map_put(cstr_t, int)(&seen, w, (int)kv_size(cws->cws_words));
+      }
+      col = end;
+    }
+  }
+  map_destroy(cstr_t, &seen);
+  ga_clear(&word);
+
+  if (!cws->cws_usable) {
+    return;
+  }
+  const size_t n = kv_size(cws->cws_words);
+  cws->cws_sorted = xmalloc(MAX(n, 1) * sizeof(int));
+  for (size_t i = 0; i < n; i++) {
+    cws->cws_sorted[i] = (int)i;
+  }
+  compl_words_sorting = cws;
+  qsort(cws->cws_sorted, n, sizeof(int), compl_word_sort_cmp);
+  compl_words_sorting = NULL;
+}
+
+/// Get the words of "buf" for completion, finding them when the buffer
+/// changed.
+///
+/// @return  NULL when the words can't be used, search the buffer then.
+static compl_words_T *compl_get_buf_words(buf_T *buf)
+{
+  compl_words_T *cws = buf->b_compl_words;
+  if (cws != NULL && (cws->cws_changedtick != buf_get_changedtick(buf)
+                      || memcmp(cws->cws_chartab, buf->b_chartab, sizeof(buf->b_chartab)) != 0)) {
+    ins_compl_free_buf_words(buf);
+    cws = NULL;
+  }
+  if (cws == NULL) {
+    cws = buf->b_compl_words = xcalloc(1, sizeof(compl_words_T));
+    cws->cws_changedtick = buf_get_changedtick(buf);
+    memcpy(cws->cws_chartab, buf->b_chartab, sizeof(buf->b_chartab));
+    compl_find_buf_words(buf, cws);
+  }
+  return cws->cws_usable ? cws : NULL;
+}
+
+/// Return true when the matches of "compl_pattern" in buffer "buf" can be
+/// taken from its words: for a keyword completion that is not adding and
+/// when "buf" and the current buffer have the same keyword characters.
+static bool compl_can_use_buf_words(buf_T *buf)
+{
+  if (!ctrl_x_mode_normal() || (compl_cont_status & CONT_SOL) || compl_status_adding()
+      || ins_compl_has_preinsert()
+      || memcmp(buf->b_chartab, curbuf->b_chartab, sizeof(buf->b_chartab)) != 0
+      || (compl_length > 0 && (compl_orig_text.data == NULL
+                               || (int)compl_orig_text.size < compl_length))) {
+    return false;
+  }
+  for (int i = 0; i < compl_length; i++) {
+    if ((uint8_t)compl_orig_text.data[i] >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Add the words of buffer "st->ins_buf" that match "compl_pattern", in the
+/// same order as searching the buffer from the start or the end would find
+/// them.  As all matches are added "st->found_all" is set.
+///
+/// @return  OK when a new match was added, FAIL otherwise,
+///          NOTDONE when the words can't be used.
+static int compl_add_buf_words(ins_compl_next_state_T *st)
+{
+  buf_T *buf = st->ins_buf;
+  compl_words_T *cws = compl_get_buf_words(buf);
+  if (cws == NULL) {
+    return NOTDONE;
+  }
+
+  // The pattern is "\<\k\k", "\<x\k" or "\<prefix", see
+  // get_normal_compl_info().
+  const char *prefix = compl_orig_text.data;
+  const int prefixlen = compl_length;
+  const int minlen = MAX(compl_length, 2);
+  const bool icase = ignorecase(compl_pattern.data);
+
+  // Find the words starting with "prefix" ignoring case.
+  const int n = (int)kv_size(cws->cws_words);
+  int lo = 0;
+  int hi = n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    const complword_T *w = &kv_A(cws->cws_words, cws->cws_sorted[mid]);
+    if (compl_word_cmp(w->cw_word, MIN(w->cw_len, prefixlen), prefix, prefixlen) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  kvec_t(int) found = KV_INITIAL_VALUE;
+  for (int i = lo; i < n; i++) {
+    const int idx = cws->cws_sorted[i];
+    const complword_T *w = &kv_A(cws->cws_words, idx);
+    if (compl_word_cmp(w->cw_word, MIN(w->cw_len, prefixlen), prefix, prefixlen) != 0) {
+      break;
+    }
+    if (w->cw_len >= minlen && (icase || strncmp(w->cw_word, prefix, (size_t)prefixlen) == 0)) {
+      kv_push(found, idx);
+    }
+  }
+
+  // Forward the first occurrence is found first, backward the last one.
+  if (compl_dir_forward()) {
+    qsort(found.items, kv_size(found), sizeof(int), compl_word_first_cmp);
+  } else {
+    compl_words_sorting = cws;
+    qsort(found.items, kv_size(found), sizeof(int), compl_word_last_cmp);
+    compl_words_sorting = NULL;
+  }
+
+  int ret = FAIL;
+  for (size_t i = 0; i < kv_size(found); i++) {
+    complword_T *w = &kv_A(cws->cws_words, kv_A(found, i));
+    if (ins_compl_add_infercase(w->cw_word, w->cw_len, p_ic, buf->b_sfname, 0, false, 0)
+        != NOTDONE) {
+      ret = OK;
+    }
+  }
+  kv_destroy(found);
+
+  st->found_all = true;
+  buf->b_scanned = true;
+  return ret;
+}
+
 /// Get the next set of words matching "compl_pattern" for default completion(s)
 /// (normal ^P/^N and ^X^L).
 /// Search for "compl_pattern" in the buffer "st->ins_buf" starting from the
@@ -4089,8 +4329,16 @@ static int get_next_default_completion(ins_compl_next_state_T *st, pos_T *start_
     p_ws = true;
   }
   bool looped_around = false;
-  int found_new_match = FAIL;
-  while (true) {
+  int found_new_match = NOTDONE;
+  // For another buffer the words may be known already.
+  if (!in_curbuf && !in_collect && compl_can_use_buf_words(st->ins_buf)) {
+    found_new_match = compl_add_buf_words(st);
+  }
+  const bool used_words = found_new_match != NOTDONE;
+  if (!used_words) {
+    found_new_match = FAIL;
+  }
+  while (!used_words) {
     bool cont_s_ipos = false;
 
     msg_silent++;  // Don't want messages for wrapscan.
@@ -4571,6 +4819,15 @@ static int ins_compl_get_exp(pos_T *ini)
       }
 
       compl_started = false;
+
+      // Going through many sources without a new match can take long, also
+      // check for typed keys then.  The search continues with the next
+      // source when completion isn't stopped.
+      if (type != -1 && ins_compl_check_keys_timed() && compl_interrupted) {
+        st.found_all = true;
+        found_new_match = OK;
+        break;
+      }
     }
 
     // For `^P` completion, reset `compl_curr_match` to the head to avoid
@@ -5118,6 +5375,22 @@ void ins_compl_check_keys(int frequency, bool in_compl_func)
   }
 }
 
+/// Like ins_compl_check_keys(), but only when COMPL_CHECK_KEYS_MSEC passed
+/// since the last check.
+///
+/// @return  true when keys were checked.
+static bool ins_compl_check_keys_timed(void)
+{
+  static proftime_T next_check = 0;
+
+  if (next_check != 0 && !profile_passed_limit(next_check)) {
+    return false;
+  }
+  next_check = profile_setlimit(COMPL_CHECK_KEYS_MSEC);
+  ins_compl_check_keys(0, false);
+  return true;
+}
+
 /// Decide the direction of Insert mode complete from the key typed.
 /// Returns BACKWARD or FORWARD.
 static int ins_compl_key2dir(int c)
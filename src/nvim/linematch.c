@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "nvim/linematch.h"
 #include "nvim/macros_defs.h"
@@ -12,6 +13,7 @@
 
 #define LN_MAX_BUFS 8
 #define LN_DECISION_MAX 255  // pow(2, LN_MAX_BUFS(8)) - 1 = 255
+#define LN_MAX_TENSOR_SIZE (64 * 1024 * 1024)  // bytes used for the tensor at most
 
 // struct for running the diff linematch algorithm
 typedef struct diffcmppath_S diffcmppath_T;
@@ -24,6 +26,17 @@ struct diffcmppath_S {
   size_t df_optimal_choice;
 };
 
+// lines of a diff block and the scores of line pairs for linematch_nbuffers()
+typedef struct {
+  const int *lm_diff_len;
+  size_t lm_ndiffs;
+  bool lm_iwhite;
+  mmfile_t *lm_lines[LN_MAX_BUFS];  // each line, "ptr" is NULL after the end
+  // matched chars of line pairs, -1 when not computed yet; NULL for two
+  // buffers, then each pair is compared only once
+  int *lm_scores[LN_MAX_BUFS][LN_MAX_BUFS];
+} linematch_T;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "linematch.c.generated.h"
 #endif
@@ -86,7 +99,27 @@ static int matching_chars(const mmfile_t *m1, const mmfile_t *m2)
   size_t s2len = MIN(MATCH_CHAR_MAX_LEN - 1, line_len(m2));
   char *s1 = m1->ptr;
   char *s2 = m2->ptr;
-  int matrix[2][MATCH_CHAR_MAX_LEN] = { 0 };
+
+  // A common start and end is part of the longest common subsequence, only
+  // the rest needs the quadratic loop.  Similar lines often differ in a few
+  // characters only.
+  size_t pre = 0;
+  while (pre < s1len && pre < s2len && s1[pre] == s2[pre]) {
+    pre++;
+  }
+  size_t suf = 0;
+  while (suf < s1len - pre && suf < s2len - pre
+         && s1[s1len - 1 - suf] == s2[s2len - 1 - suf]) {
+    suf++;
+  }
+  s1 += pre;
+  s2 += pre;
+  s1len -= pre + suf;
+  s2len -= pre + suf;
+
+  int matrix[2][MATCH_CHAR_MAX_LEN];
+  memset(matrix[0], 0, (s2len + 1) * sizeof(int));
+  memset(matrix[1], 0, (s2len + 1) * sizeof(int));
   bool icur = 1;  // save space by storing only two rows for i axis
   for (size_t i = 0; i < s1len; i++) {
     icur = !icur;
@@ -107,26 +140,56 @@ static int matching_chars(const mmfile_t *m1, const mmfile_t *m2)
       }
     }
   }
-  return matrix[icur][s2len];
+  return (int)(pre + suf) + matrix[icur][s2len];
+}
+
+/// Get the matched characters of line "ia" of buffer "a" and line "ib" of
+/// buffer "b", computing them only once when it is cached.
+///
+/// @return  -1 when one of the lines is past the end.
+static int line_pair_score(linematch_T *lm, size_t a, int ia, size_t b, int ib)
+{
+  const mmfile_t *m1 = &lm->lm_lines[a][ia];
+  const mmfile_t *m2 = &lm->lm_lines[b][ib];
+  if (m1->ptr == NULL || m2->ptr == NULL) {
+    return -1;
+  }
+  int *score = lm->lm_scores[a][b];
+  if (score != NULL) {
+    score += (size_t)ia * (size_t)lm->lm_diff_len[b] + (size_t)ib;
+    if (*score >= 0) {
+      return *score;
+    }
+  }
+  // TODO(lewis6991): handle whitespace ignoring higher up in the stack
+  int r = lm->lm_iwhite ? matching_chars_iwhite(m1, m2) : matching_chars(m1, m2);
+  if (score != NULL) {
+    *score = r;
+  }
+  return r;
 }
 
-/// count the matching characters between a variable number of strings "sp"
-/// mark the strings that have already been compared to extract them later
-/// without re-running the character match counting.
-/// @param sp
-/// @param fomvals
-/// @param n
-static int count_n_matched_chars(mmfile_t **sp, const size_t n, bool iwhite)
+/// count the matching characters between the lines "line_idx" of the buffers
+/// in "choice".
+/// @param lm
+/// @param line_idx
+/// @param choice
+static int count_n_matched_chars(linematch_T *lm, const int *line_idx, int choice)
 {
   int matched_chars = 0;
   int matched = 0;
-  for (size_t i = 0; i < n; i++) {
-    for (size_t j = i + 1; j < n; j++) {
-      if (sp[i]->ptr != NULL && sp[j]->ptr != NULL) {
+  for (size_t i = 0; i < lm->lm_ndiffs; i++) {
+    if (!(choice & (1 << i))) {
+      continue;
+    }
+    for (size_t j = i + 1; j < lm->lm_ndiffs; j++) {
+      if (!(choice & (1 << j))) {
+        continue;
+      }
+      int score = line_pair_score(lm, i, line_idx[i], j, line_idx[j]);
+      if (score >= 0) {
         matched++;
-        // TODO(lewis6991): handle whitespace ignoring higher up in the stack
-        matched_chars += iwhite ? matching_chars_iwhite(sp[i], sp[j])
-                                : matching_chars(sp[i], sp[j]);
+        matched_chars += score;
       }
     }
   }
@@ -165,32 +228,26 @@ mmfile_t fastforward_buf_to_lnum(mmfile_t s, linenr_T lnum)
 /// @param diffcmppath
 /// @param diff_len
 /// @param ndiffs
-/// @param diff_blk
+/// @param lm
 static void try_possible_paths(const int *df_iters, const size_t *paths, const int npaths,
                                const int path_idx, int *choice, diffcmppath_T *diffcmppath,
-                               const int *diff_len, const size_t ndiffs, const mmfile_t **diff_blk,
-                               bool iwhite)
+                               const int *diff_len, const size_t ndiffs, linematch_T *lm)
 {
   if (path_idx == npaths) {
     if ((*choice) > 0) {
       int from_vals[LN_MAX_BUFS] = { 0 };
       const int *to_vals = df_iters;
-      mmfile_t mm[LN_MAX_BUFS];  // stack memory for current_lines
-      mmfile_t *current_lines[LN_MAX_BUFS];
       for (size_t k = 0; k < ndiffs; k++) {
         from_vals[k] = df_iters[k];
         // get the index at all of the places
         if ((*choice) & (1 << k)) {
           from_vals[k]--;
-          mm[k] = fastforward_buf_to_lnum(*diff_blk[k], df_iters[k]);
-        } else {
-          mm[k] = (mmfile_t){ 0 };
         }
-        current_lines[k] = &mm[k];
       }
       size_t unwrapped_idx_from = unwrap_indexes(from_vals, diff_len, ndiffs);
       size_t unwrapped_idx_to = unwrap_indexes(to_vals, diff_len, ndiffs);
-      int matched_chars = count_n_matched_chars(current_lines, ndiffs, iwhite);
+      // the lines compared are the ones in "from_vals"
+      int matched_chars = count_n_matched_chars(lm, from_vals, *choice);
       int score = diffcmppath[unwrapped_idx_from].df_lev_score + matched_chars;
       if (score > diffcmppath[unwrapped_idx_to].df_lev_score) {
         diffcmppath[unwrapped_idx_to].df_path_n = 1;
@@ -208,10 +265,10 @@ static void try_possible_paths(const int *df_iters, const size_t *paths, const i
   size_t bit_place = paths[path_idx];
   *(choice) |= (1 << bit_place);  // set it to 1
   try_possible_paths(df_iters, paths, npaths, path_idx + 1, choice,
-                     diffcmppath, diff_len, ndiffs, diff_blk, iwhite);
+                     diffcmppath, diff_len, ndiffs, lm);
   *(choice) &= ~(1 << bit_place);  // set it to 0
   try_possible_paths(df_iters, paths, npaths, path_idx + 1, choice,
-                     diffcmppath, diff_len, ndiffs, diff_blk, iwhite);
+                     diffcmppath, diff_len, ndiffs, lm);
 }
 
 /// unwrap indexes to access n dimensional tensor
@@ -243,10 +300,9 @@ static size_t unwrap_indexes(const int *values, const int *diff_len, const size_
 /// @param diffcmppath
 /// @param diff_len
 /// @param ndiffs
-/// @param diff_blk
+/// @param lm
 static void populate_tensor(int *df_iters, const size_t ch_dim, diffcmppath_T *diffcmppath,
-                            const int *diff_len, const size_t ndiffs, const mmfile_t **diff_blk,
-                            bool iwhite)
+                            const int *diff_len, const size_t ndiffs, linematch_T *lm)
 {
   if (ch_dim == ndiffs) {
     int npaths = 0;
@@ -262,14 +318,13 @@ static void populate_tensor(int *df_iters, const size_t ch_dim, diffcmppath_T *d
     size_t unwrapper_idx_to = unwrap_indexes(df_iters, diff_len, ndiffs);
     diffcmppath[unwrapper_idx_to].df_lev_score = -1;
     try_possible_paths(df_iters, paths, npaths, 0, &choice, diffcmppath,
-                       diff_len, ndiffs, diff_blk, iwhite);
+                       diff_len, ndiffs, lm);
     return;
   }
 
   for (int i = 0; i <= diff_len[ch_dim]; i++) {
     df_iters[ch_dim] = i;
-    populate_tensor(df_iters, ch_dim + 1, diffcmppath, diff_len,
-                    ndiffs, diff_blk, iwhite);
+    populate_tensor(df_iters, ch_dim + 1, diffcmppath, diff_len, ndiffs, lm);
   }
 }
 
@@ -339,6 +394,9 @@ size_t linematch_nbuffers(const mmfile_t **diff_blk, const int *diff_len, const
     assert(diff_len[i] >= 0);
     memsize *= (size_t)(diff_len[i] + 1);
     memsize_decisions += (size_t)diff_len[i];
+    if (ndiffs > 2 && memsize > LN_MAX_TENSOR_SIZE / sizeof(diffcmppath_T)) {
+      return linematch_pairwise(diff_blk, diff_len, ndiffs, decisions, iwhite);
+    }
   }
 
   // create the flattened path matrix
@@ -353,9 +411,34 @@ size_t linematch_nbuffers(const mmfile_t **diff_blk, const int *diff_len, const
     }
   }
 
+  // Find the start of each line once.  With more than two buffers the same
+  // pair of lines is compared for many cells, remember the scores then.
+  linematch_T lm = { .lm_diff_len = diff_len, .lm_ndiffs = ndiffs, .lm_iwhite = iwhite };
+  for (size_t k = 0; k < ndiffs; k++) {
+    lm.lm_lines[k] = xmalloc(sizeof(mmfile_t) * (size_t)MAX(diff_len[k], 1));
+    mmfile_t s = *diff_blk[k];
+    for (int i = 0; i < diff_len[k]; i++) {
+      lm.lm_lines[k][i] = s;
+      if (s.ptr != NULL) {
+        s = fastforward_buf_to_lnum(s, 2);
+      }
+    }
+    for (size_t j = 0; ndiffs > 2 && j < k; j++) {
+      size_t n_scores = (size_t)diff_len[j] * (size_t)diff_len[k];
+      lm.lm_scores[j][k] = xmalloc(sizeof(int) * MAX(n_scores, 1));
+      memset(lm.lm_scores[j][k], 0xff, sizeof(int) * n_scores);  // all -1
+    }
+  }
+
   // memory for avoiding repetitive calculations of score
   int df_iters[LN_MAX_BUFS];
-  populate_tensor(df_iters, 0, diffcmppath, diff_len, ndiffs, diff_blk, iwhite);
+  populate_tensor(df_iters, 0, diffcmppath, diff_len, ndiffs, &lm);
+  for (size_t k = 0; k < ndiffs; k++) {
+    xfree(lm.lm_lines[k]);
+    for (size_t j = 0; j < k; j++) {
+      xfree(lm.lm_scores[j][k]);
+    }
+  }
 
   const size_t u = unwrap_indexes(diff_len, diff_len, ndiffs);
   diffcmppath_T *startNode = &diffcmppath[u];
@@ -380,6 +463,72 @@ size_t linematch_nbuffers(const mmfile_t **diff_blk, const int *diff_len, const
   return n_optimal;
 }
 
+/// Align the lines like linematch_nbuffers(), but by aligning each buffer
+/// with the one that has the most lines and merging the results.  Used when
+/// the tensor for all the buffers would use too much memory.
+/// @param diff_blk
+/// @param diff_len
+/// @param ndiffs
+/// @param [out] [allocated] decisions
+/// @return the length of decisions
+static size_t linematch_pairwise(const mmfile_t **diff_blk, const int *diff_len,
+                                 const size_t ndiffs, int **decisions, bool iwhite)
+{
+  size_t center = 0;
+  size_t memsize_decisions = 0;
+  for (size_t k = 0; k < ndiffs; k++) {
+    memsize_decisions += (size_t)diff_len[k];
+    if (diff_len[k] > diff_len[center]) {
+      center = k;
+    }
+  }
+  *decisions = xmalloc(sizeof(int) * MAX(memsize_decisions, 1));
+
+  // For each other buffer: the alignment with the center buffer and how far
+  // it was used.
+  int *pair_decisions[LN_MAX_BUFS] = { 0 };
+  size_t pair_len[LN_MAX_BUFS] = { 0 };
+  size_t pair_idx[LN_MAX_BUFS] = { 0 };
+  for (size_t k = 0; k < ndiffs; k++) {
+    if (k != center) {
+      const mmfile_t *pair_blk[2] = { diff_blk[center], diff_blk[k] };
+      const int pair_diff_len[2] = { diff_len[center], diff_len[k] };
+      pair_len[k] = linematch_nbuffers(pair_blk, pair_diff_len, 2, &pair_decisions[k], iwhite);
+    }
+  }
+
+  // Walk the lines of the center buffer, first taking the lines of the other
+  // buffers that come before it and then the lines matched with it.
+  size_t n = 0;
+  for (int i = 0; i <= diff_len[center]; i++) {
+    int choice = i < diff_len[center] ? (1 << center) : 0;
+    for (size_t k = 0; k < ndiffs; k++) {
+      if (k == center) {
+        continue;
+      }
+      // "1" only advances the center buffer, "2" only buffer "k".
+      while (pair_idx[k] < pair_len[k] && pair_decisions[k][pair_idx[k]] == 2) {
+        (*decisions)[n++] = 1 << k;
+        pair_idx[k]++;
+      }
+      if (pair_idx[k] < pair_len[k] && i < diff_len[center]) {
+        if (pair_decisions[k][pair_idx[k]] == 3) {
+          choice |= 1 << k;
+        }
+        pair_idx[k]++;
+      }
+    }
+    if (choice != 0) {
+      (*decisions)[n++] = choice;
+    }
+  }
+
+  for (size_t k = 0; k < ndiffs; k++) {
+    xfree(pair_decisions[k]);
+  }
+  return n;
+}
+
 // returns the minimum amount of path changes from start to end
 static size_t test_charmatch_paths(diffcmppath_T *node, int lastdecision)
 {
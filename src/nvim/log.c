@@ -21,6 +21,7 @@
 #include "nvim/eval.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
+#include "nvim/macros_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/os/fs.h"
@@ -31,12 +32,24 @@
 #include "nvim/path.h"
 #include "nvim/ui_client.h"
 
+/// Size of each of the two buffers for log messages: one is appended to, while
+/// the writer thread writes the other one to the log file.
+#define LOG_BUF_SIZE (64 * 1024)
+
 /// Cached location of the expanded log file path decided by log_path_init().
 static char log_file_path[MAXPATHL + 1] = { 0 };
 
 static bool did_log_init = false;
 static uv_mutex_t mutex;
 
+static char *log_buf = NULL;  ///< messages not written yet, NULL when not buffering
+static size_t log_buf_len = 0;
+static char *log_wbuf = NULL;  ///< messages being written by the writer thread
+static uv_mutex_t write_mutex;  ///< held while writing, always locked after "mutex"
+static uv_cond_t log_cond;  ///< signalled when "log_buf" becomes non-empty or on log_stop()
+static uv_thread_t log_thread;
+static bool log_thread_stop = false;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "log.c.generated.h"
 #endif
@@ -107,6 +120,97 @@ void log_init(void)
   // AFTER init_homedir ("~", XDG) and set_init_1 (env vars). 22b52dd462e5 #11501
   log_path_init();
   did_log_init = true;
+
+  // Messages are appended to a buffer and written in batches by a thread, so
+  // that logging doesn't open and write the file for every message.
+  uv_mutex_init(&write_mutex);
+  uv_cond_init(&log_cond);
+  log_buf = xmalloc(LOG_BUF_SIZE);
+  log_wbuf = xmalloc(LOG_BUF_SIZE);
+  if (uv_thread_create(&log_thread, log_writer_thread, NULL) != 0) {
+    XFREE_CLEAR(log_buf);
+    XFREE_CLEAR(log_wbuf);
+    return;
+  }
+  // Nvim may also exit() without os_exit().
+  atexit(log_atexit);
+}
+
+static void log_atexit(void)
+{
+  log_lock();
+  if (log_buf != NULL) {
+    log_flush();
+  }
+  log_unlock();
+}
+
+/// Writes the buffered log messages and stops the writer thread. Later
+/// messages are written directly.
+void log_stop(void)
+{
+  if (log_buf == NULL) {
+    return;
+  }
+  log_lock();
+  log_thread_stop = true;
+  uv_cond_signal(&log_cond);
+  log_unlock();
+  // The thread writes the remaining messages before it returns.
+  uv_thread_join(&log_thread);
+  log_lock();
+  XFREE_CLEAR(log_buf);
+  XFREE_CLEAR(log_wbuf);
+  log_unlock();
+}
+
+static void log_writer_thread(void *arg)
+{
+  uv_mutex_lock(&mutex);
+  while (true) {
+    while (log_buf_len == 0 && !log_thread_stop) {
+      uv_cond_wait(&log_cond, &mutex);
+    }
+    if (log_buf_len == 0) {
+      break;
+    }
+    char *buf = log_buf;
+    size_t len = log_buf_len;
+    log_buf = log_wbuf;
+    log_wbuf = buf;
+    log_buf_len = 0;
+    // Lock before unlocking "mutex", so that log_flush() can't write newer
+    // messages before these.
+    uv_mutex_lock(&write_mutex);
+    uv_mutex_unlock(&mutex);
+    log_write(buf, len);
+    uv_mutex_unlock(&write_mutex);
+    uv_mutex_lock(&mutex);
+  }
+  uv_mutex_unlock(&mutex);
+}
+
+static void log_write(const char *buf, size_t len)
+{
+  FILE *log_file = open_log_file();
+  fwrite(buf, 1, len, log_file);
+  fflush(log_file);
+  if (log_file != stderr && log_file != stdout) {
+    fclose(log_file);
+  }
+}
+
+/// Writes the buffered messages now, instead of in the writer thread.
+/// Must be called with log_lock() held.
+static void log_flush(void)
+{
+  if (log_buf_len == 0) {
+    return;
+  }
+  uv_mutex_lock(&write_mutex);
+  log_write(log_buf, log_buf_len);
+  log_buf_len = 0;
+  uv_mutex_unlock(&write_mutex);
 }
 
 void log_lock(void)
@@ -177,17 +281,20 @@ bool logmsg(int log_level, const char *context, const char *func_name, int line_
   }
   recursive = true;
   bool ret = false;
-  FILE *log_file = open_log_file();
 
   va_list args;
   va_start(args, fmt);
-  ret = v_do_log_to_file(log_file, log_level, context, func_name, line_num,
-                         eol, fmt, args);
-  va_end(args);
-
-  if (log_file != stderr && log_file != stdout) {
-    fclose(log_file);
+  if (log_buf != NULL) {
+    ret = v_log_to_buf(log_level, context, func_name, line_num, eol, fmt, args);
+  } else {
+    FILE *log_file = open_log_file();
+    ret = v_do_log_to_file(log_file, log_level, context, func_name, line_num,
+                           eol, fmt, args);
+    if (log_file != stderr && log_file != stdout) {
+      fclose(log_file);
+    }
   }
+  va_end(args);
 
   recursive = false;
   log_unlock();
@@ -198,6 +305,7 @@ void log_uv_handles(void *loop)
 {
   uv_loop_t *l = loop;
   log_lock();
+  log_flush();
   FILE *log_file = open_log_file();
 
   uv_print_all_handles(l, log_file);
@@ -273,6 +381,7 @@ void log_callstack_to_file(FILE *log_file, const char *const func_name, const in
 void log_callstack(const char *const func_name, const int line_num)
 {
   log_lock();
+  log_flush();
   FILE *log_file = open_log_file();
   log_callstack_to_file(log_file, func_name, line_num);
   log_unlock();
@@ -296,6 +405,87 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
                              const char *func_name, int line_num, bool eol, const char *fmt,
                              va_list args)
   FUNC_ATTR_PRINTF(7, 0)
+{
+  char header[256];
+  if (log_header(header, sizeof(header), log_level, context, func_name, line_num) < 0) {
+    return false;
+  }
+  if (fputs(header, log_file) < 0) {
+    return false;
+  }
+  if (vfprintf(log_file, fmt, args) < 0) {
+    return false;
+  }
+  if (eol) {
+    fputc('\n', log_file);
+  }
+  if (fflush(log_file) == EOF) {
+    return false;
+  }
+
+  return true;
+}
+
+/// Appends a log message to "log_buf", to be written by the writer thread.
+/// Must be called with log_lock() held.
+static bool v_log_to_buf(int log_level, const char *context, const char *func_name, int line_num,
+                         bool eol, const char *fmt, va_list args)
+  FUNC_ATTR_PRINTF(6, 0)
+{
+  char header[256];
+  int hlen = log_header(header, sizeof(header), log_level, context, func_name, line_num);
+  if (hlen < 0) {
+    return false;
+  }
+  va_list args_copy;
+  va_copy(args_copy, args);
+  int mlen = vsnprintf(NULL, 0, fmt, args_copy);
+  va_end(args_copy);
+  if (mlen < 0) {
+    return false;
+  }
+  // Header, message, newline and the NUL written by vsnprintf().
+  size_t len = (size_t)hlen + (size_t)mlen + (eol ? 1 : 0);
+  if (len + 1 > LOG_BUF_SIZE) {
+    // Too big for the buffer: write it directly, after the buffered messages.
+    log_flush();
+    uv_mutex_lock(&write_mutex);
+    FILE *log_file = open_log_file();
+    bool ret = v_do_log_to_file(log_file, log_level, context, func_name, line_num, eol, fmt, args);
+    if (log_file != stderr && log_file != stdout) {
+      fclose(log_file);
+    }
+    uv_mutex_unlock(&write_mutex);
+    return ret;
+  }
+  if (log_buf_len + len + 1 > LOG_BUF_SIZE) {
+    log_flush();
+  }
+
+  bool was_empty = log_buf_len == 0;
+  char *p = log_buf + log_buf_len;
+  memcpy(p, header, (size_t)hlen);
+  vsnprintf(p + hlen, (size_t)mlen + 1, fmt, args);
+  if (eol) {
+    p[hlen + mlen] = '\n';
+  }
+  log_buf_len += len;
+
+  if (log_level >= LOGLVL_ERR) {
+    // Don't lose errors if Nvim crashes right after.
+    log_flush();
+  } else if (was_empty) {
+    uv_cond_signal(&log_cond);
+  }
+  return true;
+}
+
+/// Formats the header of a log message, with the level, time, instance name and
+/// location, into "buf".
+///
+/// @return length of the header, or -1 on failure.
+static int log_header(char *buf, size_t size, int log_level, const char *context,
+                      const char *func_name, int line_num)
 {
   // Name of the Nvim instance that produced the log.
   static char name[32] = { 0 };
@@ -311,11 +501,11 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
   // Format the timestamp.
   struct tm local_time;
   if (os_localtime(&local_time) == NULL) {
-    return false;
+    return -1;
   }
   char date_time[20];
   if (strftime(date_time, sizeof(date_time), "%Y-%m-%dT%H:%M:%S", &local_time) == 0) {
-    return false;
+    return -1;
   }
 
   int millis = 0;
@@ -349,28 +539,16 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
     }
   }
 
-  // Print the log message.
   int rv = (line_num == -1 || func_name == NULL)
-           ? fprintf(log_file, "%s %s.%03d %-10s %s",
-                     log_levels[log_level], date_time, millis, name,
-                     (context == NULL ? "?:" : context))
-           : fprintf(log_file, "%s %s.%03d %-10s %s%s:%d: ",
-                     log_levels[log_level], date_time, millis, name,
-                     (context == NULL ? "" : context),
-                     func_name, line_num);
-
+           ? snprintf(buf, size, "%s %s.%03d %-10s %s",
+                      log_levels[log_level], date_time, millis, name,
+                      (context == NULL ? "?:" : context))
+           : snprintf(buf, size, "%s %s.%03d %-10s %s%s:%d: ",
+                      log_levels[log_level], date_time, millis, name,
+                      (context == NULL ? "" : context),
+                      func_name, line_num);
   if (rv < 0) {
-    return false;
+    return -1;
   }
-  if (vfprintf(log_file, fmt, args) < 0) {
-    return false;
-  }
-  if (eol) {
-    fputc('\n', log_file);
-  }
-  if (fflush(log_file) == EOF) {
-    return false;
-  }
-
-  return true;
+  return MIN(rv, (int)size - 1);
 }
@@ -171,6 +171,64 @@ static LuaTableProps nlua_traverse_table(lua_State *const lstate)
   return ret;
 }
 
+/// Converts the Lua value on top of the stack to a typval_T if it is a scalar
+/// (nil, boolean, string or number), without popping it.
+///
+/// @return false if the value has another type, `tv` is not changed then.
+static inline bool nlua_tv_from_scalar(lua_State *lstate, typval_T *tv)
+{
+  switch (lua_type(lstate, -1)) {
+  case LUA_TNIL:
+    *tv = (typval_T){ .v_type = VAR_SPECIAL, .v_lock = VAR_UNLOCKED,
+                      .vval.v_special = kSpecialVarNull };
+    return true;
+  case LUA_TBOOLEAN:
+    *tv = (typval_T){ .v_type = VAR_BOOL, .v_lock = VAR_UNLOCKED,
+                      .vval.v_bool = lua_toboolean(lstate, -1) ? kBoolVarTrue : kBoolVarFalse };
+    return true;
+  case LUA_TSTRING: {
+    size_t len;
+    const char *s = lua_tolstring(lstate, -1, &len);
+    *tv = decode_string(s, len, false, false);
+    return true;
+  }
+  case LUA_TNUMBER: {
+    const lua_Number n = lua_tonumber(lstate, -1);
+    if (n > (lua_Number)VARNUMBER_MAX || n < (lua_Number)VARNUMBER_MIN
+        || ((lua_Number)((varnumber_T)n)) != n) {
+      *tv = (typval_T){ .v_type = VAR_FLOAT, .v_lock = VAR_UNLOCKED,
+                        .vval.v_float = (float_T)n };
+    } else {
+      *tv = (typval_T){ .v_type = VAR_NUMBER, .v_lock = VAR_UNLOCKED,
+                        .vval.v_number = (varnumber_T)n };
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/// Appends the items of the Lua list on top of the stack to `l`, starting
+/// after the items `l` already has, for as long as they are scalars.
+///
+/// Lists of strings or numbers are then converted in one loop, without going
+/// through the conversion stack of nlua_pop_typval() for every item. The
+/// caller converts the remaining items, if any.
+static void nlua_pop_scalar_items(lua_State *lstate, list_T *l, size_t len)
+{
+  for (size_t i = (size_t)tv_list_len(l); i < len; i++) {
+    lua_rawgeti(lstate, -1, (int)i + 1);
+    typval_T tv;
+    bool scalar = nlua_tv_from_scalar(lstate, &tv);
+    lua_pop(lstate, 1);
+    if (!scalar) {
+      return;
+    }
+    tv_list_append_owned_tv(l, tv);
+  }
+}
+
 /// Helper structure for nlua_pop_typval
 typedef struct {
   typval_T *tv;     ///< Location where conversion result is saved.
@@ -265,33 +323,10 @@ bool nlua_pop_typval(lua_State *lstate, typval_T *ret_tv)
       .v_lock = VAR_UNLOCKED,
       .vval = { .v_number = 0 },
     };
-    switch (lua_type(lstate, -1)) {
+    switch (nlua_tv_from_scalar(lstate, cur.tv) ? LUA_TNIL : lua_type(lstate, -1)) {
     case LUA_TNIL:
-      cur.tv->v_type = VAR_SPECIAL;
-      cur.tv->vval.v_special = kSpecialVarNull;
+      // Already converted as a scalar.
       break;
-    case LUA_TBOOLEAN:
-      cur.tv->v_type = VAR_BOOL;
-      cur.tv->vval.v_bool = (lua_toboolean(lstate, -1) ? kBoolVarTrue : kBoolVarFalse);
-      break;
-    case LUA_TSTRING: {
-      size_t len;
-      const char *s = lua_tolstring(lstate, -1, &len);
-      *cur.tv = decode_string(s, len, false, false);
-      break;
-    }
-    case LUA_TNUMBER: {
-      const lua_Number n = lua_tonumber(lstate, -1);
-      if (n > (lua_Number)VARNUMBER_MAX || n < (lua_Number)VARNUMBER_MIN
-          || ((lua_Number)((varnumber_T)n)) != n) {
-        cur.tv->v_type = VAR_FLOAT;
-        cur.tv->vval.v_float = (float_T)n;
-      } else {
-        cur.tv->v_type = VAR_NUMBER;
-        cur.tv->vval.v_number = (varnumber_T)n;
-      }
-      break;
-    }
     case LUA_TTABLE: {
       // Only need to track table refs if we have a metatable associated.
       LuaRef table_ref = LUA_NOREF;
@@ -319,6 +354,7 @@ bool nlua_pop_typval(lua_State *lstate, typval_T *ret_tv)
         tv_list_ref(cur.tv->vval.v_list);
         cur.list_len = table_props.maxidx;
         if (table_props.maxidx != 0) {
+          nlua_pop_scalar_items(lstate, cur.tv->vval.v_list, table_props.maxidx);
           cur.container = true;
           cur.idx = lua_gettop(lstate);
           kvi_push(stack, cur);
@@ -585,6 +621,81 @@ static bool typval_conv_special = false;
 #undef TYPVAL_ENCODE_CONV_RECURSE
 #undef TYPVAL_ENCODE_ALLOW_SPECIALS
 
+static inline bool tv_is_scalar(const typval_T *tv)
+{
+  return tv->v_type == VAR_STRING || tv->v_type == VAR_NUMBER
+         || tv->v_type == VAR_FLOAT || tv->v_type == VAR_BOOL;
+}
+
+/// Pushes a scalar, see tv_is_scalar(), converted like encode_vim_to_lua() does.
+static inline void nlua_push_scalar(lua_State *lstate, const typval_T *tv)
+{
+  switch (tv->v_type) {
+  case VAR_STRING: {
+    const char *s = tv->vval.v_string;
+    lua_pushlstring(lstate, s ? s : "", s ? strlen(s) : 0);
+    break;
+  }
+  case VAR_NUMBER:
+    lua_pushnumber(lstate, (lua_Number)tv->vval.v_number);
+    break;
+  case VAR_FLOAT:
+    lua_pushnumber(lstate, (lua_Number)tv->vval.v_float);
+    break;
+  case VAR_BOOL:
+    lua_pushboolean(lstate, tv->vval.v_bool == kBoolVarTrue);
+    break;
+  default:
+    abort();
+  }
+}
+
+/// Pushes a non-empty list or dict whose items are all scalars (e.g. the
+/// result of getline(1, '$')), in one pass and without the generic encoder.
+///
+/// @return false if `tv` is something else, nothing is pushed then.
+static bool nlua_push_scalar_container(lua_State *lstate, const typval_T *tv)
+{
+  if (tv->v_type == VAR_LIST) {
+    list_T *const l = tv->vval.v_list;
+    if (tv_list_len(l) == 0) {
+      return false;
+    }
+    TV_LIST_ITER_CONST(l, li, {
+      if (!tv_is_scalar(TV_LIST_ITEM_TV(li))) {
+        return false;
+      }
+    });
+    lua_createtable(lstate, tv_list_len(l), 0);
+    int idx = 1;
+    TV_LIST_ITER_CONST(l, li, {
+      nlua_push_scalar(lstate, TV_LIST_ITEM_TV(li));
+      lua_rawseti(lstate, -2, idx++);
+    });
+    return true;
+  } else if (tv->v_type == VAR_DICT) {
+    dict_T *const d = tv->vval.v_dict;
+    // A dict with two items may be a special dict (_TYPE and _VAL), leave
+    // those to the encoder.
+    if (d == NULL || d->dv_hashtab.ht_used == 0 || d->dv_hashtab.ht_used == 2) {
+      return false;
+    }
+    TV_DICT_ITER(d, di, {
+      if (!tv_is_scalar(&di->di_tv)) {
+        return false;
+      }
+    });
+    lua_createtable(lstate, 0, (int)d->dv_hashtab.ht_used);
+    TV_DICT_ITER(d, di, {
+      lua_pushstring(lstate, (const char *)di->di_key);
+      nlua_push_scalar(lstate, &di->di_tv);
+      lua_rawset(lstate, -3);
+    });
+    return true;
+  }
+  return false;
+}
+
 /// Convert Vimscript typval_T to Lua value
 ///
 /// Should leave single value in Lua stack. May only fail if Lua failed to grow stack.
@@ -598,10 +709,14 @@ bool nlua_push_typval(lua_State *lstate, typval_T *const tv, int flags)
   typval_conv_special = (flags & kNluaPushSpecial);
   const int initial_size = lua_gettop(lstate);
 
-  if (!lua_checkstack(lstate, initial_size + 2)) {
+  if (!lua_checkstack(lstate, initial_size + 3)) {
     semsg(_("E1502: Lua failed to grow stack to %i"), initial_size + 4);
     return false;
   }
+  if (nlua_push_scalar_container(lstate, tv)) {
+    assert(lua_gettop(lstate) == initial_size + 1);
+    return true;
+  }
   if (encode_vim_to_lua(lstate, tv, "nlua_push_typval argument") == FAIL) {
     return false;
   }
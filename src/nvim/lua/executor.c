@@ -46,6 +46,7 @@
 #include "nvim/lua/treesitter.h"
 #include "nvim/macros_defs.h"
 #include "nvim/main.h"
+#include "nvim/map_defs.h"
 #include "nvim/mbyte_defs.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
@@ -56,6 +57,8 @@
 #include "nvim/option_vars.h"
 #include "nvim/os/fileio.h"
 #include "nvim/os/fileio_defs.h"
+#include "nvim/os/fs.h"
+#include "nvim/os/fs_defs.h"
 #include "nvim/os/os.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
@@ -95,6 +98,34 @@ typedef struct {
   size_t size;
 } ModuleDef;
 
+/// Bytecode of a module in the vim.loader cache, validated by the size and
+/// mtime of the module file.
+typedef struct {
+  int64_t size;
+  int64_t sec;
+  int64_t nsec;
+  uint32_t path_len;
+  uint32_t chunk_len;
+} LuacHeader;
+
+typedef struct {
+  LuacHeader h;
+  const char *chunk;
+  bool owned;  ///< chunk was added in this session, not read from the cache file
+} LuacEntry;
+
+#define LUAC_MAGIC "NVIMLUAC"
+#define LUAC_VERSION 1
+
+/// The vim.loader cache. It is read from a single file once, entries point
+/// into the contents of that file. The file is mapped into memory when
+/// possible, so that instances using the same cache share it.
+static char *luac_data = NULL;
+/// Size of the mapping when "luac_data" was mapped with os_mmap_file().
+static size_t luac_mapped_size = 0;
+static PMap(cstr_t) luac_entries = MAP_INIT;
+static bool luac_dirty = false;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "lua/executor.c.generated.h"
 # include "lua/vim_module.generated.h"
@@ -807,6 +838,16 @@ static bool nlua_state_init(lua_State *const lstate) FUNC_ATTR_NONNULL_ALL
   lua_pushcfunction(lstate, &nlua_ui_detach);
   lua_setfield(lstate, -2, "ui_detach");
 
+  // internal vim._luac... API for vim.loader
+  lua_pushcfunction(lstate, &nlua_luac_read);
+  lua_setfield(lstate, -2, "_luac_read");
+  lua_pushcfunction(lstate, &nlua_luac_load);
+  lua_setfield(lstate, -2, "_luac_load");
+  lua_pushcfunction(lstate, &nlua_luac_add);
+  lua_setfield(lstate, -2, "_luac_add");
+  lua_pushcfunction(lstate, &nlua_luac_write);
+  lua_setfield(lstate, -2, "_luac_write");
+
   nlua_common_vim_init(lstate, false, false);
 
   // patch require() (only for --startuptime)
@@ -939,6 +980,7 @@ void nlua_free_all_mem(void)
   nlua_unref_global(lstate, require_ref);
   nlua_common_free_all_mem(lstate);
   nlua_treesitter_free();
+  luac_clear();
 }
 
 static void nlua_common_free_all_mem(lua_State *lstate)
@@ -1096,6 +1138,200 @@ static int nlua_require(lua_State *const lstate)
   return status == 0 ? 1 : lua_error(lstate);
 }
 
+static void luac_clear(void)
+{
+  const char *key;
+  LuacEntry *entry;
+  map_foreach(&luac_entries, key, entry, {
+    if (entry->owned) {
+      xfree((char *)entry->chunk);
+    }
+    xfree(entry);
+    xfree((char *)key);
+  });
+  map_destroy(cstr_t, &luac_entries);
+  if (luac_mapped_size > 0) {
+    os_munmap_file(luac_data, luac_mapped_size);
+    luac_data = NULL;
+    luac_mapped_size = 0;
+  }
+  XFREE_CLEAR(luac_data);
+  luac_dirty = false;
+}
+
+static void luac_put(const char *path, size_t path_len, LuacEntry entry)
+{
+  char *key = xmemdupz(path, path_len);
+  cstr_t *key_alloc = NULL;
+  bool new_item = false;
+  LuacEntry **ref = (LuacEntry **)pmap_put_ref(cstr_t)(&luac_entries, key, &key_alloc,
+                                                       &new_item);
+  if (new_item) {
+    *key_alloc = key;
+  } else {
+    xfree(key);
+    if ((*ref)->owned) {
+      xfree((char *)(*ref)->chunk);
+    }
+    xfree(*ref);
+  }
+  *ref = xmalloc(sizeof(**ref));
+  **ref = entry;
+}
+
+/// vim._luac_read({path}): reads the vim.loader cache file, replacing the
+/// cache in memory. Returns false if the file is missing or invalid.
+static int nlua_luac_read(lua_State *lstate)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const char *path = luaL_checkstring(lstate, 1);
+  luac_clear();
+
+  // vim._luac_write() replaces the file by renaming, mapping it is safe.
+  size_t size = 0;
+  ptrdiff_t nread;
+  luac_data = (char *)os_mmap_file(path, &size);
+  if (luac_data != NULL) {
+    luac_mapped_size = size;
+    nread = (ptrdiff_t)size;
+  } else {
+    FileInfo info;
+    FileDescriptor fp;
+    if (!os_fileinfo(path, &info) || file_open(&fp, path, kFileReadOnly, 0) != 0) {
+      lua_pushboolean(lstate, false);
+      return 1;
+    }
+    size = (size_t)os_fileinfo_size(&info);
+    luac_data = xmalloc(MAX(size, 1));
+    nread = file_read(&fp, luac_data, size);
+    file_close(&fp, false);
+  }
+
+  size_t off = sizeof(LUAC_MAGIC) - 1 + sizeof(uint32_t);
+  if (nread != (ptrdiff_t)size || size < off
+      || memcmp(luac_data, LUAC_MAGIC, sizeof(LUAC_MAGIC) - 1) != 0) {
+    luac_clear();
+    lua_pushboolean(lstate, false);
+    return 1;
+  }
+  uint32_t version;
+  memcpy(&version, luac_data + sizeof(LUAC_MAGIC) - 1, sizeof(version));
+  if (version != LUAC_VERSION) {
+    luac_clear();
+    lua_pushboolean(lstate, false);
+    return 1;
+  }
+
+  while (off + sizeof(LuacHeader) <= size) {
+    LuacEntry entry = { .owned = false };
+    memcpy(&entry.h, luac_data + off, sizeof(LuacHeader));
+    off += sizeof(LuacHeader);
+    if ((size_t)entry.h.path_len + entry.h.chunk_len > size - off) {
+      break;  // truncated file, keep the entries read so far
+    }
+    const char *entry_path = luac_data + off;
+    entry.chunk = entry_path + entry.h.path_len;
+    off += (size_t)entry.h.path_len + entry.h.chunk_len;
+    luac_put(entry_path, entry.h.path_len, entry);
+  }
+
+  lua_pushboolean(lstate, true);
+  return 1;
+}
+
+/// vim._luac_load({path}, {size}, {sec}, {nsec}): loads the cached bytecode of
+/// the module file {path}, if its size and mtime match. Returns nil otherwise.
+static int nlua_luac_load(lua_State *lstate)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const char *path = luaL_checkstring(lstate, 1);
+  int64_t size = (int64_t)luaL_checkinteger(lstate, 2);
+  int64_t sec = (int64_t)luaL_checkinteger(lstate, 3);
+  int64_t nsec = (int64_t)luaL_checkinteger(lstate, 4);
+
+  LuacEntry *entry = pmap_get(cstr_t)(&luac_entries, path);
+  if (entry == NULL || entry->h.size != size || entry->h.sec != sec || entry->h.nsec != nsec) {
+    return 0;
+  }
+  const char *chunkname = lua_pushfstring(lstate, "@%s", path);
+  if (luaL_loadbuffer(lstate, entry->chunk, entry->h.chunk_len, chunkname) != 0) {
+    // E.g. bytecode of another LuaJIT version.
+    return 0;
+  }
+  return 1;
+}
+
+/// vim._luac_add({path}, {size}, {sec}, {nsec}, {chunk}): adds or replaces the
+/// bytecode {chunk} (from string.dump()) of the module file {path}.
+static int nlua_luac_add(lua_State *lstate)
+  FUNC_ATTR_NONNULL_ALL
+{
+  size_t path_len;
+  const char *path = luaL_checklstring(lstate, 1, &path_len);
+  size_t chunk_len;
+  const char *chunk = luaL_checklstring(lstate, 5, &chunk_len);
+  if (path_len > UINT32_MAX || chunk_len > UINT32_MAX) {
+    return 0;
+  }
+  LuacEntry entry = {
+    .h = {
+      .size = (int64_t)luaL_checkinteger(lstate, 2),
+      .sec = (int64_t)luaL_checkinteger(lstate, 3),
+      .nsec = (int64_t)luaL_checkinteger(lstate, 4),
+      .path_len = (uint32_t)path_len,
+      .chunk_len = (uint32_t)chunk_len,
+    },
+    .chunk = xmemdup(chunk, chunk_len),
+    .owned = true,
+  };
+  luac_put(path, path_len, entry);
+  luac_dirty = true;
+  return 0;
+}
+
+/// vim._luac_write({path}): writes the vim.loader cache to {path}, if it was
+/// changed since it was read. Returns false on failure.
+static int nlua_luac_write(lua_State *lstate)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const char *path = luaL_checkstring(lstate, 1);
+  if (!luac_dirty) {
+    lua_pushboolean(lstate, true);
+    return 1;
+  }
+
+  // Write to a temporary file first, another instance may read the cache at
+  // the same time. Its name is unique, an instance could have mapped the file
+  // after it was renamed by another one.
+  char tmp_tail[32];
+  snprintf(tmp_tail, sizeof(tmp_tail), ".%" PRId64 ".tmp", os_get_pid());
+  char *tmp = concat_str(path, tmp_tail);
+  FileDescriptor fp;
+  bool ok = file_open(&fp, tmp, kFileCreate | kFileTruncate, 0600) == 0;
+  if (ok) {
+    uint32_t version = LUAC_VERSION;
+    ok = file_write(&fp, LUAC_MAGIC, sizeof(LUAC_MAGIC) - 1) >= 0
+         && file_write(&fp, (char *)&version, sizeof(version)) >= 0;
+    const char *key;
+    LuacEntry *entry;
+    map_foreach(&luac_entries, key, entry, {
+      ok = ok && file_write(&fp, (char *)&entry->h, sizeof(entry->h)) >= 0
+           && file_write(&fp, key, entry->h.path_len) >= 0
+           && file_write(&fp, entry->chunk, entry->h.chunk_len) >= 0;
+    });
+    ok = file_close(&fp, false) == 0 && ok;
+    ok = ok && os_rename(tmp, path) == OK;
+    if (!ok) {
+      os_remove(tmp);
+    }
+  }
+  xfree(tmp);
+
+  luac_dirty = luac_dirty && !ok;
+  lua_pushboolean(lstate, ok);
+  return 1;
+}
+
 /// debug.debug: interaction with user while debugging.
 ///
 /// @param  lstate  Lua interpreter state.
@@ -1401,15 +1637,68 @@ void nlua_typval_eval(const String str, typval_T *const arg, typval_T *const ret
 void nlua_typval_call(const char *str, size_t len, typval_T *const args, int argcount,
                       typval_T *ret_tv)
   FUNC_ATTR_NONNULL_ALL
+{
+  size_t lcmd_len;
+  char *lcmd = nlua_typval_call_cmd(str, len, &lcmd_len);
+
+  nlua_typval_exec(lcmd, lcmd_len, "v:lua", args, argcount, false, ret_tv);
+
+  if (lcmd != IObuff) {
+    xfree(lcmd);
+  }
+}
+
+/// Load the chunk that nlua_typval_call() runs for Lua function "str", to call
+/// it repeatedly with nlua_typval_call_ref().
+///
+/// @return  reference to the chunk, LUA_NOREF when it has a syntax error.
+LuaRef nlua_typval_ref(const char *str, size_t len)
+  FUNC_ATTR_NONNULL_ALL
+{
+  lua_State *const lstate = global_lstate;
+  size_t lcmd_len;
+  char *lcmd = nlua_typval_call_cmd(str, len, &lcmd_len);
+
+  LuaRef ref = LUA_NOREF;
+  if (luaL_loadbuffer(lstate, lcmd, lcmd_len, "v:lua") == 0) {
+    ref = nlua_ref_global(lstate, -1);
+  }
+  lua_pop(lstate, 1);  // chunk or error message
+
+  if (lcmd != IObuff) {
+    xfree(lcmd);
+  }
+  return ref;
+}
+
+/// Call the chunk "ref" from nlua_typval_ref(), like nlua_typval_call().
+void nlua_typval_call_ref(LuaRef ref, typval_T *const args, int argcount, typval_T *ret_tv)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (check_secure()) {
+    ret_tv->v_type = VAR_NUMBER;
+    ret_tv->vval.v_number = 0;
+    return;
+  }
+
+  lua_State *const lstate = global_lstate;
+  nlua_pushref(lstate, ref);
+  nlua_typval_pcall(lstate, args, argcount, false, ret_tv);
+}
+
+/// Get the chunk "return {str}(...)" that calls Lua function "str".
+///
+/// @return  the chunk in IObuff if it fits, otherwise allocated.
+static char *nlua_typval_call_cmd(const char *str, size_t len, size_t *lcmd_len)
 {
 #define CALLHEADER "return "
 #define CALLSUFFIX "(...)"
-  const size_t lcmd_len = sizeof(CALLHEADER) - 1 + len + sizeof(CALLSUFFIX) - 1;
+  *lcmd_len = sizeof(CALLHEADER) - 1 + len + sizeof(CALLSUFFIX) - 1;
   char *lcmd;
-  if (lcmd_len < IOSIZE) {
+  if (*lcmd_len < IOSIZE) {
     lcmd = IObuff;
   } else {
-    lcmd = xmalloc(lcmd_len);
+    lcmd = xmalloc(*lcmd_len);
   }
   memcpy(lcmd, CALLHEADER, sizeof(CALLHEADER) - 1);
   memcpy(lcmd + sizeof(CALLHEADER) - 1, str, len);
@@ -1417,12 +1706,7 @@ void nlua_typval_call(const char *str, size_t len, typval_T *const args, int arg
          sizeof(CALLSUFFIX) - 1);
 #undef CALLHEADER
 #undef CALLSUFFIX
-
-  nlua_typval_exec(lcmd, lcmd_len, "v:lua", args, argcount, false, ret_tv);
-
-  if (lcmd != IObuff) {
-    xfree(lcmd);
-  }
+  return lcmd;
 }
 
 void nlua_call_user_expand_func(expand_T *xp, typval_T *ret_tv)
@@ -1460,6 +1744,14 @@ static void nlua_typval_exec(const char *lcmd, size_t lcmd_len, const char *name
     return;
   }
 
+  nlua_typval_pcall(lstate, args, argcount, special, ret_tv);
+}
+
+/// Call the chunk on top of the stack with arguments "args" and put its result
+/// in "ret_tv", if not NULL.
+static void nlua_typval_pcall(lua_State *lstate, typval_T *const args, int argcount, bool special,
+                              typval_T *ret_tv)
+{
   PUSH_ALL_TYPVALS(lstate, args, argcount, special);
 
   if (nlua_pcall(lstate, argcount, ret_tv ? 1 : 0)) {
@@ -1588,6 +1880,34 @@ Object nlua_call_ref_ctx(bool fast, LuaRef ref, const char *name, Array args, Lu
     nlua_push_Object(lstate, &args.items[i], 0);
   }
 
+  return nlua_call_pushed_ref(lstate, fast, nargs, mode, arena, err);
+}
+
+/// Like nlua_call_ref(), for callbacks which only take integer arguments (or
+/// handles, which are integers in Lua as well), like the on_bytes callback of
+/// nvim_buf_attach() and decoration providers.
+///
+/// The arguments are pushed directly, without building an Array of Objects
+/// and converting each of them.
+Object nlua_call_ref_int(LuaRef ref, const char *name, const Integer *args, size_t nargs,
+                         LuaRetMode mode, Error *err)
+{
+  lua_State *const lstate = global_lstate;
+  nlua_pushref(lstate, ref);
+  if (name != NULL) {
+    lua_pushstring(lstate, name);
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    lua_pushnumber(lstate, (lua_Number)args[i]);
+  }
+
+  return nlua_call_pushed_ref(lstate, false, (int)nargs + (name != NULL), mode, NULL, err);
+}
+
+/// Calls the function pushed below its {nargs} arguments, see nlua_call_ref_ctx().
+static Object nlua_call_pushed_ref(lua_State *lstate, bool fast, int nargs, LuaRetMode mode,
+                                   Arena *arena, Error *err)
+{
   if (fast) {
     if (nlua_fast_cfpcall(lstate, nargs, 1, -1) < 0) {
       // error is already scheduled, set anyways to convey failure.
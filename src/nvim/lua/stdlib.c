@@ -19,7 +19,12 @@
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/autocmd_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/charset.h"
+#include "nvim/decoration.h"
+#include "nvim/decoration_defs.h"
+#include "nvim/decoration_provider.h"
 #include "nvim/eval/typval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/eval/vars.h"
@@ -34,6 +39,7 @@
 #include "nvim/lua/spell.h"
 #include "nvim/lua/stdlib.h"
 #include "nvim/lua/xdiff.h"
+#include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
@@ -47,6 +53,14 @@
 #include "nvim/types_defs.h"
 #include "nvim/window.h"
 
+/// A line of a buffer, as yielded by vim.buf_lines(). Only valid for as long
+/// as the buffer is not changed.
+typedef struct {
+  handle_T buf;
+  linenr_T lnum;
+  varnumber_T changedtick;
+} LineView;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "lua/stdlib.c.generated.h"
 #endif
@@ -167,6 +181,160 @@ static struct luaL_Reg regex_meta[] = {
   { NULL, NULL }
 };
 
+/// Iterator returned by vim.buf_lines()
+///
+/// Upvalues: buffer handle, next (0-based) row and end row.
+static int buf_lines_next(lua_State *lstate)
+{
+  handle_T bufnr = (handle_T)lua_tointeger(lstate, lua_upvalueindex(1));
+  linenr_T row = (linenr_T)lua_tointeger(lstate, lua_upvalueindex(2));
+  linenr_T end = (linenr_T)lua_tointeger(lstate, lua_upvalueindex(3));
+
+  buf_T *buf = handle_get_buffer(bufnr);
+  if (!buf || buf->b_ml.ml_mfp == NULL) {
+    return luaL_error(lstate, "invalid buffer");
+  }
+  if (row >= MIN(end, buf->b_ml.ml_line_count)) {
+    return 0;
+  }
+  lua_pushinteger(lstate, row + 1);
+  lua_replace(lstate, lua_upvalueindex(2));
+
+  lua_pushinteger(lstate, row);
+  LineView *view = lua_newuserdata(lstate, sizeof(LineView));
+  *view = (LineView){ .buf = bufnr, .lnum = row + 1, .changedtick = buf_get_changedtick(buf) };
+  lua_getfield(lstate, LUA_REGISTRYINDEX, "nvim_line_view");
+  lua_setmetatable(lstate, -2);
+  return 2;
+}
+
+/// Iterates over the lines of a buffer without converting them to Lua strings.
+///
+/// Expects a buffer handle (0 for the current buffer) and optional start and
+/// end rows, indexed like nvim_buf_get_lines().
+int nlua_buf_lines(lua_State *lstate)
+{
+  handle_T bufnr = (handle_T)luaL_optinteger(lstate, 1, 0);
+  lua_Integer start = luaL_optinteger(lstate, 2, 0);
+  lua_Integer end = luaL_optinteger(lstate, 3, -1);
+
+  buf_T *buf = bufnr ? handle_get_buffer(bufnr) : curbuf;
+  if (!buf || buf->b_ml.ml_mfp == NULL) {
+    return luaL_error(lstate, "invalid buffer");
+  }
+  lua_Integer count = buf->b_ml.ml_line_count;
+  start = start < 0 ? count + start + 1 : start;
+  end = end < 0 ? count + end + 1 : end;
+  if (start < 0 || start > count || end < 0 || end > count) {
+    return luaL_error(lstate, "index out of range");
+  }
+
+  lua_pushinteger(lstate, buf->handle);
+  lua_pushinteger(lstate, start);
+  lua_pushinteger(lstate, end);
+  lua_pushcclosure(lstate, buf_lines_next, 3);
+  return 1;
+}
+
+/// Gets the text of a line view, if the buffer was not changed since the view
+/// was created.
+static char *line_view_check(lua_State *lstate, size_t *len)
+{
+  LineView *view = luaL_checkudata(lstate, 1, "nvim_line_view");
+  buf_T *buf = handle_get_buffer(view->buf);
+  if (!buf || buf->b_ml.ml_mfp == NULL || buf_get_changedtick(buf) != view->changedtick) {
+    luaL_error(lstate, "line view is outdated: buffer was changed");
+  }
+  *len = (size_t)ml_get_buf_len(buf, view->lnum);
+  return ml_get_buf(buf, view->lnum);
+}
+
+static int line_view_text(lua_State *lstate)
+{
+  size_t len;
+  char *line = line_view_check(lstate, &len);
+  lua_pushlstring(lstate, line, len);
+  return 1;
+}
+
+static int line_view_len(lua_State *lstate)
+{
+  size_t len;
+  line_view_check(lstate, &len);
+  lua_pushinteger(lstate, (lua_Integer)len);
+  return 1;
+}
+
+static const char *find_plain(const char *hay, size_t hay_len, const char *needle,
+                              size_t needle_len)
+{
+  if (needle_len == 0) {
+    return hay;
+  }
+  while (hay_len >= needle_len) {
+    const char *p = memchr(hay, (uint8_t)needle[0], hay_len - needle_len + 1);
+    if (p == NULL) {
+      return NULL;
+    }
+    if (memcmp(p, needle, needle_len) == 0) {
+      return p;
+    }
+    hay_len -= (size_t)(p - hay) + 1;
+    hay = p + 1;
+  }
+  return NULL;
+}
+
+/// Finds a plain substring in the line, like string.find(line, s, init, true).
+static int line_view_find(lua_State *lstate)
+{
+  size_t len;
+  const char *line = line_view_check(lstate, &len);
+  size_t needle_len;
+  const char *needle = luaL_checklstring(lstate, 2, &needle_len);
+  lua_Integer init = luaL_optinteger(lstate, 3, 1);
+  if (init < 0) {
+    init = MAX((lua_Integer)len + init + 1, 1);
+  } else if (init == 0) {
+    init = 1;
+  }
+  if ((size_t)init > len + 1) {
+    lua_pushnil(lstate);
+    return 1;
+  }
+
+  const char *p = find_plain(line + init - 1, len - (size_t)(init - 1), needle, needle_len);
+  if (p == NULL) {
+    lua_pushnil(lstate);
+    return 1;
+  }
+  lua_pushinteger(lstate, (lua_Integer)(p - line) + 1);
+  lua_pushinteger(lstate, (lua_Integer)(p - line) + (lua_Integer)needle_len);
+  return 2;
+}
+
+/// Matches a vim.regex() object against the line, like regex:match_line().
+static int line_view_match(lua_State *lstate)
+{
+  size_t len;
+  char *line = line_view_check(lstate, &len);
+  regprog_T **prog = luaL_checkudata(lstate, 2, "nvim_regex");
+  int nret = regex_match(lstate, prog, line);
+  if (!*prog) {
+    return luaL_error(lstate, "regex: internal error");
+  }
+  return nret;
+}
+
+static struct luaL_Reg line_view_meta[] = {
+  { "__tostring", line_view_text },
+  { "__len", line_view_len },
+  { "text", line_view_text },
+  { "find", line_view_find },
+  { "match", line_view_match },
+  { NULL, NULL }
+};
+
 /// convert byte index to UTF-32 and UTF-16 indices
 ///
 /// Expects a string and an optional index. If no index is supplied, the length
@@ -578,6 +746,78 @@ static int nlua_foldupdate(lua_State *lstate)
   return 0;
 }
 
+/// Adds an ephemeral highlight to the line being drawn.
+///
+/// Does the same as nvim_buf_set_extmark() with `ephemeral`, `hl_group`,
+/// `priority`, `conceal`, `spell` and `url`, but takes positional arguments,
+/// so that a highlighter setting many marks per line doesn't build and
+/// validate an opts dict for each of them.
+///
+/// Lua signature: vim._add_ephemeral_hl(buf, ns, start_row, start_col, end_row, end_col,
+///                                      hl_id, priority, conceal, spell, url)
+static int nlua_add_ephemeral_hl(lua_State *L)
+{
+  handle_T bufnr = (handle_T)luaL_checkinteger(L, 1);
+  win_T *win = decor_state.win;
+  if (!win || (bufnr != 0 && win->w_buffer->handle != bufnr)
+      || (bufnr == 0 && win->w_buffer != curbuf)) {
+    return luaL_error(L, "cannot set ephemeral highlight outside of a decoration provider");
+  }
+  buf_T *buf = win->w_buffer;
+
+  uint32_t ns = (uint32_t)luaL_checkinteger(L, 2);
+  int start_row = (int)luaL_checkinteger(L, 3);
+  int start_col = (int)luaL_checkinteger(L, 4);
+  int end_row = (int)luaL_checkinteger(L, 5);
+  int end_col = (int)luaL_checkinteger(L, 6);
+  if (start_row < 0 || start_col < 0 || end_row < 0 || end_col < 0) {
+    return luaL_error(L, "invalid range");
+  }
+  if (start_row >= buf->b_ml.ml_line_count) {
+    return 0;
+  }
+  if (end_row >= buf->b_ml.ml_line_count) {
+    // past the final newline
+    end_row = buf->b_ml.ml_line_count;
+    end_col = 0;
+  }
+
+  DecorHighlightInline hl = DECOR_HIGHLIGHT_INLINE_INIT;
+  hl.hl_id = (int)luaL_optinteger(L, 7, 0);
+  hl.priority = (DecorPriority)luaL_optinteger(L, 8, DECOR_PRIORITY_BASE);
+  bool has_hl = hl.hl_id > 0;
+
+  if (!lua_isnoneornil(L, 9)) {
+    size_t len;
+    const char *conceal = luaL_checklstring(L, 9, &len);
+    hl.flags |= kSHConceal;
+    has_hl = true;
+    if (len > 0) {
+      int ch;
+      hl.conceal_char = utfc_ptr2schar(conceal, &ch);
+      if (!hl.conceal_char || !vim_isprintc(ch)) {
+        return luaL_error(L, "conceal char has to be printable");
+      }
+    }
+  }
+
+  if (!lua_isnoneornil(L, 10)) {
+    hl.flags |= lua_toboolean(L, 10) ? kSHSpellOn : kSHSpellOff;
+    has_hl = true;
+  }
+
+  const char *url = luaL_optstring(L, 11, NULL);
+  if (!has_hl && url == NULL) {
+    return 0;
+  }
+
+  DecorSignHighlight sh = decor_sh_from_inline(hl);
+  sh.url = url ? xstrdup(url) : NULL;
+  decor_provider_record_ephemeral(start_row, start_col, end_row, end_col, &sh, ns, 0);
+  decor_range_add_sh(&decor_state, start_row, start_col, end_row, end_col, &sh, true, ns, 0);
+  return 0;
+}
+
 static int nlua_with(lua_State *L)
 {
   int flags = 0;
@@ -683,6 +923,9 @@ static void nlua_state_add_internal(lua_State *const lstate)
 
   lua_pushcfunction(lstate, &nlua_with);
   lua_setfield(lstate, -2, "_with_c");
+
+  lua_pushcfunction(lstate, &nlua_add_ephemeral_hl);
+  lua_setfield(lstate, -2, "_add_ephemeral_hl");
 }
 
 void nlua_state_add_stdlib(lua_State *const lstate, bool is_thread)
@@ -719,6 +962,16 @@ void nlua_state_add_stdlib(lua_State *const lstate, bool is_thread)
     lua_setfield(lstate, -2, "__index");  // [meta]
     lua_pop(lstate, 1);  // don't use metatable now
 
+    // buf_lines
+    lua_pushcfunction(lstate, &nlua_buf_lines);
+    lua_setfield(lstate, -2, "buf_lines");
+    luaL_newmetatable(lstate, "nvim_line_view");
+    luaL_register(lstate, NULL, line_view_meta);
+
+    lua_pushvalue(lstate, -1);  // [meta, meta]
+    lua_setfield(lstate, -2, "__index");  // [meta]
+    lua_pop(lstate, 1);  // don't use metatable now
+
     // vim.spell
     luaopen_spell(lstate);
     lua_setfield(lstate, -2, "spell");
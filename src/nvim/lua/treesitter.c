@@ -25,10 +25,16 @@
 
 #include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/eval/typval_defs.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
+#include "nvim/lua/executor.h"
 #include "nvim/lua/treesitter.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
@@ -60,12 +66,43 @@ typedef struct {
   uint64_t timeout_threshold_ns;
 } TSLuaParserCallbackPayload;
 
+/// Copy of the text of a buffer, shared by the parses of one buffer state.
+/// Only changed on the main thread; workers just read the text.
+typedef struct {
+  char *text;
+  uint32_t len;
+  int refcount;
+  handle_T bufnr;
+  varnumber_T changedtick;
+} TSLuaSnapshot;
+
+/// A parse running on a libuv worker thread. The worker only touches the
+/// fields owned by the job: a private parser, the text snapshot and a copy of
+/// the old tree.
+typedef struct {
+  uv_work_t uv;
+  TSParser *parser;
+  TSTree *old_tree;
+  TSTree *new_tree;
+  TSRange *changed;
+  uint32_t n_changed;
+  TSLuaSnapshot *snapshot;
+  uint64_t timeout_ns;
+  bool include_bytes;
+  LuaRef cb;
+  lua_State *lstate;
+} TSLuaParseJob;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "lua/treesitter.c.generated.h"
 #endif
 
 static PMap(cstr_t) langs = MAP_INIT;
 
+/// Last snapshot taken, reused while it is in use and its buffer is unchanged,
+/// e.g. by the parses of all the injected regions of a buffer.
+static TSLuaSnapshot *last_snapshot = NULL;
+
 #ifdef HAVE_WASMTIME
 static wasm_engine_t *wasmengine;
 static TSWasmStore *ts_wasmstore;
@@ -369,6 +406,7 @@ static struct luaL_Reg parser_meta[] = {
   { "__gc", parser_gc },
   { "__tostring", parser_tostring },
   { "parse", parser_parse },
+  { "_parse_async", parser_parse_async },
   { "reset", parser_reset },
   { "set_included_ranges", parser_set_ranges },
   { "included_ranges", parser_get_ranges },
@@ -451,7 +489,18 @@ static const char *input_cb(void *payload, uint32_t byte_index, TSPoint position
     *bytes_read = 0;
     return "";
   }
-  size_t tocopy = MIN(len - position.column, BUFSIZE);
+  size_t tocopy = len - position.column;
+  if (tocopy == 0) {
+    *bytes_read = 1;
+    return "\n";
+  }
+  if (tocopy > BUFSIZE && memchr(line + position.column, '\n', tocopy) == NULL) {
+    // A long line without embedded NUL: use the text in the buffer, it stays
+    // valid until the next call.  The final \n is returned by the next call.
+    *bytes_read = (uint32_t)tocopy;
+    return line + position.column;
+  }
+  tocopy = MIN(tocopy, BUFSIZE);
 
   memcpy(buf, line + position.column, tocopy);
   // Translate embedded \n to NUL
@@ -582,6 +631,212 @@ static int parser_parse(lua_State *L)
   return 2;
 }
 
+/// Gets a copy of the text of a buffer the way input_cb() presents it: every
+/// line followed by a \n, with embedded \n translated to NUL.
+///
+/// @return snapshot with a reference for the caller, or NULL if the buffer is
+///         too large for tree-sitter.
+static TSLuaSnapshot *buf_snapshot(buf_T *bp)
+{
+  varnumber_T changedtick = buf_get_changedtick(bp);
+  if (last_snapshot && last_snapshot->bufnr == bp->handle
+      && last_snapshot->changedtick == changedtick) {
+    last_snapshot->refcount++;
+    return last_snapshot;
+  }
+
+  size_t size = 0;
+  for (linenr_T lnum = 1; lnum <= bp->b_ml.ml_line_count; lnum++) {
+    size += (size_t)ml_get_buf_len(bp, lnum) + 1;
+  }
+  if (size > UINT32_MAX) {
+    return NULL;
+  }
+
+  char *text = xmalloc(MAX(size, 1));
+  char *p = text;
+  for (linenr_T lnum = 1; lnum <= bp->b_ml.ml_line_count; lnum++) {
+    size_t linelen = (size_t)ml_get_buf_len(bp, lnum);
+    memcpy(p, ml_get_buf(bp, lnum), linelen);
+    memchrsub(p, '\n', NUL, linelen);
+    p += linelen;
+    *p++ = '\n';
+  }
+
+  TSLuaSnapshot *snapshot = xmalloc(sizeof(TSLuaSnapshot));
+  *snapshot = (TSLuaSnapshot){ .text = text, .len = (uint32_t)size, .refcount = 1,
+                               .bufnr = bp->handle, .changedtick = changedtick };
+  last_snapshot = snapshot;
+  return snapshot;
+}
+
+static void snapshot_unref(TSLuaSnapshot *snapshot)
+{
+  if (--snapshot->refcount > 0) {
+    return;
+  }
+  if (last_snapshot == snapshot) {
+    last_snapshot = NULL;
+  }
+  xfree(snapshot->text);
+  xfree(snapshot);
+}
+
+static const char *snapshot_input_cb(void *payload, uint32_t byte_index, TSPoint position,
+                                     uint32_t *bytes_read)
+{
+  TSLuaSnapshot *snapshot = payload;
+  if (byte_index >= snapshot->len) {
+    *bytes_read = 0;
+    return "";
+  }
+  *bytes_read = snapshot->len - byte_index;
+  return snapshot->text + byte_index;
+}
+
+static void parse_job_work(uv_work_t *req)
+{
+  TSLuaParseJob *job = req->data;
+  TSInput input = { (void *)job->snapshot, snapshot_input_cb, TSInputEncodingUTF8, NULL };
+  if (job->timeout_ns > 0) {
+    TSLuaParserCallbackPayload payload = { .parse_start_time = os_hrtime(),
+                                           .timeout_threshold_ns = job->timeout_ns };
+    TSParseOptions parse_options = { .payload = &payload,
+                                     .progress_callback = on_parser_progress };
+    job->new_tree = ts_parser_parse_with_options(job->parser, job->old_tree, input,
+                                                 parse_options);
+  } else {
+    job->new_tree = ts_parser_parse(job->parser, job->old_tree, input);
+  }
+
+  if (job->new_tree) {
+    job->changed = job->old_tree
+                   ? ts_tree_get_changed_ranges(job->old_tree, job->new_tree, &job->n_changed)
+                   : ts_tree_included_ranges(job->new_tree, &job->n_changed);
+  }
+}
+
+static void parse_job_free(TSLuaParseJob *job, bool unref)
+{
+  if (unref) {
+    luaL_unref(job->lstate, LUA_REGISTRYINDEX, job->cb);
+  }
+  if (job->new_tree) {
+    ts_tree_delete(job->new_tree);
+  }
+  if (job->old_tree) {
+    ts_tree_delete(job->old_tree);
+  }
+  ts_parser_delete(job->parser);
+  snapshot_unref(job->snapshot);
+  xfree(job->changed);
+  xfree(job);
+}
+
+/// Hands the result of a threaded parse to the Lua callback, from the main
+/// event queue so that it runs where vim.schedule() callbacks do.
+static void parse_job_done_event(void **argv)
+{
+  TSLuaParseJob *job = argv[0];
+  lua_State *L = job->lstate;
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, job->cb);  // [cb]
+  int nargs = 0;
+  if (job->new_tree) {
+    push_tree(L, job->new_tree);  // [cb, tree]
+    job->new_tree = NULL;  // now owned by the lua GC
+    push_ranges(L, job->changed, job->n_changed, job->include_bytes);  // [cb, tree, ranges]
+    nargs = 2;
+  }
+  if (nlua_pcall(L, nargs, 0)) {
+    nlua_error(L, _("treesitter parse callback: %.*s"));
+  }
+  parse_job_free(job, true);
+}
+
+static void parse_job_after_work(uv_work_t *req, int status)
+{
+  TSLuaParseJob *job = req->data;
+  if (main_loop.closing) {
+    // The Lua state may already be gone, don't touch the callback.
+    parse_job_free(job, false);
+    return;
+  }
+  multiqueue_put(main_loop.events, parse_job_done_event, job);
+}
+
+/// Parses a buffer on a libuv worker thread.
+///
+/// The text is copied first, so the buffer may change while the worker runs;
+/// the caller must check whether the result is still current. Parses started
+/// while the buffer doesn't change share one copy, so the regions of a
+/// parser with injections can be parsed concurrently. Returns false if
+/// the parser can't be used from another thread (WASM languages, or a logger
+/// that calls back into Lua), in which case nothing is started.
+///
+/// Lua signature: parser:_parse_async(old_tree, bufnr, include_bytes, timeout_ns, callback)
+/// where callback is called with (tree, changed_ranges), or with no arguments
+/// if the parse timed out.
+static int parser_parse_async(lua_State *L)
+{
+  TSParser *p = parser_check(L, 1);
+  const TSTree *old_tree = NULL;
+  if (!lua_isnil(L, 2)) {
+    TSLuaTree *ud = luaL_checkudata(L, 2, TS_META_TREE);
+    old_tree = ud ? ud->tree : NULL;
+  }
+  handle_T bufnr = (handle_T)luaL_checkinteger(L, 3);
+  buf_T *buf = handle_get_buffer(bufnr);
+  if (!buf) {
+    return luaL_argerror(L, 3, "invalid buffer handle");
+  }
+  bool include_bytes = lua_toboolean(L, 4);
+  uint64_t timeout_ns = lua_isnil(L, 5) ? 0 : (uint64_t)luaL_checkinteger(L, 5);
+  luaL_checktype(L, 6, LUA_TFUNCTION);
+
+  const TSLanguage *lang = ts_parser_language(p);
+  if (!lang) {
+    return luaL_error(L, "Language was unset, or has an incompatible ABI.");
+  }
+  if (ts_language_is_wasm(lang) || ts_parser_logger(p).log || main_loop.closing) {
+    lua_pushboolean(L, false);
+    return 1;
+  }
+
+  TSLuaSnapshot *snapshot = buf_snapshot(buf);
+  if (snapshot == NULL) {
+    lua_pushboolean(L, false);
+    return 1;
+  }
+
+  TSLuaParseJob *job = xcalloc(1, sizeof(TSLuaParseJob));
+  job->uv.data = job;
+  job->parser = ts_parser_new();
+  ts_parser_set_language(job->parser, lang);
+  uint32_t n_ranges;
+  const TSRange *ranges = ts_parser_included_ranges(p, &n_ranges);
+  ts_parser_set_included_ranges(job->parser, ranges, n_ranges);
+  job->old_tree = old_tree ? ts_tree_copy(old_tree) : NULL;
+  job->snapshot = snapshot;
+  job->timeout_ns = timeout_ns;
+  job->include_bytes = include_bytes;
+  lua_pushvalue(L, 6);
+  job->cb = luaL_ref(L, LUA_REGISTRYINDEX);
+  job->lstate = L;
+
+  // A timesliced parse may have been left suspended in this parser, it will
+  // not be resumed.
+  ts_parser_reset(p);
+
+  if (uv_queue_work(&main_loop.uv, &job->uv, parse_job_work, parse_job_after_work) != 0) {
+    parse_job_free(job, true);
+    lua_pushboolean(L, false);
+    return 1;
+  }
+  lua_pushboolean(L, true);
+  return 1;
+}
+
 static int parser_reset(lua_State *L)
 {
   TSParser *p = parser_check(L, 1);
@@ -1352,6 +1607,7 @@ static int node_equal(lua_State *L)
 static struct luaL_Reg querycursor_meta[] = {
   { "remove_match", querycursor_remove_match },
   { "next_capture", querycursor_next_capture },
+  { "_next_capture_ranges", querycursor_next_capture_ranges },
   { "next_match", querycursor_next_match },
   { "__gc", querycursor_gc },
   { NULL, NULL }
@@ -1430,6 +1686,62 @@ static int querycursor_next_capture(lua_State *L)
   return 3;
 }
 
+/// Gets the ranges of the next captures without creating a TSNode for each.
+///
+/// Lua signature: cursor:_next_capture_ranges(out, offset, max, query)
+///
+/// Puts 5 integers per capture in `out`, after index `offset`: capture id,
+/// start row, start col, end row, end col. Returns how many captures were
+/// put. A capture from a pattern with predicates or directives ends the batch
+/// early, since these are evaluated in Lua: it is returned after the count,
+/// as next_capture() would return it.
+static int querycursor_next_capture_ranges(lua_State *L)
+{
+  TSQueryCursor *cursor = querycursor_check(L, 1);
+  luaL_checktype(L, 2, LUA_TTABLE);
+  int offset = (int)luaL_checkinteger(L, 3);
+  int max = (int)luaL_checkinteger(L, 4);
+  TSQuery *query = query_check(L, 5);
+
+  int count = 0;
+  while (count < max) {
+    TSQueryMatch match;
+    uint32_t capture_index;
+    if (!ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      break;
+    }
+    TSQueryCapture capture = match.captures[capture_index];
+
+    uint32_t nsteps;
+    ts_query_predicates_for_pattern(query, match.pattern_index, &nsteps);
+    if (nsteps > 0) {
+      lua_pushinteger(L, count);  // [count]
+      lua_pushinteger(L, capture.index + 1);  // [count, index]
+      push_node(L, capture.node, 1);  // [count, index, node]
+      push_querymatch(L, &match, 1);  // [count, index, node, match]
+      return 4;
+    }
+
+    TSPoint start = ts_node_start_point(capture.node);
+    TSPoint end = ts_node_end_point(capture.node);
+    int i = offset + count * 5;
+    lua_pushinteger(L, capture.index + 1);
+    lua_rawseti(L, 2, i + 1);
+    lua_pushinteger(L, start.row);
+    lua_rawseti(L, 2, i + 2);
+    lua_pushinteger(L, start.column);
+    lua_rawseti(L, 2, i + 3);
+    lua_pushinteger(L, end.row);
+    lua_rawseti(L, 2, i + 4);
+    lua_pushinteger(L, end.column);
+    lua_rawseti(L, 2, i + 5);
+    count++;
+  }
+
+  lua_pushinteger(L, count);
+  return 1;
+}
+
 static int querycursor_next_match(lua_State *L)
 {
   TSQueryCursor *cursor = querycursor_check(L, 1);
@@ -181,6 +181,7 @@ static bool event_teardown(void)
   server_teardown();
   signal_teardown();
   terminal_teardown();
+  aucmd_debounce_teardown();
 
   return loop_close(&main_loop, true);
 }
@@ -686,6 +687,7 @@ void os_exit(int r)
   }
 
   ILOG("Nvim exit: %d", r);
+  log_stop();
 
 #ifdef EXITFREE
   free_all_mem();
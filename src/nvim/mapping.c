@@ -134,6 +134,9 @@ static const char e_entries_missing_in_mapset_dict_argument[]
 static const char e_illegal_map_mode_string_str[]
   = N_("E1276: Illegal map mode string: '%s'");
 
+/// Pool for mappings and abbreviations, plugins define many of them.
+static MemPool mapblock_pool = MEM_POOL_INIT("mapblock", mapblock_T);
+
 /// Get the start of the hashed map list for "state" and first character "c".
 mapblock_T *get_maphash_list(int state, int c)
 {
@@ -161,7 +164,7 @@ static void mapblock_free(mapblock_T **mpp)
     xfree(mp->m_desc);
   }
   *mpp = mp->m_next;
-  xfree(mp);
+  pool_free(&mapblock_pool, mp);
 }
 
 /// put characters to represent the map mode in a string buffer
@@ -504,7 +507,8 @@ static mapblock_T *map_add(buf_T *buf, mapblock_T **map_table, mapblock_T **abbr
                            bool is_abbr, scid_T sid, linenr_T lnum, bool simplified)
   FUNC_ATTR_NONNULL_RET
 {
-  mapblock_T *mp = xcalloc(1, sizeof(mapblock_T));
+  mapblock_T *mp = pool_alloc(&mapblock_pool);
+  CLEAR_POINTER(mp);
 
   // If CTRL-C has been mapped, don't always use it for Interrupting.
   if (*keys == Ctrl_C) {
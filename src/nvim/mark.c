@@ -1245,18 +1245,8 @@ void mark_adjust_buf(buf_T *buf, linenr_T line1, linenr_T line2, linenr_T amount
     ONE_ADJUST_NODEL(&(buf->b_visual.vi_start.lnum));
     ONE_ADJUST_NODEL(&(buf->b_visual.vi_end.lnum));
 
-    // quickfix marks
-    if (!qf_mark_adjust(buf, NULL, line1, line2, amount, amount_after)) {
-      buf->b_has_qf_entry &= ~BUF_HAS_QF_ENTRY;
-    }
-    // location lists
-    bool found_one = false;
-    FOR_ALL_TAB_WINDOWS(tab, win) {
-      found_one |= qf_mark_adjust(buf, win, line1, line2, amount, amount_after);
-    }
-    if (!found_one) {
-      buf->b_has_qf_entry &= ~BUF_HAS_LL_ENTRY;
-    }
+    // quickfix and location list marks
+    qf_mark_adjust(buf, line1, line2, amount, amount_after);
   }
 
   if (op != kExtmarkNOOP) {
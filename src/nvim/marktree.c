@@ -50,6 +50,7 @@
 #include <uv.h>
 
 #include "klib/kvec.h"
+#include "nvim/assert_defs.h"
 #include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/marktree.h"
@@ -62,6 +63,7 @@
 #include "nvim/garray_defs.h"
 
 #define T MT_BRANCH_FACTOR
+STATIC_ASSERT(T >= 2 && T < 64, "MT_BRANCH_FACTOR must be in the range 2..63");
 #define ILEN (sizeof(MTNode) + sizeof(struct mtnode_inner_s))
 
 #define ID_INCR (((uint64_t)1) << 2)
@@ -441,9 +443,20 @@ void marktree_intersect_pair(MarkTree *b, uint64_t id, MarkTreeIter *itr, MarkTr
 #undef iat
 }
 
+/// Nodes are carved out of a per-tree arena. Nodes released by splits and
+/// merges are kept on a free list per node size and reused, so that bursts
+/// of edits don't churn the heap and nodes of one tree stay close together.
 static MTNode *marktree_alloc_node(MarkTree *b, bool internal)
 {
-  MTNode *x = xcalloc(1, internal ? ILEN : sizeof(MTNode));
+  MTNode **free_list = internal ? &b->free_inner : &b->free_leaf;
+  size_t size = internal ? ILEN : sizeof(MTNode);
+  MTNode *x = *free_list;
+  if (x) {
+    *free_list = x->parent;
+  } else {
+    x = arena_alloc(&b->node_arena, size, true);
+  }
+  memset(x, 0, size);
   kvi_init(x->intersect);
   b->n_nodes++;
   return x;
@@ -1296,6 +1309,9 @@ void marktree_clear(MarkTree *b)
     marktree_free_subtree(b, b->root);
     b->root = NULL;
   }
+  // all nodes are in the arena, just drop it together with the free lists
+  arena_mem_free(arena_finish(&b->node_arena));
+  b->free_leaf = b->free_inner = NULL;
   map_destroy(uint64_t, b->id2node);
   b->n_keys = 0;
   memset(b->meta_root, 0, kMTMetaCount * sizeof(b->meta_root[0]));
@@ -1315,7 +1331,9 @@ void marktree_free_subtree(MarkTree *b, MTNode *x)
 static void marktree_free_node(MarkTree *b, MTNode *x)
 {
   kvi_destroy(x->intersect);
-  xfree(x);
+  MTNode **free_list = x->level ? &b->free_inner : &b->free_leaf;
+  x->parent = *free_list;
+  *free_list = x;
   b->n_nodes--;
 }
 
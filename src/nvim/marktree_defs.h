@@ -6,14 +6,27 @@
 
 #include "nvim/decoration_defs.h"
 #include "nvim/map_defs.h"
+#include "nvim/memory_defs.h"
+
+// The branch factor can be tuned at build time (cmake -DMT_BRANCH_FACTOR=N)
+// to trade node size (a node holds up to 2*MT_BRANCH_FACTOR-1 keys, searched
+// with a binary search) against tree depth.
+#ifndef MT_BRANCH_FACTOR
+# define MT_BRANCH_FACTOR 10
+#endif
+
+// note max branch is actually 2*MT_BRANCH_FACTOR
+// and strictly this is ceil(log2(2*MT_BRANCH_FACTOR + 1))
+// as we need a pseudo-index for "right before this node"
+#define MT_LOG2_BRANCH_(n) ((n) < 8 ? 3 : (n) < 16 ? 4 : (n) < 32 ? 5 : (n) < 64 ? 6 : 7)
+
+// a non-root node has at least MT_BRANCH_FACTOR children, so a tree of depth d
+// holds at least 2*MT_BRANCH_FACTOR^(d-1)-1 keys. Enough for 2^32 marks.
+#define MT_MAX_DEPTH_(t) ((t) < 4 ? 34 : 20)
 
 enum {
-  MT_MAX_DEPTH     = 20,
-  MT_BRANCH_FACTOR = 10,
-  // note max branch is actually 2*MT_BRANCH_FACTOR
-  // and strictly this is ceil(log2(2*MT_BRANCH_FACTOR + 1))
-  // as we need a pseudo-index for "right before this node"
-  MT_LOG2_BRANCH   = 5,
+  MT_MAX_DEPTH     = MT_MAX_DEPTH_(MT_BRANCH_FACTOR),
+  MT_LOG2_BRANCH   = MT_LOG2_BRANCH_(2 * MT_BRANCH_FACTOR),
 };
 
 typedef struct {
@@ -99,4 +112,6 @@ typedef struct {
   uint32_t meta_root[kMTMetaCount];
   size_t n_keys, n_nodes;
   PMap(uint64_t) id2node[1];
+  Arena node_arena;  ///< memory of all nodes, released at once by marktree_clear()
+  MTNode *free_leaf, *free_inner;  ///< released nodes, linked through their parent pointer
 } MarkTree;
@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
 #include "nvim/drawscreen.h"
@@ -33,6 +34,7 @@
 #include "nvim/pos_defs.h"
 #include "nvim/profile.h"
 #include "nvim/regexp.h"
+#include "nvim/search.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
 #include "nvim/vim_defs.h"
@@ -45,6 +47,21 @@ static const char *e_invalwindow = N_("E957: Invalid window number");
 
 #define SEARCH_HL_PRIORITY 0
 
+enum { SEARCH_HL_NOMATCH_LINES = 1024, };  ///< lines in search_hl_nomatch
+
+/// Lines without a match for the 'hlsearch' pattern.  When the pattern is
+/// plain text that is extended, e.g. while typing it with 'incsearch', these
+/// lines won't match either and don't need to be searched again.
+static struct {
+  handle_T bufnr;
+  varnumber_T changedtick;
+  char *pat;              ///< pattern the lines were checked for, or NULL
+  size_t patlen;
+  bool ic;
+  linenr_T top;           ///< first line in "nomatch", zero when unset
+  uint8_t nomatch[SEARCH_HL_NOMATCH_LINES / 8];
+} search_hl_nomatch;
+
 /// Add match to the match list of window "wp".
 /// If "pat" is not NULL the pattern will be highlighted with the group "grp"
 /// with priority "prio".
@@ -374,6 +391,75 @@ static int next_search_hl_pos(match_T *shl, linenr_T lnum, matchitem_T *match, c
   return 0;
 }
 
+#if defined(EXITFREE)
+void free_match_stuff(void)
+{
+  XFREE_CLEAR(search_hl_nomatch.pat);
+}
+#endif
+
+/// Make search_hl_nomatch valid for the current 'hlsearch' pattern.
+///
+/// @return  false if it can't be used.
+static bool search_hl_nomatch_check(win_T *wp, match_T *shl)
+{
+  char *pat = last_search_pat();
+  if (pat == NULL) {
+    return false;
+  }
+  size_t patlen = strlen(pat);
+
+  if (search_hl_nomatch.pat != NULL
+      && search_hl_nomatch.bufnr == shl->buf->handle
+      && search_hl_nomatch.changedtick == buf_get_changedtick(shl->buf)
+      && search_hl_nomatch.ic == shl->rm.rmm_ic
+      && search_pat_extends(search_hl_nomatch.pat, search_hl_nomatch.patlen, pat, patlen)) {
+    if (patlen > search_hl_nomatch.patlen) {
+      // Lines not matching the shorter pattern don't match this one.
+      xfree(search_hl_nomatch.pat);
+      search_hl_nomatch.pat = xmemdupz(pat, patlen);
+      search_hl_nomatch.patlen = patlen;
+    }
+    return true;
+  }
+
+  XFREE_CLEAR(search_hl_nomatch.pat);
+  if (!search_pat_extends(pat, patlen, pat, patlen)) {
+    return false;
+  }
+  search_hl_nomatch.pat = xmemdupz(pat, patlen);
+  search_hl_nomatch.patlen = patlen;
+  search_hl_nomatch.bufnr = shl->buf->handle;
+  search_hl_nomatch.changedtick = buf_get_changedtick(shl->buf);
+  search_hl_nomatch.ic = shl->rm.rmm_ic;
+  search_hl_nomatch.top = wp->w_topline;
+  CLEAR_FIELD(search_hl_nomatch.nomatch);
+  return true;
+}
+
+/// @return  true if line "lnum" is known not to match the 'hlsearch' pattern.
+static bool search_hl_nomatch_get(win_T *wp, match_T *shl, linenr_T lnum)
+{
+  if (!search_hl_nomatch_check(wp, shl)) {
+    return false;
+  }
+  linenr_T idx = lnum - search_hl_nomatch.top;
+  return idx >= 0 && idx < SEARCH_HL_NOMATCH_LINES
+         && (search_hl_nomatch.nomatch[idx / 8] & (1 << (idx % 8)));
+}
+
+/// Remember that line "lnum" does not match the 'hlsearch' pattern.
+static void search_hl_nomatch_set(win_T *wp, match_T *shl, linenr_T lnum)
+{
+  if (!search_hl_nomatch_check(wp, shl)) {
+    return;
+  }
+  linenr_T idx = lnum - search_hl_nomatch.top;
+  if (idx >= 0 && idx < SEARCH_HL_NOMATCH_LINES) {
+    search_hl_nomatch.nomatch[idx / 8] |= (uint8_t)(1 << (idx % 8));
+  }
+}
+
 /// Search for a next 'hlsearch' or match.
 /// Uses shl->buf.
 /// Sets shl->lnum and shl->rm contents.
@@ -424,6 +510,7 @@ static void next_search_hl(win_T *win, match_T *search_hl, match_T *shl, linenr_
     // 2. Not Vi compatible or empty match: continue at next character.
     //    Break the loop if this is beyond the end of the line.
     // 3. Vi compatible searching: continue at end of previous match.
+    const bool from_start = shl->lnum == 0;
     if (shl->lnum == 0) {
       matchcol = 0;
     } else if (vim_strchr(p_cpo, CPO_SEARCH) == NULL
@@ -450,6 +537,14 @@ static void next_search_hl(win_T *win, match_T *search_hl, match_T *shl, linenr_
                               && cur->mit_match.regprog == cur->mit_hl.rm.regprog);
       int timed_out = false;
 
+      // For 'hlsearch' the line may be known not to match.
+      const bool use_nomatch = from_start && shl == search_hl
+                               && !re_multiline(shl->rm.regprog);
+      if (use_nomatch && search_hl_nomatch_get(win, shl, lnum)) {
+        shl->lnum = 0;
+        break;
+      }
+
       nmatched = vim_regexec_multi(&shl->rm, win, shl->buf, lnum, matchcol,
                                    &(shl->tm), &timed_out);
       // Copy the regprog, in case it got freed and recompiled.
@@ -468,6 +563,9 @@ static void next_search_hl(win_T *win, match_T *search_hl, match_T *shl, linenr_
         got_int = false;  // avoid the "Type :quit to exit Vim" message
         break;
       }
+      if (use_nomatch && nmatched == 0) {
+        search_hl_nomatch_set(win, shl, lnum);
+      }
     } else if (cur != NULL) {
       nmatched = next_search_hl_pos(shl, lnum, cur, matchcol);
     }
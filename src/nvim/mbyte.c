@@ -460,6 +460,21 @@ int utf_char2cells(int c)
     return 1;
   }
 
+  // Looking up the properties is slow compared to the drawing code calling
+  // this for every character, remember the result.
+  if (c >= 0x100 && c <= 0x10FFFF) {
+    uint8_t *page = char2cells_page(c);
+    if (page[c & 0xFF] == 0) {
+      page[c & 0xFF] = (uint8_t)char2cells(c);
+    }
+    return page[c & 0xFF];
+  }
+  return char2cells(c);
+}
+
+/// Compute utf_char2cells() for character "c" >= 0x80.
+static int char2cells(int c)
+{
   if (!vim_isprintc(c)) {
     assert(c <= 0xFFFF);
     // unprintable is displayed either as <xx> or <xxxx>
@@ -966,6 +981,26 @@ int utf_ptr2len_len(const char *p, int size)
   return len;
 }
 
+/// Get the number of leading ASCII bytes in "p[size]".
+/// Checks eight bytes at a time, which is a lot faster than looking at every
+/// byte for mostly ASCII text.
+int utf_ascii_len(const char *p, int size)
+  FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_ALL
+{
+  int i = 0;
+  for (; i + (int)sizeof(uint64_t) <= size; i += (int)sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, p + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      break;
+    }
+  }
+  while (i < size && (uint8_t)p[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
 /// Return the number of bytes occupied by a UTF-8 character in a string.
 /// This includes following composing characters.
 /// Returns zero for NUL.
@@ -2855,6 +2890,52 @@ typedef struct {
 
 static cw_interval_T *cw_table = NULL;
 static size_t cw_table_size = 0;
+/// Incremented every time cw_table is changed.
+static unsigned cw_table_gen = 0;
+
+/// Cache of utf_char2cells() for characters from 0x100, in pages of 256
+/// characters allocated when first used.  Zero means not computed yet.
+static uint8_t *char2cells_cache[0x110000 >> 8];
+
+/// What the values in char2cells_cache[] depend on when they were computed.
+static struct {
+  char ambw;
+  int emoji;
+  unsigned cw_table_gen;
+} char2cells_cache_key;
+
+/// Get the page of char2cells_cache[] for character "c" >= 0x100.  Clears the
+/// cache when 'ambiwidth', 'emoji' or the setcellwidths() table changed.
+static uint8_t *char2cells_page(int c)
+{
+  if (char2cells_cache_key.ambw != *p_ambw
+      || char2cells_cache_key.emoji != p_emoji
+      || char2cells_cache_key.cw_table_gen != cw_table_gen) {
+    for (size_t i = 0; i < ARRAY_SIZE(char2cells_cache); i++) {
+      if (char2cells_cache[i] != NULL) {
+        memset(char2cells_cache[i], 0, 256);
+      }
+    }
+    char2cells_cache_key.ambw = *p_ambw;
+    char2cells_cache_key.emoji = p_emoji;
+    char2cells_cache_key.cw_table_gen = cw_table_gen;
+  }
+
+  uint8_t **pagep = &char2cells_cache[c >> 8];
+  if (*pagep == NULL) {
+    *pagep = xcalloc(256, 1);
+  }
+  return *pagep;
+}
+
+#if defined(EXITFREE)
+void mbyte_free_all_mem(void)
+{
+  for (size_t i = 0; i < ARRAY_SIZE(char2cells_cache); i++) {
+    XFREE_CLEAR(char2cells_cache[i]);
+  }
+}
+#endif
 
 /// Return the value of the cellwidth table for the character `c`.
 ///
@@ -2996,6 +3077,7 @@ update:
   const size_t cw_table_size_save = cw_table_size;
   cw_table = table;
   cw_table_size = table_size;
+  cw_table_gen++;
 
   // Check that the new value does not conflict with 'listchars' or
   // 'fillchars'.
@@ -3004,6 +3086,7 @@ update:
     emsg(_(error));
     cw_table = cw_table_save;
     cw_table_size = cw_table_size_save;
+    cw_table_gen++;
     xfree(table);
     return;
   }
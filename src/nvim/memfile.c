@@ -41,8 +41,10 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <uv.h>
 
 #include "nvim/assert_defs.h"
 #include "nvim/buffer_defs.h"
@@ -50,6 +52,7 @@
 #include "nvim/fileio.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
+#include "nvim/klib/kvec.h"
 #include "nvim/map_defs.h"
 #include "nvim/memfile.h"
 #include "nvim/memfile_defs.h"
@@ -314,12 +317,13 @@ bhdr_T *mf_get(memfile_T *mfp, blocknr_T nr, unsigned page_count)
       mf_free_bhdr(hp);
       return NULL;
     }
+    pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);
+    g_stats.memfile_miss++;
   } else {
-    pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
+    g_stats.memfile_hit++;
   }
 
   hp->bh_flags |= BH_LOCKED;
-  pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);  // put in front of hash table
 
   return hp;
 }
@@ -394,37 +398,42 @@ int mf_sync(memfile_T *mfp, int flags)
   // fails then we give up.
   int status = OK;
   bhdr_T *hp = NULL;
+  // First write the blocks that already have a place in the file, combining
+  // consecutive blocks into one write.
+  bool stopped = !(flags & MFS_ZERO) && !mf_write_runs(mfp, flags);
   // note, "last" block is typically earlier in the hash list
-  map_foreach_value(&mfp->mf_hash, hp, {
-    if (((flags & MFS_ALL) || hp->bh_bnum >= 0)
-        && (hp->bh_flags & BH_DIRTY)
-        && (status == OK || (hp->bh_bnum >= 0
-                             && hp->bh_bnum < mfp->mf_infile_count))) {
-      if ((flags & MFS_ZERO) && hp->bh_bnum != 0) {
-        continue;
-      }
-      if (mf_write(mfp, hp) == FAIL) {
-        if (status == FAIL) {   // double error: quit syncing
-          break;
+  if (!stopped) {
+    map_foreach_value(&mfp->mf_hash, hp, {
+      if (((flags & MFS_ALL) || hp->bh_bnum >= 0)
+          && (hp->bh_flags & BH_DIRTY)
+          && (status == OK || (hp->bh_bnum >= 0
+                               && hp->bh_bnum < mfp->mf_infile_count))) {
+        if ((flags & MFS_ZERO) && hp->bh_bnum != 0) {
+          continue;
         }
-        status = FAIL;
-      }
-      if (flags & MFS_STOP) {   // Stop when char available now.
-        if (os_char_avail()) {
+        if (mf_write(mfp, hp) == FAIL) {
+          if (status == FAIL) {   // double error: quit syncing
+            break;
+          }
+          status = FAIL;
+        }
+        if (flags & MFS_STOP) {   // Stop when char available now.
+          if (os_char_avail()) {
+            break;
+          }
+        } else {
+          os_breakcheck();
+        }
+        if (got_int) {
           break;
         }
-      } else {
-        os_breakcheck();
       }
-      if (got_int) {
-        break;
-      }
-    }
-  })
+    })
+  }
 
   // If the whole list is flushed, the memfile is not dirty anymore.
   // In case of an error, dirty flag is also set, to avoid trying all the time.
-  if (hp == NULL || status == FAIL) {
+  if ((!stopped && hp == NULL) || status == FAIL) {
     mfp->mf_dirty = MF_DIRTY_NO;
   }
 
@@ -439,6 +448,88 @@ int mf_sync(memfile_T *mfp, int flags)
   return status;
 }
 
+/// Write dirty blocks that are inside the swap file, sorted on block number.
+/// Blocks with consecutive block numbers are written with one system call.
+/// Blocks that fail to be written stay dirty, mf_write() handles them.
+///
+/// @return  false when stopped because a character is available or CTRL-C
+///          was typed.
+static bool mf_write_runs(memfile_T *mfp, int flags)
+{
+  enum { MF_MAX_IOV = 64, };
+
+  kvec_t(bhdr_T *) blocks = KV_INITIAL_VALUE;
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if ((hp->bh_flags & BH_DIRTY) && hp->bh_bnum >= 0
+        && hp->bh_bnum < mfp->mf_infile_count) {
+      kv_push(blocks, hp);
+    }
+  })
+  if (kv_size(blocks) < 2) {
+    kv_destroy(blocks);
+    return true;
+  }
+  qsort(blocks.items, kv_size(blocks), sizeof(bhdr_T *), mf_bnum_cmp);
+
+  bool ret = true;
+  uv_buf_t bufs[MF_MAX_IOV];
+  // Sync from last to first, like mf_sync().
+  size_t end = kv_size(blocks);
+  while (end > 0) {
+    size_t start = end - 1;
+    while (start > 0 && end - start < MF_MAX_IOV
+           && (kv_A(blocks, start - 1)->bh_bnum
+               + (blocknr_T)kv_A(blocks, start - 1)->bh_page_count
+               == kv_A(blocks, start)->bh_bnum)) {
+      start--;
+    }
+    ptrdiff_t size = 0;
+    for (size_t i = start; i < end; i++) {
+      hp = kv_A(blocks, i);
+      bufs[i - start] = uv_buf_init(hp->bh_data, mfp->mf_page_size * hp->bh_page_count);
+      size += (ptrdiff_t)bufs[i - start].len;
+    }
+    off_T offset = (off_T)mfp->mf_page_size * kv_A(blocks, start)->bh_bnum;
+    if (os_pwritev(mfp->mf_fd, bufs, (unsigned)(end - start), offset) != size) {
+      break;  // let mf_write() retry and give the error message
+    }
+    did_swapwrite_msg = false;
+    for (size_t i = start; i < end; i++) {
+      hp = kv_A(blocks, i);
+      hp->bh_flags &= ~BH_DIRTY;
+      if (hp->bh_bnum + (blocknr_T)hp->bh_page_count > mfp->mf_infile_count) {
+        mfp->mf_infile_count = hp->bh_bnum + hp->bh_page_count;
+      }
+    }
+    end = start;
+
+    if (flags & MFS_STOP) {  // Stop when char available now.
+      if (os_char_avail()) {
+        ret = false;
+        break;
+      }
+    } else {
+      os_breakcheck();
+    }
+    if (got_int) {
+      ret = false;
+      break;
+    }
+  }
+
+  kv_destroy(blocks);
+  return ret;
+}
+
+/// Compare two block headers on block number, for qsort().
+static int mf_bnum_cmp(const void *a, const void *b)
+{
+  blocknr_T bnum_a = (*(const bhdr_T **)a)->bh_bnum;
+  blocknr_T bnum_b = (*(const bhdr_T **)b)->bh_bnum;
+  return bnum_a < bnum_b ? -1 : bnum_a > bnum_b;
+}
+
 /// Set dirty flag for all blocks in memory file with a positive block number.
 /// These are blocks that need to be written to a newly created swapfile.
 void mf_set_dirty(memfile_T *mfp)
@@ -469,27 +560,42 @@ bool mf_release_all(void)
       }
 
       // Flush as many blocks as possible, only if there is a swapfile.
-      if (mfp->mf_fd >= 0) {
-        for (int i = 0; i < (int)map_size(&mfp->mf_hash);) {
-          bhdr_T *hp = mfp->mf_hash.values[i];
-          if (!(hp->bh_flags & BH_LOCKED)
-              && (!(hp->bh_flags & BH_DIRTY)
-                  || mf_write(mfp, hp) != FAIL)) {
-            pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
-            mf_free_bhdr(hp);
-            retval = true;
-            // Rerun with the same value of i. another item will have taken
-            // its place (or it was the last)
-          } else {
-            i++;
-          }
-        }
+      if (mf_release_blocks(mfp)) {
+        retval = true;
       }
     }
   }
   return retval;
 }
 
+/// Write the blocks of "mfp" that are not locked to the swap file and free
+/// their memory.  They are read back by mf_get() when needed.
+///
+/// @return  Whether any memory was released.
+bool mf_release_blocks(memfile_T *mfp)
+{
+  bool retval = false;
+  if (mfp->mf_fd < 0) {
+    return false;
+  }
+  for (int i = 0; i < (int)map_size(&mfp->mf_hash);) {
+    bhdr_T *hp = mfp->mf_hash.values[i];
+    if (!(hp->bh_flags & BH_LOCKED)
+        && (!(hp->bh_flags & BH_DIRTY)
+            || mf_write(mfp, hp) != FAIL)) {
+      pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
+      mf_free_bhdr(hp);
+      g_stats.memfile_release++;
+      retval = true;
+      // Rerun with the same value of i. another item will have taken
+      // its place (or it was the last)
+    } else {
+      i++;
+    }
+  }
+  return retval;
+}
+
 /// Allocate a block header and a block of memory for it.
 static bhdr_T *mf_alloc_bhdr(memfile_T *mfp, unsigned page_count)
 {
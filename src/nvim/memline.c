@@ -224,6 +224,10 @@ typedef struct {
 
 #define STACK_INCR      5       // nr of entries added to ml_stack at a time
 
+// Seconds a buffer must be hidden and unused before ml_sync_all() releases
+// the memory of its blocks.
+enum { ML_HIDDEN_RELEASE_TIME = 60, };
+
 // The line number where the first mark may be is remembered.
 // If it is 0 there are no marks at all.
 // (always used for the current buffer only, no buffer change possible while
@@ -296,6 +300,9 @@ int ml_open(buf_T *buf)
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_chunksize = NULL;
   buf->b_ml.ml_usedchunks = 0;
+  buf->b_ml.ml_chunkstart = NULL;
+  buf->b_ml.ml_chunkstart_size = 0;
+  buf->b_ml.ml_chunkstart_valid = 0;
 
   if (cmdmod.cmod_flags & CMOD_NOSWAPFILE) {
     buf->b_p_swf = false;
@@ -578,6 +585,9 @@ void ml_close(buf_T *buf, int del_file)
   }
   xfree(buf->b_ml.ml_stack);
   XFREE_CLEAR(buf->b_ml.ml_chunksize);
+  XFREE_CLEAR(buf->b_ml.ml_chunkstart);
+  buf->b_ml.ml_chunkstart_size = 0;
+  buf->b_ml.ml_chunkstart_valid = 0;
   buf->b_ml.ml_mfp = NULL;
 
   // Reset the "recovered" flag, give the ATTENTION prompt the next time
@@ -1720,6 +1730,15 @@ void ml_sync_all(int check_file, int check_char, bool do_fsync)
         break;
       }
     }
+    // When idle, the text of a hidden buffer that was not used for a while
+    // is kept in the swap file only, it is read back when needed.
+    if (check_file && buf->b_nwindows == 0 && buf != curbuf
+        && time(NULL) - buf->b_last_used >= ML_HIDDEN_RELEASE_TIME
+        && mf_release_blocks(buf->b_ml.ml_mfp)) {
+      if (check_char && os_char_avail()) {      // character available now
+        break;
+      }
+    }
   }
 }
 
@@ -1858,6 +1877,69 @@ colnr_T ml_get_buf_len(buf_T *buf, linenr_T lnum)
   return buf->b_ml.ml_line_len - 1;
 }
 
+/// Get a run of lines starting at "lnum" directly from the data block that
+/// contains it, avoiding the overhead of ml_get_buf() for each line.
+/// The block is locked.  The pointers stay valid while ml_get_locked_block()
+/// returns the same block and the buffer is not changed.
+///
+/// @param[out] lines  pointers to the NUL terminated lines
+/// @param[out] lens   length of each line, excluding the NUL
+///
+/// @return  the number of lines, at most "maxlines".  Zero when the lines are
+///          not available, then use ml_get_buf().
+int ml_get_buf_lines(buf_T *buf, linenr_T lnum, int maxlines, char **lines, colnr_T *lens)
+  FUNC_ATTR_NONNULL_ALL
+{
+  // A changed line is not in the data block yet.  Don't flush it, the caller
+  // may still be using the pointer to it.
+  if (buf->b_ml.ml_mfp == NULL || (buf->b_ml.ml_flags & ML_LINE_DIRTY)
+      || lnum < 1 || lnum > buf->b_ml.ml_line_count || maxlines <= 0) {
+    return 0;
+  }
+
+  bhdr_T *hp = ml_find_line(buf, lnum, ML_FIND);
+  if (hp == NULL) {
+    return 0;
+  }
+
+  DataBlock *dp = hp->bh_data;
+  int count = MIN(maxlines, buf->b_ml.ml_locked_high - lnum + 1);
+  for (int i = 0; i < count; i++) {
+    int idx = lnum + i - buf->b_ml.ml_locked_low;
+    unsigned start = (dp->db_index[idx] & DB_INDEX_MASK);
+    unsigned end = idx == 0 ? dp->db_txt_end : (dp->db_index[idx - 1] & DB_INDEX_MASK);
+    lines[i] = (char *)dp + start;
+    lens[i] = (colnr_T)(end - start) - 1;
+  }
+  return count;
+}
+
+/// Like ml_get_buf_lines(), but when the lines are not available in a data
+/// block get line "lnum" with ml_get_buf().  For reading a range of lines
+/// without copying them.  The pointers are valid until the next ml_get()
+/// call or change in the buffer.
+///
+/// @return  the number of lines, at least one for a valid "lnum".
+int ml_get_buf_span(buf_T *buf, linenr_T lnum, int maxlines, char **lines, colnr_T *lens)
+  FUNC_ATTR_NONNULL_ALL
+{
+  int count = ml_get_buf_lines(buf, lnum, maxlines, lines, lens);
+  if (count == 0 && maxlines > 0) {
+    lines[0] = ml_get_buf(buf, lnum);
+    lens[0] = ml_get_buf_len(buf, lnum);
+    count = 1;
+  }
+  return count;
+}
+
+/// @return  the currently locked data block of "buf", used to check that
+///          lines returned by ml_get_buf_lines() are still valid.
+const void *ml_get_locked_block(const buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  return buf->b_ml.ml_locked;
+}
+
 /// @return  codepoint at pos. pos must be either valid or have col set to MAXCOL!
 int gchar_pos(pos_T *pos)
   FUNC_ATTR_NONNULL_ARG(1)
@@ -2020,6 +2102,140 @@ int ml_append_buf(buf_T *buf, linenr_T lnum, char *line, colnr_T len, bool newfi
   return ml_append_int(buf, lnum, line, len, newfile, false);
 }
 
+/// Append "count" lines after lnum, like calling ml_append() for each of them.
+/// Lines that fit in the data block where the previous line was inserted are
+/// copied into it at once, instead of looking up the block for every line.
+///
+/// @param lnum  append after this line (can be 0)
+/// @param lines  text of the new lines
+/// @param lens  length of each line, including NUL, or 0
+/// @param count  number of lines
+/// @param newfile  flag, see ml_append()
+///
+/// @return  FAIL for failure, OK otherwise
+int ml_append_many(linenr_T lnum, char **lines, const colnr_T *lens, int count, bool newfile)
+{
+  // When starting up, we might still need to create the memfile
+  if (curbuf->b_ml.ml_mfp == NULL && open_buffer(false, NULL, 0) == FAIL) {
+    return FAIL;
+  }
+
+  return ml_append_many_int(curbuf, lnum, lines, lens, count, newfile);
+}
+
+/// Like ml_append_many() but for an arbitrary buffer.  The buffer must already
+/// have a memline.
+int ml_append_buf_many(buf_T *buf, linenr_T lnum, char **lines, const colnr_T *lens, int count,
+                       bool newfile)
+  FUNC_ATTR_NONNULL_ARG(1)
+{
+  if (buf->b_ml.ml_mfp == NULL) {
+    return FAIL;
+  }
+
+  return ml_append_many_int(buf, lnum, lines, lens, count, newfile);
+}
+
+static int ml_append_many_int(buf_T *buf, linenr_T lnum, char **lines, const colnr_T *lens,
+                              int count, bool newfile)
+{
+  if (buf->b_ml.ml_line_lnum != 0) {
+    ml_flush_line(buf, false);
+  }
+
+  int done = 0;
+  while (done < count) {
+    // Insert one line the normal way, this locks the data block it ends up
+    // in and splits blocks when needed.
+    if (ml_append_int(buf, lnum + done, lines[done], lens[done], newfile, false) == FAIL) {
+      return FAIL;
+    }
+    done++;
+    done += ml_append_locked(buf, lnum + done, lines + done, lens + done, count - done, newfile);
+  }
+  return OK;
+}
+
+/// Append lines after line "lnum" for as long as "lnum" is in the locked data
+/// block and there is room in it.  Does what ml_append_int() does for every
+/// line, without looking up the block again.
+///
+/// @return  the number of lines that were appended
+static int ml_append_locked(buf_T *buf, linenr_T lnum, char **lines, const colnr_T *lens,
+                            int count, bool newfile)
+{
+  bhdr_T *hp = buf->b_ml.ml_locked;
+  int n = 0;
+
+  // ml_updatechunk() may release the locked block, check it every time.
+  while (n < count && hp != NULL && buf->b_ml.ml_locked == hp
+         && lnum >= buf->b_ml.ml_locked_low && lnum <= buf->b_ml.ml_locked_high) {
+    DataBlock *dp = hp->bh_data;
+    colnr_T len = lens[n] != 0 ? lens[n] : (colnr_T)strlen(lines[n]) + 1;
+    if ((int)dp->db_free < len + (int)INDEX_SIZE) {
+      break;
+    }
+
+    if (lowest_marked && lowest_marked > lnum) {
+      lowest_marked = lnum + 1;
+    }
+
+    int db_idx = lnum - buf->b_ml.ml_locked_low;
+    int line_count = buf->b_ml.ml_locked_high - buf->b_ml.ml_locked_low + 1;
+    ml_insert_in_block(dp, db_idx, line_count, lines[n], len, false);
+
+    // The pointer blocks are updated when the block is released.
+    buf->b_ml.ml_locked_lineadd++;
+    buf->b_ml.ml_locked_high++;
+    buf->b_ml.ml_line_count++;
+
+    // Mark the block dirty.
+    buf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
+    if (!newfile) {
+      buf->b_ml.ml_flags |= ML_LOCKED_POS;
+    }
+
+    ml_updatechunk(buf, lnum + 1, len, ML_CHNK_ADDLINE);
+    lnum++;
+    n++;
+  }
+  return n;
+}
+
+/// Insert line "line[len]" after index "db_idx" in data block "dp", which has
+/// "line_count" lines.  There must be enough room for it.
+static void ml_insert_in_block(DataBlock *dp, int db_idx, int line_count, const char *line,
+                               colnr_T len, bool mark)
+{
+  dp->db_txt_start -= (unsigned)len;
+  dp->db_free -= (unsigned)len + (unsigned)INDEX_SIZE;
+  dp->db_line_count++;
+
+  // move the text of the lines that follow to the front
+  // adjust the indexes of the lines that follow
+  if (line_count > db_idx + 1) {          // if there are following lines
+    // Offset is the start of the previous line.
+    // This will become the character just after the new line.
+    int offset = db_idx < 0 ? (int)dp->db_txt_end
+                            : (int)((dp->db_index[db_idx]) & DB_INDEX_MASK);
+    memmove((char *)dp + dp->db_txt_start,
+            (char *)dp + dp->db_txt_start + len,
+            (size_t)offset - (dp->db_txt_start + (size_t)len));
+    for (int i = line_count - 1; i > db_idx; i--) {
+      dp->db_index[i + 1] = dp->db_index[i] - (unsigned)len;
+    }
+    dp->db_index[db_idx + 1] = (unsigned)(offset - len);
+  } else {  // add line at the end
+    dp->db_index[db_idx + 1] = dp->db_txt_start;
+  }
+
+  // copy the text into the block
+  memmove((char *)dp + dp->db_index[db_idx + 1], line, (size_t)len);
+  if (mark) {
+    dp->db_index[db_idx + 1] |= DB_MARKED;
+  }
+}
+
 /// @param lnum  append after this line (can be 0)
 /// @param line  text of the new line
 /// @param len  length of line, including NUL, or 0
@@ -2098,33 +2314,7 @@ static int ml_append_int(buf_T *buf, linenr_T lnum, char *line, colnr_T len, boo
 
   if ((int)dp->db_free >= space_needed) {       // enough room in data block
     // Insert new line in existing data block, or in data block allocated above.
-    dp->db_txt_start -= (unsigned)len;
-    dp->db_free -= (unsigned)space_needed;
-    dp->db_line_count++;
-
-    // move the text of the lines that follow to the front
-    // adjust the indexes of the lines that follow
-    if (line_count > db_idx + 1) {          // if there are following lines
-      // Offset is the start of the previous line.
-      // This will become the character just after the new line.
-      int offset = db_idx < 0 ? (int)dp->db_txt_end
-                              : (int)((dp->db_index[db_idx]) & DB_INDEX_MASK);
-      memmove((char *)dp + dp->db_txt_start,
-              (char *)dp + dp->db_txt_start + len,
-              (size_t)offset - (dp->db_txt_start + (size_t)len));
-      for (int i = line_count - 1; i > db_idx; i--) {
-        dp->db_index[i + 1] = dp->db_index[i] - (unsigned)len;
-      }
-      dp->db_index[db_idx + 1] = (unsigned)(offset - len);
-    } else {  // add line at the end
-      dp->db_index[db_idx + 1] = dp->db_txt_start;
-    }
-
-    // copy the text into the block
-    memmove((char *)dp + dp->db_index[db_idx + 1], line, (size_t)len);
-    if (mark) {
-      dp->db_index[db_idx + 1] |= DB_MARKED;
-    }
+    ml_insert_in_block(dp, db_idx, line_count, line, len, mark);
 
     // Mark the block dirty.
     buf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
@@ -2918,6 +3108,7 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
         (buf->b_ml.ml_locked_lineadd)--;
         (buf->b_ml.ml_locked_high)--;
       }
+      g_stats.ml_locked_hit++;
       return buf->b_ml.ml_locked;
     }
 
@@ -2936,6 +3127,7 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
     return NULL;
   }
 
+  g_stats.ml_tree_search++;
   blocknr_T bnum = 1;                         // start at the root of the tree
   blocknr_T bnum2;
   int page_count = 1;
@@ -3752,6 +3944,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
 
   if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1) {
     // First line in empty buffer from ml_flush_line() -- reset
+    buf->b_ml.ml_chunkstart_valid = 0;
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = buf->b_ml.ml_line_len;
@@ -3777,6 +3970,9 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   }
   chunksize_T *curchnk = buf->b_ml.ml_chunksize + curix;
 
+  // This chunk changes, and the one before it when chunks are collapsed.
+  buf->b_ml.ml_chunkstart_valid = MIN(buf->b_ml.ml_chunkstart_valid, MAX(curix - 1, 0));
+
   if (updtype == ML_CHNK_DELLINE) {
     len = -len;
   }
@@ -3904,6 +4100,69 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   ml_upd_lastcurix = curix;
 }
 
+/// Check if line "lnum" or byte offset "offset" is after the lines and bytes
+/// in "start", which is an entry in ml_chunkstart.
+static bool ml_chunk_before(const chunksize_T *start, linenr_T lnum, int offset, int ffdos)
+{
+  return (lnum != 0 && lnum > start->mlcs_numlines)
+         || (offset != 0
+             && offset > start->mlcs_totalsize + ffdos * start->mlcs_numlines);
+}
+
+/// Find the chunk that contains line "lnum" or byte offset "offset".
+/// Computes the lines and bytes before the chunks in ml_chunkstart up to the
+/// wanted chunk, where they are not valid yet since the last change.
+///
+/// @return  index of the chunk, ml_chunkstart[index] is valid.
+static int ml_find_chunk(buf_T *buf, linenr_T lnum, int offset, int ffdos)
+{
+  memline_T *ml = &buf->b_ml;
+  int last = MAX(ml->ml_usedchunks - 1, 0);
+
+  if (ml->ml_chunkstart_size <= last) {
+    ml->ml_chunkstart_size = MAX(ml->ml_numchunks, last + 1);
+    ml->ml_chunkstart = xrealloc(ml->ml_chunkstart,
+                                 sizeof(chunksize_T) * (size_t)ml->ml_chunkstart_size);
+  }
+  ml->ml_chunkstart[0].mlcs_numlines = 0;
+  ml->ml_chunkstart[0].mlcs_totalsize = 0;
+  ml->ml_chunkstart_valid = MIN(ml->ml_chunkstart_valid, last);
+
+  chunksize_T *start = ml->ml_chunkstart;
+  int valid = ml->ml_chunkstart_valid;
+  if (ml_chunk_before(&start[valid], lnum, offset, ffdos)) {
+    // Beyond the valid entries: add up the following chunks until the
+    // one containing the position.  The last chunk is special because it
+    // will never qualify.
+    while (valid < last) {
+      start[valid + 1].mlcs_numlines = start[valid].mlcs_numlines
+                                       + ml->ml_chunksize[valid].mlcs_numlines;
+      start[valid + 1].mlcs_totalsize = start[valid].mlcs_totalsize
+                                        + ml->ml_chunksize[valid].mlcs_totalsize;
+      valid++;
+      if (!ml_chunk_before(&start[valid], lnum, offset, ffdos)) {
+        ml->ml_chunkstart_valid = valid;
+        return valid - 1;
+      }
+    }
+    ml->ml_chunkstart_valid = valid;
+    return valid;
+  }
+
+  // Binary search for the last chunk that starts before the position.
+  int lo = 0;
+  int hi = valid;
+  while (lo < hi) {
+    int mid = lo + (hi - lo + 1) / 2;
+    if (ml_chunk_before(&start[mid], lnum, offset, ffdos)) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
 /// Find offset for line or line with offset.
 ///
 /// @param buf buffer to use
@@ -3958,24 +4217,13 @@ int ml_find_line_or_offset(buf_T *buf, linenr_T lnum, int *offp, bool no_ff)
   if (lnum == 0 && offset <= 0) {
     return 1;       // Not a "find offset" and offset 0 _must_ be in line 1
   }
-  // Find the last chunk before the one containing our line. Last chunk is
-  // special because it will never qualify
-  linenr_T curline = 1;
-  int curix = 0;
-  int size = 0;
-  while (curix < buf->b_ml.ml_usedchunks - 1
-         && ((lnum != 0
-              && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-             || (offset != 0
-                 && offset > size +
-                 buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-                 + ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines))) {
-    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-    if (offset && ffdos) {
-      size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
-    curix++;
+  // Find the chunk containing our line.
+  int curix = ml_find_chunk(buf, lnum, offset, ffdos);
+  chunksize_T *start = &buf->b_ml.ml_chunkstart[curix];
+  linenr_T curline = 1 + start->mlcs_numlines;
+  int size = start->mlcs_totalsize;
+  if (offset && ffdos) {
+    size += start->mlcs_numlines;
   }
 
   while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset)) {
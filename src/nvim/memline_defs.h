@@ -34,6 +34,8 @@ typedef struct {
 ///
 /// Memline also has "chunks" of 800 lines that are separate from the 128-tree
 /// structure, primarily used to speed up line2byte() and byte2line().
+/// The number of lines and bytes before each chunk is computed when needed,
+/// to find the chunk with a binary search.
 ///
 /// Motivation: If you have a file that is 10000 lines long, and you insert
 ///             a line at linenr 1000, you don't want to move 9000 lines in
@@ -69,4 +71,7 @@ typedef struct {
   chunksize_T *ml_chunksize;
   int ml_numchunks;
   int ml_usedchunks;
+  chunksize_T *ml_chunkstart;   // lines and bytes before each chunk
+  int ml_chunkstart_size;       // allocated entries in ml_chunkstart
+  int ml_chunkstart_valid;      // ml_chunkstart[0] up to this one is valid
 } memline_T;
@@ -7,12 +7,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <uv.h>
 
 #include "nvim/api/extmark.h"
 #include "nvim/api/private/helpers.h"
 #include "nvim/api/ui.h"
 #include "nvim/arglist.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/assert_defs.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/buffer_updates.h"
 #include "nvim/channel.h"
@@ -676,6 +678,123 @@ void *mergesort_list(void *head, MergeSortGetFunc get_next, MergeSortSetFunc set
   return head;
 }
 
+/// Call "fn" for each of the "count" items of "size" bytes at "items", each
+/// in its own thread, and wait for all of them to finish.
+///
+/// This thread handles the first item, and any item a thread could not be
+/// started for.
+void run_in_threads(void *items, size_t count, size_t size, void (*fn)(void *))
+{
+  uv_thread_t *threads = xmalloc(count * sizeof(*threads));
+  bool *started = xcalloc(count, sizeof(*started));
+  for (size_t i = 1; i < count; i++) {
+    started[i] = uv_thread_create(&threads[i], fn, (char *)items + i * size) == 0;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!started[i]) {
+      fn((char *)items + i * size);
+    }
+  }
+  for (size_t i = 1; i < count; i++) {
+    if (started[i]) {
+      uv_thread_join(&threads[i]);
+    }
+  }
+  xfree(started);
+  xfree(threads);
+}
+
+#define QSORT_PARALLEL_MAX_THREADS 8
+
+/// Part of the array sorted by one thread of qsort_parallel().
+typedef struct {
+  char *base;
+  size_t count;
+  size_t size;
+  MergeSortCompareFunc compare;
+} qsort_chunk_T;
+
+static void qsort_chunk_thread(void *arg)
+{
+  qsort_chunk_T *chunk = arg;
+  qsort(chunk->base, chunk->count, chunk->size, chunk->compare);
+}
+
+/// Merge the sorted runs src[lo:mid] and src[mid:hi] into dst[lo:hi].
+static void qsort_merge(const char *src, char *dst, size_t lo, size_t mid, size_t hi,
+                        size_t size, MergeSortCompareFunc compare)
+{
+  size_t i = lo;
+  size_t j = mid;
+  char *p = dst + lo * size;
+  while (i < mid && j < hi) {
+    if (compare(src + j * size, src + i * size) < 0) {
+      memcpy(p, src + j++ * size, size);
+    } else {
+      memcpy(p, src + i++ * size, size);
+    }
+    p += size;
+  }
+  memcpy(p, src + i * size, (mid - i) * size);
+  p += (mid - i) * size;
+  memcpy(p, src + j * size, (hi - j) * size);
+}
+
+/// Like qsort(), but arrays of at least QSORT_PARALLEL_MIN elements are split
+/// in parts that are sorted in threads and then merged.
+///
+/// "compare" must be safe to call from other threads and may only return zero
+/// for an element compared with itself.  The result is then the same as with
+/// qsort().
+void qsort_parallel(void *base, size_t count, size_t size, MergeSortCompareFunc compare)
+{
+  size_t nthreads = MIN((size_t)uv_available_parallelism(), QSORT_PARALLEL_MAX_THREADS);
+  if (count < QSORT_PARALLEL_MIN || nthreads < 2) {
+    qsort(base, count, size, compare);
+    return;
+  }
+
+  qsort_chunk_T chunks[QSORT_PARALLEL_MAX_THREADS];
+  size_t bounds[QSORT_PARALLEL_MAX_THREADS + 1];
+  for (size_t i = 0; i < nthreads; i++) {
+    bounds[i] = count * i / nthreads;
+    chunks[i] = (qsort_chunk_T){
+      .base = (char *)base + bounds[i] * size,
+      .count = count * (i + 1) / nthreads - bounds[i],
+      .size = size,
+      .compare = compare,
+    };
+  }
+  bounds[nthreads] = count;
+  run_in_threads(chunks, nthreads, sizeof(*chunks), qsort_chunk_thread);
+
+  // Merge neighbouring runs until one is left.
+  char *tmp = xmalloc(count * size);
+  char *src = base;
+  char *dst = tmp;
+  size_t nruns = nthreads;
+  while (nruns > 1) {
+    size_t n = 0;
+    for (size_t r = 0; r < nruns; r += 2) {
+      if (r + 1 < nruns) {
+        qsort_merge(src, dst, bounds[r], bounds[r + 1], bounds[r + 2], size, compare);
+      } else {
+        memcpy(dst + bounds[r] * size, src + bounds[r] * size, (bounds[r + 1] - bounds[r]) * size);
+      }
+      bounds[n++] = bounds[r];
+    }
+    bounds[n] = count;
+    nruns = n;
+    char *swap = src;
+    src = dst;
+    dst = swap;
+  }
+  if (src != base) {
+    memcpy(base, src, count * size);
+  }
+  xfree(tmp);
+}
+
 #define REUSE_MAX 4
 
 static struct consumed_blk *arena_reuse_blk;
@@ -821,6 +940,107 @@ char *arena_memdupz(Arena *arena, const char *buf, size_t size)
   return mem;
 }
 
+/// Pools that objects were allocated from, for pool_stats().
+static MemPool *used_pools = NULL;
+
+// With ASAN every pool object is allocated separately, to find use after free.
+// Unit tests check the allocations.
+#if __has_feature(address_sanitizer) || defined(UNIT_TESTING)
+# define POOL_USE_MALLOC
+#endif
+
+/// Allocates an object from "pool".
+///
+/// Objects are taken from ARENA_BLOCK_SIZE blocks and freed objects are reused
+/// for the next allocation. For small objects that are allocated and freed
+/// often this avoids the malloc() overhead per object and fragmenting the heap.
+/// The blocks are only freed on exit.
+///
+/// @return  uninitialized memory for one object, free it with pool_free().
+void *pool_alloc(MemPool *pool)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_NONNULL_RET
+{
+  if (!pool->used) {
+    pool->used = true;
+    pool->next = used_pools;
+    used_pools = pool;
+  }
+  pool->live++;
+
+#ifdef POOL_USE_MALLOC
+  return xmalloc(pool->size);
+#else
+  if (pool->free_list != NULL) {
+    void *obj = pool->free_list;
+    pool->free_list = *(void **)obj;
+    pool->free--;
+    return obj;
+  }
+
+  size_t size = pool_obj_size(pool);
+  if (pool->cur_blk == NULL || pool->pos + size > ARENA_BLOCK_SIZE) {
+    struct consumed_blk *blk = alloc_block();
+    blk->prev = (struct consumed_blk *)pool->cur_blk;
+    pool->cur_blk = (char *)blk;
+    pool->pos = arena_align_offset(sizeof(struct consumed_blk));
+    pool->blocks++;
+  }
+  void *obj = pool->cur_blk + pool->pos;
+  pool->pos += size;
+  return obj;
+#endif
+}
+
+/// Frees an object allocated with pool_alloc() from the same "pool".
+void pool_free(MemPool *pool, void *obj)
+  FUNC_ATTR_NONNULL_ARG(1)
+{
+  if (obj == NULL) {
+    return;
+  }
+  pool->live--;
+
+#ifdef POOL_USE_MALLOC
+  xfree(obj);
+#else
+  *(void **)obj = pool->free_list;
+  pool->free_list = obj;
+  pool->free++;
+#endif
+}
+
+#ifndef POOL_USE_MALLOC
+/// Size of an object of "pool" in a block: large enough for the free list link
+/// and aligned like arena_alloc() does.
+static size_t pool_obj_size(const MemPool *pool)
+{
+  size_t size = arena_align_offset(MAX(pool->size, sizeof(void *)));
+  assert(size <= ARENA_BLOCK_SIZE - arena_align_offset(sizeof(struct consumed_blk)));
+  return size;
+}
+#endif
+
+/// @return  dict with the object size, number of allocated objects, number
+///          of free objects and number of blocks of every pool which was used.
+Dict pool_stats(Arena *arena)
+{
+  size_t count = 0;
+  for (MemPool *pool = used_pools; pool != NULL; pool = pool->next) {
+    count++;
+  }
+
+  Dict rv = arena_dict(arena, count);
+  for (MemPool *pool = used_pools; pool != NULL; pool = pool->next) {
+    Dict stats = arena_dict(arena, 4);
+    PUT_C(stats, "size", INTEGER_OBJ((Integer)pool->size));
+    PUT_C(stats, "live", INTEGER_OBJ((Integer)pool->live));
+    PUT_C(stats, "free", INTEGER_OBJ((Integer)pool->free));
+    PUT_C(stats, "blocks", INTEGER_OBJ((Integer)pool->blocks));
+    PUT_C(rv, pool->name, DICT_OBJ(stats));
+  }
+  return rv;
+}
+
 #if defined(EXITFREE)
 
 # include "nvim/autocmd.h"
@@ -834,10 +1054,13 @@ char *arena_memdupz(Arena *arena, const char *buf, size_t size)
 # include "nvim/getchar.h"
 # include "nvim/grid.h"
 # include "nvim/mark.h"
+# include "nvim/match.h"
+# include "nvim/mbyte.h"
 # include "nvim/msgpack_rpc/channel.h"
 # include "nvim/ops.h"
 # include "nvim/option.h"
 # include "nvim/os/os.h"
+# include "nvim/profile.h"
 # include "nvim/quickfix.h"
 # include "nvim/regexp.h"
 # include "nvim/search.h"
@@ -845,6 +1068,22 @@ char *arena_memdupz(Arena *arena, const char *buf, size_t size)
 # include "nvim/tag.h"
 # include "nvim/window.h"
 
+/// Frees the blocks of all pools. Objects that were not freed are lost.
+static void pool_free_all_mem(void)
+{
+  while (used_pools != NULL) {
+    MemPool *pool = used_pools;
+    struct consumed_blk *blk = (struct consumed_blk *)pool->cur_blk;
+    while (blk != NULL) {
+      struct consumed_blk *prev = blk->prev;
+      free_block(blk);
+      blk = prev;
+    }
+    used_pools = pool->next;
+    *pool = (MemPool){ .name = pool->name, .size = pool->size };
+  }
+}
+
 // Free everything that we allocated.
 // Can be used to detect memory leaks, e.g., with ccmalloc.
 // NOTE: This is tricky!  Things are freed that functions depend on.  Don't be
@@ -893,11 +1132,14 @@ void free_all_mem(void)
 
   // Obviously named calls.
   free_all_autocmds();
+  trace_free_all();
   free_all_marks();
   alist_clear(&global_alist);
   free_homedir();
+  free_exe_cache();
   free_users();
   free_search_patterns();
+  free_match_stuff();
   free_old_sub();
   free_last_insert();
   free_insexpand_stuff();
@@ -985,6 +1227,7 @@ void free_all_mem(void)
 
   decor_free_all_mem();
   drawline_free_all_mem();
+  mbyte_free_all_mem();
 
   if (ui_client_channel_id) {
     ui_client_free_all_mem();
@@ -995,6 +1238,7 @@ void free_all_mem(void)
   ui_comp_free_all_mem();
   nlua_free_all_mem();
   rpc_free_all_mem();
+  pool_free_all_mem();
 
   // should be last, in case earlier free functions deallocates arenas
   arena_free_reuse_blks();
@@ -44,6 +44,9 @@ typedef void *(*MergeSortGetFunc)(void *);
 typedef void (*MergeSortSetFunc)(void *, void *);
 typedef int (*MergeSortCompareFunc)(const void *, const void *);
 
+/// Minimal number of elements for qsort_parallel() to use threads.
+#define QSORT_PARALLEL_MIN 65536
+
 EXTERN size_t arena_alloc_count INIT( = 0);
 
 #define kv_fixsize_arena(a, v, s) \
@@ -15,3 +15,20 @@ typedef struct {
 
 // inits an empty arena.
 #define ARENA_EMPTY { .cur_blk = NULL, .pos = 0, .size = 0 }
+
+/// Pool of objects of one type, see pool_alloc().
+typedef struct mem_pool {
+  const char *name;
+  size_t size;  ///< size of one object
+  void *free_list;  ///< freed objects, linked through their first pointer
+  char *cur_blk;  ///< block new objects are taken from
+  size_t pos;  ///< position of the next new object in "cur_blk"
+  size_t live;  ///< number of allocated objects
+  size_t free;  ///< number of objects in "free_list"
+  size_t blocks;  ///< number of blocks
+  struct mem_pool *next;  ///< next used pool, see pool_stats()
+  bool used;
+} MemPool;
+
+/// inits a pool for objects of type "type"
+#define MEM_POOL_INIT(name_, type) { .name = (name_), .size = sizeof(type) }
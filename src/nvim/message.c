@@ -2249,6 +2249,8 @@ static void msg_puts_display(const char *str, int maxlen, int hl_id, int recurse
   cmdline_was_last_drawn = redrawing_cmdline;
 
   int msg_row_pending = -1;
+  // Text before "draw_start" scrolls off the screen before it is shown.
+  const char *draw_start = msg_scrolled_off_end(str, maxlen, recurse);
 
   while (true) {
     if (msg_col >= Columns) {
@@ -2311,7 +2313,8 @@ static void msg_puts_display(const char *str, int maxlen, int hl_id, int recurse
       break;
     }
 
-    if (msg_row != msg_row_pending && ((uint8_t)(*s) >= 0x20 || *s == TAB)) {
+    const bool draw = s >= draw_start;
+    if (draw && msg_row != msg_row_pending && ((uint8_t)(*s) >= 0x20 || *s == TAB)) {
       // TODO(bfredl): this logic is messier that it has to be. What
       // messages really want is its own private linebuf_char buffer.
       if (msg_row_pending >= 0) {
@@ -2328,10 +2331,14 @@ static void msg_puts_display(const char *str, int maxlen, int hl_id, int recurse
 
       if (cw > 1 && (msg_col == Columns - 1)) {
         // Doesn't fit, print a highlighted '>' to fill it up.
-        grid_line_puts(msg_col, ">", 1, HL_ATTR(HLF_AT));
+        if (draw) {
+          grid_line_puts(msg_col, ">", 1, HL_ATTR(HLF_AT));
+        }
         cw = 1;
       } else {
-        grid_line_puts(msg_col, s, l, print_attr);
+        if (draw) {
+          grid_line_puts(msg_col, s, l, print_attr);
+        }
         s += l;
       }
       msg_didout = true;  // remember that line is not empty
@@ -2354,7 +2361,9 @@ static void msg_puts_display(const char *str, int maxlen, int hl_id, int recurse
         }
       } else if (c == TAB) {  // translate Tab into spaces
         do {
-          grid_line_puts(msg_col, " ", 1, print_attr);
+          if (draw) {
+            grid_line_puts(msg_col, " ", 1, print_attr);
+          }
           msg_col += 1;
 
           if (msg_col == Columns) {
@@ -2379,6 +2388,29 @@ static void msg_puts_display(const char *str, int maxlen, int hl_id, int recurse
   msg_check();
 }
 
+/// Without a more-prompt the lines of a long message are only sent to the UI
+/// when the throttled message grid is flushed, see msg_scroll_flush(). Lines
+/// followed by at least a screen full of lines have scrolled off the screen by
+/// then, they don't need to be drawn.
+///
+/// @return  end of the text in "str" that doesn't need to be drawn, "str" when
+///          all of it must be drawn.
+static const char *msg_scrolled_off_end(const char *str, int maxlen, int recurse)
+{
+  if (recurse || p_more || msg_no_more || !msg_do_throttle()) {
+    return str;
+  }
+  const char *p = str + (maxlen < 0 ? strlen(str) : strnlen(str, (size_t)maxlen));
+  int newlines = 0;
+  while (p > str) {
+    p--;
+    if (*p == '\n' && ++newlines == Rows) {
+      return p;
+    }
+  }
+  return str;
+}
+
 void msg_line_flush(void)
 {
   if (cmdmsg_rl) {
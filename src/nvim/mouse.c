@@ -1117,7 +1117,7 @@ void ins_mousescroll(int dir)
   // Call the common mouse scroll function shared with other modes.
   do_mousescroll(&cap);
 
-  curwin->w_redr_status = true;
+  status_redraw_win(curwin);
   curwin = old_curwin;
   curbuf = curwin->w_buffer;
 
@@ -1593,7 +1593,7 @@ void nv_mousescroll(cmdarg_T *cap)
   // Call the common mouse scroll function shared with other modes.
   do_mousescroll(cap);
 
-  curwin->w_redr_status = true;
+  status_redraw_win(curwin);
   curwin = old_curwin;
   curbuf = curwin->w_buffer;
 }
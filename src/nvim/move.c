@@ -1348,7 +1348,7 @@ bool scrolldown(win_T *wp, linenr_T line_count, int byfold)
       } else {
         wp->w_skipcol -= width1;
       }
-      redraw_later(wp, UPD_NOT_VALID);
+      redraw_later(wp, UPD_VALID);
       done++;
     } else if (can_fill) {
       wp->w_topfill++;
@@ -1505,9 +1505,9 @@ bool scrollup(win_T *wp, linenr_T line_count, bool byfold)
     }
 
     if (prev_skipcol > 0 || wp->w_skipcol > 0) {
-      // need to redraw more, because wl_size of the (new) topline may
-      // now be invalid
-      redraw_later(wp, UPD_NOT_VALID);
+      // wl_size of the (new) topline may now be invalid, win_update()
+      // redraws it and scrolls the rows below it
+      redraw_later(wp, UPD_VALID);
     }
   } else {
     wp->w_topline += line_count;
@@ -2599,7 +2599,7 @@ void do_check_cursorbind(void)
       if (!curwin->w_p_scb) {
         update_topline(curwin);
       }
-      curwin->w_redr_status = true;
+      status_redraw_win(curwin);
     }
   }
 
@@ -29,6 +29,8 @@
 #include "nvim/msgpack_rpc/packer_defs.h"
 #include "nvim/msgpack_rpc/unpacker.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
+#include "nvim/profile.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 #include "nvim/ui_client.h"
@@ -66,10 +68,19 @@ static void log_notify(char *dir, uint64_t channel_id, const char *name)
 # define log_notify(...)
 #endif
 
+/// Number and duration of the handled requests of one method.
+typedef struct {
+  int64_t count;
+  int64_t ns;
+} RpcMethodStats;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "msgpack_rpc/channel.c.generated.h"
 #endif
 
+/// Maps the (static) name of a method to its RpcMethodStats.
+static PMap(cstr_t) rpc_method_stats = MAP_INIT;
+
 void rpc_init(void)
 {
   ch_before_blocking_events = multiqueue_new_child(main_loop.events);
@@ -124,6 +135,9 @@ bool rpc_send_event(uint64_t id, const char *name, Array args)
 
   log_notify(SEND, channel ? channel->id : 0, name);
   if (channel) {
+    if (notification_dropped(channel)) {
+      return false;
+    }
     serialize_request(&channel, 1, 0, name, args);
   } else {
     broadcast_event(name, args);
@@ -338,17 +352,64 @@ static void handle_request(Channel *channel, Unpacker *p, Array args)
     }
   } else {
     bool is_resize = p->handler.fn == handle_nvim_ui_try_resize;
+    if (p->type == kMessageTypeRequest) {
+      channel->rpc.pending_requests++;
+    }
     if (is_resize) {
-      Event ev = event_create_oneshot(event_create(request_event, evdata), 2);
+      Event ev = event_create_oneshot(event_create(queued_request_event, evdata), 2);
       multiqueue_put_event(channel->events, ev);
       multiqueue_put_event(resize_events, ev);
     } else {
-      multiqueue_put(channel->events, request_event, evdata);
+      multiqueue_put(channel->events, queued_request_event, evdata);
       DLOG("RPC: scheduled %.*s", (int)p->method_name_len, p->handler.name);
     }
   }
 }
 
+/// Handles a message which was put on the event queue of the channel.
+///
+/// Keeps count of the requests still on the queue, so that serialize_response()
+/// can hold the responses of pipelined requests.  Held responses are written
+/// before the next request runs, so that a slow request doesn't delay the
+/// responses to the requests before it.
+static void queued_request_event(void **argv)
+{
+  RequestEvent *e = argv[0];
+  if (e->type == kMessageTypeRequest) {
+    assert(e->channel->rpc.pending_requests > 0);
+    e->channel->rpc.pending_requests--;
+  }
+  flush_responses(e->channel);
+  request_event(argv);
+}
+
+static void rpc_method_stats_add(const char *name, uint64_t ns)
+{
+  RpcMethodStats **ref = (RpcMethodStats **)pmap_put_ref(cstr_t)(&rpc_method_stats, name,
+                                                                  NULL, NULL);
+  if (*ref == NULL) {
+    *ref = xcalloc(1, sizeof(**ref));
+  }
+  (*ref)->count++;
+  (*ref)->ns += (int64_t)ns;
+}
+
+/// @return  dict of "count" and "ns" (total duration) of the handled requests
+///          for each method.
+Dict rpc_method_stats_get(Arena *arena)
+{
+  Dict rv = arena_dict(arena, map_size(&rpc_method_stats));
+  const char *name;
+  RpcMethodStats *stats;
+  map_foreach(&rpc_method_stats, name, stats, {
+    Dict d = arena_dict(arena, 2);
+    PUT_C(d, "count", INTEGER_OBJ(stats->count));
+    PUT_C(d, "ns", INTEGER_OBJ(stats->ns));
+    PUT_C(rv, name, DICT_OBJ(d));
+  });
+  return rv;
+}
+
 /// Handles a message, depending on the type:
 ///   - Request: invokes method and writes the response (or error).
 ///   - Notification: invokes method (emits `nvim_error_event` on error).
@@ -363,6 +424,7 @@ static void request_event(void **argv)
     goto free_ret;
   }
 
+  const uint64_t start = os_hrtime();
   Object result = handler.fn(channel->id, e->args, &e->used_mem, &error);
   if (e->type == kMessageTypeRequest || ERROR_SET(&error)) {
     // Send the response.
@@ -371,6 +433,12 @@ static void request_event(void **argv)
   if (handler.ret_alloc) {
     api_free_object(result);
   }
+  const uint64_t elapsed = os_hrtime() - start;
+  g_stats.rpc_request++;
+  g_stats.rpc_request_ns += (int64_t)elapsed;
+  stats_hist_add(g_stats.rpc_hist, elapsed);
+  rpc_method_stats_add(handler.name, elapsed);
+  trace_end("rpc", handler.name, NULL, start);
 
 free_ret:
   // e->args (and possibly result) are allocated in an arena
@@ -395,6 +463,9 @@ static bool channel_write(Channel *channel, WBuffer *buffer)
 {
   bool success;
 
+  // Responses held back by serialize_response() go first, to keep the order.
+  flush_responses(channel);
+
   if (channel->rpc.closed) {
     wstream_release_wbuffer(buffer);
     return false;
@@ -461,7 +532,7 @@ static void broadcast_event(const char *name, Array args)
   Channel *channel;
 
   map_foreach_value(&channels, channel, {
-    if (channel->is_rpc) {
+    if (channel->is_rpc && !notification_dropped(channel)) {
       kv_push(chans, channel);
     }
   });
@@ -525,6 +596,9 @@ void rpc_free(Channel *channel)
 
   kv_destroy(channel->rpc.call_stack);
   api_free_dict(channel->rpc.info);
+  if (channel->rpc.responses.startptr) {
+    free_block(channel->rpc.responses.startptr);
+  }
 }
 
 /// Closes a channel after receiving fatal error, and logs a message.
@@ -542,6 +616,33 @@ static void chan_close_on_err(Channel *channel, char *msg, int loglevel)
   LOG(loglevel, "RPC: %s", msg);
 }
 
+/// Checks if a notification to `channel` should be dropped, because the peer
+/// has not read the data already queued for it.
+///
+/// Requests and responses are still queued until the stream write fails and
+/// the channel is closed, but notifications (which may be sent in bulk, e.g.
+/// by broadcasts) should not grow the memory of Nvim without bound.
+static bool notification_dropped(Channel *channel)
+{
+  if (channel->streamtype == kChannelStreamInternal) {
+    return false;
+  }
+
+  Stream *in = channel_instream(channel);
+  if (in->curmem <= RPC_NOTIFY_QUEUE_LIMIT) {
+    channel->rpc.dropping = false;
+    return false;
+  }
+
+  if (!channel->rpc.dropping) {
+    WLOG("RPC: ch %" PRIu64 ": write queue is full (%zu bytes), dropping notifications",
+         channel->id, in->curmem);
+    channel->rpc.dropping = true;
+  }
+  channel->rpc.dropped_notifications++;
+  return true;
+}
+
 static void serialize_request(Channel **chans, size_t nchans, uint32_t request_id,
                               const char *method, Array args)
 {
@@ -575,33 +676,54 @@ void serialize_response(Channel *channel, MsgpackRpcRequestHandler handler, Mess
       MAXSIZE_TEMP_ARRAY(args, 2);
       ADD_C(args, INTEGER_OBJ(err->type));
       ADD_C(args, CSTR_AS_OBJ(err->msg));
-      serialize_request(&channel, 1, 0, "nvim_error_event", args);
+      if (!notification_dropped(channel)) {
+        serialize_request(&channel, 1, 0, "nvim_error_event", args);
+      }
     }
     return;
   }
 
-  PackerBuffer packer;
-  packer_buffer_init_channels(&channel, 1, &packer);
+  // Responses to pipelined requests are held until the next queued request of
+  // the channel starts, see queued_request_event(). An internal
+  // channel parses every write as a single message, so it is not batched.
+  bool batch = channel->streamtype != kChannelStreamInternal;
+  PackerBuffer single;
+  PackerBuffer *packer = &single;
+  if (batch) {
+    if (channel->rpc.ui && remote_ui_incomplete_event(channel->rpc.ui)) {
+      remote_ui_flush_pending_data(channel->rpc.ui);
+    }
+    packer = &channel->rpc.responses;
+    if (packer->startptr == NULL) {
+      responses_init(channel);
+    }
+  } else {
+    packer_buffer_init_channels(&channel, 1, packer);
+  }
 
-  mpack_array(&packer.ptr, 4);
-  mpack_w(&packer.ptr, 1);
-  mpack_uint(&packer.ptr, response_id);
+  mpack_array(&packer->ptr, 4);
+  mpack_w(&packer->ptr, 1);
+  mpack_uint(&packer->ptr, response_id);
 
   if (ERROR_SET(err)) {
     // error represented by a [type, message] array
-    mpack_array(&packer.ptr, 2);
-    mpack_integer(&packer.ptr, err->type);
-    mpack_str(cstr_as_string(err->msg), &packer);
+    mpack_array(&packer->ptr, 2);
+    mpack_integer(&packer->ptr, err->type);
+    mpack_str(cstr_as_string(err->msg), packer);
     // Nil result
-    mpack_nil(&packer.ptr);
+    mpack_nil(&packer->ptr);
   } else {
     // Nil error
-    mpack_nil(&packer.ptr);
+    mpack_nil(&packer->ptr);
     // Return value
-    mpack_object(arg, &packer);
+    mpack_object(arg, packer);
   }
 
-  packer_buffer_finish_channels(&packer);
+  if (!batch) {
+    packer_buffer_finish_channels(packer);
+  } else if (channel->rpc.pending_requests == 0 || handler.fast) {
+    flush_responses(channel);
+  }
 
   log_response(SEND, channel->id, ERROR_SET(err) ? ERR : RES, response_id);
 }
@@ -610,7 +732,7 @@ static void packer_buffer_init_channels(Channel **chans, size_t nchans, PackerBu
 {
   for (size_t i = 0; i < nchans; i++) {
     Channel *chan = chans[i];
-    if (chan->rpc.ui && chan->rpc.ui->incomplete_event) {
+    if (chan->rpc.ui && remote_ui_incomplete_event(chan->rpc.ui)) {
       remote_ui_flush_pending_data(chan->rpc.ui);
     }
   }
@@ -642,6 +764,42 @@ static void channel_flush_callback(PackerBuffer *packer)
   packer_buffer_init_channels(packer->anydata, (size_t)packer->anyint, packer);
 }
 
+static void responses_init(Channel *channel)
+{
+  PackerBuffer *packer = &channel->rpc.responses;
+  packer->startptr = alloc_block();
+  packer->ptr = packer->startptr;
+  packer->endptr = packer->startptr + ARENA_BLOCK_SIZE;
+  packer->packer_flush = responses_flush_callback;
+  packer->anydata = channel;
+}
+
+/// Writes the responses collected by serialize_response(), if any.
+static void flush_responses(Channel *channel)
+{
+  PackerBuffer *packer = &channel->rpc.responses;
+  if (packer->startptr == NULL) {
+    return;
+  }
+
+  char *data = packer->startptr;
+  size_t len = (size_t)(packer->ptr - packer->startptr);
+  // Cleared before writing, channel_write() calls this again.
+  *packer = (PackerBuffer){ 0 };
+  if (len > 0) {
+    channel_write(channel, wstream_new_buffer(data, len, 1, free_block));
+  } else {
+    free_block(data);
+  }
+}
+
+static void responses_flush_callback(PackerBuffer *packer)
+{
+  Channel *channel = packer->anydata;
+  flush_responses(channel);
+  responses_init(channel);
+}
+
 void rpc_set_client_info(uint64_t id, Dict info)
 {
   Channel *chan = find_rpc_channel(id);
@@ -699,5 +857,10 @@ const char *get_client_info(Channel *chan, const char *key)
 void rpc_free_all_mem(void)
 {
   multiqueue_free(ch_before_blocking_events);
+  RpcMethodStats *stats;
+  map_foreach_value(&rpc_method_stats, stats, {
+    xfree(stats);
+  });
+  map_destroy(cstr_t, &rpc_method_stats);
 }
 #endif
@@ -5,8 +5,12 @@
 
 #include "nvim/api/private/dispatch.h"
 #include "nvim/map_defs.h"
+#include "nvim/msgpack_rpc/packer_defs.h"
 #include "nvim/ui_defs.h"
 
+/// Bytes queued for writing to a channel, above which notifications are dropped.
+#define RPC_NOTIFY_QUEUE_LIMIT (64 * 1024 * 1024)
+
 typedef struct Channel Channel;
 typedef struct Unpacker Unpacker;
 
@@ -44,4 +48,8 @@ typedef struct {
   kvec_t(ChannelCallFrame *) call_stack;
   Dict info;
   ClientType client_type;
+  size_t pending_requests;  ///< queued requests which will send a response
+  PackerBuffer responses;  ///< responses not yet written, see serialize_response()
+  bool dropping;  ///< notifications are being dropped, see notification_dropped()
+  size_t dropped_notifications;
 } RpcState;
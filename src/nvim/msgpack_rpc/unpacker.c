@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <uv.h>
 
 #include "klib/kvec.h"
@@ -240,6 +241,12 @@ bool unpacker_parse_header(Unpacker *p)
 
   if (p->type != kMessageTypeResponse) {
     NEXT(tok);
+    if (tok.type == MPACK_TOKEN_UINT) {
+      // method given by its "method_id" in the API metadata
+      p->handler = msgpack_rpc_get_handler_for_id(mpack_unpack_uint(tok), &p->unpack_error);
+      p->method_name_len = p->handler.name ? strlen(p->handler.name) : 0;
+      goto done;
+    }
     if ((tok.type != MPACK_TOKEN_STR && tok.type != MPACK_TOKEN_BIN)
         || tok.length > 100) {
       goto error;
@@ -259,6 +266,7 @@ bool unpacker_parse_header(Unpacker *p)
                                              tok.length, &p->unpack_error);
   }
 
+done:
   p->read_ptr = data;
   p->read_size = size;
   return true;
@@ -1367,7 +1367,10 @@ static void normal_redraw(NormalState *s)
   show_cursor_info_later(false);
 
   if (must_redraw) {
-    update_screen();
+    // After events the screen is updated at most once per 'redrawinterval'.
+    if (!state_redraw_postponed()) {
+      update_screen();
+    }
   } else {
     redraw_statuslines();
     if (redraw_cmdline || clear_cmdline || redraw_mode) {
@@ -2060,7 +2063,7 @@ static void display_showcmd(void)
 
   if (*p_sloc == 's') {
     if (showcmd_is_clear) {
-      curwin->w_redr_status = true;
+      status_redraw_win(curwin);
     } else {
       win_redr_status(curwin);
       setcursor();  // put cursor back where it belongs
@@ -2216,7 +2219,7 @@ void check_scrollbind(linenr_T vtopline_diff, int leftcol_diff)
 
       redraw_later(curwin, UPD_VALID);
       cursor_correct(curwin);
-      curwin->w_redr_status = true;
+      status_redraw_win(curwin);
     }
 
     // do the horizontal scroll
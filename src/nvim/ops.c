@@ -594,9 +594,8 @@ static void shift_block(oparg_T *oap, int amount)
     STRCPY(newp + fixedlen + fill, non_white);
     assert(newlen - oldlen == new_line_len - old_line_len);
   }
-  // replace the line
+  // replace the line, op_shift() calls changed_lines() for all lines
   ml_replace(curwin->w_cursor.lnum, newp, false);
-  changed_bytes(curwin->w_cursor.lnum, bd.textcol);
   extmark_splice_cols(curbuf, (int)curwin->w_cursor.lnum - 1, startcol,
                       oldlen, newlen,
                       kExtmarkUndo);
@@ -866,8 +865,18 @@ yankreg_T *copy_register(int name)
 
   yankreg_T *copy = xmalloc(sizeof(yankreg_T));
   *copy = *reg;
+  copy->y_text = NULL;
   if (copy->y_size == 0) {
     copy->y_array = NULL;
+  } else if (reg->y_text != NULL) {
+    // Copy the block with the text of all lines at once.
+    String *last = &reg->y_array[reg->y_size - 1];
+    copy->y_text = xmemdup(reg->y_text, (size_t)(last->data - reg->y_text) + last->size + 1);
+    copy->y_array = xmalloc(copy->y_size * sizeof(String));
+    for (size_t i = 0; i < copy->y_size; i++) {
+      copy->y_array[i] = cbuf_as_string(copy->y_text + (reg->y_array[i].data - reg->y_text),
+                                        reg->y_array[i].size);
+    }
   } else {
     copy->y_array = xcalloc(copy->y_size, sizeof(String));
     for (size_t i = 0; i < copy->y_size; i++) {
@@ -877,6 +886,19 @@ yankreg_T *copy_register(int name)
   return copy;
 }
 
+/// Give each line of register "reg" its own allocation, so that lines can be
+/// changed, added and freed separately.
+static void reg_unshare_text(yankreg_T *reg)
+{
+  if (reg->y_text == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < reg->y_size; i++) {
+    reg->y_array[i] = copy_string(reg->y_array[i], NULL);
+  }
+  XFREE_CLEAR(reg->y_text);
+}
+
 /// Check if the current yank register has kMTLineWise register type
 /// For valid, non-blackhole registers also provides pointer to the register
 /// structure prepared for pasting.
@@ -985,6 +1007,7 @@ static int stuff_yank(int regname, char *p)
   const size_t plen = strlen(p);
   yankreg_T *reg = get_yank_register(regname, YREG_YANK);
   if (is_append_register(regname) && reg->y_array != NULL) {
+    reg_unshare_text(reg);
     String *pp = &(reg->y_array[reg->y_size - 1]);
     const size_t tmplen = pp->size + plen;
     char *tmp = xmalloc(tmplen + 1);
@@ -1450,6 +1473,7 @@ static void shift_delete_registers(bool y_append)
     y_previous = &y_regs[1];
   }
   y_regs[1].y_array = NULL;  // set register "1 to empty
+  y_regs[1].y_text = NULL;
 }
 
 /// Handle a delete operation.
@@ -2063,9 +2087,7 @@ void op_tilde(oparg_T *oap)
   if (oap->motion_type == kMTBlockWise) {  // Visual block mode
     for (; pos.lnum <= oap->end.lnum; pos.lnum++) {
       block_prep(oap, &bd, pos.lnum, false);
-      pos.col = bd.textcol;
-      bool one_change = swapchars(oap->op_type, &pos, bd.textlen);
-      did_change |= one_change;
+      did_change |= swapchars_line(oap->op_type, pos.lnum, bd.textcol, bd.textlen);
     }
     if (did_change) {
       changed_lines(curbuf, oap->start.lnum, 0, oap->end.lnum + 1, 0, true);
@@ -2145,21 +2167,65 @@ static int swapchars(int op_type, pos_T *pos, int length)
   return did_change;
 }
 
-/// @param op_type
-///                 == OP_UPPER: make uppercase,
-///                 == OP_LOWER: make lowercase,
-///                 == OP_ROT13: do rot13 encoding,
-///                 else swap case of character at 'pos'
+/// Like swapchars(), but for the "length" bytes at "col" in line "lnum" only.
+/// Replaces the line once and adjusts extmarks for the whole range, instead of
+/// doing that for every character. Doesn't call changed_bytes(), the caller
+/// must call changed_lines().
 ///
-/// @return  true when something actually changed.
-bool swapchar(int op_type, pos_T *pos)
-  FUNC_ATTR_NONNULL_ARG(2)
+/// @return  true if some character was changed.
+static bool swapchars_line(int op_type, linenr_T lnum, colnr_T col, int length)
 {
-  const int c = gchar_pos(pos);
+  const char *const oldp = ml_get(lnum);
+  const colnr_T oldlen = ml_get_len(lnum);
+  if (col >= oldlen || length <= 0) {
+    return false;
+  }
+
+  StringBuilder sb = KV_INITIAL_VALUE;
+  kv_resize(sb, (size_t)oldlen + 1);
+  kv_concat_len(sb, oldp, (size_t)col);
+
+  bool did_change = false;
+  const char *p = oldp + col;
+  const char *const end = oldp + MIN(col + length, oldlen);
+  while (p < end) {
+    const int clen = utfc_ptr2len(p);
+    const int c = utf_ptr2char(p);
+    const int nc = swapchar_nc(op_type, c);
+    if (nc != c) {
+      // keep composing characters
+      const int blen = utf_ptr2len(p);
+      char buf[MB_MAXCHAR + 1];
+      kv_concat_len(sb, buf, (size_t)utf_char2bytes(nc, buf));
+      kv_concat_len(sb, p + blen, (size_t)(clen - blen));
+      did_change = true;
+    } else {
+      kv_concat_len(sb, p, (size_t)clen);
+    }
+    p += clen;
+  }
+
+  if (!did_change) {
+    kv_destroy(sb);
+    return false;
+  }
+
+  const colnr_T old_text_len = (colnr_T)(p - (oldp + col));
+  const colnr_T new_text_len = (colnr_T)kv_size(sb) - col;
+  kv_concat_len(sb, p, (size_t)(oldlen - (p - oldp)) + 1);  // including NUL
+  ml_replace(lnum, sb.items, false);
+  if (!curbuf_splice_pending) {
+    extmark_splice_cols(curbuf, (int)lnum - 1, col, old_text_len, new_text_len, kExtmarkUndo);
+  }
+  return true;
+}
 
+/// @return  the character "c" changed for "op_type", see swapchar().
+static int swapchar_nc(int op_type, int c)
+{
   // Only do rot13 encoding for ASCII characters.
   if (c >= 0x80 && op_type == OP_ROT13) {
-    return false;
+    return c;
   }
 
   int nc = c;
@@ -2176,6 +2242,21 @@ bool swapchar(int op_type, pos_T *pos)
       nc = mb_tolower(c);
     }
   }
+  return nc;
+}
+
+/// @param op_type
+///                 == OP_UPPER: make uppercase,
+///                 == OP_LOWER: make lowercase,
+///                 == OP_ROT13: do rot13 encoding,
+///                 else swap case of character at 'pos'
+///
+/// @return  true when something actually changed.
+bool swapchar(int op_type, pos_T *pos)
+  FUNC_ATTR_NONNULL_ARG(2)
+{
+  const int c = gchar_pos(pos);
+  const int nc = swapchar_nc(op_type, c);
   if (nc != c) {
     if (c >= 0x80 || nc >= 0x80) {
       pos_T sp = curwin->w_cursor;
@@ -2541,8 +2622,13 @@ void free_register(yankreg_T *reg)
     return;
   }
 
-  for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
-    API_CLEAR_STRING(reg->y_array[i]);
+  if (reg->y_text != NULL) {
+    // All lines are in one block.
+    XFREE_CLEAR(reg->y_text);
+  } else {
+    for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
+      API_CLEAR_STRING(reg->y_array[i]);
+    }
   }
   XFREE_CLEAR(reg->y_array);
 }
@@ -2607,9 +2693,21 @@ static void op_yank_reg(oparg_T *oap, bool message, yankreg_T *reg, bool append)
   reg->y_type = yank_type;  // set the yank register type
   reg->y_width = 0;
   reg->y_array = xcalloc(yanklines, sizeof(String));
+  reg->y_text = NULL;
   reg->additional_data = NULL;
   reg->timestamp = os_time();
 
+  char *text = NULL;
+  if (yank_type == kMTLineWise && reg == curr) {
+    // Store the text of all lines in one block instead of allocating each
+    // line separately.
+    size_t textlen = 0;
+    for (linenr_T l = oap->start.lnum; l <= yankendlnum; l++) {
+      textlen += (size_t)ml_get_len(l) + 1;
+    }
+    text = reg->y_text = xmalloc(textlen);
+  }
+
   size_t y_idx = 0;  // index in y_array[]
   linenr_T lnum = oap->start.lnum;  // current line number
 
@@ -2630,7 +2728,15 @@ static void op_yank_reg(oparg_T *oap, bool message, yankreg_T *reg, bool append)
       break;
 
     case kMTLineWise:
-      reg->y_array[y_idx] = cbuf_to_string(ml_get(lnum), (size_t)ml_get_len(lnum));
+      if (text != NULL) {
+        char *line = ml_get(lnum);
+        size_t len = (size_t)ml_get_len(lnum);
+        memcpy(text, line, len + 1);
+        reg->y_array[y_idx] = cbuf_as_string(text, len);
+        text += len + 1;
+      } else {
+        reg->y_array[y_idx] = cbuf_to_string(ml_get(lnum), (size_t)ml_get_len(lnum));
+      }
       break;
 
     case kMTCharWise:
@@ -2650,6 +2756,7 @@ static void op_yank_reg(oparg_T *oap, bool message, yankreg_T *reg, bool append)
   }
 
   if (curr != reg) {      // append the new block to the old block
+    reg_unshare_text(curr);
     size_t j;
     String *new_ptr = xmalloc(sizeof(String) * (curr->y_size + reg->y_size));
     for (j = 0; j < curr->y_size; j++) {
@@ -3424,9 +3531,19 @@ void do_put(int regname, yankreg_T *reg, int dir, int count, int flags)
       int indent_diff = 0;        // init for gcc
       bool first_indent = true;
       int lendiff = 0;
+      char **put_lines = NULL;
+      colnr_T *put_lens = NULL;
 
       if (flags & PUT_FIXINDENT) {
         orig_indent = get_indent();
+      } else {
+        // Without fixing the indent the lines can be appended all at once.
+        put_lines = xmalloc(y_size * sizeof(*put_lines));
+        put_lens = xmalloc(y_size * sizeof(*put_lens));
+        for (size_t i = 0; i < y_size; i++) {
+          put_lines[i] = y_array[i].data;
+          put_lens[i] = (colnr_T)y_array[i].size + 1;
+        }
       }
 
       // Insert at least one line.  When y_type is kMTCharWise, break the first
@@ -3461,6 +3578,20 @@ void do_put(int regname, yankreg_T *reg, int dir, int count, int flags)
           i = 1;
         }
 
+        if (put_lines != NULL) {
+          // the last line of a charwise register was inserted above
+          int append_count = (int)(y_size - i) - (y_type == kMTCharWise);
+          if (append_count > 0
+              && ml_append_many(lnum, put_lines + i, put_lens + i, append_count,
+                                false) == FAIL) {
+            goto error;
+          }
+          new_lnum += append_count;
+          lnum += (linenr_T)(y_size - i);
+          nr_lines += (linenr_T)(y_size - i);
+          i = y_size;
+        }
+
         for (; i < y_size; i++) {
           if ((y_type != kMTCharWise || i < y_size - 1)) {
             if (ml_append(lnum, y_array[i].data, 0, false) == FAIL) {
@@ -3523,6 +3654,9 @@ void do_put(int regname, yankreg_T *reg, int dir, int count, int flags)
       }
 
 error:
+      xfree(put_lines);
+      xfree(put_lens);
+
       // Adjust marks.
       if (y_type == kMTLineWise) {
         curbuf->b_op_start.col = 0;
@@ -5115,6 +5249,7 @@ static void str_to_reg(yankreg_T *y_ptr, MotionType yank_type, const char *str,
   if (y_ptr->y_array == NULL) {  // NULL means empty register
     y_ptr->y_size = 0;
   }
+  reg_unshare_text(y_ptr);
 
   if (yank_type == kMTUnknown) {
     yank_type = ((str_list
@@ -105,6 +105,7 @@ enum GRegFlags {
 typedef struct {
   String *y_array;          ///< Pointer to an array of Strings.
   size_t y_size;            ///< Number of lines in y_array.
+  char *y_text;             ///< When not NULL, block holding the text of all lines.
   MotionType y_type;        ///< Register type
   colnr_T y_width;          ///< Register width (only valid for y_type == kBlockWise).
   Timestamp timestamp;      ///< Time when register was last modified.
@@ -390,6 +390,7 @@ void set_init_1(bool clean_arg)
   curbuf->b_p_initialized = true;
   curbuf->b_p_ar = -1;          // no local 'autoread' value
   curbuf->b_p_ul = NO_LOCAL_UNDOLEVEL;
+  curbuf->b_p_um = -1;          // no local 'undomemory' value
   check_buf_options(curbuf);
   check_win_options(curwin);
   check_options();
@@ -2820,6 +2821,7 @@ static const char *validate_num_option(OptIndex opt_idx, OptInt *newval, char *e
   case kOptShiftwidth:
   case kOptTextwidth:
   case kOptWritedelay:
+  case kOptRedrawinterval:
   case kOptTimeoutlen:
     if (value < 0) {
       return e_positive;
@@ -2876,7 +2878,7 @@ static const char *validate_num_option(OptIndex opt_idx, OptInt *newval, char *e
     }
     break;
   case kOptRegexpengine:
-    if (value < 0 || value > 2) {
+    if (value < 0 || value > 3) {
       return e_invarg;
     }
     break;
@@ -2890,6 +2892,11 @@ static const char *validate_num_option(OptIndex opt_idx, OptInt *newval, char *e
       return e_positive;
     }
     break;
+  case kOptUndomemory:
+    if (value < -1) {
+      return e_invarg;
+    }
+    break;
   case kOptCmdwinheight:
     if (value < 1) {
       return e_positive;
@@ -3375,6 +3382,7 @@ static OptVal get_option_unset_value(OptIndex opt_idx)
       return BOOLEAN_OPTVAL(kNone);
     case kOptScrolloff:
     case kOptSidescrolloff:
+    case kOptUndomemory:
       return NUMBER_OPTVAL(-1);
     case kOptUndolevels:
       return NUMBER_OPTVAL(NO_LOCAL_UNDOLEVEL);
@@ -4460,6 +4468,8 @@ void *get_varp_scope_from(vimoption_T *p, int opt_flags, buf_T *buf, win_T *win)
       return &(win->w_p_wbr);
     case kOptUndolevels:
       return &(buf->b_p_ul);
+    case kOptUndomemory:
+      return &(buf->b_p_um);
     case kOptLispwords:
       return &(buf->b_p_lw);
     case kOptBackupcopy:
@@ -4559,6 +4569,8 @@ void *get_varp_from(vimoption_T *p, buf_T *buf, win_T *win)
     return *win->w_p_wbr != NUL ? &(win->w_p_wbr) : p->var;
   case kOptUndolevels:
     return buf->b_p_ul != NO_LOCAL_UNDOLEVEL ? &(buf->b_p_ul) : p->var;
+  case kOptUndomemory:
+    return buf->b_p_um >= 0 ? &(buf->b_p_um) : p->var;
   case kOptLispwords:
     return *buf->b_p_lw != NUL ? &(buf->b_p_lw) : p->var;
   case kOptMakeencoding:
@@ -5208,6 +5220,7 @@ void buf_copy_options(buf_T *buf, int flags)
       // are not copied, start using the global value
       buf->b_p_ar = -1;
       buf->b_p_ul = NO_LOCAL_UNDOLEVEL;
+      buf->b_p_um = -1;
       buf->b_p_bkc = empty_string_option;
       buf->b_bkc_flags = 0;
       buf->b_p_gefm = empty_string_option;
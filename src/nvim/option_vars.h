@@ -445,6 +445,7 @@ EXTERN char *p_qe;              ///< 'quoteescape'
 EXTERN int p_ro;                ///< 'readonly'
 EXTERN char *p_rdb;             ///< 'redrawdebug'
 EXTERN unsigned rdb_flags;
+EXTERN OptInt p_rdi;            ///< 'redrawinterval'
 EXTERN OptInt p_rdt;            ///< 'redrawtime'
 EXTERN OptInt p_re;             ///< 'regexpengine'
 EXTERN OptInt p_report;         ///< 'report'
@@ -543,6 +544,7 @@ EXTERN OptInt p_ttm;            ///< 'ttimeoutlen'
 EXTERN char *p_udir;            ///< 'undodir'
 EXTERN int p_udf;               ///< 'undofile'
 EXTERN OptInt p_ul;             ///< 'undolevels'
+EXTERN OptInt p_um;             ///< 'undomemory'
 EXTERN OptInt p_ur;             ///< 'undoreload'
 EXTERN OptInt p_uc;             ///< 'updatecount'
 EXTERN OptInt p_ut;             ///< 'updatetime'
@@ -6796,6 +6796,22 @@ local options = {
       varname = 'p_rdb',
       flags_varname = 'rdb_flags',
     },
+    {
+      abbreviation = 'rdi',
+      defaults = 0,
+      desc = [=[
+        Minimum time in milliseconds between screen updates for events, such
+        as output of jobs and terminals, timers and RPC requests.  When events
+        arrive faster, the changes they make are drawn together once this time
+        has passed.  The screen is still updated right away after typed keys.
+        Set to 0 to update the screen after every event.
+      ]=],
+      full_name = 'redrawinterval',
+      scope = { 'global' },
+      short_desc = N_('minimum time between screen updates for events'),
+      type = 'number',
+      varname = 'p_rdi',
+    },
     {
       abbreviation = 'rdt',
       defaults = 2000,
@@ -6825,6 +6841,8 @@ local options = {
         	0	automatic selection
         	1	old engine
         	2	NFA engine
+        	3	NFA engine, with a lazily built DFA to quickly skip
+        		lines that cannot match
         Note that when using the NFA engine and the pattern contains something
         that is not supported the pattern will not match.  This is only useful
         for debugging the regexp engine.
@@ -8878,7 +8896,8 @@ local options = {
         completely from the statusline when none of the flags are set. >vim
         	set statusline=...%(\ [%M%R%H]%)...
         <	Beware that an expression is evaluated each and every time the status
-        line is displayed.
+        line is updated.  When the status line is only drawn again because it
+        was overwritten, the text of the previous evaluation is used.
         			*stl-%{* *g:actual_curbuf* *g:actual_curwin*
         While evaluating %{} the current buffer and current window will be set
         temporarily to that of the window (and buffer) whose statusline is
@@ -9812,6 +9831,28 @@ local options = {
       type = 'number',
       varname = 'p_ul',
     },
+    {
+      abbreviation = 'um',
+      defaults = 0,
+      desc = [=[
+        Maximum amount of memory in Kbyte to use for the undo information of
+        a buffer.  When it is exceeded the oldest changes are forgotten, like
+        when there are more than 'undolevels' changes.  The last change is
+        always kept, even when it uses more memory.  The limit is for each
+        buffer, the total for all buffers is not limited.
+        Set to 0 for no limit.  The memory used is reported by |undotree()|.
+        After using the local value, go back the global value with one of
+        these two: >vim
+        	setlocal undomemory<
+        	setlocal undomemory=-1
+        <
+      ]=],
+      full_name = 'undomemory',
+      scope = { 'global', 'buf' },
+      short_desc = N_('maximum memory in Kbyte used for undo'),
+      type = 'number',
+      varname = 'p_um',
+    },
     {
       abbreviation = 'ur',
       defaults = 10000,
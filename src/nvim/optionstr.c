@@ -40,6 +40,7 @@
 #include "nvim/option_vars.h"
 #include "nvim/optionstr.h"
 #include "nvim/os/os.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
@@ -708,7 +709,7 @@ const char *did_set_buftype(optset_T *args)
     RESET_FMARK(&buf->b_prompt_start, next_prompt, 0, ((fmarkv_T)INIT_FMARKV));
   }
   if (win->w_status_height || global_stl_height()) {
-    win->w_redr_status = true;
+    status_redraw_win(win);
     redraw_later(win, UPD_VALID);
   }
   buf->b_help = (buf->b_p_bt[0] == 'h');
@@ -1850,6 +1851,9 @@ const char *did_set_spelloptions(optset_T *args)
       && opt_strings_flags(val, opt_spo_values, &win->w_s->b_p_spo_flags, true) != OK) {
     return e_invarg;
   }
+  if (!(opt_flags & OPT_GLOBAL)) {
+    spell_clean_lines_clear(win->w_s);
+  }
   return NULL;
 }
 
@@ -2533,6 +2537,7 @@ char *get_listchars_name(expand_T *xp FUNC_ATTR_UNUSED, int idx)
 /// @return  an untranslated error message if any of them is invalid, NULL otherwise.
 const char *check_chars_options(void)
 {
+  vcol_cache_invalidate_all();
   if (set_chars_option(curwin, p_lcs, kListchars, false, NULL, 0) != NULL) {
     return e_conflicts_with_value_of_listchars;
   }
@@ -17,6 +17,7 @@
 #endif
 
 #include "auto/config.h"
+#include "klib/kvec.h"
 #include "nvim/os/fs.h"
 #include "nvim/os/os_defs.h"
 
@@ -33,17 +34,23 @@
 # include <sys/xattr.h>
 #endif
 
+#ifndef MSWIN
+# include <sys/mman.h>
+#endif
+
 #include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/errors.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
+#include "nvim/map_defs.h"
 #include "nvim/macros_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/os.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
@@ -60,10 +67,27 @@
 # include "nvim/strings.h"
 #endif
 
+/// Identity and modification time of a $PATH directory, see exe_cache_validate().
+typedef struct {
+  FileID id;
+  uv_timespec_t mtime;
+} DirStamp;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "os/fs.c.generated.h"
 #endif
 
+/// Time during which the results of is_executable_in_path() are used without
+/// checking the $PATH directories.
+#define EXE_CACHE_TTL_NS (100 * 1000 * 1000)
+
+/// Results of is_executable_in_path(): the full path of a name, or NULL if it
+/// was not found. Valid as long as $PATH and its directories don't change.
+static PMap(cstr_t) exe_cache = MAP_INIT;
+static char *exe_cache_path = NULL;  ///< Search path (key) "exe_cache" belongs to.
+static kvec_t(DirStamp) exe_cache_dirs = KV_INITIAL_VALUE;
+static uint64_t exe_cache_checked = 0;  ///< When "exe_cache_dirs" were checked.
+
 #ifdef HAVE_XATTR
 static const char e_xattr_erange[]
   = N_("E1506: Buffer too small to copy xattr value or key");
@@ -96,6 +120,8 @@ int os_chdir(const char *path)
   }
   int err = uv_chdir(path);
   if (err == 0) {
+    // Relative $PATH entries now refer to other directories.
+    exe_cache_invalidate();
     ui_call_chdir(cstr_as_string(path));
   }
   return err;
@@ -341,8 +367,90 @@ static bool is_executable_ext(const char *name, char **abspath)
 }
 #endif
 
+static void exe_cache_clear(void)
+{
+  const char *key;
+  char *value;
+  map_foreach(&exe_cache, key, value, {
+    xfree((char *)key);
+    xfree(value);
+  });
+  map_clear(cstr_t, &exe_cache);
+}
+
+/// Clears "exe_cache" and makes the next exe_cache_validate() check the $PATH
+/// directories again.
+static void exe_cache_invalidate(void)
+{
+  exe_cache_clear();
+  kv_size(exe_cache_dirs) = 0;
+  exe_cache_checked = 0;
+}
+
+/// Clears "exe_cache" if "key" is not the one it was filled with, or if a
+/// directory in "path" was modified (an executable may have been added or
+/// removed). The directories are checked at most every EXE_CACHE_TTL_NS.
+///
+/// @param path  Search path.
+/// @param key   "path" and anything else that affects the result.
+static void exe_cache_validate(const char *path, const char *key)
+  FUNC_ATTR_NONNULL_ALL
+{
+  uint64_t now = os_hrtime();
+  bool same_path = exe_cache_path != NULL && strequal(key, exe_cache_path);
+  if (same_path && now - exe_cache_checked < EXE_CACHE_TTL_NS) {
+    return;
+  }
+
+  kvec_t(DirStamp) dirs = KV_INITIAL_VALUE;
+  for (const char *p = path;; p++) {
+    const char *e = xstrchrnul(p, ENV_SEPCHAR);
+    char *dir = xmemdupz(p, (size_t)(e - p));
+    FileInfo file_info;
+    DirStamp stamp = { .id = FILE_ID_EMPTY };
+    if (os_fileinfo(*dir == NUL ? "." : dir, &file_info)) {
+      os_fileinfo_id(&file_info, &stamp.id);
+      stamp.mtime = file_info.stat.st_mtim;
+    }
+    kv_push(dirs, stamp);
+    xfree(dir);
+    if (*e == NUL) {
+      break;
+    }
+    p = e;
+  }
+
+  bool changed = !same_path || kv_size(dirs) != kv_size(exe_cache_dirs)
+                 || memcmp(dirs.items, exe_cache_dirs.items,
+                           kv_size(dirs) * sizeof(DirStamp)) != 0;
+  if (changed) {
+    exe_cache_clear();
+    if (!same_path) {
+      xfree(exe_cache_path);
+      exe_cache_path = xstrdup(key);
+    }
+  }
+  kv_destroy(exe_cache_dirs);
+  exe_cache_dirs = dirs;
+  exe_cache_checked = now;
+}
+
+#if defined(EXITFREE)
+void free_exe_cache(void)
+{
+  exe_cache_clear();
+  map_destroy(cstr_t, &exe_cache);
+  kv_destroy(exe_cache_dirs);
+  XFREE_CLEAR(exe_cache_path);
+}
+#endif
+
 /// Checks if a file is in `$PATH` and is executable.
 ///
+/// Results are cached, see exe_cache_validate(). A cached executable is still
+/// checked to be one, which is a single stat() instead of one for every
+/// directory in $PATH (times the $PATHEXT extensions on Windows).
+///
 /// @param[in]  name  Filename to check.
 /// @param[out] abspath  Returns resolved executable path, if not NULL.
 ///
@@ -370,15 +478,63 @@ static bool is_executable_in_path(const char *name, char **abspath)
   char *path = xstrdup(path_env);
 #endif
 
+#ifdef MSWIN
+  // $PATHEXT and the shell decide which file names are tried.
+  const char *pathext = os_getenv_noalloc("PATHEXT");
+  pathext = pathext ? pathext : "";
+  size_t key_size = strlen(path) + strlen(p_sh) + strlen(pathext) + 3;
+  char *cache_key = xmalloc(key_size);
+  snprintf(cache_key, key_size, "%s\n%s\n%s", path, p_sh, pathext);
+  exe_cache_validate(path, cache_key);
+  xfree(cache_key);
+#else
+  exe_cache_validate(path, path);
+#endif
+
+  char *found = NULL;
+  bool new_item = false;
+  const char **key = NULL;
+  char **cached = (char **)pmap_put_ref(cstr_t)(&exe_cache, name, &key, &new_item);
+  if (new_item) {
+    *key = xstrdup(name);
+  }
+  if (*cached != NULL && !is_executable(*cached, NULL)) {
+    XFREE_CLEAR(*cached);  // Not executable anymore, search again.
+    new_item = true;
+  }
+  if (new_item) {
+    if (search_path_for_exe(path, name, &found)) {
+      *cached = xstrdup(found);
+    }
+  } else if (*cached != NULL) {
+    found = xstrdup(*cached);
+  }
+  bool rv = found != NULL;
+
+  if (abspath != NULL) {
+    *abspath = found;
+  } else {
+    xfree(found);
+  }
+  xfree(path);
+  xfree(path_env);
+  return rv;
+}
+
+/// Walks through all entries in "path" to check if "name" exists there and is
+/// an executable file.
+///
+/// @param[out,allocated] abspath  Returns full exe path.
+static bool search_path_for_exe(const char *path, const char *name, char **abspath)
+  FUNC_ATTR_NONNULL_ALL
+{
   const size_t bufsize = strlen(name) + strlen(path) + 2;
   char *buf = xmalloc(bufsize);
 
-  // Walk through all entries in $PATH to check if "name" exists there and
-  // is an executable file.
-  char *p = path;
+  const char *p = path;
   bool rv = false;
   while (true) {
-    char *e = xstrchrnul(p, ENV_SEPCHAR);
+    const char *e = xstrchrnul(p, ENV_SEPCHAR);
 
     // Combine the $PATH segment with `name`.
     xmemcpyz(buf, p, (size_t)(e - p));
@@ -390,21 +546,18 @@ static bool is_executable_in_path(const char *name, char **abspath)
     if (is_executable(buf, abspath)) {
 #endif
       rv = true;
-      goto end;
+      break;
     }
 
     if (*e != ENV_SEPCHAR) {
       // End of $PATH without finding any executable called name.
-      goto end;
+      break;
     }
 
     p = e + 1;
   }
 
-end:
   xfree(buf);
-  xfree(path);
-  xfree(path_env);
   return rv;
 }
 
@@ -428,6 +581,47 @@ int os_open(const char *path, int flags, int mode)
   return r;
 }
 
+/// Maps file "path" read-only into memory. The pages are shared with other
+/// processes that map the same file, and are only read when used.
+///
+/// The file must not be changed in place while it is mapped, replace it by
+/// renaming another file instead.
+///
+/// @param path Filename
+/// @param[out] size Size of the file
+/// @return start of the mapping, or NULL on failure, for an empty file or
+///         when mapping files is not supported.
+const char *os_mmap_file(const char *path, size_t *size)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+#ifdef MSWIN
+  return NULL;
+#else
+  int fd = os_open(path, O_RDONLY, 0);
+  if (fd < 0) {
+    return NULL;
+  }
+  FileInfo info;
+  void *p = MAP_FAILED;
+  if (os_fileinfo_fd(fd, &info) && os_fileinfo_size(&info) > 0
+      && os_fileinfo_size(&info) <= SIZE_MAX) {
+    *size = (size_t)os_fileinfo_size(&info);
+    p = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  os_close(fd);
+  return p == MAP_FAILED ? NULL : p;
+#endif
+}
+
+/// Unmaps a file mapped with os_mmap_file().
+void os_munmap_file(const char *p, size_t size)
+  FUNC_ATTR_NONNULL_ALL
+{
+#ifndef MSWIN
+  munmap((void *)p, size);
+#endif
+}
+
 /// Compatibility wrapper conforming to fopen(3).
 ///
 /// Windows: works with UTF-16 filepaths by delegating to libuv (os_open).
@@ -716,6 +910,23 @@ ptrdiff_t os_write(const int fd, const char *const buf, const size_t size, const
   return (ptrdiff_t)written_bytes;
 }
 
+/// Write to a file at a given offset, from several buffers (pwritev()).
+///
+/// @param[in]  fd  File descriptor to write to.
+/// @param[in]  bufs  Buffers with the data to write.
+/// @param[in]  nbufs  Number of buffers.
+/// @param[in]  offset  Byte offset in the file to write at.
+///
+/// @return Number of bytes written, which may be less than requested, or
+///         libuv error code (< 0).
+ptrdiff_t os_pwritev(int fd, const uv_buf_t *bufs, unsigned nbufs, int64_t offset)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  ptrdiff_t r;
+  RUN_UV_FS_FUNC(r, uv_fs_write, fd, bufs, nbufs, offset, NULL);
+  return r;
+}
+
 /// Copies a file from `path` to `new_path`.
 ///
 /// @see http://docs.libuv.org/en/v1.x/fs.html#c.uv_fs_copyfile
@@ -1152,6 +1363,16 @@ const char *os_scandir_next(Directory *dir)
   return err != UV_EOF ? dir->ent.name : NULL;
 }
 
+/// Gets the type of the entry last returned by os_scandir_next(), as far as
+/// the file system reports it without a stat() call.
+/// @param dir  The Directory object.
+/// @returns UV_DIRENT_UNKNOWN if the type is not known.
+uv_dirent_type_t os_scandir_type(const Directory *dir)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  return dir->ent.type;
+}
+
 /// Frees memory associated with `os_scandir()`.
 /// @param dir  The directory.
 void os_closedir(Directory *dir)
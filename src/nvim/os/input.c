@@ -43,6 +43,8 @@ static bool input_eof = false;
 static bool blocking = false;
 static int cursorhold_time = 0;  ///< time waiting for CursorHold event
 static int cursorhold_tb_change_cnt = 0;  ///< tb_change_cnt when waiting started
+static uint64_t input_arrival = 0;  ///< os_hrtime() when unprocessed input arrived, or zero
+static bool input_arrival_redraw = false;  ///< the screen update for "input_arrival" started
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "os/input.c.generated.h"
@@ -262,6 +264,10 @@ static size_t input_space(void)
 
 void input_enqueue_raw(const char *data, size_t size)
 {
+  if (input_arrival == 0 && size > 0) {
+    input_arrival = os_hrtime();
+  }
+
   if (input_read_pos > input_buffer) {
     size_t available = input_available();
     memmove(input_buffer, input_read_pos, available);
@@ -274,6 +280,34 @@ void input_enqueue_raw(const char *data, size_t size)
   input_write_pos += to_write;
 }
 
+/// Ends the "input processing" phase of the input latency, because the
+/// screen update showing its result starts.
+void input_latency_redraw(void)
+{
+  if (input_arrival != 0 && !input_arrival_redraw) {
+    g_stats.input_ns += (int64_t)(os_hrtime() - input_arrival);
+    input_arrival_redraw = true;
+  }
+}
+
+/// Records the input latency, from the arrival of input until the screen
+/// has been updated and flushed after processing all of it.
+void input_latency_flushed(void)
+{
+  if (input_arrival == 0) {
+    return;
+  }
+  const uint64_t now = os_hrtime();
+  if (!input_arrival_redraw) {
+    g_stats.input_ns += (int64_t)(now - input_arrival);
+  }
+  g_stats.input_latency++;
+  g_stats.input_latency_ns += (int64_t)(now - input_arrival);
+  stats_hist_add(g_stats.input_latency_hist, now - input_arrival);
+  input_arrival = 0;
+  input_arrival_redraw = false;
+}
+
 size_t input_enqueue(uint64_t chan_id, String keys)
 {
   current_ui = chan_id;
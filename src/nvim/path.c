@@ -590,7 +590,8 @@ static size_t path_expand(garray_T *gap, const char *path, int flags)
   return do_path_expand(gap, path, 0, flags, false);
 }
 
-static const char *scandir_next_with_dots(Directory *dir)
+/// @param[out] type  set to the type of the entry, see os_scandir_type().
+static const char *scandir_next_with_dots(Directory *dir, uv_dirent_type_t *type)
 {
   static int count = 0;
   if (dir == NULL) {  // initialize
@@ -600,9 +601,12 @@ static const char *scandir_next_with_dots(Directory *dir)
 
   count += 1;
   if (count == 1 || count == 2) {
+    *type = UV_DIRENT_DIR;
     return (count == 1) ? "." : "..";
   }
-  return os_scandir_next(dir);
+  const char *name = os_scandir_next(dir);
+  *type = os_scandir_type(dir);
+  return name;
 }
 
 /// Implementation of path_expand().
@@ -726,11 +730,19 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
 
   Directory dir;
   char *dirpath = (*buf == NUL ? "." : buf);
-  if (os_file_is_readable(dirpath) && os_scandir(&dir, dirpath)) {
+  // Don't check whether the directory is readable first: scanning it fails
+  // just the same, and on a network mount every syscall counts.
+  if (os_scandir(&dir, dirpath)) {
     // Find all matching entries.
     const char *name;
-    scandir_next_with_dots(NULL);  // initialize
-    while (!got_int && (name = scandir_next_with_dots(&dir)) != NULL) {
+    uv_dirent_type_t type;
+    scandir_next_with_dots(NULL, NULL);  // initialize
+    while (!got_int && (name = scandir_next_with_dots(&dir, &type)) != NULL) {
+      // A regular file cannot contain the rest of the path (or further matches
+      // for "**"), no need to look for it.
+      if (type == UV_DIRENT_FILE && *path_end != NUL) {
+        continue;
+      }
       len = (size_t)(s - buf);
       if ((name[0] != '.'
            || starts_with_dot
@@ -745,7 +757,7 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
           continue;
         }
 
-        if (starstar && stardepth < 100) {
+        if (starstar && stardepth < 100 && type != UV_DIRENT_FILE) {
           // For "**" in the pattern first go deeper in the tree to
           // find matches.
           vim_snprintf(buf + len, buflen - len, "/**%s", path_end);  // NOLINT
@@ -767,10 +779,12 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
           if (*path_end != NUL) {
             backslash_halve(buf + len + 1);
           }
-          // add existing file or symbolic link
-          if ((flags & EW_ALLLINKS)
-              ? os_fileinfo_link(buf, &file_info)
-              : os_path_exists(buf)) {
+          // add existing file or symbolic link; a file or directory that was
+          // just found in the directory exists, only links need checking
+          if ((*path_end == NUL && (type == UV_DIRENT_FILE || type == UV_DIRENT_DIR))
+              || ((flags & EW_ALLLINKS)
+                  ? os_fileinfo_link(buf, &file_info)
+                  : os_path_exists(buf))) {
             addfile(gap, buf, flags);
           }
         }
@@ -13,15 +13,18 @@
 #include "nvim/decoration.h"
 #include "nvim/decoration_defs.h"
 #include "nvim/diff.h"
+#include "nvim/eval/typval_defs.h"
 #include "nvim/fold.h"
 #include "nvim/globals.h"
 #include "nvim/indent.h"
+#include "nvim/klib/kvec.h"
 #include "nvim/macros_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/marktree.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
 #include "nvim/memline.h"
+#include "nvim/memory.h"
 #include "nvim/move.h"
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
@@ -35,6 +38,18 @@
 # include "plines.c.generated.h"
 #endif
 
+enum {
+  kVcolCacheMinLen = 4096,     ///< shorter lines are not cached
+  kVcolCheckpointStep = 512,  ///< bytes between checkpoints in a cached line
+};
+
+/// Incremented when the size of characters may change for all lines.
+static uint32_t vcol_cache_epoch = 0;
+
+/// Incremented when inline virtual text is added or removed, or the windows
+/// where a namespace is shown change.
+static uint32_t inline_virt_cache_epoch = 0;
+
 /// Functions calculating horizontal size of text, when displayed in a window.
 
 /// Return the number of cells the first char in "p" will take on the screen,
@@ -78,7 +93,14 @@ int linetabsize_col(int startvcol, char *s)
 /// Doesn't count the size of 'listchars' "eol".
 int linetabsize(win_T *wp, linenr_T lnum)
 {
-  return win_linetabsize(wp, lnum, ml_get_buf(wp->w_buffer, lnum), MAXCOL);
+  char *line = ml_get_buf(wp->w_buffer, lnum);
+  CharsizeArg csarg;
+  CSType const cstype = init_charsize_arg(&csarg, wp, lnum, line);
+  if (cstype == kCharsizeFast) {
+    return linesize_fast_cached(&csarg, lnum);
+  } else {
+    return linesize_regular(&csarg, 0, MAXCOL);
+  }
 }
 
 /// Like linetabsize(), but counts the size of 'listchars' "eol".
@@ -105,10 +127,13 @@ CSType init_charsize_arg(CharsizeArg *csarg, win_T *wp, linenr_T lnum, char *lin
   csarg->indent_width = INT_MIN;
   csarg->use_tabstop = !wp->w_p_list || wp->w_p_lcs_chars.tab1;
 
-  if (lnum > 0) {
-    if (marktree_itr_get_filter(wp->w_buffer->b_marktree, lnum - 1, 0, lnum, 0,
-                                inline_filter, csarg->iter)) {
+  if (lnum > 0 && buf_meta_total(wp->w_buffer, kMTMetaInline) > 0) {
+    int idx;
+    InlineVirtCache *ivc = inline_virt_cache_get(wp, lnum, &idx);
+    if (kv_size(ivc->items) > 0) {
       csarg->virt_row = lnum - 1;
+      csarg->virt_cache = idx;
+      csarg->virt_idx = 0;
     }
   }
 
@@ -159,37 +184,28 @@ CharSize charsize_regular(CharsizeArg *csarg, char *const cur, colnr_T const vco
   }
 
   if (csarg->virt_row >= 0) {
-    int tab_size = size;
+    InlineVirtCache *ivc = &wp->w_inline_virt_cache[csarg->virt_cache];
+    if (ivc->lnum != csarg->virt_row + 1 || ivc->buf != buf->handle) {
+      // The entry was reused for another line, get this line again.
+      ivc = inline_virt_cache_get(wp, csarg->virt_row + 1, &csarg->virt_cache);
+    }
     int col = (int)(cur - line);
-    while (true) {
-      MTKey mark = marktree_itr_current(csarg->iter);
-      if (mark.pos.row != csarg->virt_row || mark.pos.col > col) {
-        break;
-      } else if (mark.pos.col == col) {
-        if (!mt_invalid(mark) && ns_in_win(mark.ns, wp)) {
-          DecorInline decor = mt_decor(mark);
-          DecorVirtText *vt = decor.ext ? decor.data.ext.vt : NULL;
-          while (vt) {
-            if (!(vt->flags & kVTIsLines) && vt->pos == kVPosInline) {
-              if (mt_right(mark)) {
-                csarg->cur_text_width_right += vt->width;
-              } else {
-                csarg->cur_text_width_left += vt->width;
-              }
-              size += vt->width;
-              if (use_tabstop) {
-                // tab size changes because of the inserted text
-                size -= tab_size;
-                tab_size = tabstop_padding(vcol + size, buf->b_p_ts, buf->b_p_vts_array);
-                size += tab_size;
-              }
-            }
-            vt = vt->next;
-          }
+    while (csarg->virt_idx < kv_size(ivc->items)
+           && kv_A(ivc->items, csarg->virt_idx).col <= col) {
+      InlineVirtItem item = kv_A(ivc->items, csarg->virt_idx++);
+      if (item.col == col) {
+        csarg->cur_text_width_left = item.width_left;
+        csarg->cur_text_width_right = item.width_right;
+        if (use_tabstop) {
+          // tab size changes because of the inserted text
+          size = item.width_left + item.width_right
+                 + tabstop_padding(vcol + item.width_left + item.width_right,
+                                   buf->b_p_ts, buf->b_p_vts_array);
+        } else {
+          size += item.width_left + item.width_right;
         }
+        break;
       }
-      marktree_itr_next_filter(wp->w_buffer->b_marktree, csarg->iter, csarg->virt_row + 1, 0,
-                               inline_filter);
     }
   }
 
@@ -492,6 +508,204 @@ int linesize_fast(CharsizeArg const *const csarg, int vcol_arg, colnr_T const le
   return vcol_arg;
 }
 
+/// Like linesize_fast() for the whole of line "lnum", using the cached size
+/// of the line when it is long.
+static int linesize_fast_cached(CharsizeArg *const csarg, linenr_T lnum)
+{
+  VcolCache *vc = vcol_cache_get(csarg, lnum);
+  return vc != NULL ? vc->size : linesize_fast(csarg, 0, MAXCOL);
+}
+
+/// Get the cached size of line "lnum" in window "csarg->win", computing it and
+/// the checkpoints used to start counting virtual columns halfway the line when
+/// needed.  Only long lines are cached, so that moving around in them doesn't
+/// count the size of every character from the start of the line again.
+///
+/// @param csarg  Argument to charsize functions, CSType must be kCharsizeFast.
+///
+/// @return NULL if the line is not cached.
+static VcolCache *vcol_cache_get(CharsizeArg *const csarg, linenr_T lnum)
+{
+  win_T *const wp = csarg->win;
+  buf_T *const buf = wp->w_buffer;
+  colnr_T const len = ml_get_buf_len(buf, lnum);
+  if (len < kVcolCacheMinLen || buf->b_p_vts_array != NULL) {
+    return NULL;
+  }
+
+  // The position of the window border matters for double-width characters.
+  int width1 = 0;
+  int width2 = 0;
+  if (wp->w_p_wrap && wp->w_view_width > 0) {
+    width1 = wp->w_view_width - win_col_off(wp);
+    width2 = width1 + win_col_off2(wp);
+  }
+  varnumber_T const changedtick = buf_get_changedtick(buf);
+
+  for (int i = 0; i < kVcolCacheSize; i++) {
+    VcolCache *vc = &wp->w_vcol_cache[i];
+    if (vc->lnum == lnum && vc->buf == buf->handle && vc->changedtick == changedtick
+        && vc->len == len && vc->epoch == vcol_cache_epoch && vc->ts == buf->b_p_ts
+        && vc->use_tabstop == csarg->use_tabstop
+        && vc->width1 == width1 && vc->width2 == width2) {
+      return vc;
+    }
+  }
+
+  VcolCache *vc = &wp->w_vcol_cache[wp->w_vcol_cache_next];
+  wp->w_vcol_cache_next = (wp->w_vcol_cache_next + 1) % kVcolCacheSize;
+  vc->lnum = lnum;
+  vc->buf = buf->handle;
+  vc->changedtick = changedtick;
+  vc->len = len;
+  vc->epoch = vcol_cache_epoch;
+  vc->ts = buf->b_p_ts;
+  vc->use_tabstop = csarg->use_tabstop;
+  vc->width1 = width1;
+  vc->width2 = width2;
+  kv_size(vc->checkpoints) = 0;
+
+  char *const line = csarg->line;
+  bool const use_tabstop = csarg->use_tabstop;
+  int64_t vcol = 0;
+  colnr_T nchars = 0;
+  colnr_T next_col = kVcolCheckpointStep;
+
+  StrCharInfo ci = utf_ptr2StrCharInfo(line);
+  while (*ci.ptr != NUL) {
+    colnr_T const col = (colnr_T)(ci.ptr - line);
+    if (col >= next_col) {
+      kv_push(vc->checkpoints, ((VcolCheckpoint){ .col = col, .nchars = nchars,
+                                                  .vcol = (colnr_T)vcol }));
+      next_col = col + kVcolCheckpointStep;
+    }
+    vcol += charsize_fast_impl(wp, ci.ptr, use_tabstop, (colnr_T)vcol, ci.chr.value).width;
+    ci = utfc_next(ci);
+    nchars++;
+    if (vcol > MAXCOL) {
+      vcol = MAXCOL;
+      break;
+    }
+  }
+  vc->size = (int)vcol;
+
+  return vc;
+}
+
+/// Find the last checkpoint in "vc" before byte "col", or before the character
+/// with index "nchars" when "col" is negative.
+///
+/// @return NULL if there is none.
+static VcolCheckpoint *vcol_cache_find(VcolCache *vc, colnr_T col, colnr_T nchars)
+{
+  size_t lo = 0;
+  size_t hi = kv_size(vc->checkpoints);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    VcolCheckpoint *cp = &kv_A(vc->checkpoints, mid);
+    if (col >= 0 ? cp->col <= col : cp->nchars <= nchars) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo > 0 ? &kv_A(vc->checkpoints, lo - 1) : NULL;
+}
+
+/// Invalidate the cached sizes of long lines in all windows.  Used when the
+/// size of characters changes, e.g. for 'ambiwidth' or setcellwidths().
+void vcol_cache_invalidate_all(void)
+{
+  vcol_cache_epoch++;
+}
+
+/// Get the inline virtual text of line "lnum" shown in window "wp", from the
+/// w_inline_virt_cache[] of the window when possible. "idxp" is set to the
+/// index of the used entry.
+///
+/// Marks on the same byte are combined, their order does not change the size.
+static InlineVirtCache *inline_virt_cache_get(win_T *wp, linenr_T lnum, int *idxp)
+{
+  buf_T *const buf = wp->w_buffer;
+  varnumber_T const changedtick = buf_get_changedtick(buf);
+
+  for (int i = 0; i < kInlineVirtCacheSize; i++) {
+    InlineVirtCache *ivc = &wp->w_inline_virt_cache[i];
+    if (ivc->lnum == lnum && ivc->buf == buf->handle && ivc->changedtick == changedtick
+        && ivc->epoch == inline_virt_cache_epoch) {
+      *idxp = i;
+      return ivc;
+    }
+  }
+
+  *idxp = wp->w_inline_virt_cache_next;
+  InlineVirtCache *ivc = &wp->w_inline_virt_cache[wp->w_inline_virt_cache_next];
+  wp->w_inline_virt_cache_next = (wp->w_inline_virt_cache_next + 1) % kInlineVirtCacheSize;
+  ivc->lnum = lnum;
+  ivc->buf = buf->handle;
+  ivc->changedtick = changedtick;
+  ivc->epoch = inline_virt_cache_epoch;
+  kv_size(ivc->items) = 0;
+
+  MarkTreeIter itr[1];
+  if (!marktree_itr_get_filter(buf->b_marktree, lnum - 1, 0, lnum, 0, inline_filter, itr)) {
+    return ivc;
+  }
+  while (true) {
+    MTKey mark = marktree_itr_current(itr);
+    if (mark.pos.row != lnum - 1) {
+      break;
+    }
+    if (!mt_invalid(mark) && ns_in_win(mark.ns, wp)) {
+      DecorInline decor = mt_decor(mark);
+      int width = 0;
+      for (DecorVirtText *vt = decor.ext ? decor.data.ext.vt : NULL; vt; vt = vt->next) {
+        if (!(vt->flags & kVTIsLines) && vt->pos == kVPosInline) {
+          width += vt->width;
+        }
+      }
+      if (width > 0) {
+        if (kv_size(ivc->items) == 0 || kv_last(ivc->items).col != mark.pos.col) {
+          kv_push(ivc->items, ((InlineVirtItem){ .col = mark.pos.col }));
+        }
+        if (mt_right(mark)) {
+          kv_last(ivc->items).width_right += width;
+        } else {
+          kv_last(ivc->items).width_left += width;
+        }
+      }
+    }
+    marktree_itr_next_filter(buf->b_marktree, itr, lnum, 0, inline_filter);
+  }
+
+  return ivc;
+}
+
+/// Invalidate the cached inline virtual text in all windows.  Used when inline
+/// virtual text is added or removed without changing the text.
+void inline_virt_cache_invalidate_all(void)
+{
+  inline_virt_cache_epoch++;
+}
+
+/// Free the cached inline virtual text in window "wp".
+void inline_virt_cache_clear(win_T *wp)
+{
+  for (int i = 0; i < kInlineVirtCacheSize; i++) {
+    kv_destroy(wp->w_inline_virt_cache[i].items);
+    wp->w_inline_virt_cache[i] = (InlineVirtCache){ 0 };
+  }
+}
+
+/// Free the cached sizes of long lines in window "wp".
+void vcol_cache_clear(win_T *wp)
+{
+  for (int i = 0; i < kVcolCacheSize; i++) {
+    kv_destroy(wp->w_vcol_cache[i].checkpoints);
+    wp->w_vcol_cache[i] = (VcolCache){ 0 };
+  }
+}
+
 /// Get how many virtual columns inline virtual text should offset the cursor.
 ///
 /// @param csarg   should contain information stored by charsize_regular()
@@ -535,6 +749,12 @@ void getvcol(win_T *wp, pos_T *pos, colnr_T *start, colnr_T *cursor, colnr_T *en
   CharSize char_size;
   StrCharInfo ci = utf_ptr2StrCharInfo(line);
   if (cstype == kCharsizeFast) {
+    VcolCache *vc = vcol_cache_get(&csarg, pos->lnum);
+    VcolCheckpoint *cp = vc != NULL ? vcol_cache_find(vc, end_col, 0) : NULL;
+    if (cp != NULL) {
+      ci = utf_ptr2StrCharInfo(line + cp->col);
+      vcol = cp->vcol;
+    }
     bool const use_tabstop = csarg.use_tabstop;
     while (true) {
       if (*ci.ptr == NUL) {
@@ -794,7 +1014,7 @@ int plines_win_nofold(win_T *wp, linenr_T lnum)
 
   int64_t col;
   if (cstype == kCharsizeFast) {
-    col = linesize_fast(&csarg, 0, MAXCOL);
+    col = linesize_fast_cached(&csarg, lnum);
   } else {
     col = linesize_regular(&csarg, 0, MAXCOL);
   }
@@ -842,6 +1062,13 @@ int plines_win_col(win_T *wp, linenr_T lnum, long column)
   colnr_T vcol = 0;
   StrCharInfo ci = utf_ptr2StrCharInfo(line);
   if (cstype == kCharsizeFast) {
+    VcolCache *vc = column > 0 ? vcol_cache_get(&csarg, lnum) : NULL;
+    VcolCheckpoint *cp = vc != NULL ? vcol_cache_find(vc, -1, (colnr_T)MIN(column, MAXCOL)) : NULL;
+    if (cp != NULL) {
+      ci = utf_ptr2StrCharInfo(line + cp->col);
+      vcol = cp->vcol;
+      column -= cp->nchars;
+    }
     bool const use_tabstop = csarg.use_tabstop;
     while (*ci.ptr != NUL && --column >= 0) {
       vcol += charsize_fast_impl(wp, ci.ptr, use_tabstop, vcol, ci.chr.value).width;
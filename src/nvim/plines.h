@@ -1,9 +1,9 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-#include "nvim/marktree_defs.h"
 #include "nvim/pos_defs.h"
 #include "nvim/types_defs.h"
 
@@ -24,11 +24,12 @@ typedef struct {
                              ///< parts of lines, INT_MIN if not yet calculated.
 
   int virt_row;              ///< Row for virtual text, -1 if no virtual text.
+  int virt_cache;            ///< Entry of w_inline_virt_cache[] for "virt_row".
+  size_t virt_idx;           ///< Next item in the w_inline_virt_cache[] entry.
   int cur_text_width_left;   ///< Width of virtual text left of cursor.
   int cur_text_width_right;  ///< Width of virtual text right of cursor.
 
   int max_head_vcol;         ///< See charsize_regular().
-  MarkTreeIter iter[1];
 } CharsizeArg;
 
 typedef struct {
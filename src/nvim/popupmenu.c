@@ -69,6 +69,8 @@ static int pum_width;               // width of displayed pum items
 static int pum_base_width;          // width of pum items base
 static int pum_kind_width;          // width of pum items kind column
 static int pum_extra_width;         // width of extra stuff
+static pumitem_T *pum_sized_array = NULL;  // "pum_array" the widths are for
+static int pum_sized_size;          // "pum_size" the widths are for
 static int pum_scrollbar;           // one when scrollbar present, else zero
 static bool pum_rl;                 // true when popupmenu is drawn 'rightleft'
 
@@ -94,6 +96,8 @@ static bool pum_invalid = false;  // the screen was just cleared
 static void pum_compute_size(void)
 {
   // Compute the width of the widest match and the widest extra.
+  pum_sized_array = pum_array;
+  pum_sized_size = pum_size;
   pum_base_width = 0;
   pum_kind_width = 0;
   pum_extra_width = 0;
@@ -318,7 +322,11 @@ void pum_display(pumitem_T *array, int size, int selected, bool array_changed, i
       return;
     }
 
-    pum_compute_size();
+    // When only the selected item changed the widths are the same.  With many
+    // items computing them again makes moving through the matches slow.
+    if (array_changed || pum_sized_array != array || pum_sized_size != size) {
+      pum_compute_size();
+    }
     int max_width = pum_base_width;
     if (p_pmw > 0 && max_width > p_pmw) {
       max_width = (int)p_pmw;
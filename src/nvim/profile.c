@@ -7,6 +7,8 @@
 #include <string.h>
 #include <uv.h>
 
+#include "nvim/api/private/defs.h"
+#include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/charset.h"
 #include "nvim/cmdexpand_defs.h"
@@ -24,6 +26,7 @@
 #include "nvim/hashtab_defs.h"
 #include "nvim/keycodes.h"
 #include "nvim/memory.h"
+#include "nvim/memory_defs.h"
 #include "nvim/message.h"
 #include "nvim/os/fs.h"
 #include "nvim/os/os.h"
@@ -986,3 +989,142 @@ void time_finish(void)
 
   XFREE_CLEAR(startuptime_buf);
 }
+
+/// Span of time spent in an activity, see trace_end().
+typedef struct {
+  const char *cat;     ///< category
+  const char *name;    ///< name, allocated when "name_alloc" is true
+  const char *detail;  ///< extra information or NULL
+  bool name_alloc;     ///< "name" must be freed
+  uint64_t start;      ///< os_hrtime() at the start
+  uint64_t dur;        ///< duration in nanoseconds
+} TraceSpan;
+
+static TraceSpan *trace_spans = NULL;  ///< ring buffer of "trace_size" spans
+static size_t trace_size = 0;
+static size_t trace_len = 0;   ///< number of recorded spans
+static size_t trace_next = 0;  ///< index for the next span
+
+/// Start recording spans of time spent in sourcing, autocommands, RPC
+/// requests, decoration providers and redrawing.  Only the last "size" spans
+/// are kept.  Stops recording when "size" is zero.
+void trace_start(size_t size)
+{
+  trace_free_all();
+  if (size > 0) {
+    trace_spans = xcalloc(size, sizeof(*trace_spans));
+    trace_size = size;
+    do_tracing = true;
+  }
+}
+
+/// Stop recording spans and free the recorded ones.
+void trace_free_all(void)
+{
+  for (size_t i = 0; i < trace_len; i++) {
+    if (trace_spans[i].name_alloc) {
+      xfree((char *)trace_spans[i].name);
+    }
+  }
+  XFREE_CLEAR(trace_spans);
+  trace_size = 0;
+  trace_len = 0;
+  trace_next = 0;
+  do_tracing = false;
+}
+
+/// Adds a duration to a histogram of g_stats. Bucket i counts durations of
+/// 2^(i-1) to 2^i milliseconds, the first one shorter durations and the last one
+/// longer durations.
+///
+/// @param hist  Array of STATS_HIST_SIZE counters.
+/// @param ns  Duration in nanoseconds.
+void stats_hist_add(int64_t *hist, uint64_t ns)
+  FUNC_ATTR_NONNULL_ALL
+{
+  uint64_t ms = ns / 1000000;
+  int i = 0;
+  while (ms > 0 && i < STATS_HIST_SIZE - 1) {
+    ms >>= 1;
+    i++;
+  }
+  hist[i]++;
+}
+
+/// @return  the start time of a span for trace_end(), zero when not tracing.
+uint64_t trace_begin(void)
+  FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  return do_tracing ? os_hrtime() : 0;
+}
+
+static void trace_add(const char *cat, const char *name, bool name_alloc, const char *detail,
+                      uint64_t start)
+{
+  TraceSpan *span = &trace_spans[trace_next];
+  if (trace_len == trace_size) {
+    // Overwrite the oldest span.
+    if (span->name_alloc) {
+      xfree((char *)span->name);
+    }
+  } else {
+    trace_len++;
+  }
+  *span = (TraceSpan){
+    .cat = cat,
+    .name = name,
+    .detail = detail,
+    .name_alloc = name_alloc,
+    .start = start,
+    .dur = os_hrtime() - start,
+  };
+  trace_next = (trace_next + 1) % trace_size;
+}
+
+/// Record a span that started at "start", returned by trace_begin().
+/// "cat", "name" and "detail" must stay valid, they are not copied.
+///
+/// @param detail  extra information or NULL
+void trace_end(const char *cat, const char *name, const char *detail, uint64_t start)
+  FUNC_ATTR_NONNULL_ARG(1, 2)
+{
+  if (start != 0 && do_tracing) {
+    trace_add(cat, name, false, detail, start);
+  }
+}
+
+/// Like trace_end(), but makes a copy of "name".
+void trace_end_copy(const char *cat, const char *name, uint64_t start)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (start != 0 && do_tracing) {
+    trace_add(cat, xstrdup(name), true, NULL, start);
+  }
+}
+
+/// Get the recorded spans, oldest first, as "complete" events of the Chrome
+/// trace event format.  Times are in microseconds.
+Array trace_events(Arena *arena)
+{
+  Array rv = arena_array(arena, trace_len);
+  const size_t first = trace_len < trace_size ? 0 : trace_next;
+  const int64_t pid = os_get_pid();
+  for (size_t i = 0; i < trace_len; i++) {
+    TraceSpan *span = &trace_spans[(first + i) % trace_size];
+    Dict ev = arena_dict(arena, 8);
+    PUT_C(ev, "name", CSTR_TO_ARENA_OBJ(arena, span->name));
+    PUT_C(ev, "cat", CSTR_AS_OBJ(span->cat));
+    PUT_C(ev, "ph", CSTR_AS_OBJ("X"));
+    PUT_C(ev, "ts", FLOAT_OBJ((double)span->start / 1000.0));
+    PUT_C(ev, "dur", FLOAT_OBJ((double)span->dur / 1000.0));
+    PUT_C(ev, "pid", INTEGER_OBJ(pid));
+    PUT_C(ev, "tid", INTEGER_OBJ(0));
+    if (span->detail != NULL) {
+      Dict args = arena_dict(arena, 1);
+      PUT_C(args, "detail", CSTR_TO_ARENA_OBJ(arena, span->detail));
+      PUT_C(ev, "args", DICT_OBJ(args));
+    }
+    ADD_C(rv, DICT_OBJ(ev));
+  }
+  return rv;
+}
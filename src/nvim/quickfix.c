@@ -9,7 +9,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/arglist.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
@@ -101,6 +103,8 @@ struct qfline_S {
   char qf_type;           ///< type of the error (mostly 'E'); 1 for :helpgrep
   typval_T qf_user_data;  ///< custom user data associated with this item
   char qf_valid;          ///< valid error message detected
+  int qf_adjust_gen;      ///< b_qf_adjust_gen of the buffer when qf_adjust_len was set
+  int qf_adjust_len;      ///< number of b_qf_adjust[] changes applied
 };
 
 // There is a stack of error lists.
@@ -126,6 +130,8 @@ typedef struct {
   qfline_T *qf_start;     ///< pointer to the first error
   qfline_T *qf_last;      ///< pointer to the last error
   qfline_T *qf_ptr;       ///< pointer to the current error
+  kvec_t(qfline_T *) qf_entries;  ///< all the errors in order, to get one by
+                                  ///< its index without walking the list
   int qf_count;           ///< number of errors (0 means empty list)
   int qf_index;           ///< current index in the error list
   bool qf_nonevalid;      ///< true if not a single valid entry found
@@ -191,6 +197,9 @@ struct efm_S {
                               // '-' do not include this line
                               // '+' include whole line in message
   int conthere;                 // %> used
+  char literal[16];             // text every matching line starts with,
+                                // compared ignoring case
+  int literal_len;
 };
 
 /// List of location lists to be deleted.
@@ -257,6 +266,38 @@ typedef struct {
   char *qf_title;      ///< quickfix list title
 } vgr_args_T;
 
+enum {
+  VGR_PF_MAX_THREADS = 8,       ///< maximum number of :vimgrep reader threads
+  VGR_PF_BUFSIZE = 64 * 1024,   ///< size of the read buffer of each thread
+};
+
+/// Result of checking a file for the literal text of the :vimgrep pattern.
+enum {
+  VGR_PF_PENDING = 0,  ///< not checked yet
+  VGR_PF_MAYBE = 1,    ///< file may contain a match, load it
+  VGR_PF_NOMATCH = 2,  ///< file cannot contain a match
+};
+
+/// Threads that read the files of :vimgrep ahead of the main thread, to find
+/// the files that do not contain the literal text every match must contain.
+/// These files don't need to be loaded in a buffer.
+typedef struct {
+  uv_mutex_t mutex;
+  uv_cond_t cond;        ///< signalled when a result is available
+  char **fnames;         ///< full file names, owned
+  int fcount;            ///< number of files
+  int next;              ///< next file for a thread to check
+  int nbufs;             ///< number of read buffers handed out
+  bool stop;             ///< threads must stop
+  char *lit;             ///< literal text, owned
+  size_t litlen;         ///< length of "lit"
+  bool ic;               ///< ignore case for "lit"
+  uint8_t *result;       ///< VGR_PF_ value for each file
+  char *bufs;            ///< read buffers for all threads
+  int nthreads;          ///< number of threads started
+  uv_thread_t threads[VGR_PF_MAX_THREADS];
+} vgr_prefilter_T;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "quickfix.c.generated.h"
 #endif
@@ -334,6 +375,9 @@ static void qfga_clear(void)
 static int quickfix_busy = 0;
 static qf_delq_T *qf_delq_head = NULL;
 
+/// Pool for quickfix entries, lists can have many thousands of them.
+static MemPool qfline_pool = MEM_POOL_INIT("qfline", qfline_T);
+
 /// Process the next line from a file/buffer/list/string and add it
 /// to the quickfix list 'qfl'.
 static int qf_init_process_nextline(qf_list_T *qfl, efm_T *fmt_first, qfstate_T *state,
@@ -537,7 +581,20 @@ static int efm_to_regpat(const char *efm, int len, efm_T *fmt_ptr, char *regpat)
   char *ptr = regpat;
   *ptr++ = '^';
   int round = 0;
+  // The literal text ends at the first item that is not a plain character.  A
+  // multi like "%#" applies to the character before it, drop that one too.
+  bool in_literal = true;
+  fmt_ptr->literal_len = 0;
   for (const char *efmp = efm; efmp < efm + len; efmp++) {
+    if (in_literal && (*efmp == '%' || *efmp == '\' || (uint8_t)(*efmp) >= 0x80)
+        && !(*efmp == '%' && (efmp[1] == '>' || (efmp == efm && efmp + 1 < efm + len
+                                                 && vim_strchr("+-DXAEWINCZGOPQ",
+                                                               (uint8_t)efmp[1]) != NULL)))) {
+      in_literal = false;
+      if (fmt_ptr->literal_len > 0) {
+        fmt_ptr->literal_len--;
+      }
+    }
     if (*efmp == '%') {
       efmp++;
       int idx;
@@ -582,6 +639,9 @@ static int efm_to_regpat(const char *efm, int len, efm_T *fmt_ptr, char *regpat)
         *ptr++ = '\\';  // escape regexp atoms
       }
       if (*efmp) {
+        if (in_literal && fmt_ptr->literal_len < (int)sizeof(fmt_ptr->literal)) {
+          fmt_ptr->literal[fmt_ptr->literal_len++] = *efmp;
+        }
         *ptr++ = *efmp;
       }
     }
@@ -1599,6 +1659,29 @@ static int qf_parse_match(char *linebuf, size_t linelen, efm_T *fmt_ptr, regmatc
   return QF_OK;
 }
 
+/// Return false when 'linebuf' can't match 'fmt_ptr', because it doesn't start
+/// with the literal text of the format.  Avoids running the regexp for most
+/// formats on lines that are just compiler noise.
+static bool efm_literal_may_match(const efm_T *fmt_ptr, const char *linebuf, size_t linelen)
+{
+  if (fmt_ptr->literal_len == 0) {
+    return true;
+  }
+  if (linelen < (size_t)fmt_ptr->literal_len) {
+    return false;
+  }
+  for (int i = 0; i < fmt_ptr->literal_len; i++) {
+    // A multibyte character may fold to an ASCII one, leave it to the regexp.
+    if ((uint8_t)linebuf[i] >= 0x80) {
+      return true;
+    }
+    if (TOLOWER_ASC(linebuf[i]) != TOLOWER_ASC(fmt_ptr->literal[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /// Parse an error line in 'linebuf' using a single error format string in
 /// 'fmt_ptr->prog' and return the matching values in 'fields'.
 /// Returns QF_OK if the efm format matches completely and the fields are
@@ -1626,6 +1709,10 @@ static int qf_parse_get_fields(char *linebuf, size_t linelen, efm_T *fmt_ptr, qf
   fields->type = 0;
   *tail = NULL;
 
+  if (!efm_literal_may_match(fmt_ptr, linebuf, linelen)) {
+    return QF_FAIL;
+  }
+
   regmatch_T regmatch;
   // Always ignore case when looking for a matching error.
   regmatch.rm_ic = true;
@@ -1922,9 +2009,7 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
                         char valid)
 {
   buf_T *buf;
-  qfline_T *qfp = xmalloc(sizeof(qfline_T));
-  char *fullname = NULL;
-  char *p = NULL;
+  qfline_T *qfp = pool_alloc(&qfline_pool);
 
   if (bufnum != 0) {
     buf = buflist_findnr(bufnum);
@@ -1937,21 +2022,11 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
     qfp->qf_fnum = qf_get_fnum(qfl, dir, fname);
     buf = buflist_findnr(qfp->qf_fnum);
   }
-  if (fname != NULL) {
-    fullname = fix_fname(fname);
-  }
-  qfp->qf_fname = NULL;
-  if (buf != NULL && buf->b_ffname != NULL && fullname != NULL) {
-    if (path_fnamecmp(fullname, buf->b_ffname) != 0) {
-      p = path_try_shorten_fname(fullname);
-      if (p != NULL) {
-        qfp->qf_fname = xstrdup(p);
-      }
-    }
-  }
-  xfree(fullname);
+  qfp->qf_fname = qf_entry_fname(buf, fname);
   qfp->qf_text = xstrdup(mesg);
   qfp->qf_lnum = lnum;
+  qfp->qf_adjust_gen = buf != NULL ? buf->b_qf_adjust_gen : 0;
+  qfp->qf_adjust_len = buf != NULL ? buf->b_qf_adjust_len : 0;
   qfp->qf_end_lnum = end_lnum;
   qfp->qf_col = col;
   qfp->qf_end_col = end_col;
@@ -1979,6 +2054,35 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
   qfp->qf_type = type;
   qfp->qf_valid = valid;
 
+  qf_link_entry(qfl, qfp);
+  return QF_OK;
+}
+
+/// Return the name to use for an entry in buffer "buf" with file name "fname",
+/// when "fname" is a different name for the file, e.g. a hard link.
+///
+/// @return  allocated string or NULL when the buffer name can be used.
+static char *qf_entry_fname(buf_T *buf, const char *fname)
+{
+  if (fname == NULL) {
+    return NULL;
+  }
+  char *fullname = fix_fname(fname);
+  char *ret = NULL;
+  if (buf != NULL && buf->b_ffname != NULL && fullname != NULL
+      && path_fnamecmp(fullname, buf->b_ffname) != 0) {
+    char *p = path_try_shorten_fname(fullname);
+    if (p != NULL) {
+      ret = xstrdup(p);
+    }
+  }
+  xfree(fullname);
+  return ret;
+}
+
+/// Add entry "qfp" at the end of list "qfl".
+static void qf_link_entry(qf_list_T *qfl, qfline_T *qfp)
+{
   qfline_T **lastp = &qfl->qf_last;
   if (qf_list_empty(qfl)) {
     // first element in the list
@@ -1995,13 +2099,12 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
   qfp->qf_cleared = false;
   *lastp = qfp;
   qfl->qf_count++;
+  kv_push(qfl->qf_entries, qfp);
   if (qfl->qf_index == 0 && qfp->qf_valid) {
     // first valid entry
     qfl->qf_index = qfl->qf_count;
     qfl->qf_ptr = qfp;
   }
-
-  return QF_OK;
 }
 
 /// Resize quickfix stack to be able to hold n amount of lists.
@@ -2192,7 +2295,7 @@ static int copy_loclist_entries(const qf_list_T *from_qfl, qf_list_T *to_qfl)
                      from_qfp->qf_module,
                      0,
                      from_qfp->qf_text,
-                     from_qfp->qf_lnum,
+                     qf_entry_lnum(from_qfp),
                      from_qfp->qf_end_lnum,
                      from_qfp->qf_col,
                      from_qfp->qf_end_col,
@@ -2210,6 +2313,8 @@ static int copy_loclist_entries(const qf_list_T *from_qfl, qf_list_T *to_qfl)
     // field is copied here.
     qfline_T *const prevp = to_qfl->qf_last;
     prevp->qf_fnum = from_qfp->qf_fnum;  // file number
+    prevp->qf_adjust_gen = from_qfp->qf_adjust_gen;
+    prevp->qf_adjust_len = from_qfp->qf_adjust_len;
     prevp->qf_type = from_qfp->qf_type;  // error type
     if (from_qfl->qf_ptr == from_qfp) {
       to_qfl->qf_ptr = prevp;  // current location
@@ -2521,12 +2626,27 @@ static bool qflist_valid(win_T *wp, unsigned qf_id)
   return false;
 }
 
+/// Return true when qf_entries of "qfl" has all its entries.
+static inline bool qf_entries_valid(const qf_list_T *qfl)
+{
+  return qfl->qf_count > 0 && kv_size(qfl->qf_entries) == (size_t)qfl->qf_count;
+}
+
 /// When loading a file from the quickfix, the autocommands may modify it.
 /// This may invalidate the current quickfix entry.  This function checks
 /// whether an entry is still present in the quickfix list.
 /// Similar to location list.
 static bool is_qf_entry_present(qf_list_T *qfl, qfline_T *qf_ptr)
 {
+  if (qf_entries_valid(qfl)) {
+    for (size_t i = 0; i < kv_size(qfl->qf_entries); i++) {
+      if (kv_A(qfl->qf_entries, i) == qf_ptr) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   qfline_T *qfp;
   int i;
 
@@ -2625,6 +2745,12 @@ static qfline_T *get_nth_valid_entry(qf_list_T *qfl, int errornr, int dir, int *
 /// list 'qfl'. Returns a pointer to the new entry and the index in 'new_qfidx'
 static qfline_T *get_nth_entry(qf_list_T *qfl, int errornr, int *new_qfidx)
 {
+  if (qf_entries_valid(qfl) && qfl->qf_index > 0) {
+    int qf_idx = MAX(MIN(errornr, qfl->qf_count), 1);
+    *new_qfidx = qf_idx;
+    return kv_A(qfl->qf_entries, qf_idx - 1);
+  }
+
   qfline_T *qf_ptr = qfl->qf_ptr;
   int qf_idx = qfl->qf_index;
 
@@ -3076,6 +3202,7 @@ static void qf_jump_print_msg(qf_info_T *qi, int qf_index, qfline_T *qf_ptr, buf
       update_screen();
     }
   }
+  qf_entry_adjust(qf_ptr);
   vim_snprintf(IObuff, IOSIZE, _("(%d of %d)%s%s: "), qf_index,
                qf_get_curlist(qi)->qf_count,
                qf_ptr->qf_cleared ? _(" (line deleted)") : "",
@@ -3189,7 +3316,7 @@ static int qf_jump_to_buffer(qf_info_T *qi, int qf_index, qfline_T *qf_ptr, int
     setpcmark();
   }
 
-  qf_jump_goto_line(qf_ptr->qf_lnum, qf_ptr->qf_col, qf_ptr->qf_viscol, qf_ptr->qf_pattern);
+  qf_jump_goto_line(qf_entry_lnum(qf_ptr), qf_ptr->qf_col, qf_ptr->qf_viscol, qf_ptr->qf_pattern);
 
   if ((fdo_flags & kOptFdoFlagQuickfix) && openfold) {
     foldOpenCursor();
@@ -3357,11 +3484,11 @@ static void qf_list_entry(qfline_T *qfp, int qf_idx, bool cursel)
   msg_putchar('\n');
   msg_outtrans(IObuff, cursel ? HLF_QFL : qfFile_hl_id, false);
 
-  if (qfp->qf_lnum != 0) {
+  if (qf_entry_lnum(qfp) != 0) {
     msg_puts_hl(":", qfSep_hl_id, false);
   }
   garray_T *gap = qfga_get();
-  if (qfp->qf_lnum != 0) {
+  if (qf_entry_lnum(qfp) != 0) {
     qf_range_text(gap, qfp);
   }
   ga_concat(gap, qf_types(qfp->qf_type, qfp->qf_nr));
@@ -3381,7 +3508,8 @@ static void qf_list_entry(qfline_T *qfp, int qf_idx, bool cursel)
   // unrecognized line keep the indent, the compiler may mark a word
   // with ^^^^.
   gap = qfga_get();
-  qf_fmt_text(gap, (fname != NULL || qfp->qf_lnum != 0) ? skipwhite(qfp->qf_text) : qfp->qf_text);
+  qf_fmt_text(gap, (fname != NULL || qf_entry_lnum(qfp) != 0)
+                   ? skipwhite(qfp->qf_text) : qfp->qf_text);
   ga_append(gap, NUL);
   msg_prt_line(gap->ga_data, false);
 }
@@ -3483,15 +3611,15 @@ static void qf_fmt_text(garray_T *gap, const char *restrict text)
 
 /// Add the range information from the lnum, col, end_lnum, and end_col values
 /// of a quickfix entry to the grow array "gap".
-static void qf_range_text(garray_T *gap, const qfline_T *qfp)
+static void qf_range_text(garray_T *gap, qfline_T *qfp)
 {
   char *const buf = IObuff;
   const size_t bufsize = IOSIZE;
 
-  vim_snprintf(buf, bufsize, "%" PRIdLINENR, qfp->qf_lnum);
+  vim_snprintf(buf, bufsize, "%" PRIdLINENR, qf_entry_lnum(qfp));
   size_t len = strlen(buf);
 
-  if (qfp->qf_end_lnum > 0 && qfp->qf_lnum != qfp->qf_end_lnum) {
+  if (qfp->qf_end_lnum > 0 && qf_entry_lnum(qfp) != qfp->qf_end_lnum) {
     vim_snprintf(buf + len, bufsize - len, "-%" PRIdLINENR, qfp->qf_end_lnum);
     len += strlen(buf + len);
   }
@@ -3600,6 +3728,16 @@ void qf_history(exarg_T *eap)
 
 /// Free all the entries in the error list "idx". Note that other information
 /// associated with the list like context and title are not freed.
+static void qf_free_entry(qfline_T *qfp)
+{
+  xfree(qfp->qf_fname);
+  xfree(qfp->qf_module);
+  xfree(qfp->qf_text);
+  xfree(qfp->qf_pattern);
+  tv_clear(&qfp->qf_user_data);
+  pool_free(&qfline_pool, qfp);
+}
+
 static void qf_free_items(qf_list_T *qfl)
 {
   bool stop = false;
@@ -3608,13 +3746,8 @@ static void qf_free_items(qf_list_T *qfl)
     qfline_T *qfp = qfl->qf_start;
     qfline_T *qfpnext = qfp->qf_next;
     if (!stop) {
-      xfree(qfp->qf_fname);
-      xfree(qfp->qf_module);
-      xfree(qfp->qf_text);
-      xfree(qfp->qf_pattern);
-      tv_clear(&qfp->qf_user_data);
       stop = (qfp == qfpnext);
-      xfree(qfp);
+      qf_free_entry(qfp);
       if (stop) {
         // Somehow qf_count may have an incorrect value, set it to 1
         // to avoid crashing when it's wrong.
@@ -3632,6 +3765,7 @@ static void qf_free_items(qf_list_T *qfl)
   qfl->qf_index = 0;
   qfl->qf_start = NULL;
   qfl->qf_last = NULL;
+  kv_destroy(qfl->qf_entries);
   qfl->qf_ptr = NULL;
   qfl->qf_nonevalid = true;
 
@@ -3658,53 +3792,111 @@ static void qf_free(qf_list_T *qfl)
   qfl->qf_changedtick = 0;
 }
 
-/// Adjust error list entries for changed line numbers
+/// Adjust error list entries for changed line numbers.
 ///
-/// Note: `buf` is the changed buffer, but `wp` is a potential location list
-/// into that buffer, or NULL to check the quickfix list.
-bool qf_mark_adjust(buf_T *buf, win_T *wp, linenr_T line1, linenr_T line2, linenr_T amount,
+/// The change is only recorded in "buf", entries apply it when their line
+/// number is used next, see qf_entry_adjust(). This avoids going over all the
+/// entries of all the lists for every change. When there are too many changes
+/// they are applied to all the entries.
+void qf_mark_adjust(buf_T *buf, linenr_T line1, linenr_T line2, linenr_T amount,
                     linenr_T amount_after)
 {
-  qf_info_T *qi = ql_info;
-  assert(qi != NULL);
-  int buf_has_flag = wp == NULL ? BUF_HAS_QF_ENTRY : BUF_HAS_LL_ENTRY;
-
-  if (!(buf->b_has_qf_entry & buf_has_flag)) {
-    return false;
+  if (!(buf->b_has_qf_entry & (BUF_HAS_QF_ENTRY | BUF_HAS_LL_ENTRY))) {
+    return;
   }
-  if (wp != NULL) {
-    if (wp->w_llist == NULL) {
-      return false;
+  if (buf->b_qf_adjust_len == QF_ADJUST_MAX) {
+    qf_adjust_flush(buf);
+    if (!(buf->b_has_qf_entry & (BUF_HAS_QF_ENTRY | BUF_HAS_LL_ENTRY))) {
+      return;
     }
-    qi = wp->w_llist;
   }
+  buf->b_qf_adjust[buf->b_qf_adjust_len++] = (LineAdjust){
+    .line1 = line1,
+    .line2 = line2,
+    .amount = amount,
+    .amount_after = amount_after,
+  };
+}
 
-  int i;
-  qfline_T *qfp;
+/// Applies the line changes of "buf" to the entries of the lists in "qi".
+///
+/// @return  true if there is an entry for "buf".
+static bool qf_adjust_flush_lists(buf_T *buf, qf_info_T *qi)
+{
   bool found_one = false;
   for (int idx = 0; idx < qi->qf_listcount; idx++) {
     qf_list_T *qfl = qf_get_list(qi, idx);
-    if (!qf_list_empty(qfl)) {
-      FOR_ALL_QFL_ITEMS(qfl, qfp, i) {
-        if (qfp->qf_fnum == buf->b_fnum) {
-          found_one = true;
-          if (qfp->qf_lnum >= line1 && qfp->qf_lnum <= line2) {
-            if (amount == MAXLNUM) {
-              qfp->qf_cleared = true;
-            } else {
-              qfp->qf_lnum += amount;
-            }
-          } else if (amount_after && qfp->qf_lnum > line2) {
-            qfp->qf_lnum += amount_after;
-          }
-        }
+    // Not FOR_ALL_QFL_ITEMS(), an interrupt must not skip entries.
+    qfline_T *qfp = qfl->qf_start;
+    for (int i = 1; i <= qfl->qf_count && qfp != NULL; i++, qfp = qfp->qf_next) {
+      if (qfp->qf_fnum == buf->b_fnum) {
+        found_one = true;
+        qf_entry_adjust(qfp);
+        qfp->qf_adjust_gen = buf->b_qf_adjust_gen + 1;
+        qfp->qf_adjust_len = 0;
       }
     }
   }
-
   return found_one;
 }
 
+/// Applies the recorded line changes of "buf" to all quickfix and location
+/// list entries and clears them. Also updates the b_has_qf_entry flags.
+void qf_adjust_flush(buf_T *buf)
+{
+  if (buf->b_qf_adjust_len == 0) {
+    return;
+  }
+
+  if (!qf_adjust_flush_lists(buf, ql_info)) {
+    buf->b_has_qf_entry &= ~BUF_HAS_QF_ENTRY;
+  }
+  bool found_one = false;
+  FOR_ALL_TAB_WINDOWS(tab, win) {
+    if (win->w_llist != NULL) {
+      found_one |= qf_adjust_flush_lists(buf, win->w_llist);
+    }
+  }
+  if (!found_one) {
+    buf->b_has_qf_entry &= ~BUF_HAS_LL_ENTRY;
+  }
+
+  buf->b_qf_adjust_gen++;
+  buf->b_qf_adjust_len = 0;
+}
+
+/// Applies the line changes of its buffer that "qfp" hasn't seen yet.
+/// Must be done before using qf_lnum or qf_cleared.
+static void qf_entry_adjust(qfline_T *qfp)
+{
+  if (qfp->qf_fnum == 0) {
+    return;
+  }
+  buf_T *buf = buflist_findnr(qfp->qf_fnum);
+  if (buf == NULL || qfp->qf_adjust_gen != buf->b_qf_adjust_gen) {
+    return;
+  }
+  for (; qfp->qf_adjust_len < buf->b_qf_adjust_len; qfp->qf_adjust_len++) {
+    const LineAdjust *adj = &buf->b_qf_adjust[qfp->qf_adjust_len];
+    if (qfp->qf_lnum >= adj->line1 && qfp->qf_lnum <= adj->line2) {
+      if (adj->amount == MAXLNUM) {
+        qfp->qf_cleared = true;
+      } else {
+        qfp->qf_lnum += adj->amount;
+      }
+    } else if (adj->amount_after && qfp->qf_lnum > adj->line2) {
+      qfp->qf_lnum += adj->amount_after;
+    }
+  }
+}
+
+/// @return  the line number of "qfp", after applying line changes.
+static linenr_T qf_entry_lnum(qfline_T *qfp)
+{
+  qf_entry_adjust(qfp);
+  return qfp->qf_lnum;
+}
+
 // Make a nice message out of the error character and the error number:
 //  char    number  message
 //  e or E    0     " error"
@@ -4003,7 +4195,7 @@ static void qf_win_goto(win_T *win, linenr_T lnum)
   curwin->w_curswant = 0;
   update_topline(curwin);              // scroll to show the line
   redraw_later(curwin, UPD_VALID);
-  curwin->w_redr_status = true;  // update ruler
+  status_redraw_win(curwin);  // update ruler
   curwin = old_curwin;
   curbuf = curwin->w_buffer;
 }
@@ -4225,7 +4417,7 @@ static void qf_update_buffer(qf_info_T *qi, qfline_T *old_last)
 }
 
 // Add an error line to the quickfix buffer.
-static int qf_buf_add_line(qf_list_T *qfl, buf_T *buf, linenr_T lnum, const qfline_T *qfp,
+static int qf_buf_add_line(qf_list_T *qfl, buf_T *buf, linenr_T lnum, qfline_T *qfp,
                            char *dirname, char *qftf_str, bool first_bufline)
   FUNC_ATTR_NONNULL_ARG(1, 2, 4, 5)
 {
@@ -4262,7 +4454,7 @@ static int qf_buf_add_line(qf_list_T *qfl, buf_T *buf, linenr_T lnum, const qfli
 
     ga_append(gap, '|');
 
-    if (qfp->qf_lnum > 0) {
+    if (qf_entry_lnum(qfp) > 0) {
       qf_range_text(gap, qfp);
       ga_concat(gap, qf_types(qfp->qf_type, qfp->qf_nr));
     } else if (qfp->qf_pattern != NULL) {
@@ -4982,7 +5174,7 @@ static qfline_T *qf_find_first_entry_on_line(qfline_T *entry, int *errornr)
   while (!got_int
          && entry->qf_prev != NULL
          && entry->qf_fnum == entry->qf_prev->qf_fnum
-         && entry->qf_lnum == entry->qf_prev->qf_lnum) {
+         && qf_entry_lnum(entry) == qf_entry_lnum(entry->qf_prev)) {
     entry = entry->qf_prev;
     (*errornr)--;
   }
@@ -4998,7 +5190,7 @@ static qfline_T *qf_find_last_entry_on_line(qfline_T *entry, int *errornr)
   while (!got_int
          && entry->qf_next != NULL
          && entry->qf_fnum == entry->qf_next->qf_fnum
-         && entry->qf_lnum == entry->qf_next->qf_lnum) {
+         && qf_entry_lnum(entry) == qf_entry_lnum(entry->qf_next)) {
     entry = entry->qf_next;
     (*errornr)++;
   }
@@ -5009,53 +5201,53 @@ static qfline_T *qf_find_last_entry_on_line(qfline_T *entry, int *errornr)
 // Returns true if the specified quickfix entry is
 // after the given line (linewise is true)
 // or after the line and column.
-static bool qf_entry_after_pos(const qfline_T *qfp, const pos_T *pos, bool linewise)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+static bool qf_entry_after_pos(qfline_T *qfp, const pos_T *pos, bool linewise)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
 {
   if (linewise) {
-    return qfp->qf_lnum > pos->lnum;
+    return qf_entry_lnum(qfp) > pos->lnum;
   }
-  return qfp->qf_lnum > pos->lnum
-         || (qfp->qf_lnum == pos->lnum && qfp->qf_col > pos->col);
+  return qf_entry_lnum(qfp) > pos->lnum
+         || (qf_entry_lnum(qfp) == pos->lnum && qfp->qf_col > pos->col);
 }
 
 // Returns true if the specified quickfix entry is
 // before the given line (linewise is true)
 // or before the line and column.
-static bool qf_entry_before_pos(const qfline_T *qfp, const pos_T *pos, bool linewise)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+static bool qf_entry_before_pos(qfline_T *qfp, const pos_T *pos, bool linewise)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
 {
   if (linewise) {
-    return qfp->qf_lnum < pos->lnum;
+    return qf_entry_lnum(qfp) < pos->lnum;
   }
-  return qfp->qf_lnum < pos->lnum
-         || (qfp->qf_lnum == pos->lnum && qfp->qf_col < pos->col);
+  return qf_entry_lnum(qfp) < pos->lnum
+         || (qf_entry_lnum(qfp) == pos->lnum && qfp->qf_col < pos->col);
 }
 
 // Returns true if the specified quickfix entry is
 // on or after the given line (linewise is true)
 // or on or after the line and column.
-static bool qf_entry_on_or_after_pos(const qfline_T *qfp, const pos_T *pos, bool linewise)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+static bool qf_entry_on_or_after_pos(qfline_T *qfp, const pos_T *pos, bool linewise)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
 {
   if (linewise) {
-    return qfp->qf_lnum >= pos->lnum;
+    return qf_entry_lnum(qfp) >= pos->lnum;
   }
-  return qfp->qf_lnum > pos->lnum
-         || (qfp->qf_lnum == pos->lnum && qfp->qf_col >= pos->col);
+  return qf_entry_lnum(qfp) > pos->lnum
+         || (qf_entry_lnum(qfp) == pos->lnum && qfp->qf_col >= pos->col);
 }
 
 // Returns true if the specified quickfix entry is
 // on or before the given line (linewise is true)
 // or on or before the line and column.
-static bool qf_entry_on_or_before_pos(const qfline_T *qfp, const pos_T *pos, bool linewise)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+static bool qf_entry_on_or_before_pos(qfline_T *qfp, const pos_T *pos, bool linewise)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
 {
   if (linewise) {
-    return qfp->qf_lnum <= pos->lnum;
+    return qf_entry_lnum(qfp) <= pos->lnum;
   }
-  return qfp->qf_lnum < pos->lnum
-         || (qfp->qf_lnum == pos->lnum && qfp->qf_col <= pos->col);
+  return qf_entry_lnum(qfp) < pos->lnum
+         || (qf_entry_lnum(qfp) == pos->lnum && qfp->qf_col <= pos->col);
 }
 
 /// Find the first quickfix entry after position 'pos' in buffer 'bnr'.
@@ -5659,6 +5851,217 @@ static int vgr_process_args(exarg_T *eap, vgr_args_T *args)
   return OK;
 }
 
+/// Check whether "lit" appears in "s[len]".  When "ic" is true ASCII case is
+/// ignored, "lit" is then in lower case.
+static bool vgr_prefilter_find(const char *s, size_t len, const char *lit, size_t litlen, bool ic)
+{
+  if (len < litlen) {
+    return false;
+  }
+  const char *const end = s + len - litlen;
+  for (const char *p = s; p <= end; p++) {
+    if (ic) {
+      if (TOLOWER_ASC(*p) == lit[0] && vim_strnicmp_asc(p, lit, litlen) == 0) {
+        return true;
+      }
+    } else {
+      p = memchr(p, (uint8_t)lit[0], (size_t)(end - p) + 1);
+      if (p == NULL) {
+        return false;
+      }
+      if (memcmp(p, lit, litlen) == 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// @return  true when the reader threads must stop.
+static bool vgr_prefilter_stopped(vgr_prefilter_T *pf)
+{
+  uv_mutex_lock(&pf->mutex);
+  bool stop = pf->stop;
+  uv_mutex_unlock(&pf->mutex);
+  return stop;
+}
+
+/// Read file "fi" and check for the literal.  Runs in a reader thread.
+///
+/// @return  VGR_PF_MAYBE or VGR_PF_NOMATCH.
+static uint8_t vgr_prefilter_file(vgr_prefilter_T *pf, int fi, char *buf)
+{
+  int fd = os_open(pf->fnames[fi], O_RDONLY, 0);
+  if (fd < 0) {
+    return VGR_PF_MAYBE;  // let loading the file report the error
+  }
+
+  uint8_t result = VGR_PF_NOMATCH;
+  size_t keep = 0;
+  while (true) {
+    if (vgr_prefilter_stopped(pf)) {
+      result = VGR_PF_MAYBE;
+      break;
+    }
+    int n = read_eintr(fd, buf + keep, VGR_PF_BUFSIZE);
+    if (n < 0) {
+      result = VGR_PF_MAYBE;
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    // A NUL may be part of a wide encoding, can't say how the text will be
+    // converted.
+    size_t total = keep + (size_t)n;
+    if (memchr(buf + keep, NUL, (size_t)n) != NULL
+        || vgr_prefilter_find(buf, total, pf->lit, pf->litlen, pf->ic)) {
+      result = VGR_PF_MAYBE;
+      break;
+    }
+    // Keep the tail, the literal may continue in the next block.
+    keep = MIN(pf->litlen - 1, total);
+    memmove(buf, buf + total - keep, keep);
+  }
+
+  os_close(fd);
+  return result;
+}
+
+/// Reader thread: check files until there are none left or told to stop.
+static void vgr_prefilter_thread(void *arg)
+{
+  vgr_prefilter_T *pf = arg;
+
+  uv_mutex_lock(&pf->mutex);
+  char *buf = pf->bufs + (size_t)pf->nbufs++ * (VGR_PF_BUFSIZE + pf->litlen);
+  while (!pf->stop && pf->next < pf->fcount) {
+    int fi = pf->next++;
+    uv_mutex_unlock(&pf->mutex);
+
+    uint8_t result = vgr_prefilter_file(pf, fi, buf);
+
+    uv_mutex_lock(&pf->mutex);
+    pf->result[fi] = result;
+    uv_cond_broadcast(&pf->cond);
+  }
+  uv_mutex_unlock(&pf->mutex);
+}
+
+/// Start threads that check the files to be searched by :vimgrep for the
+/// literal text that the pattern requires.
+///
+/// @return  NULL when this is not possible or not useful.
+static vgr_prefilter_T *vgr_prefilter_start(vgr_args_T *args)
+{
+  if ((args->flags & VGR_FUZZY) || args->fcount < 2) {
+    return NULL;
+  }
+
+  bool ic;
+  int len;
+  const char *lit = vim_regprog_literal(args->regmatch.regprog, args->regmatch.rmm_ic, &ic, &len);
+  if (lit == NULL) {
+    return NULL;
+  }
+  // Only plain ASCII is found reliably in the file before 'fileencoding' is
+  // detected.  Ignoring case "k" and "s" also match a non-ASCII character.
+  for (int i = 0; i < len; i++) {
+    const uint8_t c = (uint8_t)lit[i];
+    if (c >= 0x80 || c == CAR
+        || (ic && (TOLOWER_ASC(c) == 'k' || TOLOWER_ASC(c) == 's'))) {
+      return NULL;
+    }
+  }
+
+  vgr_prefilter_T *pf = xcalloc(1, sizeof(vgr_prefilter_T));
+  pf->fcount = args->fcount;
+  pf->fnames = xmalloc((size_t)pf->fcount * sizeof(char *));
+  for (int fi = 0; fi < pf->fcount; fi++) {
+    // An autocommand may change the directory while the threads run.
+    pf->fnames[fi] = FullName_save(args->fnames[fi], false);
+  }
+  pf->lit = xmemdupz(lit, (size_t)len);
+  pf->litlen = (size_t)len;
+  pf->ic = ic;
+  if (ic) {
+    for (int i = 0; i < len; i++) {
+      pf->lit[i] = (char)TOLOWER_ASC(pf->lit[i]);
+    }
+  }
+  pf->result = xcalloc((size_t)pf->fcount, sizeof(uint8_t));
+
+  int nthreads = (int)MIN(uv_available_parallelism(), VGR_PF_MAX_THREADS);
+  nthreads = MIN(nthreads, pf->fcount);
+  pf->bufs = xmalloc((size_t)nthreads * (VGR_PF_BUFSIZE + pf->litlen));
+
+  uv_mutex_init(&pf->mutex);
+  uv_cond_init(&pf->cond);
+  for (int i = 0; i < nthreads; i++) {
+    if (uv_thread_create(&pf->threads[i], vgr_prefilter_thread, pf) != 0) {
+      break;
+    }
+    pf->nthreads++;
+  }
+  if (pf->nthreads == 0) {
+    vgr_prefilter_stop(pf);
+    return NULL;
+  }
+  return pf;
+}
+
+/// Stop the reader threads and free "pf".
+static void vgr_prefilter_stop(vgr_prefilter_T *pf)
+{
+  if (pf == NULL) {
+    return;
+  }
+
+  uv_mutex_lock(&pf->mutex);
+  pf->stop = true;
+  uv_mutex_unlock(&pf->mutex);
+  for (int i = 0; i < pf->nthreads; i++) {
+    uv_thread_join(&pf->threads[i]);
+  }
+  uv_cond_destroy(&pf->cond);
+  uv_mutex_destroy(&pf->mutex);
+
+  for (int fi = 0; fi < pf->fcount; fi++) {
+    xfree(pf->fnames[fi]);
+  }
+  xfree(pf->fnames);
+  xfree(pf->lit);
+  xfree(pf->result);
+  xfree(pf->bufs);
+  xfree(pf);
+}
+
+/// Check whether file "fi" needs to be loaded and searched.  Waits for a
+/// reader thread to check the file, CTRL-C interrupts.
+///
+/// @param fname  name of the file, for checking autocommands
+static bool vgr_prefilter_may_match(vgr_prefilter_T *pf, int fi, char *fname)
+{
+  // Autocommands may change the text when reading the file.
+  if (has_autocmd(EVENT_BUFREADCMD, fname, NULL)
+      || has_autocmd(EVENT_BUFREADPRE, fname, NULL)
+      || has_autocmd(EVENT_BUFREADPOST, fname, NULL)) {
+    return true;
+  }
+
+  uv_mutex_lock(&pf->mutex);
+  while (pf->result[fi] == VGR_PF_PENDING && !got_int) {
+    uv_cond_timedwait(&pf->cond, &pf->mutex, 20 * 1000 * 1000);  // 20 msec
+    uv_mutex_unlock(&pf->mutex);
+    os_breakcheck();
+    uv_mutex_lock(&pf->mutex);
+  }
+  uint8_t result = pf->result[fi];
+  uv_mutex_unlock(&pf->mutex);
+
+  return result != VGR_PF_NOMATCH && !got_int;
+}
+
 /// Search for a pattern in a list of files and populate the quickfix list with
 /// the matches.
 static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, bool *redraw_for_dummy,
@@ -5675,6 +6078,8 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
   // ":lcd %:p:h" changes the meaning of short path names.
   os_dirname(dirname_start, MAXPATHL);
 
+  vgr_prefilter_T *pf = vgr_prefilter_start(cmd_args);
+
   time_t seconds = 0;
   for (int fi = 0; fi < cmd_args->fcount && !got_int && cmd_args->tomatch > 0; fi++) {
     char *fname = path_try_shorten_fname(cmd_args->fnames[fi]);
@@ -5688,6 +6093,9 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
     buf_T *buf = buflist_findname_exp(cmd_args->fnames[fi]);
     bool using_dummy;
     if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
+      if (pf != NULL && !vgr_prefilter_may_match(pf, fi, fname)) {
+        continue;  // no match possible, don't load the file
+      }
       // Remember that a buffer with this name already exists.
       duplicate_name = (buf != NULL);
       using_dummy = true;
@@ -5783,6 +6191,7 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
   status = OK;
 
 theend:
+  vgr_prefilter_stop(pf);
   xfree(dirname_now);
   xfree(dirname_start);
   return status;
@@ -6082,7 +6491,7 @@ static int get_qfline_items(qfline_T *qfp, list_T *list)
   buf[0] = qfp->qf_type;
   buf[1] = NUL;
   if (tv_dict_add_nr(dict, S_LEN("bufnr"), (varnumber_T)bufnum) == FAIL
-      || (tv_dict_add_nr(dict, S_LEN("lnum"), (varnumber_T)qfp->qf_lnum) == FAIL)
+      || (tv_dict_add_nr(dict, S_LEN("lnum"), (varnumber_T)qf_entry_lnum(qfp)) == FAIL)
       || (tv_dict_add_nr(dict, S_LEN("end_lnum"), (varnumber_T)qfp->qf_end_lnum) == FAIL)
       || (tv_dict_add_nr(dict, S_LEN("col"), (varnumber_T)qfp->qf_col) == FAIL)
       || (tv_dict_add_nr(dict, S_LEN("end_col"), (varnumber_T)qfp->qf_end_col) == FAIL)
@@ -6140,6 +6549,13 @@ static int get_errorlist(qf_info_T *qi_arg, win_T *wp, int qf_idx, int eidx, lis
     return FAIL;
   }
 
+  if (eidx > 0 && qf_entries_valid(qfl)) {
+    if (eidx > qfl->qf_count) {
+      return OK;
+    }
+    return get_qfline_items(kv_A(qfl->qf_entries, eidx - 1), list);
+  }
+
   qfline_T *qfp;
   int i;
   FOR_ALL_QFL_ITEMS(qfl, qfp, i) {
@@ -6683,10 +7099,10 @@ static bool entry_is_closer_to_target(qfline_T *entry, qfline_T *other_entry, in
     return false;
   }
 
-  int line_distance = entry->qf_lnum
-                      ? abs(entry->qf_lnum - target_lnum) : INT_MAX;
-  int other_line_distance = other_entry->qf_lnum
-                            ? abs(other_entry->qf_lnum - target_lnum) : INT_MAX;
+  int line_distance = qf_entry_lnum(entry)
+                      ? abs(qf_entry_lnum(entry) - target_lnum) : INT_MAX;
+  int other_line_distance = qf_entry_lnum(other_entry)
+                            ? abs(qf_entry_lnum(other_entry) - target_lnum) : INT_MAX;
   if (line_distance > other_line_distance) {
     return false;
   } else if (line_distance < other_line_distance) {
@@ -6714,12 +7130,124 @@ static bool entry_is_closer_to_target(qfline_T *entry, qfline_T *other_entry, in
   return false;
 }
 
+/// Return true when "s", a string from a dict item, is stored as "stored".
+/// An empty string is stored as NULL.
+static bool qf_str_stored(const char *stored, const char *s)
+{
+  if (s == NULL || *s == NUL) {
+    return stored == NULL;
+  }
+  return stored != NULL && strcmp(stored, s) == 0;
+}
+
+/// Return true when existing entry "qfp" is what qf_add_entry_from_dict()
+/// would add for dict "d".  Only entries with a "bufnr" are checked, for a
+/// file name the buffer may still have to be created.
+static bool qf_entry_equals_dict(qfline_T *qfp, dict_T *d)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const int bufnum = (int)tv_dict_get_number(d, "bufnr");
+  qf_entry_adjust(qfp);
+  if (bufnum == 0 || qfp->qf_fnum != bufnum || qfp->qf_cleared) {
+    return false;
+  }
+  buf_T *const buf = buflist_findnr(bufnum);
+  if (buf == NULL
+      || qf_entry_lnum(qfp) != (linenr_T)tv_dict_get_number(d, "lnum")
+      || qfp->qf_end_lnum != (linenr_T)tv_dict_get_number(d, "end_lnum")
+      || qfp->qf_col != (int)tv_dict_get_number(d, "col")
+      || qfp->qf_end_col != (int)tv_dict_get_number(d, "end_col")
+      || qfp->qf_viscol != (char)tv_dict_get_number(d, "vcol")
+      || qfp->qf_nr != (int)tv_dict_get_number(d, "nr")) {
+    return false;
+  }
+
+  const char *const type = tv_dict_get_string(d, "type", false);
+  char type_c = type == NULL ? NUL : *type;
+  if (type_c != 1 && !vim_isprintc(type_c)) {
+    type_c = 0;
+  }
+  if (qfp->qf_type != type_c) {
+    return false;
+  }
+  // Only the NULL-ness of "pattern" is used after the next call.
+  const char *const pattern = tv_dict_get_string(d, "pattern", false);
+  if (!qf_str_stored(qfp->qf_pattern, pattern)
+      || !qf_str_stored(qfp->qf_module, tv_dict_get_string(d, "module", false))) {
+    return false;
+  }
+  const char *const text = tv_dict_get_string(d, "text", false);
+  if (strcmp(qfp->qf_text, text == NULL ? "" : text) != 0) {
+    return false;
+  }
+
+  char valid = qf_entry_lnum(qfp) != 0 || pattern != NULL;
+  if (tv_dict_find(d, "valid", -1) != NULL) {
+    valid = (char)tv_dict_get_number(d, "valid");
+  }
+  if (qfp->qf_valid != valid) {
+    return false;
+  }
+
+  dictitem_T *const di = tv_dict_find(d, "user_data", -1);
+  if (di == NULL || di->di_tv.v_type == VAR_UNKNOWN) {
+    if (qfp->qf_user_data.v_type != VAR_UNKNOWN) {
+      return false;
+    }
+  } else if (qfp->qf_user_data.v_type == VAR_UNKNOWN
+             || !tv_equal(&qfp->qf_user_data, &di->di_tv, false)) {
+    return false;
+  }
+
+  char *fname = qf_entry_fname(buf, tv_dict_get_string(d, "filename", false));
+  const bool same_fname = fname == NULL
+                          ? qfp->qf_fname == NULL
+                          : qfp->qf_fname != NULL && strcmp(fname, qfp->qf_fname) == 0;
+  xfree(fname);
+  return same_fname;
+}
+
+/// When updating list "qfl", find an unused entry of the old list in "reuse"
+/// that equals dict "d", the item at index "idx" of a list with "len" items.
+/// Only the entry at the same index and the one at the same distance from the
+/// end are tried, these are kept when entries were changed, added or removed
+/// in one place.
+///
+/// @return  whether the entry was found and added to "qfl".
+static bool qf_reuse_entry(qf_list_T *qfl, qfline_T **reuse, int reuse_count, int idx, int len,
+                           dict_T *d)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const int cand[2] = { idx, idx + reuse_count - len };
+  for (int i = 0; i < 2; i++) {
+    const int c = cand[i];
+    if (c < 0 || c >= reuse_count || reuse[c] == NULL || !qf_entry_equals_dict(reuse[c], d)) {
+      continue;
+    }
+    qfline_T *const qfp = reuse[c];
+    reuse[c] = NULL;
+    buf_T *const buf = buflist_findnr(qfp->qf_fnum);
+    buf->b_has_qf_entry |= IS_QF_LIST(qfl) ? BUF_HAS_QF_ENTRY : BUF_HAS_LL_ENTRY;
+    if (qfp->qf_user_data.v_type != VAR_UNKNOWN) {
+      // Equal, but use the new value like a new entry would.
+      tv_clear(&qfp->qf_user_data);
+      tv_dict_get_tv(d, "user_data", &qfp->qf_user_data);
+      qfl->qf_has_user_data = true;
+    }
+    qf_link_entry(qfl, qfp);
+    return true;
+  }
+  return false;
+}
+
 /// Add list of entries to quickfix/location list. Each list entry is
 /// a dictionary with item information.
 static int qf_add_entries(qf_info_T *qi, int qf_idx, list_T *list, char *title, int action)
 {
   qf_list_T *qfl = qf_get_list(qi, qf_idx);
   qfline_T *old_last = NULL;
+  qfline_T **reuse = NULL;  // old entries that can be kept for 'u'
+  int reuse_count = 0;
   int retval = OK;
   bool valid_entry = false;
 
@@ -6731,7 +7259,7 @@ static int qf_add_entries(qf_info_T *qi, int qf_idx, list_T *list, char *title,
   int prev_col = 0;
   if (qfl->qf_ptr) {
     prev_fnum = qfl->qf_ptr->qf_fnum;
-    prev_lnum = qfl->qf_ptr->qf_lnum;
+    prev_lnum = qf_entry_lnum(qfl->qf_ptr);
     prev_col = qfl->qf_ptr->qf_col;
   }
 
@@ -6758,14 +7286,27 @@ static int qf_add_entries(qf_info_T *qi, int qf_idx, list_T *list, char *title,
     qf_store_title(qfl, title);
   } else if (action == 'u') {
     select_nearest_entry = true;
+    // Take out the old entries to keep those that didn't change, often most
+    // of them when a plugin updates its list.
+    if (qf_entries_valid(qfl)) {
+      reuse_count = qfl->qf_count;
+      reuse = xmemdup(qfl->qf_entries.items, (size_t)reuse_count * sizeof(*reuse));
+      kv_destroy(qfl->qf_entries);
+      qfl->qf_count = 0;
+      qfl->qf_start = NULL;
+    }
     qf_free_items(qfl);
     qf_store_title(qfl, title);
   }
 
   qfline_T *entry_to_select = NULL;
   int entry_to_select_index = 0;
+  const int len = tv_list_len(list);
+  int idx = 0;
+  bool first_add = true;
 
   TV_LIST_ITER_CONST(list, li, {
+    const int cur_idx = idx++;
     if (TV_LIST_ITEM_TV(li)->v_type != VAR_DICT) {
       continue;  // Skip non-dict items.
     }
@@ -6775,9 +7316,16 @@ static int qf_add_entries(qf_info_T *qi, int qf_idx, list_T *list, char *title,
       continue;
     }
 
-    retval = qf_add_entry_from_dict(qfl, d, li == tv_list_first(list), &valid_entry);
-    if (retval == QF_FAIL) {
-      break;
+    if (reuse != NULL && qf_reuse_entry(qfl, reuse, reuse_count, cur_idx, len, d)) {
+      if (qfl->qf_last->qf_valid) {
+        valid_entry = true;
+      }
+    } else {
+      retval = qf_add_entry_from_dict(qfl, d, first_add, &valid_entry);
+      first_add = false;
+      if (retval == QF_FAIL) {
+        break;
+      }
     }
 
     qfline_T *entry = qfl->qf_last;
@@ -6791,6 +7339,15 @@ static int qf_add_entries(qf_info_T *qi, int qf_idx, list_T *list, char *title,
     }
   });
 
+  if (reuse != NULL) {
+    for (int i = 0; i < reuse_count; i++) {
+      if (reuse[i] != NULL) {
+        qf_free_entry(reuse[i]);
+      }
+    }
+    xfree(reuse);
+  }
+
   // Check if any valid error entries are added to the list.
   if (valid_entry) {
     qfl->qf_nonevalid = false;
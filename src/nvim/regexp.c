@@ -17,6 +17,7 @@
 #include <uv.h>
 
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
 #include "nvim/errors.h"
@@ -29,6 +30,7 @@
 #include "nvim/globals.h"
 #include "nvim/keycodes.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
@@ -59,6 +61,11 @@ enum {
   NFA_MAX_BRACES = 20,
 };
 
+enum {
+  /// Number of lines in the window of reg_getline_common().
+  REG_LINEWIN_SIZE = 32,
+};
+
 enum {
   /// In the NFA engine: how many states are allowed.
   NFA_MAX_STATES = 100000,
@@ -71,6 +78,7 @@ enum {
   AUTOMATIC_ENGINE    = 0,
   BACKTRACKING_ENGINE = 1,
   NFA_ENGINE          = 2,
+  DFA_ENGINE          = 3,  ///< NFA engine with a lazily built DFA
 };
 
 /// Structure returned by vim_regcomp() to pass on to vim_regexec().
@@ -82,18 +90,20 @@ struct regprog {
   unsigned re_engine;  ///< Automatic, backtracking or NFA engine.
   unsigned re_flags;   ///< Second argument for vim_regcomp().
   bool re_in_use;      ///< prog is being executed
+  int re_refcount;     ///< references when in the regprog cache, zero otherwise
 };
 
 /// Structure used by the back track matcher.
 /// These fields are only to be used in regexp.c!
 /// See regexp.c for an explanation.
 typedef struct {
-  // These four members implement regprog_T.
+  // These members implement regprog_T.
   regengine_T *engine;
   unsigned regflags;
   unsigned re_engine;
   unsigned re_flags;
   bool re_in_use;
+  int re_refcount;
 
   int regstart;
   uint8_t reganch;
@@ -115,20 +125,27 @@ struct nfa_state {
   int val;
 };
 
+typedef struct nfa_dfa nfa_dfa_T;
+
 /// Structure used by the NFA matcher.
 typedef struct {
-  // These four members implement regprog_T.
+  // These members implement regprog_T.
   regengine_T *engine;
   unsigned regflags;
   unsigned re_engine;
   unsigned re_flags;
   bool re_in_use;
+  int re_refcount;
 
   nfa_state_T *start;   ///< points into state[]
 
   int reganch;          ///< pattern starts with ^
   int regstart;         ///< char at start of pattern
   uint8_t *match_text;  ///< plain text to match with
+  uint8_t *regmust;     ///< text that every match must contain or NULL
+  int regmlen;          ///< length of regmust
+  bool dfa_ok;          ///< pattern can be checked with the lazy DFA
+  nfa_dfa_T *dfa;       ///< lazily built DFA or NULL
 
   int has_zend;         ///< pattern contains \ze
   int has_backref;      ///< pattern contains \1 .. \9
@@ -656,6 +673,13 @@ int re_multiline(const regprog_T *prog)
   return prog->regflags & RF_HASNL;
 }
 
+// Return true if compiled regular expression "prog" uses "\@<=" or "\@<!".
+int re_lookbehind(const regprog_T *prog)
+  FUNC_ATTR_NONNULL_ALL
+{
+  return prog->regflags & RF_LOOKBH;
+}
+
 // Check for an equivalence class name "[=a=]".  "pp" points to the '['.
 // Returns a character representing the class. Zero means that no item was
 // recognized.  Otherwise "pp" is advanced to after the item.
@@ -1283,6 +1307,17 @@ typedef struct {
   int nfa_alt_listid;
 
   int nfa_has_zsubexpr;  ///< NFA regexp has \z( ), set zsubexpr.
+
+  // Window of lines taken directly from a memline data block, so that
+  // multi-line matching does not need to call ml_get_buf() for each line.
+  struct {
+    linenr_T first;          ///< first line, relative to reg_firstlnum
+    int count;               ///< number of lines, zero when empty
+    const void *block;       ///< data block the lines are in
+    varnumber_T changedtick;  ///< b:changedtick when the lines were taken
+    char *lines[REG_LINEWIN_SIZE];
+    colnr_T lens[REG_LINEWIN_SIZE];
+  } linewin;
 } regexec_T;
 
 static regexec_T rex;
@@ -1317,6 +1352,36 @@ typedef struct {
 
 static regsubmatch_T rsm;  ///< can only be used when can_f_submatch is true
 
+/// Get line "lnum", relative to rex.reg_firstlnum, through the line window.
+/// Fills the window with the following lines when "lnum" is not in it.
+///
+/// @return  false when the window can't be used.
+static bool reg_linewin_get(linenr_T lnum, char **line, colnr_T *length)
+{
+  if (lnum < rex.linewin.first || lnum >= rex.linewin.first + rex.linewin.count
+      || ml_get_locked_block(rex.reg_buf) != rex.linewin.block
+      || buf_get_changedtick(rex.reg_buf) != rex.linewin.changedtick) {
+    const int maxlines = (int)MIN(REG_LINEWIN_SIZE, rex.reg_maxline - lnum + 1);
+    rex.linewin.count = ml_get_buf_lines(rex.reg_buf, rex.reg_firstlnum + lnum, maxlines,
+                                         rex.linewin.lines, rex.linewin.lens);
+    if (rex.linewin.count == 0) {
+      return false;
+    }
+    rex.linewin.first = lnum;
+    rex.linewin.block = ml_get_locked_block(rex.reg_buf);
+    rex.linewin.changedtick = buf_get_changedtick(rex.reg_buf);
+  }
+
+  const int idx = lnum - rex.linewin.first;
+  if (line != NULL) {
+    *line = rex.linewin.lines[idx];
+  }
+  if (length != NULL) {
+    *length = rex.linewin.lens[idx];
+  }
+  return true;
+}
+
 /// Common code for reg_getline(), reg_getline_len(), reg_getline_submatch() and
 /// reg_getline_submatch_len().
 ///
@@ -1363,6 +1428,11 @@ static void reg_getline_common(linenr_T lnum, reg_getline_flags_T flags, char **
     return;
   }
 
+  if (!(flags & RGLF_SUBMATCH)
+      && reg_linewin_get(lnum, get_line ? line : NULL, get_length ? length : NULL)) {
+    return;
+  }
+
   if (get_line) {
     *line = ml_get_buf(rex.reg_buf, firstlnum);
   }
@@ -2650,6 +2720,7 @@ static void init_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_
   rex.reg_icombine = false;
   rex.reg_nobreak = rmp->regprog->re_flags & RE_NOBREAK;
   rex.reg_maxcol = rmp->rmm_maxcol;
+  rex.linewin.count = 0;
 }
 
 // regexp_bt.c {{{1
@@ -4502,7 +4573,7 @@ static uint8_t *regatom(int *flagp)
       break;
 
     case '#':
-      if (regparse[0] == '=' && regparse[1] >= 48 && regparse[1] <= 50) {
+      if (regparse[0] == '=' && regparse[1] >= 48 && regparse[1] <= 51) {
         // misplaced \%#=1
         semsg(_(e_atom_engine_must_be_at_start_of_pattern), regparse[1]);
         return FAIL;
@@ -7540,6 +7611,402 @@ static int regtry(bt_regprog_T *prog, colnr_T col, proftime_T *tm, int *timed_ou
   return 1 + rex.lnum;
 }
 
+/// A state of the lazily built DFA: the set of NFA states the simulation can
+/// be in at some position.  The transitions for ASCII characters are
+/// computed the first time they are taken.
+typedef struct {
+  int *nstates;      ///< sorted indexes into nfa_regprog_T.state[]
+  int nlen;
+  bool has_match;    ///< the set contains NFA_MATCH
+  int8_t eol_match;  ///< -1: not computed yet, otherwise "$" leads to a match
+  int next[128];     ///< next DFA state for an ASCII char, -1: not computed yet
+} nfa_dfa_state_T;
+
+/// Lazily built DFA for an NFA program.  It only tells whether a line can
+/// contain a match, without submatch positions.
+struct nfa_dfa {
+  Map(String, int) index;  ///< NFA state set -> index in "states" + 1
+  garray_T states;          ///< nfa_dfa_state_T pointers
+  size_t mem;               ///< memory used, limited by 'maxmempattern'
+  bool ic;                  ///< value of rex.reg_ic the transitions are for
+  bool failed;              ///< hit the memory limit, only use the NFA
+  int start_bol;            ///< initial state at the start of a line or -1
+  int start;                ///< initial state elsewhere or -1
+  int *seen;                ///< per NFA state: "gen" when added to the set
+  int gen;
+  garray_T stack;           ///< scratch stack of NFA states
+  garray_T set;             ///< scratch set of NFA states
+};
+
+/// Check whether all states of "prog" can be simulated by the lazy DFA: no
+/// backreferences, look-around, "\zs", composing characters or items that
+/// depend on options or the cursor position.
+static bool nfa_dfa_supported(nfa_regprog_T *prog)
+{
+  for (int i = 0; i < prog->nstate; i++) {
+    int c = prog->state[i].c;
+    if (c > 0) {
+      continue;
+    }
+    switch (c) {
+    case NFA_SPLIT:
+    case NFA_MATCH:
+    case NFA_EMPTY:
+    case NFA_START_COLL:
+    case NFA_END_COLL:
+    case NFA_START_NEG_COLL:
+    case NFA_RANGE_MIN:
+    case NFA_RANGE_MAX:
+    case NFA_BOL:
+    case NFA_EOL:
+    case NFA_NOPEN:
+    case NFA_NCLOSE:
+    case NFA_ANY:
+    case NFA_WHITE:
+    case NFA_NWHITE:
+    case NFA_DIGIT:
+    case NFA_NDIGIT:
+    case NFA_HEX:
+    case NFA_NHEX:
+    case NFA_OCTAL:
+    case NFA_NOCTAL:
+    case NFA_WORD:
+    case NFA_NWORD:
+    case NFA_HEAD:
+    case NFA_NHEAD:
+    case NFA_ALPHA:
+    case NFA_NALPHA:
+    case NFA_LOWER:
+    case NFA_NLOWER:
+    case NFA_UPPER:
+    case NFA_NUPPER:
+    case NFA_LOWER_IC:
+    case NFA_NLOWER_IC:
+    case NFA_UPPER_IC:
+    case NFA_NUPPER_IC:
+    case NFA_CLASS_ALNUM:
+    case NFA_CLASS_ALPHA:
+    case NFA_CLASS_BLANK:
+    case NFA_CLASS_CNTRL:
+    case NFA_CLASS_DIGIT:
+    case NFA_CLASS_GRAPH:
+    case NFA_CLASS_LOWER:
+    case NFA_CLASS_PUNCT:
+    case NFA_CLASS_SPACE:
+    case NFA_CLASS_UPPER:
+    case NFA_CLASS_XDIGIT:
+    case NFA_CLASS_TAB:
+    case NFA_CLASS_RETURN:
+    case NFA_CLASS_BACKSPACE:
+    case NFA_CLASS_ESCAPE:
+      break;
+    default:
+      if ((c >= NFA_MOPEN && c <= NFA_MOPEN9)
+          || (c >= NFA_MCLOSE && c <= NFA_MCLOSE9)) {
+        break;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+static void nfa_dfa_clear(nfa_dfa_T *dfa)
+{
+  for (int i = 0; i < dfa->states.ga_len; i++) {
+    nfa_dfa_state_T *ds = ((nfa_dfa_state_T **)dfa->states.ga_data)[i];
+    xfree(ds->nstates);
+    xfree(ds);
+  }
+  dfa->states.ga_len = 0;
+  map_destroy(String, &dfa->index);
+  dfa->mem = 0;
+  dfa->start_bol = -1;
+  dfa->start = -1;
+}
+
+static void nfa_dfa_free(nfa_dfa_T *dfa)
+{
+  if (dfa == NULL) {
+    return;
+  }
+  nfa_dfa_clear(dfa);
+  ga_clear(&dfa->states);
+  ga_clear(&dfa->stack);
+  ga_clear(&dfa->set);
+  xfree(dfa->seen);
+  xfree(dfa);
+}
+
+/// Add NFA state "state" and the states reachable from it without consuming
+/// a character to dfa->set.  Only states that consume a character, NFA_MATCH
+/// and a "$" that does not match yet are stored.
+static void nfa_dfa_addstate(nfa_regprog_T *prog, nfa_dfa_T *dfa, nfa_state_T *state,
+                             bool at_bol, bool at_eol)
+{
+  GA_APPEND(nfa_state_T *, &dfa->stack, state);
+
+  while (dfa->stack.ga_len > 0) {
+    nfa_state_T *s = ((nfa_state_T **)dfa->stack.ga_data)[--dfa->stack.ga_len];
+    const int idx = (int)(s - prog->state);
+    if (dfa->seen[idx] == dfa->gen) {
+      continue;
+    }
+    dfa->seen[idx] = dfa->gen;
+
+    nfa_state_T *out = NULL;
+    nfa_state_T *out1 = NULL;
+    if (s->c == NFA_SPLIT) {
+      out = s->out;
+      out1 = s->out1;
+    } else if (s->c == NFA_EMPTY || s->c == NFA_NOPEN || s->c == NFA_NCLOSE
+               || (s->c >= NFA_MOPEN && s->c <= NFA_MCLOSE9)) {
+      out = s->out;
+    } else if (s->c == NFA_BOL) {
+      if (at_bol) {
+        out = s->out;
+      }
+    } else if (s->c == NFA_EOL && at_eol) {
+      out = s->out;
+    } else {
+      GA_APPEND(int, &dfa->set, idx);
+    }
+    // push "out1" first, so that "out" is handled first
+    if (out1 != NULL) {
+      GA_APPEND(nfa_state_T *, &dfa->stack, out1);
+    }
+    if (out != NULL) {
+      GA_APPEND(nfa_state_T *, &dfa->stack, out);
+    }
+  }
+}
+
+static int nfa_dfa_int_cmp(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+/// Find or create the DFA state for the NFA states in dfa->set.
+/// Returns its index or -1 when the memory limit was reached.
+static int nfa_dfa_getstate(nfa_regprog_T *prog, nfa_dfa_T *dfa)
+{
+  qsort(dfa->set.ga_data, (size_t)dfa->set.ga_len, sizeof(int), nfa_dfa_int_cmp);
+  String key = { .data = dfa->set.ga_data, .size = (size_t)dfa->set.ga_len * sizeof(int) };
+  int idx = map_get(String, int)(&dfa->index, key);
+  if (idx > 0) {
+    return idx - 1;
+  }
+
+  const size_t size = sizeof(nfa_dfa_state_T) + key.size;
+  if ((int64_t)((dfa->mem + size) >> 10) >= p_mmp) {
+    dfa->failed = true;
+    return -1;
+  }
+  dfa->mem += size;
+
+  nfa_dfa_state_T *ds = xmalloc(sizeof(nfa_dfa_state_T));
+  ds->nstates = xmemdup(dfa->set.ga_data, key.size);
+  ds->nlen = dfa->set.ga_len;
+  ds->has_match = false;
+  ds->eol_match = -1;
+  memset(ds->next, -1, sizeof(ds->next));
+  for (int i = 0; i < ds->nlen; i++) {
+    if (prog->state[ds->nstates[i]].c == NFA_MATCH) {
+      ds->has_match = true;
+    }
+  }
+
+  key.data = (char *)ds->nstates;
+  GA_APPEND(nfa_dfa_state_T *, &dfa->states, ds);
+  map_put(String, int)(&dfa->index, key, dfa->states.ga_len);
+  return dfa->states.ga_len - 1;
+}
+
+/// Check whether character "c" matches NFA state "state", the same way as
+/// nfa_regmatch() does for the states accepted by nfa_dfa_supported().
+static bool nfa_dfa_char_match(const nfa_state_T *state, int c)
+{
+  switch (state->c) {
+  case NFA_START_COLL:
+  case NFA_START_NEG_COLL: {
+    const bool result_if_matched = state->c == NFA_START_COLL;
+    for (const nfa_state_T *s = state->out; s->c != NFA_END_COLL; s = s->out) {
+      if (s->c == NFA_RANGE_MIN) {
+        int c1 = s->val;
+        s = s->out;  // advance to NFA_RANGE_MAX
+        const int c2 = s->val;
+        if (c >= c1 && c <= c2) {
+          return result_if_matched;
+        }
+        if (rex.reg_ic) {
+          const int curc_low = utf_fold(c);
+          for (; c1 <= c2; c1++) {
+            if (utf_fold(c1) == curc_low) {
+              return result_if_matched;
+            }
+          }
+        }
+      } else if (s->c < 0 ? check_char_class(s->c, c)
+                          : (c == s->c || (rex.reg_ic && utf_fold(c) == utf_fold(s->c)))) {
+        return result_if_matched;
+      }
+    }
+    return !result_if_matched;
+  }
+  case NFA_ANY:
+    return true;
+  case NFA_WHITE:
+    return ascii_iswhite(c);
+  case NFA_NWHITE:
+    return !ascii_iswhite(c);
+  case NFA_DIGIT:
+    return ri_digit(c);
+  case NFA_NDIGIT:
+    return !ri_digit(c);
+  case NFA_HEX:
+    return ri_hex(c);
+  case NFA_NHEX:
+    return !ri_hex(c);
+  case NFA_OCTAL:
+    return ri_octal(c);
+  case NFA_NOCTAL:
+    return !ri_octal(c);
+  case NFA_WORD:
+    return ri_word(c);
+  case NFA_NWORD:
+    return !ri_word(c);
+  case NFA_HEAD:
+    return ri_head(c);
+  case NFA_NHEAD:
+    return !ri_head(c);
+  case NFA_ALPHA:
+    return ri_alpha(c);
+  case NFA_NALPHA:
+    return !ri_alpha(c);
+  case NFA_LOWER:
+    return ri_lower(c);
+  case NFA_NLOWER:
+    return !ri_lower(c);
+  case NFA_UPPER:
+    return ri_upper(c);
+  case NFA_NUPPER:
+    return !ri_upper(c);
+  case NFA_LOWER_IC:
+    return ri_lower(c) || (rex.reg_ic && ri_upper(c));
+  case NFA_NLOWER_IC:
+    return !(ri_lower(c) || (rex.reg_ic && ri_upper(c)));
+  case NFA_UPPER_IC:
+    return ri_upper(c) || (rex.reg_ic && ri_lower(c));
+  case NFA_NUPPER_IC:
+    return !(ri_upper(c) || (rex.reg_ic && ri_lower(c)));
+  default:
+    if (state->c > 0) {
+      return state->c == c || (rex.reg_ic && utf_fold(state->c) == utf_fold(c));
+    }
+    return false;  // NFA_MATCH or "$"
+  }
+}
+
+/// Compute the DFA state that follows DFA state "from" for character "c".
+/// Returns -1 when the memory limit was reached.
+static int nfa_dfa_step(nfa_regprog_T *prog, nfa_dfa_T *dfa, const nfa_dfa_state_T *from, int c)
+{
+  dfa->set.ga_len = 0;
+  dfa->gen++;
+  for (int i = 0; i < from->nlen; i++) {
+    nfa_state_T *s = &prog->state[from->nstates[i]];
+    if (nfa_dfa_char_match(s, c)) {
+      bool is_coll = s->c == NFA_START_COLL || s->c == NFA_START_NEG_COLL;
+      nfa_dfa_addstate(prog, dfa, is_coll ? s->out1->out : s->out, false, false);
+    }
+  }
+  // A match may also start at the next position.
+  nfa_dfa_addstate(prog, dfa, prog->start, false, false);
+  return nfa_dfa_getstate(prog, dfa);
+}
+
+/// Check whether a "$" in DFA state "ds" leads to a match.
+static bool nfa_dfa_eol_match(nfa_regprog_T *prog, nfa_dfa_T *dfa, nfa_dfa_state_T *ds)
+{
+  if (ds->eol_match < 0) {
+    dfa->set.ga_len = 0;
+    dfa->gen++;
+    for (int i = 0; i < ds->nlen; i++) {
+      nfa_state_T *s = &prog->state[ds->nstates[i]];
+      if (s->c == NFA_EOL) {
+        // Passing "at_bol" may give a false positive for "$^", that is OK,
+        // the NFA will find out.
+        nfa_dfa_addstate(prog, dfa, s->out, true, true);
+      }
+    }
+    ds->eol_match = false;
+    for (int i = 0; i < dfa->set.ga_len; i++) {
+      if (prog->state[((int *)dfa->set.ga_data)[i]].c == NFA_MATCH) {
+        ds->eol_match = true;
+        break;
+      }
+    }
+  }
+  return ds->eol_match;
+}
+
+/// Use the lazy DFA of "prog" to check whether rex.line can contain a match
+/// starting at or after column "col".
+///
+/// @return  false if there is no match, true if there may be one.
+static bool nfa_dfa_may_match(nfa_regprog_T *prog, colnr_T col)
+{
+  nfa_dfa_T *dfa = prog->dfa;
+  if (dfa == NULL) {
+    dfa = prog->dfa = xcalloc(1, sizeof(nfa_dfa_T));
+    ga_init(&dfa->states, (int)sizeof(nfa_dfa_state_T *), 16);
+    ga_init(&dfa->stack, (int)sizeof(nfa_state_T *), 16);
+    ga_init(&dfa->set, (int)sizeof(int), 16);
+    dfa->seen = xcalloc((size_t)prog->nstate, sizeof(int));
+    dfa->ic = rex.reg_ic;
+    dfa->start_bol = -1;
+    dfa->start = -1;
+  }
+  if (dfa->failed) {
+    return true;
+  }
+  if (dfa->ic != rex.reg_ic) {
+    // Transitions depend on 'ignorecase', start over.
+    nfa_dfa_clear(dfa);
+    dfa->ic = rex.reg_ic;
+  }
+
+  int *startp = col == 0 ? &dfa->start_bol : &dfa->start;
+  if (*startp < 0) {
+    dfa->set.ga_len = 0;
+    dfa->gen++;
+    nfa_dfa_addstate(prog, dfa, prog->start, col == 0, false);
+    *startp = nfa_dfa_getstate(prog, dfa);
+  }
+
+  int cur = *startp;
+  for (const uint8_t *p = rex.line + col;; p++) {
+    if (cur < 0) {
+      return true;  // out of memory, let the NFA do the work
+    }
+    nfa_dfa_state_T *ds = ((nfa_dfa_state_T **)dfa->states.ga_data)[cur];
+    if (ds->has_match) {
+      return true;
+    }
+    const int c = *p;
+    if (c == NUL) {
+      return nfa_dfa_eol_match(prog, dfa, ds);
+    }
+    if (c >= 0x80) {
+      return true;  // multibyte and composing characters are left to the NFA
+    }
+    if (ds->next[c] < 0) {
+      ds->next[c] = nfa_dfa_step(prog, dfa, ds, c);
+    }
+    cur = ds->next[c];
+  }
+}
+
 /// Match a regexp against a string ("line" points to the string) or multiple
 /// lines (if "line" is NULL, use reg_getline()).
 ///
@@ -8747,6 +9214,211 @@ static uint8_t *nfa_get_match_text(nfa_state_T *start)
   return ret;
 }
 
+/// Literal information about a fragment of the postfix form, used by
+/// nfa_get_regmust().  Offsets are into the buffer holding the bytes of all
+/// literal characters of the pattern, in the order they appear.
+typedef struct {
+  bool exact;     ///< fragment only matches the text "pre"
+  int pre_start;  ///< every match starts with this text
+  int pre_len;
+  int suf_start;  ///< every match ends with this text
+  int suf_len;
+  int must_start;  ///< every match contains this text
+  int must_len;
+} nfa_lit_T;
+
+/// Find the longest literal text that every match of the postfix form
+/// "postfix" .. "end" must contain.  This makes it possible to reject a line
+/// that cannot match with a fast substring search, before doing the much
+/// more expensive state-set simulation.
+///
+/// @param[out] lenp  set to the byte length of the returned text
+///
+/// @return the text in allocated memory or NULL if there is none.
+static uint8_t *nfa_get_regmust(const int *postfix, const int *end, int *lenp)
+{
+  garray_T lits;
+  ga_init(&lits, 1, 64);
+  nfa_lit_T *stack = xmalloc((size_t)(end - postfix + 1) * sizeof(nfa_lit_T));
+  nfa_lit_T *sp = stack;
+  nfa_lit_T e1;
+  nfa_lit_T e2;
+  uint8_t *ret = NULL;
+
+#define LIT_UNKNOWN() ((nfa_lit_T){ .exact = false })
+#define LIT_EMPTY() ((nfa_lit_T){ .exact = true, .pre_start = lits.ga_len, \
+                                  .suf_start = lits.ga_len, .must_start = lits.ga_len })
+#define LIT_PUSH(e) (*sp++ = (e))
+#define LIT_POP(e) \
+  do { \
+    if (sp == stack) { \
+      goto theend; \
+    } \
+    (e) = *--sp; \
+  } while (0)
+
+  for (const int *p = postfix; p < end; p++) {
+    switch (*p) {
+    case NFA_CONCAT: {
+      nfa_lit_T e;
+      LIT_POP(e2);
+      LIT_POP(e1);
+      e.exact = e1.exact && e2.exact;
+      e.pre_start = e1.pre_start;
+      e.pre_len = e1.exact ? e1.pre_len + e2.pre_len : e1.pre_len;
+      e.suf_start = e2.exact && e1.suf_len > 0 ? e1.suf_start : e2.suf_start;
+      e.suf_len = e2.exact ? e1.suf_len + e2.suf_len : e2.suf_len;
+      if (e.exact) {
+        e.must_start = e.pre_start;
+        e.must_len = e.pre_len;
+      } else {
+        // The text where the two fragments meet is also required.
+        e.must_start = e1.suf_len > 0 ? e1.suf_start : e2.pre_start;
+        e.must_len = e1.suf_len + e2.pre_len;
+        if (e1.must_len > e.must_len) {
+          e.must_start = e1.must_start;
+          e.must_len = e1.must_len;
+        }
+        if (e2.must_len >= e.must_len) {
+          e.must_start = e2.must_start;
+          e.must_len = e2.must_len;
+        }
+      }
+      LIT_PUSH(e);
+      break;
+    }
+
+    case NFA_OR:
+    case NFA_RANGE:
+      LIT_POP(e2);
+      LIT_POP(e1);
+      LIT_PUSH(LIT_UNKNOWN());
+      break;
+
+    case NFA_STAR:
+    case NFA_STAR_NONGREEDY:
+    case NFA_QUEST:
+    case NFA_QUEST_NONGREEDY:
+    case NFA_END_COLL:
+    case NFA_END_NEG_COLL:
+    case NFA_COMPOSING:
+    case NFA_PREV_ATOM_NO_WIDTH:
+    case NFA_PREV_ATOM_NO_WIDTH_NEG:
+    case NFA_PREV_ATOM_LIKE_PATTERN:
+      LIT_POP(e1);
+      LIT_PUSH(LIT_UNKNOWN());
+      break;
+
+    case NFA_PREV_ATOM_JUST_BEFORE:
+    case NFA_PREV_ATOM_JUST_BEFORE_NEG:
+      // A look-behind may look before the start column.
+      p++;  // skip the count
+      LIT_POP(e1);
+      LIT_PUSH(LIT_UNKNOWN());
+      break;
+
+    case NFA_OPT_CHARS: {
+      int n = *++p;
+      while (n-- > 0) {
+        LIT_POP(e1);
+      }
+      LIT_PUSH(LIT_UNKNOWN());
+      break;
+    }
+
+    case NFA_NEWL:
+      // A match may span lines, only the first line would be checked.
+      goto theend;
+
+    case NFA_MOPEN:
+    case NFA_MOPEN1:
+    case NFA_MOPEN2:
+    case NFA_MOPEN3:
+    case NFA_MOPEN4:
+    case NFA_MOPEN5:
+    case NFA_MOPEN6:
+    case NFA_MOPEN7:
+    case NFA_MOPEN8:
+    case NFA_MOPEN9:
+    case NFA_ZOPEN:
+    case NFA_ZOPEN1:
+    case NFA_ZOPEN2:
+    case NFA_ZOPEN3:
+    case NFA_ZOPEN4:
+    case NFA_ZOPEN5:
+    case NFA_ZOPEN6:
+    case NFA_ZOPEN7:
+    case NFA_ZOPEN8:
+    case NFA_ZOPEN9:
+    case NFA_NOPEN:
+      // A submatch matches the same text as what it contains.  An empty
+      // submatch is pushed without popping, see post2nfa().
+      if (sp == stack) {
+        LIT_PUSH(LIT_EMPTY());
+      }
+      break;
+
+    case NFA_EMPTY:
+    case NFA_BOL:
+    case NFA_EOL:
+    case NFA_BOW:
+    case NFA_EOW:
+    case NFA_BOF:
+    case NFA_EOF:
+    case NFA_ZSTART:
+    case NFA_ZEND:
+    case NFA_CURSOR:
+    case NFA_VISUAL:
+      // zero-width items do not interrupt the literal text
+      LIT_PUSH(LIT_EMPTY());
+      break;
+
+    case NFA_LNUM:
+    case NFA_LNUM_GT:
+    case NFA_LNUM_LT:
+    case NFA_VCOL:
+    case NFA_VCOL_GT:
+    case NFA_VCOL_LT:
+    case NFA_COL:
+    case NFA_COL_GT:
+    case NFA_COL_LT:
+    case NFA_MARK:
+    case NFA_MARK_GT:
+    case NFA_MARK_LT:
+      p++;  // skip the lnum, col or mark name
+      LIT_PUSH(LIT_UNKNOWN());
+      break;
+
+    default:
+      if (*p > 0) {
+        nfa_lit_T e = LIT_EMPTY();
+        ga_grow(&lits, MB_MAXBYTES);
+        e.pre_len = utf_char2bytes(*p, (char *)lits.ga_data + lits.ga_len);
+        lits.ga_len += e.pre_len;
+        e.suf_len = e.must_len = e.pre_len;
+        LIT_PUSH(e);
+      } else {
+        LIT_PUSH(LIT_UNKNOWN());
+      }
+      break;
+    }
+  }
+
+  if (sp == stack + 1 && stack->must_len > 0) {
+    *lenp = stack->must_len;
+    ret = (uint8_t *)xmemdupz((char *)lits.ga_data + stack->must_start, (size_t)stack->must_len);
+  }
+
+theend:
+#undef LIT_UNKNOWN
+#undef LIT_EMPTY
+#undef LIT_PUSH
+#undef LIT_POP
+  xfree(stack);
+  ga_clear(&lits);
+  return ret;
+}
+
 // Allocate more space for post_start.  Called when
 // running above the estimated number of states.
 static void realloc_post_list(void)
@@ -10273,7 +10945,7 @@ static int nfa_regatom(void)
 
     case '#':
       if (regparse[0] == '=' && regparse[1] >= 48
-          && regparse[1] <= 50) {
+          && regparse[1] <= 51) {
         // misplaced \%#=1
         semsg(_(e_atom_engine_must_be_at_start_of_pattern), regparse[1]);
         return FAIL;
@@ -11626,6 +12298,9 @@ static void nfa_dump(nfa_regprog_T *prog)
   if (prog->match_text != NULL) {
     fprintf(debugf, "match_text: \"%s\"\n", prog->match_text);
   }
+  if (prog->regmust != NULL) {
+    fprintf(debugf, "regmust: \"%s\"\n", prog->regmust);
+  }
 
   fclose(debugf);
 }
@@ -14017,6 +14692,27 @@ static int skip_to_start(int c, colnr_T *colp)
   return OK;
 }
 
+/// Check whether "regmust" appears in the current line at or after "col".
+/// Uses strstr() when case matters, it is much faster than a character loop.
+static bool find_regmust(const uint8_t *regmust, int regmlen, colnr_T col)
+{
+  const char *s = (char *)rex.line + col;
+
+  if (!rex.reg_ic) {
+    return strstr(s, (char *)regmust) != NULL;
+  }
+
+  const int c = utf_ptr2char((char *)regmust);
+  while ((s = cstrchr(s, c)) != NULL) {
+    int len = regmlen;
+    if (cstrncmp((char *)s, (char *)regmust, &len) == 0) {
+      return true;
+    }
+    MB_PTR_ADV(s);
+  }
+  return false;
+}
+
 // Check for a match with match_text.
 // Called after skip_to_start() has found regstart.
 // Returns zero for no match, 1 for a match.
@@ -15700,6 +16396,22 @@ static int nfa_regexec_both(uint8_t *line, colnr_T startcol, proftime_T *tm, int
     rex.need_clear_zsubexpr = false;
   }
 
+  // If there is a "must appear" text, quickly reject a line without it.
+  // Doesn't handle combining chars well.
+  if (prog->regmust != NULL && !rex.reg_icombine
+      && !find_regmust(prog->regmust, prog->regmlen, col)) {
+    goto theend;
+  }
+
+  // The lazy DFA can tell quickly that there is no match in this line at all.
+  // When it may match the NFA still needs to find the submatches.
+  if (prog->dfa_ok
+      && (prog->re_engine == AUTOMATIC_ENGINE || prog->re_engine == DFA_ENGINE)
+      && !rex.reg_line_lbr && !rex.reg_icombine && rex.reg_maxcol == 0
+      && !nfa_dfa_may_match(prog, col)) {
+    goto theend;
+  }
+
   if (prog->regstart != NUL) {
     // Skip ahead until a character we know the match must start with.
     // When there is none there is no match.
@@ -15838,6 +16550,13 @@ static regprog_T *nfa_regcomp(uint8_t *expr, int re_flags)
   prog->reganch = nfa_get_reganch(prog->start, 0);
   prog->regstart = nfa_get_regstart(prog->start, 0);
   prog->match_text = nfa_get_match_text(prog->start);
+  prog->regmust = NULL;
+  prog->regmlen = 0;
+  if (prog->match_text == NULL) {
+    prog->regmust = nfa_get_regmust(postfix, post_ptr, &prog->regmlen);
+  }
+  prog->dfa_ok = nfa_dfa_supported(prog);
+  prog->dfa = NULL;
 
 #ifdef REGEXP_DEBUG
   nfa_postfix_dump(expr, OK);
@@ -15873,6 +16592,8 @@ static void nfa_regfree(regprog_T *prog)
   }
 
   xfree(((nfa_regprog_T *)prog)->match_text);
+  xfree(((nfa_regprog_T *)prog)->regmust);
+  nfa_dfa_free(((nfa_regprog_T *)prog)->dfa);
   xfree(((nfa_regprog_T *)prog)->pattern);
   xfree(prog);
 }
@@ -15972,15 +16693,111 @@ static int regexp_engine = 0;
 static uint8_t regname[][30] = {
   "AUTOMATIC Regexp Engine",
   "BACKTRACKING Regexp Engine",
-  "NFA Regexp Engine"
+  "NFA Regexp Engine",
+  "Lazy DFA Regexp Engine"
 };
 #endif
 
-// Compile a regular expression into internal code.
-// Returns the program in allocated memory.
-// Use vim_regfree() to free the memory.
-// Returns NULL for an error.
+enum {
+  /// Number of compiled patterns kept by vim_regcomp().
+  REGPROG_CACHE_SIZE = 32,
+};
+
+/// Entry of the cache of compiled patterns.  Besides the pattern and flags
+/// the key holds the global state that regcomp() depends on.
+typedef struct {
+  char *pattern;
+  int re_flags;
+  int engine;       ///< 'regexpengine'
+  int extmatch;     ///< reg_do_extmatch
+  bool cpo_lit;     ///< 'cpoptions' contains 'l'
+  regprog_T *prog;  ///< holds one reference
+} regprog_cache_T;
+
+/// Most recently used entry first.
+static regprog_cache_T regprog_cache[REGPROG_CACHE_SIZE];
+static int regprog_cache_len = 0;
+
+/// Drop the reference of the cache entry at "idx" and remove it.
+static void regprog_cache_del(int idx)
+{
+  regprog_cache_T *entry = &regprog_cache[idx];
+  xfree(entry->pattern);
+  vim_regfree(entry->prog);
+  regprog_cache_len--;
+  memmove(entry, entry + 1, (size_t)(regprog_cache_len - idx) * sizeof(*entry));
+}
+
+/// Remove "prog" from the regprog cache, so that vim_regcomp() no longer
+/// returns it.  References already handed out stay valid.
+static void regprog_cache_remove(regprog_T *prog)
+{
+  if (prog->re_refcount == 0) {
+    return;
+  }
+  for (int i = 0; i < regprog_cache_len; i++) {
+    if (regprog_cache[i].prog == prog) {
+      regprog_cache_del(i);
+      return;
+    }
+  }
+}
+
+/// Compile a regular expression into internal code.
+/// Returns the program in allocated memory.
+/// Use vim_regfree() to free the memory.
+/// Returns NULL for an error.
+///
+/// Recently compiled programs are kept in a small LRU cache and handed out
+/// again, with a reference count, for the same pattern and flags.  A program
+/// that is currently executing is not shared, so that recursive use keeps
+/// working.
 regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
+{
+  // Patterns using the previous substitute string or a character class that
+  // is expanded when compiling depend on more state, don't cache them.
+  const bool cacheable = strchr(expr_arg, '~') == NULL && strstr(expr_arg, "[:") == NULL;
+  const bool cpo_lit = vim_strchr(p_cpo, CPO_LITERAL) != NULL;
+
+  if (cacheable) {
+    for (int i = 0; i < regprog_cache_len; i++) {
+      regprog_cache_T entry = regprog_cache[i];
+      if (entry.re_flags == re_flags && entry.engine == (int)p_re
+          && entry.extmatch == reg_do_extmatch && entry.cpo_lit == cpo_lit
+          && !entry.prog->re_in_use && strcmp(entry.pattern, expr_arg) == 0) {
+        memmove(&regprog_cache[1], &regprog_cache[0], (size_t)i * sizeof(entry));
+        regprog_cache[0] = entry;
+        entry.prog->re_refcount++;
+        return entry.prog;
+      }
+    }
+  }
+
+  const int called_emsg_before = called_emsg;
+  regprog_T *prog = regcomp_uncached(expr_arg, re_flags);
+
+  if (prog != NULL && cacheable && called_emsg == called_emsg_before) {
+    if (regprog_cache_len == REGPROG_CACHE_SIZE) {
+      regprog_cache_del(REGPROG_CACHE_SIZE - 1);
+    }
+    memmove(&regprog_cache[1], &regprog_cache[0],
+            (size_t)regprog_cache_len * sizeof(regprog_cache[0]));
+    regprog_cache_len++;
+    regprog_cache[0] = (regprog_cache_T){
+      .pattern = xstrdup(expr_arg),
+      .re_flags = re_flags,
+      .engine = (int)p_re,
+      .extmatch = reg_do_extmatch,
+      .cpo_lit = cpo_lit,
+      .prog = prog,
+    };
+    prog->re_refcount = 2;  // one for the cache, one for the caller
+  }
+
+  return prog;
+}
+
+static regprog_T *regcomp_uncached(const char *expr_arg, int re_flags)
 {
   regprog_T *prog = NULL;
   const char *expr = expr_arg;
@@ -15993,7 +16810,8 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
 
     if (newengine == AUTOMATIC_ENGINE
         || newengine == BACKTRACKING_ENGINE
-        || newengine == NFA_ENGINE) {
+        || newengine == NFA_ENGINE
+        || newengine == DFA_ENGINE) {
       regexp_engine = expr[4] - '0';
       expr += 5;
 #ifdef REGEXP_DEBUG
@@ -16002,7 +16820,7 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
            regname[newengine]);
 #endif
     } else {
-      emsg(_("E864: \\%#= can only be followed by 0, 1, or 2. The automatic engine will be used "));
+      emsg(_("E864: \\%#= can only be followed by 0, 1, 2 or 3. The automatic engine will be used "));
       regexp_engine = AUTOMATIC_ENGINE;
     }
   }
@@ -16055,6 +16873,7 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
     // to be very slow when executing it.
     prog->re_engine = (unsigned)regexp_engine;
     prog->re_flags = (unsigned)re_flags;
+    prog->re_refcount = 0;
   }
 
   return prog;
@@ -16064,13 +16883,65 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
 void vim_regfree(regprog_T *prog)
 {
   if (prog != NULL) {
+    if (prog->re_refcount > 0 && --prog->re_refcount > 0) {
+      return;  // still used by others or the cache
+    }
     prog->engine->regfree(prog);
   }
 }
 
+/// Get a literal text that every match of "prog" contains, which can be used
+/// to skip text that cannot match without running the regexp engine.
+/// The text does not contain a line break.
+///
+/// @param      ic    whether case is ignored when the pattern doesn't say
+/// @param[out] icp   whether the text is to be compared ignoring case
+/// @param[out] lenp  length of the text
+///
+/// @return  the text, it is owned by "prog", or NULL if there is none.
+const char *vim_regprog_literal(const regprog_T *prog, bool ic, bool *icp, int *lenp)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (prog->regflags & RF_ICOMBINE) {
+    return NULL;
+  }
+
+  const uint8_t *lit;
+  int len;
+  if (prog->engine == &bt_regengine) {
+    lit = ((const bt_regprog_T *)prog)->regmust;
+    len = ((const bt_regprog_T *)prog)->regmlen;
+  } else {
+    const nfa_regprog_T *nprog = (const nfa_regprog_T *)prog;
+    if (nprog->match_text != NULL) {
+      lit = nprog->match_text;
+      len = (int)strlen((char *)lit);
+    } else {
+      lit = nprog->regmust;
+      len = nprog->regmlen;
+    }
+  }
+  if (lit == NULL || len == 0) {
+    return NULL;
+  }
+
+  if (prog->regflags & RF_ICASE) {
+    *icp = true;
+  } else if (prog->regflags & RF_NOICASE) {
+    *icp = false;
+  } else {
+    *icp = ic;
+  }
+  *lenp = len;
+  return (const char *)lit;
+}
+
 #if defined(EXITFREE)
 void free_regexp_stuff(void)
 {
+  while (regprog_cache_len > 0) {
+    regprog_cache_del(regprog_cache_len - 1);
+  }
   ga_clear(&regstack);
   ga_clear(&backpos);
   xfree(reg_tofree);
@@ -16124,6 +16995,7 @@ static bool vim_regexec_string(regmatch_T *rmp, const char *line, colnr_T col, b
   rex.reg_startpos = NULL;
   rex.reg_endpos = NULL;
 
+  g_stats.regexp_exec++;
   int result = rmp->regprog->engine->regexec_nl(rmp, (uint8_t *)line, col, nl);
   rmp->regprog->re_in_use = false;
 
@@ -16135,6 +17007,7 @@ static bool vim_regexec_string(regmatch_T *rmp, const char *line, colnr_T col, b
     char *pat = xstrdup(((nfa_regprog_T *)rmp->regprog)->pattern);
 
     p_re = BACKTRACKING_ENGINE;
+    regprog_cache_remove(rmp->regprog);
     vim_regfree(rmp->regprog);
     report_re_switch(pat);
     rmp->regprog = vim_regcomp(pat, re_flags);
@@ -16215,6 +17088,7 @@ int vim_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, c
   }
   rex_in_use = true;
 
+  g_stats.regexp_exec++;
   int result = rmp->regprog->engine->regexec_multi(rmp, win, buf, lnum, col, tm, timed_out);
   rmp->regprog->re_in_use = false;
 
@@ -16227,6 +17101,7 @@ int vim_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, c
 
     p_re = BACKTRACKING_ENGINE;
     regprog_T *prev_prog = rmp->regprog;
+    regprog_cache_remove(prev_prog);
 
     report_re_switch(pat);
     // checking for \z misuse was already done when compiling for NFA,
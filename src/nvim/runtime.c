@@ -49,10 +49,12 @@
 #include "nvim/option_defs.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/fs.h"
+#include "nvim/os/fs_defs.h"
 #include "nvim/os/input.h"
 #include "nvim/os/os.h"
 #include "nvim/os/os_defs.h"
 #include "nvim/os/stdpaths_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
 #include "nvim/profile.h"
@@ -94,8 +96,21 @@ typedef struct {
   char *path;
   bool after;
   TriState has_lua;
+  Set(cstr_t) *entries;        ///< lowercase names in "path", NULL when not read
+  uv_timespec_t entries_mtime;  ///< modification time of "path" for "entries"
+  PMap(cstr_t) *expanded;      ///< PathExpandResult for patterns, NULL when none
 } SearchPathItem;
 
+/// Matches of a pattern in a runtime path directory, see search_path_item_expand().
+typedef struct {
+  char **files;
+  int num_files;
+  int flags;            ///< flags for gen_expand_wildcards()
+  int fic;              ///< value of 'fileignorecase'
+  int busy;             ///< number of callbacks using "files"
+  uv_timespec_t mtime;  ///< modification time of the directory with the matches
+} PathExpandResult;
+
 typedef kvec_t(SearchPathItem) RuntimeSearchPath;
 typedef kvec_t(char *) CharVec;
 
@@ -523,6 +538,161 @@ static RuntimeSearchPath runtime_search_path_get_cached(int *ref)
   return runtime_search_path;
 }
 
+/// Read the names in the directory of "item" into its "entries".
+static void search_path_item_read(SearchPathItem *item, uv_timespec_t mtime)
+{
+  search_path_item_clear(item);
+
+  Directory dir;
+  if (!os_scandir(&dir, item->path)) {
+    return;
+  }
+  item->entries = xmalloc(sizeof(*item->entries));
+  *item->entries = (Set(cstr_t)) SET_INIT;
+  const char *name;
+  while ((name = os_scandir_next(&dir)) != NULL) {
+    char *key = xstrdup(name);
+    for (char *p = key; *p != NUL; p++) {
+      *p = (char)TOLOWER_ASC(*p);
+    }
+    MHPutStatus status;
+    uint32_t k = set_put_idx(cstr_t, item->entries, key, &status);
+    if (status == kMHExisting) {
+      xfree(key);
+    } else {
+      item->entries->keys[k] = key;
+    }
+  }
+  os_closedir(&dir);
+
+  // A name added within the same second may not change the time stamp on
+  // some file systems, read the directory again next time.
+  item->entries_mtime = mtime.tv_sec >= os_time() - 1 ? (uv_timespec_t){ 0 } : mtime;
+}
+
+static void search_path_item_clear(SearchPathItem *item)
+{
+  if (item->entries != NULL) {
+    const char *key;
+    set_foreach(item->entries, key, {
+      xfree((char *)key);
+    });
+    set_destroy(cstr_t, item->entries);
+    XFREE_CLEAR(item->entries);
+  }
+  if (item->expanded != NULL) {
+    const char *key;
+    PathExpandResult *res;
+    map_foreach(item->expanded, key, res, {
+      xfree((char *)key);
+      FreeWild(res->num_files, res->files);
+      xfree(res);
+    });
+    map_destroy(cstr_t, item->expanded);
+    XFREE_CLEAR(item->expanded);
+  }
+}
+
+/// Expand pattern "buf", which is "item->path" followed by "tail", and invoke
+/// "callback" for the matches.  When "tail" only has wildcards after the last
+/// path separator, the matches are kept and used again until the modification
+/// time of the directory they are in changes.  That avoids reading the same
+/// "ftplugin" directories again for every buffer with the same filetype.
+///
+/// @returns  OK when some files were found, FAIL otherwise.
+static int search_path_item_expand(SearchPathItem *item, char *buf, const char *tail, int flags,
+                                   bool all, DoInRuntimepathCB callback, void *cookie)
+{
+  const char *last_sep = strrchr(tail, '/');
+  const char *name = last_sep != NULL ? last_sep : tail;
+  const size_t dirlen = (size_t)(name - buf);
+  for (const char *p = tail; *p != NUL; p++) {
+    if ((p < name && vim_strchr("*?[]{}", (uint8_t)(*p)) != NULL)
+        || vim_strchr("~$`\\", (uint8_t)(*p)) != NULL) {
+      return gen_expand_wildcards_and_cb(1, &buf, flags, all, callback, cookie);
+    }
+  }
+
+  char dir[MAXPATHL];
+  xmemcpyz(dir, buf, dirlen);
+  FileInfo info;
+  if (!os_fileinfo(dir, &info)) {
+    return FAIL;  // no directory, no matches
+  }
+  const uv_timespec_t mtime = info.stat.st_mtim;
+
+  if (item->expanded == NULL) {
+    item->expanded = xmalloc(sizeof(*item->expanded));
+    *item->expanded = (PMap(cstr_t)) MAP_INIT;
+  }
+  PathExpandResult *res = pmap_get(cstr_t)(item->expanded, tail);
+  if (res == NULL || res->flags != flags || res->fic != p_fic
+      || mtime.tv_sec != res->mtime.tv_sec || mtime.tv_nsec != res->mtime.tv_nsec) {
+    // A file added within the same second may not change the time stamp on
+    // some file systems, don't keep the matches then.
+    if ((res != NULL && res->busy > 0) || mtime.tv_sec >= os_time() - 1) {
+      return gen_expand_wildcards_and_cb(1, &buf, flags, all, callback, cookie);
+    }
+    if (res == NULL) {
+      res = xcalloc(1, sizeof(*res));
+      pmap_put(cstr_t)(item->expanded, xstrdup(tail), res);
+    } else {
+      FreeWild(res->num_files, res->files);
+    }
+    if (gen_expand_wildcards(1, &buf, &res->num_files, &res->files, flags) != OK) {
+      res->num_files = 0;
+      res->files = NULL;
+    }
+    res->flags = flags;
+    res->fic = p_fic;
+    res->mtime = mtime;
+  }
+
+  if (res->num_files == 0) {
+    return FAIL;
+  }
+  res->busy++;
+  (*callback)(res->num_files, res->files, all, cookie);
+  res->busy--;
+  return OK;
+}
+
+/// Check if file pattern "pat" may match in the directory of "item".  This is
+/// false when the first directory of "pat" has no wildcards and is not in
+/// the directory, then expanding "pat" can be skipped.  The names in the
+/// directory are read again when its modification time changes.
+static bool search_path_item_may_match(SearchPathItem *item, const char *pat)
+{
+  const char *sep = strchr(pat, '/');
+  if (sep == NULL || sep == pat) {
+    return true;
+  }
+  char key[MAXPATHL];
+  const size_t len = (size_t)(sep - pat);
+  if (len >= sizeof(key)) {
+    return true;
+  }
+  for (size_t i = 0; i < len; i++) {
+    // The file system may also ignore case of non-ASCII characters.
+    if (vim_strchr("*?[]{}~$`\\", (uint8_t)pat[i]) != NULL || (uint8_t)pat[i] >= 0x80) {
+      return true;
+    }
+    key[i] = (char)TOLOWER_ASC(pat[i]);
+  }
+  key[len] = NUL;
+
+  FileInfo info;
+  if (!os_fileinfo(item->path, &info)) {
+    return true;
+  }
+  const uv_timespec_t mtime = info.stat.st_mtim;
+  if (item->entries == NULL || mtime.tv_sec != item->entries_mtime.tv_sec
+      || mtime.tv_nsec != item->entries_mtime.tv_nsec) {
+    search_path_item_read(item, mtime);
+  }
+  return item->entries == NULL || set_has(cstr_t, item->entries, key);
+}
+
 static RuntimeSearchPath copy_runtime_search_path(const RuntimeSearchPath src)
 {
   RuntimeSearchPath dst = KV_INITIAL_VALUE;
@@ -599,6 +769,10 @@ static int do_in_cached_path(char *name, int flags, DoInRuntimepathCB callback,
         assert(MAXPATHL >= (tail - buf));
         copy_option_part(&np, tail, (size_t)(MAXPATHL - (tail - buf)), "\t ");
 
+        if (!search_path_item_may_match(&kv_A(path, j), tail)) {
+          continue;
+        }
+
         if (p_verbose > 10) {
           verbose_enter();
           smsg(0, _("Searching for \"%s\""), buf);
@@ -610,8 +784,8 @@ static int do_in_cached_path(char *name, int flags, DoInRuntimepathCB callback,
                        | EW_NOBREAK;
 
         // Expand wildcards, invoke the callback for each match.
-        char *(pat[]) = { buf };
-        did_one |= gen_expand_wildcards_and_cb(1, pat, ew_flags, do_all, callback, cookie) == OK;
+        did_one |= search_path_item_expand(&kv_A(path, j), buf, tail, ew_flags, do_all, callback,
+                                           cookie) == OK;
       }
     }
   }
@@ -691,7 +865,8 @@ static ArrayOf(String) runtime_get_named_common(bool lua, Array pat, bool all,
 
     for (size_t j = 0; j < pat.size; j++) {
       Object pat_item = pat.items[j];
-      if (pat_item.type == kObjectTypeString) {
+      if (pat_item.type == kObjectTypeString
+          && search_path_item_may_match(item, pat_item.data.string.data)) {
         size_t size = (size_t)snprintf(buf, buf_len, "%s/%s",
                                        item->path, pat_item.data.string.data);
         if (size < buf_len) {
@@ -888,8 +1063,9 @@ const char *did_set_runtimepackpath(optset_T *args)
 static void runtime_search_path_free(RuntimeSearchPath path)
 {
   for (size_t j = 0; j < kv_size(path); j++) {
-    SearchPathItem item = kv_A(path, j);
-    xfree(item.path);
+    SearchPathItem *item = &kv_A(path, j);
+    xfree(item->path);
+    search_path_item_clear(item);
   }
   kv_destroy(path);
 }
@@ -2206,6 +2382,7 @@ static int do_source_ext(char *const fname, const bool check_other, const int is
   if (l_time_fd != NULL) {
     time_push(&rel_time, &start_time);
   }
+  const uint64_t trace_tm = trace_begin();
 
   const int l_do_profiling = do_profiling;
   if (l_do_profiling == PROF_YES) {
@@ -2322,6 +2499,7 @@ static int do_source_ext(char *const fname, const bool check_other, const int is
     time_msg(IObuff, &start_time);
     time_pop(rel_time);
   }
+  trace_end_copy("source", fname_exp, trace_tm);
 
   if (!got_int) {
     trigger_source_post = true;
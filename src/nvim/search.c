@@ -303,6 +303,7 @@ void free_search_patterns(void)
 
   XFREE_CLEAR(mr_pattern);
   mr_patternlen = 0;
+  search_stat_index_clear();
 }
 
 #endif
@@ -405,6 +406,26 @@ int ignorecase_opt(char *pat, int ic_in, int scs)
   return ic;
 }
 
+/// Return true when search pattern "pat" is plain text that starts with
+/// "prev_pat", which is plain text as well.  Then every match of "pat" is also
+/// a match of "prev_pat" at the same position, results for "prev_pat" can be
+/// used to skip searching for "pat".  The result does not depend on 'magic'.
+bool search_pat_extends(const char *prev_pat, size_t prev_patlen, const char *pat, size_t patlen)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  if (prev_patlen == 0 || patlen < prev_patlen
+      || memcmp(prev_pat, pat, prev_patlen) != 0) {
+    return false;
+  }
+  // Also reject the delimiters, the text may include an offset.
+  for (size_t i = 0; i < patlen; i++) {
+    if (pat[i] == NUL || vim_strchr("\\^$.*[~/?", (uint8_t)pat[i]) != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /// Returns true if pattern `pat` has an uppercase character.
 bool pat_has_uppercase(char *pat)
   FUNC_ATTR_NONNULL_ALL
@@ -1967,7 +1988,14 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
     lispcomm = true;        // find match inside this comment
   }
 
+  // A line without any of these is skipped as a whole, only looking at the
+  // characters matters when searching for comments or in Lisp.
+  const char stopchars[] = { '"', '\'', '\\', (char)initc, (char)findc, NUL };
+  const bool skip_lines = !comment_dir && !lisp && initc > 0 && initc < 0x80 && findc < 0x80;
+
   while (!got_int) {
+    bool new_line = false;
+
     // Go to the next position, forward or backward. We could use
     // inc() and dec() here, but that is much slower
     if (backwards) {
@@ -1988,6 +2016,7 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
         linep = ml_get(pos.lnum);
         pos.col = ml_get_len(pos.lnum);  // pos.col on trailing NUL
         do_quotes = -1;
+        new_line = true;
         line_breakcheck();
 
         // Check if this line contains a single-line comment
@@ -2023,6 +2052,7 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
         linep = ml_get(pos.lnum);
         pos.col = 0;
         do_quotes = -1;
+        new_line = true;
         line_breakcheck();
         if (lisp) {         // find comment pos in new line
           comment_col = check_linecomment(linep);
@@ -2041,6 +2071,15 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
       break;  // out of scope
     }
 
+    if (new_line && skip_lines && strpbrk(linep, stopchars) == NULL
+        && !((flags & FM_BLOCKSTOP) && (linep[0] == '{' || linep[0] == '}'))) {
+      // Nothing to match and no quotes: same as reaching the end of the line.
+      inquote = false;
+      start_in_quotes = kFalse;
+      pos.col = backwards ? 0 : ml_get_len(pos.lnum);
+      continue;
+    }
+
     if (comment_dir) {
       // Note: comments do not nest, and we ignore quotes in them
       // TODO(vim): ignore comment brackets inside strings
@@ -2687,6 +2726,118 @@ static void cmdline_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, bool sh
   msg_hist_off = false;
 }
 
+/// A match found when counting matches for the search count.
+typedef struct {
+  pos_T start;    ///< start of the match
+  pos_T maxend;   ///< largest end of this and all the previous matches
+} statmatch_T;
+
+/// Beyond the maximum count matches are only collected for
+/// search_stat_index, up to this number.
+#define SEARCH_STAT_INDEX_MAX 100000
+
+/// All matches of the last used search pattern in a buffer, found when
+/// counting them.  Other positions in the same buffer are then looked up
+/// instead of searching the whole buffer again.
+static struct {
+  garray_T ga;                ///< statmatch_T items, in order
+  bool valid;                 ///< "ga" has all matches
+  handle_T bufnr;
+  varnumber_T changedtick;
+  char *pat;
+  size_t patlen;
+  int magic;
+  bool ic;
+  bool scs;
+} search_stat_index = { .ga = GA_EMPTY_INIT_VALUE };
+
+/// @return  true if search_stat_index holds all matches of the last used
+///          pattern in the current buffer.
+static bool search_stat_index_valid(void)
+{
+  return search_stat_index.valid
+         && search_stat_index.bufnr == curbuf->handle
+         && search_stat_index.changedtick == buf_get_changedtick(curbuf)
+         && search_stat_index.patlen == spats[last_idx].patlen
+         && memcmp(search_stat_index.pat, spats[last_idx].pat, spats[last_idx].patlen) == 0
+         && search_stat_index.magic == spats[last_idx].magic
+         && search_stat_index.ic == p_ic
+         && search_stat_index.scs == p_scs;
+}
+
+#if defined(EXITFREE)
+/// Free the matches and pattern of search_stat_index.
+static void search_stat_index_clear(void)
+{
+  ga_clear(&search_stat_index.ga);
+  XFREE_CLEAR(search_stat_index.pat);
+  search_stat_index.patlen = 0;
+  search_stat_index.valid = false;
+}
+#endif
+
+/// Start collecting matches in search_stat_index.
+static void search_stat_index_start(void)
+{
+  ga_clear(&search_stat_index.ga);
+  ga_init(&search_stat_index.ga, sizeof(statmatch_T), 100);
+  search_stat_index.valid = false;
+}
+
+/// Add a match found when counting to search_stat_index.
+static void search_stat_index_add(pos_T start, pos_T end)
+{
+  garray_T *ga = &search_stat_index.ga;
+  if (ga->ga_len > 0 && lt(end, ((statmatch_T *)ga->ga_data)[ga->ga_len - 1].maxend)) {
+    end = ((statmatch_T *)ga->ga_data)[ga->ga_len - 1].maxend;
+  }
+  GA_APPEND(statmatch_T, ga, ((statmatch_T){ .start = start, .maxend = end }));
+}
+
+/// All matches have been added to search_stat_index.
+static void search_stat_index_done(void)
+{
+  xfree(search_stat_index.pat);
+  search_stat_index.pat = xmemdupz(spats[last_idx].pat, spats[last_idx].patlen);
+  search_stat_index.patlen = spats[last_idx].patlen;
+  search_stat_index.magic = spats[last_idx].magic;
+  search_stat_index.ic = p_ic;
+  search_stat_index.scs = p_scs;
+  search_stat_index.bufnr = curbuf->handle;
+  search_stat_index.changedtick = buf_get_changedtick(curbuf);
+  search_stat_index.valid = true;
+}
+
+/// Get the search count for position "p" from search_stat_index, the same
+/// way as counting the matches up to "maxcount + 1" does.
+static void search_stat_index_lookup(pos_T p, int maxcount, int *cur, int *cnt, bool *exact_match,
+                                     int *incomplete)
+{
+  const statmatch_T *const items = search_stat_index.ga.ga_data;
+  int len = search_stat_index.ga.ga_len;
+  *incomplete = 0;
+  if (maxcount > 0 && len > maxcount) {
+    len = maxcount + 1;
+    *incomplete = 2;
+  }
+
+  // Binary search for the number of matches starting at or before "p".
+  int lo = 0;
+  int hi = len;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (ltoreq(items[mid].start, p)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  *cnt = len;
+  *cur = lo;
+  *exact_match = lo > 0 && lt(p, items[lo - 1].maxend);
+}
+
 // Add the search count information to "stat".
 // "stat" must not be NULL.
 // When "recompute" is true always recompute the numbers.
@@ -2746,7 +2897,22 @@ static void update_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, searchst
   if (equalpos(lastpos, *cursor_pos) && !wraparound
       && (dirc == 0 || dirc == '/' ? cur < cnt : cur > 1)) {
     cur += dirc == 0 ? 0 : dirc == '/' ? 1 : -1;
+  } else if (EMPTY_POS(lastpos) && search_stat_index_valid()) {
+    // All the matches are known, no need to search.
+    search_stat_index_lookup(p, maxcount, &cur, &cnt, &exact_match, &incomplete);
+    xfree(lastpat);
+    lastpat = xstrnsave(spats[last_idx].pat, spats[last_idx].patlen);
+    lastpatlen = spats[last_idx].patlen;
+    chgtick = (int)buf_get_changedtick(curbuf);
+    lbuf = curbuf;
+    lastpos = p;
   } else {
+    // When counting from the start remember the matches.
+    const bool collect = EMPTY_POS(lastpos);
+    bool found_all = false;
+    if (collect) {
+      search_stat_index_start();
+    }
     proftime_T start;
     bool done_search = false;
     pos_T endpos = { 0, 0, 0 };
@@ -2754,31 +2920,53 @@ static void update_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, searchst
     if (timeout > 0) {
       start = profile_setlimit(timeout);
     }
-    while (!got_int && searchit(curwin, curbuf, &lastpos, &endpos,
-                                FORWARD, NULL, 0, 1, SEARCH_KEEP, RE_LAST,
-                                NULL) != FAIL) {
+    // Past "maxcount" matches only the index is filled, up to
+    // SEARCH_STAT_INDEX_MAX matches.
+    bool counting = true;
+    while (true) {
+      if (got_int) {
+        break;
+      }
+      if (searchit(curwin, curbuf, &lastpos, &endpos, FORWARD, NULL, 0, 1,
+                   SEARCH_KEEP, RE_LAST, NULL) == FAIL) {
+        found_all = true;
+        break;
+      }
       done_search = true;
       // Stop after passing the time limit.
       if (timeout > 0 && profile_passed_limit(start)) {
-        incomplete = 1;
+        if (counting) {
+          incomplete = 1;
+        }
         break;
       }
-      cnt++;
-      if (ltoreq(lastpos, p)) {
-        cur = cnt;
-        if (lt(p, endpos)) {
-          exact_match = true;
+      if (counting) {
+        cnt++;
+        if (ltoreq(lastpos, p)) {
+          cur = cnt;
+          if (lt(p, endpos)) {
+            exact_match = true;
+          }
         }
       }
+      if (collect) {
+        search_stat_index_add(lastpos, endpos);
+      }
       fast_breakcheck();
-      if (maxcount > 0 && cnt > maxcount) {
+      if (counting && maxcount > 0 && cnt > maxcount) {
         incomplete = 2;    // max count exceeded
+        counting = false;
+      }
+      if (!counting && (!collect || search_stat_index.ga.ga_len >= SEARCH_STAT_INDEX_MAX)) {
         break;
       }
     }
     if (got_int) {
       cur = -1;  // abort
     }
+    if (collect && found_all && !got_int) {
+      search_stat_index_done();
+    }
     if (done_search) {
       xfree(lastpat);
       lastpat = xstrnsave(spats[last_idx].pat, spats[last_idx].patlen);
@@ -3206,6 +3394,41 @@ static int fuzzy_match_recursive(const char *fuzpat, const char *str, uint32_t s
   return 0;  // no match
 }
 
+/// @return  bit for ASCII letter or digit "c", ignoring case, zero for other
+///          characters.
+static inline uint64_t fuzzy_char_bit(uint8_t c)
+{
+  if (ASCII_ISALPHA(c)) {
+    return (uint64_t)1 << (TOLOWER_ASC(c) - 'a');
+  }
+  if (ascii_isdigit(c)) {
+    return (uint64_t)1 << (26 + c - '0');
+  }
+  return 0;
+}
+
+/// Quick check whether "str" may fuzzy match "pat": every ASCII letter and
+/// digit of "pat" must appear in "str".  Rejects most strings a lot faster
+/// than fuzzy_match_recursive().  A non-ASCII character may turn into an
+/// ASCII one when ignoring case, then "str" is not rejected.
+static bool fuzzy_may_match(const char *str, const char *pat)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  uint64_t pat_bits = 0;
+  for (const char *p = pat; *p != NUL; p++) {
+    pat_bits |= fuzzy_char_bit((uint8_t)(*p));
+  }
+
+  uint64_t str_bits = 0;
+  for (const char *s = str; *s != NUL && (pat_bits & ~str_bits) != 0; s++) {
+    if ((uint8_t)(*s) >= 0x80) {
+      return true;
+    }
+    str_bits |= fuzzy_char_bit((uint8_t)(*s));
+  }
+  return (pat_bits & ~str_bits) == 0;
+}
+
 /// fuzzy_match()
 ///
 /// Performs exhaustive search via recursion to find all possible matches and
@@ -3222,12 +3445,15 @@ bool fuzzy_match(char *const str, const char *const pat_arg, const bool matchseq
                  int *const outScore, uint32_t *const matches, const int maxMatches, bool camelcase)
   FUNC_ATTR_NONNULL_ALL
 {
+  *outScore = 0;
+  if (!fuzzy_may_match(str, pat_arg)) {
+    return false;
+  }
+
   const int len = mb_charlen(str);
   bool complete = false;
   int numMatches = 0;
 
-  *outScore = 0;
-
   char *const save_pat = xstrdup(pat_arg);
   char *pat = save_pat;
   char *p = pat;
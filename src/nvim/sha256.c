@@ -9,12 +9,24 @@
 ///
 /// Vim specific notes:
 /// sha256_self_test() is implicitly called once.
+///
+/// Blocks are processed with the SHA extensions of x86 (checked at runtime) or
+/// ARMv8 (when the compiler targets them), if available.
 
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define SHA256_X86
+# include <cpuid.h>
+# include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+# define SHA256_ARM
+# include <arm_neon.h>
+#endif
+
 #include "nvim/ascii_defs.h"
 #include "nvim/memory.h"
 #include "nvim/sha256.h"
@@ -178,6 +190,171 @@ static void sha256_process(context_sha256_T *ctx, const uint8_t data[SHA256_BUFF
   ctx->state[7] += H;
 }
 
+#if defined(SHA256_X86) || defined(SHA256_ARM)
+/// Round constants, for the hardware accelerated implementations.
+static const uint32_t sha256_k[64] = {
+  0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+  0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+  0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+  0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+  0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+  0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+  0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+  0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+#endif
+
+#ifdef SHA256_X86
+/// @return true if the CPU has the SHA extensions (and SSE4.1, which they need).
+static bool sha256_has_sha_ni(void)
+{
+  static int has_sha_ni = -1;
+  if (has_sha_ni < 0) {
+    unsigned eax, ebx, ecx, edx;
+    has_sha_ni = 0;
+    if (__get_cpuid_max(0, NULL) >= 7 && __get_cpuid(1, &eax, &ebx, &ecx, &edx)
+        && (ecx & (1U << 19))) {  // SSE4.1
+      __cpuid_count(7, 0, eax, ebx, ecx, edx);
+      has_sha_ni = (ebx & (1U << 29)) != 0;  // SHA
+    }
+  }
+  return has_sha_ni;
+}
+
+/// Four rounds with the message words in "cur", also computing the next
+/// message words in "next" and "prev" (for the rounds four groups later).
+# define SHA_NI_ROUNDS(i, cur, prev, next) { \
+  msg = _mm_add_epi32(cur, _mm_loadu_si128((const __m128i *)&sha256_k[4 * (i)])); \
+  state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+  if ((i) >= 3 && (i) <= 14) { \
+    next = _mm_sha256msg2_epu32(_mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur); \
+  } \
+  msg = _mm_shuffle_epi32(msg, 0x0E); \
+  state0 = _mm_sha256rnds2_epu32(state0, state1, msg); \
+  if ((i) >= 1 && (i) <= 12) { \
+    prev = _mm_sha256msg1_epu32(prev, cur); \
+  } \
+}
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_process_sha_ni(uint32_t state[8], const uint8_t *data, size_t nblocks)
+{
+  const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  // The instructions want the state as ABEF and CDGH.
+  __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);  // CDAB
+  __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);  // EFGH
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);  // CDGH
+
+  for (; nblocks > 0; nblocks--, data += SHA256_BUFFER_SIZE) {
+    const __m128i abef = state0;
+    const __m128i cdgh = state1;
+    __m128i msg;
+    __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 0)), bswap);
+    __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), bswap);
+    __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), bswap);
+    __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), bswap);
+
+    SHA_NI_ROUNDS(0, m0, m3, m1);
+    SHA_NI_ROUNDS(1, m1, m0, m2);
+    SHA_NI_ROUNDS(2, m2, m1, m3);
+    SHA_NI_ROUNDS(3, m3, m2, m0);
+    SHA_NI_ROUNDS(4, m0, m3, m1);
+    SHA_NI_ROUNDS(5, m1, m0, m2);
+    SHA_NI_ROUNDS(6, m2, m1, m3);
+    SHA_NI_ROUNDS(7, m3, m2, m0);
+    SHA_NI_ROUNDS(8, m0, m3, m1);
+    SHA_NI_ROUNDS(9, m1, m0, m2);
+    SHA_NI_ROUNDS(10, m2, m1, m3);
+    SHA_NI_ROUNDS(11, m3, m2, m0);
+    SHA_NI_ROUNDS(12, m0, m3, m1);
+    SHA_NI_ROUNDS(13, m1, m0, m2);
+    SHA_NI_ROUNDS(14, m2, m1, m3);
+    SHA_NI_ROUNDS(15, m3, m2, m0);
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);  // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xB1);  // DCHG
+  _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));  // DCBA
+  _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(state1, tmp, 8));  // HGFE
+}
+# undef SHA_NI_ROUNDS
+#endif
+
+#ifdef SHA256_ARM
+/// Four rounds with the message words in "m[i % 4]", also computing the message
+/// words for the rounds four groups later.
+# define SHA_ARM_ROUNDS(i, m0, m1, m2, m3) { \
+  uint32x4_t wk = vaddq_u32(m0, vld1q_u32(&sha256_k[4 * (i)])); \
+  if ((i) < 12) { \
+    m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3); \
+  } \
+  uint32x4_t abcd = state0; \
+  state0 = vsha256hq_u32(state0, state1, wk); \
+  state1 = vsha256h2q_u32(state1, abcd, wk); \
+}
+
+static void sha256_process_arm(uint32_t state[8], const uint8_t *data, size_t nblocks)
+{
+  uint32x4_t state0 = vld1q_u32(&state[0]);
+  uint32x4_t state1 = vld1q_u32(&state[4]);
+
+  for (; nblocks > 0; nblocks--, data += SHA256_BUFFER_SIZE) {
+    const uint32x4_t abcd = state0;
+    const uint32x4_t efgh = state1;
+    uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 0)));
+    uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+    uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+    uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+
+    SHA_ARM_ROUNDS(0, m0, m1, m2, m3);
+    SHA_ARM_ROUNDS(1, m1, m2, m3, m0);
+    SHA_ARM_ROUNDS(2, m2, m3, m0, m1);
+    SHA_ARM_ROUNDS(3, m3, m0, m1, m2);
+    SHA_ARM_ROUNDS(4, m0, m1, m2, m3);
+    SHA_ARM_ROUNDS(5, m1, m2, m3, m0);
+    SHA_ARM_ROUNDS(6, m2, m3, m0, m1);
+    SHA_ARM_ROUNDS(7, m3, m0, m1, m2);
+    SHA_ARM_ROUNDS(8, m0, m1, m2, m3);
+    SHA_ARM_ROUNDS(9, m1, m2, m3, m0);
+    SHA_ARM_ROUNDS(10, m2, m3, m0, m1);
+    SHA_ARM_ROUNDS(11, m3, m0, m1, m2);
+    SHA_ARM_ROUNDS(12, m0, m1, m2, m3);
+    SHA_ARM_ROUNDS(13, m1, m2, m3, m0);
+    SHA_ARM_ROUNDS(14, m2, m3, m0, m1);
+    SHA_ARM_ROUNDS(15, m3, m0, m1, m2);
+
+    state0 = vaddq_u32(state0, abcd);
+    state1 = vaddq_u32(state1, efgh);
+  }
+
+  vst1q_u32(&state[0], state0);
+  vst1q_u32(&state[4], state1);
+}
+# undef SHA_ARM_ROUNDS
+#endif
+
+/// Processes "nblocks" blocks of SHA256_BUFFER_SIZE bytes.
+static void sha256_process_blocks(context_sha256_T *ctx, const uint8_t *data, size_t nblocks)
+{
+#if defined(SHA256_ARM)
+  sha256_process_arm(ctx->state, data, nblocks);
+  return;
+#elif defined(SHA256_X86)
+  if (sha256_has_sha_ni()) {
+    sha256_process_sha_ni(ctx->state, data, nblocks);
+    return;
+  }
+#endif
+  for (; nblocks > 0; nblocks--, data += SHA256_BUFFER_SIZE) {
+    sha256_process(ctx, data);
+  }
+}
+
 void sha256_update(context_sha256_T *ctx, const uint8_t *input, size_t length)
 {
   if (length == 0) {
@@ -197,16 +374,17 @@ void sha256_update(context_sha256_T *ctx, const uint8_t *input, size_t length)
 
   if (left && (length >= fill)) {
     memcpy(ctx->buffer + left, input, fill);
-    sha256_process(ctx, ctx->buffer);
+    sha256_process_blocks(ctx, ctx->buffer, 1);
     length -= fill;
     input += fill;
     left = 0;
   }
 
-  while (length >= SHA256_BUFFER_SIZE) {
-    sha256_process(ctx, input);
-    length -= SHA256_BUFFER_SIZE;
-    input += SHA256_BUFFER_SIZE;
+  if (length >= SHA256_BUFFER_SIZE) {
+    size_t nblocks = length / SHA256_BUFFER_SIZE;
+    sha256_process_blocks(ctx, input, nblocks);
+    length -= nblocks * SHA256_BUFFER_SIZE;
+    input += nblocks * SHA256_BUFFER_SIZE;
   }
 
   if (length) {
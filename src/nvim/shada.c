@@ -921,7 +921,21 @@ static void shada_read(FileDescriptor *const sd_reader, const int flags)
   const bool force = flags & kShaDaForceit;
   const bool get_old_files = (flags & (kShaDaGetOldfiles | kShaDaForceit)
                               && (force || tv_list_len(oldfiles_list) == 0));
-  const bool want_marks = flags & kShaDaWantMarks;
+  const bool want_buffer_list = (flags & kShaDaWantInfo
+                                 && find_shada_parameter('%') != NULL
+                                 && ARGCOUNT == 0);
+  // Local marks and changes are only used for buffers with a file name, e.g.
+  // at startup without file arguments there are none, then these entries are
+  // skipped without decoding them.  The buffer list may add such buffers.
+  bool want_marks = (flags & kShaDaWantMarks) && want_buffer_list;
+  if ((flags & kShaDaWantMarks) && !want_marks) {
+    FOR_ALL_BUFFERS(buf) {
+      if (buf->b_ffname != NULL) {
+        want_marks = true;
+        break;
+      }
+    }
+  }
   const unsigned srni_flags =
     (unsigned)(
                (flags & kShaDaWantInfo
@@ -932,10 +946,7 @@ static void shada_read(FileDescriptor *const sd_reader, const int flags)
                    | (find_shada_parameter('!') != NULL
                       ? kSDReadVariables
                       : 0)
-                   | (find_shada_parameter('%') != NULL
-                      && ARGCOUNT == 0
-                      ? kSDReadBufferList
-                      : 0))
+                   | (want_buffer_list ? kSDReadBufferList : 0))
                 : 0)
                | (want_marks && get_shada_parameter('\'') > 0
                   ? kSDReadLocalMarks | kSDReadChanges
@@ -1759,6 +1770,7 @@ static inline ShaDaWriteResult shada_read_when_writing(FileDescriptor *const sd_
   ShaDaWriteResult ret = kSDWriteSuccessful;
   ShadaEntry entry;
   ShaDaReadResult srni_ret;
+  PMap(cstr_t) fname_bufs = MAP_INIT;
 
 #define COMPARE_WITH_ENTRY(wms_entry_, entry) \
   do { \
@@ -1788,7 +1800,7 @@ static inline ShaDaWriteResult shada_read_when_writing(FileDescriptor *const sd_
       ret = kSDWriteReadNotShada;
       FALLTHROUGH;
     case kSDReadStatusReadError:
-      return ret;
+      goto shada_read_when_writing_end;
     case kSDReadStatusMalformed:
       continue;
     }
@@ -1901,11 +1913,12 @@ static inline ShaDaWriteResult shada_read_when_writing(FileDescriptor *const sd_
       break;
     case kSDItemChange:
     case kSDItemLocalMark: {
-      if (shada_removable(entry.data.filemark.fname)) {
+      const char *const fname = entry.data.filemark.fname;
+      // Files already in file_marks were checked when they were added.
+      if (!map_has(cstr_t, &wms->file_marks, fname) && shada_removable(fname)) {
         shada_free_shada_entry(&entry);
         break;
       }
-      const char *const fname = entry.data.filemark.fname;
       cstr_t *key = NULL;
       bool new_item = false;
       ptr_t *val = pmap_put_ref(cstr_t)(&wms->file_marks, fname, &key, &new_item);
@@ -1942,16 +1955,13 @@ static inline ShaDaWriteResult shada_read_when_writing(FileDescriptor *const sd_
               shada_free_shada_entry(&wms_entry->data);
             }
           } else {
-            FOR_ALL_BUFFERS(buf) {
-              if (buf->b_ffname != NULL
-                  && path_fnamecmp(entry.data.filemark.fname, buf->b_ffname) == 0) {
-                fmark_T fm;
-                mark_get(buf, curwin, &fm, kMarkBufLocal, (int)entry.data.filemark.name);
-                if (fm.timestamp >= entry.timestamp) {
-                  set_wms = false;
-                  shada_free_shada_entry(&entry);
-                  break;
-                }
+            buf_T *const buf = find_buffer(&fname_bufs, entry.data.filemark.fname);
+            if (buf != NULL) {
+              fmark_T fm;
+              mark_get(buf, curwin, &fm, kMarkBufLocal, (int)entry.data.filemark.name);
+              if (fm.timestamp >= entry.timestamp) {
+                set_wms = false;
+                shada_free_shada_entry(&entry);
               }
             }
           }
@@ -2019,7 +2029,13 @@ static inline ShaDaWriteResult shada_read_when_writing(FileDescriptor *const sd_
       break;
     }
   }
+shada_read_when_writing_end: {}
 #undef COMPARE_WITH_ENTRY
+  const char *key;
+  map_foreach_key(&fname_bufs, key, {
+    xfree((char *)key);
+  })
+  map_destroy(cstr_t, &fname_bufs);
   return ret;
 }
 
@@ -3814,6 +3830,13 @@ void check_marks_read(void)
   if (!curbuf->b_marks_read && get_shada_parameter('\'') > 0
       && curbuf->b_ffname != NULL) {
     shada_read_marks();
+    // This has read the marks of all buffers with a name, loading them later
+    // does not need to read the file again (e.g. when restoring a session).
+    FOR_ALL_BUFFERS(buf) {
+      if (buf->b_ffname != NULL) {
+        buf->b_marks_read = true;
+      }
+    }
   }
 
   // Always set b_marks_read; needed when 'shada' is changed to include
@@ -396,6 +396,17 @@ int init_sign_text(sign_T *sp, schar_T *sign_text, char *text)
   return OK;
 }
 
+/// Translate the text of all defined signs while compacting the glyph cache.
+void sign_remap_glyphs(void)
+{
+  sign_T *sp;
+  map_foreach_value(&sign_map, sp, {
+    for (int i = 0; i < SIGN_WIDTH; i++) {
+      sp->sn_text[i] = schar_cache_remap(sp->sn_text[i]);
+    }
+  });
+}
+
 /// Define a new sign or update an existing sign
 static int sign_define_by_name(char *name, char *icon, char *text, char *linehl, char *texthl,
                                char *culhl, char *numhl, int prio)
@@ -86,6 +86,7 @@
 #include "nvim/insexpand.h"
 #include "nvim/log.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
@@ -190,6 +191,10 @@ bool did_set_spelltab;
 # include "spell.c.generated.h"
 #endif
 
+/// Incremented whenever checking the same text may give a different result,
+/// to invalidate the b_spell_clean caches of all buffers.
+static int spell_state_tick = 0;
+
 /// mode values for find_word
 enum {
   FIND_FOLDWORD     = 0,  ///< find word case-folded
@@ -1335,6 +1340,12 @@ size_t spell_move_to(win_T *wp, int dir, smt_T behaviour, bool curline, hlf_T *a
   linenr_T decor_lnum = -1;
   decor_spell_nav_start(wp);
 
+  // Syntax items, extmarks and decoration providers can change which words
+  // are checked without changing the text, lines without bad words are only
+  // remembered without them.
+  const bool may_use_clean = !has_syntax && wp->w_buffer->b_marktree->n_keys == 0
+                             && !decor_providers_have_spell_nav();
+
   while (!got_int) {
     char *line = ml_get_buf(wp->w_buffer, lnum);
 
@@ -1370,6 +1381,19 @@ size_t spell_move_to(win_T *wp, int dir, smt_T behaviour, bool curline, hlf_T *a
     // possible.  Note: this ml_get_buf() may make "line" invalid, check
     // for empty line first.
     bool empty_line = *skipwhite(line) == NUL;
+
+    // A line found to have no bad words before doesn't need to be checked
+    // again. The cursor line is always checked, as only part of it is used.
+    bool use_clean = may_use_clean && !curline && lnum != wp->w_cursor.lnum;
+    int const skip_in = skip;
+    int const capcol_in = capcol;
+    int skip_out = 0;
+    bool clean = true;
+    if (use_clean && spell_clean_line_get(wp, lnum, skip_in, &capcol, &skip_out)) {
+      attr = HLF_COUNT;
+      goto nextline;
+    }
+
     STRCPY(buf, line);
     if (lnum < wp->w_buffer->b_ml.ml_line_count) {
       spell_cat_line(buf + strlen(buf),
@@ -1393,6 +1417,7 @@ size_t spell_move_to(win_T *wp, int dir, smt_T behaviour, bool curline, hlf_T *a
       len = spell_check(wp, p, &attr, &capcol, false);
 
       if (attr != HLF_COUNT) {
+        clean = false;
         // We found a bad word.  Check the attribute.
         if (behaviour == SMT_ALL
             || (behaviour == SMT_BAD && attr == HLF_SPB)
@@ -1466,6 +1491,15 @@ size_t spell_move_to(win_T *wp, int dir, smt_T behaviour, bool curline, hlf_T *a
       goto theend;
     }
 
+    // Characters at the start of the next line that were included in a
+    // match crossing line boundaries.
+    skip_out = attr == HLF_COUNT ? (int)(p - endp) : 0;
+    if (use_clean && clean) {
+      spell_clean_line_put(wp, lnum, skip_in, capcol_in, skip_out, capcol);
+    }
+
+nextline:
+
     if (curline) {
       break;            // only check cursor line
     }
@@ -1515,11 +1549,7 @@ size_t spell_move_to(win_T *wp, int dir, smt_T behaviour, bool curline, hlf_T *a
 
       // Skip the characters at the start of the next line that were
       // included in a match crossing line boundaries.
-      if (attr == HLF_COUNT) {
-        skip = (int)(p - endp);
-      } else {
-        skip = 0;
-      }
+      skip = skip_out;
 
       // Capcol skips over the inserted space.
       capcol--;
@@ -1540,6 +1570,87 @@ theend:
   return ret;
 }
 
+/// Get the cached result of spell_move_to() for line "lnum", if it was found
+/// to have no bad words when entered in the same state.
+///
+/// @param[in,out] capcol  column for the capital check, updated for the end of the line
+/// @param[out] skip_out  number of bytes of the next line included in the last word
+///
+/// @return  true if "lnum" is known to have no bad words
+static bool spell_clean_line_get(win_T *wp, linenr_T lnum, int skip, int *capcol, int *skip_out)
+{
+  synblock_T *s = wp->w_s;
+  varnumber_T tick = buf_get_changedtick(wp->w_buffer);
+  if (s->b_spell_clean_tick != tick || s->b_spell_clean_state != spell_state_tick) {
+    map_clear(int64_t, &s->b_spell_clean);
+    s->b_spell_clean_tick = tick;
+    s->b_spell_clean_state = spell_state_tick;
+    return false;
+  }
+  if (!map_has(int64_t, &s->b_spell_clean, lnum)) {
+    return false;
+  }
+
+  uint64_t val = (uint64_t)map_get(int64_t, int64_t)(&s->b_spell_clean, lnum);
+  // A negative "capcol" never gets to zero, its value doesn't matter.
+  int capcol_in = MAX(*capcol, -1);
+  if ((int16_t)(val >> 48) != skip || (int16_t)(val >> 32) != capcol_in) {
+    return false;
+  }
+  *skip_out = (int16_t)(val >> 16);
+  *capcol = (int16_t)val;
+  return true;
+}
+
+/// Remember that line "lnum" has no bad words when entered with "skip" and
+/// "capcol", and how it left "skip_out" and "capcol_out".
+static void spell_clean_line_put(win_T *wp, linenr_T lnum, int skip, int capcol, int skip_out,
+                                 int capcol_out)
+{
+  capcol = MAX(capcol, -1);
+  capcol_out = MAX(capcol_out, -1);
+  if (skip > INT16_MAX || capcol > INT16_MAX || skip_out > INT16_MAX || capcol_out > INT16_MAX) {
+    return;
+  }
+  synblock_T *s = wp->w_s;
+  if (s->b_spell_clean_tick != buf_get_changedtick(wp->w_buffer)) {
+    return;  // changed by a callback while checking
+  }
+  uint64_t val = ((uint64_t)(uint16_t)skip << 48) | ((uint64_t)(uint16_t)capcol << 32)
+                 | ((uint64_t)(uint16_t)skip_out << 16) | (uint16_t)capcol_out;
+  map_put(int64_t, int64_t)(&s->b_spell_clean, lnum, (int64_t)val);
+}
+
+/// @return  whether "a" and "b" hold the same languages and regions
+static bool spell_langp_equal(const garray_T *a, const garray_T *b)
+{
+  if (a->ga_len != b->ga_len) {
+    return false;
+  }
+  for (int i = 0; i < a->ga_len; i++) {
+    langp_T *lpa = LANGP_ENTRY(*a, i);
+    langp_T *lpb = LANGP_ENTRY(*b, i);
+    if (lpa->lp_slang != lpb->lp_slang || lpa->lp_region != lpb->lp_region) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Forget the lines without bad words of "synblock", after changing one of its
+/// spell options.
+void spell_clean_lines_clear(synblock_T *synblock)
+{
+  map_clear(int64_t, &synblock->b_spell_clean);
+}
+
+/// Called when the result of checking the same text may change, e.g. when a
+/// word list is (re)loaded or a spell option is changed.
+void spell_state_changed(void)
+{
+  spell_state_tick++;
+}
+
 // For spell checking: concatenate the start of the following line "line" into
 // "buf", blanking-out special characters.  Copy less than "maxlen" bytes.
 // Keep the blanks at the start of the next line, this is used in win_line()
@@ -1952,6 +2063,7 @@ char *parse_spelllang(win_T *wp)
   // it under our fingers.
   char *spl_copy = xstrdup(wp->w_s->b_p_spl);
 
+  int const old_cjk = wp->w_s->b_cjk;
   wp->w_s->b_cjk = 0;
 
   // Loop over comma separated language names.
@@ -2164,6 +2276,11 @@ char *parse_spelllang(win_T *wp)
   }
 
   // Everything is fine, store the new b_langp value.
+  // Re-parsing is done e.g. when entering a buffer, only invalidate cached
+  // results when the languages did change.
+  if (!spell_langp_equal(&wp->w_s->b_langp, &ga) || old_cjk != wp->w_s->b_cjk) {
+    spell_state_changed();
+  }
   ga_clear(&wp->w_s->b_langp);
   wp->w_s->b_langp = ga;
 
@@ -2355,6 +2472,7 @@ void spell_free_all(void)
 
   XFREE_CLEAR(repl_to);
   XFREE_CLEAR(repl_from);
+  spell_state_changed();
 }
 
 // Clear all spelling tables and reload them.
@@ -3714,5 +3832,6 @@ const char *compile_cap_prog(synblock_T *synblock)
   }
 
   vim_regfree(rp);
+  spell_clean_lines_clear(synblock);
   return NULL;
 }
@@ -406,6 +406,12 @@ typedef struct {
 
 #define HI2CI(hi)   ((compitem_T *)(hi)->hi_key)
 
+// Part of a spell file read into memory, for reading a word tree.
+typedef struct {
+  const uint8_t *p;             // next byte to read
+  const uint8_t *end;           // end of the bytes read
+} TreeReader;
+
 // Structure that is used to store the items in the word tree.  This avoids
 // the need to keep track of each allocated thing, everything is freed all at
 // once after ":mkspell" is done.
@@ -1685,14 +1691,53 @@ static int spell_read_tree(FILE *fd, uint8_t **bytsp, int *bytsp_len, idx_T **id
   idx_T *ip = xcalloc((size_t)len, sizeof(*ip));
   *idxsp = ip;
 
+  // The tree is encoded with a variable number of bytes per node, reading
+  // them one getc() at a time is slow.  Read the rest of the file into memory
+  // and continue reading the file after the tree when done.
+  off_T start = vim_ftell(fd);
+  if (start < 0 || vim_fseek(fd, 0, SEEK_END) != 0) {
+    return SP_FORMERROR;
+  }
+  off_T size = vim_ftell(fd) - start;
+  if (size <= 0 || vim_fseek(fd, start, SEEK_SET) != 0) {
+    return SP_TRUNCERROR;
+  }
+  uint8_t *buf = xmalloc((size_t)size);
+  TreeReader tr = { .p = buf, .end = buf };
+  tr.end += fread(buf, 1, (size_t)size, fd);
+
   // Recursively read the tree and store it in the array.
-  int idx = read_tree_node(fd, bp, ip, len, 0, prefixtree, prefixcnt);
+  int idx = read_tree_node(&tr, bp, ip, len, 0, prefixtree, prefixcnt);
+  if (idx >= 0 && vim_fseek(fd, start + (tr.p - buf), SEEK_SET) != 0) {
+    idx = SP_TRUNCERROR;
+  }
+  xfree(buf);
   if (idx < 0) {
     return idx;
   }
   return 0;
 }
 
+/// Like getc() on the part of the spell file in "tr".
+static int tree_getc(TreeReader *tr)
+{
+  return tr->p < tr->end ? *tr->p++ : EOF;
+}
+
+/// Like get2c() and get3c() on the part of the spell file in "tr".
+static int tree_getnc(TreeReader *tr, int n)
+{
+  if (tr->end - tr->p < n) {
+    tr->p = tr->end;
+    return EOF;
+  }
+  int c = 0;
+  for (int i = 0; i < n; i++) {
+    c = (c << 8) + *tr->p++;
+  }
+  return c;
+}
+
 /// Read one row of siblings from the spell file and store it in the byte array
 /// "byts" and index array "idxs".  Recursively read the children.
 ///
@@ -1706,13 +1751,13 @@ static int spell_read_tree(FILE *fd, uint8_t **bytsp, int *bytsp_len, idx_T **id
 /// @param startidx  current index in "byts" and "idxs"
 /// @param prefixtree  true for reading PREFIXTREE
 /// @param maxprefcondnr  maximum for <prefcondnr>
-static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, idx_T startidx,
-                            bool prefixtree, int maxprefcondnr)
+static idx_T read_tree_node(TreeReader *tr, uint8_t *byts, idx_T *idxs, int maxidx,
+                            idx_T startidx, bool prefixtree, int maxprefcondnr)
 {
   idx_T idx = startidx;
 #define SHARED_MASK     0x8000000
 
-  int len = getc(fd);                                       // <siblingcount>
+  int len = tree_getc(tr);                                    // <siblingcount>
   if (len <= 0) {
     return SP_TRUNCERROR;
   }
@@ -1724,7 +1769,7 @@ static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, id
 
   // Read the byte values, flag/region bytes and shared indexes.
   for (int i = 1; i <= len; i++) {
-    int c = getc(fd);                                       // <byte>
+    int c = tree_getc(tr);                                    // <byte>
     if (c < 0) {
       return SP_TRUNCERROR;
     }
@@ -1739,14 +1784,14 @@ static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, id
           // byte, the condition index shifted up 8 bits, the flags
           // shifted up 24 bits.
           if (c == BY_FLAGS) {
-            c = getc(fd) << 24;                         // <pflags>
+            c = tree_getc(tr) << 24;                      // <pflags>
           } else {
             c = 0;
           }
 
-          c |= getc(fd);                                // <affixID>
+          c |= tree_getc(tr);                             // <affixID>
 
-          int n = get2c(fd);                                // <prefcondnr>
+          int n = tree_getnc(tr, 2);                          // <prefcondnr>
           if (n >= maxprefcondnr) {
             return SP_FORMERROR;
           }
@@ -1756,15 +1801,15 @@ static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, id
                     // idxs[] the flags go in the low two bytes, region above
                     // that and prefix ID above the region.
           int c2 = c;
-          c = getc(fd);                                 // <flags>
+          c = tree_getc(tr);                              // <flags>
           if (c2 == BY_FLAGS2) {
-            c = (getc(fd) << 8) + c;                    // <flags2>
+            c = (tree_getc(tr) << 8) + c;                 // <flags2>
           }
           if (c & WF_REGION) {
-            c = (getc(fd) << 16) + c;                   // <region>
+            c = (tree_getc(tr) << 16) + c;                // <region>
           }
           if (c & WF_AFX) {
-            c = (getc(fd) << 24) + c;                   // <affixID>
+            c = (tree_getc(tr) << 24) + c;                // <affixID>
           }
         }
 
@@ -1772,12 +1817,12 @@ static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, id
         c = 0;
       } else {  // c == BY_INDEX
         // <nodeidx>
-        int n = get3c(fd);
+        int n = tree_getnc(tr, 3);
         if (n < 0 || n >= maxidx) {
           return SP_FORMERROR;
         }
         idxs[idx] = n + SHARED_MASK;
-        c = getc(fd);                                   // <xbyte>
+        c = tree_getc(tr);                                // <xbyte>
       }
     }
     byts[idx++] = (uint8_t)c;
@@ -1792,7 +1837,7 @@ static idx_T read_tree_node(FILE *fd, uint8_t *byts, idx_T *idxs, int maxidx, id
         idxs[startidx + i] &= ~SHARED_MASK;
       } else {
         idxs[startidx + i] = idx;
-        idx = read_tree_node(fd, byts, idxs, maxidx, idx, prefixtree, maxprefcondnr);
+        idx = read_tree_node(tr, byts, idxs, maxidx, idx, prefixtree, maxprefcondnr);
         if (idx < 0) {
           break;
         }
@@ -1827,6 +1872,7 @@ static void spell_reload_one(char *fname, bool added_word)
   if (added_word && !didit) {
     parse_spelllang(curwin);
   }
+  spell_state_changed();
 }
 
 // Functions for ":mkspell".
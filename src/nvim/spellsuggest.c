@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "nvim/ascii_defs.h"
 #include "nvim/buffer_defs.h"
@@ -99,6 +100,24 @@ typedef struct {
 
 #define SUG(ga, i) (((suggest_T *)(ga).ga_data)[i])
 
+/// Function called for each suggestion by sug_foreach().  It may only change
+/// "stp", it can be called in another thread.
+typedef void (*SugFunc)(suginfo_T *su, suggest_T *stp, void *arg);
+
+/// Part of the suggestions handled by one thread of sug_foreach().
+typedef struct {
+  suginfo_T *su;
+  garray_T *gap;
+  SugFunc fn;
+  void *arg;
+  int start;
+  int end;
+} sugchunk_T;
+
+// Minimal number of suggestions for which sug_foreach() uses threads.
+#define SUG_PARALLEL_MIN 64
+#define SUG_PARALLEL_MAX_THREADS 8
+
 // True if a word appears in the list of banned words.
 #define WAS_BANNED(su, word) (!HASHITEM_EMPTY(hash_find(&(su)->su_banned, word)))
 
@@ -2488,6 +2507,25 @@ static void score_comp_sal(suginfo_T *su)
   }
 }
 
+/// Argument of combine_one().
+typedef struct {
+  slang_T *slang;
+  char *badsound;
+} combinearg_T;
+
+/// Add the sound-a-like score of one suggestion for score_combine().
+static void combine_one(suginfo_T *su, suggest_T *stp, void *arg)
+{
+  combinearg_T *ca = arg;
+  stp->st_altscore = stp_sal_score(stp, su, ca->slang, ca->badsound);
+  if (stp->st_altscore == SCORE_MAXMAX) {
+    stp->st_score = (stp->st_score * 3 + SCORE_BIG) / 4;
+  } else {
+    stp->st_score = (stp->st_score * 3 + stp->st_altscore) / 4;
+  }
+  stp->st_salscore = false;
+}
+
 /// Combine the list of suggestions in su->su_ga and su->su_sga.
 /// They are entwined.
 static void score_combine(suginfo_T *su)
@@ -2505,16 +2543,8 @@ static void score_combine(suginfo_T *su)
       slang = lp->lp_slang;
       spell_soundfold(slang, su->su_fbadword, true, badsound);
 
-      for (int i = 0; i < su->su_ga.ga_len; i++) {
-        suggest_T *stp = &SUG(su->su_ga, i);
-        stp->st_altscore = stp_sal_score(stp, su, slang, badsound);
-        if (stp->st_altscore == SCORE_MAXMAX) {
-          stp->st_score = (stp->st_score * 3 + SCORE_BIG) / 4;
-        } else {
-          stp->st_score = (stp->st_score * 3 + stp->st_altscore) / 4;
-        }
-        stp->st_salscore = false;
-      }
+      combinearg_T ca = { .slang = slang, .badsound = badsound };
+      sug_foreach(su, &su->su_ga, combine_one, &ca);
       break;
     }
   }
@@ -3067,13 +3097,13 @@ static void add_suggestion(suginfo_T *su, garray_T *gap, const char *goodword, i
           // word to keep it fast, while some special methods set
           // the soundalike score to zero.
           if (had_bonus) {
-            rescore_one(su, stp);
+            rescore_one(su, stp, NULL);
           } else {
             new_sug.st_word = stp->st_word;
             new_sug.st_wordlen = stp->st_wordlen;
             new_sug.st_slang = stp->st_slang;
             new_sug.st_orglen = badlen;
-            rescore_one(su, &new_sug);
+            rescore_one(su, &new_sug, NULL);
           }
         }
 
@@ -3158,14 +3188,45 @@ static void add_banned(suginfo_T *su, char *word)
 static void rescore_suggestions(suginfo_T *su)
 {
   if (su->su_sallang != NULL) {
-    for (int i = 0; i < su->su_ga.ga_len; i++) {
-      rescore_one(su, &SUG(su->su_ga, i));
-    }
+    sug_foreach(su, &su->su_ga, rescore_one, NULL);
   }
 }
 
+static void sug_chunk_thread(void *arg)
+{
+  sugchunk_T *chunk = arg;
+  for (int i = chunk->start; i < chunk->end; i++) {
+    chunk->fn(chunk->su, &SUG(*chunk->gap, i), chunk->arg);
+  }
+}
+
+/// Call "fn" for each suggestion in "gap".  Sound-folding a word is slow, with
+/// a high count the suggestions are split over several threads.  Each call
+/// only changes its own suggestion, the result does not depend on the order.
+static void sug_foreach(suginfo_T *su, garray_T *gap, SugFunc fn, void *arg)
+{
+  int nthreads = MIN((int)uv_available_parallelism(), SUG_PARALLEL_MAX_THREADS);
+  if (gap->ga_len < SUG_PARALLEL_MIN) {
+    nthreads = 1;
+  }
+
+  sugchunk_T chunks[SUG_PARALLEL_MAX_THREADS];
+  for (int i = 0; i < nthreads; i++) {
+    chunks[i] = (sugchunk_T){
+      .su = su,
+      .gap = gap,
+      .fn = fn,
+      .arg = arg,
+      .start = gap->ga_len * i / nthreads,
+      .end = gap->ga_len * (i + 1) / nthreads,
+    };
+  }
+
+  run_in_threads(chunks, (size_t)nthreads, sizeof(*chunks), sug_chunk_thread);
+}
+
 /// Recompute the score for one suggestion if sound-folding is possible.
-static void rescore_one(suginfo_T *su, suggest_T *stp)
+static void rescore_one(suginfo_T *su, suggest_T *stp, void *arg)
 {
   slang_T *slang = stp->st_slang;
   char sal_badword[MAXWLEN];
@@ -1,6 +1,8 @@
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/autocmd_defs.h"
@@ -24,15 +26,30 @@
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
 #include "nvim/state.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 
+typedef struct {
+  IdleTaskFn fn;
+  void *data;
+} IdleTask;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "state.c.generated.h"
 #endif
 
+/// Time given to idle tasks each time the main loop is about to wait for input.
+#define IDLE_TASK_BUDGET_NS (4 * 1000 * 1000)
+
+static kvec_t(IdleTask) idle_tasks = KV_INITIAL_VALUE;
+static size_t idle_task_next = 0;  ///< task to run first in the next round
+
+/// Whether the last key executed by state_enter() was K_EVENT.
+static bool executed_event = false;
+
 void state_enter(VimState *s)
   FUNC_ATTR_NONNULL_ALL
 {
@@ -63,6 +80,7 @@ getkey:
     } else if (!multiqueue_empty(main_loop.events)) {
       // No input available and processing events may take time, flush now.
       ui_flush();
+      input_latency_flushed();
       // Event was made available after the last multiqueue_process_events call
       key = K_EVENT;
     } else {
@@ -70,17 +88,33 @@ getkey:
       // redraw_later, this can't be done in command-line or when waiting for "Press ENTER".
       // In many of those cases the redraw is expected AFTER the key press, while normally it should
       // update the screen immediately.
+      int wait_time = -1;
       if (must_redraw != 0 && !need_wait_return && (State & MODE_CMDLINE) == 0) {
-        update_screen();
-        setcursor();  // put cursor back where it belongs
+        if (state_redraw_postponed()) {
+          // Wake up to check the state and update the screen when 'redrawinterval' has passed.
+          wait_time = redraw_wait_time();
+        } else {
+          update_screen();
+          setcursor();  // put cursor back where it belongs
+        }
+      }
+      // Do background work, and don't block for input if any is left.
+      bool idle_busy = idle_tasks_run();
+      if (idle_busy) {
+        wait_time = 0;
       }
       // Flush screen updates before blocking.
       ui_flush();
+      input_latency_flushed();
       // Call `input_get` directly to block for events or user input without consuming anything from
       // `os/input.c:input_buffer` or calling the mapping engine.
-      input_get(NULL, 0, -1, typebuf.tb_change_cnt, main_loop.events);
-      // If an event was put into the queue, we send K_EVENT directly.
-      if (!input_available() && !multiqueue_empty(main_loop.events)) {
+      input_get(NULL, 0, wait_time, typebuf.tb_change_cnt, main_loop.events);
+      if (idle_busy && !input_available() && multiqueue_empty(main_loop.events)) {
+        goto getkey;  // continue the idle tasks
+      }
+      // If an event was put into the queue, or 'redrawinterval' has passed, we send K_EVENT
+      // directly.
+      if (!input_available() && (wait_time >= 0 || !multiqueue_empty(main_loop.events))) {
         key = K_EVENT;
       } else {
         goto getkey;
@@ -99,6 +133,7 @@ getkey:
     DLOG("input: %s", keyname);
 #endif
 
+    executed_event = key == K_EVENT;
     int execute_result = s->execute(s, key);
     if (!execute_result) {
       break;
@@ -108,6 +143,56 @@ getkey:
   }
 }
 
+/// Registers a task which is run in small steps while Nvim waits for input.
+///
+/// Steps run only when no input and no events are pending, for at most a few
+/// milliseconds together, so the task must be able to stop at "deadline" and
+/// continue in the next step. A task must not change what the user sees
+/// without redrawing it.
+void idle_task_add(IdleTaskFn fn, void *data)
+{
+  kv_push(idle_tasks, ((IdleTask){ .fn = fn, .data = data }));
+}
+
+/// Removes the tasks added with "fn" and "data", if they are not finished yet.
+void idle_task_remove(IdleTaskFn fn, void *data)
+{
+  for (size_t i = 0; i < kv_size(idle_tasks);) {
+    if (kv_A(idle_tasks, i).fn == fn && kv_A(idle_tasks, i).data == data) {
+      kv_A(idle_tasks, i) = kv_pop(idle_tasks);
+    } else {
+      i++;
+    }
+  }
+}
+
+/// Runs idle tasks in turn, until the time budget is used or input arrives.
+///
+/// @return true if any task is not finished
+static bool idle_tasks_run(void)
+{
+  if (kv_size(idle_tasks) == 0) {
+    return false;
+  }
+
+  uint64_t deadline = os_hrtime() + IDLE_TASK_BUDGET_NS;
+  while (kv_size(idle_tasks) > 0 && os_hrtime() < deadline) {
+    if (idle_task_next >= kv_size(idle_tasks)) {
+      idle_task_next = 0;
+    }
+    IdleTask task = kv_A(idle_tasks, idle_task_next);
+    if (task.fn(task.data, deadline)) {
+      idle_task_remove(task.fn, task.data);
+    } else {
+      idle_task_next++;
+    }
+    if (input_available() || !multiqueue_empty(main_loop.events)) {
+      break;
+    }
+  }
+  return kv_size(idle_tasks) > 0;
+}
+
 /// process events on main_loop, but interrupt if input is available
 ///
 /// This should be used to handle K_EVENT in states accepting input
@@ -135,6 +220,14 @@ void state_handle_k_event(void)
   }
 }
 
+/// Whether the screen update after handling events should be postponed,
+/// because the screen was updated less than 'redrawinterval' ago.
+/// state_enter() updates the screen before waiting for input once it has passed.
+bool state_redraw_postponed(void)
+{
+  return executed_event && redraw_wait_time() > 0;
+}
+
 /// Return true if in the current mode we need to use virtual.
 bool virtual_active(win_T *wp)
 {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 typedef struct vim_state VimState;
 
 typedef int (*state_check_callback)(VimState *state);
@@ -10,6 +13,13 @@ struct vim_state {
   state_execute_callback execute;
 };
 
+/// Step of an idle task, see idle_task_add().
+///
+/// @param data      data given to idle_task_add()
+/// @param deadline  os_hrtime() value at which the step should return
+/// @return true when the task is finished, false to be called again
+typedef bool (*IdleTaskFn)(void *data, uint64_t deadline);
+
 /// Values for State
 ///
 /// The lower bits up to 0x80 are used to distinguish normal/visual/op_pending
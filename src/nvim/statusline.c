@@ -26,6 +26,7 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/highlight_group.h"
 #include "nvim/macros_defs.h"
+#include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
 #include "nvim/memline_defs.h"
@@ -87,6 +88,7 @@ void win_redr_status(win_T *wp)
     // Don't redraw right now, do it later. Don't update status line when
     // popup menu is visible and may be drawn over it
     wp->w_redr_status = true;
+    wp->w_stl_repaint = false;
   } else if (*p_stl != NUL || *wp->w_p_stl != NUL) {
     // redraw custom status line
     redraw_custom_statusline(wp);
@@ -105,6 +107,9 @@ void win_redr_status(win_T *wp)
     grid_line_put_schar(W_ENDCOL(wp), fillchar, attr);
     grid_line_flush();
   }
+  if (!wp->w_redr_status) {
+    wp->w_stl_repaint = false;
+  }
   busy = false;
 }
 
@@ -208,6 +213,108 @@ void stl_fill_click_defs(StlClickDefinition *click_defs, StlClickRecord *click_r
   }
 }
 
+/// Get the text of a status line or window bar of "wp" from the last
+/// evaluation in "cache", when it was only overwritten on the screen since then
+/// and "fmt" is evaluated with the same width and fill character.
+///
+/// The returned "hltab" and "tabtab" point into "buf" and must be freed.
+///
+/// @return  whether "buf", "hltab" and "tabtab" were filled from the cache.
+static bool stl_cache_get(win_T *wp, StlCache *cache, const char *fmt, int maxwidth,
+                          schar_T fillchar, char *buf, size_t buflen, stl_hlrec_t **hltab,
+                          StlClickRecord **tabtab)
+{
+  if (!wp->w_stl_repaint || cache->fmt == NULL
+      || cache->maxwidth != maxwidth || cache->fillchar != fillchar
+      || cache->is_curwin != (wp == curwin)
+      || cache->buf != wp->w_buffer->handle
+      || cache->changedtick != buf_get_changedtick(wp->w_buffer)
+      || cache->topline != wp->w_topline || !equalpos(cache->cursor, wp->w_cursor)
+      || strcmp(cache->fmt, fmt) != 0) {
+    return false;
+  }
+
+  xstrlcpy(buf, cache->text, buflen);
+  size_t n = 0;
+  while (cache->hltab[n].start != NULL) {
+    n++;
+  }
+  *hltab = arena_alloc(frame_arena(), (n + 1) * sizeof(stl_hlrec_t), true);
+  memcpy(*hltab, cache->hltab, (n + 1) * sizeof(stl_hlrec_t));
+  for (size_t i = 0; i < n; i++) {
+    (*hltab)[i].start = buf + ((*hltab)[i].start - cache->text);
+  }
+  n = 0;
+  while (cache->tabtab[n].start != NULL) {
+    n++;
+  }
+  // The click definitions take ownership of the function names.
+  *tabtab = arena_alloc(frame_arena(), (n + 1) * sizeof(StlClickRecord), true);
+  memcpy(*tabtab, cache->tabtab, (n + 1) * sizeof(StlClickRecord));
+  for (size_t i = 0; i < n; i++) {
+    (*tabtab)[i].start = buf + ((*tabtab)[i].start - cache->text);
+    if ((*tabtab)[i].def.func != NULL) {
+      (*tabtab)[i].def.func = xstrdup((*tabtab)[i].def.func);
+    }
+  }
+  return true;
+}
+
+/// Remember the text "buf" evaluated from "fmt" for the status line or window
+/// bar of "wp" in "cache".
+static void stl_cache_put(win_T *wp, StlCache *cache, const char *fmt, int maxwidth,
+                          schar_T fillchar, const char *buf, const stl_hlrec_t *hltab,
+                          const StlClickRecord *tabtab)
+{
+  stl_cache_clear(cache);
+  cache->fmt = xstrdup(fmt);
+  cache->maxwidth = maxwidth;
+  cache->fillchar = fillchar;
+  cache->is_curwin = wp == curwin;
+  cache->buf = wp->w_buffer->handle;
+  cache->changedtick = buf_get_changedtick(wp->w_buffer);
+  cache->topline = wp->w_topline;
+  cache->cursor = wp->w_cursor;
+  cache->text = xstrdup(buf);
+  const char *end = buf + strlen(buf);
+
+  size_t n = 0;
+  while (hltab[n].start != NULL) {
+    n++;
+  }
+  cache->hltab = xmemdup(hltab, (n + 1) * sizeof(stl_hlrec_t));
+  for (size_t i = 0; i < n; i++) {
+    cache->hltab[i].start = cache->text + (MIN(hltab[i].start, end) - buf);
+  }
+  n = 0;
+  while (tabtab[n].start != NULL) {
+    n++;
+  }
+  cache->tabtab = xmemdup(tabtab, (n + 1) * sizeof(StlClickRecord));
+  for (size_t i = 0; i < n; i++) {
+    cache->tabtab[i].start = cache->text + (MIN(tabtab[i].start, end) - buf);
+    if (tabtab[i].def.func != NULL) {
+      cache->tabtab[i].def.func = xstrdup(tabtab[i].def.func);
+    }
+  }
+}
+
+/// Forget the text remembered in "cache".
+void stl_cache_clear(StlCache *cache)
+{
+  if (cache->fmt == NULL) {
+    return;
+  }
+  for (size_t i = 0; cache->tabtab[i].start != NULL; i++) {
+    xfree(cache->tabtab[i].def.func);
+  }
+  xfree(cache->fmt);
+  xfree(cache->text);
+  xfree(cache->hltab);
+  xfree(cache->tabtab);
+  *cache = (StlCache){ 0 };
+}
+
 /// Redraw the status line, window bar or ruler of window "wp".
 /// When "wp" is NULL redraw the tab pages line from 'tabline'.
 static void win_redr_custom(win_T *wp, bool draw_winbar, bool draw_ruler)
@@ -314,20 +421,31 @@ static void win_redr_custom(win_T *wp, bool draw_winbar, bool draw_ruler)
     goto theend;
   }
 
-  // Temporarily reset 'cursorbind', we don't want a side effect from moving
-  // the cursor away and back.
-  win_T *ewp = wp == NULL ? curwin : wp;
-  int p_crb_save = ewp->w_p_crb;
-  ewp->w_p_crb = false;
-
-  // Make a copy, because the statusline may include a function call that
-  // might change the option value and free the memory.
-  stl = xstrdup(stl);
-  build_stl_str_hl(ewp, buf, sizeof(buf), stl, opt_idx, opt_scope,
-                   fillchar, maxwidth, &hltab, NULL, &tabtab, NULL);
+  // The text of a status line or window bar that was only overwritten can be
+  // drawn again without evaluating the option.
+  StlCache *cache = (wp == NULL || draw_ruler) ? NULL : &wp->w_stl_cache[draw_winbar];
+  bool cached = cache != NULL
+                && stl_cache_get(wp, cache, stl, maxwidth, fillchar, buf, sizeof(buf),
+                                 &hltab, &tabtab);
+  if (!cached) {
+    // Temporarily reset 'cursorbind', we don't want a side effect from moving
+    // the cursor away and back.
+    win_T *ewp = wp == NULL ? curwin : wp;
+    int p_crb_save = ewp->w_p_crb;
+    ewp->w_p_crb = false;
+
+    // Make a copy, because the statusline may include a function call that
+    // might change the option value and free the memory.
+    stl = xstrdup(stl);
+    build_stl_str_hl(ewp, buf, sizeof(buf), stl, opt_idx, opt_scope,
+                     fillchar, maxwidth, &hltab, NULL, &tabtab, NULL);
+    if (cache != NULL) {
+      stl_cache_put(wp, cache, stl, maxwidth, fillchar, buf, hltab, tabtab);
+    }
 
-  xfree(stl);
-  ewp->w_p_crb = p_crb_save;
+    xfree(stl);
+    ewp->w_p_crb = p_crb_save;
+  }
 
   int len = (int)strlen(buf);
   int start_col = col;
@@ -472,10 +590,12 @@ void redraw_ruler(void)
 #define RULER_BUF_LEN 70
   char buffer[RULER_BUF_LEN];
 
-  int bufferlen = vim_snprintf(buffer, RULER_BUF_LEN, "%" PRId64 ",",
-                               (wp->w_buffer->b_ml.ml_flags & ML_EMPTY)
-                               ? 0
-                               : (int64_t)wp->w_cursor.lnum);
+  int bufferlen = (int)vim_fmt_num(buffer, RULER_BUF_LEN - 1,
+                                   (wp->w_buffer->b_ml.ml_flags & ML_EMPTY)
+                                   ? 0
+                                   : wp->w_cursor.lnum, 0);
+  buffer[bufferlen++] = ',';
+  buffer[bufferlen] = NUL;
   bufferlen += col_print(buffer + bufferlen, RULER_BUF_LEN - (size_t)bufferlen,
                          empty_line ? 0 : (int)wp->w_cursor.col + 1,
                          (int)virtcol + 1);
@@ -803,10 +923,10 @@ int build_statuscol_str(win_T *wp, linenr_T lnum, linenr_T relnum, char *buf, st
   }
 
   StlClickRecord *clickrec;
-  char *stc = xstrdup(wp->w_p_stc);
+  // Only drawn inside update_screen(), the copy can use the frame arena.
+  char *stc = arena_memdupz(frame_arena(), wp->w_p_stc, strlen(wp->w_p_stc));
   int width = build_stl_str_hl(wp, buf, MAXPATHL, stc, kOptStatuscolumn, OPT_LOCAL, 0,
                                stcp->width, &stcp->hlrec, NULL, fillclick ? &clickrec : NULL, stcp);
-  xfree(stc);
 
   if (fillclick) {
     stl_clear_click_defs(wp->w_statuscol_click_defs, wp->w_statuscol_click_defs_size);
@@ -1849,6 +1969,8 @@ stcsign:
         // }
 
         vim_snprintf(out_p, remaining_buf_len, nstr, 0, num, n);
+      } else if (base == kNumBaseDecimal && !zeropad && opt != STL_VIRTCOL_ALT) {
+        vim_fmt_num(out_p, remaining_buf_len, num, minwid);
       } else {
         vim_snprintf(out_p, remaining_buf_len, nstr, minwid, num);
       }
@@ -2,8 +2,11 @@
 
 #include <stdbool.h>
 
+#include "nvim/eval/typval_defs.h"
 #include "nvim/fold_defs.h"
+#include "nvim/pos_defs.h"
 #include "nvim/sign_defs.h"
+#include "nvim/types_defs.h"
 
 /// 'statusline' item flags
 typedef enum {
@@ -75,6 +78,21 @@ struct stl_hlrec {
   StlFlag item;            ///< Item flag belonging to highlight (used for 'statuscolumn')
 };
 
+/// Status line or window bar text from the last evaluation, see stl_cache_get().
+typedef struct {
+  char *fmt;                ///< option value that was evaluated, NULL when not valid
+  int maxwidth;             ///< width available for the text
+  schar_T fillchar;         ///< fill character
+  bool is_curwin;           ///< window was the current window
+  handle_T buf;             ///< buffer of the window
+  varnumber_T changedtick;  ///< b:changedtick of the window buffer
+  linenr_T topline;         ///< w_topline of the window
+  pos_T cursor;             ///< w_cursor of the window
+  char *text;               ///< evaluated text
+  stl_hlrec_t *hltab;       ///< highlight records, "start" points into "text"
+  StlClickRecord *tabtab;   ///< click records, "start" points into "text"
+} StlCache;
+
 /// Used for building the status line.
 typedef struct stl_item stl_item_t;
 struct stl_item {
@@ -777,6 +777,64 @@ int vim_snprintf(char *str, size_t str_m, const char *fmt, ...)
   return str_l;
 }
 
+static const char digit_pairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/// Write "num" in decimal to "buf", padded with spaces to at least "width"
+/// cells, like vim_snprintf() with "%*" PRId64: right-aligned, or
+/// left-aligned if "width" is negative.  Skips parsing the format, for line
+/// numbers and cursor positions that are formatted on every redraw.
+///
+/// @param[out]  buf  Buffer to write to, truncated like vim_snprintf().
+/// @param  buflen  Size of "buf", must not be zero.
+///
+/// @return Number of bytes written, excluding the NUL byte.
+size_t vim_fmt_num(char *buf, size_t buflen, int64_t num, int width)
+  FUNC_ATTR_NONNULL_ALL
+{
+  assert(buflen > 0);
+  char digits[24];
+  char *p = digits + sizeof(digits);
+  uint64_t u = num < 0 ? 0 - (uint64_t)num : (uint64_t)num;
+  while (u >= 100) {
+    const char *pair = digit_pairs + (u % 100) * 2;
+    u /= 100;
+    *--p = pair[1];
+    *--p = pair[0];
+  }
+  if (u >= 10) {
+    *--p = digit_pairs[u * 2 + 1];
+    *--p = digit_pairs[u * 2];
+  } else {
+    *--p = (char)('0' + u);
+  }
+  if (num < 0) {
+    *--p = '-';
+  }
+
+  const size_t len = (size_t)(digits + sizeof(digits) - p);
+  const bool left = width < 0;
+  const size_t field = left ? (size_t)-(int64_t)width : (size_t)width;
+  const size_t pad = field > len ? field - len : 0;
+  size_t room = buflen - 1;
+  char *out = buf;
+  const size_t before = left ? 0 : MIN(pad, room);
+  memset(out, ' ', before);
+  out += before;
+  room -= before;
+  const size_t ndigits = MIN(len, room);
+  memcpy(out, p, ndigits);
+  out += ndigits;
+  room -= ndigits;
+  const size_t after = left ? MIN(pad, room) : 0;
+  memset(out, ' ', after);
+  out += after;
+  *out = NUL;
+  return (size_t)(out - buf);
+}
+
 // Return the representation of infinity for printf() function:
 // "-inf", "inf", "+inf", " inf", "-INF", "INF", "+INF" or " INF".
 static const char *infinity_str(bool positive, char fmt_spec, int force_sign,
@@ -32,6 +32,7 @@
 #include "nvim/highlight_group.h"
 #include "nvim/indent_c.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
@@ -39,12 +40,14 @@
 #include "nvim/option_vars.h"
 #include "nvim/optionstr.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
 #include "nvim/profile.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
 #include "nvim/runtime.h"
+#include "nvim/state.h"
 #include "nvim/strings.h"
 #include "nvim/syntax.h"
 #include "nvim/types_defs.h"
@@ -186,6 +189,10 @@ static char *(spo_name_tab[SPO_COUNT]) =
 
 #define MAXKEYWLEN      80          // maximum length of a keyword
 
+// Set and test bit "n" in b_keyw_len_mask[] or b_keyw_start_mask[].
+#define KEYW_MASK_SET(mask, n) ((mask)[(n) / 64] |= (uint64_t)1 << ((n) % 64))
+#define KEYW_MASK_HAS(mask, n) (((mask)[(n) / 64] >> ((n) % 64)) & 1)
+
 // The attributes of the syntax item that has been recognized.
 static int current_attr = 0;        // attr of current syntax word
 static int current_id = 0;          // ID of current char for syn_get_id()
@@ -291,6 +298,9 @@ static int current_line_id = 0;            // unique number for current line
 #define CUR_STATE(idx)  ((stateitem_T *)(current_state.ga_data))[idx]
 
 static bool syn_time_on = false;
+
+// True when syn_fill_states() was added as an idle task.
+static bool syn_fill_queued = false;
 #define IF_SYN_TIME(p) (p)
 
 // Set the timeout used for syntax highlighting.
@@ -337,6 +347,13 @@ void syntax_start(win_T *wp, linenr_T lnum)
   }
   syn_block->b_sst_lasttick = display_tick;
 
+  // With "sync fromstart" every jump needs a saved state above it, let
+  // syn_fill_states() store them while waiting for the user.
+  if (!syn_fill_queued && syn_block->b_syn_sync_minlines == MAXLNUM) {
+    syn_fill_queued = true;
+    idle_task_add(syn_fill_states, NULL);
+  }
+
   // If the state of the end of the previous line is useful, store it.
   if (VALID_STATE(&current_state)
       && current_lnum < lnum
@@ -461,6 +478,49 @@ void syntax_start(win_T *wp, linenr_T lnum)
   syn_start_line();
 }
 
+/// Idle task which stores syntax states from the first line down to the end of
+/// the buffer, for windows using "sync fromstart".  Each chunk starts at the
+/// last saved state that can be reached from line 1 without a gap, so that a
+/// jump anywhere only has to parse from a nearby state.
+static bool syn_fill_states(void *data, uint64_t deadline)
+{
+  FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
+    synblock_T *block = wp->w_s;
+    if (block->b_sst_array == NULL || block->b_sst_len <= Rows
+        || block->b_syn_sync_minlines != MAXLNUM || !syntax_present(wp)) {
+      continue;
+    }
+    linenr_T line_count = wp->w_buffer->b_ml.ml_line_count;
+    linenr_T prev_lnum = 0;
+    while (true) {
+      // The same distance as used by syntax_start() for storing states.
+      linenr_T dist = line_count / (block->b_sst_len - Rows) + 1;
+      linenr_T lnum = 1;
+      for (synstate_T *p = block->b_sst_first; p != NULL; p = p->sst_next) {
+        if (p->sst_lnum > lnum + dist) {
+          break;
+        }
+        if (p->sst_change_lnum == 0) {
+          lnum = p->sst_lnum;
+        }
+      }
+      // Done when the end is reached, or when no state could be stored.
+      if (lnum + dist > line_count || lnum <= prev_lnum) {
+        break;
+      }
+      prev_lnum = lnum;
+      syntax_start(wp, lnum + dist);
+      if (got_int || os_hrtime() >= deadline) {
+        invalidate_current_state();
+        return false;
+      }
+    }
+  }
+  invalidate_current_state();
+  syn_fill_queued = false;
+  return true;
+}
+
 // We cannot simply discard growarrays full of state_items or buf_states; we
 // have to manually release their extmatch pointers first.
 static void clear_syn_state(synstate_T *p)
@@ -1661,8 +1721,9 @@ static int syn_current_attr(const bool syncing, const bool displaying, bool *con
 
               regmatch.rmm_ic = spp->sp_ic;
               regmatch.regprog = spp->sp_prog;
-              int r = syn_regexec(&regmatch, current_lnum, lc_col,
-                                  IF_SYN_TIME(&spp->sp_time));
+              int r = syn_literal_in_line(spp->sp_prog, spp->sp_ic, lc_col)
+                      && syn_regexec(&regmatch, current_lnum, lc_col,
+                                     IF_SYN_TIME(&spp->sp_time));
               spp->sp_prog = regmatch.regprog;
               if (!r) {
                 // no match in this line, try another one
@@ -2659,6 +2720,59 @@ static colnr_T syn_getcurline_len(void)
   return ml_get_buf_len(syn_buf, current_lnum);
 }
 
+/// Check whether the literal text that every match of "prog" contains is in
+/// the current line at or after "col".  This avoids running the regexp engine
+/// for most patterns on most lines.
+///
+/// @return  false only when "prog" cannot match in the current line.
+static bool syn_literal_in_line(const regprog_T *prog, int ic, colnr_T col)
+{
+  if (prog == NULL || re_multiline(prog) || re_lookbehind(prog)) {
+    // Can match text that is not in the current line.
+    return true;
+  }
+  bool lit_ic;
+  int litlen;
+  const char *lit = vim_regprog_literal(prog, ic, &lit_ic, &litlen);
+  if (lit == NULL) {
+    return true;
+  }
+  if (lit_ic) {
+    // Only plain ASCII is found reliably when ignoring case, "k" and "s"
+    // also match a non-ASCII character.
+    for (int i = 0; i < litlen; i++) {
+      const uint8_t c = (uint8_t)lit[i];
+      if (c >= 0x80 || TOLOWER_ASC(c) == 'k' || TOLOWER_ASC(c) == 's') {
+        return true;
+      }
+    }
+  }
+
+  const colnr_T len = syn_getcurline_len();
+  if (col >= len || len - col < litlen) {
+    return false;
+  }
+  const char *p = syn_getcurline() + col;
+  const char *const end = syn_getcurline() + len - litlen;
+  if (!lit_ic) {
+    while ((p = memchr(p, (uint8_t)lit[0], (size_t)(end - p) + 1)) != NULL) {
+      if (memcmp(p, lit, (size_t)litlen) == 0) {
+        return true;
+      }
+      if (p++ == end) {
+        break;
+      }
+    }
+    return false;
+  }
+  for (; p <= end; p++) {
+    if (TOLOWER_ASC(*p) == TOLOWER_ASC(lit[0]) && vim_strnicmp_asc(p, lit, (size_t)litlen) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Call vim_regexec() to find a match with "rmp" in "syn_buf".
 // Returns true when there is a match.
 static bool syn_regexec(regmmatch_T *rmp, linenr_T lnum, colnr_T col, syn_time_T *st)
@@ -2723,7 +2837,9 @@ static int check_keyword_id(char *const line, const int startcol, int *const end
   // checked.
   char *const kwp = line + startcol;
   int kwlen = 0;
+  bool ascii = true;
   do {
+    ascii &= (uint8_t)kwp[kwlen] < 0x80;
     kwlen += utfc_ptr2len(kwp + kwlen);
   } while (vim_iswordp_buf(kwp + kwlen, syn_buf));
 
@@ -2731,6 +2847,14 @@ static int check_keyword_id(char *const line, const int startcol, int *const end
     return 0;
   }
 
+  // Most words are not a keyword, reject them by length and first byte
+  // before copying and hashing.  Only for ASCII words, case folding may
+  // change the length of other text.
+  if (ascii && (!KEYW_MASK_HAS(syn_block->b_keyw_len_mask, kwlen)
+                || !KEYW_MASK_HAS(syn_block->b_keyw_start_mask, (uint8_t)kwp[0]))) {
+    return 0;
+  }
+
   // Must make a copy of the keyword, so we can add a NUL and make it
   // lowercase.
   char keyword[MAXKEYWLEN + 1];         // assume max. keyword len is 80
@@ -2965,6 +3089,8 @@ void syntax_clear(synblock_T *block)
   // free the keywords
   clear_keywtab(&block->b_keywtab);
   clear_keywtab(&block->b_keywtab_ic);
+  CLEAR_FIELD(block->b_keyw_len_mask);
+  CLEAR_FIELD(block->b_keyw_start_mask);
 
   // free the syntax patterns
   for (int i = block->b_syn_patterns.ga_len; --i >= 0;) {
@@ -2994,6 +3120,7 @@ void syntax_clear(synblock_T *block)
   // free the stored states
   syn_stack_free_all(block);
   invalidate_current_state();
+  map_destroy(int64_t, &block->b_spell_clean);
 
   // Reset the counter for ":syn include"
   running_syn_inc_tag = 0;
@@ -3714,6 +3841,17 @@ static void add_keyword(char *const name, size_t namelen, const int id, const in
     name_iclen = namelen;
   }
 
+  // Update the masks used by check_keyword_id() to reject other words.
+  // "name_ic" is lower case when ignoring case, also accept upper case.
+  synblock_T *const block = curwin->w_s;
+  if (name_iclen <= MAXKEYWLEN) {
+    KEYW_MASK_SET(block->b_keyw_len_mask, name_iclen);
+  }
+  KEYW_MASK_SET(block->b_keyw_start_mask, (uint8_t)name_ic[0]);
+  if (block->b_syn_ic) {
+    KEYW_MASK_SET(block->b_keyw_start_mask, (uint8_t)TOUPPER_ASC(name_ic[0]));
+  }
+
   keyentry_T *const kp = xmalloc(offsetof(keyentry_T, keyword) + name_iclen + 1);
   STRCPY(kp->keyword, name_ic);
   kp->k_syn.id = (int16_t)id;
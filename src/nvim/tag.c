@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
@@ -38,6 +39,7 @@
 #include "nvim/input.h"
 #include "nvim/insexpand.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
@@ -55,6 +57,7 @@
 #include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
+#include "nvim/profile.h"
 #include "nvim/quickfix.h"
 #include "nvim/regexp.h"
 #include "nvim/regexp_defs.h"
@@ -165,6 +168,60 @@ typedef struct {
   bool sort_error;   ///< tags file not sorted
 } findtags_match_args_T;
 
+/// Summary of the tag names in one part of a tags file, to skip the parts
+/// without a match in a linear search.
+typedef struct {
+  off_T first_line;        ///< offset of the first line in the chunk, -1 for none
+  bool any;                ///< a tag name starts with a multibyte character
+  uint8_t first[32];       ///< bit set for the lower-cased first byte of a name
+  uint8_t pair[128];       ///< bit set for a hash of the first two bytes
+} tagchunk_T;
+
+/// Chunks of a tags file, see tag_index_get().
+typedef struct {
+  char *ti_fname;          ///< name of the tags file, NULL when not used
+  uint64_t ti_size;        ///< file size when indexed
+  int64_t ti_mtime;        ///< modification time when indexed
+  int64_t ti_mtime_ns;
+  size_t ti_nchunks;
+  tagchunk_T *ti_chunks;
+} tagindex_T;
+
+/// Tags file indexed by one thread of tag_index_prepare().
+typedef struct {
+  tagindex_T tj_index;     ///< the index, ti_fname is the file to read
+  bool tj_ok;              ///< the index was built
+} tagindexjob_T;
+
+/// Part of the jobs handled by one thread of tag_index_prepare().
+typedef struct {
+  tagindexjob_T *tw_jobs;
+  int tw_start;            ///< first job, every tw_step'th job is handled
+  int tw_step;
+  int tw_count;
+  bool tw_skip_foldcase;   ///< skip files sorted with "foldcase"
+} tagindexworker_T;
+
+/// Help tags file kept in memory, see help_tags_file_get().
+typedef struct {
+  uint64_t hf_size;        ///< file size when read
+  int64_t hf_mtime;        ///< modification time when read
+  int64_t hf_mtime_ns;
+  char *hf_data;           ///< the file contents, read in text mode
+  size_t hf_len;
+} helptagsfile_T;
+
+enum {
+  TAG_INDEX_CHUNK = 64 * 1024,          ///< bytes of the tags file per chunk
+  TAG_INDEX_MIN_SIZE = 1024 * 1024,     ///< smaller files are not indexed
+  TAG_INDEX_COUNT = 16,                 ///< number of tags files indexed
+  TAG_INDEX_MAX_THREADS = 8,            ///< threads used by tag_index_prepare()
+};
+
+/// Time in msec after which completion stops searching for more tags once
+/// it found some.
+enum { TAG_MANY_TIMEOUT = 500, };
+
 /// State information used during a tag search
 typedef struct {
   tagsearch_state_T state;       ///< tag search state
@@ -174,6 +231,8 @@ typedef struct {
   int lbuf_size;                 ///< length of lbuf
   char *tag_fname;               ///< name of the tag file
   FILE *fp;                      ///< current tags file pointer
+  helptagsfile_T *mem;           ///< help tags file read instead of "fp"
+  off_T mem_off;                 ///< read offset in "mem"
   int flags;                     ///< flags used for tag search
   int tag_file_sorted;           ///< !_TAG_FILE_SORTED value
   bool get_searchpat;            ///< used for 'showfulltag'
@@ -181,7 +240,10 @@ typedef struct {
   bool did_open;                 ///< did open a tag file
   int mincount;                  ///< MAXCOL: find all matches
                                  ///< other: minimal number of matches
+  proftime_T time_limit;         ///< when completing: stop with matches after
+                                 ///< this time, zero otherwise
   bool linear;                   ///< do a linear search
+  tagindex_T *tag_index;         ///< chunks to skip in a linear search or NULL
   vimconv_T vimconv;
   char help_lang[3];             ///< lang of current tags file
   int help_pri;                  ///< help language priority
@@ -1404,6 +1466,7 @@ static void findtags_state_init(findtags_state_T *st, char *pat, int flags, int
 {
   st->tag_fname = xmalloc(MAXPATHL + 1);
   st->fp = NULL;
+  st->mem = NULL;
   st->orgpat = xmalloc(sizeof(pat_T));
   st->orgpat->pat = pat;
   st->orgpat->len = (int)strlen(pat);
@@ -1418,6 +1481,7 @@ static void findtags_state_init(findtags_state_T *st, char *pat, int flags, int
   st->help_lang[0] = NUL;
   st->help_pri = 0;
   st->mincount = mincount;
+  st->time_limit = mincount == TAG_MANY ? profile_setlimit(TAG_MANY_TIMEOUT) : 0;
   st->lbuf_size = LSIZE;
   st->lbuf = xmalloc((size_t)st->lbuf_size);
   st->match_count = 0;
@@ -1520,6 +1584,439 @@ static int findtags_apply_tfu(findtags_state_T *st, char *pat, char *buf_ffname)
   return retval;
 }
 
+static tagindex_T tag_indexes[TAG_INDEX_COUNT];
+static int tag_index_next = 0;  ///< entry in tag_indexes[] to use next
+
+/// Return the bit in tagchunk_T.pair[] for tag names starting with "c1" "c2".
+static inline unsigned tag_index_pair_bit(uint8_t c1, uint8_t c2)
+{
+  return ((unsigned)TOLOWER_ASC(c1) * 31 + (unsigned)TOLOWER_ASC(c2)) & 1023;
+}
+
+/// Add a tag line at offset "off" to the index, its name starts with the "len"
+/// bytes of "name".
+static void tag_index_add_line(tagindex_T *ti, off_T off, const uint8_t *name, int len)
+{
+  tagchunk_T *chunk = &ti->ti_chunks[off / TAG_INDEX_CHUNK];
+  if (chunk->first_line < 0) {
+    chunk->first_line = off;
+  }
+  if ((len >= 1 && name[0] >= 0x80) || (len >= 2 && name[1] >= 0x80)) {
+    chunk->any = true;
+    return;
+  }
+  if (len >= 1) {
+    uint8_t c = (uint8_t)TOLOWER_ASC(name[0]);
+    chunk->first[c >> 3] |= (uint8_t)(1 << (c & 7));
+  }
+  if (len >= 2) {
+    unsigned bit = tag_index_pair_bit(name[0], name[1]);
+    chunk->pair[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+  }
+}
+
+/// Read tags file "fname" and fill the chunks of "ti".
+static bool tag_index_build(tagindex_T *ti, const char *fname)
+{
+  FILE *fd = os_fopen(fname, "rb");  // raw offsets, also where "\r\n" is used
+  if (fd == NULL) {
+    return false;
+  }
+  ti->ti_nchunks = (size_t)(ti->ti_size / TAG_INDEX_CHUNK) + 1;
+  ti->ti_chunks = xcalloc(ti->ti_nchunks, sizeof(tagchunk_T));
+  for (size_t i = 0; i < ti->ti_nchunks; i++) {
+    ti->ti_chunks[i].first_line = -1;
+  }
+
+  uint8_t *buf = xmalloc(TAG_INDEX_CHUNK);
+  uint8_t name[2];
+  int namelen = 0;
+  bool in_name = false;   // collecting the start of a tag name
+  bool at_start = true;   // next byte starts a line
+  off_T line_off = 0;
+  off_T pos = 0;
+  size_t len;
+  bool ok = true;
+  while ((len = fread(buf, 1, TAG_INDEX_CHUNK, fd)) > 0) {
+    if ((uint64_t)pos + len > ti->ti_size) {
+      ok = false;  // file grew while reading it
+      break;
+    }
+    for (size_t i = 0; i < len; i++) {
+      uint8_t c = buf[i];
+      if (at_start) {
+        line_off = pos + (off_T)i;
+        namelen = 0;
+        in_name = true;
+        at_start = false;
+      }
+      if (c == '\n') {
+        at_start = true;
+      }
+      if (in_name) {
+        if (c == TAB || c == '\n' || c == '\r' || namelen == 2) {
+          tag_index_add_line(ti, line_off, name, namelen);
+          in_name = false;
+        } else {
+          name[namelen++] = c;
+        }
+      }
+    }
+    pos += (off_T)len;
+  }
+  if (in_name) {
+    tag_index_add_line(ti, line_off, name, namelen);
+  }
+  xfree(buf);
+  fclose(fd);
+  return ok;
+}
+
+/// Free the entry "ti" in tag_indexes[].
+static void tag_index_clear(tagindex_T *ti)
+{
+  xfree(ti->ti_fname);
+  xfree(ti->ti_chunks);
+  CLEAR_POINTER(ti);
+}
+
+/// Set the size and modification time of "ti" from "file_info".
+static void tag_index_set_stamp(tagindex_T *ti, const FileInfo *file_info)
+{
+  ti->ti_size = os_fileinfo_size(file_info);
+  ti->ti_mtime = (int64_t)file_info->stat.st_mtim.tv_sec;
+  ti->ti_mtime_ns = (int64_t)file_info->stat.st_mtim.tv_nsec;
+}
+
+/// Find the entry in tag_indexes[] for tags file "fname".  "*valid" is set
+/// when the entry has the size and modification time of "stamp".
+///
+/// @param claim  when there is no entry for "fname", return the entry to
+///               reuse for it
+static tagindex_T *tag_index_lookup(const char *fname, const tagindex_T *stamp, bool claim,
+                                    bool *valid)
+{
+  *valid = false;
+  for (int i = 0; i < TAG_INDEX_COUNT; i++) {
+    tagindex_T *ti = &tag_indexes[i];
+    if (ti->ti_fname != NULL && strcmp(ti->ti_fname, fname) == 0) {
+      *valid = ti->ti_size == stamp->ti_size && ti->ti_mtime == stamp->ti_mtime
+               && ti->ti_mtime_ns == stamp->ti_mtime_ns;
+      return ti;
+    }
+  }
+  if (!claim) {
+    return NULL;
+  }
+  tagindex_T *ti = &tag_indexes[tag_index_next];
+  tag_index_next = (tag_index_next + 1) % TAG_INDEX_COUNT;
+  return ti;
+}
+
+/// Get the index of tags file "fname", building it when the file changed.
+/// The index divides the file in chunks of TAG_INDEX_CHUNK bytes and remembers
+/// how the tag names in each chunk start, ignoring case.  A linear search,
+/// used when ignoring case in a tags file sorted on case, can then skip the
+/// chunks that can't have a match.
+///
+/// @return  NULL for a small file or when the file can't be read.
+static tagindex_T *tag_index_get(const char *fname)
+{
+  FileInfo file_info;
+  if (!os_fileinfo(fname, &file_info)
+      || os_fileinfo_size(&file_info) < TAG_INDEX_MIN_SIZE) {
+    return NULL;
+  }
+  tagindex_T stamp;
+  tag_index_set_stamp(&stamp, &file_info);
+  bool valid;
+  tagindex_T *ti = tag_index_lookup(fname, &stamp, true, &valid);
+  if (valid) {
+    return ti;
+  }
+
+  tag_index_clear(ti);
+  tag_index_set_stamp(ti, &file_info);
+  if (!tag_index_build(ti, fname)) {
+    tag_index_clear(ti);
+    return NULL;
+  }
+  ti->ti_fname = xstrdup(fname);
+  return ti;
+}
+
+/// Return true when the header of tags file "fname" says it is sorted with
+/// "foldcase".  Then a search ignoring case uses a binary search.
+static bool tag_file_foldcase_sorted(const char *fname)
+{
+  FILE *fd = os_fopen(fname, "rb");
+  if (fd == NULL) {
+    return false;
+  }
+  char buf[1024];
+  size_t len = fread(buf, 1, sizeof(buf) - 1, fd);
+  fclose(fd);
+  buf[len] = NUL;
+  // The header lines come first and are sorted, check just these.
+  for (char *p = buf; strncmp(p, "!_TAG_", 6) == 0;) {
+    if (strncmp(p, "!_TAG_FILE_SORTED\t2", 20) == 0) {
+      return true;
+    }
+    p = strchr(p, '\n');
+    if (p == NULL) {
+      break;
+    }
+    p++;
+  }
+  return false;
+}
+
+static void tag_index_worker_thread(void *arg)
+{
+  tagindexworker_T *w = arg;
+  for (int i = w->tw_start; i < w->tw_count; i += w->tw_step) {
+    tagindexjob_T *job = &w->tw_jobs[i];
+    if (w->tw_skip_foldcase && tag_file_foldcase_sorted(job->tj_index.ti_fname)) {
+      continue;
+    }
+    job->tj_ok = tag_index_build(&job->tj_index, job->tj_index.ti_fname);
+  }
+}
+
+/// Before searching with "st" build the missing indexes of the large tags
+/// files in 'tags', each in a separate thread.  Building an index reads the
+/// whole file, doing that for several files at the same time hides most of
+/// the I/O latency.  The search itself still goes through the files one by
+/// one, in the order of 'tags', so the found matches are the same.
+static void tag_index_prepare(findtags_state_T *st)
+{
+  if (st->orgpat->headlen == 0 || p_tl != 0 || !tag_index_pat_ok(st->orgpat)
+      || uv_available_parallelism() < 2) {
+    return;
+  }
+
+  tagindexjob_T jobs[TAG_INDEX_COUNT];
+  int njobs = 0;
+  tagname_T tn;
+  char *fname = xmalloc(MAXPATHL + 1);
+  for (bool first = true; njobs < TAG_INDEX_COUNT && get_tagfname(&tn, first, fname) == OK;
+       first = false) {
+    FileInfo file_info;
+    if (!os_fileinfo(fname, &file_info)
+        || os_fileinfo_size(&file_info) < TAG_INDEX_MIN_SIZE) {
+      continue;
+    }
+    CLEAR_FIELD(jobs[njobs]);
+    tag_index_set_stamp(&jobs[njobs].tj_index, &file_info);
+    bool valid;
+    tag_index_lookup(fname, &jobs[njobs].tj_index, false, &valid);
+    for (int i = 0; i < njobs && !valid; i++) {
+      valid = strcmp(jobs[i].tj_index.ti_fname, fname) == 0;  // listed twice
+    }
+    if (valid) {
+      continue;
+    }
+    jobs[njobs].tj_index.ti_fname = xstrdup(fname);
+    njobs++;
+  }
+  tagname_free(&tn);
+  xfree(fname);
+
+  // With a single file let tag_index_get() build it when it is used.
+  int nthreads = MIN(MIN((int)uv_available_parallelism(), TAG_INDEX_MAX_THREADS), njobs);
+  if (nthreads >= 2) {
+    tagindexworker_T workers[TAG_INDEX_MAX_THREADS];
+    for (int i = 0; i < nthreads; i++) {
+      workers[i] = (tagindexworker_T){
+        .tw_jobs = jobs,
+        .tw_start = i,
+        .tw_step = nthreads,
+        .tw_count = njobs,
+        .tw_skip_foldcase = !st->linear,
+      };
+    }
+    run_in_threads(workers, (size_t)nthreads, sizeof(*workers), tag_index_worker_thread);
+  }
+
+  for (int i = 0; i < njobs; i++) {
+    tagindex_T *job_ti = &jobs[i].tj_index;
+    if (!jobs[i].tj_ok) {
+      tag_index_clear(job_ti);
+      continue;
+    }
+    bool valid;
+    tagindex_T *ti = tag_index_lookup(job_ti->ti_fname, job_ti, true, &valid);
+    tag_index_clear(ti);
+    *ti = *job_ti;
+  }
+}
+
+/// Return true when chunk "chunk" may have a tag name that starts with the
+/// "headlen" ASCII bytes of "head", ignoring case.
+static bool tag_index_may_match(const tagchunk_T *chunk, const char *head, int headlen)
+{
+  if (chunk->first_line < 0) {
+    return false;
+  }
+  if (chunk->any) {
+    return true;
+  }
+  if (headlen == 1) {
+    uint8_t c = (uint8_t)TOLOWER_ASC(head[0]);
+    return chunk->first[c >> 3] & (1 << (c & 7));
+  }
+  unsigned bit = tag_index_pair_bit((uint8_t)head[0], (uint8_t)head[1]);
+  return chunk->pair[bit >> 3] & (1 << (bit & 7));
+}
+
+/// Use the index of the tags file to skip to the next line that may match
+/// in a linear search.
+///
+/// @return  false when no further line can match.
+static bool findtags_index_skip(findtags_state_T *st)
+{
+  tagindex_T *ti = st->tag_index;
+  off_T pos = findtags_ftell(st);
+  if (pos < 0) {
+    st->tag_index = NULL;
+    return true;
+  }
+  size_t c = (size_t)(pos / TAG_INDEX_CHUNK);
+  if (c >= ti->ti_nchunks) {
+    return true;
+  }
+  const tagchunk_T *chunk = &ti->ti_chunks[c];
+  if (chunk->first_line < 0 || tag_index_may_match(chunk, st->orgpat->head, st->orgpat->headlen)) {
+    return true;
+  }
+  for (c++; c < ti->ti_nchunks; c++) {
+    if (tag_index_may_match(&ti->ti_chunks[c], st->orgpat->head, st->orgpat->headlen)) {
+      return findtags_fseek(st, ti->ti_chunks[c].first_line, SEEK_SET) == 0;
+    }
+  }
+  return false;
+}
+
+/// Return true when the start of the tag names matched by "pat" can be
+/// looked up in the index of a tags file.
+static bool tag_index_pat_ok(const pat_T *pat)
+{
+  for (int i = 0; i < MIN(pat->headlen, 2); i++) {
+    if ((uint8_t)pat->head[i] >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Return true when the linear search in "st" can use the index of the tags
+/// file.
+static bool findtags_use_index(findtags_state_T *st)
+{
+  return st->orgpat->headlen != 0 && p_tl == 0 && st->vimconv.vc_type == CONV_NONE
+         && tag_index_pat_ok(st->orgpat);
+}
+
+static PMap(cstr_t) help_tags_files = MAP_INIT;
+
+/// Get help tags file "fname" from memory, reading it when it was not read
+/// before or it changed.  There is a help tags file for every plugin with
+/// documentation, keeping them avoids opening and reading all of them again
+/// for every ":help" and its completion.
+///
+/// @return  NULL for a file large enough to be indexed, see tag_index_get(),
+///          or when the file can't be read.
+static helptagsfile_T *help_tags_file_get(const char *fname)
+{
+  FileInfo file_info;
+  if (!os_fileinfo(fname, &file_info)
+      || os_fileinfo_size(&file_info) >= TAG_INDEX_MIN_SIZE) {
+    return NULL;
+  }
+  const uint64_t size = os_fileinfo_size(&file_info);
+  const int64_t mtime = (int64_t)file_info.stat.st_mtim.tv_sec;
+  const int64_t mtime_ns = (int64_t)file_info.stat.st_mtim.tv_nsec;
+  helptagsfile_T *hf = pmap_get(cstr_t)(&help_tags_files, fname);
+  if (hf != NULL && hf->hf_size == size && hf->hf_mtime == mtime
+      && hf->hf_mtime_ns == mtime_ns) {
+    return hf;
+  }
+
+  // Text mode, like the "fp" used otherwise.
+  FILE *fd = os_fopen(fname, "r");
+  if (fd == NULL) {
+    return NULL;
+  }
+  char *data = xmalloc((size_t)size + 1);
+  size_t len = fread(data, 1, (size_t)size + 1, fd);
+  fclose(fd);
+  if (len > size) {  // file grew after getting its size
+    xfree(data);
+    return NULL;
+  }
+
+  if (hf == NULL) {
+    hf = xcalloc(1, sizeof(helptagsfile_T));
+    pmap_put(cstr_t)(&help_tags_files, xstrdup(fname), hf);
+  }
+  xfree(hf->hf_data);
+  *hf = (helptagsfile_T){
+    .hf_size = size,
+    .hf_mtime = mtime,
+    .hf_mtime_ns = mtime_ns,
+    .hf_data = data,
+    .hf_len = len,
+  };
+  return hf;
+}
+
+/// Like vim_fgets() for the tags file of "st", reading into "st->lbuf".
+static bool findtags_fgets(findtags_state_T *st)
+{
+  if (st->mem == NULL) {
+    return vim_fgets(st->lbuf, st->lbuf_size, st->fp);
+  }
+  const helptagsfile_T *hf = st->mem;
+  st->lbuf[st->lbuf_size - 2] = NUL;
+  if ((uint64_t)st->mem_off >= hf->hf_len) {
+    return true;
+  }
+  const char *p = hf->hf_data + st->mem_off;
+  const size_t avail = hf->hf_len - (size_t)st->mem_off;
+  const char *nl = memchr(p, '\n', avail);
+  const size_t linelen = nl != NULL ? (size_t)(nl - p) + 1 : avail;
+  // A too long line is truncated, skipping the rest.
+  const size_t n = MIN(linelen, (size_t)st->lbuf_size - 1);
+  memcpy(st->lbuf, p, n);
+  st->lbuf[n] = NUL;
+  st->mem_off += (off_T)linelen;
+  return false;
+}
+
+/// Like vim_fseek() for the tags file of "st".
+static int findtags_fseek(findtags_state_T *st, off_T offset, int whence)
+{
+  if (st->mem == NULL) {
+    return vim_fseek(st->fp, offset, whence);
+  }
+  if (whence == SEEK_END) {
+    offset += (off_T)st->mem->hf_len;
+  } else if (whence == SEEK_CUR) {
+    offset += st->mem_off;
+  }
+  if (offset < 0) {
+    return -1;
+  }
+  st->mem_off = offset;
+  return 0;
+}
+
+/// Like vim_ftell() for the tags file of "st".
+static off_T findtags_ftell(findtags_state_T *st)
+{
+  return st->mem == NULL ? vim_ftell(st->fp) : st->mem_off;
+}
+
 /// Read the next line from a tags file.
 /// Returns TAGS_READ_SUCCESS if a tags line is successfully read and should be
 /// processed.
@@ -1543,7 +2040,7 @@ static tags_read_status_T findtags_get_next_line(findtags_state_T *st, tagsearch
     sinfo_p->curr_offset -= st->lbuf_size * 2;
     if (sinfo_p->curr_offset < 0) {
       sinfo_p->curr_offset = 0;
-      fseek(st->fp, 0, SEEK_SET);
+      vim_ignored = findtags_fseek(st, 0, SEEK_SET);
       st->state = TS_STEP_FORWARD;
     }
   }
@@ -1553,35 +2050,38 @@ static tags_read_status_T findtags_get_next_line(findtags_state_T *st, tagsearch
   if (st->state == TS_BINARY || st->state == TS_SKIP_BACK) {
     // Adjust the search file offset to the correct position
     sinfo_p->curr_offset_used = sinfo_p->curr_offset;
-    vim_ignored = vim_fseek(st->fp, sinfo_p->curr_offset, SEEK_SET);
-    eof = vim_fgets(st->lbuf, st->lbuf_size, st->fp);
+    vim_ignored = findtags_fseek(st, sinfo_p->curr_offset, SEEK_SET);
+    eof = findtags_fgets(st);
     if (!eof && sinfo_p->curr_offset != 0) {
-      sinfo_p->curr_offset = vim_ftell(st->fp);
+      sinfo_p->curr_offset = findtags_ftell(st);
       if (sinfo_p->curr_offset == sinfo_p->high_offset) {
         // oops, gone a bit too far; try from low offset
-        vim_ignored = vim_fseek(st->fp, sinfo_p->low_offset, SEEK_SET);
+        vim_ignored = findtags_fseek(st, sinfo_p->low_offset, SEEK_SET);
         sinfo_p->curr_offset = sinfo_p->low_offset;
       }
-      eof = vim_fgets(st->lbuf, st->lbuf_size, st->fp);
+      eof = findtags_fgets(st);
     }
     // skip empty and blank lines
     while (!eof && vim_isblankline(st->lbuf)) {
-      sinfo_p->curr_offset = vim_ftell(st->fp);
-      eof = vim_fgets(st->lbuf, st->lbuf_size, st->fp);
+      sinfo_p->curr_offset = findtags_ftell(st);
+      eof = findtags_fgets(st);
     }
     if (eof) {
       // Hit end of file.  Skip backwards.
       st->state = TS_SKIP_BACK;
-      sinfo_p->match_offset = vim_ftell(st->fp);
+      sinfo_p->match_offset = findtags_ftell(st);
       sinfo_p->curr_offset = sinfo_p->curr_offset_used;
       return TAGS_READ_IGNORE;
     }
   } else {
     // Not jumping around in the file: Read the next line.
+    if (st->state == TS_LINEAR && st->tag_index != NULL && !findtags_index_skip(st)) {
+      return TAGS_READ_EOF;
+    }
 
     // skip empty and blank lines
     do {
-      eof = vim_fgets(st->lbuf, st->lbuf_size, st->fp);
+      eof = findtags_fgets(st);
     } while (!eof && vim_isblankline(st->lbuf));
 
     if (eof) {
@@ -1666,18 +2166,22 @@ static bool findtags_start_state_handler(findtags_state_T *st, bool *sortic,
     st->state = TS_LINEAR;
   }
 
+  if (st->state == TS_LINEAR && st->mem == NULL && findtags_use_index(st)) {
+    st->tag_index = tag_index_get(st->tag_fname);
+  }
+
   // When starting a binary search, get the size of the file and
   // compute the first offset.
   if (st->state == TS_BINARY) {
-    if (vim_fseek(st->fp, 0, SEEK_END) != 0) {
+    if (findtags_fseek(st, 0, SEEK_END) != 0) {
       // can't seek, don't use binary search
       st->state = TS_LINEAR;
     } else {
       // Get the tag file size.
       // Don't use lseek(), it doesn't work
       // properly on MacOS Catalina.
-      const off_T filesize = vim_ftell(st->fp);
-      vim_ignored = vim_fseek(st->fp, 0, SEEK_SET);
+      const off_T filesize = findtags_ftell(st);
+      vim_ignored = findtags_fseek(st, 0, SEEK_SET);
 
       // Calculate the first read offset in the file.  Start
       // the search in the middle of the file.
@@ -1769,7 +2273,7 @@ static tagmatch_status_T findtags_parse_line(findtags_state_T *st, tagptrs_T *ta
         return TAG_MATCH_NEXT;
       }
       if (tagcmp < 0) {
-        sinfo_p->curr_offset = vim_ftell(st->fp);
+        sinfo_p->curr_offset = findtags_ftell(st);
         if (sinfo_p->curr_offset < sinfo_p->high_offset) {
           sinfo_p->low_offset = sinfo_p->curr_offset;
           if (margs->sortic) {
@@ -1805,7 +2309,7 @@ static tagmatch_status_T findtags_parse_line(findtags_state_T *st, tagptrs_T *ta
     } else if (st->state == TS_STEP_FORWARD) {
       assert(cmplen >= 0);
       if (mb_strnicmp(tagpp->tagname, st->orgpat->head, (size_t)cmplen) != 0) {
-        return ((off_T)vim_ftell(st->fp) > sinfo_p->match_offset)
+        return ((off_T)findtags_ftell(st) > sinfo_p->match_offset)
                ? TAG_MATCH_STOP   // past last match
                : TAG_MATCH_NEXT;  // before first match
       }
@@ -2081,6 +2585,12 @@ static void findtags_get_all_tags(findtags_state_T *st, findtags_match_args_T *m
       st->stop_searching = true;
       break;
     }
+    // Also stop when matches were found but searching takes long, so that
+    // completion does not block typing on huge tags files.
+    if (st->match_count > 0 && profile_passed_limit(st->time_limit)) {
+      st->stop_searching = true;
+      break;
+    }
     if (st->get_searchpat) {
       goto line_read_in;
     }
@@ -2118,7 +2628,7 @@ line_read_in:
 
       if (st->state == TS_STEP_FORWARD || st->state == TS_LINEAR) {
         // Seek to the same position to read the same line again
-        vim_ignored = vim_fseek(st->fp, search_info.curr_offset, SEEK_SET);
+        vim_ignored = findtags_fseek(st, search_info.curr_offset, SEEK_SET);
       }
       // this will try the same thing again, make sure the offset is
       // different
@@ -2135,7 +2645,7 @@ line_read_in:
     }
     if (retval == TAG_MATCH_FAIL) {
       semsg(_("E431: Format error in tags file \"%s\""), st->tag_fname);
-      semsg(_("Before byte %" PRId64), (int64_t)vim_ftell(st->fp));
+      semsg(_("Before byte %" PRId64), (int64_t)findtags_ftell(st));
       st->stop_searching = true;
       return;
     }
@@ -2158,6 +2668,8 @@ static void findtags_in_file(findtags_state_T *st, int flags, char *buf_ffname)
   st->vimconv.vc_type = CONV_NONE;
   st->tag_file_sorted = NUL;
   st->fp = NULL;
+  st->mem = NULL;
+  st->tag_index = NULL;
   findtags_matchargs_init(&margs, st->flags);
 
   // A file that doesn't exist is silently ignored.  Only when not a
@@ -2168,9 +2680,15 @@ static void findtags_in_file(findtags_state_T *st, int flags, char *buf_ffname)
     }
   }
 
-  st->fp = os_fopen(st->tag_fname, "r");
-  if (st->fp == NULL) {
-    return;
+  if (curbuf->b_help) {
+    st->mem = help_tags_file_get(st->tag_fname);
+    st->mem_off = 0;
+  }
+  if (st->mem == NULL) {
+    st->fp = os_fopen(st->tag_fname, "r");
+    if (st->fp == NULL) {
+      return;
+    }
   }
 
   if (p_verbose >= 5) {
@@ -2189,6 +2707,7 @@ static void findtags_in_file(findtags_state_T *st, int flags, char *buf_ffname)
     fclose(st->fp);
     st->fp = NULL;
   }
+  st->mem = NULL;
   if (st->vimconv.vc_type != CONV_NONE) {
     convert_setup(&st->vimconv, NULL, NULL);
   }
@@ -2377,6 +2896,9 @@ int find_tags(char *pat, int *num_matches, char ***matchesp, int flags, int minc
                                && (findall || st.orgpat->headlen == 0 || !p_tbs));
   for (int round = 1; round <= 2; round++) {
     st.linear = (st.orgpat->headlen == 0 || !p_tbs || round == 2);
+    if (st.linear || st.orgpat->regmatch.rm_ic) {
+      tag_index_prepare(&st);
+    }
 
     // Try tag file names from tags option one by one.
     for (first_file = true;
@@ -2459,6 +2981,19 @@ void free_tag_stuff(void)
   tag_freematch();
 
   tagstack_clear_entry(&ptag_entry);
+
+  for (int i = 0; i < TAG_INDEX_COUNT; i++) {
+    tag_index_clear(&tag_indexes[i]);
+  }
+
+  const char *fname;
+  helptagsfile_T *hf;
+  map_foreach(&help_tags_files, fname, hf, {
+    xfree((char *)fname);
+    xfree(hf->hf_data);
+    xfree(hf);
+  });
+  map_destroy(cstr_t, &help_tags_files);
 }
 
 #endif
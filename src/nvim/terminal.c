@@ -141,7 +141,8 @@ struct terminal {
   //  - receive data from libvterm as a result of key presses.
   char textbuf[TEXTBUF_SIZE];
 
-  ScrollbackLine **sb_buffer;       // Scrollback storage.
+  ScrollbackLine **sb_buffer;       // Scrollback storage, a ring buffer (see sb_row()).
+  size_t sb_start;                  // Index of the newest row in sb_buffer.
   size_t sb_current;                // Lines stored in sb_buffer.
   size_t sb_size;                   // Capacity of sb_buffer.
   // "virtual index" that points to the first sb_buffer row that we need to
@@ -717,7 +718,7 @@ bool terminal_enter(void)
   s->term->pending.cursor = true;  // Update the cursor shape table
   adjust_topline(s->term, buf, 0);  // scroll to end
   showmode();
-  curwin->w_redr_status = true;  // For mode() in statusline. #8323
+  status_redraw_win(curwin);  // For mode() in statusline. #8323
   redraw_custom_title_later();
   ui_cursor_shape();
   apply_autocmds(EVENT_TERMENTER, NULL, NULL, false, curbuf);
@@ -811,7 +812,7 @@ static int terminal_check(VimState *state)
   terminal_check_cursor();
   validate_cursor(curwin);
 
-  if (must_redraw) {
+  if (must_redraw && !state_redraw_postponed()) {
     update_screen();
 
     // Make sure an invoked autocmd doesn't delete the buffer (and the
@@ -965,7 +966,7 @@ void terminal_destroy(Terminal **termpp)
       set_del(ptr_t, &invalidated_terminals, term);
     }
     for (size_t i = 0; i < term->sb_current; i++) {
-      xfree(term->sb_buffer[i]);
+      xfree(*sb_row(term, i));
     }
     xfree(term->sb_buffer);
     xfree(term->title);
@@ -1368,21 +1369,18 @@ static int term_sb_push(int cols, const VTermScreenCell *cells, void *data)
   // copy vterm cells into sb_buffer
   size_t c = (size_t)cols;
   ScrollbackLine *sbrow = NULL;
+  // The new row goes just before the newest one. When the storage is full this
+  // is the slot of the oldest row, which is dropped.
+  term->sb_start = (term->sb_start + term->sb_size - 1) % term->sb_size;
   if (term->sb_current == term->sb_size) {
-    if (term->sb_buffer[term->sb_current - 1]->cols == c) {
+    if (term->sb_buffer[term->sb_start]->cols == c) {
       // Recycle old row if it's the right size
-      sbrow = term->sb_buffer[term->sb_current - 1];
+      sbrow = term->sb_buffer[term->sb_start];
     } else {
-      xfree(term->sb_buffer[term->sb_current - 1]);
+      xfree(term->sb_buffer[term->sb_start]);
     }
-
-    // Make room at the start by shifting to the right.
-    memmove(term->sb_buffer + 1, term->sb_buffer,
-            sizeof(term->sb_buffer[0]) * (term->sb_current - 1));
-  } else if (term->sb_current > 0) {
-    // Make room at the start by shifting to the right.
-    memmove(term->sb_buffer + 1, term->sb_buffer,
-            sizeof(term->sb_buffer[0]) * term->sb_current);
+  } else {
+    term->sb_current++;
   }
 
   if (!sbrow) {
@@ -1390,11 +1388,7 @@ static int term_sb_push(int cols, const VTermScreenCell *cells, void *data)
     sbrow->cols = c;
   }
 
-  // New row is added at the start of the storage buffer.
-  term->sb_buffer[0] = sbrow;
-  if (term->sb_current < term->sb_size) {
-    term->sb_current++;
-  }
+  term->sb_buffer[term->sb_start] = sbrow;
 
   if (term->sb_pending < (int)term->sb_size) {
     term->sb_pending++;
@@ -1423,11 +1417,10 @@ static int term_sb_pop(int cols, VTermScreenCell *cells, void *data)
     term->sb_pending--;
   }
 
-  ScrollbackLine *sbrow = term->sb_buffer[0];
+  ScrollbackLine *sbrow = term->sb_buffer[term->sb_start];
   term->sb_current--;
-  // Forget the "popped" row by shifting the rest onto it.
-  memmove(term->sb_buffer, term->sb_buffer + 1,
-          sizeof(term->sb_buffer[0]) * (term->sb_current));
+  // Forget the "popped" row, the next one becomes the newest.
+  term->sb_start = (term->sb_start + 1) % term->sb_size;
 
   size_t cols_to_copy = MIN((size_t)cols, sbrow->cols);
 
@@ -1922,7 +1915,7 @@ static bool send_mouse_event(Terminal *term, int c)
     // Call the common mouse scroll function shared with other modes.
     do_mousescroll(&cap);
 
-    curwin->w_redr_status = true;
+    status_redraw_win(curwin);
     curwin = save_curwin;
     curbuf = curwin->w_buffer;
     redraw_later(mouse_win, UPD_NOT_VALID);
@@ -1974,7 +1967,7 @@ static void fetch_row(Terminal *term, int row, int end_col)
 static bool fetch_cell(Terminal *term, int row, int col, VTermScreenCell *cell)
 {
   if (row < 0) {
-    ScrollbackLine *sbrow = term->sb_buffer[-row - 1];
+    ScrollbackLine *sbrow = *sb_row(term, (size_t)(-row - 1));
     if ((size_t)col < sbrow->cols) {
       *cell = sbrow->cells[col];
     } else {
@@ -2137,15 +2130,20 @@ static void adjust_scrollback(Terminal *term, buf_T *buf)
     for (size_t i = 0; i < diff; i++) {
       ml_delete(1, false);
       term->sb_current--;
-      xfree(term->sb_buffer[term->sb_current]);
+      xfree(*sb_row(term, term->sb_current));
     }
     deleted_lines(1, (linenr_T)diff);
   }
 
-  // Resize the scrollback storage.
-  size_t sb_region = sizeof(ScrollbackLine *) * scbk;
+  // Resize the scrollback storage, moving the newest row to the start.
   if (scbk != term->sb_size) {
-    term->sb_buffer = xrealloc(term->sb_buffer, sb_region);
+    ScrollbackLine **sb_buffer = xmalloc(sizeof(ScrollbackLine *) * scbk);
+    for (size_t i = 0; i < term->sb_current; i++) {
+      sb_buffer[i] = *sb_row(term, i);
+    }
+    xfree(term->sb_buffer);
+    term->sb_buffer = sb_buffer;
+    term->sb_start = 0;
   }
 
   term->sb_size = scbk;
@@ -2159,37 +2157,57 @@ static void refresh_scrollback(Terminal *term, buf_T *buf)
 
   // May still have pending scrollback after increase in terminal height if the
   // scrollback wasn't refreshed in time; append these to the top of the buffer.
+  // The buffer is updated in bulk and changes are reported once per block of
+  // lines, so that a burst of output costs one redraw and one round of
+  // buffer-update callbacks instead of one for every line.
   int row_offset = term->sb_pending;
+  int added = 0;
   while (term->sb_pending > 0 && buf->b_ml.ml_line_count < height) {
     fetch_row(term, term->sb_pending - row_offset - 1, width);
     ml_append_buf(buf, 0, term->textbuf, 0, false);
-    appended_lines_buf(buf, 0, 1);
+    added++;
     term->sb_pending--;
   }
+  if (added > 0) {
+    appended_lines_buf(buf, 0, added);
+  }
 
   row_offset -= term->sb_pending;
-  while (term->sb_pending > 0) {
+  if (term->sb_pending > 0) {
     // This means that either the window height has decreased or the screen
-    // became full and libvterm had to push all rows up. Convert the first
-    // pending scrollback row into a string and append it just above the visible
-    // section of the buffer
-    if (((int)buf->b_ml.ml_line_count - height) >= (int)term->sb_size) {
-      // scrollback full, delete lines at the top
+    // became full and libvterm had to push all rows up. Convert the pending
+    // scrollback rows into strings and append them just above the visible
+    // section of the buffer, after deleting as many lines at the top as needed
+    // to stay within the scrollback limit.
+    int sb_lines = (int)buf->b_ml.ml_line_count - height;
+    int to_delete = MIN(term->sb_pending,
+                        MAX(0, sb_lines + term->sb_pending - (int)term->sb_size));
+    for (int i = 0; i < to_delete; i++) {
       ml_delete_buf(buf, 1, false);
-      deleted_lines_buf(buf, 1, 1);
     }
-    fetch_row(term, -term->sb_pending - row_offset, width);
+    if (to_delete > 0) {
+      deleted_lines_buf(buf, 1, to_delete);
+    }
+
     int buf_index = (int)buf->b_ml.ml_line_count - height;
-    ml_append_buf(buf, buf_index, term->textbuf, 0, false);
-    appended_lines_buf(buf, buf_index, 1);
-    term->sb_pending--;
+    added = 0;
+    while (term->sb_pending > 0) {
+      fetch_row(term, -term->sb_pending - row_offset, width);
+      ml_append_buf(buf, buf_index + added, term->textbuf, 0, false);
+      added++;
+      term->sb_pending--;
+    }
+    appended_lines_buf(buf, buf_index, added);
   }
 
   // Remove extra lines at the bottom
   int max_line_count = (int)term->sb_current + height;
-  while (buf->b_ml.ml_line_count > max_line_count) {
+  int extra = (int)buf->b_ml.ml_line_count - max_line_count;
+  for (int i = 0; i < extra; i++) {
     ml_delete_buf(buf, buf->b_ml.ml_line_count, false);
-    deleted_lines_buf(buf, buf->b_ml.ml_line_count, 1);
+  }
+  if (extra > 0) {
+    deleted_lines_buf(buf, max_line_count + 1, extra);
   }
 
   adjust_scrollback(term, buf);
@@ -2254,6 +2272,13 @@ static void adjust_topline(Terminal *term, buf_T *buf, int added)
   }
 }
 
+/// Gets the slot of scrollback row "i", where 0 is the newest row.
+static inline ScrollbackLine **sb_row(Terminal *term, size_t i)
+{
+  size_t idx = term->sb_start + i;
+  return &term->sb_buffer[idx < term->sb_size ? idx : idx - term->sb_size];
+}
+
 static int row_to_linenr(Terminal *term, int row)
 {
   return row != INT_MAX ? row + (int)term->sb_current + 1 : INT_MAX;
@@ -4,7 +4,9 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/change.h"
 #include "nvim/charset.h"
@@ -14,6 +16,7 @@
 #include "nvim/eval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/ex_cmds_defs.h"
+#include "nvim/extmark.h"
 #include "nvim/getchar.h"
 #include "nvim/globals.h"
 #include "nvim/indent.h"
@@ -96,6 +99,13 @@ void internal_format(int textwidth, int second_indent, int flags, bool format_on
     }
   }
 
+  // A long plain line is split in one pass, the loop below then only checks
+  // the last part.
+  if (format_only && c == NUL && (flags & INSCHAR_FORMAT) && !(flags & INSCHAR_COM_LIST)
+      && second_indent < 0 && can_format_long_line(textwidth, flags)) {
+    haveto_redraw = format_long_line(textwidth);
+  }
+
   // Repeat breaking lines, until the current line is not too long.
   while (!got_int) {
     int startcol;                       // Cursor column at entry
@@ -458,6 +468,133 @@ void internal_format(int textwidth, int second_indent, int flags, bool format_on
   }
 }
 
+/// @return  true when the cursor line can be split by format_long_line(): it
+///          is much longer than "textwidth", has only printable ASCII
+///          characters, no indent and no comment leader, and no option
+///          changes where internal_format() would break it.
+static bool can_format_long_line(int textwidth, int flags)
+{
+  if ((State & VREPLACE_FLAG) || old_indent != 0
+      || curbuf->b_p_cin || *curbuf->b_p_inde != NUL || curbuf->b_p_si || curbuf->b_p_lisp
+      || curwin->w_p_bri || *get_showbreak_value(curwin) != NUL
+      || buf_meta_total(curbuf, kMTMetaInline) > 0
+      || has_format_option(FO_MBYTE_BREAK) || has_format_option(FO_ONE_LETTER)
+      || has_format_option(FO_PERIOD_ABBR) || has_format_option(FO_WHITE_PAR)
+      || has_format_option(FO_Q_NUMBER)) {
+    return false;
+  }
+
+  char *line = get_cursor_line_ptr();
+  colnr_T len = get_cursor_line_len();
+  if (len <= textwidth * 3 || ascii_iswhite(line[0]) || ascii_iswhite(gchar_cursor())) {
+    return false;
+  }
+  if ((flags & INSCHAR_DO_COM) && get_leader_len(line, NULL, false, true) > 0) {
+    return false;
+  }
+  for (colnr_T i = 0; i < len; i++) {
+    if ((uint8_t)line[i] < ' ' || (uint8_t)line[i] > '~') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Split the cursor line where repeated calls of open_line() in
+/// internal_format() would, but find all the break positions in one pass and
+/// copy each part of the line once.  Breaking a line of N bytes in M parts
+/// one by one costs O(N * M).  Leaves the cursor on the last part.
+///
+/// @return  true when the line was split.
+static bool format_long_line(int textwidth)
+{
+  linenr_T lnum = curwin->w_cursor.lnum;
+  colnr_T cursor_col = curwin->w_cursor.col;
+  char *line = get_cursor_line_ptr();
+  // Start and end of the blanks at each break, as pairs.
+  kvec_t(colnr_T) breaks = KV_INITIAL_VALUE;
+
+  // For each part find the last blanks that start at or before "textwidth",
+  // or else the first blanks after it, like internal_format() does.
+  colnr_T start = 0;
+  while (cursor_col - start >= textwidth) {
+    colnr_T wantcol = start + textwidth;
+    colnr_T foundcol = 0;
+    colnr_T nextcol = 0;
+    for (colnr_T col = start + 1; col < cursor_col; col++) {
+      if (line[col] != ' ') {
+        continue;
+      }
+      colnr_T end = col;
+      while (line[end] == ' ') {
+        end++;
+      }
+      if (col <= wantcol || foundcol == 0) {
+        foundcol = col;
+        nextcol = end;
+      }
+      if (col > wantcol) {
+        break;
+      }
+      col = end;
+    }
+    if (foundcol == 0) {
+      break;
+    }
+    kv_push(breaks, foundcol);
+    kv_push(breaks, nextcol);
+    start = nextcol;
+  }
+
+  size_t nbreaks = kv_size(breaks) / 2;
+  if (nbreaks == 0) {
+    kv_destroy(breaks);
+    return false;
+  }
+
+  undisplay_dollar();
+  u_clearline(curbuf);
+  curbuf_splice_pending++;
+
+  // Terminate each part in a copy of the line, then store the parts.
+  char *text = xstrnsave(line, (size_t)get_cursor_line_len());
+  for (size_t i = 0; i < nbreaks; i++) {
+    text[kv_A(breaks, 2 * i)] = NUL;
+  }
+  ml_replace(lnum, text, true);
+  for (size_t i = 0; i < nbreaks; i++) {
+    ml_append(lnum + (linenr_T)i, text + kv_A(breaks, 2 * i + 1), 0, false);
+  }
+  xfree(text);
+
+  mark_adjust(lnum + 1, (linenr_T)MAXLNUM, (linenr_T)nbreaks, 0, kExtmarkNOOP);
+
+  // Move extmarks and marks one part at a time, as open_line() does.
+  start = 0;
+  for (size_t i = 0; i < nbreaks; i++) {
+    colnr_T col = kv_A(breaks, 2 * i) - start;
+    colnr_T next = kv_A(breaks, 2 * i + 1) - start;
+    extmark_splice(curbuf, (int)(lnum + (linenr_T)i) - 1, col,
+                   0, next - col, next - col, 1, 0, 1, kExtmarkUndo);
+    mark_col_adjust(lnum + (linenr_T)i, next, 1, -next, 0);
+    start += next;
+  }
+  curbuf_splice_pending--;
+
+  changed_lines(curbuf, lnum, kv_A(breaks, 0), lnum + 1, (linenr_T)nbreaks, true);
+
+  curwin->w_cursor.lnum = lnum + (linenr_T)nbreaks;
+  curwin->w_cursor.col = cursor_col - start;
+  kv_destroy(breaks);
+
+  set_can_cindent(true);
+  did_ai = false;
+  did_si = false;
+  can_si = false;
+  can_si_back = false;
+  return true;
+}
+
 /// Blank lines, and lines containing only the comment leader, are left
 /// untouched by the formatting.  The function returns true in this
 /// case.  It also returns true when a line starts with the end of a comment
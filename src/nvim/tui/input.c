@@ -191,20 +191,26 @@ static void tinput_done_event(void **argv)
   os_exit(1);
 }
 
+/// Send a chunk of a bracketed paste to Nvim server.
+static void tinput_paste(TermInput *input, String data)
+{
+  MAXSIZE_TEMP_ARRAY(args, 3);
+  ADD_C(args, STRING_OBJ(data));  // 'data'
+  ADD_C(args, BOOLEAN_OBJ(true));  // 'crlf'
+  ADD_C(args, INTEGER_OBJ(input->paste));  // 'phase'
+  rpc_send_event(ui_client_channel_id, "nvim_paste", args);
+  if (input->paste == 1) {
+    // Paste phase: "continue"
+    input->paste = 2;
+  }
+}
+
 /// Send all pending input in key buffer to Nvim server.
 static void tinput_flush(TermInput *input)
 {
   String keys = { .data = input->key_buffer, .size = input->key_buffer_len };
   if (input->paste) {  // produce exactly one paste event
-    MAXSIZE_TEMP_ARRAY(args, 3);
-    ADD_C(args, STRING_OBJ(keys));  // 'data'
-    ADD_C(args, BOOLEAN_OBJ(true));  // 'crlf'
-    ADD_C(args, INTEGER_OBJ(input->paste));  // 'phase'
-    rpc_send_event(ui_client_channel_id, "nvim_paste", args);
-    if (input->paste == 1) {
-      // Paste phase: "continue"
-      input->paste = 2;
-    }
+    tinput_paste(input, keys);
   } else {  // enqueue input
     if (input->key_buffer_len > 0) {
       MAXSIZE_TEMP_ARRAY(args, 1);
@@ -796,17 +802,20 @@ static size_t handle_raw_buffer(TermInput *input, bool force, const char *data,
     // be the first thing encountered on the next iteration. The `handle_*`
     // calls (above) depend on this.
     //
-    size_t count = 0;
-    for (size_t i = 0; i < size; i++) {
-      count = i + 1;
-      if (ptr[i] == '\x1b' && count > 1) {
-        count--;
-        break;
-      }
-    }
+    const char *esc = size > 1 ? memchr(ptr + 1, '\x1b', size - 1) : NULL;
+    size_t count = esc ? (size_t)(esc - ptr) : size;
     // Push bytes directly (paste).
     if (input->paste) {
-      tinput_enqueue(input, ptr, count);
+      if (count >= KEY_BUFFER_SIZE / 2) {
+        // Send a large chunk as one paste event, without copying it to the
+        // key buffer (which would split it into many small events).
+        if (input->key_buffer_len > 0) {
+          tinput_flush(input);
+        }
+        tinput_paste(input, (String){ .data = (char *)ptr, .size = count });
+      } else {
+        tinput_enqueue(input, ptr, count);
+      }
       ptr += count;
       size -= count;
       continue;
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -75,6 +76,14 @@ typedef struct {
   int top, bot, left, right;
 } Rect;
 
+/// How the cursor is moved along a row or column, see cursor_goto().
+typedef enum {
+  kMoveNone,   ///< already there
+  kMoveOne,    ///< repeat the capability for moving one cell
+  kMoveParm,   ///< the capability for moving some cells
+  kMovePrint,  ///< print the cells in between again
+} CursorMove;
+
 struct TUIData {
   Loop *loop;
   unibi_var_t params[9];
@@ -100,6 +109,7 @@ struct TUIData {
   bool can_set_lr_margin;  // smglr
   bool can_scroll;
   bool can_erase_chars;
+  bool can_repeat_char;
   bool immediate_wrap_after_last_column;
   bool bce;
   bool mouse_enabled;
@@ -147,6 +157,9 @@ struct TUIData {
   bool rgb;
   int url;  ///< Index of URL currently being printed, if any
   StringBuilder urlbuf;  ///< Re-usable buffer for writing OSC 8 control sequences
+  StringBuilder pending;  ///< Flushed output the TTY did not accept yet
+  bool flush_deferred;    ///< tui_flush() was skipped because of "pending"
+  uv_timer_t write_timer;  ///< Retries writing "pending"
 };
 
 static int got_winch = 0;
@@ -169,6 +182,7 @@ void tui_start(TUIData **tui_p, int *width, int *height, char **term, bool *rgb)
 
   kv_init(tui->invalid_regions);
   kv_init(tui->urlbuf);
+  kv_init(tui->pending);
   signal_watcher_init(tui->loop, &tui->winch_handle, tui);
   signal_watcher_start(&tui->winch_handle, sigwinch_cb, SIGWINCH);
 
@@ -184,6 +198,9 @@ void tui_start(TUIData **tui_p, int *width, int *height, char **term, bool *rgb)
   tui->startup_delay_timer.data = tui;
   uv_timer_start(&tui->startup_delay_timer, after_startup_cb, 100, 0);
 
+  uv_timer_init(&tui->loop->uv, &tui->write_timer);
+  tui->write_timer.data = tui;
+
   *tui_p = tui;
   loop_poll_events(&main_loop, 1);
   *width = tui->width;
@@ -444,6 +461,7 @@ static void terminfo_start(TUIData *tui)
     && !!unibi_get_str(tui->ut, unibi_insert_line)
     && !!unibi_get_str(tui->ut, unibi_parm_insert_line);
   tui->can_erase_chars = !!unibi_get_str(tui->ut, unibi_erase_chars);
+  tui->can_repeat_char = !!unibi_get_str(tui->ut, unibi_repeat_char);
   tui->immediate_wrap_after_last_column =
     terminfo_is_term_family(term, "conemu")
     || terminfo_is_term_family(term, "cygwin")
@@ -564,6 +582,10 @@ static void terminfo_disable(TUIData *tui)
 
   // Immediately flush the buffer and wait for the DA1 response.
   flush_buf(tui);
+
+  // Nothing is drawn until the terminal is started again.
+  tui->flush_deferred = false;
+  uv_timer_stop(&tui->write_timer);
 }
 
 /// Disable the alternate screen and prepare for the TUI to close.
@@ -639,6 +661,7 @@ void tui_stop(TUIData *tui)
   signal_watcher_stop(&tui->winch_handle);
   signal_watcher_close(&tui->winch_handle, NULL);
   uv_close((uv_handle_t *)&tui->startup_delay_timer, NULL);
+  uv_close((uv_handle_t *)&tui->write_timer, NULL);
 }
 
 /// Callback function called when the response to the Device Attributes (DA1)
@@ -680,6 +703,7 @@ void tui_free_all_mem(TUIData *tui)
 
   kv_destroy(tui->attrs);
   kv_destroy(tui->urlbuf);
+  kv_destroy(tui->pending);
   xfree(tui->space_buf);
   xfree(tui->term);
   xfree(tui);
@@ -731,10 +755,15 @@ static void update_attrs(TUIData *tui, int attr_id)
     tui->print_attr_id = attr_id;
     return;
   }
+  int prev_attr_id = tui->print_attr_id;
   tui->print_attr_id = attr_id;
   HlAttrs attrs = kv_A(tui->attrs, (size_t)attr_id);
   int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
 
+  if (prev_attr_id >= 0 && update_colors(tui, kv_A(tui->attrs, (size_t)prev_attr_id), attrs)) {
+    return;
+  }
+
   bool bold = attr & HL_BOLD;
   bool italic = attr & HL_ITALIC;
   bool reverse = attr & HL_INVERSE;
@@ -833,41 +862,13 @@ static void update_attrs(TUIData *tui, int attr_id)
     }
   }
 
-  int fg, bg;
-  if (tui->rgb && !(attr & HL_FG_INDEXED)) {
-    fg = ((attrs.rgb_fg_color != -1)
-          ? attrs.rgb_fg_color : tui->clear_attrs.rgb_fg_color);
-    if (fg != -1) {
-      UNIBI_SET_NUM_VAR(tui->params[0], (fg >> 16) & 0xff);  // red
-      UNIBI_SET_NUM_VAR(tui->params[1], (fg >> 8) & 0xff);   // green
-      UNIBI_SET_NUM_VAR(tui->params[2], fg & 0xff);          // blue
-      unibi_out_ext(tui, tui->unibi_ext.set_rgb_foreground);
-    }
-  } else {
-    fg = (attrs.cterm_fg_color
-          ? attrs.cterm_fg_color - 1 : (tui->clear_attrs.cterm_fg_color - 1));
-    if (fg != -1) {
-      UNIBI_SET_NUM_VAR(tui->params[0], fg);
-      unibi_out(tui, unibi_set_a_foreground);
-    }
+  int fg = attr_fg(tui, attrs);
+  if (fg != -1) {
+    out_fg(tui, attrs, fg);
   }
-
-  if (tui->rgb && !(attr & HL_BG_INDEXED)) {
-    bg = ((attrs.rgb_bg_color != -1)
-          ? attrs.rgb_bg_color : tui->clear_attrs.rgb_bg_color);
-    if (bg != -1) {
-      UNIBI_SET_NUM_VAR(tui->params[0], (bg >> 16) & 0xff);  // red
-      UNIBI_SET_NUM_VAR(tui->params[1], (bg >> 8) & 0xff);   // green
-      UNIBI_SET_NUM_VAR(tui->params[2], bg & 0xff);          // blue
-      unibi_out_ext(tui, tui->unibi_ext.set_rgb_background);
-    }
-  } else {
-    bg = (attrs.cterm_bg_color
-          ? attrs.cterm_bg_color - 1 : (tui->clear_attrs.cterm_bg_color - 1));
-    if (bg != -1) {
-      UNIBI_SET_NUM_VAR(tui->params[0], bg);
-      unibi_out(tui, unibi_set_a_background);
-    }
+  int bg = attr_bg(tui, attrs);
+  if (bg != -1) {
+    out_bg(tui, attrs, bg);
   }
 
   if (tui->url != attrs.url) {
@@ -899,6 +900,91 @@ static void update_attrs(TUIData *tui, int attr_id)
                         && !strikethrough && (tui->bce || bg == -1);
 }
 
+/// Gets the foreground color to set for "attrs", -1 for the default color.
+static int attr_fg(TUIData *tui, HlAttrs attrs)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_FG_INDEXED)) {
+    return attrs.rgb_fg_color != -1 ? attrs.rgb_fg_color : tui->clear_attrs.rgb_fg_color;
+  }
+  return attrs.cterm_fg_color ? attrs.cterm_fg_color - 1 : tui->clear_attrs.cterm_fg_color - 1;
+}
+
+/// Gets the background color to set for "attrs", -1 for the default color.
+static int attr_bg(TUIData *tui, HlAttrs attrs)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_BG_INDEXED)) {
+    return attrs.rgb_bg_color != -1 ? attrs.rgb_bg_color : tui->clear_attrs.rgb_bg_color;
+  }
+  return attrs.cterm_bg_color ? attrs.cterm_bg_color - 1 : tui->clear_attrs.cterm_bg_color - 1;
+}
+
+static void out_fg(TUIData *tui, HlAttrs attrs, int fg)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_FG_INDEXED)) {
+    UNIBI_SET_NUM_VAR(tui->params[0], (fg >> 16) & 0xff);  // red
+    UNIBI_SET_NUM_VAR(tui->params[1], (fg >> 8) & 0xff);   // green
+    UNIBI_SET_NUM_VAR(tui->params[2], fg & 0xff);          // blue
+    unibi_out_ext(tui, tui->unibi_ext.set_rgb_foreground);
+  } else {
+    UNIBI_SET_NUM_VAR(tui->params[0], fg);
+    unibi_out(tui, unibi_set_a_foreground);
+  }
+}
+
+static void out_bg(TUIData *tui, HlAttrs attrs, int bg)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_BG_INDEXED)) {
+    UNIBI_SET_NUM_VAR(tui->params[0], (bg >> 16) & 0xff);  // red
+    UNIBI_SET_NUM_VAR(tui->params[1], (bg >> 8) & 0xff);   // green
+    UNIBI_SET_NUM_VAR(tui->params[2], bg & 0xff);          // blue
+    unibi_out_ext(tui, tui->unibi_ext.set_rgb_background);
+  } else {
+    UNIBI_SET_NUM_VAR(tui->params[0], bg);
+    unibi_out(tui, unibi_set_a_background);
+  }
+}
+
+/// When "attrs" only has other colors than "prev", which the terminal is using,
+/// change only the colors instead of resetting all attributes.
+///
+/// @return  false if all attributes need to be set.
+static bool update_colors(TUIData *tui, HlAttrs prev, HlAttrs attrs)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  int prev_attr = tui->rgb ? prev.rgb_ae_attr : prev.cterm_ae_attr;
+  if (attr != prev_attr || attrs.url != prev.url
+      || ((attr & HL_UNDERLINE_MASK) && attrs.rgb_sp_color != prev.rgb_sp_color)) {
+    return false;
+  }
+
+  int fg = attr_fg(tui, attrs);
+  int bg = attr_bg(tui, attrs);
+  int prev_fg = attr_fg(tui, prev);
+  int prev_bg = attr_bg(tui, prev);
+  // Going back to a default color needs a reset.
+  if ((fg == -1 && prev_fg != -1) || (bg == -1 && prev_bg != -1)) {
+    return false;
+  }
+
+  if (fg != prev_fg) {
+    out_fg(tui, attrs, fg);
+  }
+  if (bg != prev_bg) {
+    out_bg(tui, attrs, bg);
+  }
+
+  bool any_attr = attr & (HL_BOLD | HL_ITALIC | HL_UNDERLINE_MASK | HL_INVERSE | HL_STANDOUT
+                          | HL_STRIKETHROUGH);
+  tui->default_attr = fg == -1 && bg == -1 && !any_attr;
+  tui->can_clear_attr = !(attr & (HL_INVERSE | HL_STANDOUT | HL_UNDERLINE_MASK | HL_STRIKETHROUGH))
+                        && (tui->bce || bg == -1);
+  return true;
+}
+
 static void final_column_wrap(TUIData *tui)
 {
   UGrid *grid = &tui->grid;
@@ -929,29 +1015,124 @@ static void print_cell(TUIData *tui, char *buf, sattr_T attr)
   }
 }
 
-static bool cheap_to_print(TUIData *tui, int row, int col, int next)
+/// Whether the "n" cells from "col" can be printed again to move the cursor
+/// over them: they must be ASCII and use the current attributes.
+static bool cheap_to_print(TUIData *tui, int row, int col, int n)
 {
   UGrid *grid = &tui->grid;
+  if (row < 0 || row >= grid->height || col + n > grid->width) {
+    return false;
+  }
   UCell *cell = grid->cells[row] + col;
-  while (next) {
-    next--;
-    if (attrs_differ(tui, cell->attr,
-                     tui->print_attr_id, tui->rgb)) {
-      if (tui->default_attr) {
-        return false;
-      }
-    }
-    if (schar_get_ascii(cell->data) == 0) {
-      return false;  // not ascii
+  for (; n > 0; n--, cell++) {
+    if (attrs_differ(tui, cell->attr, tui->print_attr_id, tui->rgb)
+        || schar_get_ascii(cell->data) == 0) {
+      return false;
     }
-    cell++;
   }
   return true;
 }
 
-/// This optimizes several cases where it is cheaper to do something other
-/// than send a full cursor positioning control sequence.  However, there are
-/// some further optimizations that may seem obvious but that will not work.
+/// Gets the number of bytes unibi_out() writes for "unibi_index" with the
+/// current "tui->params", INT_MAX if the terminal does not have it.
+static int unibi_cost(TUIData *tui, int unibi_index)
+{
+  const char *str = unibi_get_str(tui->ut, (unsigned)unibi_index);
+  if (str == NULL) {
+    return INT_MAX;
+  }
+  char buf[64];
+  unibi_var_t params[9];
+  memcpy(params, tui->params, sizeof(params));
+  return (int)unibi_run(str, params, buf, sizeof(buf));
+}
+
+static int cost_add(int a, int b)
+{
+  return (a == INT_MAX || b == INT_MAX) ? INT_MAX : a + b;
+}
+
+/// Gets the cheapest way to move the cursor "n" cells with "one" or "parm".
+static int cursor_move_cost(TUIData *tui, int n, int one, int parm, CursorMove *move)
+{
+  if (n == 0) {
+    *move = kMoveNone;
+    return 0;
+  }
+  int one_cost = unibi_cost(tui, one);
+  one_cost = one_cost == INT_MAX ? INT_MAX : one_cost * n;
+  UNIBI_SET_NUM_VAR(tui->params[0], n);
+  int parm_cost = unibi_cost(tui, parm);
+  *move = parm_cost < one_cost ? kMoveParm : kMoveOne;
+  return MIN(one_cost, parm_cost);
+}
+
+/// Gets the cheapest way to move the cursor from column "from" to "to" in "row".
+static int cursor_horizontal_cost(TUIData *tui, int row, int from, int to, CursorMove *move)
+{
+  if (to < from) {
+    return cursor_move_cost(tui, from - to, unibi_cursor_left, unibi_parm_left_cursor, move);
+  }
+  int cost = cursor_move_cost(tui, to - from, unibi_cursor_right, unibi_parm_right_cursor, move);
+  if (to - from < cost && cheap_to_print(tui, row, from, to - from)) {
+    *move = kMovePrint;
+    return to - from;
+  }
+  return cost;
+}
+
+static int cursor_vertical_cost(TUIData *tui, int from, int to, CursorMove *move)
+{
+  if (to < from) {
+    return cursor_move_cost(tui, from - to, unibi_cursor_up, unibi_parm_up_cursor, move);
+  }
+  return cursor_move_cost(tui, to - from, unibi_cursor_down, unibi_parm_down_cursor, move);
+}
+
+static void cursor_move_out(TUIData *tui, int n, int one, int parm, CursorMove move)
+{
+  if (move == kMoveParm) {
+    UNIBI_SET_NUM_VAR(tui->params[0], n);
+    unibi_out(tui, parm);
+  } else if (move == kMoveOne) {
+    while (n--) {
+      unibi_out(tui, one);
+    }
+  }
+}
+
+/// Moves the cursor to "row" first and then to "col", as chosen by
+/// cursor_vertical_cost() and cursor_horizontal_cost().
+static void cursor_move_relative(TUIData *tui, int row, int col, CursorMove vmove,
+                                 CursorMove hmove)
+{
+  UGrid *grid = &tui->grid;
+  if (row < grid->row) {
+    cursor_move_out(tui, grid->row - row, unibi_cursor_up, unibi_parm_up_cursor, vmove);
+  } else {
+    cursor_move_out(tui, row - grid->row, unibi_cursor_down, unibi_parm_down_cursor, vmove);
+  }
+  ugrid_goto(grid, row, grid->col);
+
+  if (hmove == kMovePrint) {
+    while (grid->col < col) {
+      char buf[MAX_SCHAR_SIZE];
+      UCell *cell = &grid->cells[row][grid->col];
+      schar_get(buf, cell->data);
+      print_cell(tui, buf, cell->attr);
+    }
+  } else if (col < grid->col) {
+    cursor_move_out(tui, grid->col - col, unibi_cursor_left, unibi_parm_left_cursor, hmove);
+  } else {
+    cursor_move_out(tui, col - grid->col, unibi_cursor_right, unibi_parm_right_cursor, hmove);
+  }
+  ugrid_goto(grid, row, col);
+}
+
+/// Moves the cursor with the fewest bytes: absolute positioning, relative
+/// motion, CR followed by relative motion, or printing the cells in between
+/// again.  However, there are some further optimizations that may seem obvious
+/// but that will not work.
 ///
 /// We cannot use VT (ASCII 0/11) for moving the cursor up, because VT means
 /// move the cursor down on a DEC terminal.  Similarly, on a DEC terminal FF
@@ -972,92 +1153,96 @@ static void cursor_goto(TUIData *tui, int row, int col)
     tui->print_attr_id = -1;
   }
 
+  enum { kGotoAddress, kGotoHome, kGotoRelative, kGotoReturn } how = kGotoAddress;
+  UNIBI_SET_NUM_VAR(tui->params[0], row);
+  UNIBI_SET_NUM_VAR(tui->params[1], col);
+  int best = unibi_cost(tui, unibi_cursor_address);
+
   if (0 == row && 0 == col) {
+    int cost = unibi_cost(tui, unibi_cursor_home);
+    if (cost != INT_MAX && cost <= best) {
+      best = cost;
+      how = kGotoHome;
+    }
+  }
+
+  CursorMove vmove = kMoveNone;
+  CursorMove hmove = kMoveNone;
+  CursorMove cr_hmove = kMoveNone;
+  if (grid->row != -1) {
+    int vcost = cursor_vertical_cost(tui, grid->row, row, &vmove);
+    // Deferred right margin wrap terminals have inconsistent ideas about
+    // where the cursor actually is during a deferred wrap.  Relative
+    // motion calculations have OBOEs that cannot be compensated for,
+    // because two terminals that claim to be the same will implement
+    // different cursor positioning rules.
+    if (tui->immediate_wrap_after_last_column || grid->col < tui->width) {
+      int cost = cost_add(vcost, cursor_horizontal_cost(tui, row, grid->col, col, &hmove));
+      if (cost < best) {
+        best = cost;
+        how = kGotoRelative;
+      }
+    }
+    // Motion to left margin from anywhere else, or CR + printing chars, may be
+    // even less expensive than using BSes or CUB.
+    int cost = cost_add(cost_add(unibi_cost(tui, unibi_carriage_return), vcost),
+                        cursor_horizontal_cost(tui, row, 0, col, &cr_hmove));
+    if (cost < best) {
+      how = kGotoReturn;
+    }
+  }
+
+  switch (how) {
+  case kGotoHome:
     unibi_out(tui, unibi_cursor_home);
     ugrid_goto(grid, row, col);
-    return;
-  }
-  if (grid->row == -1) {
-    goto safe_move;
-  }
-  if (0 == col
-      ? col != grid->col
-      : (row != grid->row
-         ? false
-         : (1 == col
-            ? (2 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-            : (2 == col
-               ? (5 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-               : false)))) {
-    // Motion to left margin from anywhere else, or CR + printing chars is
-    // even less expensive than using BSes or CUB.
+    break;
+  case kGotoRelative:
+    cursor_move_relative(tui, row, col, vmove, hmove);
+    break;
+  case kGotoReturn:
     unibi_out(tui, unibi_carriage_return);
     ugrid_goto(grid, grid->row, 0);
+    cursor_move_relative(tui, row, col, vmove, cr_hmove);
+    break;
+  case kGotoAddress:
+    unibi_goto(tui, row, col);
+    ugrid_goto(grid, row, col);
+    break;
   }
-  if (row == grid->row) {
-    if (col < grid->col
-        // Deferred right margin wrap terminals have inconsistent ideas about
-        // where the cursor actually is during a deferred wrap.  Relative
-        // motion calculations have OBOEs that cannot be compensated for,
-        // because two terminals that claim to be the same will implement
-        // different cursor positioning rules.
-        && (tui->immediate_wrap_after_last_column || grid->col < tui->width)) {
-      int n = grid->col - col;
-      if (n <= 4) {  // This might be just BS, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_left);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_left_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (col > grid->col) {
-      int n = col - grid->col;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_right);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_right_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    }
+}
+
+/// Prints the cell at "col" in "row" and the same cells after it, up to
+/// "endcol", with REP when that is shorter.
+///
+/// @return  the number of cells printed with REP, zero if none.
+static int print_repeated(TUIData *tui, int row, int col, int endcol)
+{
+  UGrid *grid = &tui->grid;
+  UCell *cell = &grid->cells[row][col];
+  int c = schar_get_ascii(cell->data);
+  if (!tui->can_repeat_char || c < ' ' || c == DEL) {
+    return 0;
   }
-  if (col == grid->col) {
-    if (row > grid->row) {
-      int n = row - grid->row;
-      if (n <= 4) {  // This might be just LF, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_down);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_down_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (row < grid->row) {
-      int n = grid->row - row;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_up);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_up_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    }
+  // Stay away from the right margin, see cursor_goto().
+  endcol = MIN(endcol, tui->width - 1);
+  int n = 1;
+  while (col + n < endcol && cell[n].data == cell->data && cell[n].attr == cell->attr) {
+    n++;
+  }
+  UNIBI_SET_NUM_VAR(tui->params[0], c);
+  UNIBI_SET_NUM_VAR(tui->params[1], n);
+  if (n < 2 || unibi_cost(tui, unibi_repeat_char) >= n) {
+    return 0;
   }
 
-safe_move:
-  unibi_goto(tui, row, col);
-  ugrid_goto(grid, row, col);
+  cursor_goto(tui, row, col);
+  update_attrs(tui, cell->attr);
+  UNIBI_SET_NUM_VAR(tui->params[0], c);
+  UNIBI_SET_NUM_VAR(tui->params[1], n);
+  unibi_out(tui, unibi_repeat_char);
+  grid->col += n;
+  return n;
 }
 
 static void print_spaces(TUIData *tui, int width)
@@ -1124,6 +1309,7 @@ static void clear_region(TUIData *tui, int top, int bot, int left, int right, in
     update_attrs(tui, attr_id);
   } else {
     unibi_out(tui, unibi_exit_attribute_mode);
+    tui->print_attr_id = -1;
   }
 
   // Background is set to the default color and the right edge matches the
@@ -1534,6 +1720,25 @@ void tui_flush(TUIData *tui)
     tui_busy_stop(tui);  // avoid hidden cursor
   }
 
+  if (kv_size(tui->pending) > 0) {
+    // The terminal did not keep up with the previous frame: skip this one,
+    // the grid is drawn when it has been written, see write_timer_cb().
+    tui->flush_deferred = true;
+    return;
+  }
+
+  // The server compacts its own glyph cache instead of clearing the screen,
+  // so grid_clear cannot be relied on to empty this one.
+  if (schar_cache_full()) {
+    schar_cache_compact_start();
+    for (int row = 0; row < grid->height; row++) {
+      UGRID_FOREACH_CELL(grid, row, 0, grid->width, {
+        cell->data = schar_cache_remap(cell->data);
+      });
+    }
+    schar_cache_compact_finish();
+  }
+
   while (kv_size(tui->invalid_regions)) {
     Rect r = kv_pop(tui->invalid_regions);
     assert(r.bot <= grid->height && r.right <= grid->width);
@@ -1549,9 +1754,16 @@ void tui_flush(TUIData *tui)
         }
       }
 
+      int next_col = r.left;
       UGRID_FOREACH_CELL(grid, row, r.left, clear_col, {
-        print_cell_at_pos(tui, row, curcol, cell,
-                          curcol < clear_col - 1 && (cell + 1)->data == NUL);
+        if (curcol < next_col) {
+          continue;  // printed with REP
+        }
+        next_col = curcol + print_repeated(tui, row, curcol, clear_col);
+        if (next_col == curcol) {
+          print_cell_at_pos(tui, row, curcol, cell,
+                            curcol < clear_col - 1 && (cell + 1)->data == NUL);
+        }
       });
       if (clear_col < r.right) {
         clear_region(tui, row, row + 1, clear_col, r.right, clear_attr);
@@ -1561,7 +1773,7 @@ void tui_flush(TUIData *tui)
 
   cursor_goto(tui, tui->row, tui->col);
 
-  flush_buf(tui);
+  flush_buf_nowait(tui);
 }
 
 /// Dumps termcap info to the messages area, if 'verbose' >= 3.
@@ -2080,6 +2292,12 @@ static void patch_terminfo_bugs(TUIData *tui, const char *term, const char *colo
     unibi_set_bool(ut, unibi_back_color_erase, false);
   }
 
+  if (xterm && !true_xterm) {
+    // The xterm terminfo entries have REP, but many terminals that claim to
+    // be xterm (including Terminal.app) do not implement it.
+    unibi_set_str(ut, unibi_repeat_char, NULL);
+  }
+
   if (xterm || hterm) {
     // Termit, LXTerminal, GTKTerm2, GNOME Terminal, MATE Terminal, roxterm,
     // and EvilVTE falsely claim to be xterm and do not support important xterm
@@ -2545,22 +2763,27 @@ static size_t flush_buf_end(TUIData *tui, char *buf, size_t len)
 static void flush_buf(TUIData *tui)
 {
   uv_write_t req;
-  uv_buf_t bufs[3];
+  uv_buf_t bufs[4];
   char pre[32];
   char post[32];
 
-  if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)) {
+  if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)
+      && kv_size(tui->pending) == 0) {
     return;
   }
 
-  bufs[0].base = pre;
-  bufs[0].len = UV_BUF_LEN(flush_buf_start(tui, pre, sizeof(pre)));
+  // Output of an earlier frame goes first.
+  bufs[0].base = tui->pending.items;
+  bufs[0].len = UV_BUF_LEN(kv_size(tui->pending));
+
+  bufs[1].base = pre;
+  bufs[1].len = UV_BUF_LEN(flush_buf_start(tui, pre, sizeof(pre)));
 
-  bufs[1].base = tui->buf;
-  bufs[1].len = UV_BUF_LEN(tui->bufpos);
+  bufs[2].base = tui->buf;
+  bufs[2].len = UV_BUF_LEN(tui->bufpos);
 
-  bufs[2].base = post;
-  bufs[2].len = UV_BUF_LEN(flush_buf_end(tui, post, sizeof(post)));
+  bufs[3].base = post;
+  bufs[3].len = UV_BUF_LEN(flush_buf_end(tui, post, sizeof(post)));
 
   if (tui->screenshot) {
     for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
@@ -2574,8 +2797,83 @@ static void flush_buf(TUIData *tui)
     }
     uv_run(&tui->write_loop, UV_RUN_DEFAULT);
   }
+  kv_size(tui->pending) = 0;
+  tui->bufpos = 0;
+  tui->overflow = false;
+}
+
+/// Like flush_buf(), but does not wait for the TTY to accept all of the
+/// output.  What is left is written by write_timer_cb(), and tui_flush() skips
+/// frames until then, so that a slow terminal gets the latest grid state
+/// instead of every intermediate frame.
+static void flush_buf_nowait(TUIData *tui)
+{
+#ifdef MSWIN
+  // uv_try_write() is not reliable for pipes and consoles.
+  bool const nowait = false;
+#else
+  bool const nowait = tui->screenshot == NULL;
+#endif
+  if (!nowait) {
+    flush_buf(tui);
+    return;
+  }
+
+  if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)) {
+    return;
+  }
+
+  char pre[32];
+  char post[32];
+  size_t pre_len = flush_buf_start(tui, pre, sizeof(pre));
+  kv_concat_len(tui->pending, pre, pre_len);
+  kv_concat_len(tui->pending, tui->buf, tui->bufpos);
+  size_t post_len = flush_buf_end(tui, post, sizeof(post));
+  kv_concat_len(tui->pending, post, post_len);
   tui->bufpos = 0;
   tui->overflow = false;
+
+  write_pending(tui);
+  if (kv_size(tui->pending) > 0) {
+    uv_timer_start(&tui->write_timer, write_timer_cb, 1, 1);
+  }
+}
+
+/// Writes as much of the pending output as the TTY accepts without blocking.
+static void write_pending(TUIData *tui)
+{
+  size_t done = 0;
+  while (done < kv_size(tui->pending)) {
+    uv_buf_t buf = uv_buf_init(tui->pending.items + done,
+                               UV_BUF_LEN(kv_size(tui->pending) - done));
+    int ret = uv_try_write((uv_stream_t *)&tui->output_handle, &buf, 1);
+    if (ret == UV_EAGAIN) {
+      break;
+    } else if (ret < 0) {
+      ELOG("uv_try_write failed: %s", uv_strerror(ret));
+      done = kv_size(tui->pending);
+      break;
+    }
+    done += (size_t)ret;
+  }
+  if (done > 0) {
+    memmove(tui->pending.items, tui->pending.items + done, kv_size(tui->pending) - done);
+    kv_size(tui->pending) -= done;
+  }
+}
+
+static void write_timer_cb(uv_timer_t *handle)
+{
+  TUIData *tui = handle->data;
+  write_pending(tui);
+  if (kv_size(tui->pending) > 0) {
+    return;
+  }
+  uv_timer_stop(&tui->write_timer);
+  if (tui->flush_deferred) {
+    tui->flush_deferred = false;
+    tui_flush(tui);
+  }
 }
 
 /// Try to get "kbs" code from stty because "the terminfo kbs entry is extremely
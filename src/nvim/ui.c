@@ -52,8 +52,6 @@ typedef struct {
 # include "ui.c.generated.h"
 #endif
 
-#define MAX_UI_COUNT 16
-
 static RemoteUI *uis[MAX_UI_COUNT];
 static bool ui_ext[kUIExtCount] = { 0 };
 static size_t ui_count = 0;
@@ -108,7 +106,7 @@ static void ui_log(const char *funname)
     bool any_call = false; \
     for (size_t i = 0; i < ui_count; i++) { \
       RemoteUI *ui = uis[i]; \
-      if ((cond)) { \
+      if (!ui->mirror && (cond)) { \
         remote_ui_##funname(__VA_ARGS__); \
         any_call = true; \
       } \
@@ -242,6 +240,9 @@ void ui_refresh(void)
     return;
   }
 
+  // The following redraw brings all UIs to the same state, only now UIs with
+  // the same options can share their events.
+  ui_mirror_update();
   ui_default_colors_set();
 
   int save_p_lz = p_lz;
@@ -255,6 +256,34 @@ void ui_refresh(void)
   pending_has_mouse = -1;
 }
 
+/// Lets UIs with the same options share the encoded events: the first one of
+/// them packs the events, and its buffers are written to the channels of the
+/// others as well.
+static void ui_mirror_update(void)
+{
+  ui_unmirror_all();
+  for (size_t i = 1; i < ui_count; i++) {
+    RemoteUI *ui = uis[i];
+    if (!ui->ui_ext[kUILinegrid]) {
+      continue;
+    }
+    for (size_t j = 0; j < i; j++) {
+      if (!uis[j]->mirror && remote_ui_same_options(uis[j], ui)) {
+        remote_ui_mirror(uis[j], ui);
+        break;
+      }
+    }
+  }
+}
+
+/// Stops sharing events between UIs, before any UI gets events of its own.
+void ui_unmirror_all(void)
+{
+  for (size_t i = 0; i < ui_count; i++) {
+    remote_ui_unmirror(uis[i]);
+  }
+}
+
 int ui_pum_get_height(void)
 {
   int pum_height = 0;
@@ -380,6 +409,7 @@ void ui_attach_impl(RemoteUI *ui, uint64_t chanid)
   if (ui_count == MAX_UI_COUNT) {
     abort();
   }
+  ui_unmirror_all();
   if (!ui->ui_ext[kUIMultigrid] && !ui->ui_ext[kUIFloatDebug]
       && !ui_client_channel_id) {
     ui_comp_attach(ui);
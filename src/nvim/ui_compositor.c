@@ -30,6 +30,16 @@
 #include "nvim/ui.h"
 #include "nvim/ui_compositor.h"
 
+/// Last result of hl_blend_attrs() in compose_line(), neighboring cells mostly
+/// have the same attributes.
+typedef struct {
+  int back_attr;
+  int front_attr;
+  bool through_in;  ///< "through" passed to hl_blend_attrs()
+  bool through;     ///< "through" returned by hl_blend_attrs()
+  int attr;
+} BlendCache;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "ui_compositor.c.generated.h"
 #endif
@@ -426,6 +436,7 @@ static void compose_line(Integer row, Integer startcol, Integer endcol, LineFlag
 
     // 'pumblend' and 'winblend'
     if (grid->blending) {
+      BlendCache bc = { .back_attr = INT_MIN };
       int width;
       for (int i = col - (int)startcol; i < until - startcol; i += width) {
         width = 1;
@@ -437,10 +448,10 @@ static void compose_line(Integer row, Integer startcol, Integer endcol, LineFlag
           thru &= (linebuf[i + 1] == schar_from_ascii(' ')
                    || linebuf[i + 1] == schar_from_char(L'\u2800'));
         }
-        attrbuf[i] = (sattr_T)hl_blend_attrs(bg_attrs[i], attrbuf[i], &thru);
+        attrbuf[i] = (sattr_T)compose_blend_attrs(&bc, bg_attrs[i], attrbuf[i], &thru);
         if (width == 2) {
-          attrbuf[i + 1] = (sattr_T)hl_blend_attrs(bg_attrs[i + 1],
-                                                   attrbuf[i + 1], &thru);
+          attrbuf[i + 1] = (sattr_T)compose_blend_attrs(&bc, bg_attrs[i + 1],
+                                                        attrbuf[i + 1], &thru);
         }
         if (thru) {
           memcpy(linebuf + i, bg_line + i, (size_t)width * sizeof(linebuf[i]));
@@ -487,6 +498,24 @@ static void compose_line(Integer row, Integer startcol, Integer endcol, LineFlag
                             (const sattr_T *)attrbuf + skipstart);
 }
 
+/// Like hl_blend_attrs(), but reuses the result for the previous cell when the
+/// attributes are the same.
+static inline int compose_blend_attrs(BlendCache *bc, int back_attr, int front_attr,
+                                      bool *through)
+{
+  if (back_attr != bc->back_attr || front_attr != bc->front_attr
+      || *through != bc->through_in) {
+    bc->back_attr = back_attr;
+    bc->front_attr = front_attr;
+    bc->through_in = *through;
+    bc->attr = hl_blend_attrs(back_attr, front_attr, through);
+    bc->through = *through;
+  } else {
+    *through = bc->through;
+  }
+  return bc->attr;
+}
+
 static void compose_debug(Integer startrow, Integer endrow, Integer startcol, Integer endcol,
                           int syn_id, bool delay)
 {
@@ -581,6 +610,10 @@ void ui_comp_raw_line(Integer grid, Integer row, Integer startcol, Integer endco
     endcol = MIN(endcol, clearcol);
   }
 
+  // The lines are encoded for the UIs while composing, don't count that twice.
+  const uint64_t compose_start = os_hrtime();
+  const int64_t encode_before = g_stats.ui_encode_ns;
+
   bool covered = curgrid_covered_above((int)row);
   // TODO(bfredl): eventually should just fix compose_line to respect clearing
   // and optimize it for uncovered lines.
@@ -598,6 +631,14 @@ void ui_comp_raw_line(Integer grid, Integer row, Integer startcol, Integer endco
     ui_composed_call_raw_line(1, row, startcol, endcol, clearcol, clearattr,
                               flags, chunk, attrs);
   }
+  g_stats.compositor_ns += (int64_t)(os_hrtime() - compose_start)
+                           - (g_stats.ui_encode_ns - encode_before);
+}
+
+/// Translate the message separator char while compacting the glyph cache.
+void ui_comp_remap_glyphs(void)
+{
+  msg_sep_char = schar_cache_remap(msg_sep_char);
 }
 
 /// The screen is invalid and will soon be cleared
@@ -19,6 +19,7 @@ typedef enum {
   kUIMultigrid,
   kUIHlState,
   kUITermColors,
+  kUIGridBin,
   kUIFloatDebug,
   kUIExtCount,
 } UIExtension;
@@ -30,6 +31,8 @@ enum {
 
 typedef int LineFlags;
 
+#define MAX_UI_COUNT 16
+
 typedef struct {
   bool rgb;
   bool override;  ///< Force highest-requested UI capabilities.
@@ -82,6 +85,11 @@ typedef struct {
   // Position of legacy cursor, used both for drawing and visible user cursor.
   Integer client_row, client_col;
   bool wildmenu_active;
+
+  /// UI with the same options which packs the events for this one, see ui_mirror_update()
+  RemoteUI *mirror;
+  size_t nmirrors;  ///< number of UIs which share the events of this one
+  uint64_t mirror_chans[MAX_UI_COUNT];  ///< channels of these UIs
 } RemoteUI;
 
 typedef struct {
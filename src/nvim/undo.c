@@ -108,6 +108,7 @@
 #include "nvim/globals.h"
 #include "nvim/highlight_defs.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
 #include "nvim/mbyte.h"
@@ -160,6 +161,13 @@ static bool undo_undoes = false;
 
 static int lastmark = 0;
 
+/// Pool for undo entries, there is one for every change.
+static MemPool u_entry_pool = MEM_POOL_INIT("u_entry", u_entry_T);
+
+// A single changed line is stored as a delta when this saves at least this
+// many bytes.
+enum { U_DELTA_MIN_SAVED = 64, };
+
 #if defined(U_DEBUG)
 // Check the undo structures for being valid.  Print a warning when something
 // looks wrong.
@@ -337,6 +345,29 @@ static OptInt get_undolevel(buf_T *buf)
   return buf->b_p_ul;
 }
 
+/// Get the 'undomemory' value for buffer "buf" in bytes, zero for no limit.
+static size_t get_undomemory(buf_T *buf)
+{
+  OptInt um = buf->b_p_um >= 0 ? buf->b_p_um : p_um;
+  return um > 0 ? (size_t)um * 1024 : 0;
+}
+
+/// @return  the number of bytes used by undo entry "uep" and its lines.
+static size_t u_entry_memory(const u_entry_T *uep)
+{
+  size_t size = sizeof(u_entry_T) + sizeof(char *) * (size_t)uep->ue_size;
+  for (linenr_T i = 0; i < uep->ue_size; i++) {
+    size += strlen(uep->ue_array[i]) + 1;
+  }
+  return size;
+}
+
+/// Subtract "size" bytes from the undo memory used by "buf".
+static void u_memory_sub(buf_T *buf, size_t size)
+{
+  buf->b_u_memory -= MIN(size, buf->b_u_memory);
+}
+
 static inline void zero_fmark_additional_data(fmark_T *fmarks)
 {
   for (size_t i = 0; i < NMARKS; i++) {
@@ -389,6 +420,12 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
     // Need to create new entry in b_changelist.
     buf->b_new_change = true;
 
+    // The buffer still has the text after the previous change, the last
+    // chance to store it as a delta against that text.
+    if (buf->b_u_curhead == NULL && buf->b_u_newhead != NULL && !buf->b_p_udf) {
+      u_compress_header(buf, buf->b_u_newhead);
+    }
+
     u_header_T *uhp;
     if (get_undolevel(buf) >= 0) {
       // Make a new header entry.  Do this first so that we don't mess
@@ -411,7 +448,9 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
     }
 
     // free headers to keep the size right
-    while (buf->b_u_numhead > get_undolevel(buf)
+    const size_t undomemory = get_undomemory(buf);
+    while ((buf->b_u_numhead > get_undolevel(buf)
+            || (undomemory > 0 && buf->b_u_memory > undomemory))
            && buf->b_u_oldhead != NULL) {
       u_header_T *uhfree = buf->b_u_oldhead;
 
@@ -465,6 +504,7 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
     }
 
     uhp->uh_seq = ++buf->b_u_seq_last;
+    pmap_put(int)(&buf->b_u_seq_headers, uhp->uh_seq, uhp);
     buf->b_u_seq_cur = uhp->uh_seq;
     uhp->uh_time = time(NULL);
     uhp->uh_save_nr = 0;
@@ -566,12 +606,29 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
       }
     }
 
+    // When saving the line just below the lines saved by the last entry,
+    // e.g. for ":substitute" on a range of lines, add it to that entry
+    // instead of making a new entry for every line.
+    if (size == 1 && newbot == 0 && bot <= buf->b_ml.ml_line_count) {
+      uep = u_get_headentry(buf);
+      if (uep != NULL
+          && buf->b_u_newhead->uh_getbot_entry == uep
+          && uep->ue_lcount == buf->b_ml.ml_line_count
+          && uep->ue_size > 0
+          && uep->ue_top + uep->ue_size == top) {
+        uep->ue_array = xrealloc(uep->ue_array, sizeof(char *) * (size_t)(uep->ue_size + 1));
+        uep->ue_array[uep->ue_size++] = u_save_line_buf(buf, top + 1);
+        buf->b_u_memory += sizeof(char *) + strlen(uep->ue_array[uep->ue_size - 1]) + 1;
+        return OK;
+      }
+    }
+
     // find line number for ue_bot for previous u_save()
     u_getbot(buf);
   }
 
   // add lines in front of entry list
-  uep = xmalloc(sizeof(u_entry_T));
+  uep = pool_alloc(&u_entry_pool);
   CLEAR_POINTER(uep);
 #ifdef U_DEBUG
   uep->ue_magic = UE_MAGIC;
@@ -605,6 +662,7 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
   } else {
     uep->ue_array = NULL;
   }
+  buf->b_u_memory += u_entry_memory(uep);
 
   uep->ue_next = buf->b_u_newhead->uh_entry;
   buf->b_u_newhead->uh_entry = uep;
@@ -642,6 +700,10 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, bool r
 // extra fields for uhp
 #define UHP_SAVE_NR            1
 
+// size of the stdio buffer used for reading and writing an undo file, the
+// tree is (de)serialized a few bytes at a time
+#define UF_BUFSIZE             65536
+
 static const char e_not_open[] = N_("E828: Cannot open undo file for writing: %s");
 
 /// Compute the hash for a buffer text into hash[UNDO_HASH_SIZE].
@@ -1079,7 +1141,7 @@ static bool serialize_uep(bufinfo_T *bi, u_entry_T *uep)
 
 static u_entry_T *unserialize_uep(bufinfo_T *bi, bool *error, const char *file_name)
 {
-  u_entry_T *uep = xmalloc(sizeof(u_entry_T));
+  u_entry_T *uep = pool_alloc(&u_entry_pool);
   CLEAR_POINTER(uep);
 #ifdef U_DEBUG
   uep->ue_magic = UE_MAGIC;
@@ -1249,6 +1311,20 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
     goto theend;
   }
 
+  // Changes made while 'undofile' was off may be stored as deltas.
+  if (u_has_delta(buf)) {
+    if (name != NULL || p_verbose > 0) {
+      if (name == NULL) {
+        verbose_enter();
+      }
+      smsg(0, "%s", _("Skipping undo file write, undo history was made without 'undofile'"));
+      if (name == NULL) {
+        verbose_leave();
+      }
+    }
+    goto theend;
+  }
+
   int fd = os_open(file_name, O_CREAT|O_WRONLY|O_EXCL|O_NOFOLLOW, perm);
   if (fd < 0) {
     semsg(_(e_not_open), file_name);
@@ -1288,6 +1364,7 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
     os_remove(file_name);
     goto theend;
   }
+  setvbuf(fp, NULL, _IOFBF, UF_BUFSIZE);
 
   // Undo must be synced.
   u_sync(true);
@@ -1418,6 +1495,7 @@ void u_read_undo(char *name, const uint8_t *hash, const char *orig_name FUNC_ATT
     }
     goto error;
   }
+  setvbuf(fp, NULL, _IOFBF, UF_BUFSIZE);
 
   bufinfo_T bi = {
     .bi_buf = curbuf,
@@ -1625,6 +1703,15 @@ void u_read_undo(char *name, const uint8_t *hash, const char *orig_name FUNC_ATT
   curbuf->b_u_line_lnum = line_lnum;
   curbuf->b_u_line_colnr = line_colnr;
   curbuf->b_u_numhead = num_head;
+  curbuf->b_u_memory = 0;
+  for (int i = 0; i < num_head; i++) {
+    if (uhp_table[i] != NULL) {
+      pmap_put(int)(&curbuf->b_u_seq_headers, uhp_table[i]->uh_seq, uhp_table[i]);
+      for (u_entry_T *uep = uhp_table[i]->uh_entry; uep != NULL; uep = uep->ue_next) {
+        curbuf->b_u_memory += u_entry_memory(uep);
+      }
+    }
+  }
   curbuf->b_u_seq_last = seq_last;
   curbuf->b_u_seq_cur = seq_cur;
   curbuf->b_u_time_cur = seq_time;
@@ -2016,6 +2103,17 @@ void undo_time(int step, bool sec, bool file, bool absolute)
     goto target_zero;
   }
 
+  // A sequence number is looked up directly, no need to search the tree.
+  if (absolute) {
+    uhp = pmap_get(int)(&curbuf->b_u_seq_headers, target);
+    if (uhp == NULL) {
+      semsg(_("E830: Undo number %" PRId64 " not found"), (int64_t)step);
+      return;
+    }
+    u_mark_path(uhp, &mark, &nomark);
+    goto target_zero;
+  }
+
   // May do this twice:
   // 1. Search for "target", update "closest" to the best match found.
   // 2. If "target" not found search for "closest".
@@ -2240,6 +2338,35 @@ target_zero:
   u_undo_end(did_undo, absolute, false);
 }
 
+/// Mark the path from the current undo state to header "target" in uh_walk,
+/// like the search in undo_time() does: the headers to undo with "*markp",
+/// then the headers to redo, together with the alternate branches before them
+/// that are passed to get there.
+static void u_mark_path(u_header_T *target, int *markp, int *nomarkp)
+{
+  u_header_T *cur = curbuf->b_u_curhead == NULL ? curbuf->b_u_newhead
+                                                 : curbuf->b_u_curhead->uh_next.ptr;
+  int curmark = ++lastmark;
+  for (u_header_T *uhp = cur; uhp != NULL; uhp = uhp->uh_next.ptr) {
+    uhp->uh_walk = curmark;
+  }
+
+  int mark = ++lastmark;
+  *markp = mark;
+  *nomarkp = ++lastmark;
+
+  // Go up from "target" until reaching a header above the current state.
+  u_header_T *common = target;
+  for (; common != NULL && common->uh_walk != curmark; common = common->uh_next.ptr) {
+    for (u_header_T *uhp = common; uhp != NULL; uhp = uhp->uh_alt_prev.ptr) {
+      uhp->uh_walk = mark;
+    }
+  }
+  for (u_header_T *uhp = cur; uhp != common; uhp = uhp->uh_next.ptr) {
+    uhp->uh_walk = mark;
+  }
+}
+
 /// u_undoredo: common code for undo and redo
 ///
 /// The lines in the file are replaced by the lines in the entry list at
@@ -2286,7 +2413,8 @@ static void u_undoredo(bool undo, bool do_buf_event)
       bot = curbuf->b_ml.ml_line_count + 1;
     }
     if (top > curbuf->b_ml.ml_line_count || top >= bot
-        || bot > curbuf->b_ml.ml_line_count + 1) {
+        || bot > curbuf->b_ml.ml_line_count + 1
+        || (uep->ue_delta && (bot - top - 1 != 1 || u_expand_entry(uep) == FAIL))) {
       unblock_autocmds();
       iemsg(_("E438: u_undo: line numbers wrong"));
       changed(curbuf);                // don't want UNCHANGED now
@@ -2295,6 +2423,7 @@ static void u_undoredo(bool undo, bool do_buf_event)
 
     linenr_T oldsize = bot - top - 1;        // number of lines before undo
     linenr_T newsize = uep->ue_size;         // number of lines after undo
+    u_memory_sub(curbuf, u_entry_memory(uep));
 
     if (top < newlnum) {
       // If the saved cursor is somewhere in this undo block, move it to
@@ -2396,6 +2525,7 @@ static void u_undoredo(bool undo, bool do_buf_event)
     uep->ue_size = oldsize;
     uep->ue_array = newarray;
     uep->ue_bot = top + newsize + 1;
+    curbuf->b_u_memory += u_entry_memory(uep);
 
     // insert this entry in front of the new entry list
     nuep = uep->ue_next;
@@ -2762,7 +2892,7 @@ void u_find_first_changed(void)
   }
   // Check that the last undo block was for the whole file.
   u_entry_T *uep = uhp->uh_entry;
-  if (uep->ue_top != 0 || uep->ue_bot != 0) {
+  if (uep->ue_top != 0 || uep->ue_bot != 0 || uep->ue_delta) {
     return;
   }
 
@@ -2820,6 +2950,112 @@ static u_entry_T *u_get_headentry(buf_T *buf)
   return buf->b_u_newhead->uh_entry;
 }
 
+/// Store the entry of header "uhp" compactly when it changed a single line:
+/// only keep the bytes of the old line that differ from the line in the
+/// buffer, which must have the text after the change.  The whole line is
+/// restored by u_expand_entry() when undoing.
+static void u_compress_header(buf_T *buf, u_header_T *uhp)
+{
+  u_entry_T *uep = uhp->uh_entry;
+  if (uep == NULL || uep->ue_next != NULL || uep->ue_size != 1 || uep->ue_delta
+      || uhp->uh_getbot_entry != NULL) {
+    return;
+  }
+  linenr_T lnum = uep->ue_top + 1;
+  linenr_T bot = uep->ue_bot == 0 ? buf->b_ml.ml_line_count + 1 : uep->ue_bot;
+  if (bot != lnum + 1 || lnum > buf->b_ml.ml_line_count) {
+    return;
+  }
+
+  char *old = uep->ue_array[0];
+  size_t old_len = strlen(old);
+  const char *cur = ml_get_buf(buf, lnum);
+  size_t cur_len = (size_t)ml_get_buf_len(buf, lnum);
+
+  size_t pre = 0;
+  while (pre < old_len && pre < cur_len && old[pre] == cur[pre]) {
+    pre++;
+  }
+  size_t suf = 0;
+  while (suf < old_len - pre && suf < cur_len - pre
+         && old[old_len - 1 - suf] == cur[cur_len - 1 - suf]) {
+    suf++;
+  }
+  if (pre + suf < U_DELTA_MIN_SAVED) {
+    return;
+  }
+
+  uep->ue_array[0] = xmemdupz(old + pre, old_len - pre - suf);
+  xfree(old);
+  u_memory_sub(buf, pre + suf);
+  uep->ue_delta = true;
+  uep->ue_delta_col = (colnr_T)pre;
+  uep->ue_delta_len = (colnr_T)(cur_len - pre - suf);
+  uep->ue_delta_linelen = (colnr_T)cur_len;
+}
+
+/// Restore the whole old line of an entry stored by u_compress_header().
+/// The current buffer must have the text after the change.
+///
+/// @return  FAIL when the line in the buffer does not match the entry.
+static int u_expand_entry(u_entry_T *uep)
+{
+  linenr_T lnum = uep->ue_top + 1;
+  if (lnum > curbuf->b_ml.ml_line_count || ml_get_len(lnum) != uep->ue_delta_linelen) {
+    return FAIL;
+  }
+  const char *cur = ml_get(lnum);
+  size_t col = (size_t)uep->ue_delta_col;
+  size_t mid_len = strlen(uep->ue_array[0]);
+  size_t tail = (size_t)(uep->ue_delta_linelen - uep->ue_delta_col - uep->ue_delta_len);
+
+  char *line = xmalloc(col + mid_len + tail + 1);
+  memcpy(line, cur, col);
+  memcpy(line + col, uep->ue_array[0], mid_len);
+  memcpy(line + col + mid_len, cur + col + uep->ue_delta_len, tail);
+  line[col + mid_len + tail] = NUL;
+
+  xfree(uep->ue_array[0]);
+  uep->ue_array[0] = line;
+  uep->ue_delta = false;
+  curbuf->b_u_memory += col + tail;
+  return OK;
+}
+
+/// @return  true if an undo entry of "buf" is stored as a delta, which can't
+///          be written to an undo file.
+static bool u_has_delta(buf_T *buf)
+{
+  int mark = ++lastmark;
+  u_header_T *uhp = buf->b_u_oldhead;
+  while (uhp != NULL) {
+    if (uhp->uh_walk != mark) {
+      uhp->uh_walk = mark;
+      for (u_entry_T *uep = uhp->uh_entry; uep != NULL; uep = uep->ue_next) {
+        if (uep->ue_delta) {
+          return true;
+        }
+      }
+    }
+
+    // Walk through the tree like u_write_undo().
+    if (uhp->uh_prev.ptr != NULL && uhp->uh_prev.ptr->uh_walk != mark) {
+      uhp = uhp->uh_prev.ptr;
+    } else if (uhp->uh_alt_next.ptr != NULL
+               && uhp->uh_alt_next.ptr->uh_walk != mark) {
+      uhp = uhp->uh_alt_next.ptr;
+    } else if (uhp->uh_next.ptr != NULL && uhp->uh_alt_prev.ptr == NULL
+               && uhp->uh_next.ptr->uh_walk != mark) {
+      uhp = uhp->uh_next.ptr;
+    } else if (uhp->uh_alt_prev.ptr != NULL) {
+      uhp = uhp->uh_alt_prev.ptr;
+    } else {
+      uhp = uhp->uh_next.ptr;
+    }
+  }
+  return false;
+}
+
 /// u_getbot(): compute the line number of the previous u_save
 ///              It is called only when b_u_synced is false.
 static void u_getbot(buf_T *buf)
@@ -2929,10 +3165,12 @@ static void u_freeentries(buf_T *buf, u_header_T *uhp, u_header_T **uhpp)
   if (uhpp != NULL && uhp == *uhpp) {
     *uhpp = NULL;
   }
+  pmap_del(int)(&buf->b_u_seq_headers, uhp->uh_seq, NULL);
 
   u_entry_T *nuep;
   for (u_entry_T *uep = uhp->uh_entry; uep != NULL; uep = nuep) {
     nuep = uep->ue_next;
+    u_memory_sub(buf, u_entry_memory(uep));
     u_freeentry(uep, uep->ue_size);
   }
 
@@ -2955,7 +3193,7 @@ static void u_freeentry(u_entry_T *uep, int n)
 #ifdef U_DEBUG
   uep->ue_magic = 0;
 #endif
-  xfree(uep);
+  pool_free(&u_entry_pool, uep);
 }
 
 /// invalidate the undo buffer; called when storage has already been released
@@ -2964,6 +3202,9 @@ void u_clearall(buf_T *buf)
   buf->b_u_newhead = buf->b_u_oldhead = buf->b_u_curhead = NULL;
   buf->b_u_synced = true;
   buf->b_u_numhead = 0;
+  buf->b_u_memory = 0;
+  map_destroy(int, &buf->b_u_seq_headers);
+  buf->b_u_seq_headers = (PMap(int)) MAP_INIT;
   buf->b_u_line_ptr = NULL;
   buf->b_u_line_lnum = 0;
 }
@@ -3109,6 +3350,48 @@ bool curbufIsChanged(void)
   return bufIsChanged(curbuf);
 }
 
+/// Returns a dict with the undotree() entries of undo header "uhp" in "buf",
+/// without "alt" and "parent".
+static dict_T *u_eval_header(buf_T *const buf, const u_header_T *const uhp)
+  FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_RET
+{
+  dict_T *const dict = tv_dict_alloc();
+  tv_dict_add_nr(dict, S_LEN("seq"), (varnumber_T)uhp->uh_seq);
+  tv_dict_add_nr(dict, S_LEN("time"), (varnumber_T)uhp->uh_time);
+  if (uhp == buf->b_u_newhead) {
+    tv_dict_add_nr(dict, S_LEN("newhead"), 1);
+  }
+  if (uhp == buf->b_u_curhead) {
+    tv_dict_add_nr(dict, S_LEN("curhead"), 1);
+  }
+  if (uhp->uh_save_nr > 0) {
+    tv_dict_add_nr(dict, S_LEN("save"), (varnumber_T)uhp->uh_save_nr);
+  }
+  return dict;
+}
+
+/// Returns the undo headers of "buf" with a sequence number above "since", for
+/// undotree() with "since", in the order of the sequence numbers.  Each item has the sequence number of
+/// the header it follows in "parent".
+static list_T *u_eval_since(buf_T *const buf, const int since)
+  FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_RET
+{
+  list_T *const list = tv_list_alloc(kListLenMayKnow);
+
+  for (int seq = MAX(since, 0) + 1; seq <= buf->b_u_seq_last; seq++) {
+    const u_header_T *const uhp = pmap_get(int)(&buf->b_u_seq_headers, seq);
+    if (uhp == NULL) {
+      continue;  // freed for 'undolevels' or 'undomemory'
+    }
+    dict_T *const dict = u_eval_header(buf, uhp);
+    tv_dict_add_nr(dict, S_LEN("parent"),
+                   (varnumber_T)(uhp->uh_next.ptr != NULL ? uhp->uh_next.ptr->uh_seq : 0));
+    tv_list_append_dict(list, dict);
+  }
+
+  return list;
+}
+
 /// Append the list of undo blocks to a newly allocated list
 ///
 /// For use in undotree(). Recursive.
@@ -3122,18 +3405,7 @@ static list_T *u_eval_tree(buf_T *const buf, const u_header_T *const first_uhp)
   list_T *const list = tv_list_alloc(kListLenMayKnow);
 
   for (const u_header_T *uhp = first_uhp; uhp != NULL; uhp = uhp->uh_prev.ptr) {
-    dict_T *const dict = tv_dict_alloc();
-    tv_dict_add_nr(dict, S_LEN("seq"), (varnumber_T)uhp->uh_seq);
-    tv_dict_add_nr(dict, S_LEN("time"), (varnumber_T)uhp->uh_time);
-    if (uhp == buf->b_u_newhead) {
-      tv_dict_add_nr(dict, S_LEN("newhead"), 1);
-    }
-    if (uhp == buf->b_u_curhead) {
-      tv_dict_add_nr(dict, S_LEN("curhead"), 1);
-    }
-    if (uhp->uh_save_nr > 0) {
-      tv_dict_add_nr(dict, S_LEN("save"), (varnumber_T)uhp->uh_save_nr);
-    }
+    dict_T *const dict = u_eval_header(buf, uhp);
 
     if (uhp->uh_alt_next.ptr != NULL) {
       // Recursive call to add alternate undo tree.
@@ -3184,8 +3456,14 @@ void f_undotree(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   tv_dict_add_nr(dict, S_LEN("seq_cur"), (varnumber_T)buf->b_u_seq_cur);
   tv_dict_add_nr(dict, S_LEN("time_cur"), (varnumber_T)buf->b_u_time_cur);
   tv_dict_add_nr(dict, S_LEN("save_cur"), (varnumber_T)buf->b_u_save_nr_cur);
+  tv_dict_add_nr(dict, S_LEN("memory"), (varnumber_T)buf->b_u_memory);
 
-  tv_dict_add_list(dict, S_LEN("entries"), u_eval_tree(buf, buf->b_u_oldhead));
+  if (argvars[0].v_type != VAR_UNKNOWN && argvars[1].v_type != VAR_UNKNOWN) {
+    const int since = (int)tv_get_number(&argvars[1]);
+    tv_dict_add_list(dict, S_LEN("entries"), u_eval_since(buf, since));
+  } else {
+    tv_dict_add_list(dict, S_LEN("entries"), u_eval_tree(buf, buf->b_u_oldhead));
+  }
 }
 
 // Given the buffer, Return the undo header. If none is set, set one first.
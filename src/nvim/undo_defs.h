@@ -25,6 +25,10 @@ struct u_entry {
   linenr_T ue_lcount;  ///< linecount when u_save called
   char **ue_array;     ///< array of lines in undo block
   linenr_T ue_size;    ///< number of lines in ue_array
+  bool ue_delta;       ///< ue_array[0] only has the changed bytes
+  colnr_T ue_delta_col;      ///< length of the unchanged start of the line
+  colnr_T ue_delta_len;      ///< length of the changed bytes in the new line
+  colnr_T ue_delta_linelen;  ///< length of the new line
 #ifdef U_DEBUG
   int ue_magic;        ///< magic number to check allocation
 #endif
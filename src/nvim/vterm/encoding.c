@@ -260,6 +260,20 @@ encodings[] = {
   { 0 },
 };
 
+/// @return true if printable ASCII decodes to the same characters with "inst",
+///         and it's not in the middle of a multibyte character.
+bool vterm_encoding_ascii_identity(const VTermEncodingInstance *inst)
+{
+  if (inst->enc == &encoding_usascii) {
+    return true;
+  }
+  if (inst->enc == &encoding_utf8) {
+    const struct UTF8DecoderData *data = (const struct UTF8DecoderData *)inst->data;
+    return data->bytes_remaining == 0;
+  }
+  return false;
+}
+
 VTermEncoding *vterm_lookup_encoding(VTermEncodingType type, char designation)
 {
   for (int i = 0; encodings[i].designation; i++) {
@@ -153,6 +153,39 @@ static int putglyph(VTermGlyphInfo *info, VTermPos pos, void *user)
   return 1;
 }
 
+static int putglyphs(const schar_T *schars, int count, VTermGlyphInfo *info, VTermPos pos,
+                     void *user)
+{
+  VTermScreen *screen = user;
+  ScreenCell *cell = getcell(screen, pos.row, pos.col);
+
+  if (!cell || pos.col + count > screen->cols) {
+    return 0;
+  }
+
+  for (int i = 0; i < count; i++, cell++) {
+    cell->schar = schars[i];
+    if (schars[i] != 0) {
+      cell->pen = screen->pen;
+    }
+    cell->pen.protected_cell = info->protected_cell;
+    cell->pen.dwl = info->dwl;
+    cell->pen.dhl = info->dhl;
+
+    if (screen->damage_merge == VTERM_DAMAGE_CELL) {
+      damagerect(screen, (VTermRect){ .start_row = pos.row, .end_row = pos.row + 1,
+                                      .start_col = pos.col + i, .end_col = pos.col + i + 1 });
+    }
+  }
+
+  if (screen->damage_merge != VTERM_DAMAGE_CELL) {
+    damagerect(screen, (VTermRect){ .start_row = pos.row, .end_row = pos.row + 1,
+                                    .start_col = pos.col, .end_col = pos.col + count });
+  }
+
+  return 1;
+}
+
 static void sb_pushline_from_row(VTermScreen *screen, int row)
 {
   VTermPos pos = { .row = row };
@@ -842,6 +875,7 @@ static int sb_clear(void *user)
 
 static VTermStateCallbacks state_cbs = {
   .putglyph = &putglyph,
+  .putglyphs = &putglyphs,
   .movecursor = &movecursor,
   .scrollrect = &scrollrect,
   .erase = &erase,
@@ -2,7 +2,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include "nvim/grid.h"
+#include "nvim/macros_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/vterm/encoding.h"
 #include "nvim/vterm/parser.h"
@@ -43,6 +48,26 @@ static void putglyph(VTermState *state, const schar_T schar, int width, VTermPos
   DEBUG_LOG("libvterm: Unhandled putglyph U+%04x at (%d,%d)\n", chars[0], pos.col, pos.row);
 }
 
+/// Puts "count" glyphs of width 1 in the row of "pos", starting at "pos".
+static void putglyphs(VTermState *state, const schar_T *schars, int count, VTermPos pos)
+{
+  if (state->callbacks && state->callbacks->putglyphs) {
+    VTermGlyphInfo info = {
+      .width = 1,
+      .protected_cell = state->protected_cell,
+      .dwl = state->lineinfo[pos.row].doublewidth,
+      .dhl = state->lineinfo[pos.row].doubleheight,
+    };
+    if ((*state->callbacks->putglyphs)(schars, count, &info, pos, state->cbdata)) {
+      return;
+    }
+  }
+
+  for (int i = 0; i < count; i++) {
+    putglyph(state, schars[i], 1, (VTermPos){ .row = pos.row, .col = pos.col + i });
+  }
+}
+
 static void updatecursor(VTermState *state, VTermPos *oldpos, int cancel_phantom)
 {
   if (state->pos.col == oldpos->col && state->pos.row == oldpos->row) {
@@ -305,10 +330,103 @@ static void set_lineinfo(VTermState *state, int row, int force, int dwl, int dhl
   }
 }
 
+/// @return the number of printable ASCII bytes at the start of "bytes[len]"
+///         that can be put with on_text_ascii().
+static size_t text_ascii_len(VTermState *state, const char bytes[], size_t len)
+{
+  // Insert mode, single shifts and autowrap off need the per glyph handling.
+  if (state->mode.insert || !state->mode.autowrap || state->gsingle_set
+      || !vterm_encoding_ascii_identity(&state->encoding[state->gl_set])) {
+    return 0;
+  }
+
+  size_t n = 0;
+#ifdef __SSE2__
+  const __m128i below = _mm_set1_epi8(0x20 - 1);
+  const __m128i above = _mm_set1_epi8(0x7f);
+  while (len - n >= 16) {
+    // Signed comparisons: bytes 0x80 and above are negative.
+    const __m128i v = _mm_loadu_si128((const __m128i *)(bytes + n));
+    const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(v, below),
+                                                     _mm_cmplt_epi8(v, above)));
+    if (mask != 0xffff) {
+      break;
+    }
+    n += 16;
+  }
+#endif
+  while (n < len && (uint8_t)bytes[n] >= 0x20 && (uint8_t)bytes[n] < 0x7f) {
+    n++;
+  }
+
+  // The first character may combine with the previous glyph (e.g. after a
+  // prepended concatenation mark).
+  if (n > 0 && state->pos.row == state->combine_pos.row
+      && state->pos.col == state->combine_pos.col + state->combine_width) {
+    GraphemeState grapheme_state = state->grapheme_state;
+    if (utf_iscomposing((int)state->grapheme_last, (uint8_t)bytes[0], &grapheme_state)) {
+      return 0;
+    }
+  }
+  return n;
+}
+
+/// Puts printable ASCII characters, which never combine and have width 1, a
+/// row at a time. Does the same as on_text() otherwise.
+static void on_text_ascii(VTermState *state, const char bytes[], size_t len)
+{
+  VTermPos oldpos = state->pos;
+  schar_T *schars = (schar_T *)(state->vt->tmpbuffer);
+  size_t maxchars = (state->vt->tmpbuffer_len) / sizeof(schar_T);
+
+  VTermPos lastpos = state->pos;
+  size_t i = 0;
+  while (i < len) {
+    if (state->at_phantom || state->pos.col + 1 > THISROWWIDTH(state)) {
+      linefeed(state);
+      state->pos.col = 0;
+      state->at_phantom = 0;
+      state->lineinfo[state->pos.row].continuation = 1;
+    }
+
+    int rowwidth = THISROWWIDTH(state);
+    size_t count = MIN(MIN(len - i, maxchars), (size_t)(rowwidth - state->pos.col));
+    for (size_t j = 0; j < count; j++) {
+      schars[j] = schar_from_ascii(bytes[i + j]);
+    }
+    putglyphs(state, schars, (int)count, state->pos);
+    i += count;
+
+    lastpos = (VTermPos){ .row = state->pos.row, .col = state->pos.col + (int)count - 1 };
+    if (state->pos.col + (int)count >= rowwidth) {
+      state->pos.col = rowwidth - 1;
+      state->at_phantom = 1;
+    } else {
+      state->pos.col += (int)count;
+    }
+  }
+
+  // Save the last char in case it has to be combined with more on the next call.
+  state->grapheme_buf[0] = bytes[len - 1];
+  state->grapheme_len = 1;
+  state->grapheme_last = (uint8_t)bytes[len - 1];
+  state->grapheme_state = GRAPHEME_STATE_INIT;
+  state->combine_width = 1;
+  state->combine_pos = lastpos;
+
+  updatecursor(state, &oldpos, 0);
+}
+
 static int on_text(const char bytes[], size_t len, void *user)
 {
   VTermState *state = user;
 
+  size_t ascii_len = text_ascii_len(state, bytes, len);
+  if (ascii_len > 0) {
+    on_text_ascii(state, bytes, ascii_len);
+    return (int)ascii_len;
+  }
+
   VTermPos oldpos = state->pos;
 
   uint32_t *codepoints = (uint32_t *)(state->vt->tmpbuffer);
@@ -256,6 +256,10 @@ struct VTermBuilder {
 
 typedef struct {
   int (*putglyph)(VTermGlyphInfo *info, VTermPos pos, void *user);
+  // Optional: "count" glyphs of width 1 in one row starting at "pos", with the
+  // attributes in "info". Without it putglyph is called for each one.
+  int (*putglyphs)(const schar_T *schars, int count, VTermGlyphInfo *info, VTermPos pos,
+                   void *user);
   int (*movecursor)(VTermPos pos, VTermPos oldpos, int visible, void *user);
   int (*scrollrect)(VTermRect rect, int downward, int rightward, void *user);
   int (*moverect)(VTermRect dest, VTermRect src, void *user);
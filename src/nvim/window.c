@@ -18,6 +18,7 @@
 #include "nvim/cursor.h"
 #include "nvim/decoration.h"
 #include "nvim/diff.h"
+#include "nvim/drawline.h"
 #include "nvim/drawscreen.h"
 #include "nvim/edit.h"
 #include "nvim/errors.h"
@@ -4992,7 +4993,7 @@ static void win_enter_ext(win_T *const wp, const int flags)
   }
   if (!curwin_invalid) {
     prevwin = curwin;           // remember for CTRL-W p
-    curwin->w_redr_status = true;
+    status_redraw_win(curwin);
   }
   curwin = wp;
   curbuf = wp->w_buffer;
@@ -5024,7 +5025,7 @@ static void win_enter_ext(win_T *const wp, const int flags)
   }
 
   maketitle();
-  curwin->w_redr_status = true;
+  status_redraw_win(curwin);
   redraw_tabline = true;
   if (restart_edit) {
     redraw_later(curwin, UPD_VALID);  // causes status line redraw
@@ -5279,6 +5280,9 @@ void win_free(win_T *wp, tabpage_T *tp)
   }
 
   xfree(wp->w_lines);
+  win_line_cache_clear(wp);
+  vcol_cache_clear(wp);
+  inline_virt_cache_clear(wp);
 
   for (int i = 0; i < wp->w_tagstacklen; i++) {
     tagstack_clear_entry(&wp->w_tagstack[i]);
@@ -5296,6 +5300,10 @@ void win_free(win_T *wp, tabpage_T *tp)
   stl_clear_click_defs(wp->w_statuscol_click_defs, wp->w_statuscol_click_defs_size);
   xfree(wp->w_statuscol_click_defs);
 
+  for (size_t i = 0; i < ARRAY_SIZE(wp->w_stl_cache); i++) {
+    stl_cache_clear(&wp->w_stl_cache[i]);
+  }
+
   // Remove the window from the b_wininfo lists, it may happen that the
   // freed memory is re-used for another window.
   FOR_ALL_BUFFERS(buf) {
@@ -5860,7 +5868,7 @@ static void frame_comp_pos(frame_T *topfrp, int *row, int *col)
       wp->w_winrow = *row;
       wp->w_wincol = *col;
       redraw_later(wp, UPD_NOT_VALID);
-      wp->w_redr_status = true;
+      status_redraw_win(wp);
       wp->w_pos_changed = true;
     }
     const int h = wp->w_height + wp->w_hsep_height + wp->w_status_height;
@@ -6748,7 +6756,7 @@ void win_set_inner_size(win_T *wp, bool valid_cursor)
                                  wp->w_wincol_off, wp->w_border_adj[1]);
   }
 
-  wp->w_redr_status = true;
+  status_redraw_win(wp);
 }
 
 /// Set the width of a window.
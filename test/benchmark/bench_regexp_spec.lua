@@ -61,4 +61,44 @@ describe('regexp search', function()
     command(string.format(measure_cmd, regexpengine))
     command('write')
   end)
+
+  it('is working with regexpengine=3', function()
+    local regexpengine = 3
+    command(string.format(measure_cmd, regexpengine))
+    command('write')
+  end)
+end)
+
+describe('regexp search without a match', function()
+  -- Patterns that the lazy DFA handles, on lines where most don't match.
+  local patterns = { [[\w\+Exception\s*:]], [[^\s*[0-9]\+ ERROR]], [[[a-f]\{4}-[a-f]\{4}]] }
+
+  setup(function()
+    clear()
+    source([[
+      func MeasureNoMatch(re, pattern)
+        let sstart = reltime()
+        execute 'set re=' .. a:re
+        for lnum in range(1, line('$'))
+          call match(getline(lnum), a:pattern)
+        endfor
+        return reltimefloat(reltime(sstart))
+      endfunc
+      call setline(1, repeat(['2024-01-01 12:00:00 INFO the quick brown fox jumps over the lazy dog'], 20000))
+    ]])
+  end)
+
+  for _, pattern in ipairs(patterns) do
+    it(pattern, function()
+      local times = {}
+      for re = 1, 3 do
+        times[#times + 1] = string.format(
+          're=%d: %.3fs',
+          re,
+          n.call('MeasureNoMatch', re, pattern)
+        )
+      end
+      print('\n' .. pattern .. ': ' .. table.concat(times, ', '))
+    end)
+  end
 end)
@@ -137,4 +137,49 @@ describe('decor perf', function()
     )
     print('\nTotal ' .. res)
   end)
+
+  it('can handle many overlapping highlights', function()
+    Screen.new(100, 51)
+
+    local result = exec_lua(function()
+      local lines = {}
+      for _ = 1, 50 do
+        table.insert(lines, ('x'):rep(1000))
+      end
+      vim.api.nvim_buf_set_lines(0, 0, 0, false, lines)
+      vim.api.nvim_win_set_cursor(0, { 1, 0 })
+      vim.wo.wrap = true
+      local ns = vim.api.nvim_create_namespace('decor_spec.lua')
+      local hl = vim.api.nvim_get_hl_id_by_name('Comment')
+      for row = 0, 49 do
+        for col = 0, 999 do
+          vim.api.nvim_buf_set_extmark(0, ns, row, col, { end_col = 1000, hl_group = hl })
+        end
+      end
+
+      local total = {}
+      for _ = 1, 10 do
+        local tic = vim.uv.hrtime()
+        vim.cmd 'redraw!'
+        local toc = vim.uv.hrtime()
+        table.insert(total, toc - tic)
+      end
+
+      return { total }
+    end)
+
+    local total = unpack(result)
+    table.sort(total)
+
+    local ms = 1 / 1000000
+    local res = string.format(
+      'min, 25%%, median, 75%%, max:\n\t%0.1fms,\t%0.1fms,\t%0.1fms,\t%0.1fms,\t%0.1fms',
+      total[1] * ms,
+      total[1 + math.floor(#total * 0.25)] * ms,
+      total[1 + math.floor(#total * 0.5)] * ms,
+      total[1 + math.floor(#total * 0.75)] * ms,
+      total[#total] * ms
+    )
+    print('\nTotal ' .. res)
+  end)
 end)
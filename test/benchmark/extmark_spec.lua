@@ -42,4 +42,29 @@ describe('extmark perf', function()
       stop('nvim_buf_clear_namespace')
     ]])
   end)
+
+  it('range queries in a mark-heavy buffer', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 10000 do
+        lines[i] = ('line %d with some text'):format(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local ns = vim.api.nvim_create_namespace('ns')
+
+      start()
+      for i = 0, 9999 do
+        for col = 0, 20, 5 do
+          vim.api.nvim_buf_set_extmark(0, ns, i, col, { end_col = col + 3 })
+        end
+      end
+      stop('nvim_buf_set_extmark')
+
+      start()
+      for i = 0, 9950, 10 do
+        vim.api.nvim_buf_get_extmarks(0, ns, { i, 0 }, { i + 50, 0 }, { overlap = true })
+      end
+      stop('nvim_buf_get_extmarks')
+    ]])
+  end)
 end)
@@ -0,0 +1,79 @@
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local exec = n.exec
+local fn = n.fn
+
+local N = 200000
+
+describe('hashtab perf', function()
+  before_each(function()
+    clear()
+    exec([[
+      func Measure(name, fn)
+        let start = reltime()
+        call call(a:fn, [])
+        return printf('%14.6f ms - %s', reltimefloat(reltime(start)) * 1000, a:name)
+      endfunc
+    ]])
+  end)
+
+  local function run(name, body)
+    exec('func Bench()\n' .. body:format(N) .. '\nendfunc')
+    print(fn.Measure(name, 'Bench'))
+  end
+
+  it('local variable lookups', function()
+    run(
+      'local variables',
+      [[
+        let [i, sum, step] = [0, 0, 3]
+        while i < %d
+          let sum += i * step
+          let i += 1
+        endwhile]]
+    )
+  end)
+
+  it('global variable lookups', function()
+    run(
+      'global variables',
+      [[
+        let [g:i, g:sum] = [0, 0]
+        while g:i < %d
+          let g:sum += g:i
+          let g:i += 1
+        endwhile]]
+    )
+  end)
+
+  it('dict lookups', function()
+    run(
+      'dict with 1000 keys',
+      [[
+        let d = {}
+        for k in range(1000)
+          let d['key' .. k] = k
+        endfor
+        let [i, sum] = [0, 0]
+        while i < %d
+          let sum += d['key' .. (i %% 1000)]
+          let i += 1
+        endwhile]]
+    )
+  end)
+
+  it('dict inserts and removals', function()
+    run(
+      'dict add/remove',
+      [[
+        let d = {}
+        for i in range(%d)
+          let d[i] = i
+          if i >= 100
+            call remove(d, i - 100)
+          endif
+        endfor]]
+    )
+  end)
+end)
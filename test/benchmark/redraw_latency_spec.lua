@@ -0,0 +1,162 @@
+-- Replays a script of keys and events against a large file with treesitter
+-- highlighting, diagnostics, signs and a statusline, and reports latency
+-- percentiles per phase, measured by Nvim itself (see nvim__stats()).
+--
+-- Set $BENCH_JSON to also append the results as one JSON object per line.
+
+local n = require('test.functional.testnvim')()
+
+local api = n.api
+local exec_lua = n.exec_lua
+
+local PHASES = {
+  { 'latency', 'input_latency_ns' },
+  { 'input', 'input_ns' },
+  { 'update_screen', 'redraw_ns' },
+  { 'win_line', 'win_line_ns' },
+  { 'compositor', 'compositor_ns' },
+  { 'ui_encode', 'ui_encode_ns' },
+}
+
+local SCRIPT = {
+  { keys = 'j', rep = 100 },
+  { keys = '<C-d>', rep = 20 },
+  { keys = '<C-u>', rep = 20 },
+  { keys = 'w', rep = 50 },
+  { keys = 'ifoo<Esc>', rep = 20 },
+  { keys = 'u', rep = 20 },
+  { keys = 'ddp', rep = 20 },
+  { keys = '/return<CR>' },
+  { keys = 'n', rep = 30 },
+  { keys = 'G' },
+  { keys = 'gg' },
+  { keys = ':vsplit<CR>' },
+  { keys = '<C-f>', rep = 20 },
+  { lua = 'refresh_diagnostics()', rep = 10 },
+}
+
+local function setup_corpus()
+  n.command('edit ./src/nvim/eval.c')
+  exec_lua(function()
+    vim.treesitter.highlighter.new(vim.treesitter.get_parser(0, 'c', {}))
+
+    vim.o.number = true
+    vim.o.cursorline = true
+    vim.o.signcolumn = 'yes:2'
+    vim.o.laststatus = 2
+    vim.o.statusline = '%f %h%m%r %{&filetype} %{len(getline("."))} %=%l,%c%V %P'
+
+    local sign_ns = vim.api.nvim_create_namespace('redraw_latency_signs')
+    local line_count = vim.api.nvim_buf_line_count(0)
+    for lnum = 0, line_count - 1, 7 do
+      vim.api.nvim_buf_set_extmark(0, sign_ns, lnum, 0, { sign_text = 'S', sign_hl_group = 'Todo' })
+    end
+
+    local diag_ns = vim.api.nvim_create_namespace('redraw_latency_diagnostics')
+    local gen = 0
+    function _G.refresh_diagnostics()
+      gen = gen + 1
+      local diags = {}
+      for lnum = gen % 10, line_count - 1, 10 do
+        diags[#diags + 1] = {
+          lnum = lnum,
+          col = 0,
+          end_col = 4,
+          severity = lnum % 4 + 1,
+          message = ('diagnostic %d on line %d'):format(gen, lnum),
+        }
+      end
+      vim.diagnostic.set(diag_ns, 0, diags)
+    end
+    _G.refresh_diagnostics()
+  end)
+end
+
+--- @param values number[]
+--- @param p number
+local function percentile(values, p)
+  if #values == 0 then
+    return 0
+  end
+  local i = math.max(1, math.ceil(#values * p / 100))
+  return values[i]
+end
+
+--- Plays "script" and returns the duration of each phase for every step, in
+--- nanoseconds.
+local function replay(script)
+  local samples = {} --- @type table<string, number[]>
+  for _, phase in ipairs(PHASES) do
+    samples[phase[1]] = {}
+  end
+
+  for _, step in ipairs(script) do
+    for _ = 1, step.rep or 1 do
+      local before = api.nvim__stats()
+      if step.keys then
+        api.nvim_input(step.keys)
+      else
+        exec_lua(step.lua)
+      end
+      -- nvim_eval() is handled after the input was processed and the screen
+      -- was flushed.
+      n.poke_eventloop()
+      local after = api.nvim__stats()
+      -- Steps without input (events) have no input latency.
+      local has_input = after.input_latency > before.input_latency
+      for _, phase in ipairs(PHASES) do
+        if has_input or (phase[1] ~= 'latency' and phase[1] ~= 'input') then
+          table.insert(samples[phase[1]], after[phase[2]] - before[phase[2]])
+        end
+      end
+    end
+  end
+  return samples
+end
+
+local function report(name, samples)
+  print()
+  print(('%-14s %6s %10s %10s %10s %10s'):format(name, 'n', 'p50 ms', 'p90 ms', 'p99 ms', 'max ms'))
+  local result = { name = name, phases = {} }
+  for _, phase in ipairs(PHASES) do
+    local values = samples[phase[1]]
+    table.sort(values)
+    local row = { count = #values }
+    for _, p in ipairs({ 50, 90, 99, 100 }) do
+      row['p' .. p] = percentile(values, p) / 1e6
+    end
+    result.phases[phase[1]] = row
+    print(
+      ('%-14s %6d %10.3f %10.3f %10.3f %10.3f'):format(
+        phase[1],
+        row.count,
+        row.p50,
+        row.p90,
+        row.p99,
+        row.p100
+      )
+    )
+  end
+
+  local json_path = os.getenv('BENCH_JSON')
+  if json_path and json_path ~= '' then
+    local f = assert(io.open(json_path, 'a'))
+    f:write(vim.json.encode(result), '\n')
+    f:close()
+  end
+end
+
+describe('redraw latency', function()
+  before_each(function()
+    n.clear()
+    -- A UI that ignores the redraw events, so that only Nvim is measured.
+    api.nvim_ui_attach(120, 50, { ext_linegrid = true })
+    setup_corpus()
+  end)
+
+  it('replays a script of keys and events', function()
+    -- Warm up caches (treesitter, glyphs, highlights) first.
+    replay({ { keys = 'jk', rep = 20 } })
+    report('eval.c', replay(SCRIPT))
+  end)
+end)
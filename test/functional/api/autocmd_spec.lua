@@ -10,6 +10,7 @@ local matches = t.matches
 local api = n.api
 local source = n.source
 local pcall_err = t.pcall_err
+local retry = t.retry
 
 before_each(clear)
 
@@ -39,6 +40,13 @@ describe('autocmd api', function()
         })
       )
       eq("Required: 'command' or 'callback'", pcall_err(api.nvim_create_autocmd, 'FileType', {}))
+      eq(
+        "Invalid 'debounce': out of range",
+        pcall_err(api.nvim_create_autocmd, 'FileType', {
+          command = 'ls',
+          debounce = -1,
+        })
+      )
       eq(
         "Invalid 'desc': expected String, got Integer",
         pcall_err(api.nvim_create_autocmd, 'FileType', {
@@ -412,6 +420,29 @@ describe('autocmd api', function()
         ]])
       )
     end)
+
+    it('runs a debounced autocmd once for repeated events', function()
+      eq(
+        0,
+        exec_lua([[
+          _G.calls = {}
+          vim.api.nvim_create_autocmd('User', {
+            pattern = 'Test',
+            debounce = 20,
+            callback = function(args)
+              table.insert(_G.calls, args.data)
+            end,
+          })
+          for i = 1, 3 do
+            vim.api.nvim_exec_autocmds('User', { pattern = 'Test', data = i })
+          end
+          return #_G.calls
+        ]])
+      )
+      retry(nil, 1000, function()
+        eq({ 3 }, exec_lua('return _G.calls'))
+      end)
+    end)
   end)
 
   describe('nvim_get_autocmds', function()
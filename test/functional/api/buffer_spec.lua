@@ -677,6 +677,25 @@ describe('api/buf', function()
       end
     end)
 
+    it('inserts many lines at once', function()
+      set_lines(0, -1, true, { 'first', 'last' })
+      local lines = {}
+      for i = 1, 5000 do
+        lines[i] = ('line %d '):format(i) .. ('x'):rep(i % 100)
+      end
+      set_lines(1, 1, true, lines)
+      eq(5002, api.nvim_buf_line_count(0))
+      eq({ 'first', lines[1] }, get_lines(0, 2, true))
+      eq({ lines[2500] }, get_lines(2500, 2501, true))
+      eq({ lines[5000], 'last' }, get_lines(-3, -1, true))
+      eq(lines, get_lines(1, -2, true))
+      -- insert in front of the inserted lines again
+      set_lines(1, 1, true, lines)
+      eq(10002, api.nvim_buf_line_count(0))
+      eq({ lines[5000], lines[1] }, get_lines(5000, 5002, true))
+      eq(fn.line2byte(10002), fn.line2byte(10001) + #lines[5000] + 1)
+    end)
+
     it('can get line ranges with non-strict indexing', function()
       set_lines(0, -1, true, { 'a', 'b', 'c' })
       eq({ 'a', 'b', 'c' }, get_lines(0, -1, true)) --sanity
@@ -1639,6 +1658,8 @@ describe('api/buf', function()
     it('can handle NULs', function()
       set_text(0, 0, 0, 0, { 'ab\0cd' })
       eq('ab\0cd', curbuf_depr('get_line', 0))
+      set_text(0, 0, 0, 0, { 'x', 'e\0f', 'y' })
+      eq({ 'x', 'e\0f', 'yab\0cd' }, get_lines(0, -1, true))
     end)
 
     it('adjusts extmarks', function()
@@ -1868,6 +1889,66 @@ describe('api/buf', function()
     end)
   end)
 
+  describe('nvim_buf_apply_edits', function()
+    it('applies edits relative to the original text', function()
+      api.nvim_buf_set_lines(0, 0, -1, true, { 'hello foo!', 'text', 'more text' })
+      api.nvim_buf_apply_edits(0, {
+        { 0, 6, 0, 9, { 'world' } },
+        { 2, 0, 2, 5, {} },
+        { 0, 0, 0, 0, { 'well ' } },
+        { 1, 4, 2, 0, { '', 'new', '' } },
+        { 0, 0, 0, 0, { 'oh, ' } },
+      })
+      eq(
+        { 'well oh, hello world!', 'text', 'new', 'text' },
+        api.nvim_buf_get_lines(0, 0, -1, true)
+      )
+    end)
+
+    it('creates a single undo step and changedtick update', function()
+      api.nvim_buf_set_lines(0, 0, -1, true, { 'a b c' })
+      local tick = api.nvim_buf_get_changedtick(0)
+      api.nvim_buf_apply_edits(0, {
+        { 0, 0, 0, 1, { 'x' } },
+        { 0, 2, 0, 3, { 'y' } },
+        { 0, 4, 0, 5, { 'z' } },
+      })
+      eq({ 'x y z' }, api.nvim_buf_get_lines(0, 0, -1, true))
+      eq(tick + 1, api.nvim_buf_get_changedtick(0))
+      command('undo')
+      eq({ 'a b c' }, api.nvim_buf_get_lines(0, 0, -1, true))
+    end)
+
+    it('moves extmarks like nvim_buf_set_text()', function()
+      api.nvim_buf_set_lines(0, 0, -1, true, { 'abc def ghi' })
+      local ns = api.nvim_create_namespace('apply_edits')
+      local id = api.nvim_buf_set_extmark(0, ns, 0, 8, {})
+      api.nvim_buf_apply_edits(0, {
+        { 0, 0, 0, 3, { 'a', 'b' } },
+        { 0, 4, 0, 7, { '' } },
+      })
+      eq({ 'a', 'b  ghi' }, api.nvim_buf_get_lines(0, 0, -1, true))
+      eq({ 1, 3 }, api.nvim_buf_get_extmark_by_id(0, ns, id, {}))
+    end)
+
+    it('validates edits', function()
+      api.nvim_buf_set_lines(0, 0, -1, true, { 'abc def' })
+      eq(
+        'edits overlap',
+        pcall_err(api.nvim_buf_apply_edits, 0, { { 0, 0, 0, 4, { 'x' } }, { 0, 2, 0, 6, { 'y' } } })
+      )
+      eq(
+        "Invalid 'start_row': out of range",
+        pcall_err(api.nvim_buf_apply_edits, 0, { { 5, 0, 5, 0, { 'x' } } })
+      )
+      eq(
+        "'start' is higher than 'end'",
+        pcall_err(api.nvim_buf_apply_edits, 0, { { 0, 4, 0, 2, { 'x' } } })
+      )
+      eq({ 'abc def' }, api.nvim_buf_get_lines(0, 0, -1, true))
+    end)
+  end)
+
   describe_lua_and_rpc('nvim_buf_get_text', function(lua_or_rpc)
     local get_text = lua_or_rpc.nvim_buf_get_text
     before_each(function()
@@ -240,6 +240,44 @@ describe('API/extmarks', function()
     eq({}, get_extmarks(ns2, { 0, 0 }, { -1, -1 }))
   end)
 
+  it('can clear a namespace holding most marks', function()
+    for i = 0, 4 do
+      set_extmark(ns, i + 1, 0, i, { end_col = 5 })
+    end
+    set_extmark(ns2, 1, 0, 1, { end_col = 3, hl_group = 'Error' })
+    api.nvim_buf_clear_namespace(0, ns, 0, -1)
+    eq({}, get_extmarks(ns, 0, -1))
+    eq({ { 1, 0, 1 } }, get_extmarks(ns2, 0, -1))
+    eq(3, get_extmark_by_id(ns2, 1, { details = true })[3].end_col)
+    -- the kept mark still moves with the text
+    feed('0x')
+    eq({ 0, 0 }, get_extmark_by_id(ns2, 1))
+    eq(2, get_extmark_by_id(ns2, 1, { details = true })[3].end_col)
+  end)
+
+  it('can set many marks at once', function()
+    set_extmark(ns, 10, 0, 4)
+    local ids = api.nvim_buf_set_extmarks(0, ns, { { 0, 1 }, { 0, 2, { id = 5, end_col = 3 } } }, {})
+    eq({ 11, 5 }, ids)
+    eq({ { 11, 0, 1 }, { 5, 0, 2 }, { 10, 0, 4 } }, get_extmarks(ns, { 0, 0 }, { -1, -1 }))
+    eq(3, get_extmark_by_id(ns, 5, { details = true })[3].end_col)
+
+    -- clear replaces the marks of the namespace
+    set_extmark(ns2, 1, 0, 0)
+    ids = api.nvim_buf_set_extmarks(0, ns, { { 0, 3 } }, { clear = true })
+    eq({ { ids[1], 0, 3 } }, get_extmarks(ns, { 0, 0 }, { -1, -1 }))
+    eq({ { 1, 0, 0 } }, get_extmarks(ns2, { 0, 0 }, { -1, -1 }))
+
+    eq(
+      'Invalid marks item: expected [line, col, opts]',
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 0 } }, {})
+    )
+    eq(
+      "Invalid 'col': expected Integer, got String",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 0, 'x' } }, {})
+    )
+  end)
+
   it('can undo with extmarks (#25147)', function()
     feed('itest<esc>')
     set_extmark(ns, 1, 0, 0)
@@ -457,6 +495,14 @@ describe('API/extmarks', function()
     check_undo_redo(ns, marks[1], 1, 1, 4, 1)
   end)
 
+  it('marks move with multiline typing in insert mode', function()
+    set_extmark(ns, marks[1], 0, 0)
+    set_extmark(ns, marks[2], 0, 3)
+    feed('0ia<cr>b<cr>c<esc>')
+    check_undo_redo(ns, marks[1], 0, 0, 2, 1)
+    check_undo_redo(ns, marks[2], 0, 3, 2, 4)
+  end)
+
   it('marks move with line join', function()
     -- do_join in ops.c
     feed('a<cr>222<esc>')
@@ -1762,6 +1808,25 @@ describe('API/extmarks', function()
     eq({ { 5, 0, 0 } }, get_extmarks(-1, 0, -1, { type = 'virt_lines' }))
   end)
 
+  it('can filter virt_lines marks among many other marks', function()
+    local lines = {}
+    for i = 1, 100 do
+      lines[i] = 'line ' .. i
+    end
+    api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    for i = 0, 99 do
+      set_extmark(ns, i + 1, i, 0, {})
+      set_extmark(ns, i + 101, i, 1, { end_row = i, end_col = 3, hl_group = 'Normal' })
+    end
+    set_extmark(ns, 201, 10, 2, { virt_lines = { { { 'a', 'Normal' } } } })
+    set_extmark(ns, 202, 70, 2, { virt_lines = { { { 'b', 'Normal' } } } })
+    eq({ { 201, 10, 2 }, { 202, 70, 2 } }, get_extmarks(ns, 0, -1, { type = 'virt_lines' }))
+    eq({ { 202, 70, 2 } }, get_extmarks(ns, { 10, 3 }, -1, { type = 'virt_lines' }))
+    eq({ { 201, 10, 2 } }, get_extmarks(ns, 0, { 70, 1 }, { type = 'virt_lines' }))
+    eq({ { 201, 10, 2 } }, get_extmarks(ns, { 10, 0 }, { 20, 0 }, { type = 'virt_lines', overlap = true }))
+    eq({ { 202, 70, 2 } }, get_extmarks(-1, { 70, 2 }, -1, { type = 'virt_lines', overlap = true }))
+  end)
+
   it('invalidated marks are deleted', function()
     screen = Screen.new(40, 6)
     feed('dd6iaaa bbb ccc<CR><ESC>gg')
@@ -99,4 +99,22 @@ describe('notify', function()
       eq({}, api.nvim_get_chan_info(catchan))
     end) -- cat be dead :(
   end)
+
+  it('drops notifications to a channel which does not read them', function()
+    t.skip(t.is_os('win'), 'N/A for Windows')
+    local chan = eval("jobstart(['sleep', '10'], {'rpc': v:true})")
+    local info = exec_lua(function(...)
+      local data = string.rep('x', 1024 * 1024)
+      for _ = 1, 80 do
+        vim.rpcnotify(..., 'flood', data)
+      end
+      return vim.api.nvim_get_chan_info(...)
+    end, chan)
+    eq('number', type(info.dropped_notifications))
+    eq(true, info.dropped_notifications > 0)
+    eq(true, info.queued_bytes > 64 * 1024 * 1024)
+    eq(0, eval('rpcnotify(' .. chan .. ', "flood")'))
+    assert_alive()
+    command('call jobstop(' .. chan .. ')')
+  end)
 end)
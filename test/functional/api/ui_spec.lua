@@ -69,6 +69,47 @@ describe('nvim_ui_attach()', function()
       pcall_err(request, 'nvim_ui_attach', 40, 10, { rgb = false })
     )
   end)
+
+  it('ext_gridbin sends cells as binary data', function()
+    local screen = Screen.new(20, 4, { ext_gridbin = true })
+    eq(true, api.nvim_list_uis()[1].ext_gridbin)
+    eq(true, api.nvim_list_uis()[1].ext_linegrid)
+    feed('iaaaabé<Esc>')
+    feed('0vl')
+    screen:expect([[
+      {17:a}^aaabé              |
+      {1:~                   }|*2
+      {5:-- VISUAL --}        |
+    ]])
+    eq(
+      'ext_gridbin option cannot be changed',
+      pcall_err(request, 'nvim_ui_set_option', 'ext_gridbin', false)
+    )
+  end)
+
+  it('UIs with the same options get the same events', function()
+    local screen = Screen.new(20, 4)
+    local session2 = n.connect(eval('v:servername'))
+    local screen2 = Screen.new(20, 4, {}, session2)
+    feed('ifoo<Esc>')
+    local expected = [[
+      fo^o                 |
+      {1:~                   }|*2
+                          |
+    ]]
+    screen:expect(expected)
+    screen2:expect(expected)
+    -- the remaining UI gets the events after the first one detached
+    screen:detach()
+    feed('obar<Esc>')
+    screen2:expect([[
+      foo                 |
+      ba^r                 |
+      {1:~                   }|
+                          |
+    ]])
+    session2:close()
+  end)
 end)
 
 it('autocmds UIEnter/UILeave', function()
@@ -84,6 +84,19 @@ describe('API', function()
     assert_alive()
   end)
 
+  it('accepts method_id from api-metadata instead of the name', function()
+    local method_id --- @type integer?
+    for _, f in ipairs(api.nvim_get_api_info()[2].functions) do
+      if f.name == 'nvim_eval' then
+        method_id = f.method_id
+      end
+    end
+    eq('number', type(method_id))
+    eq(3, request(method_id, '1 + 2'))
+    matches('Invalid method id: 1000000$', pcall_err(request, 1000000, '1'))
+    assert_alive()
+  end)
+
   it('failed async request emits nvim_error_event', function()
     local error_types = api.nvim_get_api_info()[2].error_types
     async_meths.nvim_command('bogus')
@@ -1976,6 +1989,21 @@ describe('API', function()
     end)
   end)
 
+  describe('nvim__get_option_values', function()
+    it('gets several options', function()
+      api.nvim_set_option_value('shiftwidth', 3, { buf = 0 })
+      local names = { 'sw', 'tabstop', 'enc', 'lisp' }
+      eq({ 3, 8, 'utf-8', false }, api.nvim__get_option_values(names, {}))
+      eq({ 8 }, api.nvim__get_option_values({ 'sw' }, { scope = 'global' }))
+      eq({}, api.nvim__get_option_values({}, {}))
+      eq("Unknown option 'foo'", pcall_err(api.nvim__get_option_values, { 'sw', 'foo' }, {}))
+      eq(
+        "cannot use 'filetype'",
+        pcall_err(api.nvim__get_option_values, { 'sw' }, { filetype = 'lua' })
+      )
+    end)
+  end)
+
   describe('nvim_{get,set}_current_buf, nvim_list_bufs', function()
     it('works', function()
       eq(1, #api.nvim_list_bufs())
@@ -3169,6 +3197,7 @@ describe('API', function()
         {
           chan = 1,
           ext_cmdline = false,
+          ext_gridbin = false,
           ext_hlstate = false,
           ext_linegrid = screen._options.ext_linegrid or false,
           ext_messages = false,
@@ -3458,6 +3487,88 @@ describe('API', function()
     end)
   end)
 
+  describe('nvim__stats', function()
+    it('counts RPC requests', function()
+      local function count(stats)
+        local method = stats.rpc_method.nvim_command
+        return method and method.count or 0
+      end
+      local before = api.nvim__stats()
+      command('echo')
+      command('echo')
+      local after = api.nvim__stats()
+      -- The first nvim__stats() is counted as well.
+      eq(3, after.rpc_request - before.rpc_request)
+      eq(2, count(after) - count(before))
+      local sum = 0
+      for _, c in ipairs(after.rpc_hist) do
+        sum = sum + c
+      end
+      eq(after.rpc_request, sum)
+      eq(8, #after.redraw_hist)
+    end)
+
+    it('counts regexp matches', function()
+      local before = api.nvim__stats().regexp_exec
+      eq(1, fn.match('abc', 'b'))
+      ok(api.nvim__stats().regexp_exec > before)
+    end)
+
+    it('counts pool objects', function()
+      command('let g:l = range(1000)')
+      local listitem = api.nvim__stats().pools.listitem
+      ok(listitem.live >= 1000)
+      command('unlet g:l')
+      eq(listitem.live - 1000, api.nvim__stats().pools.listitem.live)
+    end)
+
+    it('measures input latency', function()
+      local screen = Screen.new(40, 5)
+      local before = api.nvim__stats()
+      feed('ifoo<Esc>')
+      screen:expect([[
+        fo^o                                     |
+        {1:~                                       }|*3
+                                                |
+      ]])
+      local after = api.nvim__stats()
+      ok(after.input_latency > before.input_latency)
+      ok(after.input_latency_ns - before.input_latency_ns >= after.input_ns - before.input_ns)
+      ok(after.win_line_ns > before.win_line_ns)
+      ok(after.ui_encode_ns > before.ui_encode_ns)
+      eq(8, #after.input_latency_hist)
+    end)
+  end)
+
+  describe('nvim__trace_start, nvim__trace_get', function()
+    it('records spans', function()
+      eq({}, api.nvim__trace_get())
+      api.nvim__trace_start(100)
+      command('autocmd User Foo let g:x = 1')
+      command('doautocmd User Foo')
+      local names = {}
+      for _, ev in ipairs(api.nvim__trace_get()) do
+        eq('X', ev.ph)
+        if ev.cat ~= 'redraw' then
+          table.insert(names, ev.cat .. ' ' .. ev.name)
+        end
+      end
+      eq({ 'rpc nvim_command', 'autocmd User', 'rpc nvim_command' }, names)
+    end)
+
+    it('keeps the last spans', function()
+      api.nvim__trace_start(2)
+      for _ = 1, 5 do
+        command('echo')
+      end
+      eq(2, #api.nvim__trace_get())
+      api.nvim__trace_start(0)
+      command('echo')
+      eq({}, api.nvim__trace_get())
+      eq("Invalid 'size': out of range", pcall_err(api.nvim__trace_start, -1))
+    end)
+  end)
+
   describe('nvim_get_all_options_info', function()
     it('should have key value pairs of option names', function()
       local options_info = api.nvim_get_all_options_info()
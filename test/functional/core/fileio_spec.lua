@@ -124,6 +124,16 @@ describe('fileio', function()
     -- oldtest: Test_signal_PWR()
   end)
 
+  it('memfile block stats', function()
+    clear()
+    local stats = request('nvim__stats')
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'a', 'b', 'c' })
+    eq({ 'a', 'b', 'c' }, api.nvim_buf_get_lines(0, 0, -1, true))
+    ok(request('nvim__stats').memfile_hit > stats.memfile_hit)
+    eq(stats.memfile_miss, request('nvim__stats').memfile_miss)
+    eq(0, request('nvim__stats').memfile_release)
+  end)
+
   it('backup #9709', function()
     skip(is_ci('cirrus'))
     clear({
@@ -712,6 +712,34 @@ describe('jobs', function()
     )
   end)
 
+  it('jobstart() with stdout_raw passes output as a String', function()
+    skip(is_os('win'))
+    eq(
+      { 'one\ntwo\n', '', 'one\ntwo\n' },
+      exec_lua(function()
+        local chunks = {} --- @type string[]
+        local buffered = nil --- @type string?
+        local cmd = { 'printf', 'one\\ntwo\\n' }
+        local j1 = vim.fn.jobstart(cmd, {
+          stdout_raw = true,
+          on_stdout = function(_, data)
+            table.insert(chunks, data)
+          end,
+        })
+        local j2 = vim.fn.jobstart(cmd, {
+          stdout_raw = true,
+          stdout_buffered = true,
+          on_stdout = function(_, data)
+            buffered = data
+          end,
+        })
+        vim.fn.jobwait({ j1, j2 }, 10000)
+        -- the last chunk is the empty string at EOF
+        return { table.concat(chunks), chunks[#chunks], buffered }
+      end)
+    )
+  end)
+
   it('jobstart() environment: $NVIM, $NVIM_LISTEN_ADDRESS #11009', function()
     local function get_child_env(envname, env)
       return exec_lua(
@@ -4,10 +4,12 @@ local n = require('test.functional.testnvim')()
 local clear = n.clear
 local insert = n.insert
 local exec = n.exec
+local exec_lua = n.exec_lua
 local feed = n.feed
 local expect = n.expect
 local command = n.command
 local fn = n.fn
+local api = n.api
 local eq = t.eq
 local neq = t.neq
 
@@ -461,6 +463,43 @@ a]],
     eq(0, fn.foldlevel(12))
   end)
 
+  it('fdm=expr gives the levels of evaluating foldexpr', function()
+    fn.setline(1, { 'a', '  b', '    c', '', '  d', 'e' })
+    command('let b:step = 2 | setlocal foldmethod=expr')
+    for _, expr in ipairs({
+      [[getline(v:lnum) =~ '^\s' ? 1 : 0]],
+      [[indent(v:lnum) / b:step]],
+      [[strlen(getline(v:lnum)) > 1 && v:lnum != 3 || !v:lnum]],
+      [[(v:lnum % 2) + len('x''y' .. "z") * 2]],
+      [[(v:lnum > 2) + (getline(v:lnum) is# 'e') - -1]],
+      [[getline(v:lnum)[0] == ' ']],
+    }) do
+      api.nvim_set_option_value('foldexpr', expr, { scope = 'local' })
+      for lnum = 1, 6 do
+        command('let v:lnum = ' .. lnum)
+        eq(fn.eval(expr), fn.foldlevel(lnum), expr)
+      end
+    end
+  end)
+
+  it('fdm=expr calls the current Lua function for v:lua foldexpr', function()
+    fn.setline(1, { 'a', 'b', 'c' })
+    exec_lua(function()
+      _G.Fold = function(lnum)
+        return lnum - 1
+      end
+    end)
+    command('setlocal foldmethod=expr foldexpr=v:lua.Fold(v:lnum)')
+    eq({ 0, 1, 2 }, { fn.foldlevel(1), fn.foldlevel(2), fn.foldlevel(3) })
+    exec_lua(function()
+      _G.Fold = function(lnum)
+        return lnum == 2 and 1 or 0
+      end
+    end)
+    command('normal! zx')
+    eq({ 0, 1, 0 }, { fn.foldlevel(1), fn.foldlevel(2), fn.foldlevel(3) })
+  end)
+
   it('no folds remain if :delete makes buffer empty #19671', function()
     command('setlocal foldmethod=manual')
     fn.setline(1, { 'foo', 'bar', 'baz' })
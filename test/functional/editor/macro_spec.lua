@@ -36,6 +36,20 @@ describe('macros with default mappings', function()
     eq('lxxx', eval('@i'))
   end)
 
+  it('replays a long macro with mappings that expand in front of it', function()
+    command('imap x yz')
+    fn.setreg('q', 'i' .. ('abx'):rep(20000) .. '\27')
+    feed('@q')
+    eq(('abyz'):rep(20000), api.nvim_get_current_line())
+    -- Many keys appended one by one.
+    command('enew!')
+    for _ = 1, 2000 do
+      api.nvim_feedkeys('ix\27', 'n', false)
+    end
+    command('call feedkeys("", "x")')
+    eq(('x'):rep(2000), api.nvim_get_current_line())
+  end)
+
   it('can be replayed with Q', function()
     insert [[
 hello
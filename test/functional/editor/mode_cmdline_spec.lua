@@ -118,5 +118,21 @@ describe('cmdline', function()
       eq(1, fn.histdel(':'))
       eq('', fn.histget(':', -1))
     end)
+
+    it('moves an added item to the front only when it is still there', function()
+      api.nvim_set_option_value('history', 3, {})
+      for _, item in ipairs({ 'foo', 'bar', 'baz', 'qux', 'foo' }) do
+        eq(1, fn.histadd(':', item))
+      end
+      eq({ 'baz', 'qux', 'foo' }, { fn.histget(':', -3), fn.histget(':', -2), fn.histget(':', -1) })
+
+      eq(1, fn.histadd(':', 'baz'))
+      eq({ 'qux', 'foo', 'baz' }, { fn.histget(':', -3), fn.histget(':', -2), fn.histget(':', -1) })
+      eq(6, fn.histnr(':'))
+
+      eq(1, fn.histdel(':', '^foo$'))
+      eq(1, fn.histadd(':', 'foo'))
+      eq({ 'qux', 'baz', 'foo' }, { fn.histget(':', -3), fn.histget(':', -2), fn.histget(':', -1) })
+    end)
   end)
 end)
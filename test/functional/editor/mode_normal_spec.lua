@@ -59,4 +59,25 @@ describe('Normal mode', function()
                                     |
     ]])
   end)
+
+  it('computes virtual columns in a long line after changes', function()
+    local function check()
+      local line = api.nvim_get_current_line()
+      for _, col in ipairs({ 1, 3, 4000, 4001, 4002, 7999, #line }) do
+        -- go to the last byte of the character
+        while (line:byte(col + 1) or 0) >= 0x80 and line:byte(col + 1) < 0xc0 do
+          col = col + 1
+        end
+        eq(fn.strdisplaywidth(line:sub(1, col)), fn.virtcol({ 1, col }))
+      end
+    end
+    fn.setline(1, ('ab\tcÀ'):rep(1400))
+    check()
+    command('set tabstop=4')
+    check()
+    feed('0ix<Esc>')
+    check()
+    command('set list listchars=eol:$')
+    check()
+  end)
 end)
@@ -4,6 +4,8 @@ local n = require('test.functional.testnvim')()
 local clear = n.clear
 local command = n.command
 local eq = t.eq
+local feed = n.feed
+local fn = n.fn
 local pcall_err = t.pcall_err
 
 describe('search (/)', function()
@@ -14,3 +16,19 @@ describe('search (/)', function()
     eq([[Vim:E951: \% value too large]], pcall_err(command, '/\\v%2147483648c'))
   end)
 end)
+
+describe('%', function()
+  before_each(clear)
+
+  it('skips lines without brackets or quotes', function()
+    fn.setline(1, { 'if (a', '  b', '  ")"', '  c', '  d) {', '  e', '}' })
+    feed('gg0f(%')
+    eq({ 5, 4 }, { fn.line('.'), fn.col('.') })
+    feed('%')
+    eq({ 1, 4 }, { fn.line('.'), fn.col('.') })
+    feed('5G$%')
+    eq({ 7, 1 }, { fn.line('.'), fn.col('.') })
+    feed('%')
+    eq({ 5, 6 }, { fn.line('.'), fn.col('.') })
+  end)
+end)
@@ -0,0 +1,56 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local command = n.command
+local eq = t.eq
+local feed = n.feed
+local fn = n.fn
+local api = n.api
+
+describe('gq', function()
+  before_each(clear)
+
+  -- Fills lines up to "tw" columns, a word longer than that gets its own line.
+  local function fill(words, sep, tw)
+    local lines = {}
+    local cur = nil
+    for _, w in ipairs(words) do
+      if cur and #cur + #sep + #w <= tw then
+        cur = cur .. sep .. w
+      else
+        table.insert(lines, cur)
+        cur = w
+      end
+    end
+    table.insert(lines, cur)
+    return lines
+  end
+
+  it('splits a long line in one go', function()
+    local words = {}
+    for i = 1, 2000 do
+      table.insert(words, ('w'):rep(i % 7 + 1) .. i)
+    end
+    table.insert(words, ('x'):rep(30))
+    table.insert(words, 'end')
+    fn.setline(1, { 'before', table.concat(words, '  '), 'after' })
+    command('set textwidth=20')
+    local ns = api.nvim_create_namespace('test')
+    -- On the 1000th word.
+    local col = #table.concat(words, '  ', 1, 999) + 2
+    api.nvim_buf_set_extmark(0, ns, 1, col, {})
+    feed('2Ggqq')
+
+    local expected = fill(words, '  ', 20)
+    table.insert(expected, 1, 'before')
+    table.insert(expected, 'after')
+    eq(expected, api.nvim_buf_get_lines(0, 0, -1, true))
+    local mark = api.nvim_buf_get_extmarks(0, ns, 0, -1, {})[1]
+    local line = api.nvim_buf_get_lines(0, mark[2], mark[2] + 1, true)[1]
+    eq(words[1000], line:sub(mark[3] + 1, mark[3] + #words[1000]))
+
+    feed('u')
+    eq({ 'before', table.concat(words, '  '), 'after' }, api.nvim_buf_get_lines(0, 0, -1, true))
+  end)
+end)
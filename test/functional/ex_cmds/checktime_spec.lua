@@ -0,0 +1,42 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local command = n.command
+local eq = t.eq
+local api = n.api
+local write_file = t.write_file
+
+describe(':checktime', function()
+  local testfile = 'Xtest-checktime'
+
+  before_each(function()
+    clear()
+    write_file(testfile, 'one\n')
+    command('set autoread')
+    command('edit ' .. testfile)
+  end)
+  after_each(function()
+    os.remove(testfile)
+    os.remove(testfile .. '.new')
+  end)
+
+  it('reloads a file changed in place or replaced', function()
+    eq({ 'one' }, api.nvim_buf_get_lines(0, 0, -1, true))
+
+    write_file(testfile, 'two\n')
+    command('checktime')
+    eq({ 'two' }, api.nvim_buf_get_lines(0, 0, -1, true))
+
+    -- Replaced by another file, as many programs save files.
+    write_file(testfile .. '.new', 'three\n')
+    os.rename(testfile .. '.new', testfile)
+    command('checktime')
+    eq({ 'three' }, api.nvim_buf_get_lines(0, 0, -1, true))
+
+    -- The replacement is noticed too.
+    write_file(testfile, 'four\n')
+    command('checktime')
+    eq({ 'four' }, api.nvim_buf_get_lines(0, 0, -1, true))
+  end)
+end)
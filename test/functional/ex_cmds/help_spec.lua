@@ -43,4 +43,23 @@ describe(':help', function()
     command('help …')
     eq('*…*', api.nvim_get_current_line())
   end)
+
+  it('finds tags added to a tags file that was searched before', function()
+    mkdir('Xhelptags')
+    finally(function()
+      rmdir('Xhelptags')
+    end)
+    mkdir('Xhelptags/doc')
+    write_file('Xhelptags/doc/Xhelptags.txt', '*Xfoo*\n')
+    command('helptags Xhelptags/doc')
+    command('set rtp+=Xhelptags')
+    command('help Xfoo')
+    eq('*Xfoo*', api.nvim_get_current_line())
+    command('helpclose')
+
+    write_file('Xhelptags/doc/Xhelptags.txt', '*Xfoo*\n*Xbarbaz*\n')
+    command('helptags Xhelptags/doc')
+    command('help Xbarbaz')
+    eq('*Xbarbaz*', api.nvim_get_current_line())
+  end)
 end)
@@ -182,6 +182,37 @@ describe('quickfix', function()
     eq({ 0, 6, 1, 0, 1 }, fn.getcurpos())
   end)
 
+  it('keeps entry line numbers right over many buffer modifications', function()
+    source([[
+      new
+      setl bt=nofile
+      call setline(1, map(range(1, 200), '"Line " .. v:val'))
+      call setqflist(map(range(10, 200, 10), '{"bufnr": bufnr(), "lnum": v:val}'))
+      call setloclist(0, [{'bufnr': bufnr(), 'lnum': 100}])
+      " More changes than are recorded before they are applied to all entries.
+      for i in range(50)
+        call append(0, 'new')
+        if i % 2
+          2del _
+        endif
+      endfor
+      150,$del _
+    ]])
+    -- 50 lines added above and 25 deleted, then lines 150 to 225 were deleted.
+    eq({ 35, 45, 115, 125, 135, 145 }, {
+      fn.getqflist()[1].lnum,
+      fn.getqflist()[2].lnum,
+      fn.getqflist()[9].lnum,
+      fn.getqflist()[10].lnum,
+      fn.getqflist()[11].lnum,
+      fn.getqflist()[12].lnum,
+    })
+    eq(125, fn.getloclist(0)[1].lnum)
+    -- Entries on deleted lines keep their line number.
+    eq(155, fn.getqflist()[13].lnum)
+    t.matches('%(line deleted%)', fn.execute('cc 13'))
+  end)
+
   it('BufAdd does not cause E16 when reusing quickfix buffer #18135', function()
     local file = file_base .. '_reuse_qfbuf_BufAdd'
     write_file(file, ('\n'):rep(100) .. 'foo')
@@ -232,3 +263,21 @@ it(':vimgrep can specify Unicode pattern without delimiters', function()
     :vimgrep →^                              |
   ]])
 end)
+
+it("'errorformat' text before the first item still matches like the regexp", function()
+  local function texts(efm, lines)
+    command('set errorformat=' .. efm)
+    fn.setqflist({}, 'r', { lines = lines })
+    local r = {}
+    for _, e in ipairs(fn.getqflist()) do
+      table.insert(r, e.valid == 1 and e.text or '')
+    end
+    return r
+  end
+  -- literal text is compared ignoring case
+  eq({ 'one', '' }, texts('ERROR:\\ %m', { 'error: one', 'warning: two' }))
+  -- "%#" repeats the character before it
+  eq({ 'a', 'b' }, texts('xy%#:%m', { 'x:a', 'xyyy:b' }))
+  -- "%-G" and "%E" do not end the literal text
+  eq({ 'c' }, texts('%-Gnoise%.%#,%Eerr\\ %m', { 'noise here', 'err c' }))
+end)
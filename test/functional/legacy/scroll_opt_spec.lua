@@ -1378,4 +1378,62 @@ describe('smoothscroll', function()
       :norm j721|                             |
     ]])
   end)
+
+  it('<C-E> and <C-Y> keep rows below a partly displayed topline', function()
+    exec([[
+      call setline(1, ['one ' .. 'word '->repeat(20), 'two', 'three', 'four', 'five'])
+      set smoothscroll number scrolloff=0
+      :5
+    ]])
+    local s0 = [[
+      {8:  1 }one word word word word word word wo|
+      {8:    }rd word word word word word word wor|
+      {8:    }d word word word word word word     |
+      {8:  2 }two                                 |
+      {8:  3 }three                               |
+      {8:  4 }four                                |
+      {8:  5 }^five                                |
+      {1:~                                       }|*4
+                                              |
+    ]]
+    local s1 = [[
+      {1:<<<}{8: }rd word word word word word word wor|
+      {8:    }d word word word word word word     |
+      {8:  2 }two                                 |
+      {8:  3 }three                               |
+      {8:  4 }four                                |
+      {8:  5 }^five                                |
+      {1:~                                       }|*5
+                                              |
+    ]]
+    local s2 = [[
+      {1:<<<}{8: }d word word word word word word     |
+      {8:  2 }two                                 |
+      {8:  3 }three                               |
+      {8:  4 }four                                |
+      {8:  5 }^five                                |
+      {1:~                                       }|*6
+                                              |
+    ]]
+    screen:expect(s0)
+    feed('<C-E>')
+    screen:expect(s1)
+    feed('<C-E>')
+    screen:expect(s2)
+    feed('<C-E>')
+    screen:expect([[
+      {8:  2 }two                                 |
+      {8:  3 }three                               |
+      {8:  4 }four                                |
+      {8:  5 }^five                                |
+      {1:~                                       }|*7
+                                              |
+    ]])
+    feed('<C-Y>')
+    screen:expect(s2)
+    feed('<C-Y>')
+    screen:expect(s1)
+    feed('<C-Y>')
+    screen:expect(s0)
+  end)
 end)
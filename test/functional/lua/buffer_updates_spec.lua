@@ -449,6 +449,37 @@ describe('lua buffer event callbacks: on_lines', function()
     eq({ 'bytes', 2, 5, 0, 0, 0, 4, 0, 40, 0, 10, 10 }, api.nvim_get_var('qf_on_bytes'))
     eq({ 'lines', 2, 6, 0, 5, 1, 42 }, api.nvim_get_var('qf_on_lines'))
   end)
+
+  it('with batch delivers merged changes later', function()
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'hello', 'world' })
+    exec_lua(function()
+      _G.batch_events = {}
+      vim.api.nvim_buf_attach(0, false, {
+        batch = true,
+        on_lines = function(_, buf, tick, first, last_old, last_new)
+          table.insert(_G.batch_events, { 'lines', buf, tick, first, last_old, last_new })
+        end,
+        on_bytes = function(...)
+          table.insert(_G.batch_events, { ... })
+        end,
+      })
+    end)
+    eq(
+      0,
+      exec_lua(function()
+        vim.api.nvim_buf_set_text(0, 0, 5, 0, 5, { ' there' })
+        vim.api.nvim_buf_set_text(0, 0, 11, 0, 11, { '!' })
+        vim.api.nvim_buf_set_text(0, 1, 0, 1, 5, { 'earth' })
+        return #_G.batch_events
+      end)
+    )
+    local tick = api.nvim_buf_get_changedtick(0)
+    eq({
+      { 'bytes', 1, tick, 0, 5, 5, 0, 0, 0, 0, 7, 7 },
+      { 'bytes', 1, tick, 1, 0, 13, 0, 5, 5, 0, 5, 5 },
+      { 'lines', 1, tick, 0, 2, 2 },
+    }, exec_lua('return _G.batch_events'))
+  end)
 end)
 
 describe('lua: nvim_buf_attach on_bytes', function()
@@ -679,6 +710,17 @@ describe('lua: nvim_buf_attach on_bytes', function()
       }
     end)
 
+    it('blockwise case change', function()
+      local check_events = setup_eventcheck(verify, { 'abcd', 'efgh', 'ijkl' })
+      feed('gg0l<C-v>2jl~')
+      check_events {
+        { 'test1', 'bytes', 1, 3, 0, 1, 1, 0, 2, 2, 0, 2, 2 },
+        { 'test1', 'bytes', 1, 3, 1, 1, 6, 0, 2, 2, 0, 2, 2 },
+        { 'test1', 'bytes', 1, 3, 2, 1, 11, 0, 2, 2, 0, 2, 2 },
+      }
+      eq({ 'aBCd', 'eFGh', 'iJKl' }, api.nvim_buf_get_lines(0, 0, -1, true))
+    end)
+
     it('blockwise paste', function()
       local check_events = setup_eventcheck(verify, { '1', '2', '3' })
       feed('1G0')
@@ -903,40 +945,64 @@ describe('lua: nvim_buf_attach on_bytes', function()
         new line 3]]
       )
 
+      -- only the changed lines are reported
+      local tick = api.nvim_buf_get_changedtick(0)
       command 'checktime'
       check_events {
-        { 'test1', 'reload', 1 },
+        { 'test1', 'bytes', 1, tick, 0, 0, 0, 2, 0, 22, 3, 0, 33 },
       }
 
+      tick = api.nvim_buf_get_changedtick(0)
       feed 'ggJ'
       check_events {
-        { 'test1', 'bytes', 1, 5, 0, 10, 10, 1, 0, 1, 0, 1, 1 },
+        { 'test1', 'bytes', 1, tick, 0, 10, 10, 1, 0, 1, 0, 1, 1 },
       }
 
       eq({ 'new line 1 new line 2', 'new line 3' }, api.nvim_buf_get_lines(0, 0, -1, true))
 
       -- check we can undo and redo a reload event.
+      tick = api.nvim_buf_get_changedtick(0)
       feed 'u'
       check_events {
-        { 'test1', 'bytes', 1, 8, 0, 10, 10, 0, 1, 1, 1, 0, 1 },
+        { 'test1', 'bytes', 1, tick + 1, 0, 10, 10, 0, 1, 1, 1, 0, 1 },
       }
 
+      tick = api.nvim_buf_get_changedtick(0)
       feed 'u'
       check_events {
-        { 'test1', 'reload', 1 },
+        { 'test1', 'bytes', 1, tick + 1, 0, 0, 0, 3, 0, 33, 2, 0, 22 },
       }
+      eq({ 'old line 1', 'old line 2' }, api.nvim_buf_get_lines(0, 0, -1, true))
 
+      tick = api.nvim_buf_get_changedtick(0)
       feed '<c-r>'
       check_events {
-        { 'test1', 'reload', 1 },
+        { 'test1', 'bytes', 1, tick + 1, 0, 0, 0, 2, 0, 22, 3, 0, 33 },
       }
 
+      tick = api.nvim_buf_get_changedtick(0)
       feed '<c-r>'
       check_events {
-        { 'test1', 'bytes', 1, 14, 0, 10, 10, 1, 0, 1, 0, 1, 1 },
+        { 'test1', 'bytes', 1, tick + 1, 0, 10, 10, 1, 0, 1, 0, 1, 1 },
       }
     end)
 
+    it('checktime autoread keeps extmarks in unchanged lines', function()
+      write_file('Xtest-reload', 'line 1\nline 2\nline 3\n')
+      local atime = os.time() - 10
+      vim.uv.fs_utime('Xtest-reload', atime, atime)
+      command 'e Xtest-reload'
+      command 'set autoread'
+      local ns = api.nvim_create_namespace('reload')
+      local id = api.nvim_buf_set_extmark(0, ns, 2, 3, {})
+
+      write_file('Xtest-reload', 'line 1\nchanged\nadded\nline 3\n')
+      command 'checktime'
+
+      eq({ 'line 1', 'changed', 'added', 'line 3' }, api.nvim_buf_get_lines(0, 0, -1, true))
+      eq({ 3, 3 }, api.nvim_buf_get_extmark_by_id(0, ns, id, {}))
+    end)
+
     it('tab with noexpandtab and softtabstop', function()
       command('set noet')
       command('set ts=4')
@@ -136,6 +136,20 @@ describe('vim.json.decode()', function()
     eq('ફ', exec_lua([=[return vim.json.decode([["ફ"]])]=]))
   end)
 
+  it('parses long strings and integers', function()
+    eq(
+      { ('x'):rep(40) .. '"' .. ('y'):rep(40), ('z'):rep(100) },
+      exec_lua(function()
+        local x, y = ('x'):rep(40), ('y'):rep(40)
+        return vim.json.decode('["' .. x .. '\\"' .. y .. '", "' .. ('z'):rep(100) .. '"]')
+      end)
+    )
+    eq(
+      { 100000000000000000, -100000000000000000, 1000000000000000000, 1 },
+      exec_lua([[return vim.json.decode('[100000000000000000, -100000000000000000, 1000000000000000000, 1]')]])
+    )
+  end)
+
   it('parses surrogate pairs properly', function()
     eq('\240\144\128\128', exec_lua([[return vim.json.decode('"\\uD800\\uDC00"')]]))
   end)
@@ -73,6 +73,34 @@ describe('vim.loader', function()
     )
   end)
 
+  it('keeps the bytecode of all modules in one cache file', function()
+    local tmp = t.tmpname(false)
+    assert(t.mkdir(tmp))
+    assert(t.mkdir(tmp .. '/lua'))
+    t.write_file(tmp .. '/lua/loader_test_mod.lua', 'return 42', true)
+
+    eq(
+      { 42, true, 42, true },
+      exec_lua(function(dir)
+        vim.opt.rtp:prepend(dir)
+        vim.loader.enable()
+        local ret = { require('loader_test_mod') }
+        local cache = vim.loader.path .. '/cache.luac'
+        ret[#ret + 1] = vim._luac_write(cache)
+
+        -- read the cache back from the file
+        local modpath = vim.fs.normalize(dir .. '/lua/loader_test_mod.lua')
+        local stat = assert(vim.uv.fs_stat(modpath))
+        vim._luac_read(cache)
+        local chunk = vim._luac_load(modpath, stat.size, stat.mtime.sec, stat.mtime.nsec)
+        ret[#ret + 1] = chunk()
+        local stale = vim._luac_load(modpath, stat.size + 1, stat.mtime.sec, stat.mtime.nsec)
+        ret[#ret + 1] = stale == nil
+        return ret
+      end, tmp)
+    )
+  end)
+
   it('handles % signs in modpath #24491', function()
     exec_lua [[
       vim.loader.enable()
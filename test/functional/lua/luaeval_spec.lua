@@ -162,6 +162,19 @@ describe('luaeval()', function()
     eq(nested_by_level[level].o, fn.luaeval('_A', nested_by_level[level].o))
   end)
 
+  it('correctly converts lists and dicts of scalars', function()
+    eq({ 'a', 1, 1.5, true, false }, fn.luaeval('{"a", 1, 1.5, true, false}'))
+    eq({ 'a', { 1 }, 'b' }, fn.luaeval('{"a", {1}, "b"}'))
+    eq(eval('v:t_blob'), eval([[type(luaeval('{"a", "\0"}')[1])]]))
+    eq({ 1, 2, { 3, 'x' }, 4 }, fn.luaeval('_A', { 1, 2, { 3, 'x' }, 4 }))
+    eq(true, eval([[luaeval('_A[3] == 1.5 and _A[4] == true', ['a', 1, 1.5, v:true])]]))
+    eq(1000, fn.luaeval('#_A', fn.range(1000)))
+    eq(
+      { a = 'x', b = 2, c = 1.5, d = false },
+      fn.luaeval('_A', { a = 'x', b = 2, c = 1.5, d = false })
+    )
+  end)
+
   local function sp(typ, val)
     return ('{"_TYPE": v:msgpack_types.%s, "_VAL": %s}'):format(typ, val)
   end
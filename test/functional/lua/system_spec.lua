@@ -138,6 +138,30 @@ describe('vim.system', function()
     end)
   end)
 
+  it('system_all() runs commands at most {limit} at a time', function()
+    eq(
+      { 2, 4, { 0, 0, 0, 127 }, '1\n', '3\n' },
+      exec_lua(function()
+        local count = 0
+        local cmds = { { 'echo', '1' }, { 'echo', '2' }, { 'echo', '3' }, { 'no-such-command' } }
+        local obj = vim.system_all(cmds, { text = true, limit = 2 }, function()
+          count = count + 1
+        end)
+        local running = obj._state.running
+        local res = obj:wait()
+        return {
+          running,
+          count,
+          vim.tbl_map(function(r)
+            return r.code
+          end, res),
+          res[1].stdout,
+          res[3].stdout,
+        }
+      end)
+    )
+  end)
+
   it('SystemObj:wait() does not process non-fast events #27292', function()
     eq(
       false,
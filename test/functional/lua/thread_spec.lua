@@ -292,6 +292,44 @@ describe('threadpool', function()
     ]])
   end)
 
+  it('vim.parallel_map()', function()
+    eq(
+      { { 2, 4, 6, 8, 10, 12, 14 }, { 'A', 'BB', 'C' }, { true, true } },
+      exec_lua(function()
+        return {
+          vim.parallel_map(function(x)
+            return x * 2
+          end, { 1, 2, 3, 4, 5, 6, 7 }, { threads = 3 }),
+          vim.parallel_map(function(s)
+            return s:upper()
+          end, { 'a', 'bb', 'c' }),
+          vim.parallel_map(function()
+            return vim.is_thread()
+          end, { 1, 2 }, { threads = 2 }),
+        }
+      end)
+    )
+
+    t.matches(
+      'worker failed',
+      pcall_err(exec_lua, function()
+        vim.parallel_map(function()
+          error('worker failed')
+        end, { 1, 2 }, { threads = 2 })
+      end)
+    )
+
+    t.matches(
+      'fn must not have upvalues',
+      pcall_err(exec_lua, function()
+        local up = 1
+        vim.parallel_map(function(x)
+          return x + up
+        end, { 1 })
+      end)
+    )
+  end)
+
   describe('vim.*', function()
     before_each(function()
       clear()
@@ -1757,6 +1757,54 @@ describe('lua stdlib', function()
     assert_alive()
   end)
 
+  it('vim.buf_lines', function()
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'foo bar', '', 'bar baz bar', 'abbc' })
+    eq(
+      { { 0, 'foo bar', 7 }, { 1, '', 0 }, { 2, 'bar baz bar', 11 }, { 3, 'abbc', 4 } },
+      exec_lua(function()
+        local ret = {}
+        for row, line in vim.buf_lines(0) do
+          ret[#ret + 1] = { row, line:text(), #line }
+        end
+        return ret
+      end)
+    )
+    eq(
+      { { 1, '' }, { 2, 'bar baz bar' } },
+      exec_lua(function()
+        local ret = {}
+        for row, line in vim.buf_lines(0, 1, -2) do
+          ret[#ret + 1] = { row, tostring(line) }
+        end
+        return ret
+      end)
+    )
+    eq(
+      { { 5, 7 }, {}, { 1, 3 }, { 9, 11 }, { 0, 4 } },
+      exec_lua(function()
+        local lines = {}
+        for _, line in vim.buf_lines(0) do
+          lines[#lines + 1] = line
+        end
+        return {
+          { lines[1]:find('bar') },
+          { lines[2]:find('bar') },
+          { lines[3]:find('bar') },
+          { lines[3]:find('bar', 2) },
+          { lines[4]:match(vim.regex('ab\\+c')) },
+        }
+      end)
+    )
+    matches(
+      'line view is outdated: buffer was changed',
+      pcall_err(exec_lua, function()
+        local _, line = vim.buf_lines(0)()
+        vim.api.nvim_buf_set_lines(0, 0, 1, true, { 'changed' })
+        return line:text()
+      end)
+    )
+  end)
+
   it('vim.defer_fn', function()
     eq(
       false,
@@ -1,3 +1,12 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+
+local api = n.api
+local command = n.command
+local eq = t.eq
+local exec_lua = n.exec_lua
+local feed = n.feed
+
 describe('vim.pack', function()
   describe('add()', function()
     pending('works', function()
@@ -30,6 +39,79 @@ describe('vim.pack', function()
       -- and error on conflicts.
     end)
 
+    describe('with `load` table', function()
+      before_each(function()
+        n.clear({ env = { XDG_DATA_HOME = t.tmpname(false) } })
+        -- Plugins already on disk are not installed
+        exec_lua(function()
+          local plug_dir = vim.fs.joinpath(vim.fn.stdpath('data'), 'site', 'pack', 'core', 'opt')
+          local function add_file(path, lines)
+            path = vim.fs.joinpath(plug_dir, path)
+            vim.fn.mkdir(vim.fs.dirname(path), 'p')
+            vim.fn.writefile(lines, path)
+          end
+          for _, name in ipairs({ 'plug_event', 'plug_ft', 'plug_cmd', 'plug_module' }) do
+            add_file(name .. '/plugin/' .. name .. '.lua', {
+              ('vim.g.loaded = (vim.g.loaded or "") .. "%s "'):format(name),
+            })
+          end
+          add_file('plug_ft/ftplugin/text.lua', { 'vim.b.plug_ft = true' })
+          add_file('plug_cmd/plugin/plug_cmd_def.lua', {
+            'vim.api.nvim_create_user_command("PlugCmd", function(args)',
+            '  vim.g.plug_cmd_args = { args.line1, args.line2, args.bang, args.fargs }',
+            'end, { bang = true, nargs = "*", range = true })',
+          })
+          add_file('plug_module/lua/plug_module/sub.lua', { 'return "sub"' })
+        end)
+      end)
+
+      local function loaded()
+        return exec_lua('return vim.g.loaded')
+      end
+
+      local function add(name, load)
+        exec_lua(function()
+          vim.pack.add({ 'https://example.com/' .. name }, { load = load })
+        end)
+      end
+
+      it('adds plugin on `event`', function()
+        add('plug_event', { event = 'InsertEnter' })
+        eq(nil, loaded())
+        feed('i<Esc>')
+        eq('plug_event ', loaded())
+        -- Only once
+        feed('i<Esc>')
+        eq('plug_event ', loaded())
+      end)
+
+      it('adds plugin on `ft`', function()
+        command('filetype plugin on')
+        add('plug_ft', { ft = 'text' })
+        command('set filetype=help')
+        eq(nil, loaded())
+        command('set filetype=text')
+        eq('plug_ft ', loaded())
+        eq(true, api.nvim_buf_get_var(0, 'plug_ft'))
+      end)
+
+      it('adds plugin on `cmd` and runs the command', function()
+        add('plug_cmd', { cmd = 'PlugCmd' })
+        eq(nil, loaded())
+        api.nvim_buf_set_lines(0, 0, -1, true, { 'a', 'b', 'c' })
+        command('2,3PlugCmd! x y')
+        eq('plug_cmd ', loaded())
+        eq({ 2, 3, true, { 'x', 'y' } }, api.nvim_get_var('plug_cmd_args'))
+      end)
+
+      it('adds plugin on `module`', function()
+        add('plug_module', { module = 'plug_module' })
+        eq(nil, loaded())
+        eq('sub', exec_lua([[return require('plug_module.sub')]]))
+        eq('plug_module ', loaded())
+      end)
+    end)
+
     pending('installs', function()
       -- TODO
 
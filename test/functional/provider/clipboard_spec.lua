@@ -235,6 +235,33 @@ describe('clipboard', function()
     eq({ { 'star', '' }, 'b' }, eval('g:dummy_clipboard_star'))
   end)
 
+  it('g:clipboard with async serves the cached clipboard until FocusGained', function()
+    source([[
+      let g:pastes = 0
+      function! Paste() abort
+        let g:pastes += 1
+        return [['paste' .. g:pastes], 'v']
+      endfunction
+      let g:clipboard = {
+            \  'name': 'custom',
+            \  'copy': { '+': {lines, regtype -> 0}, '*': {lines, regtype -> 0} },
+            \  'paste': { '+': function('Paste'), '*': function('Paste') },
+            \  'async': 1,
+            \}]])
+    eq('custom', eval('provider#clipboard#Executable()'))
+
+    eq('paste1', eval("getreg('+')"))
+    eq('paste1', eval("getreg('+')"))
+    eq(1, eval('g:pastes'))
+
+    command('doautocmd FocusGained')
+    eq('paste2', eval("getreg('+')"))
+
+    command('call setreg("+", "yanked")')
+    eq('yanked', eval("getreg('+')"))
+    eq(2, eval('g:pastes'))
+  end)
+
   describe('g:clipboard[paste] Vimscript function', function()
     it('can return empty list for empty clipboard', function()
       source([[let g:dummy_clipboard = []
@@ -502,6 +502,35 @@ describe("'scrollback' option", function()
     eq(scrollback + term_height, eval('line("$")'))
   end)
 
+  it('keeps the newest lines in order after they wrap around', function()
+    -- Scrollback is 10 on setup_screen
+    local screen = tt.setup_screen(nil, nil, 30)
+    local lines = {}
+    for i = 1, 55 do
+      table.insert(lines, 'line' .. tostring(i))
+    end
+    table.insert(lines, '')
+    feed_data(lines)
+    screen:expect([[
+        line51                        |
+        line52                        |
+        line53                        |
+        line54                        |
+        line55                        |
+        ^                              |
+        {5:-- TERMINAL --}                |
+      ]])
+    local expected = {}
+    for i = 41, 55 do
+      table.insert(expected, 'line' .. tostring(i))
+    end
+    eq(expected, exec_lua([[
+      return vim.tbl_map(function(l)
+        return vim.trim(l)
+      end, vim.api.nvim_buf_get_lines(0, 0, 15, true))
+    ]]))
+  end)
+
   it('defaults to 10000 in :terminal buffers', function()
     set_fake_shell()
     command('terminal')
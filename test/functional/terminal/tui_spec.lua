@@ -389,6 +389,42 @@ describe('TUI', function()
     end)
   end
 
+  it('draws the last frame when the terminal does not keep up', function()
+    -- Block the host Nvim so that it does not read the pty, while the child
+    -- draws more frames than the pty buffer holds.
+    n.get_session():notify(
+      'nvim_exec_lua',
+      'local start = vim.uv.hrtime() while vim.uv.hrtime() - start < 5e8 do end',
+      {}
+    )
+    child_session:notify(
+      'nvim_exec_lua',
+      [[
+        for i = 1, 2000 do
+          local line = ('%04d'):format(i):rep(12)
+          vim.api.nvim_buf_set_lines(0, 0, -1, true, { line, line, line, line })
+          vim.cmd.redraw()
+        end
+      ]],
+      {}
+    )
+    screen:expect([[
+      ^200020002000200020002000200020002000200020002000  |
+      200020002000200020002000200020002000200020002000  |*3
+      {3:[No Name] [+]                                     }|
+                                                        |
+      {5:-- TERMINAL --}                                    |
+    ]])
+    feed_data('G$')
+    screen:expect([[
+      200020002000200020002000200020002000200020002000  |*3
+      20002000200020002000200020002000200020002000200^0  |
+      {3:[No Name] [+]                                     }|
+                                                        |
+      {5:-- TERMINAL --}                                    |
+    ]])
+  end)
+
   it('rapid resize #7572 #7628', function()
     -- Need buffer rows to provoke the behavior.
     feed_data(':edit test/functional/fixtures/bigfile.txt\n')
@@ -1990,6 +2026,7 @@ describe('TUI', function()
       {
         chan = ui_chan,
         ext_cmdline = false,
+        ext_gridbin = false,
         ext_hlstate = false,
         ext_linegrid = true,
         ext_messages = false,
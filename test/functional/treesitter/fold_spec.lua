@@ -8,6 +8,7 @@ local insert = n.insert
 local write_file = t.write_file
 local exec_lua = n.exec_lua
 local command = n.command
+local fn = n.fn
 local feed = n.feed
 local poke_eventloop = n.poke_eventloop
 
@@ -384,6 +385,22 @@ end]])
     }, get_fold_levels())
   end)
 
+  it('updates folds of a large buffer in chunks', function()
+    parse('c')
+    command([[set foldmethod=expr foldexpr=v:lua.vim.treesitter.foldexpr()]])
+    exec_lua(function()
+      local lines = {}
+      for i = 1, 1500 do
+        vim.list_extend(lines, { ('void f%d(void)'):format(i), '{', '  int x;', '}' })
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    end)
+
+    t.retry(nil, nil, function()
+      eq({ 1, 1, 1 }, { fn.foldlevel(1), fn.foldlevel(3000), fn.foldlevel(6000) })
+    end)
+  end)
+
   it('takes account of relevant options', function()
     insert([[
 # h1
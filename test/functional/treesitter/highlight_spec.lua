@@ -969,6 +969,30 @@ describe('treesitter highlighting (C)', function()
       ]],
     })
   end)
+
+  it('does not run the query again when redrawing unchanged lines', function()
+    insert(hl_text_c)
+    local res = exec_lua(function()
+      _G.pred_calls = 0
+      vim.treesitter.query.add_predicate('count?', function()
+        _G.pred_calls = _G.pred_calls + 1
+        return true
+      end, { force = true })
+      vim.treesitter.query.set('c', 'highlights', '((identifier) @variable (#count? @variable))')
+      vim.treesitter.highlighter.new(vim.treesitter.get_parser(0, 'c'))
+      vim.cmd('redraw!')
+      local calls = _G.pred_calls
+      vim.cmd('redraw!')
+      return { calls > 0, _G.pred_calls - calls }
+    end)
+    eq({ true, 0 }, res)
+
+    -- an edit makes a new tree
+    local calls = exec_lua('return _G.pred_calls')
+    feed('ggOint x;<Esc>')
+    command('redraw!')
+    eq(true, exec_lua('return _G.pred_calls') > calls)
+  end)
 end)
 
 describe('treesitter highlighting (lua)', function()
@@ -244,6 +244,55 @@ describe('treesitter parser API', function()
     eq({ 2, 0, 2, 10 }, exec_lua([[return {parser:parse()[1]:root():named_child(2):range()}]]))
   end)
 
+  it('parses on a worker thread', function()
+    insert([[
+      int main() {
+        int x = 3;
+      }]])
+
+    local res = exec_lua(function()
+      local ts_parser = vim.treesitter.get_parser(0, 'c')._parser
+      local started = ts_parser:_parse_async(nil, 0, true, nil, function(tree, ranges)
+        _G.result = { tree:root():sexpr(), ranges }
+      end)
+      vim.wait(1000, function()
+        return _G.result ~= nil
+      end)
+      local text = table.concat(vim.api.nvim_buf_get_lines(0, 0, -1, false), '\n')
+      local expected = vim.treesitter.get_string_parser(text, 'c'):parse()[1]:root():sexpr()
+      return { started, _G.result[1] == expected, #_G.result[2] }
+    end)
+    eq({ true, true, 1 }, res)
+  end)
+
+  it('parses many injected regions asynchronously', function()
+    local res = exec_lua(function()
+      local lines = {}
+      for i = 1, 200 do
+        vim.list_extend(lines, { '```lua', 'local x' .. i .. ' = ' .. i, '```', '' })
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+
+      local parser = vim.treesitter.get_parser(0, 'markdown')
+      local done = false
+      parser:parse(true, function()
+        done = true
+      end)
+      vim.wait(10000, function()
+        return done
+      end)
+
+      local parsed = 0
+      for _, tree in pairs(parser:children().lua:trees()) do
+        if tree:root():named_child(0):type() == 'variable_declaration' then
+          parsed = parsed + 1
+        end
+      end
+      return { done, parsed, parser:is_valid() }
+    end)
+    eq({ true, 200, true }, res)
+  end)
+
   it('handles multiple async parse calls', function()
     insert([[printf("%s", "some text");]])
     feed('yy49999p')
@@ -257,6 +306,10 @@ describe('treesitter parser API', function()
       end
       _G.schedules = 0
       _G.parser = vim.treesitter.get_parser(0, 'c')
+      -- Count the time slices, not a parse on a worker thread
+      _G.parser._parse_on_worker = function()
+        return false
+      end
       for i = 1, 5 do
         _G['done' .. i] = false
         _G.parser:parse(nil, function()
@@ -159,6 +159,36 @@ void ui_refresh(void)
     }, res)
   end)
 
+  it('supports getting capture ranges (capture_ranges)', function()
+    insert(test_text)
+
+    local res = exec_lua(function()
+      local cquery = vim.treesitter.query.parse('c', test_query)
+      local parser = vim.treesitter.get_parser(0, 'c')
+      local tree = parser:parse()[1]
+      local ranges = cquery:capture_ranges(tree:root(), 0, 7, 14)
+      local res = {}
+      for i = 1, #ranges, 5 do
+        local cid, row1, col1, row2, col2 = unpack(ranges, i, i + 4)
+        table.insert(res, { '@' .. cquery.captures[cid], row1, col1, row2, col2 })
+      end
+      return res
+    end)
+
+    eq({
+      { '@type', 8, 2, 8, 6 }, -- bool
+      { '@keyword', 9, 2, 9, 5 }, -- for
+      { '@type', 9, 7, 9, 13 }, -- size_t
+      { '@minfunc', 11, 12, 11, 15 }, -- "MIN"(ui->width, width);
+      { '@fieldarg', 11, 16, 11, 18 }, --      ui
+      { '@min_id', 11, 27, 11, 32 }, -- width
+      { '@minfunc', 12, 13, 12, 16 }, -- "MIN"(ui->height, height);
+      { '@fieldarg', 12, 17, 12, 19 }, --      ui
+      { '@min_id', 12, 29, 12, 35 }, -- height
+      { '@fieldarg', 13, 14, 13, 16 }, -- ui   ; in BAR(..)
+    }, res)
+  end)
+
   it('supports query and iter by match (iter_matches)', function()
     insert(test_text)
 
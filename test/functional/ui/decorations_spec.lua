@@ -172,6 +172,59 @@ describe('decorations providers', function()
     }
   end)
 
+  it('can cache ephemeral highlights of lines', function()
+    insert(mulholland)
+    exec_lua(function()
+      local hl = vim.api.nvim_get_hl_id_by_name('ErrorMsg')
+      local ns = vim.api.nvim_create_namespace('mulholland')
+      _G.line_count = 0
+      vim.api.nvim_set_decoration_provider(ns, {
+        on_line = function(_, _, buf, line)
+          _G.line_count = _G.line_count + 1
+          vim.api.nvim_buf_set_extmark(buf, ns, line, line, {
+            end_line = line,
+            end_col = line + 1,
+            hl_group = hl,
+            ephemeral = true,
+          })
+        end,
+        cache_lines = true,
+      })
+    end)
+
+    local grid = [[
+      {2:/}/ just to see if there was an accident |
+      /{2:/} on Mulholland Drive                  |
+      tr{2:y}_start();                            |
+      buf{2:r}ef_T save_buf;                      |
+      swit{2:c}h_buffer(&save_buf, buf);          |
+      posp {2:=} getmark(mark, false);            |
+      restor{2:e}_buffer(&save_buf);^              |
+                                              |
+    ]]
+    screen:expect(grid)
+    eq(7, exec_lua('return _G.line_count'))
+
+    command('redraw!')
+    screen:expect(grid)
+    eq(7, exec_lua('return _G.line_count'))
+
+    -- a change of the buffer invalidates the cache
+    feed('gg0x')
+    command('redraw!')
+    screen:expect([[
+      {2:^/} just to see if there was an accident  |
+      /{2:/} on Mulholland Drive                  |
+      tr{2:y}_start();                            |
+      buf{2:r}ef_T save_buf;                      |
+      swit{2:c}h_buffer(&save_buf, buf);          |
+      posp {2:=} getmark(mark, false);            |
+      restor{2:e}_buffer(&save_buf);              |
+                                              |
+    ]])
+    eq(true, exec_lua('return _G.line_count') >= 14)
+  end)
+
   it('can indicate spellchecked points', function()
     exec [[
     set spell
@@ -1031,6 +1084,36 @@ describe('extmark decorations', function()
     screen:expect_unchanged()
   end)
 
+  it('draws highlights added to lines while they were scrolled out of view', function()
+    screen:try_resize(50, 5)
+    insert(example_text)
+    feed('gg')
+    screen:expect([[
+      ^for _,item in ipairs(items) do                    |
+          local text, hl_id_cell, count = unpack(item)  |
+          if hl_id_cell ~= nil then                     |
+              hl_id = hl_id_cell                        |
+                                                        |
+    ]])
+    feed('4<C-E>')
+    screen:expect([[
+      ^    end                                           |
+          for _ = 1, (count or 1) do                    |
+              local cell = line[colpos]                 |
+              cell.text = text                          |
+                                                        |
+    ]])
+    api.nvim_buf_set_extmark(0, ns, 1, 4, { end_col = 9, hl_group = 'ErrorMsg' })
+    feed('gg')
+    screen:expect([[
+      ^for _,item in ipairs(items) do                    |
+          {4:local} text, hl_id_cell, count = unpack(item)  |
+          if hl_id_cell ~= nil then                     |
+              hl_id = hl_id_cell                        |
+                                                        |
+    ]])
+  end)
+
   it('can have virtual text of overlay position', function()
     insert(example_text)
     feed 'gg'
@@ -5523,6 +5606,26 @@ describe('decorations: inline virtual text', function()
                                                         |
     ]])
   end)
+
+  it('cursor column follows added, removed and scoped inline virt text', function()
+    api.nvim_buf_set_lines(0, 0, -1, false, { 'foobar' })
+    feed('$')
+    eq(6, fn.virtcol('.'))
+    local id = api.nvim_buf_set_extmark(0, ns, 0, 3, { virt_text_pos = 'inline', virt_text = { { 'XX' } } })
+    eq(8, fn.virtcol('.'))
+    api.nvim_buf_set_extmark(0, ns, 0, 3, { virt_text_pos = 'inline', virt_text = { { 'YYY' } } })
+    eq(11, fn.virtcol('.'))
+    api.nvim_buf_del_extmark(0, ns, id)
+    eq(9, fn.virtcol('.'))
+    local win = api.nvim_get_current_win()
+    command('split')
+    api.nvim__ns_set(ns, { wins = { api.nvim_get_current_win() } })
+    eq(9, fn.virtcol('.'))
+    api.nvim_set_current_win(win)
+    eq(6, fn.virtcol('.'))
+    api.nvim__ns_set(ns, { wins = {} })
+    eq(9, fn.virtcol('.'))
+  end)
 end)
 
 describe('decorations: virtual lines', function()
@@ -1483,6 +1483,31 @@ describe('inccommand=nosplit', function()
       :%s/^                |
     ]])
   end)
+
+  it('only previews from the first visible line', function()
+    local lines = {}
+    for i = 1, 40 do
+      lines[i] = 'x ' .. i
+    end
+    api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    command('normal! 25Gzt')
+
+    feed(':%s/x/y')
+    screen:expect({ any = 'y 25' })
+    eq({ 'x 1', 'x 24', 'y 25' }, {
+      api.nvim_buf_get_lines(0, 0, 1, true)[1],
+      api.nvim_buf_get_lines(0, 23, 24, true)[1],
+      api.nvim_buf_get_lines(0, 24, 25, true)[1],
+    })
+    feed('<CR>')
+    eq('y 1', api.nvim_buf_get_lines(0, 0, 1, true)[1])
+
+    -- Matches above the view are previewed when none are visible.
+    command('normal! 25Gzt')
+    feed(':%s/y 3$/z')
+    screen:expect({ any = 'z' })
+    eq('z', api.nvim_buf_get_lines(0, 2, 3, true)[1])
+  end)
 end)
 
 describe(":substitute, 'inccommand' with a failing expression", function()
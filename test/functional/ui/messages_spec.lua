@@ -1574,6 +1574,20 @@ describe('ui/builtin messages', function()
     }
   end)
 
+  it('long message without more-prompt shows its last lines', function()
+    command('set nomore')
+    feed([[:echo join(map(range(1, 100), '"line " .. v:val'), "\n")<cr>]])
+    screen:expect([[
+      line 95                                                     |
+      line 96                                                     |
+      line 97                                                     |
+      line 98                                                     |
+      line 99                                                     |
+      line 100                                                    |
+      {6:Press ENTER or type command to continue}^                     |
+    ]])
+  end)
+
   it(':hi Group output', function()
     screen:try_resize(70, 7)
     feed(':hi ErrorMsg<cr>')
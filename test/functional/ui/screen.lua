@@ -163,6 +163,7 @@ local function _init_colors()
 end
 
 --- @class test.functional.ui.screen.Opts
+--- @field ext_gridbin? boolean
 --- @field ext_linegrid? boolean
 --- @field ext_multigrid? boolean
 --- @field ext_newgrid? boolean
@@ -1235,8 +1236,38 @@ end
 --- @param row integer
 --- @param col integer
 --- @param items integer[][]
+--- Decodes the cells of a "grid_line" event with ext_gridbin, see |ui-gridbin|.
+--- @param data string
+local function decode_gridbin(data)
+  local items = {}
+  local pos = 1
+  local function uvarint()
+    local val, mul = 0, 1
+    while true do
+      local byte = data:byte(pos)
+      pos = pos + 1
+      val = val + (byte % 0x80) * mul
+      if byte < 0x80 then
+        return val
+      end
+      mul = mul * 0x80
+    end
+  end
+  while pos <= #data do
+    local len = data:byte(pos)
+    local text = data:sub(pos + 1, pos + len)
+    pos = pos + 1 + len
+    local hl_id = uvarint()
+    table.insert(items, { text, hl_id, uvarint() })
+  end
+  return items
+end
+
 function Screen:_handle_grid_line(grid, row, col, items, wrap)
   assert(self._options.ext_linegrid)
+  if type(items) == 'string' then
+    items = decode_gridbin(items)
+  end
   assert(#items > 0)
   local line = self._grids[grid].rows[row + 1]
   local colpos = col + 1
@@ -738,6 +738,29 @@ local function screen_tests(linegrid)
                                                            |
     ]])
   end)
+
+  it("updates the screen after events once 'redrawinterval' has passed", function()
+    command('set redrawinterval=100')
+    exec([[
+      let g:count = 0
+      func Tick(timer)
+        let g:count += 1
+        call setline(1, 'tick ' .. g:count)
+      endfunc
+      call timer_start(1, 'Tick', {'repeat': 5})
+    ]])
+    screen:expect([[
+      ^tick 5                                               |
+      {0:~                                                    }|*12
+                                                           |
+    ]])
+    feed('Afoo<Esc>')
+    screen:expect([[
+      tick 5fo^o                                            |
+      {0:~                                                    }|*12
+                                                           |
+    ]])
+  end)
 end
 
 describe('Screen (char-based)', function()
@@ -9,6 +9,7 @@ local exec = n.exec
 local feed = n.feed
 local insert = n.insert
 local api = n.api
+local eq = t.eq
 local is_os = t.is_os
 
 describe("'spell'", function()
@@ -408,6 +409,42 @@ describe("'spell'", function()
     ]])
   end)
 
+  it('finds bad words after clean lines are edited', function()
+    exec('set spell')
+    api.nvim_buf_set_lines(0, 0, -1, true, {
+      'This line is fine.',
+      'So is this one.',
+      'Here is a badwurd.',
+    })
+    feed('gg]s')
+    eq({ 3, 10 }, api.nvim_win_get_cursor(0))
+    feed('gg]s')
+    eq({ 3, 10 }, api.nvim_win_get_cursor(0))
+    api.nvim_buf_set_lines(0, 1, 2, true, { 'So is thiss one.' })
+    feed('gg]s')
+    eq({ 2, 6 }, api.nvim_win_get_cursor(0))
+    exec('spellgood! thiss')
+    feed('gg]s')
+    eq({ 3, 10 }, api.nvim_win_get_cursor(0))
+  end)
+
+  it('finds bad words after syntax items are cleared', function()
+    exec([[
+      set spell
+      syntax match Skip /thiss/ contains=@NoSpell
+    ]])
+    api.nvim_buf_set_lines(0, 0, -1, true, {
+      'This line is fine.',
+      'So is thiss one.',
+      'Here is a badwurd.',
+    })
+    feed('gg]s')
+    eq({ 3, 10 }, api.nvim_win_get_cursor(0))
+    exec('syntax clear')
+    feed('gg]s')
+    eq({ 2, 6 }, api.nvim_win_get_cursor(0))
+  end)
+
   it("global value works properly for 'spelloptions'", function()
     screen:try_resize(43, 3)
     exec('set spell')
@@ -590,6 +590,59 @@ describe('statusline', function()
     eq(1, eval('g:counter < 50'), 'g:counter=' .. eval('g:counter'))
   end)
 
+  it('is not evaluated again when the window is only redrawn', function()
+    exec([[
+      set laststatus=2
+      let g:counter = 0
+      func Status()
+        let g:counter += 1
+        return 'count ' .. g:counter
+      endfunc
+      set statusline=%{Status()}
+    ]])
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*5
+      {3:count 1                                 }|
+                                              |
+    ]])
+    api.nvim__redraw({ valid = false })
+    screen:expect_unchanged()
+    eq(1, eval('g:counter'))
+    command('redraw!')
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*5
+      {3:count 2                                 }|
+                                              |
+    ]])
+    command('redrawstatus')
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*5
+      {3:count 3                                 }|
+                                              |
+    ]])
+  end)
+
+  it('is evaluated again when switching to a buffer in the same state', function()
+    command('set laststatus=2 statusline=%f shortmess+=F')
+    command('edit Xa | edit Xb')
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*5
+      {3:Xb                                      }|
+                                              |
+    ]])
+    command('bnext')
+    screen:expect([[
+      ^                                        |
+      {1:~                                       }|*5
+      {3:Xa                                      }|
+                                              |
+    ]])
+  end)
+
   it('is redrawn on various state changes', function()
     -- recording state change #22683
     command('set ls=2 stl=%{repeat(reg_recording(),5)}')
@@ -23,3 +23,45 @@ describe('extend()', function()
     eq({ 1, 1, {}, {} }, api.nvim_get_var('l'))
   end)
 end)
+
+describe('list indexing', function()
+  it('stays correct when a long list is changed between lookups', function()
+    n.exec([[
+      let l = range(1000)
+      let g:res = [l[500], l[-1]]
+      call add(l, 1000)
+      call remove(l, -1)
+      let g:res += [l[700], l[999]]
+      call insert(l, 'a', 300)
+      call remove(l, 100)
+      let g:res += [l[299], l[600], len(l)]
+      call reverse(l)
+      let g:res += [l[0], l[600]]
+      call sort(l, {a, b -> type(a) == v:t_string ? -1 : type(b) == v:t_string ? 1 : a - b})
+      let g:res += [l[0], l[1], l[999]]
+      call extend(l, range(5), 400)
+      let g:res += [l[402], l[404], l[405]]
+    ]])
+    eq(
+      { 500, 999, 700, 999, 'a', 600, 1000, 999, 399, 'a', 0, 999, 2, 4, 400 },
+      api.nvim_get_var('res')
+    )
+  end)
+end)
+
+describe('indexing a temporary container', function()
+  it('keeps the value when the container is freed', function()
+    eq('b', eval("['a', 'b', 'c'][1]"))
+    eq({ 1, 2 }, eval("{'x': [1, 2], 'y': 'z'}.x"))
+    eq('c', eval("split('a b c')[-1]"))
+    eq({ a = 'A', b = 'B' }, eval("mapnew({'a': 'a', 'b': 'b'}, {_, v -> toupper(v)})"))
+    n.exec([[
+      let g:l = ['a', 'b']
+      let g:d = {'k': 'v'}
+      let g:x = [g:l[0], g:d.k]
+    ]])
+    eq({ 'a', 'b' }, api.nvim_get_var('l'))
+    eq({ k = 'v' }, api.nvim_get_var('d'))
+    eq({ 'a', 'v' }, api.nvim_get_var('x'))
+  end)
+end)
@@ -225,6 +225,31 @@ describe('listing functions using :function', function()
   end)
 end)
 
+describe('function lines', function()
+  before_each(clear)
+
+  it('find their commands again when called repeatedly', function()
+    exec([[
+      command! -bar Cmd let g:log += ['one']
+      let g:log = []
+      func F()
+        Cmd
+        silent let g:log += ['let']
+        for i in range(2)
+          Cmd | let g:log += [i]
+        endfor
+      endfunc
+      call F()
+      command! -bar Cmd let g:log += ['two']
+      call F()
+    ]])
+    eq(
+      { 'one', 'let', 'one', 0, 'one', 1, 'two', 'let', 'two', 0, 'two', 1 },
+      api.nvim_get_var('log')
+    )
+  end)
+end)
+
 it('no double-free in garbage collection #16287', function()
   clear()
   -- Don't use exec() here as using a named script reproduces the issue better.
@@ -63,6 +63,46 @@ describe('executable()', function()
     eq(0, call('executable', 'no_such_file_exists_209ufq23f'))
   end)
 
+  it('notices executables added to and removed from $PATH', function()
+    t.mkdir('Xexe_path')
+    finally(function()
+      n.rmdir('Xexe_path')
+    end)
+    command('let $PATH = fnamemodify("Xexe_path", ":p")')
+    local exe = is_os('win') and 'Xnew_exe.bat' or 'Xnew_exe'
+    eq(0, call('executable', exe))
+    -- Looked up again once the directory changed, checked at most every 100 ms.
+    write_file('Xexe_path/' .. exe, 'exit 0')
+    if not is_os('win') then
+      call('system', { 'chmod', '+x', 'Xexe_path/' .. exe })
+    end
+    command('sleep 200m')
+    eq(1, call('executable', exe))
+    os.remove('Xexe_path/' .. exe)
+    eq(0, call('executable', exe))
+  end)
+
+  it('looks up a relative $PATH entry again after :cd', function()
+    local exe = is_os('win') and 'Xcd_exe.bat' or 'Xcd_exe'
+    t.mkdir('Xexe_cd')
+    t.mkdir('Xexe_cd/sub')
+    t.mkdir('Xexe_cd/sub/bin')
+    finally(function()
+      n.rmdir('Xexe_cd')
+    end)
+    write_file('Xexe_cd/sub/bin/' .. exe, 'exit 0')
+    if not is_os('win') then
+      call('system', { 'chmod', '+x', 'Xexe_cd/sub/bin/' .. exe })
+    end
+    command('let $PATH = "bin"')
+    command('cd Xexe_cd')
+    eq(0, call('executable', exe))
+    command('cd sub')
+    eq(1, call('executable', exe))
+    command('cd ..')
+    eq(0, call('executable', exe))
+  end)
+
   it('sibling to nvim binary', function()
     -- Some executable in build/bin/, *not* in $PATH nor CWD.
     local sibling_exe = 'printargs-test'
@@ -386,6 +386,17 @@ describe('json_decode() function', function()
     )
   end)
 
+  it('parses long strings with escapes in any position', function()
+    local long = ('abcdefghijklmnopqrstuvwxyz'):rep(3)
+    eq(long, fn.json_decode('"' .. long .. '"'))
+    eq(long .. '\n' .. long, fn.json_decode('"' .. long .. '\\n' .. long .. '"'))
+    eq('«' .. long .. '"', fn.json_decode('"«' .. long .. '\\""'))
+    eq(
+      'Vim(call):E474: ASCII control characters cannot be present inside string: \t"',
+      exc_exec('call json_decode("\\"' .. long .. '\\t\\"")')
+    )
+  end)
+
   it('fails on strings with invalid bytes', function()
     eq(
       'Vim(call):E474: Only UTF-8 strings allowed: \255"',
@@ -52,6 +52,33 @@ describe('sort()', function()
     )
   end)
 
+  it('sorts long lists and ranges the same as short ones', function()
+    command([[
+      function Sorted(l)
+        for i in range(len(a:l) - 1)
+          if a:l[i] >=# a:l[i + 1]
+            return [i, a:l[i], a:l[i + 1]]
+          endif
+        endfor
+        return v:true
+      endfunction
+    ]])
+    -- Equal numbers have to keep the order of the index after the '-'.
+    command([[let g:l = sort(map(range(70000), 'printf("%d-%d", 99 - v:val % 100, v:val)'), 'n')]])
+    command([[call map(g:l, 'printf("%05d-%05d", str2nr(v:val), str2nr(matchstr(v:val, "-\\zs.*")))')]])
+    eq(true, eval('Sorted(g:l)'))
+    eq(true, eval([[Sorted(sort(map(range(70000), '"k" .. (v:val * 7919 % 70000)')))]]))
+    eq(8, eval([[sort(map(range(70000), 'v:val % 3 ? v:val : 1.0 * v:val'), 'f')[8] ]]))
+    -- :sort sorts long ranges in threads too.
+    command([[call setline(1, map(range(70000), 'printf("%05d %d", v:val, v:val % 7)'))]])
+    command([[sort /\d\+ / n]])
+    command([[let g:l = map(getline(1, '$'), 'printf("%d-%s", str2nr(v:val[6:]), v:val[:4])')]])
+    eq(true, eval('Sorted(g:l)'))
+    command([[call setline(1, map(range(70000), '"x" .. (v:val * 7919 % 70000)'))]])
+    command('sort')
+    eq(true, eval([[Sorted(getline(1, '$'))]]))
+  end)
+
   it('can yield E702 and stop sorting after that', function()
     command([[
       function Cmp(a, b)
@@ -66,4 +93,21 @@ describe('sort()', function()
       pcall_err(command, 'let sl = sort([1, 0, [], 3, 2], "Cmp")')
     )
   end)
+
+  it(':sort keeps the order of equal numbers', function()
+    local function sorted(lines, cmd)
+      api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      command(cmd)
+      return api.nvim_buf_get_lines(0, 0, -1, true)
+    end
+    local lines = { 'b 3', 'x', 'a -2', 'c 3', 'y', 'd 0x10' }
+    eq({ 'x', 'y', 'a -2', 'd 0x10', 'b 3', 'c 3' }, sorted(lines, 'sort n'))
+    eq({ 'c 3', 'b 3', 'd 0x10', 'a -2', 'y', 'x' }, sorted(lines, 'sort! n'))
+    eq(
+      { '', '-0.0 a', '0.0 b', '-0.0 c', '2.5', '1e3' },
+      sorted({ '-0.0 a', '0.0 b', '1e3', '', '-0.0 c', '2.5' }, 'sort f')
+    )
+    eq({ 'x 0xa', '0x1F', 'ff' }, sorted({ 'ff', '0x1F', 'x 0xa' }, 'sort x'))
+    eq({ 'a', 'b' }, sorted({ 'b', 'a', 'b', 'a' }, 'sort u'))
+  end)
 end)
@@ -1544,6 +1544,24 @@ func Test_cmdline_wildignorecase()
   call delete('XTEST')
 endfunc
 
+" Typing more characters after completing a file name narrows down the matches
+func Test_cmdline_complete_file_narrow()
+  call mkdir('Xnarrow', 'R')
+  for name in ['foo1', 'foo2', 'fbar', 'bar', '.hidden']
+    call writefile([], 'Xnarrow/' .. name)
+  endfor
+
+  call feedkeys(":e Xnarrow/f\<Tab>\<C-E>o\<C-A>\<C-B>\"\<CR>", 'xt')
+  call assert_equal('"e Xnarrow/foo1 Xnarrow/foo2', @:)
+  call feedkeys(":e Xnarrow/f\<Tab>\<C-E>ox\<Tab>\<BS>\<C-A>\<C-B>\"\<CR>", 'xt')
+  call assert_equal('"e Xnarrow/foo1 Xnarrow/foo2', @:)
+  call feedkeys(":e Xnarrow/fo\<Tab>\<C-E>\<BS>\<BS>b\<C-A>\<C-B>\"\<CR>", 'xt')
+  call assert_equal('"e Xnarrow/bar', @:)
+  " an empty name does not match hidden files, a name starting with "." does
+  call feedkeys(":e Xnarrow/\<Tab>\<C-E>.\<C-A>\<C-B>\"\<CR>", 'xt')
+  call assert_equal('"e Xnarrow/.hidden', @:)
+endfunc
+
 func Test_cmdline_write_alternatefile()
   new
   call setline('.', ['one', 'two'])
@@ -1316,6 +1316,41 @@ func Test_byte2line_line2byte()
   bw!
 endfunc
 
+func s:CheckLineOffsets()
+  let eol = &fileformat == 'dos' ? 2 : 1
+  let off = 1
+  for lnum in range(1, line('$'))
+    if lnum % 97 == 0 || lnum == line('$')
+      call assert_equal(off, line2byte(lnum), 'line ' .. lnum)
+      call assert_equal(lnum, byte2line(off), 'offset ' .. off)
+    endif
+    let off += len(getline(lnum)) + eol
+  endfor
+  call assert_equal(off, line2byte(line('$') + 1))
+endfunc
+
+" Test line2byte() and byte2line() with many chunks of lines and changes
+" in between.
+func Test_byte2line_line2byte_many_lines()
+  new
+  call setline(1, map(range(1, 5000), 'repeat("x", v:val % 17)'))
+  for ff in ['unix', 'dos']
+    let &fileformat = ff
+    call s:CheckLineOffsets()
+  endfor
+  set fileformat=unix
+  " Changes near the end, start and middle.
+  4000,4100d
+  call s:CheckLineOffsets()
+  call append(10, repeat(['abcdefgh'], 2000))
+  call s:CheckLineOffsets()
+  3000,3500s/x/yy/g
+  call s:CheckLineOffsets()
+  1,2500d
+  call s:CheckLineOffsets()
+  bw!
+endfunc
+
 " Test for byteidx() using a character index
 func Test_byteidx()
   let a = '.é.' " one char of two bytes
@@ -137,4 +137,29 @@ func Test_interrupt_global()
   call delete('Xtest_interrupt_global')
 endfunc
 
+" Test for :g/pat/d deleting runs of matching lines
+func Test_global_delete_range()
+  new
+  let lines = range(1, 30)->map({_, v -> (v % 15 < 12 ? 'x' : 'y') .. v})
+  call setline(1, lines)
+  g/^x/d
+  call assert_equal(['y12', 'y13', 'y14', 'y27', 'y28', 'y29'], getline(1, '$'))
+  " the numbered registers get the last lines one by one
+  call assert_equal("x30\n", @1)
+  call assert_equal("x26\n", @2)
+  call assert_equal("x19\n", @9)
+  call assert_equal("x30\n", @")
+  call assert_equal(6, line('.'))
+  undo
+  call assert_equal(lines, getline(1, '$'))
+
+  v/^x/d _
+  call assert_equal(24, line('$'))
+  call assert_equal('x30', getline('$'))
+  call assert_equal("x30\n", @1)
+  undo
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
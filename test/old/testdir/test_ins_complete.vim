@@ -1297,6 +1297,41 @@ func Test_complete_wrapscan()
   close!
 endfunc
 
+func s:GetComplWords()
+  let g:compl_words = complete_info(['items']).items->map({_, v -> v.word})
+  return ''
+endfunc
+
+" Test for completing words from another buffer, also after it changed
+func Test_complete_other_buffer_words()
+  new
+  let other = bufnr()
+  call setline(1, ['foo1 bar foo2', 'foo1 foo3 xfoo', 'Foo4 foo2 f'])
+  new
+  setlocal complete=w
+  inoremap <buffer> <F5> <C-R>=<SID>GetComplWords()<CR>
+  call feedkeys("Sfo\<C-N>\<F5>\<Esc>", 'tx')
+  call assert_equal(['foo1', 'foo2', 'foo3'], g:compl_words)
+
+  set ignorecase
+  call feedkeys("Sfo\<C-N>\<F5>\<Esc>", 'tx')
+  call assert_equal(['foo1', 'foo2', 'foo3', 'Foo4'], g:compl_words)
+  set ignorecase&
+
+  call setbufline(other, 1, 'foo5 foo1')
+  call feedkeys("Sfo\<C-N>\<F5>\<Esc>", 'tx')
+  call assert_equal(['foo5', 'foo1', 'foo3', 'foo2'], g:compl_words)
+
+  " a word with a multibyte character is found by searching
+  call setbufline(other, 2, 'foo1 foö3')
+  call feedkeys("Sfo\<C-N>\<F5>\<Esc>", 'tx')
+  call assert_equal(['foo5', 'foo1', 'foö3', 'foo2'], g:compl_words)
+
+  bwipe!
+  bwipe!
+  unlet g:compl_words
+endfunc
+
 " Test for completing special characters
 func Test_complete_special_chars()
   new
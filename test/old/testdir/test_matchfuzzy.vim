@@ -300,6 +300,18 @@ func Test_matchfuzzy_limit()
   call assert_equal([{'id': 5, 'val': 'crayon'}], l->matchfuzzy('c', #{key: 'val', limit: 1}))
 endfunc
 
+" Test for strings rejected early because they miss a character of the pattern
+func Test_matchfuzzy_missing_char()
+  let l = ['foo_bar', 'Foo9Bar', 'fobar', 'bar foo', 'FOO BAR 9', 'oof']
+  call assert_equal(['FOO BAR 9', 'Foo9Bar', 'foo_bar'],
+        \ l->matchfuzzy('fOObr')->sort())
+  call assert_equal(['FOO BAR 9', 'Foo9Bar'], l->matchfuzzy('9 fo')->sort())
+  call assert_equal(['FOO BAR 9'], l->matchfuzzy('foo 9', #{matchseq: 1}))
+  call assert_equal([], l->matchfuzzy('foz'))
+  " a non-ASCII character may match an ASCII one ignoring case
+  call assert_equal(["\u212a"], ["\u212a", 'x']->matchfuzzy('k'))
+endfunc
+
 " This was using uninitialized memory
 func Test_matchfuzzy_initialized()
   CheckRunVimInTerminal
@@ -6463,6 +6463,37 @@ func Test_quickfix_update_with_missing_coordinate_info()
   %bwipe!
 endfunc
 
+" Updating a list with "u" keeps the entries that didn't change, the result
+" must be the same as for a new list.
+func Test_quickfix_update_keeps_entries()
+  new
+  call setline(1, range(1, 10))
+  let b1 = bufnr()
+  let items = []
+  for i in range(1, 8)
+    call add(items, {'bufnr': b1, 'lnum': i, 'col': i, 'text': 'e' .. i,
+          \ 'type': 'W', 'user_data': {'n': i}})
+  endfor
+  call setqflist(items)
+
+  let new_items = deepcopy(items)
+  let new_items[2].text = 'changed'
+  let new_items[5].user_data = {'n': 0}
+  call insert(new_items, {'bufnr': b1, 'lnum': 9, 'pattern': 'x'}, 4)
+  call remove(new_items, 0)
+  call add(new_items, {'filename': bufname(b1), 'lnum': 2})
+  call setqflist(new_items, 'u')
+  let updated = getqflist()
+  call assert_equal('changed', updated[1].text)
+  call assert_equal({'n': 0}, updated[5].user_data)
+
+  call setqflist(new_items, 'r')
+  call assert_equal(getqflist(), updated)
+
+  call setqflist([], 'f')
+  %bwipe!
+endfunc
+
 " Test for "%b" in "errorformat"
 func Test_efm_format_b()
   call setqflist([], 'f')
@@ -6787,6 +6818,44 @@ func Test_chi_and_lhi_are_independent()
   set lhistory&
 endfunc
 
+" Test for :vimgrep skipping files that don't contain the text every match
+" needs
+func Test_vimgrep_skip_files()
+  call writefile(['no match here'], 'Xskip1.txt', 'D')
+  call writefile(['one', 'a needle and its end'], 'Xskip2.txt', 'D')
+  call writefile(['nothing'], 'Xskip3.txt', 'D')
+  call writefile(['NEEDLE', 'NEEDLE END'], 'Xskip4.txt', 'D')
+  %bwipe!
+
+  for re in [1, 2]
+    exe 'set regexpengine=' .. re
+    vimgrep /needle.*end/j Xskip*.txt
+    let l = getqflist()
+    call assert_equal(1, len(l))
+    call assert_equal('Xskip2.txt', bufname(l[0].bufnr))
+    call assert_equal(2, l[0].lnum)
+
+    vimgrep /\cneedle.*end/gj Xskip*.txt
+    call assert_equal([['Xskip2.txt', 2], ['Xskip4.txt', 2]],
+          \ getqflist()->map({_, v -> [bufname(v.bufnr), v.lnum]}))
+
+    " an autocommand may change the text when reading
+    augroup QF_Test
+      au!
+      au BufReadPost Xskip3.txt call setline(1, 'needle at the end')
+    augroup END
+    vimgrep /needle.*end/j Xskip*.txt
+    call assert_equal(['Xskip2.txt', 'Xskip3.txt'],
+          \ getqflist()->map({_, v -> bufname(v.bufnr)}))
+    augroup QF_Test
+      au!
+    augroup END
+    %bwipe!
+  endfor
+  set regexpengine&
+  call setqflist([], 'f')
+endfunc
+
 func Test_quickfix_close_buffer_crash()
   new
   lexpr 'test' | lopen
@@ -1175,4 +1175,97 @@ func Test_compare_column_matchstr()
 endfunc
 
 
+" Patterns with a literal that every match must contain are rejected early
+" when the text does not contain it.  Check this gives the same results as
+" the backtracking engine.
+func Test_required_literal()
+  let tl = [
+        \ ['\w\+Error', 'MyError: x', 'MyError'],
+        \ ['\w\+Error', 'My error: x', ''],
+        \ ['\s*foo\(bar\)', '  foobar', '  foobar'],
+        \ ['\s*foo\(bar\)', '  foo bar', ''],
+        \ ['[ab]\+cd\<ef', 'abcdef', ''],
+        \ ['.*x\<y', 'ab xy x y', ''],
+        \ ['.*x \<y', 'ab xy x y', 'ab xy x y'],
+        \ ['\(foo\)\@<=bar', 'foobar', 'bar'],
+        \ ['\cA.*LOG', 'a quick log', 'a quick log'],
+        \ ['\CA.*LOG', 'a quick log', ''],
+        \ ['\d\+\%[abc]xyz', '12xyz', '12xyz'],
+        \ ['\d\+\(ab\|cd\)ef', '1cdef', '1cdef'],
+        \ ]
+  for [pat, text, expected] in tl
+    for engine in [1, 2]
+      call assert_equal(expected, matchstr(text, '\%#=' .. engine .. pat),
+            \ 'engine ' .. engine .. ' pattern ' .. pat)
+    endfor
+  endfor
+
+  " "\n" may move the literal to the next line
+  new
+  call setline(1, ['abc', 'def'])
+  call assert_equal([1, 1], searchpos('\%#=2\w\+\ndef'))
+  bwipe!
+endfunc
+
+" Compiled patterns are cached, the cache must not return a program compiled
+" with different settings.
+func Test_regprog_cache()
+  for i in range(3)
+    call assert_equal(1, match("a\tb", '[\t]'))
+    set cpo+=l
+    call assert_equal(-1, match("a\tb", '[\t]'))
+    call assert_equal(1, match("atb", '[\t]'))
+    set cpo-=l
+  endfor
+
+  new
+  setlocal iskeyword=@
+  call assert_equal(-1, match('a-b', '\%#=1a[[:keyword:]]'))
+  setlocal iskeyword=@,-
+  call assert_equal(0, match('a-b', '\%#=1a[[:keyword:]]'))
+  bwipe!
+
+  new
+  s/^/foo/
+  call assert_equal(-1, match('abc', '~'))
+  call assert_equal(0, match('foo', '~'))
+  s/^/bar/
+  call assert_equal(-1, match('foo', '~'))
+  bwipe!
+
+  " the same pattern used recursively
+  call assert_equal('AbAb', substitute('abab', 'a',
+        \ '\=toupper(substitute(submatch(0), "a", "a", "g"))', 'g'))
+endfunc
+
+" The lazy DFA must agree with the backtracking engine.
+func Test_lazy_dfa()
+  let pats = ['\d\+-\d\+', '^\s*#', 'x$', '^$', 'ab\|cd', '[^a-c]\{3}',
+        \ '[[:upper:]][[:digit:]]', '\(foo\)\+bar', '\%(a\|b\)*c$',
+        \ '[a-cX-Z]z', '\a\l\u', '\x\x\X', '[0-9]\+\.[0-9]*']
+  let lines = ['', '123-456', '  # comment', 'ax', 'xa', 'zzcd', 'abc',
+        \ 'Z9', 'foofoobar', 'ababc', 'Bz', 'xZz', 'aaB', 'ffg', '1.',
+        \ "caf\xe9 cd", 'ABC', '   ']
+  for ic in [0, 1]
+    let &ignorecase = ic
+    for pat in pats
+      for line in lines
+        call assert_equal(match(line, '\%#=1' .. pat), match(line, '\%#=3' .. pat),
+              \ 'pattern ' .. pat .. ' line "' .. line .. '" ignorecase ' .. ic)
+      endfor
+    endfor
+  endfor
+  set ignorecase&
+
+  " in a buffer, starting at a column
+  new
+  call setline(1, ['no match here', 'abc 123', 'x'])
+  set re=3
+  call assert_equal([2, 5], searchpos('\d\+'))
+  call assert_equal([3, 1], searchpos('^x$'))
+  call assert_equal(0, search('^\d'))
+  set re=0
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -456,6 +456,38 @@ func Test_search_cmdline3()
   call Incsearch_cleanup()
 endfunc
 
+" Test for 'incsearch' when the pattern is extended, continuing from the
+" previous match
+func Test_search_cmdline_extend()
+  CheckOption incsearch
+
+  call Ntest_override("char_avail", 1)
+  new
+  call setline(1, ['  1', 'ab1', 'abc2', 'ab', 'abcd3', 'xyz'])
+  set incsearch hlsearch
+
+  1
+  call feedkeys("/abc\<c-l>\<cr>", 'tx')
+  call assert_equal('abc2', getline('.'))
+  call feedkeys("/abcd\<c-l>\<cr>", 'tx')
+  call assert_equal('abcd3', getline('.'))
+  1
+  call feedkeys("/abq\<bs>c\<c-l>\<cr>", 'tx')
+  call assert_equal('abc2', getline('.'))
+  $
+  call feedkeys("?ab\<c-l>\<c-l>\<cr>", 'tx')
+  call assert_equal('abcd3', getline('.'))
+  call assert_equal('abcd', @/)
+  " the search wraps around
+  $
+  call feedkeys("/ab\<c-l>\<cr>", 'tx')
+  call assert_equal(2, line('.'))
+
+  set noincsearch nohlsearch
+  call Ntest_override("char_avail", 0)
+  bw!
+endfunc
+
 func Test_search_cmdline3s()
   CheckOption incsearch
 
@@ -1799,7 +1831,7 @@ func Test_invalid_regexp()
   call assert_fails("call search('\\%[]')", 'E70:')
   call assert_fails("call search('\\%9999999999999999999999999999v')", 'E951:')
   set regexpengine&
-  call assert_fails("call search('\\%#=3ab')", 'E864:')
+  call assert_fails("call search('\\%#=4ab')", 'E864:')
 endfunc
 
 " Test for searching a very complex pattern in a string. Should switch the
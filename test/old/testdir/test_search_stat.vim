@@ -268,6 +268,41 @@ func Test_searchcount_fails()
   call assert_fails('echo searchcount({"pos" : [1, 2, []]})', 'E745:')
 endfunc
 
+" Test for searchcount() at different positions after counting all matches
+func Test_searchcount_positions()
+  new
+  call setline(1, ['foo bar', 'xx', 'foo foo', 'bar', 'foo'])
+  call assert_equal(#{current: 3, total: 4, exact_match: 1, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [3, 6, 0]}))
+  call assert_equal(#{current: 3, total: 4, exact_match: 0, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [4, 1, 0]}))
+  call assert_equal(#{current: 0, total: 4, exact_match: 0, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [0, 1, 0]}))
+  call assert_equal(#{current: 4, total: 4, exact_match: 1, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [5, 1, 0]}))
+
+  " a change in the buffer is noticed
+  call append(0, 'foo')
+  call assert_equal(#{current: 1, total: 5, exact_match: 1, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [1, 1, 0]}))
+  call assert_equal(#{current: 3, total: 3, exact_match: 0, incomplete: 2, maxcount: 2},
+        \ searchcount(#{pattern: 'foo', pos: [5, 1, 0], maxcount: 2}))
+  call assert_equal(#{current: 4, total: 5, exact_match: 1, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [4, 5, 0]}))
+
+  " more matches than "maxcount"
+  call append(0, 'foo')
+  call assert_equal(#{current: 1, total: 3, exact_match: 1, incomplete: 2, maxcount: 2},
+        \ searchcount(#{pattern: 'foo', pos: [1, 1, 0], maxcount: 2}))
+  call assert_equal(#{current: 3, total: 3, exact_match: 0, incomplete: 2, maxcount: 2},
+        \ searchcount(#{pattern: 'foo', pos: [6, 1, 0], maxcount: 2}))
+  call assert_equal(#{current: 2, total: 3, exact_match: 1, incomplete: 2, maxcount: 2},
+        \ searchcount(#{pattern: 'foo', pos: [2, 1, 0], maxcount: 2}))
+  call assert_equal(#{current: 6, total: 6, exact_match: 1, incomplete: 0, maxcount: 99},
+        \ searchcount(#{pattern: 'foo', pos: [7, 1, 0]}))
+  bwipe!
+endfunc
+
 func Test_search_stat_narrow_screen()
   " This used to crash Vim
   let save_columns = &columns
@@ -319,4 +319,29 @@ func Test_tag_complete_with_overlong_line()
   set tags&
 endfunc
 
+" A large tags file searched linearly while ignoring case
+func Test_taglist_ignorecase_large_file()
+  let tagslines = ['!_TAG_FILE_SORTED	1	//']
+  for i in range(40000)
+    call add(tagslines, printf('Tag%05d	Xfile	%d;"	kind:function	class:SomeClass', i, i + 1))
+  endfor
+  call add(tagslines, 'ZONKER	Xfile	3')
+  call add(tagslines, 'Zonk	Xfile	1')
+  call add(tagslines, 'zonk	Xfile	2')
+  call writefile(tagslines, 'Xtags', 'D')
+  set tags=Xtags ignorecase
+
+  call assert_equal(['Zonk', 'zonk'], taglist('^zonk$')->map({_, t -> t.name})->sort())
+  call assert_equal(['ZONKER', 'Zonk', 'zonk'], taglist('^ZoN')->map({_, t -> t.name})->sort())
+  call assert_equal(['Tag39999'], taglist('^tag39999')->map({_, t -> t.name}))
+  call assert_equal([], taglist('^zz'))
+
+  " the file is indexed again after it changed
+  call add(tagslines, 'zzz	Xfile	4')
+  call writefile(tagslines, 'Xtags')
+  call assert_equal(['zzz'], taglist('^zz')->map({_, t -> t.name}))
+
+  set tags& ignorecase&
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
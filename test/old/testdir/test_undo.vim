@@ -883,4 +883,155 @@ func Test_undo_range_normal()
   bwipe!
 endfunc
 
+" Test undo after :substitute changing a range of lines, which is saved in
+" one undo entry
+func Test_undo_substitute_range()
+  new
+  let lines = ['one x', 'two x', 'three', 'four x', 'five x', 'six x']
+  call setline(1, lines)
+  let &l:undolevels = &l:undolevels
+  %s/x/y/
+  call assert_equal(['one y', 'two y', 'three', 'four y', 'five y', 'six y'],
+        \ getline(1, '$'))
+  undo
+  call assert_equal(lines, getline(1, '$'))
+  redo
+  call assert_equal(['one y', 'two y', 'three', 'four y', 'five y', 'six y'],
+        \ getline(1, '$'))
+  undo
+
+  " a line break in the replacement changes the line count
+  let &l:undolevels = &l:undolevels
+  %s/x/\r/
+  call assert_equal(11, line('$'))
+  undo
+  call assert_equal(lines, getline(1, '$'))
+
+  " the first line is changed again
+  let &l:undolevels = &l:undolevels
+  2,4s/x/y/
+  1s/one/ONE/
+  undo
+  call assert_equal(['one x', 'two y', 'three', 'four y'], getline(1, 4))
+  undo
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+endfunc
+
+" Changes in a single long line may be stored as a delta
+func Test_undo_long_line_delta()
+  new
+  setlocal noundofile
+  let line = repeat('abcdefghij', 50)
+  call setline(1, [line, 'two'])
+  let &l:undolevels = &l:undolevels
+  call setline(1, 'X' .. line[1:])
+  let &l:undolevels = &l:undolevels
+  call setline(1, 'Y' .. line[1:])
+  let &l:undolevels = &l:undolevels
+  call setline(1, line[:249] .. 'middle' .. line[250:])
+  let &l:undolevels = &l:undolevels
+  call setline(2, 'TWO')
+  undo
+  call assert_equal(line[:249] .. 'middle' .. line[250:], getline(1))
+  undo
+  call assert_equal('Y' .. line[1:], getline(1))
+  undo
+  call assert_equal('X' .. line[1:], getline(1))
+  undo
+  call assert_equal(line, getline(1))
+  redo
+  redo
+  redo
+  call assert_equal(line[:249] .. 'middle' .. line[250:], getline(1))
+  " a new branch after undo
+  undo
+  call setline(1, line)
+  undo
+  call assert_equal('Y' .. line[1:], getline(1))
+  undo
+  undo
+  call assert_equal(line, getline(1))
+
+  " an undo file is not written for this history
+  silent wundo Xundofile_delta
+  call assert_false(filereadable('Xundofile_delta'))
+  bwipe!
+endfunc
+
+" 'undomemory' forgets the oldest changes
+func Test_undomemory()
+  new
+  setlocal noundofile
+  call setline(1, ['one', 'two'])
+  for i in range(10)
+    let &l:undolevels = &l:undolevels
+    call setline(1, repeat(nr2char(char2nr('a') + i), 1000))
+  endfor
+  call assert_equal(10, len(undotree().entries))
+  call assert_true(undotree().memory > 8000)
+
+  setlocal undomemory=4
+  let &l:undolevels = &l:undolevels
+  call setline(2, 'TWO')
+  let ut = undotree()
+  call assert_equal(4, len(ut.entries))
+  call assert_inrange(1, 4096, ut.memory)
+  call assert_equal(11, ut.seq_last)
+  undo 0
+  call assert_equal(repeat('g', 1000), getline(1))
+
+  " the global value is used without a local value
+  setlocal undomemory<
+  call assert_equal(-1, &l:undomemory)
+  call assert_equal(0, &undomemory)
+  call assert_fails('setlocal undomemory=-2', 'E474:')
+  bwipe!
+endfunc
+
+" undotree() with {since} and :undo N across branches
+func Test_undotree_since()
+  new
+  call setline(1, 'one')
+  for i in range(2, 5)
+    let &l:undolevels = &l:undolevels
+    call setline(1, 'change ' .. i)
+  endfor
+  let entries = undotree('%', 2).entries
+  call assert_equal([3, 4, 5], map(copy(entries), 'v:val.seq'))
+  call assert_equal([2, 3, 4], map(copy(entries), 'v:val.parent'))
+  call assert_equal(1, entries[-1].newhead)
+  call assert_equal(0, undotree('%', 0).entries[0].parent)
+  call assert_equal([], undotree('%', 5).entries)
+
+  undo 3
+  let &l:undolevels = &l:undolevels
+  call setline(1, 'branch')
+  let entries = undotree('%', 5).entries
+  call assert_equal(1, len(entries))
+  call assert_equal(6, entries[0].seq)
+  call assert_equal(3, entries[0].parent)
+
+  undo 5
+  call assert_equal('change 5', getline(1))
+  undo 6
+  call assert_equal('branch', getline(1))
+  undo 2
+  call assert_equal('change 2', getline(1))
+  undo 4
+  call assert_equal('change 4', getline(1))
+  undo
+  call assert_equal('change 3', getline(1))
+  redo
+  call assert_equal('change 4', getline(1))
+  undo 0
+  call assert_equal('', getline(1))
+  undo 6
+  call assert_equal('branch', getline(1))
+  undo 1
+  call assert_equal('one', getline(1))
+  call assert_fails('undo 7', 'E830:')
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
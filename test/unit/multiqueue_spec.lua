@@ -138,6 +138,28 @@ describe('multiqueue (multi-level event-queue)', function()
     eq('c2i11', get(parent))
   end)
 
+  itp('takes events of a background queue after the others', function()
+    local bg = multiqueue.multiqueue_new_child(parent)
+    multiqueue.multiqueue_set_background(bg, true)
+    put(bg, 'bg1')
+    put(bg, 'bg2')
+    put(child3, 'c3i3')
+    eq('c1i1', get(parent))
+    eq('c1i2', get(parent))
+    eq('c2i1', get(parent))
+    eq('c1i3', get(parent))
+    eq('c2i2', get(parent))
+    eq('c2i3', get(parent))
+    eq('c2i4', get(parent))
+    eq('c3i1', get(parent))
+    -- not starved by the other queues
+    eq('bg1', get(parent))
+    eq('c3i2', get(parent))
+    eq('c3i3', get(parent))
+    eq('bg2', get(parent))
+    eq(true, multiqueue.multiqueue_empty(parent))
+  end)
+
   itp('removes from parent queue when child is freed', function()
     free(child2)
     eq('c1i1', get(parent))
@@ -0,0 +1,56 @@
+local t = require('test.unit.testutil')
+local itp = t.gen_itp(it)
+
+local eq = t.eq
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/sha256.h')
+
+--- Bytes 0, 1, ..., 250, 0, 1, ... of length "len".
+local function pattern(len)
+  local buf = ffi.new('uint8_t[?]', len)
+  for i = 0, len - 1 do
+    buf[i] = i % 251
+  end
+  return buf
+end
+
+local function hex(digest)
+  local s = {}
+  for i = 0, 31 do
+    s[#s + 1] = ('%02x'):format(digest[i])
+  end
+  return table.concat(s)
+end
+
+describe('sha256', function()
+  itp('passes the self test', function()
+    eq(true, lib.sha256_self_test())
+  end)
+
+  itp('hashes input of several blocks', function()
+    eq(
+      '4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d',
+      ffi.string(lib.sha256_bytes(pattern(1000), 1000, nil, 0))
+    )
+    local abc = ('abc'):rep(100)
+    eq(
+      '87516260b9a9d70d5598444b7f5a2cb191c6da852acedaeaccba2341988901dc',
+      ffi.string(lib.sha256_bytes(abc, #abc, 'salt', 4))
+    )
+  end)
+
+  itp('gives the same digest for any split of the input', function()
+    local buf = pattern(1000)
+    local ctx = ffi.new('context_sha256_T')
+    local digest = ffi.new('uint8_t[32]')
+    for _, step in ipairs({ 1, 7, 63, 64, 65, 200, 1000 }) do
+      lib.sha256_start(ctx)
+      for i = 0, 999, step do
+        lib.sha256_update(ctx, buf + i, math.min(step, 1000 - i))
+      end
+      lib.sha256_finish(ctx, digest)
+      eq('4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d', hex(digest))
+    end
+  end)
+end)
@@ -263,6 +263,49 @@ describe('vim_snprintf()', function()
   end)
 end)
 
+describe('vim_fmt_num()', function()
+  local function a(expected, bsize, num, width)
+    local buf = ffi.gc(strings.xmalloc(bsize), strings.xfree)
+    eq(#expected, tonumber(strings.vim_fmt_num(buf, bsize, num, width)))
+    eq(expected, ffi.string(buf))
+    if bsize > #expected + 1 then
+      -- Formats like vim_snprintf() with "%*" PRId64.
+      local buf2 = ffi.gc(strings.xmalloc(bsize), strings.xfree)
+      strings.vim_snprintf(buf2, bsize, '%*lld', ffi.cast('int', width), ffi.cast('long long', num))
+      eq(expected, ffi.string(buf2))
+    end
+  end
+
+  itp('formats numbers', function()
+    a('0', 20, 0, 0)
+    a('7', 20, 7, 0)
+    a('42', 20, 42, 0)
+    a('100', 20, 100, 0)
+    a('1234567', 20, 1234567, 0)
+    a('-1', 20, -1, 0)
+    a('-9876', 20, -9876, 0)
+    -- int64_t arithmetic wraps around.
+    local int64_min = ffi.cast('int64_t', 2 ^ 62) * 2
+    a('9223372036854775807', 30, int64_min - 1, 0)
+    a('-9223372036854775808', 30, int64_min, 0)
+  end)
+
+  itp('pads to the width', function()
+    a('   42', 20, 42, 5)
+    a('42   ', 20, 42, -5)
+    a('-42  ', 20, -42, -5)
+    a('12345', 20, 12345, 3)
+    a('12345', 20, 12345, -3)
+  end)
+
+  itp('truncates', function()
+    a('123', 4, 123456, 0)
+    a('   ', 4, 12, 6)
+    a('12 ', 4, 12, -6)
+    a('', 1, 12, 0)
+  end)
+end)
+
 describe('strcase_save()', function()
   local strcase_save = function(input_string, upper)
     local res = strings.strcase_save(to_cstr(input_string), upper)
@@ -3202,6 +3202,12 @@ putglyph 1f3f4,200d,2620,fe0f 2 0,4]])
     screen_chars(0, 0, 2, 80, 'Hello\nWorld', screen)
     screen_text(0, 0, 2, 80, '48,65,6c,6c,6f,0a,57,6f,72,6c,64', screen)
 
+    -- Long run wrapping to the next line
+    reset(nil, screen)
+    push(string.rep('x', 100) .. 'é' .. string.rep('y', 10), vt)
+    screen_row(0, string.rep('x', 80), screen)
+    screen_row(1, string.rep('x', 20) .. 'é' .. string.rep('y', 10), screen)
+
     -- Altscreen
     reset(nil, screen)
     push('P', vt)
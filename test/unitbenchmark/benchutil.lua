@@ -0,0 +1,151 @@
+-- Timing helpers for benchmarks that call into Nvim C code through the FFI.
+--
+-- Each measured function runs inside a child forked by the unit test harness,
+-- so results are printed and appended to $BENCH_JSON (one JSON object per
+-- line) instead of being returned to the parent.
+
+local uv = vim.uv
+
+local M = {}
+
+local nsamples = tonumber(os.getenv('BENCH_SAMPLES')) or 20
+local min_time = (tonumber(os.getenv('BENCH_MIN_TIME_MS')) or 10) * 1e6
+local json_path = os.getenv('BENCH_JSON')
+
+--- @param fn fun(n: integer)
+--- @param iters integer
+--- @return number elapsed time in nanoseconds
+local function measure(fn, iters)
+  local start = uv.hrtime()
+  fn(iters)
+  return uv.hrtime() - start
+end
+
+--- Finds how many iterations a single sample needs so that it takes at least
+--- BENCH_MIN_TIME_MS, so that timer resolution and call overhead don't
+--- dominate.
+local function calibrate(fn)
+  local iters = 1
+  while true do
+    local elapsed = measure(fn, iters)
+    if elapsed >= min_time or iters >= 2 ^ 30 then
+      return iters
+    end
+    iters = math.max(iters * 2, math.ceil(iters * 1.2 * min_time / math.max(elapsed, 1)))
+  end
+end
+
+--- @param sorted number[]
+local function median(sorted)
+  local n = #sorted
+  if n % 2 == 1 then
+    return sorted[(n + 1) / 2]
+  end
+  return (sorted[n / 2] + sorted[n / 2 + 1]) / 2
+end
+
+--- @param times number[]
+local function summarize(times)
+  table.sort(times)
+  local sum = 0
+  for _, v in ipairs(times) do
+    sum = sum + v
+  end
+  local mean = sum / #times
+  local var = 0
+  for _, v in ipairs(times) do
+    var = var + (v - mean) ^ 2
+  end
+  local med = median(times)
+  local dev = {}
+  for i, v in ipairs(times) do
+    dev[i] = math.abs(v - med)
+  end
+  table.sort(dev)
+  return {
+    min = times[1],
+    max = times[#times],
+    mean = mean,
+    median = med,
+    stddev = #times > 1 and math.sqrt(var / (#times - 1)) or 0,
+    mad = median(dev),
+  }
+end
+
+--- @param ns number
+local function fmt_time(ns)
+  if ns >= 1e9 then
+    return ('%.3f s'):format(ns / 1e9)
+  elseif ns >= 1e6 then
+    return ('%.3f ms'):format(ns / 1e6)
+  elseif ns >= 1e3 then
+    return ('%.3f us'):format(ns / 1e3)
+  end
+  return ('%.1f ns'):format(ns)
+end
+
+--- Measures `fn` and reports the result.
+---
+--- `fn(n)` must perform the measured operation `n` times. The iteration count
+--- is calibrated first and one sample is discarded as warmup, then
+--- $BENCH_SAMPLES samples are taken. The median is reported together with the
+--- median absolute deviation (MAD), which unlike the mean and standard
+--- deviation is not skewed by a few samples hit by scheduling noise.
+---
+--- @param name string
+--- @param fn fun(n: integer)
+--- @param opts? { ops?: integer } `ops`: number of primitive operations done
+---   by one iteration, used to report the time per operation.
+--- @return table
+function M.bench(name, fn, opts)
+  opts = opts or {}
+  local iters = calibrate(fn)
+  measure(fn, iters)
+  local times = {}
+  for i = 1, nsamples do
+    times[i] = measure(fn, iters) / iters
+  end
+
+  local r = summarize(times)
+  r.name = name
+  r.samples = nsamples
+  r.iterations = iters
+  r.ops = opts.ops or 1
+  r.ns_per_op = r.median / r.ops
+
+  print(
+    ('%-44s %12s/op  MAD %5.1f%%  min %12s  (%d x %d)'):format(
+      name,
+      fmt_time(r.ns_per_op),
+      r.median > 0 and r.mad / r.median * 100 or 0,
+      fmt_time(r.min / r.ops),
+      nsamples,
+      iters
+    )
+  )
+
+  if json_path and json_path ~= '' then
+    local f = assert(io.open(json_path, 'a'))
+    f:write(vim.json.encode(r), '\n')
+    f:close()
+  end
+  return r
+end
+
+--- Returns `count` pseudo-random integers in [0, max), the same on every run
+--- so that results stay comparable.
+--- @param count integer
+--- @param max integer
+--- @param seed? integer
+--- @return integer[]
+function M.random_ints(count, max, seed)
+  local state = seed or 42
+  local res = {}
+  for i = 1, count do
+    state = state * 16807 % 2147483647
+    res[i] = state % max
+  end
+  return res
+end
+
+return M
@@ -0,0 +1,87 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/hashtab.h', './src/nvim/map_defs.h', './src/nvim/memory.h')
+
+local N = 10000
+
+describe('hashtab and map', function()
+  -- Keys shaped like Vimscript variable names, kept alive as C strings
+  -- because both tables store the key pointer.
+  local names = {} --- @type string[]
+  local keys = {}
+  for i = 1, N do
+    names[i] = ('var_%d_%x'):format(i, i * 2654435761 % 4294967296)
+    keys[i] = t.to_cstr(names[i])
+  end
+  local order = b.random_ints(N, N, 11)
+
+  local function fill_hashtab(ht)
+    lib.hash_init(ht)
+    for i = 1, N do
+      lib.hash_add(ht, keys[i])
+    end
+  end
+
+  local function fill_map(map)
+    for i = 1, N do
+      lib.map_put_ref_cstr_tptr_t(map, keys[i], nil, nil)[0] = keys[i]
+    end
+  end
+
+  local function map_destroy(map)
+    lib.xfree(map[0].set.keys)
+    lib.xfree(map[0].set.h.hash)
+    lib.xfree(map[0].values)
+    ffi.fill(map, ffi.sizeof('Map_cstr_tptr_t'))
+  end
+
+  itp('hashtab add', function()
+    local ht = ffi.new('hashtab_T[1]')
+    b.bench('hashtab: add', function(n)
+      for _ = 1, n do
+        fill_hashtab(ht)
+        lib.hash_clear(ht)
+      end
+    end, { ops = N })
+  end)
+
+  itp('hashtab find', function()
+    local ht = ffi.new('hashtab_T[1]')
+    fill_hashtab(ht)
+    b.bench('hashtab: find', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.hash_find(ht, names[order[i] + 1])
+        end
+      end
+    end, { ops = N })
+    lib.hash_clear(ht)
+  end)
+
+  itp('map put', function()
+    local map = ffi.new('Map_cstr_tptr_t[1]')
+    b.bench('map: put', function(n)
+      for _ = 1, n do
+        fill_map(map)
+        map_destroy(map)
+      end
+    end, { ops = N })
+  end)
+
+  itp('map get', function()
+    local map = ffi.new('Map_cstr_tptr_t[1]')
+    fill_map(map)
+    b.bench('map: get', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.map_ref_cstr_tptr_t(map, names[order[i] + 1], nil)
+        end
+      end
+    end, { ops = N })
+    map_destroy(map)
+  end)
+end)
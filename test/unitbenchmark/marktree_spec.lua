@@ -0,0 +1,72 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/marktree.h')
+
+local N = 10000
+
+describe('marktree', function()
+  local rows = b.random_ints(N, 2000)
+  local cols = b.random_ints(N, 80, 7)
+
+  local function fill(tree)
+    for i = 1, N do
+      lib.marktree_put_test(tree, 1, i, rows[i], cols[i], i % 2 == 0, -1, -1, false, false)
+    end
+  end
+
+  itp('put', function()
+    local tree = ffi.new('MarkTree[1]')
+    b.bench('marktree: put', function(n)
+      for _ = 1, n do
+        fill(tree)
+        lib.marktree_clear(tree)
+      end
+    end, { ops = N })
+  end)
+
+  itp('itr_get', function()
+    local tree = ffi.new('MarkTree[1]')
+    local iter = ffi.new('MarkTreeIter[1]')
+    fill(tree)
+    b.bench('marktree: itr_get', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.marktree_itr_get(tree, rows[i], cols[i], iter)
+        end
+      end
+    end, { ops = N })
+    lib.marktree_clear(tree)
+  end)
+
+  itp('itr_next', function()
+    local tree = ffi.new('MarkTree[1]')
+    local iter = ffi.new('MarkTreeIter[1]')
+    fill(tree)
+    b.bench('marktree: full scan', function(n)
+      for _ = 1, n do
+        lib.marktree_itr_first(tree, iter)
+        repeat
+        until not lib.marktree_itr_next(tree, iter)
+      end
+    end, { ops = N })
+    lib.marktree_clear(tree)
+  end)
+
+  itp('splice', function()
+    local tree = ffi.new('MarkTree[1]')
+    fill(tree)
+    -- Insert and delete a line, so that the tree is the same after each pair.
+    b.bench('marktree: splice', function(n)
+      for i = 1, n do
+        local row = rows[(i % N) + 1]
+        lib.marktree_splice(tree, row, 0, 0, 0, 1, 0)
+        lib.marktree_splice(tree, row, 0, 1, 0, 0, 0)
+      end
+    end, { ops = 2 })
+    lib.marktree_clear(tree)
+  end)
+end)
@@ -0,0 +1,42 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/mbyte.h')
+
+local TEXTS = {
+  ascii = ('The quick brown fox jumps over the lazy dog. '):rep(100),
+  latin = ('Größenänderung für Überschriften, naïve café. '):rep(100),
+  cjk = ('日本語のテキストと한국어 텍스트, 中文文本。'):rep(100),
+  combining = ('e\204\129a\204\128o\204\136 \240\159\145\141\240\159\143\189 '):rep(100),
+}
+
+describe('mbyte', function()
+  for _, kind in ipairs({ 'ascii', 'latin', 'cjk', 'combining' }) do
+    local text = TEXTS[kind]
+    local buf = ffi.cast('const char *', text)
+    local len = #text
+
+    itp('decode ' .. kind, function()
+      b.bench('mbyte: utf_ptr2char ' .. kind, function(n)
+        for _ = 1, n do
+          local off = 0
+          while off < len do
+            lib.utf_ptr2char(buf + off)
+            off = off + lib.utfc_ptr2len(buf + off)
+          end
+        end
+      end, { ops = len })
+    end)
+
+    itp('cells ' .. kind, function()
+      b.bench('mbyte: mb_string2cells ' .. kind, function(n)
+        for _ = 1, n do
+          lib.mb_string2cells(text)
+        end
+      end, { ops = len })
+    end)
+  end
+end)
@@ -0,0 +1,85 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local lib = t.cimport('./src/nvim/buffer.h', './src/nvim/memline.h')
+
+local N = 10000
+local LINE = t.to_cstr('local x = vim.api.nvim_buf_get_lines(0, 0, -1, false) -- some comment')
+
+describe('memline', function()
+  local lnums = b.random_ints(N, N, 3)
+
+  local function new_buf()
+    local buf = lib.buflist_new(nil, nil, 1, 0)
+    buf.b_p_swf = false
+    t.eq(1, lib.ml_open(buf)) -- OK
+    return buf
+  end
+
+  local function fill(buf)
+    for i = 1, N do
+      lib.ml_append_buf(buf, i - 1, LINE, 0, false)
+    end
+  end
+
+  itp('append', function()
+    local buf = new_buf()
+    b.bench('memline: append', function(n)
+      for _ = 1, n do
+        fill(buf)
+        lib.ml_close(buf, true)
+        lib.ml_open(buf)
+      end
+    end, { ops = N })
+  end)
+
+  itp('append in the middle', function()
+    local buf = new_buf()
+    b.bench('memline: append in the middle', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.ml_append_buf(buf, math.floor(i / 2), LINE, 0, false)
+        end
+        lib.ml_close(buf, true)
+        lib.ml_open(buf)
+      end
+    end, { ops = N })
+  end)
+
+  itp('get', function()
+    local buf = new_buf()
+    fill(buf)
+    b.bench('memline: get (random)', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.ml_get_buf(buf, lnums[i] + 1)
+        end
+      end
+    end, { ops = N })
+  end)
+
+  itp('replace', function()
+    local buf = new_buf()
+    fill(buf)
+    b.bench('memline: replace (random)', function(n)
+      for _ = 1, n do
+        for i = 1, N do
+          lib.ml_replace_buf(buf, lnums[i] + 1, LINE, true, false)
+        end
+      end
+    end, { ops = N })
+  end)
+
+  itp('delete', function()
+    local buf = new_buf()
+    b.bench('memline: delete', function(n)
+      for _ = 1, n do
+        fill(buf)
+        for _ = 1, N do
+          lib.ml_delete_buf(buf, 1, false)
+        end
+      end
+    end, { ops = N })
+  end)
+end)
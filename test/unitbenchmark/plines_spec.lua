@@ -0,0 +1,31 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local lib = t.cimport('./src/nvim/plines.h', './src/nvim/globals.h')
+
+local TEXT = ('\tif (x == 1) {\treturn "äöü 日本語";\t}  // trailing comment with some words '):rep(10)
+local LINE = t.to_cstr(TEXT)
+local LEN = #TEXT
+
+describe('plines', function()
+  itp('linetabsize', function()
+    b.bench('plines: linetabsize_col', function(n)
+      for _ = 1, n do
+        lib.linetabsize_col(0, LINE)
+      end
+    end, { ops = LEN })
+  end)
+
+  itp('linetabsize with linebreak', function()
+    -- 'linebreak' disables the fast path, every character goes through
+    -- charsize_regular(), which also needs the window width for wrapping.
+    lib.curwin.w_onebuf_opt.wo_lbr = 1
+    lib.curwin.w_view_width = 80
+    b.bench('plines: linetabsize_col linebreak', function(n)
+      for _ = 1, n do
+        lib.linetabsize_col(0, LINE)
+      end
+    end, { ops = LEN })
+  end)
+end)
@@ -0,0 +1,4 @@
+-- Modules loaded here will not be cleared and reloaded by Busted.
+-- Busted started doing this to help provide more isolation.  See issue #62
+-- for more information about this.
+require('test.unit.preload')
@@ -0,0 +1,64 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/regexp.h')
+
+local RE_MAGIC = 1
+
+local LINES = {
+  '    local result = vim.api.nvim_buf_get_extmarks(bufnr, ns_id, 0, -1, { details = true })',
+  'static int regmatch(uint8_t *scan, const proftime_T *tm, int *timed_out) // 3.14159',
+  '\tif (p_ic && !(flags & SEARCH_KEEP)) { return FAIL; }  /* äöü ñ 日本語 */',
+  'The quick brown fox jumps over the lazy dog, 10 times in 2.5 seconds.',
+}
+
+local PATTERNS = {
+  { 'literal', 'nvim_buf' },
+  { 'word start', [[\<\h\w*(]] },
+  { 'float', [[\d\+\.\d\+]] },
+  { 'alternation', [[\(return\|fox\|result\)]] },
+  { 'backtracking', [[a.*b.*c.*d]] },
+  { 'no match', [[xyz\d\+]] },
+}
+
+local ENGINES = { { 'backtracking', [[\%#=1]] }, { 'nfa', [[\%#=2]] } }
+
+describe('regexp', function()
+  for _, engine in ipairs(ENGINES) do
+    for _, pat in ipairs(PATTERNS) do
+      itp(engine[1] .. ' ' .. pat[1], function()
+        local regmatch = ffi.new('regmatch_T[1]')
+        regmatch[0].regprog = lib.vim_regcomp(engine[2] .. pat[2], RE_MAGIC)
+        assert(regmatch[0].regprog ~= nil)
+        regmatch[0].rm_ic = false
+        b.bench(('regexp: %s %s'):format(engine[1], pat[1]), function(n)
+          for _ = 1, n do
+            for i = 1, #LINES do
+              lib.vim_regexec(regmatch, LINES[i], 0)
+            end
+          end
+        end, { ops = #LINES })
+        lib.vim_regfree(regmatch[0].regprog)
+      end)
+    end
+  end
+
+  for _, engine in ipairs(ENGINES) do
+    itp(engine[1] .. ' compile', function()
+      local pats = {}
+      for i, pat in ipairs(PATTERNS) do
+        pats[i] = engine[2] .. pat[2]
+      end
+      b.bench(('regexp: %s compile'):format(engine[1]), function(n)
+        for _ = 1, n do
+          for i = 1, #pats do
+            lib.vim_regfree(lib.vim_regcomp(pats[i], RE_MAGIC))
+          end
+        end
+      end, { ops = #pats })
+    end)
+  end
+end)
@@ -0,0 +1,77 @@
+local t = require('test.unit.testutil')
+local b = require('test.unitbenchmark.benchutil')
+local itp = t.gen_itp(it)
+
+local ffi = t.ffi
+
+local lib = t.cimport('./src/nvim/msgpack_rpc/unpacker.h', './src/nvim/memory.h')
+
+local NMSG = 64
+
+--- Minimal msgpack encoder for the payloads below.
+local function str(s)
+  assert(#s < 32)
+  return string.char(0xa0 + #s) .. s
+end
+
+local function array(items)
+  local n = #items
+  local hdr = n < 16 and string.char(0x90 + n)
+    or string.char(0xdc, math.floor(n / 256), n % 256)
+  return hdr .. table.concat(items)
+end
+
+--- Response [1, msgid, nil, [["text", i, true], ...]] like a typical API result.
+local function response(msgid)
+  local items = {}
+  for i = 1, 256 do
+    items[i] = array({ str('line ' .. i), string.char(i % 128), '\xc3' })
+  end
+  return array({ '\x01', string.char(msgid % 128), '\xc0', array(items) })
+end
+
+--- ["redraw", [["grid_line", [grid, row, col, cells, wrap]]]] for an 80 column row.
+local function grid_line(row)
+  local cells = {}
+  for i = 1, 80 do
+    cells[i] = array({ str(string.char(32 + i)), '\x01' })
+  end
+  local line = array({ '\x02', string.char(row % 128), '\x00', array(cells), '\xc2' })
+  return array({ '\x02', str('redraw'), array({ array({ str('grid_line'), line }) }) })
+end
+
+describe('unpacker', function()
+  local function bench(name, payload)
+    local unpacker = ffi.cast('Unpacker*', lib.xcalloc(1, ffi.sizeof('Unpacker')))
+    lib.unpacker_init(unpacker)
+    local data = t.to_cstr(payload)
+    b.bench(name, function(n)
+      for _ = 1, n do
+        unpacker.read_ptr = data
+        unpacker.read_size = #payload
+        while lib.unpacker_advance(unpacker) do
+          lib.arena_mem_free(lib.arena_finish(unpacker.arena))
+        end
+        assert(unpacker.read_size == 0)
+      end
+    end, { ops = NMSG })
+    lib.unpacker_teardown(unpacker)
+    lib.xfree(unpacker)
+  end
+
+  itp('response', function()
+    local msgs = {}
+    for i = 1, NMSG do
+      msgs[i] = response(i)
+    end
+    bench('unpacker: response', table.concat(msgs))
+  end)
+
+  itp('grid_line', function()
+    local msgs = {}
+    for i = 1, NMSG do
+      msgs[i] = grid_line(i)
+    end
+    bench('unpacker: grid_line', table.concat(msgs))
+  end)
+end)